@@ -97,12 +97,22 @@
 
 #define LWIP_SOCKET                     0
 #define LWIP_NETCONN                    (NO_SYS == 0)
+#define LWIP_SO_RCVTIMEO                1
 #define MEMP_NUM_SYS_TIMEOUT            300
 
-#define LWIP_STATS                      0
-#define LINK_STATS                      0
+/* Counters for /stats.json and the UDP stream of stats_stream.c. 32-bit
+   counters do not wrap in a benchmark, and MEMP_STATS counts the pools
+   even though they come from malloc */
+#define LWIP_STATS                      1
+#define LWIP_STATS_LARGE                1
+#define LINK_STATS                      1
+#define MEMP_STATS                      1
 #define LWIP_STATS_DISPLAY              0
 
+/* Receive latency histograms, see arch/lpc_stats.h. Set to 0 to measure
+   the stack without the stamps */
+#define LWIP_STATS_LATENCY              1
+
 /* There are more *_DEBUG options that can be selected.
    See opts.h. Make sure that LWIP_DEBUG is defined when
    building the code to use debug. */
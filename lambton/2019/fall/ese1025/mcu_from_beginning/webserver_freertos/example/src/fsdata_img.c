@@ -0,0 +1,85 @@
+/* Generated by tools/makefsdata.c, do not edit */
+
+#include "lwip_fs.h"
+
+static const char fsimg_data_0[] = {
+	/* /index.htm */
+	0x48,0x54,0x54,0x50,0x2f,0x31,0x2e,0x31,0x20,0x32,0x30,0x30,0x20,0x4f,0x4b,0x0d,
+	0x0a,0x53,0x65,0x72,0x76,0x65,0x72,0x3a,0x20,0x6c,0x77,0x49,0x50,0x2f,0x31,0x2e,
+	0x33,0x2e,0x31,0x20,0x28,0x68,0x74,0x74,0x70,0x3a,0x2f,0x2f,0x73,0x61,0x76,0x61,
+	0x6e,0x6e,0x61,0x68,0x2e,0x6e,0x6f,0x6e,0x67,0x6e,0x75,0x2e,0x6f,0x72,0x67,0x2f,
+	0x70,0x72,0x6f,0x6a,0x65,0x63,0x74,0x73,0x2f,0x6c,0x77,0x69,0x70,0x29,0x0d,0x0a,
+	0x43,0x6f,0x6e,0x74,0x65,0x6e,0x74,0x2d,0x74,0x79,0x70,0x65,0x3a,0x20,0x74,0x65,
+	0x78,0x74,0x2f,0x68,0x74,0x6d,0x6c,0x0d,0x0a,0x56,0x61,0x72,0x79,0x3a,0x20,0x41,
+	0x63,0x63,0x65,0x70,0x74,0x2d,0x45,0x6e,0x63,0x6f,0x64,0x69,0x6e,0x67,0x0d,0x0a,
+	0x45,0x54,0x61,0x67,0x3a,0x20,0x22,0x31,0x30,0x62,0x38,0x30,0x64,0x66,0x35,0x22,
+	0x0d,0x0a,0x0d,0x0a,
+	0x3c,0x68,0x74,0x6d,0x6c,0x3e,0x0d,0x0a,0x3c,0x68,0x65,0x61,0x64,0x3e,0x3c,0x74,
+	0x69,0x74,0x6c,0x65,0x3e,0x43,0x6f,0x6e,0x67,0x72,0x61,0x74,0x73,0x21,0x3c,0x2f,
+	0x74,0x69,0x74,0x6c,0x65,0x3e,0x3c,0x2f,0x68,0x65,0x61,0x64,0x3e,0x0d,0x0a,0x3c,
+	0x62,0x6f,0x64,0x79,0x3e,0x0d,0x0a,0x3c,0x68,0x31,0x3e,0x57,0x65,0x6c,0x63,0x6f,
+	0x6d,0x65,0x20,0x74,0x6f,0x20,0x6f,0x75,0x72,0x20,0x6c,0x77,0x49,0x50,0x20,0x48,
+	0x54,0x54,0x50,0x20,0x73,0x65,0x72,0x76,0x65,0x72,0x21,0x3c,0x2f,0x68,0x31,0x3e,
+	0x0d,0x0a,0x3c,0x70,0x3e,0x54,0x68,0x69,0x73,0x20,0x69,0x73,0x20,0x61,0x20,0x73,
+	0x6d,0x61,0x6c,0x6c,0x20,0x74,0x65,0x73,0x74,0x20,0x70,0x61,0x67,0x65,0x2c,0x20,
+	0x73,0x65,0x72,0x76,0x65,0x64,0x20,0x62,0x79,0x20,0x68,0x74,0x74,0x70,0x73,0x65,
+	0x72,0x76,0x65,0x72,0x2d,0x6e,0x65,0x74,0x63,0x6f,0x6e,0x6e,0x20,0x66,0x72,0x6f,
+	0x6d,0x20,0x74,0x68,0x65,0x0d,0x0a,0x66,0x6c,0x61,0x73,0x68,0x20,0x66,0x69,0x6c,
+	0x65,0x20,0x69,0x6d,0x61,0x67,0x65,0x2e,0x20,0x52,0x65,0x67,0x65,0x6e,0x65,0x72,
+	0x61,0x74,0x65,0x20,0x65,0x78,0x61,0x6d,0x70,0x6c,0x65,0x2f,0x73,0x72,0x63,0x2f,
+	0x66,0x73,0x64,0x61,0x74,0x61,0x5f,0x69,0x6d,0x67,0x2e,0x63,0x20,0x77,0x69,0x74,
+	0x68,0x0d,0x0a,0x74,0x6f,0x6f,0x6c,0x73,0x2f,0x6d,0x61,0x6b,0x65,0x66,0x73,0x64,
+	0x61,0x74,0x61,0x2e,0x63,0x20,0x61,0x66,0x74,0x65,0x72,0x20,0x63,0x68,0x61,0x6e,
+	0x67,0x69,0x6e,0x67,0x20,0x74,0x68,0x65,0x20,0x66,0x69,0x6c,0x65,0x73,0x20,0x69,
+	0x6e,0x20,0x65,0x78,0x61,0x6d,0x70,0x6c,0x65,0x2f,0x66,0x73,0x2e,0x3c,0x2f,0x70,
+	0x3e,0x0d,0x0a,0x3c,0x2f,0x62,0x6f,0x64,0x79,0x3e,0x0d,0x0a,0x3c,0x2f,0x68,0x74,
+	0x6d,0x6c,0x3e,0x0d,0x0a,
+};
+
+static const char fsimg_gzip_0[] = {
+	/* /index.htm (gzip) */
+	0x48,0x54,0x54,0x50,0x2f,0x31,0x2e,0x31,0x20,0x32,0x30,0x30,0x20,0x4f,0x4b,0x0d,
+	0x0a,0x53,0x65,0x72,0x76,0x65,0x72,0x3a,0x20,0x6c,0x77,0x49,0x50,0x2f,0x31,0x2e,
+	0x33,0x2e,0x31,0x20,0x28,0x68,0x74,0x74,0x70,0x3a,0x2f,0x2f,0x73,0x61,0x76,0x61,
+	0x6e,0x6e,0x61,0x68,0x2e,0x6e,0x6f,0x6e,0x67,0x6e,0x75,0x2e,0x6f,0x72,0x67,0x2f,
+	0x70,0x72,0x6f,0x6a,0x65,0x63,0x74,0x73,0x2f,0x6c,0x77,0x69,0x70,0x29,0x0d,0x0a,
+	0x43,0x6f,0x6e,0x74,0x65,0x6e,0x74,0x2d,0x74,0x79,0x70,0x65,0x3a,0x20,0x74,0x65,
+	0x78,0x74,0x2f,0x68,0x74,0x6d,0x6c,0x0d,0x0a,0x43,0x6f,0x6e,0x74,0x65,0x6e,0x74,
+	0x2d,0x45,0x6e,0x63,0x6f,0x64,0x69,0x6e,0x67,0x3a,0x20,0x67,0x7a,0x69,0x70,0x0d,
+	0x0a,0x56,0x61,0x72,0x79,0x3a,0x20,0x41,0x63,0x63,0x65,0x70,0x74,0x2d,0x45,0x6e,
+	0x63,0x6f,0x64,0x69,0x6e,0x67,0x0d,0x0a,0x45,0x54,0x61,0x67,0x3a,0x20,0x22,0x31,
+	0x30,0x62,0x38,0x30,0x64,0x66,0x35,0x22,0x0d,0x0a,0x0d,0x0a,
+	0x1f,0x8b,0x08,0x00,0x00,0x00,0x00,0x00,0x02,0x03,0x3d,0x90,0xbb,0x4e,0x04,0x31,
+	0x0c,0x45,0xfb,0x91,0xe6,0x1f,0x4c,0x0f,0x13,0xd1,0x47,0x69,0x68,0xa0,0x5b,0xa1,
+	0x91,0x28,0x91,0x37,0xe3,0x3c,0x84,0xf3,0x50,0x62,0x58,0xf6,0xef,0xc9,0xce,0x00,
+	0x92,0x2b,0xdf,0x73,0xed,0x6b,0xeb,0x20,0x89,0xcd,0x3c,0xe9,0x40,0xb8,0x19,0x2d,
+	0x51,0x98,0xcc,0x53,0xc9,0xbe,0xa1,0xf4,0x3b,0xad,0x8e,0x86,0x56,0xbb,0x3c,0xb0,
+	0x73,0xd9,0xae,0x3b,0xfe,0x68,0xde,0x88,0x6d,0x49,0x04,0x52,0xa0,0x7c,0x36,0xe0,
+	0xcb,0xcb,0x09,0x9e,0xd7,0xf5,0x04,0x9d,0xda,0x17,0xb5,0x61,0x1e,0xd0,0x40,0xab,
+	0x59,0x43,0xec,0x30,0x0a,0xa1,0x27,0x64,0x06,0xa1,0x2e,0x50,0xd1,0xd3,0xfd,0xc1,
+	0x6e,0x70,0xbe,0x42,0x10,0xa9,0x87,0xf3,0x21,0x93,0xd8,0x92,0x33,0xb8,0x56,0x12,
+	0x48,0xa0,0x79,0x72,0x8c,0x3d,0x80,0x8b,0x4c,0x10,0xd3,0x30,0x2e,0xf0,0x4a,0x9e,
+	0x32,0x8d,0x94,0x04,0xf4,0x8d,0xa9,0x32,0xa9,0xde,0xac,0x72,0x7d,0x43,0xc1,0xf7,
+	0x98,0xfc,0x62,0xe1,0x12,0x25,0xcc,0x93,0x94,0xc2,0x5d,0x25,0xfc,0xa0,0x43,0x1c,
+	0x02,0x3a,0xa1,0x06,0x36,0x60,0xf6,0x31,0xfb,0xdb,0x8a,0x7d,0xf6,0x08,0x99,0xff,
+	0xa7,0xb9,0xbe,0x68,0x55,0x6f,0x07,0xa8,0xbf,0xa3,0xd5,0xef,0xb3,0x7e,0x00,0x97,
+	0x19,0x6e,0xfd,0x35,0x01,0x00,0x00,
+};
+
+static const struct fsimg_entry fsimg_files[] = {
+	{"/index.htm", "\"10b80df5\"",
+	 fsimg_data_0, 457, 148,
+	 fsimg_gzip_0, 403, 172},
+};
+
+static const u16_t fsimg_index[1] = {
+	1,
+};
+
+static const u32_t fsimg_disp[1] = {
+	0x00000000,
+};
+
+const struct fsimg fsimg_root = {
+	fsimg_files, fsimg_index, fsimg_disp, 0u, 1, 1, 1
+};
@@ -34,6 +34,7 @@
 #include <stdlib.h>
 
 #include "board.h"
+#include "lwip/sys.h"
 #include "lwip_fs.h"
 #include "httpd_structs.h"
 
@@ -65,6 +66,15 @@ const static char http_index_html[] =
 static FATFS *Fatfs;	/* File system object */
 #endif
 
+/* Files of the flash image that can be open at the same time, at least
+   one per HTTP worker */
+#ifndef FSIMG_NUM_OPEN
+#define FSIMG_NUM_OPEN 4
+#endif
+
+static struct fs_file fsimg_open[FSIMG_NUM_OPEN];
+static u8_t fsimg_open_used[FSIMG_NUM_OPEN];
+
 /* Internal File descriptor structure */
 struct file_ds {
 	uint8_t scratch[SECTOR_SZ];
@@ -156,41 +166,89 @@ end_fn:
 	return strlen(buff);
 }
 
-/*****************************************************************************
- * Public functions
- ****************************************************************************/
+/* Name hash of the image index, must match tools/makefsdata.c */
+static u32_t fsimg_hash(const char *name, u32_t seed)
+{
+	u32_t h = 2166136261UL ^ seed;
 
-/* Read http header information into a string */
-int GetHTTP_Header(const char *fName, char *buff)
+	while (*name) {
+		h ^= (u8_t) *name++;
+		h *= 16777619UL;
+	}
+	return h;
+}
+
+/* Bucket and step of a name hash, must match tools/makefsdata.c */
+static u32_t fsimg_mix(u32_t h)
 {
-	return get_http_headers(fName, buff);
+	h ^= h >> 16;
+	h *= 0x85EBCA6BUL;
+	h ^= h >> 13;
+	h *= 0xC2B2AE35UL;
+	h ^= h >> 16;
+	return h;
 }
 
-/* Opens the default index html file */
-struct fs_file *fs_open_default(void) {
-	int hlen;
-	struct file_ds *fds;
-	struct fs_file *fs;
+/* Find a file of the flash image, NULL if it has none of that name */
+static const struct fsimg_entry *fsimg_lookup(const char *name)
+{
+	const struct fsimg *img = &fsimg_root;
+	u32_t h, g, d;
+	u16_t n;
+
+	h = fsimg_hash(name, img->seed);
+	g = fsimg_mix(h);
+	d = img->disp[g & (img->disp_size - 1)];
+	n = img->index[(h + (d >> 16) * ((g >> 16) | 1) + (d & 0xFFFF)) & (img->index_size - 1)];
+	if (n == 0 || strcmp(img->files[n - 1].name, name))
+		return NULL;
+	return &img->files[n - 1];
+}
 
-	fds = malloc(sizeof(*fds));
-	if (fds == NULL) {
-		DEBUGSTR("Malloc Failure, Out of Memory!\r\n");
+/* Open a file of the flash image, no allocation nor copy is done */
+static struct fs_file *fsimg_fs_open(const char *name, u8_t accept_gzip)
+{
+	const struct fsimg_entry *ent;
+	struct fs_file *fs = NULL;
+	int i;
+	SYS_ARCH_DECL_PROTECT(lev);
+
+	ent = fsimg_lookup(name);
+	if (ent == NULL)
 		return NULL;
+
+	SYS_ARCH_PROTECT(lev);
+	for (i = 0; i < FSIMG_NUM_OPEN; i++) {
+		if (!fsimg_open_used[i]) {
+			fsimg_open_used[i] = 1;
+			fs = &fsimg_open[i];
+			break;
+		}
 	}
-	memset(fds, 0, sizeof(*fds));
-	fs = &fds->fs;
-	fs->pextension = (void *) fds;	/* Store this for later use */
-	hlen = get_http_headers("default.htm", (char *) fds->scratch);
-	fs->data = (const char *) fds->scratch;
-	memcpy((void *) &fs->data[hlen], (void *) http_index_html, sizeof(http_index_html) - 1);
-	fs->len = hlen + sizeof(http_index_html) - 1;
-	fs->index = fs->len;
+	SYS_ARCH_UNPROTECT(lev);
+	if (fs == NULL) {
+		LWIP_DEBUGF(HTTPD_DEBUG, ("DFS: OPEN: Too many image files open\r\n"));
+		return NULL;
+	}
+
+	memset(fs, 0, sizeof(*fs));
+	if (accept_gzip && ent->gz_data != NULL) {
+		fs->data = ent->gz_data;
+		fs->len = ent->gz_len;
+		fs->index = ent->gz_hdr_len;
+	} else {
+		fs->data = ent->data;
+		fs->len = ent->len;
+		fs->index = ent->hdr_len;
+	}
+	fs->etag = ent->etag;
 	fs->http_header_included = 1;
+	fs->data_persistent = 1;
 	return fs;
 }
 
-/* File open function */
-struct fs_file *fs_open(const char *name) {
+/* Opens a file of the FAT file system */
+static struct fs_file *fatfs_fs_open(const char *name) {
 #if defined(LWIP_FATFS_SUPPORT)
 	FRESULT res;
 	int hlen;
@@ -229,12 +287,60 @@ struct fs_file *fs_open(const char *name) {
 	fs->index = hlen;
 	fs->len = f_size(&fds->fi) + hlen;
 	fs->http_header_included = 1;
+	fs->data_persistent = 0;
 	return fs;
 #else
 	return 0;
 #endif
 }
 
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Read http header information into a string */
+int GetHTTP_Header(const char *fName, char *buff)
+{
+	return get_http_headers(fName, buff);
+}
+
+/* Opens the default index html file */
+struct fs_file *fs_open_default(void) {
+	int hlen;
+	struct file_ds *fds;
+	struct fs_file *fs;
+
+	fds = malloc(sizeof(*fds));
+	if (fds == NULL) {
+		DEBUGSTR("Malloc Failure, Out of Memory!\r\n");
+		return NULL;
+	}
+	memset(fds, 0, sizeof(*fds));
+	fs = &fds->fs;
+	fs->pextension = (void *) fds;	/* Store this for later use */
+	hlen = get_http_headers("default.htm", (char *) fds->scratch);
+	fs->data = (const char *) fds->scratch;
+	memcpy((void *) &fs->data[hlen], (void *) http_index_html, sizeof(http_index_html) - 1);
+	fs->len = hlen + sizeof(http_index_html) - 1;
+	fs->index = fs->len;
+	fs->http_header_included = 1;
+	return fs;
+}
+
+/* File open function */
+struct fs_file *fs_open(const char *name) {
+	return fs_open_enc(name, 0);
+}
+
+/* File open function, gzip responses allowed */
+struct fs_file *fs_open_enc(const char *name, u8_t accept_gzip) {
+	struct fs_file *fs;
+
+	fs = fsimg_fs_open(name, accept_gzip);
+	if (fs != NULL)
+		return fs;
+	return fatfs_fs_open(name);
+}
 
 /* File close function */
 void fs_close(struct fs_file *file)
@@ -244,6 +350,11 @@ void fs_close(struct fs_file *file)
 	if(file == NULL)
 		return;
 
+	if (file >= &fsimg_open[0] && file < &fsimg_open[FSIMG_NUM_OPEN]) {
+		fsimg_open_used[file - &fsimg_open[0]] = 0;
+		return;
+	}
+
 	fds = (struct file_ds *) file->pextension;
 #if defined(LWIP_FATFS_SUPPORT)
 	if (fds->fi_valid)
@@ -252,41 +363,46 @@ void fs_close(struct fs_file *file)
  	free(fds);
 }
 
-#if defined(LWIP_FATFS_SUPPORT)
+/* Number of bytes left in the file */
+int fs_bytes_left(struct fs_file *file)
+{
+	return file->len - file->index;
+}
+
 /* File read function */
 int fs_read(struct fs_file *file, char *buffer, int count)
 {
+#if defined(LWIP_FATFS_SUPPORT)
 	uint32_t i = 0;
 	struct file_ds *fds = (struct file_ds *) file->pextension;
+#endif
+
+	if (file->data_persistent) {
+		/* Image file, the data follows the header in flash */
+		if (count > fs_bytes_left(file))
+			count = fs_bytes_left(file);
+		memcpy(buffer, file->data + file->index, count);
+		file->index += count;
+		return count;
+	}
+
+#if defined(LWIP_FATFS_SUPPORT)
 	if (f_read(&fds->fi, (uint8_t *) buffer, count, &i))
 		return 0; /* Error in reading file */
 	file->index += i;
 	return i;
+#else
+	return 0;
+#endif
 }
 
-/* Number of bytes left in the file */
-int fs_bytes_left(struct fs_file *file)
-{
-	return file->len - file->index;
-}
-
+#if defined(LWIP_FATFS_SUPPORT)
 /* Fat file system information function */
 void FATFS_GetBufferInfo(uint8_t **buffer, uint32_t *size)
 {
 	*buffer = (uint8_t *) ipcex_getGblVal(SHGBL_USBDISKADDR);
 	*size = (uint32_t) RAMDISK_SIZE;
 }
-#else
-int fs_bytes_left(struct fs_file *file)
-{
-	return 0;
-}
-
-int fs_read(struct fs_file *file, char *buffer, int count)
-{
-	return 0;
-}
-
 #endif /* defined(LWIP_FATFS_SUPPORT) */
 
 #ifdef LWIP_DEBUG
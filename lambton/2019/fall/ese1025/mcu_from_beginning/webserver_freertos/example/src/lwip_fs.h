@@ -84,6 +84,13 @@ struct fs_file {
   u16_t chksum_count;
 #endif /* HTTPD_PRECALCULATED_CHECKSUM */
   u8_t http_header_included;
+  /* 1 when data holds the whole response (header and body, len bytes) in
+     memory that outlives the file, such as a flash image. The server then
+     sends it by reference instead of reading it through fs_read(). index
+     is the length of the header part. */
+  u8_t data_persistent;
+  /* Quoted entity tag of the file data, NULL when the file has none */
+  const char *etag;
 #if LWIP_HTTPD_CUSTOM_FILES
   u8_t is_custom_file;
 #endif /* LWIP_HTTPD_CUSTOM_FILES */
@@ -92,6 +99,34 @@ struct fs_file {
 #endif /* LWIP_HTTPD_FILE_STATE */
 };
 
+/** One file of the flash image built by tools/makefsdata.c. Each response
+ * holds the prebuilt HTTP header followed by the file data. */
+struct fsimg_entry {
+  const char *name;       /* URI of the file, starting with '/' */
+  const char *etag;       /* quoted entity tag, also in the headers */
+  const char *data;       /* response with the plain data */
+  u32_t len;
+  u32_t hdr_len;
+  const char *gz_data;    /* response with gzip data, NULL if none */
+  u32_t gz_len;
+  u32_t gz_hdr_len;
+};
+
+/** Flash image, names are found through a perfect hash: the name hash
+ * picks a bucket, and the displacement of the bucket its index slot */
+struct fsimg {
+  const struct fsimg_entry *files;
+  const u16_t *index;     /* file number + 1 for each hash slot, 0 if empty */
+  const u32_t *disp;      /* displacement of each bucket */
+  u32_t seed;
+  u16_t index_size;       /* power of two */
+  u16_t disp_size;        /* buckets, power of two */
+  u16_t num_files;
+};
+
+/** Image generated into fsdata_img.c */
+extern const struct fsimg fsimg_root;
+
 /**
  * @brief	Get HTTP header function
  * @param fName	:   Filename for which the header be generated
@@ -122,6 +157,19 @@ struct fs_file *fs_open_default(void);
  */
 struct fs_file *fs_open(const char *name);
 
+/**
+ * @brief	Open a file, choosing the gzip response when allowed
+ * @param name	:	Name of the file to be opened
+ * @param accept_gzip	:	Non-zero when the client accepts gzip encoding
+ * @return Pointer to File structure on success
+ *         NULL on failure
+ * Files of the flash image are looked up first, without any allocation.
+ * They have data_persistent set and, when accept_gzip is non-zero and the
+ * image holds a gzip copy, carry a "Content-Encoding: gzip" header. Other
+ * names are opened from the file system as with fs_open().
+ */
+struct fs_file *fs_open_enc(const char *name, u8_t accept_gzip);
+
 /**
  * @brief	Closes/Frees a previously opened file function
  * @param file	:	Pointer to File structure of opened file
@@ -29,11 +29,17 @@
 * this code.
 */
 
+#include <ctype.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "lwip/opt.h"
 #include "lwip/arch.h"
 #include "lwip/api.h"
+#include "lwip/tcp.h"
+#include "lwip/tcpip.h"
+#include "arch/lpc_stats.h"
 #include "lwip_fs.h"
 
 #if LWIP_NETCONN
@@ -54,6 +60,106 @@ void http_server_netconn_init(void);
 #define CRLF "\r\n"
 #endif
 
+/* Size and number of the buffers files are read into. A connection holds
+   one buffer while it serves a file that is not persistent. */
+#ifndef HTTPD_FILE_BUF_SIZE
+#define HTTPD_FILE_BUF_SIZE 1024
+#endif
+
+#ifndef HTTPD_NUM_FILE_BUFS
+#define HTTPD_NUM_FILE_BUFS 2
+#endif
+
+/* Number of tasks serving connections, and of accepted connections that
+   can wait for a free task */
+#ifndef HTTPD_NUM_WORKERS
+#define HTTPD_NUM_WORKERS 2
+#endif
+
+#ifndef HTTPD_ACCEPT_QUEUE_LEN
+#define HTTPD_ACCEPT_QUEUE_LEN 4
+#endif
+
+/* Largest request line and header block, in bytes */
+#ifndef HTTPD_REQ_BUF_SIZE
+#define HTTPD_REQ_BUF_SIZE 512
+#endif
+
+/* Time in milliseconds a persistent connection may wait for a request */
+#ifndef HTTPD_IDLE_TIMEOUT_MS
+#define HTTPD_IDLE_TIMEOUT_MS 5000
+#endif
+
+/* How often, in milliseconds, a connection waiting for its next request
+   checks for accepted connections waiting for a worker. It gives its
+   worker up to them at once instead of after HTTPD_IDLE_TIMEOUT_MS. */
+#ifndef HTTPD_IDLE_POLL_MS
+#define HTTPD_IDLE_POLL_MS 20
+#endif
+
+/* Size of the buffer /stats.json is written into */
+#ifndef HTTPD_STATS_BUF_SIZE
+#define HTTPD_STATS_BUF_SIZE 2048
+#endif
+
+#if !LWIP_SO_RCVTIMEO
+#error LWIP_SO_RCVTIMEO is needed for the HTTPD idle timeout
+#endif
+
+/* Per-connection request state, one for each worker */
+struct http_conn {
+	struct netconn *conn;
+	struct netbuf *inbuf;		/* netbuf being copied into req */
+	u16_t inoff;				/* bytes of inbuf already copied */
+	char *req;					/* request buffer, HTTPD_REQ_BUF_SIZE bytes */
+	int reqlen;					/* bytes in req */
+};
+
+static char req_bufs[HTTPD_NUM_WORKERS][HTTPD_REQ_BUF_SIZE];
+static sys_mbox_t accept_mbox;
+static volatile int accept_waiting;	/* connections in accept_mbox */
+
+/* Data sent with NETCONN_NOCOPY must stay unchanged until the peer has
+   acknowledged it, which can be long after netconn_write() returns. Only
+   persistent (flash or ROM) file data is sent by reference, everything
+   read into these buffers is copied into the send buffer. */
+static uint8_t file_bufs[HTTPD_NUM_FILE_BUFS][HTTPD_FILE_BUF_SIZE];
+static uint8_t file_buf_used[HTTPD_NUM_FILE_BUFS];
+static sys_sem_t file_buf_sem;	/* counts the free buffers */
+
+#if LWIP_STATS || LWIP_STATS_LATENCY
+const static char http_json_hdr[] = "HTTP/1.1 200 OK\r\nContent-type: application/json\r\nCache-Control: no-store\r\n\r\n";
+
+/* /stats.json is written here, one request at a time */
+static char stats_buf[HTTPD_STATS_BUF_SIZE];
+static sys_mutex_t stats_mutex;
+#endif
+
+/* Take a file buffer, waiting for one if all are in use */
+static uint8_t *file_buf_get(void)
+{
+	SYS_ARCH_DECL_PROTECT(lev);
+	int i;
+
+	sys_arch_sem_wait(&file_buf_sem, 0);
+	SYS_ARCH_PROTECT(lev);
+	for (i = 0; file_buf_used[i]; i++) {}
+	file_buf_used[i] = 1;
+	SYS_ARCH_UNPROTECT(lev);
+	return file_bufs[i];
+}
+
+/* Give a file buffer back */
+static void file_buf_put(uint8_t *fbuf)
+{
+	SYS_ARCH_DECL_PROTECT(lev);
+
+	SYS_ARCH_PROTECT(lev);
+	file_buf_used[(fbuf - file_bufs[0]) / HTTPD_FILE_BUF_SIZE] = 0;
+	SYS_ARCH_UNPROTECT(lev);
+	sys_sem_signal(&file_buf_sem);
+}
+
 /* Function to check if the requested method is supported */
 static int supported_method(const char *method)
 {
@@ -72,43 +178,230 @@ static uint32_t get_version(const char *vstr)
 	return (major << 16) | minor;
 }
 
-/** Serve one HTTP connection accepted in the http thread */
-static void
-http_server_netconn_serve(struct netconn *conn)
+/* Find the empty line that ends the request or response headers, returns
+   the offset of its CRLF CRLF or -1 */
+static int http_find_hdr_end(const char *buf, int len)
 {
-  struct netbuf *inbuf;
-  char *buf, *tbuf;
-  u16_t buflen;
-	struct fs_file *fs = NULL;
-  err_t err;
-	static uint8_t file_buffer[1024];
+	int i;
+
+	for (i = 0; i + 3 < len; i++) {
+		if (buf[i] == '\r' && buf[i + 1] == '\n' && buf[i + 2] == '\r' && buf[i + 3] == '\n')
+			return i;
+	}
+	return -1;
+}
+
+/* Case insensitive check that s starts with word */
+static int http_match(const char *s, const char *word)
+{
+	while (*word) {
+		if (tolower((unsigned char) *s++) != tolower((unsigned char) *word++))
+			return 0;
+	}
+	return 1;
+}
+
+/* Value of the named header, NULL when the request does not have it */
+static const char *http_hdr_value(const char *hdrs, const char *name)
+{
+	int nlen = strlen(name);
+
+	while (hdrs != NULL && *hdrs) {
+		if (http_match(hdrs, name) && hdrs[nlen] == ':') {
+			hdrs += nlen + 1;
+			while (*hdrs == ' ' || *hdrs == '\t')
+				hdrs++;
+			return hdrs;
+		}
+		hdrs = strstr(hdrs, CRLF);
+		if (hdrs != NULL)
+			hdrs += 2;
+	}
+	return NULL;
+}
+
+/* Check that the comma separated header value val lists token */
+static int http_hdr_has(const char *val, const char *token)
+{
+	int tlen = strlen(token);
+
+	while (val != NULL && *val && *val != '\r') {
+		while (*val == ' ' || *val == ',')
+			val++;
+		if (http_match(val, token) && (val[tlen] == ',' || val[tlen] == ';' ||
+			val[tlen] == ' ' || val[tlen] == '\r'))
+			return 1;
+		while (*val && *val != ',' && *val != '\r')
+			val++;
+	}
+	return 0;
+}
+
+/* Send a response that starts with data[0, len): the status line, the
+   headers, an empty line and possibly the start of the body. extra more
+   body bytes are sent separately by the caller. Content-Length and
+   Connection headers are added in front of the empty line, so that the
+   client can find the end of the body on a persistent connection. */
+static err_t http_send_framed(struct netconn *conn, const char *data, int len,
+	u8_t apiflags, int extra, int *keepalive)
+{
+	char framing[64];
+	int end, flen;
+	err_t err;
+
+	end = http_find_hdr_end(data, len);
+	if (end < 0) {
+		/* No header to extend, closing the connection ends the body */
+		*keepalive = 0;
+		return (len > 0) ? netconn_write(conn, data, len, apiflags) : ERR_OK;
+	}
+
+	/* Status line and headers, including the CRLF of the last one */
+	err = netconn_write(conn, data, end + 2, apiflags);
+	if (err != ERR_OK)
+		return err;
+
+	flen = snprintf(framing, sizeof(framing), "Content-Length: %d" CRLF "Connection: %s" CRLF CRLF,
+		len - (end + 4) + extra, *keepalive ? "keep-alive" : "close");
+	err = netconn_write(conn, framing, flen, NETCONN_COPY);
+	if (err != ERR_OK || end + 4 == len)
+		return err;
+
+	return netconn_write(conn, data + end + 4, len - (end + 4), apiflags);
+}
+
+#if LWIP_STATS || LWIP_STATS_LATENCY
+/* Send the statistics of lpc_stats_json() */
+static err_t http_send_stats(struct netconn *conn, int *keepalive)
+{
+	err_t err;
 	int len;
-	uint32_t req_ver;
-  
-  /* Read the data from the port, blocking if nothing yet there. 
-   We assume the request (the part we care about) is in one netbuf */
-  err = netconn_recv(conn, &inbuf);
-  
-  if (err != ERR_OK) return;
 
-	netbuf_data(inbuf, (void**)&buf, &buflen);
-	if (buflen < 5 || strstr(buf, CRLF) == NULL) {
-		LWIP_DEBUGF(HTTPD_DEBUG, ("HTTPD: Invalid Request Line\r\n"));
-		goto close_and_exit;
+	sys_mutex_lock(&stats_mutex);
+	len = lpc_stats_json(stats_buf, sizeof(stats_buf));
+	if (len < 0) {
+		LWIP_DEBUGF(HTTPD_DEBUG, ("HTTPD: HTTPD_STATS_BUF_SIZE too small for the statistics\r\n"));
+		err = ERR_MEM;
+	} else {
+		err = http_send_framed(conn, http_json_hdr, sizeof(http_json_hdr)-1, NETCONN_NOCOPY,
+			len, keepalive);
+		if (err == ERR_OK)
+			err = netconn_write(conn, stats_buf, len, NETCONN_COPY);
 	}
+	sys_mutex_unlock(&stats_mutex);
+	return err;
+}
+#endif
+
+/* Runs in the TCP/IP thread, which owns the pcb. The header, the framing
+   and a short body are written separately; with Nagle's algorithm the
+   later writes would wait for the client's delayed ACK of the first. */
+static void http_set_nodelay(void *arg)
+{
+	struct netconn *conn = (struct netconn *) arg;
+
+	if (conn->pcb.tcp != NULL)
+		tcp_nagle_disable(conn->pcb.tcp);
+}
+
+/* Wait for the next netbuf. A connection that is idle between requests
+   gives its worker up once connections wait in the accept queue, and
+   after HTTPD_IDLE_TIMEOUT_MS in any case. */
+static err_t http_recv(struct http_conn *hc, int between_requests)
+{
+	u32_t idle = 0;
+	err_t err;
+
+	if (!between_requests) {
+		netconn_set_recvtimeout(hc->conn, HTTPD_IDLE_TIMEOUT_MS);
+		return netconn_recv(hc->conn, &hc->inbuf);
+	}
+
+	netconn_set_recvtimeout(hc->conn, HTTPD_IDLE_POLL_MS);
+	while ((err = netconn_recv(hc->conn, &hc->inbuf)) == ERR_TIMEOUT) {
+		idle += HTTPD_IDLE_POLL_MS;
+		if (accept_waiting > 0 || idle >= HTTPD_IDLE_TIMEOUT_MS)
+			break;
+	}
+	return err;
+}
+
+/* Move more received data into the request buffer, waiting for it if
+   there is none. A netbuf that does not fit is kept for the next call.
+   between_requests is set while no part of the next request has come. */
+static err_t http_fill(struct http_conn *hc, int between_requests)
+{
+	u16_t n;
+	err_t err;
+
+	if (hc->inbuf == NULL) {
+		err = http_recv(hc, between_requests);
+		if (err != ERR_OK) {
+			hc->inbuf = NULL;
+			return err;
+		}
+		hc->inoff = 0;
+#if LWIP_STATS_LATENCY
+		lpc_stats_stamp(LPC_STATS_APP, hc->inbuf->p);
+#endif
+	}
+
+	n = netbuf_copy_partial(hc->inbuf, hc->req + hc->reqlen,
+		HTTPD_REQ_BUF_SIZE - 1 - hc->reqlen, hc->inoff);
+	hc->reqlen += n;
+	hc->inoff += n;
+	if (hc->inoff >= netbuf_len(hc->inbuf)) {
+		netbuf_delete(hc->inbuf);
+		hc->inbuf = NULL;
+	}
+	return ERR_OK;
+}
+
+/* Drop n bytes from the front of the request buffer */
+static void http_consume(struct http_conn *hc, int n)
+{
+	memmove(hc->req, hc->req + n, hc->reqlen - n);
+	hc->reqlen -= n;
+}
+
+/** Answer one request. req holds the request line and the headers, NUL
+    terminated. keepalive is set when the connection may take another
+    request and bodylen to the size of a request body that follows. */
+static err_t
+http_server_netconn_request(struct netconn *conn, char *req, int *keepalive, int *bodylen)
+{
+	char *buf, *tbuf;
+	const char *hdrs, *val;
+	struct fs_file *fs = NULL;
+	err_t err = ERR_OK;
+	uint8_t *fbuf;
+	int len;
+	u8_t gzip_ok;
+	uint32_t req_ver = 0;
+
+	/* The headers follow the request line */
+	buf = req;
+	tbuf = strstr(buf, CRLF);
+	*tbuf = 0;
+	hdrs = tbuf + 2;
 
 	LWIP_DEBUGF(HTTPD_DEBUG | LWIP_DBG_TRACE, ("HTTPD: Got URI %s\r\n", buf));
 
+	val = http_hdr_value(hdrs, "Content-Length");
+	if (val != NULL)
+		*bodylen = atoi(val);
+	gzip_ok = http_hdr_has(http_hdr_value(hdrs, "Accept-Encoding"), "gzip");
+
 	tbuf = strchr(buf, ' ');
 	if (tbuf == NULL) {
 		LWIP_DEBUGF(HTTPD_DEBUG, ("HTTPD: Parse error in Request Line\r\n"));
-		goto close_and_exit;
+		return ERR_VAL;
 	}
 	
 	*tbuf++ = 0;
 	if (!supported_method(buf)) {
 		LWIP_DEBUGF(HTTPD_DEBUG, ("HTTPD: Un-supported method: %s\r\n", buf));
-		goto close_and_exit;
+		return ERR_VAL;
 	}
 	buf = tbuf;
 	tbuf = strchr(buf, ' ');
@@ -120,60 +413,170 @@ http_server_netconn_serve(struct netconn *conn)
 		LWIP_DEBUGF(HTTPD_DEBUG | LWIP_DBG_TRACE, ("HTTPD: Request version %d.%d\r\n",
 			req_ver >> 16, req_ver & 0xFFFF));
 	}
+
+	/* HTTP/1.1 connections persist unless the client asks to close them,
+	   HTTP/1.0 ones only when the client asks to keep them */
+	val = http_hdr_value(hdrs, "Connection");
+	if (req_ver >= ((1 << 16) | 1))
+		*keepalive = (val == NULL) || !http_match(val, "close");
+	else
+		*keepalive = (val != NULL) && http_match(val, "keep-alive");
+
+	/* Let a waiting connection have the worker after this response */
+	if (accept_waiting > 0)
+		*keepalive = 0;
 	
 	tbuf = strchr(buf, '?');
 	if (tbuf != NULL) {
 		LWIP_DEBUGF(HTTPD_DEBUG, ("HTTPD: Arguements %s in URI ignored\r\n", tbuf));
 		*tbuf++ = 0;
 	}
+#if LWIP_STATS || LWIP_STATS_LATENCY
+	if (strcmp(buf, "/stats.json") == 0)
+		return http_send_stats(conn, keepalive);
+#endif
 	if (strlen(buf) == 1 && *buf == '/') {
-		fs = fs_open("/index.htm");
+		fs = fs_open_enc("/index.htm", gzip_ok);
 		if (fs == NULL)
-			fs = fs_open("/index.html");
+			fs = fs_open_enc("/index.html", gzip_ok);
 		if (fs == NULL) {
 			/* No home page, send if from buffer */
-      netconn_write(conn, http_html_hdr, sizeof(http_html_hdr)-1, NETCONN_NOCOPY);
-      netconn_write(conn, http_index_html, sizeof(http_index_html)-1, NETCONN_NOCOPY);
-			goto close_and_exit;
+			err = http_send_framed(conn, http_html_hdr, sizeof(http_html_hdr)-1, NETCONN_NOCOPY,
+				sizeof(http_index_html)-1, keepalive);
+			if (err == ERR_OK)
+				err = netconn_write(conn, http_index_html, sizeof(http_index_html)-1, NETCONN_NOCOPY);
+			return err;
 		}
 	} else {
-		fs = fs_open(buf);
+		fs = fs_open_enc(buf, gzip_ok);
 	}
 	if (fs == NULL) {
-		int len;
 		LWIP_DEBUGF(HTTPD_DEBUG, ("HTTPD: Unable to open file[%s]\r\n", buf));
-		len = GetHTTP_Header(NULL, (char *)file_buffer);
-		netconn_write(conn, file_buffer, len, NETCONN_NOCOPY);
+		fbuf = file_buf_get();
+		len = GetHTTP_Header(NULL, (char *)fbuf);
+		err = http_send_framed(conn, (char *)fbuf, len, NETCONN_COPY, 0, keepalive);
+		file_buf_put(fbuf);
+		return err;
+	}
+
+	/* The client has the current version already */
+	val = http_hdr_value(hdrs, "If-None-Match");
+	if (fs->etag != NULL && http_hdr_has(val, fs->etag)) {
+		fbuf = file_buf_get();
+		len = snprintf((char *)fbuf, HTTPD_FILE_BUF_SIZE, "HTTP/1.1 304 Not Modified" CRLF "ETag: %s" CRLF CRLF, fs->etag);
+		err = http_send_framed(conn, (char *)fbuf, len, NETCONN_COPY, 0, keepalive);
+		file_buf_put(fbuf);
 		goto close_and_exit;
 	}
-	
-	/***
-	 * FIXME: There is a possible race condition while accessing
-	 *        file_buffer, must use a mutex to protect it.
-	 **/
-	if (fs->http_header_included)
-		/* Send the header */
-		netconn_write(conn, fs->data, fs->index, NETCONN_NOCOPY);
-	 
-	 /* Read the file now */
-	 while ((len = fs_read(fs, (char *)file_buffer, sizeof(file_buffer))) > 0) {
-		netconn_write(conn, file_buffer, len, NETCONN_NOCOPY);
-	 }
-	
+
+	len = fs->http_header_included ? fs->index : 0;
+	if (fs->data_persistent) {
+		/* Header and body are in flash, send them by reference */
+		err = http_send_framed(conn, fs->data, len, NETCONN_NOCOPY, fs->len - len, keepalive);
+		if (err == ERR_OK && fs->len > len)
+			err = netconn_write(conn, fs->data + len, fs->len - len, NETCONN_NOCOPY);
+		goto close_and_exit;
+	}
+
+	/* Send the header, it is freed by fs_close() */
+	err = http_send_framed(conn, fs->data, len, NETCONN_COPY, fs_bytes_left(fs), keepalive);
+
+	/* Read the file now */
+	fbuf = file_buf_get();
+	while (err == ERR_OK && (len = fs_read(fs, (char *)fbuf, HTTPD_FILE_BUF_SIZE)) > 0) {
+		err = netconn_write(conn, fbuf, len, NETCONN_COPY);
+	}
+	file_buf_put(fbuf);
+
+	/* A short read leaves the announced length unmet */
+	if (fs_bytes_left(fs) > 0)
+		*keepalive = 0;
+
 close_and_exit:
-  fs_close(fs);
-  /* Close the connection (server closes in HTTP) */
-  netconn_close(conn);
-  
-  /* Delete the buffer (netconn_recv gives us ownership,
-   so we have to make sure to deallocate the buffer) */
-  netbuf_delete(inbuf);
+	fs_close(fs);
+	return err;
+}
+
+/** Serve one HTTP connection taken from the accept queue. Requests may
+    arrive split over several netbufs or pipelined in one. */
+static void
+http_server_netconn_serve(struct http_conn *hc)
+{
+	int end, keepalive, bodylen, n;
+	err_t err = ERR_OK;
+
+	tcpip_callback(http_set_nodelay, hc->conn);
+
+	do {
+		/* Collect data until the empty line that ends the headers */
+		while ((end = http_find_hdr_end(hc->req, hc->reqlen)) < 0) {
+			if (hc->reqlen >= HTTPD_REQ_BUF_SIZE - 1) {
+				LWIP_DEBUGF(HTTPD_DEBUG, ("HTTPD: Request too long\r\n"));
+				err = ERR_BUF;
+				break;
+			}
+			err = http_fill(hc, hc->reqlen == 0);
+			if (err != ERR_OK)
+				break;
+		}
+		if (err != ERR_OK)
+			break;
+
+		hc->req[end + 2] = 0;
+		keepalive = 0;
+		bodylen = 0;
+		err = http_server_netconn_request(hc->conn, hc->req, &keepalive, &bodylen);
+		http_consume(hc, end + 4);
+
+		/* The request body is not used, skip it */
+		while (err == ERR_OK && bodylen > 0) {
+			if (hc->reqlen == 0) {
+				err = http_fill(hc, 0);
+				continue;
+			}
+			n = LWIP_MIN(bodylen, hc->reqlen);
+			http_consume(hc, n);
+			bodylen -= n;
+		}
+	} while (err == ERR_OK && keepalive);
+
+	if (hc->inbuf != NULL) {
+		netbuf_delete(hc->inbuf);
+		hc->inbuf = NULL;
+	}
+	hc->reqlen = 0;
+
+	/* Close the connection */
+	netconn_close(hc->conn);
+}
+
+/** Worker task, serves the connections posted to the accept queue */
+static void
+http_server_netconn_worker(void *arg)
+{
+	SYS_ARCH_DECL_PROTECT(lev);
+	struct http_conn hc;
+	void *msg;
+
+	memset(&hc, 0, sizeof(hc));
+	hc.req = req_bufs[(int) (intptr_t) arg];
+
+	while (1) {
+		sys_arch_mbox_fetch(&accept_mbox, &msg, 0);
+		SYS_ARCH_PROTECT(lev);
+		accept_waiting--;
+		SYS_ARCH_UNPROTECT(lev);
+		hc.conn = (struct netconn *) msg;
+		http_server_netconn_serve(&hc);
+		netconn_delete(hc.conn);
+	}
 }
 
 /** The main function, never returns! */
 static void
 http_server_netconn_thread(void *arg)
 {
+  SYS_ARCH_DECL_PROTECT(lev);
   struct netconn *conn, *newconn;
   err_t err;
   LWIP_UNUSED_ARG(arg);
@@ -191,8 +594,12 @@ http_server_netconn_thread(void *arg)
   do {
     err = netconn_accept(conn, &newconn);
     if (err == ERR_OK) {
-      http_server_netconn_serve(newconn);
-      netconn_delete(newconn);
+      /* Hand it to a worker, waits while the queue is full. Idle
+         connections close as soon as they see it counted. */
+      SYS_ARCH_PROTECT(lev);
+      accept_waiting++;
+      SYS_ARCH_UNPROTECT(lev);
+      sys_mbox_post(&accept_mbox, newconn);
     }
   } while(err == ERR_OK);
   LWIP_DEBUGF(HTTPD_DEBUG,
@@ -213,6 +620,19 @@ http_server_netconn_thread(void *arg)
 void
 http_server_netconn_init(void)
 {
+  int i;
+
+  if (sys_sem_new(&file_buf_sem, HTTPD_NUM_FILE_BUFS) != ERR_OK)
+    return;
+  if (sys_mbox_new(&accept_mbox, HTTPD_ACCEPT_QUEUE_LEN) != ERR_OK)
+    return;
+#if LWIP_STATS || LWIP_STATS_LATENCY
+  if (sys_mutex_new(&stats_mutex) != ERR_OK)
+    return;
+#endif
+
+  for (i = 0; i < HTTPD_NUM_WORKERS; i++)
+    sys_thread_new("http_worker", http_server_netconn_worker, (void *) (intptr_t) i, DEFAULT_THREAD_STACKSIZE + 256, DEFAULT_THREAD_PRIO);
   sys_thread_new("http_server_netconn", http_server_netconn_thread, NULL, DEFAULT_THREAD_STACKSIZE + 128, DEFAULT_THREAD_PRIO);
 }
 
@@ -0,0 +1,101 @@
+/*
+ * @brief	Streams the LWIP statistics over UDP
+ *
+ * @note
+ * Every STATS_STREAM_PERIOD_MS a datagram of lpc_stats_pack() is sent to
+ * STATS_STREAM_HOST, port STATS_STREAM_PORT, which tools/statsdump.c
+ * prints. The statistics are the same as those of /stats.json, but can be
+ * followed while the HTTP server is too busy to answer, and sending them
+ * takes no connection of the server that is being measured.
+ */
+
+#include "lwip/opt.h"
+#include "lwip/api.h"
+#include "lwip/ip.h"
+#include "lwip/udp.h"
+#include "lwip/ip_addr.h"
+#include "lwip/sys.h"
+#include "arch/lpc_stats.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Where and how often the statistics are sent; to every host on the
+   network by default */
+#ifndef STATS_STREAM_HOST
+#define STATS_STREAM_HOST       "255.255.255.255"
+#endif
+
+#ifndef STATS_STREAM_PORT
+#define STATS_STREAM_PORT       5555
+#endif
+
+#ifndef STATS_STREAM_PERIOD_MS
+#define STATS_STREAM_PERIOD_MS  1000
+#endif
+
+void stats_stream_init(void);
+
+#if LWIP_NETCONN && LWIP_UDP && (LWIP_STATS || LWIP_STATS_LATENCY)
+
+/* Sends the statistics, never returns; a task that cannot send them
+   deletes itself, as a FreeRTOS task must not return */
+static void stats_stream_thread(void *arg)
+{
+	struct netconn *conn;
+	struct netbuf *buf;
+	ip_addr_t host;
+	u32_t seq = 0;
+	void *data;
+	int len;
+
+	LWIP_UNUSED_ARG(arg);
+
+	LWIP_ERROR("stats_stream: invalid STATS_STREAM_HOST",
+		ipaddr_aton(STATS_STREAM_HOST, &host), goto fail;);
+	conn = netconn_new(NETCONN_UDP);
+	LWIP_ERROR("stats_stream: invalid conn", (conn != NULL), goto fail;);
+#if IP_SOF_BROADCAST
+	ip_set_option(conn->pcb.udp, SOF_BROADCAST);
+#endif
+
+	while (1) {
+		sys_msleep(STATS_STREAM_PERIOD_MS);
+
+		buf = netbuf_new();
+		if (buf == NULL)
+			continue;
+		data = netbuf_alloc(buf, LPC_STATS_PACK_SIZE);
+		if (data != NULL) {
+			len = lpc_stats_pack((u8_t *) data, LPC_STATS_PACK_SIZE, seq);
+			if (len > 0) {
+				pbuf_realloc(buf->p, (u16_t) len);
+				if (netconn_sendto(conn, buf, &host, STATS_STREAM_PORT) == ERR_OK)
+					seq++;
+			}
+		}
+		netbuf_delete(buf);
+	}
+
+fail:
+	vTaskDelete(NULL);
+}
+
+/**
+ * @brief	Start the task that streams the statistics
+ * @return	Nothing
+ * @note	Call after tcpip_init() is done.
+ */
+void stats_stream_init(void)
+{
+	sys_thread_new("stats_stream", stats_stream_thread, NULL, DEFAULT_THREAD_STACKSIZE, DEFAULT_THREAD_PRIO);
+}
+
+#else
+
+void stats_stream_init(void)
+{
+	/* Nothing to stream */
+}
+
+#endif /* LWIP_NETCONN && LWIP_UDP && (LWIP_STATS || LWIP_STATS_LATENCY) */
@@ -67,6 +67,7 @@ static struct netif lpc_netif;
  ****************************************************************************/
 
 extern void http_server_netconn_init(void);
+extern void stats_stream_init(void);
 
 /* Sets up system hardware */
 static void prvSetupHardware(void)
@@ -136,6 +137,7 @@ static void vSetupIFTask(void *pvParameters) {
 	
 	/* Initialize and start application */
 	http_server_netconn_init();
+	stats_stream_init();
 	
 	/* This loop monitors the PHY link and will handle cable events
 	   via the PHY driver. */
@@ -0,0 +1,52 @@
+/*
+ * @brief Host (Linux) stand-in for the FreeRTOS sys_arch.h
+ *
+ * @note
+ * Found ahead of lwip/inc/arch/sys_arch.h by the host benchmark (-I. first
+ * on the include path). Semaphores, mailboxes and threads are built on
+ * pthreads in sys_arch_pthread.c, with the semantics of
+ * lwip/src/arch/sys_arch_freertos.c: a semaphore created with a count
+ * above one counts up to it.
+ */
+
+#ifndef __ARCH_SYS_ARCH_H__
+#define __ARCH_SYS_ARCH_H__
+
+#include "lwip/opt.h"
+
+#include <pthread.h>
+
+struct sys_sem {
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	unsigned int count;
+	unsigned int max;
+};
+
+struct sys_mbox {
+	pthread_mutex_t lock;
+	pthread_cond_t not_empty;
+	pthread_cond_t not_full;
+	void **msgs;
+	int size;
+	int head;
+	int count;
+};
+
+typedef struct sys_sem *sys_sem_t;
+typedef struct sys_sem *sys_mutex_t;
+typedef struct sys_mbox *sys_mbox_t;
+typedef pthread_t sys_thread_t;
+typedef int sys_prot_t;
+
+#define SYS_MBOX_NULL					NULL
+#define SYS_SEM_NULL					NULL
+
+#define sys_mbox_valid( x ) ( ( *x ) != NULL )
+#define sys_mbox_set_invalid( x ) ( ( *x ) = NULL )
+#define sys_sem_valid( x ) ( ( *x ) != NULL )
+#define sys_sem_set_invalid( x ) ( ( *x ) = NULL )
+#define sys_mutex_valid( x ) ( ( *x ) != NULL )
+#define sys_mutex_set_invalid( x ) ( ( *x ) = NULL )
+
+#endif /* __ARCH_SYS_ARCH_H__ */
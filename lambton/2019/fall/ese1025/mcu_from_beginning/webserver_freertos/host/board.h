@@ -0,0 +1,18 @@
+/*
+ * @brief Host (Linux) stand-in for the board layer
+ *
+ * @note
+ * Found ahead of the board library by the host benchmarks that build
+ * lwip_fs.c (-I. first on the include path); of the board layer it only
+ * uses the debug output, which goes to stdout.
+ */
+
+#ifndef __BOARD_H_
+#define __BOARD_H_
+
+#include <stdio.h>
+
+#define DEBUGOUT(...) printf(__VA_ARGS__)
+#define DEBUGSTR(str) fputs(str, stdout)
+
+#endif /* __BOARD_H_ */
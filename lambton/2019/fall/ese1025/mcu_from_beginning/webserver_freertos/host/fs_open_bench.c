@@ -0,0 +1,134 @@
+/*
+ * @brief Host (Linux) benchmark of fs_open() of example/src/lwip_fs.c
+ *
+ * @note
+ * Builds lwip_fs.c unchanged with a flash image written by
+ * tools/makefsdata.c, and times fs_open_enc() and fs_close() of every file
+ * of the image, the way netconn_fs.c opens them for a request: the perfect
+ * hash lookup, the check of the name, and taking and giving back a slot of
+ * the open files. The same names are also looked up with a linear strcmp()
+ * search of the image, as lwIP's fs.c walks the list of fsdata.c, and a
+ * name missing from the image is opened, which falls through to the FAT
+ * file system (not built here). Every open must give the response of the
+ * file it was asked for. The image of example/fs has a single file, so
+ * build one with many:
+ *
+ *	gcc -O2 -o makefsdata ../tools/makefsdata.c -lz
+ *	mkdir -p /tmp/fs1000 && for i in $(seq 1000); do echo $i > /tmp/fs1000/f$i.htm; done
+ *	./makefsdata /tmp/fs1000 /tmp/fsdata_1000.c
+ *	gcc -std=gnu99 -O2 -pthread -I. -I../example/src -I../lwip/inc -I../lwip/inc/ipv4 \
+ *		-o fs_open_bench fs_open_bench.c sys_arch_pthread.c ../example/src/lwip_fs.c \
+ *		/tmp/fsdata_1000.c
+ *	./fs_open_bench [-r rounds]
+ */
+
+#include "lwip/opt.h"
+#include "lwip/sys.h"
+
+#include "lwip_fs.h"
+
+#include <getopt.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* lwIP platform hook */
+void assert_loop(void)
+{
+	printf("lwIP assertion failed\n");
+	abort();
+}
+
+static double now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* The file of the image called name, by a linear search */
+static const struct fsimg_entry *linear_lookup(const char *name)
+{
+	int i;
+
+	for (i = 0; i < fsimg_root.num_files; i++) {
+		if (!strcmp(fsimg_root.files[i].name, name))
+			return &fsimg_root.files[i];
+	}
+	return NULL;
+}
+
+int main(int argc, char *argv[])
+{
+	const struct fsimg *img = &fsimg_root;
+	const struct fsimg_entry *ent;
+	volatile uintptr_t found = 0;
+	struct fs_file *fs;
+	long rounds = 0, r;
+	double t0, t1, t2, t3, opens;
+	int opt, i;
+
+	while ((opt = getopt(argc, argv, "r:")) != -1) {
+		switch (opt) {
+		case 'r':
+			rounds = strtol(optarg, NULL, 0);
+			break;
+		default:
+			printf("usage: %s [-r rounds]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (rounds < 1)
+		rounds = 10000000 / img->num_files;
+	sys_init();
+
+	/* Every file opens to its own response, plain or gzip */
+	for (i = 0; i < img->num_files; i++) {
+		ent = &img->files[i];
+		fs = fs_open_enc(ent->name, 1);
+		if (fs == NULL || fs->data != (ent->gz_data ? ent->gz_data : ent->data) ||
+			fs->len != (int) (ent->gz_data ? ent->gz_len : ent->len) || !fs->data_persistent) {
+			printf("FAILED: %s opened to the wrong response\n", ent->name);
+			return 1;
+		}
+		fs_close(fs);
+		fs = fs_open(ent->name);
+		if (fs == NULL || fs->data != ent->data) {
+			printf("FAILED: %s opened to the wrong plain response\n", ent->name);
+			return 1;
+		}
+		fs_close(fs);
+	}
+	if (fs_open("/not in the image.htm") != NULL) {
+		printf("FAILED: a name missing from the image was opened\n");
+		return 1;
+	}
+
+	t0 = now_ns();
+	for (r = 0; r < rounds; r++) {
+		for (i = 0; i < img->num_files; i++) {
+			fs = fs_open_enc(img->files[i].name, 1);
+			found += (uintptr_t) fs->data;
+			fs_close(fs);
+		}
+	}
+	t1 = now_ns();
+	for (r = 0; r < rounds; r++) {
+		for (i = 0; i < img->num_files; i++)
+			found += (uintptr_t) linear_lookup(img->files[i].name);
+	}
+	t2 = now_ns();
+	for (r = 0; r < rounds * img->num_files; r++)
+		found += (uintptr_t) fs_open("/not in the image.htm");
+	t3 = now_ns();
+
+	opens = (double) rounds * img->num_files;
+	printf("%d files, %u index slots, %u buckets\n", img->num_files, img->index_size,
+		   img->disp_size);
+	printf("fs_open_enc + fs_close %.1f ns, linear search %.1f ns, missing name %.1f ns\n",
+		   (t1 - t0) / opens, (t2 - t1) / opens, (t3 - t2) / opens);
+	return 0;
+}
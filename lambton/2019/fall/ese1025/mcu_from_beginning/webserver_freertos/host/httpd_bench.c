@@ -0,0 +1,492 @@
+/*
+ * @brief Host (Linux) benchmark of the HTTP server of example/src/netconn_fs.c
+ *
+ * @note
+ * Builds netconn_fs.c with the lwIP stack on pthreads (sys_arch_pthread.c)
+ * and fetches files from it over the loopback interface with netconn
+ * clients, which open a connection for each request. The file system is
+ * a stand-in for lwip_fs.c: "/<n>k.bin" is a file of the flash image, sent
+ * by reference, and "/fat/<n>k.bin" one of the FAT file system, read
+ * through the server's pool of HTTPD_NUM_FILE_BUFS buffers, with each read
+ * taking -d microseconds as a card would. For 1 KB, 16 KB and 128 KB files
+ * it reports the requests and bytes per second; every body is checked, and
+ * so is the number of reads in progress at once, which must reach but not
+ * pass HTTPD_NUM_FILE_BUFS when clients compete for the buffers. Then 1, 8
+ * and 32 clients fetch /1k.bin on persistent connections, reconnecting
+ * when the server closes one, while -i idle persistent connections hold
+ * workers; it reports the p50 and p99 request latency, and fails when
+ * requests had to wait for the idle ones to time out:
+ *
+ *	gcc -std=gnu99 -O2 -pthread -I. -I../lwip/inc -I../lwip/inc/ipv4 \
+ *		-o httpd_bench httpd_bench.c sys_arch_pthread.c ../example/src/netconn_fs.c \
+ *		../lwip/src/api/[a-z]*.c ../lwip/src/core/[a-z]*.c \
+ *		../lwip/src/core/ipv4/[a-z]*.c ../lwip/src/netif/etharp.c
+ *	./httpd_bench [-n requests per client] [-c clients] [-d read us] [-i idle]
+ */
+
+#include "lwip/opt.h"
+#include "lwip/api.h"
+#include "lwip/sys.h"
+#include "lwip/tcpip.h"
+
+#include "../example/src/lwip_fs.h"
+
+#include <getopt.h>
+#include <semaphore.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifndef HTTPD_NUM_FILE_BUFS
+#define HTTPD_NUM_FILE_BUFS 2	/* as in netconn_fs.c */
+#endif
+
+#ifndef HTTPD_IDLE_TIMEOUT_MS
+#define HTTPD_IDLE_TIMEOUT_MS 5000	/* as in netconn_fs.c */
+#endif
+
+#define HTTP_PORT       80
+#define MAX_CLIENTS     64
+#define MAX_IDLE        16
+#define HDR_MAX         512
+
+static const int sizes_kb[] = {1, 16, 128};
+#define NUM_SIZES       (sizeof(sizes_kb) / sizeof(sizes_kb[0]))
+
+static const char file_hdr[] = "HTTP/1.1 200 OK\r\nContent-type: application/octet-stream\r\n\r\n";
+static const char notfound_hdr[] = "HTTP/1.1 404 File not found\r\nContent-type: text/html\r\n\r\n";
+
+/* Flash image responses, header and body, one for each size */
+static char *image[NUM_SIZES];
+
+/* Reads of FAT files in progress, and the most there were at once */
+static pthread_mutex_t reads_lock = PTHREAD_MUTEX_INITIALIZER;
+static int reads, reads_peak;
+static int read_us = 50;
+
+/* Byte at offset i of every file body */
+static u8_t body_byte(int i)
+{
+	return (u8_t) (i % 251);
+}
+
+/* lwIP platform hook */
+void assert_loop(void)
+{
+	printf("lwIP assertion failed\n");
+	abort();
+}
+
+/* The file system of lwip_fs.c, as far as netconn_fs.c uses it */
+int GetHTTP_Header(const char *fName, char *buff)
+{
+	LWIP_UNUSED_ARG(fName);
+	strcpy(buff, notfound_hdr);
+	return sizeof(notfound_hdr) - 1;
+}
+
+struct fs_file *fs_open_enc(const char *name, u8_t accept_gzip)
+{
+	struct fs_file *fs;
+	int kb, fat, s;
+	char *hdr;
+
+	LWIP_UNUSED_ARG(accept_gzip);
+	fat = strncmp(name, "/fat", 4) == 0;
+	if (sscanf(name + (fat ? 4 : 0), "/%dk.bin", &kb) != 1)
+		return NULL;
+	for (s = 0; s < (int) NUM_SIZES && sizes_kb[s] != kb; s++) {}
+	if (s == (int) NUM_SIZES)
+		return NULL;
+
+	fs = calloc(1, sizeof(*fs) + (fat ? sizeof(file_hdr) : 0));
+	if (fs == NULL)
+		return NULL;
+	fs->http_header_included = 1;
+	fs->index = sizeof(file_hdr) - 1;
+	fs->len = fs->index + kb * 1024;
+	if (fat) {
+		/* The header is built for each open, as lwip_fs.c does */
+		hdr = (char *) (fs + 1);
+		memcpy(hdr, file_hdr, sizeof(file_hdr));
+		fs->data = hdr;
+	} else {
+		fs->data = image[s];
+		fs->data_persistent = 1;
+	}
+	return fs;
+}
+
+void fs_close(struct fs_file *file)
+{
+	free(file);
+}
+
+int fs_bytes_left(struct fs_file *file)
+{
+	return file->len - file->index;
+}
+
+int fs_read(struct fs_file *file, char *buffer, int count)
+{
+	int i, off = file->index - (int) (sizeof(file_hdr) - 1);
+
+	pthread_mutex_lock(&reads_lock);
+	if (++reads > reads_peak)
+		reads_peak = reads;
+	pthread_mutex_unlock(&reads_lock);
+
+	if (count > fs_bytes_left(file))
+		count = fs_bytes_left(file);
+	for (i = 0; i < count; i++)
+		buffer[i] = body_byte(off + i);
+	if (read_us > 0 && count > 0)
+		usleep(read_us);
+	file->index += count;
+
+	pthread_mutex_lock(&reads_lock);
+	reads--;
+	pthread_mutex_unlock(&reads_lock);
+	return count;
+}
+
+void http_server_netconn_init(void);
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static const int latency_clients[] = {1, 8, 32};
+#define NUM_LATENCY_RUNS (sizeof(latency_clients) / sizeof(latency_clients[0]))
+
+/* One client: fetches the same file again and again, on one persistent
+   connection or a connection each */
+struct client {
+	const char *uri;
+	int requests;
+	int keepalive;
+	uint32_t *lat_us;	/* latency of each request, or NULL */
+	int failed;
+	uint64_t bytes;
+};
+
+/* The clients start together; main waits for all of them to finish */
+static sem_t start_sem, done_sem;
+
+/* The idle connections tell main once they are served, and when closed */
+static sem_t idle_sem;
+static volatile int idle_stop;
+static int idle_closed;
+
+/* Reads one response to the end of its body, checking every byte. Sets
+   *closing when the server closes the connection after it. Returns 1 if
+   the connection closed before the response started, as the server may
+   do to an idle persistent connection, and -1 if the response is wrong. */
+static int client_response(struct netconn *conn, struct client *c, int *closing)
+{
+	char hdr[HDR_MAX];
+	int hlen = 0, clen = -1, got = 0, off;
+	struct netbuf *nb;
+	char *data, *end, *val;
+	u16_t len;
+
+	while (clen < 0 || got < clen) {
+		if (netconn_recv(conn, &nb) != ERR_OK)
+			return (hlen == 0) ? 1 : -1;
+		do {
+			netbuf_data(nb, (void **) &data, &len);
+			off = 0;
+			if (clen < 0) {
+				/* Still in the header */
+				off = LWIP_MIN(len, HDR_MAX - 1 - hlen);
+				memcpy(hdr + hlen, data, off);
+				hlen += off;
+				hdr[hlen] = 0;
+				end = strstr(hdr, "\r\n\r\n");
+				if (end == NULL) {
+					if (hlen == HDR_MAX - 1)
+						goto bad;
+					continue;
+				}
+				val = strstr(hdr, "Content-Length: ");
+				if (strncmp(hdr, "HTTP/1.1 200 ", 13) != 0 || val == NULL)
+					goto bad;
+				clen = atoi(val + 16);
+				*closing = strstr(hdr, "Connection: close") != NULL;
+				/* What came after the header is body */
+				off -= hlen - (int) (end + 4 - hdr);
+			}
+			for (; off < len; off++, got++) {
+				if (got >= clen || (u8_t) data[off] != body_byte(got))
+					goto bad;
+			}
+		} while (netbuf_next(nb) >= 0);
+		netbuf_delete(nb);
+	}
+	c->bytes += clen;
+	return 0;
+
+bad:
+	netbuf_delete(nb);
+	return -1;
+}
+
+static struct netconn *client_connect(void)
+{
+	struct netconn *conn = netconn_new(NETCONN_TCP);
+	ip_addr_t server;
+
+	IP4_ADDR(&server, 127, 0, 0, 1);
+	if (conn != NULL && netconn_connect(conn, &server, HTTP_PORT) != ERR_OK) {
+		netconn_delete(conn);
+		conn = NULL;
+	}
+	return conn;
+}
+
+static void client_close(struct netconn **conn)
+{
+	netconn_close(*conn);
+	netconn_delete(*conn);
+	*conn = NULL;
+}
+
+static void client_thread(void *arg)
+{
+	struct client *c = (struct client *) arg;
+	struct netconn *conn = NULL;
+	char req[128];
+	int i, len, r, served = 0, closing = 0;
+	uint64_t t0;
+
+	sem_wait(&start_sem);
+	len = snprintf(req, sizeof(req), "GET %s HTTP/1.1\r\nHost: bench\r\n%s\r\n", c->uri,
+		c->keepalive ? "" : "Connection: close\r\n");
+	for (i = 0; !c->failed && i < c->requests; i++) {
+		t0 = now_ns();
+		do {
+			if (conn == NULL) {
+				conn = client_connect();
+				served = 0;
+			}
+			if (conn == NULL) {
+				r = -1;
+				break;
+			}
+			r = (netconn_write(conn, req, len, NETCONN_COPY) != ERR_OK) ? 1 :
+				client_response(conn, c, &closing);
+			if (r != 0)
+				client_close(&conn);
+			/* Only a reused connection may be closed under the request */
+		} while (r > 0 && served > 0);
+		if (r != 0) {
+			c->failed = 1;
+			break;
+		}
+		served++;
+		if (c->lat_us != NULL)
+			c->lat_us[i] = (uint32_t) ((now_ns() - t0) / 1000);
+		if (!c->keepalive || closing)
+			client_close(&conn);
+	}
+	if (conn != NULL)
+		client_close(&conn);
+	sem_post(&done_sem);
+}
+
+/* A persistent connection that makes one request and then stays idle,
+   until the server closes it or main stops it */
+static void idle_thread(void *arg)
+{
+	static const char req[] = "GET /1k.bin HTTP/1.1\r\nHost: bench\r\n\r\n";
+	struct client c = {0};
+	struct netconn *conn;
+	struct netbuf *nb;
+	err_t err = ERR_OK;
+	int closing = 0;
+
+	LWIP_UNUSED_ARG(arg);
+	conn = client_connect();
+	if (conn == NULL || netconn_write(conn, req, sizeof(req) - 1, NETCONN_COPY) != ERR_OK ||
+		client_response(conn, &c, &closing) != 0) {
+		printf("FAILED: an idle connection got no response\n");
+		exit(1);
+	}
+	sem_post(&idle_sem);
+
+	netconn_set_recvtimeout(conn, 10);
+	while (!idle_stop && (err = netconn_recv(conn, &nb)) == ERR_TIMEOUT) {}
+	if (err == ERR_OK)
+		netbuf_delete(nb);
+	if (!idle_stop)
+		__sync_fetch_and_add(&idle_closed, 1);
+	netconn_close(conn);
+	netconn_delete(conn);
+	sem_post(&idle_sem);
+}
+
+static int cmp_u32(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *) a, y = *(const uint32_t *) b;
+
+	return (x > y) - (x < y);
+}
+
+/* Runs nclients clients of uri at once; returns 0 if all got every file.
+   lat, when not NULL, gets the latency of each of their requests. */
+static int run(const char *uri, int nclients, int requests, int keepalive, uint32_t *lat,
+	double *secs, uint64_t *bytes)
+{
+	static struct client clients[MAX_CLIENTS];
+	uint64_t t0;
+	int i, failed = 0;
+
+	for (i = 0; i < nclients; i++) {
+		clients[i].uri = uri;
+		clients[i].requests = requests;
+		clients[i].keepalive = keepalive;
+		clients[i].lat_us = (lat != NULL) ? lat + i * requests : NULL;
+		clients[i].failed = 0;
+		clients[i].bytes = 0;
+		sys_thread_new("client", client_thread, &clients[i], 0, 0);
+	}
+	t0 = now_ns();
+	for (i = 0; i < nclients; i++)
+		sem_post(&start_sem);
+	for (i = 0; i < nclients; i++)
+		sem_wait(&done_sem);
+	*secs = (now_ns() - t0) / 1e9;
+
+	*bytes = 0;
+	for (i = 0; i < nclients; i++) {
+		failed |= clients[i].failed;
+		*bytes += clients[i].bytes;
+	}
+	return failed ? -1 : 0;
+}
+
+static void tcpip_ready(void *arg)
+{
+	sys_sem_signal((sys_sem_t *) arg);
+}
+
+static void usage(const char *prog)
+{
+	printf("usage: %s [-n requests per client] [-c clients] [-d read us] [-i idle]\n", prog);
+}
+
+int main(int argc, char **argv)
+{
+	int requests = 200, nclients = 2, nidle = 2, opt, s, fat;
+	sys_sem_t ready;
+	char uri[32];
+	double secs;
+	uint64_t bytes;
+	uint32_t *lat, p50, p99;
+	int i, r, n;
+
+	while ((opt = getopt(argc, argv, "n:c:d:i:")) != -1) {
+		switch (opt) {
+		case 'n':
+			requests = atoi(optarg);
+			break;
+		case 'c':
+			nclients = atoi(optarg);
+			break;
+		case 'd':
+			read_us = atoi(optarg);
+			break;
+		case 'i':
+			nidle = atoi(optarg);
+			break;
+		default:
+			usage(argv[0]);
+			return 2;
+		}
+	}
+	if (requests < 1 || nclients < 1 || nclients > MAX_CLIENTS || read_us < 0 ||
+		nidle < 0 || nidle > MAX_IDLE) {
+		usage(argv[0]);
+		return 2;
+	}
+
+	for (s = 0; s < (int) NUM_SIZES; s++) {
+		image[s] = malloc(sizeof(file_hdr) - 1 + sizes_kb[s] * 1024);
+		memcpy(image[s], file_hdr, sizeof(file_hdr) - 1);
+		for (i = 0; i < sizes_kb[s] * 1024; i++)
+			image[s][sizeof(file_hdr) - 1 + i] = body_byte(i);
+	}
+
+	sys_sem_new(&ready, 0);
+	sem_init(&start_sem, 0, 0);
+	sem_init(&done_sem, 0, 0);
+	sem_init(&idle_sem, 0, 0);
+	tcpip_init(tcpip_ready, &ready);
+	sys_arch_sem_wait(&ready, 0);
+	sys_sem_free(&ready);
+	http_server_netconn_init();
+	usleep(100000);
+
+	printf("%d client(s), %d requests each, %d us per file read\n", nclients, requests, read_us);
+	printf("file            req/s     MB/s\n");
+	for (fat = 0; fat < 2; fat++) {
+		for (s = 0; s < (int) NUM_SIZES; s++) {
+			snprintf(uri, sizeof(uri), "%s/%dk.bin", fat ? "/fat" : "", sizes_kb[s]);
+			if (run(uri, nclients, requests, 0, NULL, &secs, &bytes) != 0) {
+				printf("FAILED: a client of %s got a wrong or no response\n", uri);
+				return 1;
+			}
+			printf("%-14s %7.0f %8.2f\n", uri, nclients * requests / secs, bytes / secs / 1e6);
+		}
+	}
+
+	printf("reads in progress at once: %d of %d file buffers\n", reads_peak, HTTPD_NUM_FILE_BUFS);
+	if (reads_peak > HTTPD_NUM_FILE_BUFS) {
+		printf("FAILED: more reads at once than file buffers\n");
+		return 1;
+	}
+	if (nclients >= HTTPD_NUM_FILE_BUFS && reads_peak < HTTPD_NUM_FILE_BUFS) {
+		printf("FAILED: the clients did not get all the file buffers\n");
+		return 1;
+	}
+
+	printf("\n/1k.bin on persistent connections, %d idle one(s) open, %d requests per client\n",
+		nidle, requests);
+	printf("clients    req/s   p50 us   p99 us   idle closed\n");
+	for (r = 0; r < (int) NUM_LATENCY_RUNS; r++) {
+		n = latency_clients[r];
+		lat = malloc(n * requests * sizeof(*lat));
+		idle_stop = 0;
+		idle_closed = 0;
+		for (i = 0; i < nidle; i++)
+			sys_thread_new("idle", idle_thread, NULL, 0, 0);
+		for (i = 0; i < nidle; i++)
+			sem_wait(&idle_sem);
+
+		if (run("/1k.bin", n, requests, 1, lat, &secs, &bytes) != 0) {
+			printf("FAILED: a persistent client got a wrong or no response\n");
+			return 1;
+		}
+		idle_stop = 1;
+		for (i = 0; i < nidle; i++)
+			sem_wait(&idle_sem);
+
+		qsort(lat, n * requests, sizeof(*lat), cmp_u32);
+		p50 = lat[n * requests / 2];
+		p99 = lat[n * requests * 99 / 100];
+		printf("%7d %8.0f %8u %8u %8d of %d\n", n, n * requests / secs, p50, p99, idle_closed, nidle);
+		free(lat);
+		if (p99 >= HTTPD_IDLE_TIMEOUT_MS * 1000) {
+			printf("FAILED: requests waited for idle connections to time out\n");
+			return 1;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,69 @@
+/*
+ * @brief LWIP build options for the host (Linux) HTTP server benchmark
+ *
+ * @note
+ * Put this directory first on the include path, ahead of example/inc, so
+ * that this file and arch/sys_arch.h are used in place of the MCU's. The
+ * stack runs with its TCP/IP thread on pthreads (sys_arch_pthread.c) and
+ * the clients reach the server over the loopback interface. The mailboxes
+ * and pools are sized for a few dozen connections at once.
+ */
+
+#ifndef __LWIPOPTS_H_
+#define __LWIPOPTS_H_
+
+#define NO_SYS                          0
+#define NO_SYS_NO_TIMERS                0
+#define SYS_LIGHTWEIGHT_PROT            1
+
+/* As on the MCU: TCP asserts that its headers are aligned to this */
+#define MEM_ALIGNMENT                   4
+#define MEM_LIBC_MALLOC                 1
+/* mem.h maps mem_malloc() to malloc() without declaring it, which would
+   cut the pointers to an int on the 64-bit host */
+#include <stdlib.h>
+#define MEMP_MEM_MALLOC                 1
+#define MEM_SIZE                        (1024 * 1024)
+#define PBUF_POOL_SIZE                  64
+
+#define MEMP_NUM_TCP_PCB                128
+#define MEMP_NUM_NETCONN                128
+#define MEMP_NUM_SYS_TIMEOUT            64
+
+/* Nothing is lost or corrupted on the loopback interface */
+#define CHECKSUM_CHECK_IP               0
+#define CHECKSUM_CHECK_UDP              0
+#define CHECKSUM_CHECK_TCP              0
+#define LWIP_CHECKSUM_ON_COPY           1
+
+#define LWIP_RAW                        0
+#define LWIP_DHCP                       0
+#define LWIP_UDP                        1
+#define LWIP_SOCKET                     0
+#define LWIP_NETCONN                    1
+#define LWIP_SO_RCVTIMEO                1
+
+#define LWIP_HAVE_LOOPIF                1
+#define LWIP_NETIF_LOOPBACK             1
+#define LWIP_LOOPBACK_MAX_PBUFS         0
+
+#define TCP_MSS                         1460
+#define TCP_SND_BUF                     (2 * TCP_MSS)
+#define TCP_WND                         (4 * TCP_MSS)
+/* The benchmark opens thousands of connections; do not let the closed
+   ones sit in TIME_WAIT for a minute */
+#define TCP_MSL                         1000UL
+
+#define DEFAULT_THREAD_PRIO             0
+#define DEFAULT_THREAD_STACKSIZE        0
+#define DEFAULT_ACCEPTMBOX_SIZE         64
+#define DEFAULT_TCP_RECVMBOX_SIZE       16
+#define DEFAULT_UDP_RECVMBOX_SIZE       16
+#define TCPIP_THREAD_PRIO               0
+#define TCPIP_THREAD_STACKSIZE          0
+#define TCPIP_MBOX_SIZE                 256
+
+#define LWIP_STATS                      0
+#define LWIP_STATS_LATENCY              0
+
+#endif /* __LWIPOPTS_H_ */
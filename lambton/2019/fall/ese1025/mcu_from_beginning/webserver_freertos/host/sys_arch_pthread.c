@@ -0,0 +1,322 @@
+/*
+ * @brief Host (Linux) sys_arch on pthreads for the HTTP server benchmark
+ *
+ * @note
+ * Stands in for lwip/src/arch/sys_arch_freertos.c, with the same meaning
+ * for every call: a semaphore created with a count of 0 or 1 is binary and
+ * one created with a larger count counts up to it, a mailbox holds the
+ * number of messages it was created with and sys_mbox_post() waits while
+ * it is full, and a timeout of 0 waits forever. Threads are detached and
+ * ignore the stack size and priority. SYS_ARCH_PROTECT takes one recursive
+ * mutex, as disabling interrupts would on the MCU.
+ */
+
+#include "lwip/opt.h"
+#include "lwip/sys.h"
+#include "lwip/stats.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <time.h>
+
+static pthread_mutex_t protect_lock;
+
+/* Absolute CLOCK_MONOTONIC time ms from now, for the timed waits */
+static void deadline(struct timespec *ts, u32_t ms)
+{
+	clock_gettime(CLOCK_MONOTONIC, ts);
+	ts->tv_sec += ms / 1000;
+	ts->tv_nsec += (long) (ms % 1000) * 1000000L;
+	if (ts->tv_nsec >= 1000000000L) {
+		ts->tv_sec++;
+		ts->tv_nsec -= 1000000000L;
+	}
+}
+
+static void cond_init(pthread_cond_t *cond)
+{
+	pthread_condattr_t attr;
+
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(cond, &attr);
+	pthread_condattr_destroy(&attr);
+}
+
+/* Waits on cond for at most timeout ms, or forever if timeout is 0.
+   Returns 0 when woken, -1 once the time is up. */
+static int cond_wait(pthread_cond_t *cond, pthread_mutex_t *lock, u32_t timeout,
+	const struct timespec *until)
+{
+	if (timeout == 0) {
+		pthread_cond_wait(cond, lock);
+		return 0;
+	}
+	return (pthread_cond_timedwait(cond, lock, until) == ETIMEDOUT) ? -1 : 0;
+}
+
+void sys_init(void)
+{
+	pthread_mutexattr_t attr;
+
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init(&protect_lock, &attr);
+	pthread_mutexattr_destroy(&attr);
+}
+
+u32_t sys_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (u32_t) (ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+sys_prot_t sys_arch_protect(void)
+{
+	pthread_mutex_lock(&protect_lock);
+	return 0;
+}
+
+void sys_arch_unprotect(sys_prot_t pval)
+{
+	LWIP_UNUSED_ARG(pval);
+	pthread_mutex_unlock(&protect_lock);
+}
+
+err_t sys_sem_new(sys_sem_t *sem, u8_t count)
+{
+	struct sys_sem *s = malloc(sizeof(*s));
+
+	if (s == NULL) {
+		return ERR_MEM;
+	}
+	pthread_mutex_init(&s->lock, NULL);
+	cond_init(&s->cond);
+	s->count = count;
+	s->max = (count > 1) ? count : 1;
+	*sem = s;
+	SYS_STATS_INC_USED(sem);
+	return ERR_OK;
+}
+
+void sys_sem_free(sys_sem_t *sem)
+{
+	pthread_cond_destroy(&(*sem)->cond);
+	pthread_mutex_destroy(&(*sem)->lock);
+	free(*sem);
+	SYS_STATS_DEC(sem.used);
+}
+
+void sys_sem_signal(sys_sem_t *sem)
+{
+	struct sys_sem *s = *sem;
+
+	pthread_mutex_lock(&s->lock);
+	if (s->count < s->max) {
+		s->count++;
+	}
+	pthread_cond_signal(&s->cond);
+	pthread_mutex_unlock(&s->lock);
+}
+
+u32_t sys_arch_sem_wait(sys_sem_t *sem, u32_t timeout)
+{
+	struct sys_sem *s = *sem;
+	struct timespec until;
+	u32_t start = sys_now();
+
+	deadline(&until, timeout);
+	pthread_mutex_lock(&s->lock);
+	while (s->count == 0) {
+		if (cond_wait(&s->cond, &s->lock, timeout, &until) < 0) {
+			pthread_mutex_unlock(&s->lock);
+			return SYS_ARCH_TIMEOUT;
+		}
+	}
+	s->count--;
+	pthread_mutex_unlock(&s->lock);
+	return sys_now() - start;
+}
+
+err_t sys_mutex_new(sys_mutex_t *mutex)
+{
+	return sys_sem_new(mutex, 1);
+}
+
+void sys_mutex_lock(sys_mutex_t *mutex)
+{
+	sys_arch_sem_wait(mutex, 0);
+}
+
+void sys_mutex_unlock(sys_mutex_t *mutex)
+{
+	sys_sem_signal(mutex);
+}
+
+void sys_mutex_free(sys_mutex_t *mutex)
+{
+	sys_sem_free(mutex);
+}
+
+err_t sys_mbox_new(sys_mbox_t *mbox, int size)
+{
+	struct sys_mbox *m = malloc(sizeof(*m));
+
+	if (m == NULL) {
+		return ERR_MEM;
+	}
+	m->msgs = malloc(size * sizeof(void *));
+	if (m->msgs == NULL) {
+		free(m);
+		return ERR_MEM;
+	}
+	pthread_mutex_init(&m->lock, NULL);
+	cond_init(&m->not_empty);
+	cond_init(&m->not_full);
+	m->size = size;
+	m->head = 0;
+	m->count = 0;
+	*mbox = m;
+	SYS_STATS_INC_USED(mbox);
+	return ERR_OK;
+}
+
+void sys_mbox_free(sys_mbox_t *mbox)
+{
+	struct sys_mbox *m = *mbox;
+
+	LWIP_ASSERT("mailbox freed with messages in it", m->count == 0);
+	pthread_cond_destroy(&m->not_empty);
+	pthread_cond_destroy(&m->not_full);
+	pthread_mutex_destroy(&m->lock);
+	free(m->msgs);
+	free(m);
+	SYS_STATS_DEC(mbox.used);
+}
+
+/* Adds msg at the tail of m, which has room for it; called locked */
+static void mbox_put(struct sys_mbox *m, void *msg)
+{
+	m->msgs[(m->head + m->count) % m->size] = msg;
+	m->count++;
+	pthread_cond_signal(&m->not_empty);
+}
+
+void sys_mbox_post(sys_mbox_t *mbox, void *msg)
+{
+	struct sys_mbox *m = *mbox;
+
+	pthread_mutex_lock(&m->lock);
+	while (m->count == m->size) {
+		pthread_cond_wait(&m->not_full, &m->lock);
+	}
+	mbox_put(m, msg);
+	pthread_mutex_unlock(&m->lock);
+}
+
+err_t sys_mbox_trypost(sys_mbox_t *mbox, void *msg)
+{
+	struct sys_mbox *m = *mbox;
+	err_t err = ERR_MEM;
+
+	pthread_mutex_lock(&m->lock);
+	if (m->count < m->size) {
+		mbox_put(m, msg);
+		err = ERR_OK;
+	}
+	pthread_mutex_unlock(&m->lock);
+	if (err != ERR_OK) {
+		SYS_STATS_INC(mbox.err);
+	}
+	return err;
+}
+
+/* Takes the message at the head of m, which has one; called locked */
+static void *mbox_get(struct sys_mbox *m)
+{
+	void *msg = m->msgs[m->head];
+
+	m->head = (m->head + 1) % m->size;
+	m->count--;
+	pthread_cond_signal(&m->not_full);
+	return msg;
+}
+
+u32_t sys_arch_mbox_fetch(sys_mbox_t *mbox, void **msg, u32_t timeout)
+{
+	struct sys_mbox *m = *mbox;
+	struct timespec until;
+	u32_t start = sys_now();
+	void *got;
+
+	deadline(&until, timeout);
+	pthread_mutex_lock(&m->lock);
+	while (m->count == 0) {
+		if (cond_wait(&m->not_empty, &m->lock, timeout, &until) < 0) {
+			pthread_mutex_unlock(&m->lock);
+			if (msg != NULL) {
+				*msg = NULL;
+			}
+			return SYS_ARCH_TIMEOUT;
+		}
+	}
+	got = mbox_get(m);
+	pthread_mutex_unlock(&m->lock);
+	if (msg != NULL) {
+		*msg = got;
+	}
+	return sys_now() - start;
+}
+
+u32_t sys_arch_mbox_tryfetch(sys_mbox_t *mbox, void **msg)
+{
+	struct sys_mbox *m = *mbox;
+	void *got;
+
+	pthread_mutex_lock(&m->lock);
+	if (m->count == 0) {
+		pthread_mutex_unlock(&m->lock);
+		return SYS_MBOX_EMPTY;
+	}
+	got = mbox_get(m);
+	pthread_mutex_unlock(&m->lock);
+	if (msg != NULL) {
+		*msg = got;
+	}
+	return 0;
+}
+
+struct thread_start {
+	lwip_thread_fn fn;
+	void *arg;
+};
+
+static void *thread_main(void *p)
+{
+	struct thread_start start = *(struct thread_start *) p;
+
+	free(p);
+	start.fn(start.arg);
+	return NULL;
+}
+
+sys_thread_t sys_thread_new(const char *name, lwip_thread_fn thread, void *arg,
+	int stacksize, int prio)
+{
+	struct thread_start *start = malloc(sizeof(*start));
+	pthread_t t;
+
+	LWIP_UNUSED_ARG(name);
+	LWIP_UNUSED_ARG(stacksize);
+	LWIP_UNUSED_ARG(prio);
+	LWIP_ASSERT("out of memory for a thread", start != NULL);
+	start->fn = thread;
+	start->arg = arg;
+	if (pthread_create(&t, NULL, thread_main, start) != 0) {
+		LWIP_ASSERT("pthread_create failed", 0);
+	}
+	pthread_detach(t);
+	return t;
+}
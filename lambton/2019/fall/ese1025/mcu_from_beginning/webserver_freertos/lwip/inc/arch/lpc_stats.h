@@ -0,0 +1,143 @@
+/*
+ * @brief	LWIP statistics and receive latency for the LPC17xx/40xx
+ *
+ * @note
+ * With LWIP_STATS_LATENCY, received packets are stamped with the DWT cycle
+ * counter in the EMAC interrupt, in lpc_low_level_input(), ip_input(),
+ * tcp_input() and where the application gets the data. Each layer keeps a
+ * histogram of the cycles packets took to reach it from the layer before,
+ * and the interrupt one of its own run time. The histograms are only ever
+ * added to, with LDREX/STREX on the Cortex-M3, so the interrupt, the driver
+ * task, the TCP/IP thread and the application tasks update them without a
+ * lock, and readers take them as they are. lwip_stats, with the memp
+ * high-water marks, is read the same way; a reading may be off by the
+ * packets counted while it was taken, but is never torn within a counter.
+ */
+
+#ifndef __LPC_STATS_H_
+#define __LPC_STATS_H_
+
+#include "lwip/opt.h"
+#include "lwip/pbuf.h"
+#include "lwip/memp.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** @defgroup NET_LWIP_LPC_STATS LWIP statistics and receive latency
+ * @ingroup NET_LWIP
+ * @{
+ */
+
+/** @brief Where received packets are stamped, in the order they get there
+ */
+typedef enum {
+	LPC_STATS_IRQ,						/**< EMAC interrupt, its own run time */
+	LPC_STATS_RX,						/**< lpc_low_level_input(), from the frame's arrival */
+	LPC_STATS_IP,						/**< ip_input(), from lpc_low_level_input() */
+	LPC_STATS_TCP,						/**< tcp_input(), from ip_input() */
+	LPC_STATS_APP,						/**< Application, from tcp_input() */
+	LPC_STATS_LAYERS
+} lpc_stats_layer_t;
+
+/** @brief Histogram buckets
+ * Bucket 0 counts latencies below 2^LPC_STATS_BUCKET0_BITS cycles, bucket
+ * i those of 2^(i+LPC_STATS_BUCKET0_BITS-1) to twice that, and the last
+ * bucket all that are longer. At 120 MHz that is 1 us to 280 ms.
+ */
+#define LPC_STATS_BUCKETS       20
+#define LPC_STATS_BUCKET0_BITS  7
+
+/** @brief Latency histogram of one layer
+ */
+typedef struct {
+	u32_t bucket[LPC_STATS_BUCKETS];	/**< Packets by log2 of the latency */
+	u32_t max;							/**< Longest latency in cycles */
+} lpc_stats_hist_t;
+
+/** @brief Instrumentation data, lwip_stats aside
+ */
+typedef struct {
+	lpc_stats_hist_t hist[LPC_STATS_LAYERS];	/**< Latency by layer */
+	u32_t stamp_cycles;					/**< Cycles one stamp costs, measured by lpc_stats_init() */
+	u32_t start_ms;						/**< sys_now() at lpc_stats_init() */
+} lpc_stats_t;
+
+extern lpc_stats_t lpc_stats;
+
+/** @brief Longest pool name in a datagram of lpc_stats_pack() */
+#define LPC_STATS_NAME_MAX      15
+
+/** @brief Size of the largest datagram lpc_stats_pack() makes
+ */
+#define LPC_STATS_PACK_SIZE     (24 + LPC_STATS_LAYERS * 4 * (1 + LPC_STATS_BUCKETS) + \
+								 4 * 7 * 4 + MEMP_MAX * (7 + LPC_STATS_NAME_MAX))
+
+/**
+ * @brief	Start the cycle counter and measure the cost of a stamp
+ * @return	Nothing
+ * @note	Called by lpc_enetif_init(), before the EMAC interrupt is enabled.
+ */
+void lpc_stats_init(void);
+
+/**
+ * @brief	Read the DWT cycle counter
+ * @return	Cycles since the counter was started, modulo 2^32
+ */
+u32_t lpc_stats_now(void);
+
+/**
+ * @brief	Count a latency in the histogram of a layer
+ * @param	layer	: Layer to count it for
+ * @param	cycles	: Latency in cycles
+ * @return	Nothing
+ * @note	Lock-free, can be called from an interrupt.
+ */
+void lpc_stats_add(lpc_stats_layer_t layer, u32_t cycles);
+
+/**
+ * @brief	Stamp a received packet as it reaches a layer
+ * @param	layer	: Layer it has reached
+ * @param	p		: First pbuf of the packet
+ * @return	Nothing
+ * @note	Counts the time since the packet was last stamped in the histogram
+ * of the layer. Packets that were never stamped are only stamped.
+ */
+void lpc_stats_stamp(lpc_stats_layer_t layer, struct pbuf *p);
+
+/**
+ * @brief	Write the statistics as a JSON object
+ * @param	buf		: Buffer to write to
+ * @param	size	: Size of buf
+ * @return	Length of the text, without the terminating NUL, or -1 when it
+ * does not fit
+ */
+int lpc_stats_json(char *buf, int size);
+
+/**
+ * @brief	Pack the statistics into a datagram
+ * @param	buf		: Buffer to pack into, LPC_STATS_PACK_SIZE bytes will do
+ * @param	size	: Size of buf
+ * @param	seq		: Sequence number of the datagram
+ * @return	Length of the datagram, or -1 when it does not fit
+ * @note	All numbers are big-endian: "LS", version 1, the number of layers,
+ * buckets, bucket 0 bits, protocols and pools (one byte each), the sequence
+ * number, sys_now(), the core clock and the cycles per stamp (4 bytes
+ * each). Then for each layer the longest latency and the buckets, for the
+ * link, IP, TCP and UDP the xmit, recv, drop, chkerr, lenerr, memerr and
+ * err counts (4 bytes each), and for each pool its name (length byte and
+ * characters) and its used, max and err counts (2 bytes each).
+ */
+int lpc_stats_pack(u8_t *buf, int size, u32_t seq);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LPC_STATS_H_ */
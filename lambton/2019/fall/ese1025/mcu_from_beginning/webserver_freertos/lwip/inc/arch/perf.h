@@ -32,7 +32,18 @@
 #ifndef __PERF_H__
 #define __PERF_H__
 
+#include "lwip/opt.h"
+
 #define PERF_START    /* null definition */
 #define PERF_STOP(x)  /* null definition */
 
+/* Stamps a received packet as it reaches a layer of the stack, see
+   arch/lpc_stats.h */
+#if LWIP_STATS_LATENCY
+#include "arch/lpc_stats.h"
+#define PERF_RX_STAMP(layer, p) lpc_stats_stamp(LPC_STATS_##layer, (p))
+#else
+#define PERF_RX_STAMP(layer, p) /* null definition */
+#endif
+
 #endif /* __PERF_H__ */
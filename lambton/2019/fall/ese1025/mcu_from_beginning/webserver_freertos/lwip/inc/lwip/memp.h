@@ -84,8 +84,14 @@ extern const u16_t memp_sizes[MEMP_MAX];
 #include "mem.h"
 
 #define memp_init()
+#if MEMP_STATS
+/* Count what each pool has on the heap, as if it were a real pool */
+void *memp_malloc(memp_t type);
+void  memp_free(memp_t type, void *mem);
+#else /* MEMP_STATS */
 #define memp_malloc(type)     mem_malloc(memp_sizes[type])
 #define memp_free(type, mem)  mem_free(mem)
+#endif /* MEMP_STATS */
 
 #else /* MEMP_MEM_MALLOC */
 
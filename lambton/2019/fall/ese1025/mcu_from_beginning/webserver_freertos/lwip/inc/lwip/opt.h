@@ -1615,6 +1615,15 @@
 
 #endif /* LWIP_STATS */
 
+/**
+ * LWIP_STATS_LATENCY==1: Give each pbuf a timestamp, so that the port can
+ * measure how long a received packet takes from one layer to the next.
+ * ip_input() and tcp_input() call PERF_RX_STAMP() from arch/perf.h.
+ */
+#ifndef LWIP_STATS_LATENCY
+#define LWIP_STATS_LATENCY              0
+#endif
+
 /*
    ---------------------------------
    ---------- PPP options ----------
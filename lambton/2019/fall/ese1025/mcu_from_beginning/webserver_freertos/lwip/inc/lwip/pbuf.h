@@ -107,6 +107,12 @@ struct pbuf {
    * the stack itself, or pbuf->next pointers from a chain.
    */
   u16_t ref;
+
+#if LWIP_STATS_LATENCY
+  /** time the packet reached the last layer that stamped it, 0 if none
+      has; kept in the first pbuf of a chain only */
+  u32_t stamp;
+#endif /* LWIP_STATS_LATENCY */
 };
 
 #if LWIP_SUPPORT_CUSTOM_PBUF
@@ -41,6 +41,7 @@
 
 #include "lpc_17xx40xx_emac_config.h"
 #include "arch/lpc17xx_40xx_emac.h"
+#include "arch/lpc_stats.h"
 
 #include "chip.h"
 #include "board.h"
@@ -117,6 +118,10 @@ typedef struct {
 	struct pbuf *txb[LPC_NUM_BUFF_TXDESCS];		/**< TX pbuf pointer list, zero-copy mode */
 
 	u32_t lpc_last_tx_idx;						/**< TX last descriptor index, zero-copy mode */
+#if LWIP_STATS_LATENCY
+	u32_t rx_stamp[LPC_NUM_BUFF_RXDESCS];		/**< Cycle counter when each RX descriptor was found filled */
+	u32_t rx_stamp_idx;							/**< RX descriptor the next frame to arrive is stamped in */
+#endif
 #if NO_SYS == 0
 	sys_sem_t rx_sem;							/**< RX receive thread wakeup semaphore */
 	sys_sem_t tx_clean_sem;						/**< TX cleanup thread wakeup semaphore */
@@ -178,6 +183,9 @@ STATIC err_t lpc_rx_setup(lpc_enetdata_t *lpc_enetif)
 
 	lpc_enetif->rx_free_descs = LPC_NUM_BUFF_RXDESCS;
 	lpc_enetif->rx_fill_desc_index = 0;
+#if LWIP_STATS_LATENCY
+	lpc_enetif->rx_stamp_idx = 0;
+#endif
 
 	/* Build RX buffer and descriptors */
 	lpc_rx_queue(lpc_enetif->pnetif);
@@ -185,11 +193,38 @@ STATIC err_t lpc_rx_setup(lpc_enetdata_t *lpc_enetif)
 	return ERR_OK;
 }
 
+#if LWIP_STATS_LATENCY
+/* Stamps the RX descriptors the EMAC has filled since the last call with
+   now, so that each frame keeps the time it was first found to have
+   arrived. Called from the RX interrupt, and from lpc_low_level_input()
+   for frames the interrupt has not seen yet. */
+STATIC void lpc_rx_stamp_arrivals(lpc_enetdata_t *lpc_enetif, u32_t now)
+{
+	u32_t idx = lpc_enetif->rx_stamp_idx;
+	u32_t produce = Chip_ENET_GetRXProduceIndex(LPC_ETHERNET);
+
+	/* Never 0, that is an unstamped packet */
+	now |= 1;
+	while (idx != produce) {
+		lpc_enetif->rx_stamp[idx] = now;
+		idx++;
+		if (idx >= LPC_NUM_BUFF_RXDESCS) {
+			idx = 0;
+		}
+	}
+	lpc_enetif->rx_stamp_idx = idx;
+}
+
+#endif
+
 /* Allocates a pbuf and returns the data from the incoming packet */
 STATIC struct pbuf *lpc_low_level_input(struct netif *netif) {
 	lpc_enetdata_t *lpc_enetif = netif->state;
 	struct pbuf *p = NULL;
 	u32_t idx, length;
+#if LWIP_STATS_LATENCY
+	SYS_ARCH_DECL_PROTECT(lev);
+#endif
 
 #ifdef LOCK_RX_THREAD
 #if NO_SYS == 0
@@ -241,6 +276,13 @@ STATIC struct pbuf *lpc_low_level_input(struct netif *netif) {
 	length = 0;
 	idx = Chip_ENET_GetRXConsumeIndex(LPC_ETHERNET);
 	if (!Chip_ENET_IsRxEmpty(LPC_ETHERNET)) {
+#if LWIP_STATS_LATENCY
+		/* Frames the RX interrupt has not seen yet are stamped now */
+		SYS_ARCH_PROTECT(lev);
+		lpc_rx_stamp_arrivals(lpc_enetif, lpc_stats_now());
+		SYS_ARCH_UNPROTECT(lev);
+#endif
+
 		/* Handle errors */
 		if (lpc_enetif->prxs[idx].StatusInfo & (ENET_RINFO_CRC_ERR |
 												ENET_RINFO_SYM_ERR | ENET_RINFO_ALIGN_ERR | ENET_RINFO_LEN_ERR)) {
@@ -304,6 +346,12 @@ STATIC struct pbuf *lpc_low_level_input(struct netif *netif) {
 				/* Save size */
 				p->tot_len = (u16_t) length;
 				LINK_STATS_INC(link.recv);
+
+#if LWIP_STATS_LATENCY
+				/* Time from when the frame was found in its descriptor */
+				p->stamp = lpc_enetif->rx_stamp[idx];
+				lpc_stats_stamp(LPC_STATS_RX, p);
+#endif
 			}
 		}
 
@@ -766,6 +814,9 @@ void ETH_IRQHandler(void)
 #else
 	signed portBASE_TYPE xRecTaskWoken = pdFALSE, XTXTaskWoken = pdFALSE;
 	uint32_t ints;
+#if LWIP_STATS_LATENCY
+	u32_t start = lpc_stats_now();
+#endif
 
 	/* Interrupts are of 2 groups - transmit or receive. Based on the
 	   interrupt, kick off the receive or transmit (cleanup) task */
@@ -774,6 +825,11 @@ void ETH_IRQHandler(void)
 	ints = Chip_ENET_GetIntStatus(LPC_ETHERNET);
 
 	if (ints & RXINTGROUP) {
+#if LWIP_STATS_LATENCY
+		/* Stamp the frames that have arrived since the last one */
+		lpc_rx_stamp_arrivals(&lpc_enetdata, start);
+#endif
+
 		/* RX group interrupt(s) */
 		/* Give semaphore to wakeup RX receive task. Note the FreeRTOS
 		   method is used instead of the LWIP arch method. */
@@ -790,6 +846,10 @@ void ETH_IRQHandler(void)
 	/* Clear pending interrupts */
 	Chip_ENET_ClearIntStatus(LPC_ETHERNET, ints);
 
+#if LWIP_STATS_LATENCY
+	lpc_stats_add(LPC_STATS_IRQ, lpc_stats_now() - start);
+#endif
+
 	/* Context switch needed? */
 	portEND_SWITCHING_ISR(xRecTaskWoken || XTXTaskWoken);
 #endif
@@ -837,6 +897,11 @@ err_t lpc_enetif_init(struct netif *netif)
 	netif->flags = NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP | NETIF_FLAG_UP |
 				   NETIF_FLAG_ETHERNET;
 
+#if LWIP_STATS || LWIP_STATS_LATENCY
+	/* Before any packet can be stamped */
+	lpc_stats_init();
+#endif
+
 	/* Initialize the hardware */
 	netif->state = &lpc_enetdata;
 	err = low_level_init(netif);
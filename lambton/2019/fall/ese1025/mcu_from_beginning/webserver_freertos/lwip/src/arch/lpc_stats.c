@@ -0,0 +1,420 @@
+/*
+ * @brief	LWIP statistics and receive latency for the LPC17xx/40xx
+ *
+ * @note
+ * See arch/lpc_stats.h. The cost of a stamp is measured once at start-up,
+ * and the JSON gives the share of the CPU the stamps have taken since as
+ * overhead_ppm.
+ */
+
+#include "lwip/opt.h"
+
+#if LWIP_STATS || LWIP_STATS_LATENCY
+
+#include "lwip/def.h"
+#include "lwip/sys.h"
+#include "lwip/stats.h"
+#include "arch/lpc_stats.h"
+
+#include "chip.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+/** @ingroup NET_LWIP_LPC_STATS
+ * @{
+ */
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Stamps timed by lpc_stats_init() */
+#define LPC_STATS_CALIBRATE     64
+
+/* Counters of each protocol, as in the datagram */
+#define LPC_STATS_PROTOS        4
+#define LPC_STATS_COUNTERS      7
+
+/* Text being written by lpc_stats_json() */
+typedef struct {
+	char *buf;
+	int size;
+	int len;							/* -1 once it does not fit */
+} lpc_stats_text_t;
+
+static const char *const lpc_stats_layer_names[LPC_STATS_LAYERS] = {
+	"irq", "rx", "ip", "tcp", "app"
+};
+
+#if LWIP_STATS
+static const char *const lpc_stats_proto_names[LPC_STATS_PROTOS] = {
+	"link", "ip", "tcp", "udp"
+};
+
+static const char *const lpc_stats_counter_names[LPC_STATS_COUNTERS] = {
+	"xmit", "recv", "drop", "chkerr", "lenerr", "memerr", "err"
+};
+
+/* Counters of the protocols, NULL for those lwIP does not keep */
+static struct stats_proto *const lpc_stats_protos[LPC_STATS_PROTOS] = {
+#if LINK_STATS
+	&lwip_stats.link,
+#else
+	NULL,
+#endif
+#if IP_STATS
+	&lwip_stats.ip,
+#else
+	NULL,
+#endif
+#if TCP_STATS
+	&lwip_stats.tcp,
+#else
+	NULL,
+#endif
+#if UDP_STATS
+	&lwip_stats.udp,
+#else
+	NULL,
+#endif
+};
+
+#if MEMP_STATS
+static const char *const lpc_stats_memp_names[MEMP_MAX] = {
+#define LWIP_MEMPOOL(name,num,size,desc)  desc,
+#include "lwip/memp_std.h"
+};
+#endif /* MEMP_STATS */
+#endif /* LWIP_STATS */
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/* Latency histograms */
+lpc_stats_t lpc_stats;
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+#if defined(__GNUC__)
+/* LDREX/STREX on the Cortex-M3 */
+STATIC INLINE void lpc_stats_inc(u32_t *x)
+{
+	__sync_fetch_and_add(x, 1);
+}
+
+STATIC INLINE void lpc_stats_raise(u32_t *max, u32_t v)
+{
+	u32_t old;
+
+	while ((old = *(volatile u32_t *) max) < v &&
+		   !__sync_bool_compare_and_swap(max, old, v)) {}
+}
+
+#else
+/* With the interrupts off for the few cycles it takes */
+STATIC INLINE void lpc_stats_inc(u32_t *x)
+{
+	u32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	(*x)++;
+	__set_PRIMASK(primask);
+}
+
+STATIC INLINE void lpc_stats_raise(u32_t *max, u32_t v)
+{
+	u32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	if (*max < v) {
+		*max = v;
+	}
+	__set_PRIMASK(primask);
+}
+
+#endif
+
+/* Packets counted in a histogram */
+static u32_t lpc_stats_count(const lpc_stats_hist_t *h)
+{
+	u32_t n = 0;
+	int i;
+
+	for (i = 0; i < LPC_STATS_BUCKETS; i++) {
+		n += h->bucket[i];
+	}
+	return n;
+}
+
+/* Share of the CPU the stamps have taken since lpc_stats_init() */
+static u32_t lpc_stats_overhead_ppm(void)
+{
+	uint64_t stamps = 0;
+	uint64_t cycles = (uint64_t) (sys_now() - lpc_stats.start_ms) * (SystemCoreClock / 1000);
+	int i;
+
+	for (i = 0; i < LPC_STATS_LAYERS; i++) {
+		stamps += lpc_stats_count(&lpc_stats.hist[i]);
+	}
+	if (cycles == 0) {
+		return 0;
+	}
+	return (u32_t) (stamps * lpc_stats.stamp_cycles * 1000000 / cycles);
+}
+
+/* Append to the text, unless it has run out of room already */
+static void lpc_stats_print(lpc_stats_text_t *t, const char *fmt, ...)
+{
+	va_list ap;
+	int n;
+
+	if (t->len < 0) {
+		return;
+	}
+	va_start(ap, fmt);
+	n = vsnprintf(t->buf + t->len, t->size - t->len, fmt, ap);
+	va_end(ap);
+	t->len = (n < 0 || n >= t->size - t->len) ? -1 : t->len + n;
+}
+
+static u8_t *lpc_stats_put32(u8_t *p, u32_t v)
+{
+	p[0] = (u8_t) (v >> 24);
+	p[1] = (u8_t) (v >> 16);
+	p[2] = (u8_t) (v >> 8);
+	p[3] = (u8_t) v;
+	return p + 4;
+}
+
+#if LWIP_STATS
+#if MEMP_STATS
+static u8_t *lpc_stats_put16(u8_t *p, u32_t v)
+{
+	if (v > 0xFFFF) {
+		v = 0xFFFF;
+	}
+	p[0] = (u8_t) (v >> 8);
+	p[1] = (u8_t) v;
+	return p + 2;
+}
+
+#endif /* MEMP_STATS */
+
+/* Counter i of a protocol, in the order of lpc_stats_counter_names */
+static u32_t lpc_stats_counter(const struct stats_proto *proto, int i)
+{
+	switch (i) {
+	case 0: return proto->xmit;
+	case 1: return proto->recv;
+	case 2: return proto->drop;
+	case 3: return proto->chkerr;
+	case 4: return proto->lenerr;
+	case 5: return proto->memerr;
+	default: return proto->err;
+	}
+}
+
+#endif /* LWIP_STATS */
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Start the cycle counter and measure the cost of a stamp */
+void lpc_stats_init(void)
+{
+#if LWIP_STATS_LATENCY
+	struct pbuf p;
+	u32_t start;
+	int i;
+#endif
+
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	memset(&lpc_stats, 0, sizeof(lpc_stats));
+
+#if LWIP_STATS_LATENCY
+	/* Stamp a packet over and over, in the histogram of the last layer
+	   which is cleared again after */
+	p.stamp = 0;
+	start = DWT->CYCCNT;
+	for (i = 0; i < LPC_STATS_CALIBRATE; i++) {
+		lpc_stats_stamp(LPC_STATS_APP, &p);
+	}
+	lpc_stats.stamp_cycles = (DWT->CYCCNT - start) / LPC_STATS_CALIBRATE;
+	memset(&lpc_stats.hist[LPC_STATS_APP], 0, sizeof(lpc_stats.hist[LPC_STATS_APP]));
+#endif
+
+	lpc_stats.start_ms = sys_now();
+}
+
+/* Read the DWT cycle counter */
+u32_t lpc_stats_now(void)
+{
+	return DWT->CYCCNT;
+}
+
+/* Count a latency in the histogram of a layer */
+void lpc_stats_add(lpc_stats_layer_t layer, u32_t cycles)
+{
+	lpc_stats_hist_t *h = &lpc_stats.hist[layer];
+	u32_t b = 0;
+
+	if (cycles >> LPC_STATS_BUCKET0_BITS) {
+		b = 32 - LPC_STATS_BUCKET0_BITS - __CLZ(cycles);
+		if (b >= LPC_STATS_BUCKETS) {
+			b = LPC_STATS_BUCKETS - 1;
+		}
+	}
+	lpc_stats_inc(&h->bucket[b]);
+	lpc_stats_raise(&h->max, cycles);
+}
+
+#if LWIP_STATS_LATENCY
+/* Stamp a received packet as it reaches a layer */
+void lpc_stats_stamp(lpc_stats_layer_t layer, struct pbuf *p)
+{
+	u32_t now = DWT->CYCCNT;
+
+	if (p->stamp != 0) {
+		lpc_stats_add(layer, now - p->stamp);
+	}
+	/* 0 means not stamped, a cycle off does not matter */
+	p->stamp = now | 1;
+}
+
+#endif /* LWIP_STATS_LATENCY */
+
+/* Write the statistics as a JSON object */
+int lpc_stats_json(char *buf, int size)
+{
+	lpc_stats_text_t t;
+	int i, j;
+
+	t.buf = buf;
+	t.size = size;
+	t.len = 0;
+
+	lpc_stats_print(&t, "{\"ms\":%lu,\"core_hz\":%lu,\"stamp_cycles\":%lu,\"overhead_ppm\":%lu",
+					(unsigned long) sys_now(), (unsigned long) SystemCoreClock,
+					(unsigned long) lpc_stats.stamp_cycles,
+					(unsigned long) lpc_stats_overhead_ppm());
+
+	lpc_stats_print(&t, ",\"latency\":{\"bucket0_bits\":%d", LPC_STATS_BUCKET0_BITS);
+	for (i = 0; i < LPC_STATS_LAYERS; i++) {
+		const lpc_stats_hist_t *h = &lpc_stats.hist[i];
+
+		lpc_stats_print(&t, ",\"%s\":{\"n\":%lu,\"max\":%lu,\"hist\":[",
+						lpc_stats_layer_names[i], (unsigned long) lpc_stats_count(h),
+						(unsigned long) h->max);
+		for (j = 0; j < LPC_STATS_BUCKETS; j++) {
+			lpc_stats_print(&t, j ? ",%lu" : "%lu", (unsigned long) h->bucket[j]);
+		}
+		lpc_stats_print(&t, "]}");
+	}
+	lpc_stats_print(&t, "}");
+
+#if LWIP_STATS
+	for (i = 0; i < LPC_STATS_PROTOS; i++) {
+		if (lpc_stats_protos[i] == NULL) {
+			continue;
+		}
+		lpc_stats_print(&t, ",\"%s\":{", lpc_stats_proto_names[i]);
+		for (j = 0; j < LPC_STATS_COUNTERS; j++) {
+			lpc_stats_print(&t, "%s\"%s\":%lu", j ? "," : "", lpc_stats_counter_names[j],
+							(unsigned long) lpc_stats_counter(lpc_stats_protos[i], j));
+		}
+		lpc_stats_print(&t, "}");
+	}
+
+#if MEMP_STATS
+	lpc_stats_print(&t, ",\"memp\":{");
+	for (i = 0; i < MEMP_MAX; i++) {
+		lpc_stats_print(&t, "%s\"%s\":{\"used\":%lu,\"max\":%lu,\"err\":%lu}", i ? "," : "",
+						lpc_stats_memp_names[i], (unsigned long) lwip_stats.memp[i].used,
+						(unsigned long) lwip_stats.memp[i].max,
+						(unsigned long) lwip_stats.memp[i].err);
+	}
+	lpc_stats_print(&t, "}");
+#endif /* MEMP_STATS */
+#endif /* LWIP_STATS */
+
+	lpc_stats_print(&t, "}");
+	return t.len;
+}
+
+/* Pack the statistics into a datagram */
+int lpc_stats_pack(u8_t *buf, int size, u32_t seq)
+{
+	u8_t *p = buf;
+	int i, j;
+
+	if (size < (int) LPC_STATS_PACK_SIZE) {
+		return -1;
+	}
+
+	*p++ = 'L';
+	*p++ = 'S';
+	*p++ = 1;
+	*p++ = LPC_STATS_LAYERS;
+	*p++ = LPC_STATS_BUCKETS;
+	*p++ = LPC_STATS_BUCKET0_BITS;
+	*p++ = LPC_STATS_PROTOS;
+#if LWIP_STATS && MEMP_STATS
+	*p++ = MEMP_MAX;
+#else
+	*p++ = 0;
+#endif
+	p = lpc_stats_put32(p, seq);
+	p = lpc_stats_put32(p, sys_now());
+	p = lpc_stats_put32(p, SystemCoreClock);
+	p = lpc_stats_put32(p, lpc_stats.stamp_cycles);
+
+	for (i = 0; i < LPC_STATS_LAYERS; i++) {
+		p = lpc_stats_put32(p, lpc_stats.hist[i].max);
+		for (j = 0; j < LPC_STATS_BUCKETS; j++) {
+			p = lpc_stats_put32(p, lpc_stats.hist[i].bucket[j]);
+		}
+	}
+
+	for (i = 0; i < LPC_STATS_PROTOS; i++) {
+		for (j = 0; j < LPC_STATS_COUNTERS; j++) {
+#if LWIP_STATS
+			p = lpc_stats_put32(p, lpc_stats_protos[i] ? lpc_stats_counter(lpc_stats_protos[i], j) : 0);
+#else
+			p = lpc_stats_put32(p, 0);
+#endif
+		}
+	}
+
+#if LWIP_STATS && MEMP_STATS
+	for (i = 0; i < MEMP_MAX; i++) {
+		int len = strlen(lpc_stats_memp_names[i]);
+
+		if (len > LPC_STATS_NAME_MAX) {
+			len = LPC_STATS_NAME_MAX;
+		}
+		*p++ = (u8_t) len;
+		memcpy(p, lpc_stats_memp_names[i], len);
+		p += len;
+		p = lpc_stats_put16(p, lwip_stats.memp[i].used);
+		p = lpc_stats_put16(p, lwip_stats.memp[i].max);
+		p = lpc_stats_put16(p, lwip_stats.memp[i].err);
+	}
+#endif
+
+	return p - buf;
+}
+
+/**
+ * @}
+ */
+
+#endif /* LWIP_STATS || LWIP_STATS_LATENCY */
@@ -263,10 +263,12 @@ unsigned long ulReturn;
  * Description:
  *      Creates and returns a new semaphore. The "ucCount" argument specifies
  *      the initial state of the semaphore.
- *      NOTE: Currently this routine only creates counts of 1 or 0
+ *      NOTE: Counts of 0 and 1 create a binary semaphore. A larger count
+ *      creates a counting semaphore that holds at most ucCount, such as one
+ *      guarding a pool of ucCount buffers.
  * Inputs:
  *      sys_mbox_t mbox         -- Handle of mailbox
- *      u8_t ucCount              -- Initial ucCount of semaphore (1 or 0)
+ *      u8_t ucCount              -- Initial ucCount of semaphore
  * Outputs:
  *      sys_sem_t               -- Created semaphore or 0 if could not create.
  *---------------------------------------------------------------------------*/
@@ -274,7 +276,14 @@ err_t sys_sem_new( sys_sem_t *pxSemaphore, u8_t ucCount )
 {
 err_t xReturn = ERR_MEM;
 
-	vSemaphoreCreateBinary( ( *pxSemaphore ) );
+	if( ucCount > 1U )
+	{
+		*pxSemaphore = xSemaphoreCreateCounting( ucCount, ucCount );
+	}
+	else
+	{
+		vSemaphoreCreateBinary( ( *pxSemaphore ) );
+	}
 
 	if( *pxSemaphore != NULL )
 	{
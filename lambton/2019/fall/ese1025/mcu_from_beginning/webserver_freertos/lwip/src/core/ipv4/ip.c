@@ -314,6 +314,7 @@ ip_input(struct pbuf *p, struct netif *inp)
 
   IP_STATS_INC(ip.recv);
   snmp_inc_ipinreceives();
+  PERF_RX_STAMP(IP, p);
 
   /* identify the IP header */
   iphdr = (struct ip_hdr *)p->payload;
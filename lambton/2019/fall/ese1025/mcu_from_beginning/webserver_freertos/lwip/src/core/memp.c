@@ -468,3 +468,54 @@ memp_free(memp_t type, void *mem)
 }
 
 #endif /* MEMP_MEM_MALLOC */
+
+#if MEMP_MEM_MALLOC && MEMP_STATS
+/**
+ * Get an element of the size of a pool from the heap, counted in
+ * lwip_stats.memp[type] as if it came from that pool.
+ *
+ * @param type the pool the element is for
+ * @return a pointer to the element or NULL if the heap is out of memory
+ */
+void *
+memp_malloc(memp_t type)
+{
+  void *mem;
+  SYS_ARCH_DECL_PROTECT(old_level);
+
+  LWIP_ERROR("memp_malloc: type < MEMP_MAX", (type < MEMP_MAX), return NULL;);
+
+  mem = mem_malloc(memp_sizes[type]);
+
+  SYS_ARCH_PROTECT(old_level);
+  if (mem != NULL) {
+    MEMP_STATS_INC_USED(used, type);
+  } else {
+    MEMP_STATS_INC(err, type);
+  }
+  SYS_ARCH_UNPROTECT(old_level);
+
+  return mem;
+}
+
+/**
+ * Give an element from memp_malloc() back to the heap.
+ *
+ * @param type the pool it was counted in
+ * @param mem the element to free
+ */
+void
+memp_free(memp_t type, void *mem)
+{
+  SYS_ARCH_DECL_PROTECT(old_level);
+
+  if (mem == NULL) {
+    return;
+  }
+  mem_free(mem);
+
+  SYS_ARCH_PROTECT(old_level);
+  MEMP_STATS_DEC(used, type);
+  SYS_ARCH_UNPROTECT(old_level);
+}
+#endif /* MEMP_MEM_MALLOC && MEMP_STATS */
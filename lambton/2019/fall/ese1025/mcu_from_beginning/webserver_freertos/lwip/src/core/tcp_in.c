@@ -101,6 +101,7 @@ tcp_input(struct pbuf *p, struct netif *inp)
   err_t err;
 
   PERF_START;
+  PERF_RX_STAMP(TCP, p);
 
   TCP_STATS_INC(tcp.recv);
   snmp_inc_tcpinsegs();
@@ -0,0 +1,664 @@
+/*
+ * @brief	Builds the flash file image served by lwip_fs.c
+ *
+ * @note
+ * Host (Linux) tool, it is not part of the MCU build. Build and run it with
+ *     gcc -O2 -o makefsdata makefsdata.c -lz
+ *     ./makefsdata ../example/fs ../example/src/fsdata_img.c
+ *
+ * Every regular file below the directory becomes one entry of the image.
+ * The HTTP response header (status, server, content type, ETag) is built
+ * here and stored in front of the file data, so that the server sends the
+ * response straight from flash. When gzip makes a file smaller, a second
+ * copy with a "Content-Encoding: gzip" header is stored as well. The names
+ * are indexed with a perfect hash, so fs_open() needs one hash and one
+ * strcmp() to find a file. The image is written with CRLF line endings,
+ * as the sources of the example are.
+ *
+ * The hash is a hash and displace scheme, as CHD (Belazzougui, Botelho and
+ * Dietzfelbinger, "Hash, displace, and compress") builds it: the name hash
+ * picks one of about n/4 buckets and, with the displacement found for its
+ * bucket, a slot of an index of the next power of two above n. Buckets are
+ * placed largest first, and a bucket of one name can always be given any
+ * free slot, so the index is found for any set of up to MAX_FILES names.
+ * Another seed is tried only when two names of a bucket have the same
+ * start and step through the index, which no displacement separates; the
+ * small indexes of a few dozen names need that now and then.
+ *
+ * With -b the tool also times the lookup of every name through the perfect
+ * hash against a linear strcmp() search, on the build host. host/
+ * fs_open_bench.c times fs_open() of lwip_fs.c on the image itself.
+ *
+ * With -t it tests the hash instead of writing an image: every file count
+ * from 1 to MAX_FILES, and MAX_FILES names of a few other shapes, must get
+ * an index in which the lookup of lwip_fs.c finds every name:
+ *     ./makefsdata -t
+ */
+
+#include <dirent.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <zlib.h>
+
+#define SERVER_AGENT "lwIP/1.3.1 (http://savannah.nongnu.org/projects/lwip)"
+#define MAX_FILES 1024
+#define MAX_SEEDS 1000
+
+struct file_ent {
+	char *name;			/* URI, "/dir/file.ext" */
+	unsigned char *data;
+	size_t len;
+	unsigned char *gz;	/* gzip copy, NULL when not smaller */
+	size_t gzlen;
+	uint32_t etag;
+};
+
+static struct file_ent files[MAX_FILES];
+static int num_files;
+
+/* Content types, as in httpd_structs.h */
+static const char *const content_types[][2] = {
+	{"html", "text/html"},
+	{"htm", "text/html"},
+	{"shtml", "text/html"},
+	{"shtm", "text/html"},
+	{"ssi", "text/html"},
+	{"gif", "image/gif"},
+	{"png", "image/png"},
+	{"jpg", "image/jpeg"},
+	{"bmp", "image/bmp"},
+	{"ico", "image/x-icon"},
+	{"class", "application/octet-stream"},
+	{"cls", "application/octet-stream"},
+	{"js", "application/x-javascript"},
+	{"ram", "application/x-javascript"},
+	{"css", "text/css"},
+	{"swf", "application/x-shockwave-flash"},
+	{"xml", "text/xml"},
+	{"xsl", "text/xml"},
+	{"svg", "image/svg+xml"},
+	{"json", "application/json"},
+};
+
+/* Must match fsimg_hash() in lwip_fs.c */
+static uint32_t fsimg_hash(const char *name, uint32_t seed)
+{
+	uint32_t h = 2166136261u ^ seed;
+
+	while (*name) {
+		h ^= (unsigned char) *name++;
+		h *= 16777619u;
+	}
+	return h;
+}
+
+/* Must match fsimg_mix() in lwip_fs.c, the bucket and step of a name */
+static uint32_t fsimg_mix(uint32_t h)
+{
+	h ^= h >> 16;
+	h *= 0x85ebca6bu;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35u;
+	h ^= h >> 16;
+	return h;
+}
+
+/* Index slot of a name hash with the displacement of its bucket, as
+   fsimg_lookup() of lwip_fs.c computes it */
+static uint32_t fsimg_slot(uint32_t h, uint32_t disp, unsigned int size)
+{
+	return (h + (disp >> 16) * ((fsimg_mix(h) >> 16) | 1) + (disp & 0xFFFF)) & (size - 1);
+}
+
+static uint32_t fnv1a(const unsigned char *p, size_t len)
+{
+	uint32_t h = 2166136261u;
+
+	while (len--) {
+		h ^= *p++;
+		h *= 16777619u;
+	}
+	return h;
+}
+
+static const char *content_type(const char *name)
+{
+	const char *ext = strrchr(name, '.');
+	unsigned int i;
+
+	if (ext != NULL) {
+		for (i = 0; i < sizeof(content_types) / sizeof(content_types[0]); i++) {
+			if (!strcmp(content_types[i][0], ext + 1))
+				return content_types[i][1];
+		}
+	}
+	return "text/plain";
+}
+
+/* Status line for a file, by its name as get_http_headers() of lwip_fs.c
+   does: error pages such as 404.html are sent with their own status */
+static const char *status_line(const char *name)
+{
+	if (strstr(name, "404"))
+		return "HTTP/1.1 404 File not found";
+	if (strstr(name, "400"))
+		return "HTTP/1.1 400 Bad Request";
+	if (strstr(name, "501"))
+		return "HTTP/1.1 501 Not Implemented";
+	return "HTTP/1.1 200 OK";
+}
+
+static unsigned char *read_file(const char *path, size_t *len)
+{
+	FILE *fp = fopen(path, "rb");
+	unsigned char *buf;
+	long sz;
+
+	if (fp == NULL)
+		return NULL;
+	fseek(fp, 0, SEEK_END);
+	sz = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+	buf = malloc(sz ? sz : 1);
+	if (buf == NULL || fread(buf, 1, sz, fp) != (size_t) sz) {
+		free(buf);
+		fclose(fp);
+		return NULL;
+	}
+	fclose(fp);
+	*len = sz;
+	return buf;
+}
+
+/* gzip a buffer, returns NULL when the result is not smaller */
+static unsigned char *gzip_data(const unsigned char *in, size_t len, size_t *outlen)
+{
+	z_stream zs;
+	unsigned char *out;
+	size_t max;
+
+	memset(&zs, 0, sizeof(zs));
+	if (deflateInit2(&zs, Z_BEST_COMPRESSION, Z_DEFLATED, 15 + 16, 9, Z_DEFAULT_STRATEGY) != Z_OK)
+		return NULL;
+	max = deflateBound(&zs, len);
+	out = malloc(max);
+	zs.next_in = (unsigned char *) in;
+	zs.avail_in = len;
+	zs.next_out = out;
+	zs.avail_out = max;
+	if (out == NULL || deflate(&zs, Z_FINISH) != Z_STREAM_END || zs.total_out >= len) {
+		deflateEnd(&zs);
+		free(out);
+		return NULL;
+	}
+	*outlen = zs.total_out;
+	deflateEnd(&zs);
+	return out;
+}
+
+static int add_dir(const char *root, const char *rel)
+{
+	char path[1024], name[1024];
+	struct dirent *de;
+	struct stat st;
+	DIR *d;
+
+	snprintf(path, sizeof(path), "%s%s", root, rel);
+	d = opendir(path);
+	if (d == NULL) {
+		perror(path);
+		return -1;
+	}
+	while ((de = readdir(d)) != NULL) {
+		if (de->d_name[0] == '.')
+			continue;
+		snprintf(name, sizeof(name), "%s/%s", rel, de->d_name);
+		snprintf(path, sizeof(path), "%s%s", root, name);
+		if (stat(path, &st))
+			continue;
+		if (S_ISDIR(st.st_mode)) {
+			if (add_dir(root, name))
+				return -1;
+		}
+		else if (S_ISREG(st.st_mode)) {
+			struct file_ent *f = &files[num_files];
+
+			if (num_files == MAX_FILES) {
+				fprintf(stderr, "Too many files\n");
+				return -1;
+			}
+			f->name = strdup(name);
+			f->data = read_file(path, &f->len);
+			if (f->data == NULL) {
+				perror(path);
+				return -1;
+			}
+			f->gz = gzip_data(f->data, f->len, &f->gzlen);
+			f->etag = fnv1a(f->data, f->len);
+			num_files++;
+		}
+	}
+	closedir(d);
+	return 0;
+}
+
+struct phash {
+	uint32_t seed;
+	unsigned int size;			/* index slots, power of two */
+	unsigned int nbuckets;		/* power of two */
+	unsigned short *index;		/* file number + 1 for each slot, 0 if empty */
+	uint32_t *disp;				/* displacement of each bucket */
+};
+
+/* Largest bucket first, then by bucket number, so that the image does
+   not depend on the qsort() of the host */
+static int cmp_bucket_size(const void *a, const void *b)
+{
+	const unsigned int *x = a, *y = b;
+
+	if (x[1] != y[1])
+		return (int) y[1] - (int) x[1];
+	return (int) x[0] - (int) y[0];
+}
+
+/* Step of a name hash through the index, as fsimg_slot() takes it */
+static uint32_t slot_step(uint32_t h, unsigned int size)
+{
+	return ((fsimg_mix(h) >> 16) | 1) & (size - 1);
+}
+
+/* Places the names of bucket b, whose file numbers are in members[0..n),
+   returns -1 when no displacement fits them all. The displacement is
+   d0 << 16 | d1; as the index size is a power of two, d0 and d1 below it
+   give every displacement there is. */
+static int place_bucket(struct phash *ph, const uint32_t *hash, unsigned int b,
+						const int *members, int n)
+{
+	uint32_t slots[MAX_FILES], d0, d1, disp;
+	int i, k;
+
+	/* Two names of the same start and step share every slot */
+	for (i = 0; i < n; i++) {
+		for (k = 0; k < i; k++) {
+			if ((((hash[members[i]] ^ hash[members[k]]) & (ph->size - 1)) == 0) &&
+				(slot_step(hash[members[i]], ph->size) == slot_step(hash[members[k]], ph->size)))
+				return -1;
+		}
+	}
+
+	for (d0 = 0; d0 < ph->size; d0++) {
+		for (d1 = 0; d1 < ph->size; d1++) {
+			disp = d0 << 16 | d1;
+			for (i = 0; i < n; i++) {
+				slots[i] = fsimg_slot(hash[members[i]], disp, ph->size);
+				if (ph->index[slots[i]])
+					break;
+				for (k = 0; k < i; k++) {
+					if (slots[k] == slots[i])
+						break;
+				}
+				if (k < i)
+					break;
+			}
+			if (i == n) {
+				for (i = 0; i < n; i++)
+					ph->index[slots[i]] = members[i] + 1;
+				ph->disp[b] = disp;
+				return 0;
+			}
+		}
+		/* A single name takes any free slot with d0 = 0 */
+		if (n == 1)
+			break;
+	}
+	return -1;
+}
+
+/* Hash and displace index of the names: about four names per bucket, and
+   an index of the next power of two at or above the file count */
+static int find_perfect_hash(struct phash *ph)
+{
+	static uint32_t hash[MAX_FILES];
+	static int order[MAX_FILES], start[MAX_FILES + 1];
+	static unsigned int sizes[MAX_FILES][2];
+	unsigned int b, nb;
+	uint32_t s;
+	int i, ok;
+
+	for (ph->size = 1; ph->size < (unsigned int) num_files; ph->size <<= 1) {}
+	for (nb = 1; nb * 4 < (unsigned int) num_files; nb <<= 1) {}
+	ph->nbuckets = nb;
+	ph->index = calloc(ph->size, sizeof(*ph->index));
+	ph->disp = calloc(nb, sizeof(*ph->disp));
+	if (ph->index == NULL || ph->disp == NULL)
+		return -1;
+
+	for (s = 0; s < MAX_SEEDS; s++) {
+		memset(ph->index, 0, ph->size * sizeof(*ph->index));
+		memset(ph->disp, 0, nb * sizeof(*ph->disp));
+		for (b = 0; b < nb; b++) {
+			sizes[b][0] = b;
+			sizes[b][1] = 0;
+		}
+		for (i = 0; i < num_files; i++) {
+			hash[i] = fsimg_hash(files[i].name, s);
+			sizes[fsimg_mix(hash[i]) & (nb - 1)][1]++;
+		}
+
+		/* File numbers grouped by bucket, the largest buckets first */
+		qsort(sizes, nb, sizeof(sizes[0]), cmp_bucket_size);
+		start[0] = 0;
+		for (b = 0; b < nb; b++)
+			start[b + 1] = start[b] + sizes[b][1];
+		for (b = 0; b < nb; b++) {
+			unsigned int bucket = sizes[b][0];
+			int n = start[b];
+
+			for (i = 0; i < num_files; i++) {
+				if ((fsimg_mix(hash[i]) & (nb - 1)) == bucket)
+					order[n++] = i;
+			}
+		}
+
+		ok = 1;
+		for (b = 0; b < nb && ok; b++) {
+			int n = start[b + 1] - start[b];
+
+			if (n > 0)
+				ok = !place_bucket(ph, hash, sizes[b][0], &order[start[b]], n);
+		}
+		if (ok) {
+			ph->seed = s;
+			return 0;
+		}
+	}
+	return -1;
+}
+
+/* The lookup of fsimg_lookup() in lwip_fs.c, file number or -1 */
+static int lookup(const struct phash *ph, const char *name)
+{
+	uint32_t h = fsimg_hash(name, ph->seed);
+	int k = ph->index[fsimg_slot(h, ph->disp[fsimg_mix(h) & (ph->nbuckets - 1)], ph->size)];
+
+	if (k == 0 || strcmp(files[k - 1].name, name))
+		return -1;
+	return k - 1;
+}
+
+static void emit_bytes(FILE *out, const unsigned char *p, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i < len; i++)
+		fprintf(out, "%s0x%02x,%s", (i % 16) ? "" : "\t", p[i], (i % 16 == 15 || i + 1 == len) ? "\n" : "");
+}
+
+/* Header followed by the data, returns the header length */
+static size_t emit_response(FILE *out, const char *sym, const struct file_ent *f,
+							const unsigned char *data, size_t len, int gz)
+{
+	char hdr[512];
+	int hlen;
+
+	hlen = snprintf(hdr, sizeof(hdr),
+					"%s\r\n"
+					"Server: " SERVER_AGENT "\r\n"
+					"Content-type: %s\r\n"
+					"%s"
+					"Vary: Accept-Encoding\r\n"
+					"ETag: \"%08x\"\r\n"
+					"\r\n",
+					status_line(f->name), content_type(f->name),
+					gz ? "Content-Encoding: gzip\r\n" : "", f->etag);
+	fprintf(out, "static const char %s[] = {\n", sym);
+	fprintf(out, "\t/* %s%s */\n", f->name, gz ? " (gzip)" : "");
+	emit_bytes(out, (const unsigned char *) hdr, hlen);
+	emit_bytes(out, data, len);
+	fprintf(out, "};\n\n");
+	return hlen;
+}
+
+/* Writes the memory stream to the file, with CRLF line endings */
+static int write_crlf(const char *fname, const char *buf, size_t len)
+{
+	FILE *out = fopen(fname, "wb");
+	size_t i;
+
+	if (out == NULL) {
+		perror(fname);
+		return -1;
+	}
+	for (i = 0; i < len; i++) {
+		if (buf[i] == '\n')
+			fputc('\r', out);
+		fputc(buf[i], out);
+	}
+	if (fclose(out)) {
+		perror(fname);
+		return -1;
+	}
+	return 0;
+}
+
+static int write_image(const char *fname, const struct phash *ph)
+{
+	size_t hlen[MAX_FILES], gzhlen[MAX_FILES], buflen;
+	char sym[32], *buf;
+	FILE *out;
+	int i, ret;
+	unsigned int j;
+
+	out = open_memstream(&buf, &buflen);
+	if (out == NULL) {
+		perror(fname);
+		return -1;
+	}
+	fprintf(out, "/* Generated by tools/makefsdata.c, do not edit */\n\n");
+	fprintf(out, "#include \"lwip_fs.h\"\n\n");
+	for (i = 0; i < num_files; i++) {
+		snprintf(sym, sizeof(sym), "fsimg_data_%d", i);
+		hlen[i] = emit_response(out, sym, &files[i], files[i].data, files[i].len, 0);
+		if (files[i].gz != NULL) {
+			snprintf(sym, sizeof(sym), "fsimg_gzip_%d", i);
+			gzhlen[i] = emit_response(out, sym, &files[i], files[i].gz, files[i].gzlen, 1);
+		}
+	}
+
+	fprintf(out, "static const struct fsimg_entry fsimg_files[] = {\n");
+	for (i = 0; i < num_files; i++) {
+		const struct file_ent *f = &files[i];
+
+		fprintf(out, "\t{\"%s\", \"\\\"%08x\\\"\",\n", f->name, f->etag);
+		fprintf(out, "\t fsimg_data_%d, %lu, %lu,\n", i,
+				(unsigned long) (hlen[i] + f->len), (unsigned long) hlen[i]);
+		if (f->gz != NULL)
+			fprintf(out, "\t fsimg_gzip_%d, %lu, %lu},\n", i,
+					(unsigned long) (gzhlen[i] + f->gzlen), (unsigned long) gzhlen[i]);
+		else
+			fprintf(out, "\t NULL, 0, 0},\n");
+	}
+	fprintf(out, "};\n\n");
+
+	fprintf(out, "static const u16_t fsimg_index[%u] = {\n", ph->size);
+	for (j = 0; j < ph->size; j++)
+		fprintf(out, "%s%u,%s", (j % 16) ? " " : "\t", ph->index[j],
+				(j % 16 == 15 || j + 1 == ph->size) ? "\n" : "");
+	fprintf(out, "};\n\n");
+
+	fprintf(out, "static const u32_t fsimg_disp[%u] = {\n", ph->nbuckets);
+	for (j = 0; j < ph->nbuckets; j++)
+		fprintf(out, "%s0x%08x,%s", (j % 8) ? " " : "\t", ph->disp[j],
+				(j % 8 == 7 || j + 1 == ph->nbuckets) ? "\n" : "");
+	fprintf(out, "};\n\n");
+
+	fprintf(out, "const struct fsimg fsimg_root = {\n");
+	fprintf(out, "\tfsimg_files, fsimg_index, fsimg_disp, %uu, %u, %u, %d\n", ph->seed,
+			ph->size, ph->nbuckets, num_files);
+	fprintf(out, "};\n");
+	fclose(out);
+
+	ret = write_crlf(fname, buf, buflen);
+	free(buf);
+	return ret;
+}
+
+static double now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* Time the lookup of every name, perfect hash against a linear search */
+static void bench(const struct phash *ph)
+{
+	const int rounds = 200000;
+	volatile int found = 0;
+	double t0, t1, t2;
+	int r, i, k;
+
+	t0 = now_ns();
+	for (r = 0; r < rounds; r++) {
+		for (i = 0; i < num_files; i++) {
+			found += lookup(ph, files[i].name);
+		}
+	}
+	t1 = now_ns();
+	for (r = 0; r < rounds; r++) {
+		for (i = 0; i < num_files; i++) {
+			for (k = 0; k < num_files; k++) {
+				if (!strcmp(files[k].name, files[i].name)) {
+					found += k + 1;
+					break;
+				}
+			}
+		}
+	}
+	t2 = now_ns();
+	printf("lookup, %d files: perfect hash %.1f ns, linear search %.1f ns\n", num_files,
+		   (t1 - t0) / ((double) rounds * num_files), (t2 - t1) / ((double) rounds * num_files));
+}
+
+/* Names of one shape for the self-test */
+static void test_names(int n, int shape)
+{
+	char name[64];
+	int i, k;
+
+	for (i = 0; i < num_files; i++)
+		free(files[i].name);
+	for (i = 0; i < n; i++) {
+		switch (shape) {
+		case 0:
+			snprintf(name, sizeof(name), "/f%d.htm", i);
+			break;
+		case 1:
+			snprintf(name, sizeof(name), "/img/%04d.png", i);
+			break;
+		case 2:
+			snprintf(name, sizeof(name), "/a/b/c/page-%x.html", i * 7919);
+			break;
+		default:
+			/* Random names of 2 to 17 letters */
+			name[0] = '/';
+			for (k = 1; k < 3 + rand() % 16; k++)
+				name[k] = 'a' + rand() % 26;
+			snprintf(name + k, sizeof(name) - k, "%d", i);
+			break;
+		}
+		files[i].name = strdup(name);
+	}
+	num_files = n;
+}
+
+/* Checks the index of the names, returns the number of errors */
+static int test_hash(int shape)
+{
+	struct phash ph;
+	int i, errors = 0;
+
+	if (find_perfect_hash(&ph)) {
+		printf("FAILED: no perfect hash for %d names of shape %d\n", num_files, shape);
+		return 1;
+	}
+	for (i = 0; i < num_files; i++) {
+		if (lookup(&ph, files[i].name) != i)
+			errors++;
+	}
+	if (errors)
+		printf("FAILED: %d of %d names of shape %d not found\n", errors, num_files, shape);
+	free(ph.index);
+	free(ph.disp);
+	return errors;
+}
+
+static int self_test(void)
+{
+	int n, shape, round, errors = 0;
+	double t0 = now_ns();
+
+	for (n = 1; n <= MAX_FILES; n++) {
+		test_names(n, 0);
+		errors += test_hash(0);
+	}
+	for (shape = 1; shape < 4; shape++) {
+		for (round = 0; round < 10; round++) {
+			test_names(MAX_FILES, shape);
+			errors += test_hash(shape);
+		}
+	}
+	if (errors)
+		return 1;
+	printf("perfect hash of 1 to %d names and of %d names of 3 other shapes: %.0f ms\n",
+		   MAX_FILES, MAX_FILES, (now_ns() - t0) / 1e6);
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	struct phash ph;
+	int i, do_bench = 0;
+	size_t raw = 0, gz = 0;
+
+	if (argc == 2 && !strcmp(argv[1], "-t"))
+		return self_test();
+	if (argc > 1 && !strcmp(argv[1], "-b")) {
+		do_bench = 1;
+		argv++;
+		argc--;
+	}
+	if (argc != 3) {
+		fprintf(stderr, "usage: %s [-b] <directory> <output.c> | -t\n", argv[0]);
+		return 1;
+	}
+	if (add_dir(argv[1], ""))
+		return 1;
+	if (num_files == 0) {
+		fprintf(stderr, "%s: no files\n", argv[1]);
+		return 1;
+	}
+	if (find_perfect_hash(&ph)) {
+		fprintf(stderr, "No perfect hash found\n");
+		return 1;
+	}
+	if (write_image(argv[2], &ph))
+		return 1;
+
+	for (i = 0; i < num_files; i++) {
+		raw += files[i].len;
+		gz += files[i].gz ? files[i].gzlen : 0;
+		printf("%-32s %8lu %8lu\n", files[i].name, (unsigned long) files[i].len,
+			   (unsigned long) (files[i].gz ? files[i].gzlen : 0));
+	}
+	printf("%d files, %lu bytes, %lu bytes gzip, index %u slots, %u buckets, seed %u\n",
+		   num_files, (unsigned long) raw, (unsigned long) gz, ph.size, ph.nbuckets, ph.seed);
+	if (do_bench)
+		bench(&ph);
+	return 0;
+}
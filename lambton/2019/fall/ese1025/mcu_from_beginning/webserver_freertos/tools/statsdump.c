@@ -0,0 +1,209 @@
+/*
+ * @brief	Prints the statistics datagrams of example/src/stats_stream.c
+ *
+ * @note
+ * Host (Linux) tool, it is not part of the MCU build. Build and run it with
+ *     gcc -O2 -o statsdump statsdump.c
+ *     ./statsdump [-p port]
+ *
+ * For each datagram (lpc_stats_pack() in lwip/src/arch/lpc_stats.c) it
+ * prints, per layer, the packets per second and the median and 99th
+ * percentile latency since the datagram before, as the upper edge of the
+ * histogram bucket they fall in, and the longest latency so far. Then the
+ * drops of the link, IP, TCP and UDP since the datagram before, the pools
+ * that have been used with their high-water marks and failed allocations,
+ * and the share of the CPU the latency stamps took.
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define MAX_LAYERS 8
+#define MAX_BUCKETS 32
+#define MAX_PROTOS 8
+#define COUNTERS 7
+#define DROP 2	/* index of the drop counter */
+
+/* One datagram, unpacked */
+struct snap {
+	uint32_t seq, ms, hz, stamp_cycles;
+	int layers, buckets, bucket0_bits, protos;
+	uint32_t max[MAX_LAYERS];
+	uint32_t hist[MAX_LAYERS][MAX_BUCKETS];
+	uint32_t counters[MAX_PROTOS][COUNTERS];
+};
+
+static const char *const layer_names[] = {"irq", "rx", "ip", "tcp", "app"};
+static const char *const proto_names[] = {"link", "ip", "tcp", "udp"};
+
+static uint32_t get32(const unsigned char *p)
+{
+	return (uint32_t) p[0] << 24 | (uint32_t) p[1] << 16 | (uint32_t) p[2] << 8 | p[3];
+}
+
+static unsigned get16(const unsigned char *p)
+{
+	return (unsigned) p[0] << 8 | p[1];
+}
+
+/* Cycles to microseconds */
+static double us(const struct snap *s, double cycles)
+{
+	return s->hz ? cycles * 1e6 / s->hz : 0;
+}
+
+/* Upper edge in cycles of the bucket the q-th part of the n packets in
+   h fall in, or 0 for none */
+static double percentile(const struct snap *s, const uint32_t *h, uint32_t n, double q)
+{
+	uint32_t want = (uint32_t) (q * n + 0.5), sum = 0;
+	int b;
+
+	if (n == 0)
+		return 0;
+	if (want < 1)
+		want = 1;
+	for (b = 0; b < s->buckets; b++) {
+		sum += h[b];
+		if (sum >= want)
+			break;
+	}
+	return (double) (1u << (b + s->bucket0_bits));
+}
+
+/* Unpack the fixed part and print the pools, returns 0 if it is not a
+   datagram of ours */
+static int unpack(const unsigned char *p, int len, struct snap *s, int print_pools)
+{
+	const unsigned char *end = p + len;
+	int pools, i, j;
+
+	if (len < 24 || p[0] != 'L' || p[1] != 'S' || p[2] != 1)
+		return 0;
+	s->layers = p[3];
+	s->buckets = p[4];
+	s->bucket0_bits = p[5];
+	s->protos = p[6];
+	pools = p[7];
+	if (s->layers > MAX_LAYERS || s->buckets > MAX_BUCKETS || s->protos > MAX_PROTOS ||
+		s->buckets + s->bucket0_bits > 32)
+		return 0;
+	s->seq = get32(p + 8);
+	s->ms = get32(p + 12);
+	s->hz = get32(p + 16);
+	s->stamp_cycles = get32(p + 20);
+	p += 24;
+	if (end - p < 4 * (s->layers * (1 + s->buckets) + s->protos * COUNTERS))
+		return 0;
+	for (i = 0; i < s->layers; i++) {
+		s->max[i] = get32(p);
+		p += 4;
+		for (j = 0; j < s->buckets; j++, p += 4)
+			s->hist[i][j] = get32(p);
+	}
+	for (i = 0; i < s->protos; i++)
+		for (j = 0; j < COUNTERS; j++, p += 4)
+			s->counters[i][j] = get32(p);
+
+	if (print_pools && pools > 0)
+		printf("  memp used/max err:");
+	for (i = 0; i < pools && p < end; i++) {
+		int nlen = *p++;
+
+		if (end - p < nlen + 6)
+			return 0;
+		/* only those that have been used at all */
+		if (print_pools && (get16(p + nlen + 2) || get16(p + nlen + 4)))
+			printf(" %.*s %u/%u %u", nlen, (const char *) p, get16(p + nlen),
+				   get16(p + nlen + 2), get16(p + nlen + 4));
+		p += nlen + 6;
+	}
+	if (print_pools && pools > 0)
+		printf("\n");
+	return 1;
+}
+
+static void print_snap(const struct snap *s, const struct snap *prev)
+{
+	double secs = prev ? (s->ms - prev->ms) / 1000.0 : s->ms / 1000.0;
+	uint64_t stamps = 0;
+	int i, j;
+
+	if (secs <= 0)
+		secs = 1e-3;
+	printf("seq %lu at %.3f s, %.0f MHz\n", (unsigned long) s->seq, s->ms / 1000.0, s->hz / 1e6);
+	printf("  %-5s %10s %10s %10s %10s\n", "layer", "pkts/s", "p50 us", "p99 us", "max us");
+	for (i = 0; i < s->layers; i++) {
+		uint32_t h[MAX_BUCKETS], n = 0;
+
+		for (j = 0; j < s->buckets; j++) {
+			h[j] = s->hist[i][j] - (prev ? prev->hist[i][j] : 0);
+			n += h[j];
+		}
+		stamps += n;
+		printf("  %-5s %10.0f %10.1f %10.1f %10.1f\n",
+			   i < (int) (sizeof(layer_names) / sizeof(layer_names[0])) ? layer_names[i] : "?",
+			   n / secs, us(s, percentile(s, h, n, 0.5)), us(s, percentile(s, h, n, 0.99)),
+			   us(s, s->max[i]));
+	}
+	printf("  drops");
+	for (i = 0; i < s->protos; i++)
+		printf(" %s %lu",
+			   i < (int) (sizeof(proto_names) / sizeof(proto_names[0])) ? proto_names[i] : "?",
+			   (unsigned long) (s->counters[i][DROP] - (prev ? prev->counters[i][DROP] : 0)));
+	printf("\n  stamps take %.3f%% of the CPU (%lu cycles each)\n",
+		   s->hz ? 100.0 * stamps * s->stamp_cycles / (secs * s->hz) : 0,
+		   (unsigned long) s->stamp_cycles);
+}
+
+int main(int argc, char *argv[])
+{
+	static unsigned char buf[2048];
+	struct snap cur, prev;
+	struct sockaddr_in addr;
+	int opt, sock, len, have_prev = 0, port = 5555;
+
+	while ((opt = getopt(argc, argv, "p:")) != -1) {
+		switch (opt) {
+		case 'p':
+			port = atoi(optarg);
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-p port]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	sock = socket(AF_INET, SOCK_DGRAM, 0);
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_ANY);
+	addr.sin_port = htons(port);
+	if (sock < 0 || bind(sock, (struct sockaddr *) &addr, sizeof(addr)) < 0) {
+		perror("statsdump");
+		return 1;
+	}
+
+	while ((len = recv(sock, buf, sizeof(buf), 0)) >= 0) {
+		if (!unpack(buf, len, &cur, 0)) {
+			fprintf(stderr, "statsdump: ignored a datagram of %d bytes\n", len);
+			continue;
+		}
+		/* a board that restarted starts from 0 again */
+		if (have_prev && (cur.seq <= prev.seq || cur.ms < prev.ms))
+			have_prev = 0;
+		print_snap(&cur, have_prev ? &prev : NULL);
+		unpack(buf, len, &cur, 1);
+		fflush(stdout);
+		prev = cur;
+		have_prev = 1;
+	}
+	perror("statsdump");
+	return 1;
+}
@@ -0,0 +1,456 @@
+/*
+ * ll_bench.c
+ *
+ * 		benchmark of the linked lists of dstructs: addNode(), which walks
+ * 		the list to its tail on every insert, against a list_t with its
+ * 		nodes from the heap, a list_t with its nodes from a pool, and an
+ * 		unrolled list from a pool
+ *
+ * 		gcc -std=gnu99 -O2 -Wall -I../dstructs -o ll_bench ll_bench.c \
+ * 			../source/dstructs.c
+ *
+ * 		./ll_bench [-n elements] [-o elements for addNode()]
+ *
+ * 		for each it reports, in ns per element: building the list, a
+ * 		traversal, a search for a value that is not there, and freeing
+ * 		it; and, in us, deleting an element from the middle by value;
+ * 		the results are checked against the array they were built from
+ *
+ * 		before any of that, the edge cases are checked against arrays:
+ * 		insertAfter(), prependNode() and deleteAfter() at the ends of a
+ * 		list_t, which must keep its tail right, and ullInsertAt() and
+ * 		ullDeleteAt() splitting full nodes, and merging and borrowing
+ * 		from the next node, also at the tail
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include "dstructs.h"
+
+#define		DELETES		100 /* deletions from the middle, timed */
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static void sum_up(int value, void *arg)
+{
+	*(long long *) arg += value;
+}
+
+static void report(const char *how, size_t n, uint64_t build, uint64_t walk,
+		uint64_t search, uint64_t del, uint64_t release)
+{
+	printf("%-16s %9zu %9.1f", how, n, (double) build / n);
+	if (walk != 0)
+	{
+		printf(" %9.2f %9.2f %9.2f %9.2f", (double) walk / n,
+				(double) search / n, del / 1e3 / DELETES,
+				(double) release / n);
+	}
+	printf("\n");
+}
+
+/* non-zero, and a message, unless list holds the n values of want */
+static int list_differs(const char *what, const list_t *list, const int *want,
+		size_t n)
+{
+	const ll_t *p = list -> head, *last = NULL;
+	size_t i;
+
+	for (i = 0; p != NULL && i != n && p -> data == want[i]; ++i)
+	{
+		last = p;
+		p = p -> pNext;
+	}
+	if (p != NULL || i != n || list -> size != n || list -> tail != last)
+	{
+		printf("FAILED: %s: list_t does not match (size %zu, %zu right, "
+				"tail %s)\n", what, list -> size, i,
+				list -> tail == last ? "right" : "wrong");
+		return 1;
+	}
+	return 0;
+}
+
+/* checks that the list_t functions keep head, tail and size right */
+static int check_list(void)
+{
+	list_t list;
+	ll_t *p;
+	int failed = 0;
+
+	initList(&list, NULL);
+	failed |= deleteAfter(&list, NULL) != 0;
+	p = prependNode(&list, 2);	/* into an empty list: head and tail */
+	failed |= list_differs("prependNode() to empty", &list,
+			(int[]) { 2 }, 1);
+	appendNode(&list, 3);
+	prependNode(&list, 1);
+	failed |= list_differs("prependNode()", &list, (int[]) { 1, 2, 3 }, 3);
+	insertAfter(&list, list.tail, 4);	/* after the tail: a new tail */
+	failed |= list_differs("insertAfter() the tail", &list,
+			(int[]) { 1, 2, 3, 4 }, 4);
+	appendNode(&list, 5);
+	insertAfter(&list, p, 6);	/* in the middle: the tail stays */
+	failed |= list_differs("insertAfter() in the middle", &list,
+			(int[]) { 1, 2, 6, 3, 4, 5 }, 6);
+	failed |= deleteAfter(&list, list.tail) != 0;	/* nothing after it */
+	findNode(&list, 5, &p);
+	deleteAfter(&list, p);	/* the tail: the one before is the tail */
+	failed |= list_differs("deleteAfter() the tail", &list,
+			(int[]) { 1, 2, 6, 3, 4 }, 5);
+	appendNode(&list, 7);
+	deleteAfter(&list, NULL);	/* the head */
+	failed |= list_differs("deleteAfter() the head", &list,
+			(int[]) { 2, 6, 3, 4, 7 }, 5);
+	while (deleteAfter(&list, NULL))
+	{
+	}
+	failed |= list_differs("deleteAfter() all", &list, NULL, 0);
+	insertAfter(&list, NULL, 8);	/* empty again: head and tail */
+	appendNode(&list, 9);
+	failed |= list_differs("insertAfter() to empty", &list,
+			(int[]) { 8, 9 }, 2);
+	clearList(&list);
+	return failed;
+}
+
+/*
+ * non-zero, and a message, unless the unrolled list holds the n values of
+ * want, with every node holding 1..ULL_CAP of them and the tail the last
+ */
+static int ull_differs(const char *what, const ulist_t *list, const int *want,
+		size_t n)
+{
+	const ull_t *p, *last = NULL;
+	size_t i = 0;
+
+	for (p = list -> head; p != NULL; p = p -> pNext)
+	{
+		if (p -> count < 1 || p -> count > ULL_CAP)
+		{
+			break;
+		}
+		for (int k = 0; k != p -> count && i != n; ++k)
+		{
+			if (p -> data[k] != want[i++])
+			{
+				i = n + 1;
+			}
+		}
+		last = p;
+	}
+	if (p != NULL || i != n || list -> size != n || list -> tail != last)
+	{
+		printf("FAILED: %s: unrolled list does not match\n", what);
+		return 1;
+	}
+	return 0;
+}
+
+/* element index of want[n] inserted or deleted, as the unrolled list does */
+static void array_insert(int *want, size_t *n, size_t index, int value)
+{
+	for (size_t i = (*n)++; i != index; --i)
+	{
+		want[i] = want[i - 1];
+	}
+	want[index] = value;
+}
+
+static void array_delete(int *want, size_t *n, size_t index)
+{
+	for (size_t i = index + 1; i != *n; ++i)
+	{
+		want[i - 1] = want[i];
+	}
+	--*n;
+}
+
+/*
+ * checks ullInsertAt() splitting a full node, at either side of where it
+ * splits and in the tail, and ullDeleteAt() borrowing from and merging
+ * with the next node; then random inserts and deletes
+ */
+static int check_unrolled(void)
+{
+	static int want[64 * ULL_CAP];
+	ulist_t list;
+	size_t n = 0, index;
+	unsigned int seed = 1;
+	int failed = 0, value = 1000;
+
+	initUnrolled(&list, NULL);
+	for (int i = 0; i != 3 * ULL_CAP; ++i)	/* three full nodes */
+	{
+		ullAppend(&list, i);
+		array_insert(want, &n, n, i);
+	}
+	const size_t split[] = {
+			ULL_CAP + 2,	/* a full node, into its lower half */
+			ULL_CAP + ULL_CAP - ULL_CAP / 2,	/* just where it splits */
+			0,	/* the head */
+			n + 1,	/* the tail, which is full: its upper half is the tail */
+			n + 4,
+	};
+	for (size_t k = 0; k != sizeof(split) / sizeof(split[0]); ++k)
+	{
+		failed |= ullInsertAt(&list, split[k], value) != 0;
+		array_insert(want, &n, split[k], value++);
+		failed |= ull_differs("ullInsertAt() splitting", &list, want, n);
+	}
+	ullAppend(&list, value);
+	array_insert(want, &n, n, value++);
+	failed |= ull_differs("ullAppend() after a split tail", &list, want, n);
+	ullClear(&list);
+
+	/* 13, 13, 13: 8 deletions take the first down to 5, and it borrows
+	 * from the second (12, 6, 13); 7 more, and it merges (11, 13) */
+	n = 0;
+	for (int i = 0; i != 3 * ULL_CAP; ++i)
+	{
+		ullAppend(&list, i);
+		array_insert(want, &n, n, i);
+	}
+	for (int i = 0; i != 8 + 7; ++i)
+	{
+		failed |= ullDeleteAt(&list, 1) != 1;
+		array_delete(want, &n, 1);
+		failed |= ull_differs("ullDeleteAt() borrowing, merging", &list,
+				want, n);
+	}
+	failed |= list.head -> pNext != list.tail;
+	while (n != 0)	/* from the tail, down to nothing */
+	{
+		failed |= ullDeleteAt(&list, n - 1) != 1;
+		array_delete(want, &n, n - 1);
+		failed |= ull_differs("ullDeleteAt() the tail", &list, want, n);
+	}
+	failed |= ullDeleteAt(&list, 0) != 0 || ullInsertAt(&list, 1, 0) != -1;
+
+	for (int k = 0; k != 100000 && !failed; ++k)
+	{
+		index = n == 0 ? 0 : rand_r(&seed) % (n + 1);
+		if (n < sizeof(want) / sizeof(want[0]) && (n < 8 * ULL_CAP
+				|| rand_r(&seed) % 2))
+		{
+			failed |= ullInsertAt(&list, index, value) != 0;
+			array_insert(want, &n, index, value++);
+		}
+		else
+		{
+			index -= index == n;
+			failed |= ullDeleteAt(&list, index) != 1;
+			array_delete(want, &n, index);
+		}
+		failed |= ull_differs("random ullInsertAt(), ullDeleteAt()", &list,
+				want, n);
+	}
+	ullClear(&list);
+	return failed;
+}
+
+/*
+ * the old way: builds a list of n from values with addNode(); returns the
+ * nanoseconds taken, or 0 if the list is wrong
+ */
+static uint64_t bench_addnode(const int *values, size_t n)
+{
+	ll_t *head = NULL, *p, *next;
+	uint64_t start, elapsed;
+	size_t i = 0;
+	int ok = 1;
+
+	start = now_ns();
+	for (i = 0; i != n; ++i)
+	{
+		head = addNode(head, values[i]);
+	}
+	elapsed = now_ns() - start;
+	for (p = head, i = 0; p != NULL; p = next, ++i)
+	{
+		ok &= (i < n && p -> data == values[i]);
+		next = p -> pNext;
+		free(p);
+	}
+	return (ok && i == n) ? elapsed : 0;
+}
+
+/* a list_t, from pool if not NULL; returns non-zero if it went wrong */
+static int bench_list(const char *how, const int *values, size_t n,
+		pool_t *pool, long long expect)
+{
+	list_t list;
+	uint64_t t0, t1, t2, t3, t4, t5;
+	long long sum = 0;
+	int failed = 0;
+
+	initList(&list, pool);
+	t0 = now_ns();
+	for (size_t i = 0; i != n; ++i)
+	{
+		if (appendNode(&list, values[i]) == NULL)
+		{
+			printf("out of memory\n");
+			exit(1);
+		}
+	}
+	t1 = now_ns();
+	forEachNode(&list, sum_up, &sum);
+	t2 = now_ns();
+	failed |= findNode(&list, -1, NULL) != NULL; /* values are >= 0 */
+	t3 = now_ns();
+	for (size_t k = 0; k != DELETES; ++k)
+	{
+		failed |= deleteValue(&list, values[n / 2 + k]) != 1;
+	}
+	t4 = now_ns();
+	failed |= sum != expect || list.size != n - DELETES;
+	if (pool != NULL)
+	{
+		freePool(pool);
+		initList(&list, pool);
+	}
+	else
+	{
+		clearList(&list);
+	}
+	t5 = now_ns();
+	report(how, n, t1 - t0, t2 - t1, t3 - t2, t4 - t3, t5 - t4);
+	return failed;
+}
+
+/* an unrolled list from a pool; returns non-zero if it went wrong */
+static int bench_unrolled(const int *values, size_t n, long long expect)
+{
+	pool_t pool;
+	ulist_t list;
+	uint64_t t0, t1, t2, t3, t4, t5;
+	long long sum = 0;
+	int failed = 0;
+
+	initPool(&pool, sizeof(ull_t), 0);
+	initUnrolled(&list, &pool);
+	t0 = now_ns();
+	for (size_t i = 0; i != n; ++i)
+	{
+		if (ullAppend(&list, values[i]) != 0)
+		{
+			printf("out of memory\n");
+			exit(1);
+		}
+	}
+	t1 = now_ns();
+	ullForEach(&list, sum_up, &sum);
+	t2 = now_ns();
+	failed |= ullFind(&list, -1) != -1;
+	t3 = now_ns();
+	for (size_t k = 0; k != DELETES; ++k)
+	{
+		failed |= ullDeleteValue(&list, values[n / 2 + k]) != 1;
+	}
+	t4 = now_ns();
+	failed |= sum != expect || list.size != n - DELETES;
+
+	/* put them back, in their places, and check the order (not timed) */
+	for (size_t k = 0; k != DELETES; ++k)
+	{
+		failed |= ullInsertAt(&list, n / 2 + k, values[n / 2 + k]) != 0;
+	}
+	for (size_t k = 0; k < n; k += n / 97 + 1)
+	{
+		failed |= ullFind(&list, values[k]) != (long) k;
+	}
+	t5 = now_ns();
+	freePool(&pool);
+	report("unrolled, pool", n, t1 - t0, t2 - t1, t3 - t2, t4 - t3,
+			now_ns() - t5);
+	return failed;
+}
+
+int main(int argc, char *argv[])
+{
+	size_t max_n = 10000000, old_n = 30000, n;
+	int opt, failed = 0;
+	int *values;
+	pool_t pool;
+	uint64_t elapsed;
+
+	while ((opt = getopt(argc, argv, "n:o:")) != -1)
+	{
+		switch (opt)
+		{
+		case 'n':
+			max_n = strtoul(optarg, NULL, 0);
+			break;
+		case 'o':
+			old_n = strtoul(optarg, NULL, 0);
+			break;
+		default:
+			printf("usage: %s [-n elements] [-o elements for addNode()]\n",
+					argv[0]);
+			return 2;
+		}
+	}
+	if (max_n < 2 * DELETES)
+	{
+		printf("need at least %d elements\n", 2 * DELETES);
+		return 2;
+	}
+
+	/* distinct values, so that each delete finds its own */
+	values = malloc((max_n > old_n ? max_n : old_n) * sizeof(int));
+	if (values == NULL)
+	{
+		printf("out of memory\n");
+		return 1;
+	}
+	for (size_t i = 0; i != (max_n > old_n ? max_n : old_n); ++i)
+	{
+		values[i] = (int) ((i * 2654435761u) & 0x7FFFFFFF);
+	}
+	failed |= check_list();
+	failed |= check_unrolled();
+
+	printf("%-16s %9s %9s %9s %9s %9s %9s\n", "", "elements", "build",
+			"traverse", "search", "delete", "free");
+	printf("%-16s %9s %9s %9s %9s %9s %9s\n", "", "", "ns/el", "ns/el",
+			"ns/el", "us/op", "ns/el");
+	/* quadratic: doubling n quadruples the time */
+	for (n = old_n / 4; n <= old_n && n != 0; n *= 2)
+	{
+		elapsed = bench_addnode(values, n);
+		failed |= elapsed == 0;
+		report("addNode", n, elapsed, 0, 0, 0, 0);
+	}
+	for (n = max_n / 10; n <= max_n; n *= 10)
+	{
+		long long expect = 0;
+
+		if (n < 2 * DELETES)
+		{
+			continue;
+		}
+		for (size_t i = 0; i != n; ++i)
+		{
+			expect += values[i];
+		}
+		failed |= bench_list("list, malloc", values, n, NULL, expect);
+		initPool(&pool, sizeof(ll_t), 0);
+		failed |= bench_list("list, pool", values, n, &pool, expect);
+		failed |= bench_unrolled(values, n, expect);
+	}
+	if (failed)
+	{
+		printf("FAILED\n");
+	}
+	free(values);
+	return failed;
+}
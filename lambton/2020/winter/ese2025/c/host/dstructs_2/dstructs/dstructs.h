@@ -31,7 +31,7 @@ typedef struct linkedList ll_t;
  *
  * 		creates a node of type ll_t from the heap, and returns
  * 		a pointer to this newly created node; sets the node's own
- * 	    pNext pointer to NULL
+ * 	    pNext pointer to NULL; returns NULL if the heap is exhausted
  *
  */
 ll_t*	createNode();
@@ -41,9 +41,230 @@ ll_t*	createNode();
  *
  * 		adds a new node (with node->data = value) to the bottom/back
  * 		of the list referenced by the pointer, head;
- * 		if head==NULL, a new list is created
+ * 		if head==NULL, a new list is created; the list is walked to
+ * 		find its tail, so building a list this way takes O(N^2) steps:
+ * 		appendNode(), below, takes O(1) each
  *
  */
 ll_t* 	addNode(ll_t*, int);
 
+
+/************************************************************
+ * NODE POOL: nodes carved out of big slabs of the heap
+ ************************************************************/
+struct poolSlab
+{
+	struct	poolSlab *pNext;
+};
+
+struct nodePool
+{
+	size_t	size;		/* bytes per node */
+	size_t	perSlab;	/* nodes per slab */
+	struct	poolSlab *slabs;	/* every slab, to free them all at once */
+	void	*pFree;		/* nodes given back, for reuse */
+	char	*next;		/* the unused part of the newest slab */
+	char	*end;
+};
+typedef struct nodePool pool_t;
+
+#define		POOL_SLAB_NODES		4096 /* nodes per slab, by default */
+
+/*
+ * initPool():
+ *
+ * 		sets up an empty pool of nodes of size bytes each, taken
+ * 		from the heap perSlab at a time (POOL_SLAB_NODES if 0)
+ *
+ */
+void	initPool(pool_t*, size_t, size_t);
+
+/*
+ * poolAlloc(), poolRelease():
+ *
+ * 		take a node from the pool (NULL if the heap is exhausted),
+ * 		or give one back to it for reuse
+ *
+ */
+void*	poolAlloc(pool_t*);
+void	poolRelease(pool_t*, void*);
+
+/*
+ * freePool():
+ *
+ * 		gives all of the pool's slabs back to the heap at once: every
+ * 		node taken from it is gone, and the pool is empty again
+ *
+ */
+void	freePool(pool_t*);
+
+
+/************************************************************
+ * LIST HEADER: head, tail and size of a list of ll_t nodes
+ ************************************************************/
+struct listHeader
+{
+	ll_t	*head;
+	ll_t	*tail;
+	size_t	size;
+	pool_t	*pool;	/* where the nodes come from; NULL: createNode() */
+};
+typedef struct listHeader list_t;
+
+/*
+ * initList():
+ *
+ * 		makes the list empty; its nodes will come from pool, or from
+ * 		createNode() if pool==NULL
+ *
+ */
+void	initList(list_t*, pool_t*);
+
+/*
+ * appendNode(), prependNode():
+ *
+ * 		add a new node (with node->data = value) to the back, or the
+ * 		front, of the list, in O(1); return the node, or NULL if out
+ * 		of memory
+ *
+ */
+ll_t*	appendNode(list_t*, int);
+ll_t*	prependNode(list_t*, int);
+
+/*
+ * insertAfter():
+ *
+ * 		adds a new node (with node->data = value) after the node prev
+ * 		of the list, or at the front if prev==NULL; returns the node,
+ * 		or NULL if out of memory
+ *
+ */
+ll_t*	insertAfter(list_t*, ll_t*, int);
+
+/*
+ * findNode():
+ *
+ * 		returns the first node with node->data == value, or NULL; if
+ * 		pPrev!=NULL, *pPrev is set to the node before it (NULL for the
+ * 		head), for deleteAfter()
+ *
+ */
+ll_t*	findNode(const list_t*, int, ll_t**);
+
+/*
+ * deleteAfter(), deleteValue():
+ *
+ * 		remove the node after prev (the head if prev==NULL), or the
+ * 		first node with node->data == value; return 1 if a node was
+ * 		removed, 0 if there was none
+ *
+ */
+int		deleteAfter(list_t*, ll_t*);
+int		deleteValue(list_t*, int);
+
+/*
+ * forEachNode():
+ *
+ * 		calls visit(node->data, arg) for each node, front to back
+ *
+ */
+void	forEachNode(const list_t*, void (*)(int, void*), void*);
+
+/*
+ * clearList():
+ *
+ * 		removes every node, returning it to the list's pool (or the
+ * 		heap); a list whose pool is about to go with freePool() may
+ * 		simply be initialised again instead
+ *
+ */
+void	clearList(list_t*);
+
+
+/************************************************************
+ * UNROLLED LIST: several ints per node, for fewer cache misses
+ ************************************************************/
+#define		ULL_CAP		13 /* ints per node: the node fills 64 bytes */
+
+struct unrolledNode
+{
+	struct	unrolledNode *pNext;
+	int		count;		/* of data[] in use, from data[0] */
+	int		data[ULL_CAP];
+};
+typedef struct unrolledNode ull_t;
+
+struct unrolledList
+{
+	ull_t	*head;
+	ull_t	*tail;
+	size_t	size;	/* ints, not nodes */
+	pool_t	*pool;	/* where the nodes come from; NULL: the heap */
+};
+typedef struct unrolledList ulist_t;
+
+/*
+ * initUnrolled():
+ *
+ * 		makes the list empty; its nodes will come from pool (of nodes
+ * 		of sizeof(ull_t) bytes), or from the heap if pool==NULL
+ *
+ */
+void	initUnrolled(ulist_t*, pool_t*);
+
+/*
+ * ullAppend():
+ *
+ * 		adds value to the back of the list, in O(1); returns 0, or -1
+ * 		if out of memory
+ *
+ */
+int		ullAppend(ulist_t*, int);
+
+/*
+ * ullInsertAt():
+ *
+ * 		inserts value so that it becomes element index of the list
+ * 		(index==size appends), splitting a full node in two; returns 0,
+ * 		or -1 if out of memory or index > size
+ *
+ */
+int		ullInsertAt(ulist_t*, size_t, int);
+
+/*
+ * ullFind():
+ *
+ * 		returns the index of the first element equal to value, or -1
+ *
+ */
+long	ullFind(const ulist_t*, int);
+
+/*
+ * ullDeleteAt(), ullDeleteValue():
+ *
+ * 		remove element index, or the first element equal to value,
+ * 		merging a node that falls below half full with the next one;
+ * 		return 1 if an element was removed, 0 if there was none
+ *
+ */
+int		ullDeleteAt(ulist_t*, size_t);
+int		ullDeleteValue(ulist_t*, int);
+
+/*
+ * ullForEach():
+ *
+ * 		calls visit(element, arg) for each element, front to back
+ *
+ */
+void	ullForEach(const ulist_t*, void (*)(int, void*), void*);
+
+/*
+ * ullClear():
+ *
+ * 		removes every element, returning the nodes to the list's pool
+ * 		(or the heap)
+ *
+ */
+void	ullClear(ulist_t*);
+
 #endif /* DSTRUCTS_DSTRUCTS_H_ */
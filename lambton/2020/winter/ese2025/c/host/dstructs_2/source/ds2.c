@@ -17,24 +17,29 @@ int main()
 	int loadarr[N] = { 23, 46, 227, 81, 32,
 			   17,  9,  26, 25, 22  };
 
-	/* create a linked list from loadarr data */
-	ll_t* mylisthead;
-	mylisthead = (ll_t *) malloc(sizeof(ll_t));
-	mylisthead -> data = loadarr[0];
-	mylisthead -> pNext = NULL;
+	/* create a linked list from loadarr data, its nodes from a pool */
+	pool_t	mypool;
+	list_t	mylist;
+	initPool(&mypool, sizeof(ll_t), 0);
+	initList(&mylist, &mypool);
 
-	size_t i = 1;
+	size_t i = 0;
 	while (i != N)
 	{
-		addNode(mylisthead, loadarr[i]);
+		if (appendNode(&mylist, loadarr[i]) == NULL)
+		{
+			printf("Out of memory\n");
+			freePool(&mypool);
+			return 1;
+		}
 		++i;
 	}
 
 	/* find the largest element in the list */
-	int max = mylisthead -> data;
+	int max = mylist.head -> data;
 	int nexti;
-	ll_t* pw=(mylisthead->pNext); /* working pointer */
-	while ((pw -> pNext) != NULL)
+	ll_t* pw=(mylist.head->pNext); /* working pointer */
+	while (pw != NULL)
 	{
 		nexti = pw -> data;
 		if (max < nexti)
@@ -45,6 +50,7 @@ int main()
 	}
 
 	/* announce the results */
-	printf("Your largest integer is %d", max);
+	printf("Your largest integer is %d\n", max);
+	freePool(&mypool); /* all the list's nodes, at once */
 	return 0;
 }
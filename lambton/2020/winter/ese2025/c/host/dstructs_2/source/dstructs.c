@@ -6,6 +6,7 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include "dstructs.h"
 
 /*
@@ -23,6 +24,10 @@ ll_t*	createNode()
 
     /* allocate the node from heap */
     node = 	(ll_t *) malloc(sizeof(struct linkedList));
+    if (node == NULL)
+    {
+        return NULL;	/* out of memory */
+    }
 
     /* make next point to NULL */
     node -> pNext = NULL;//
@@ -47,6 +52,10 @@ ll_t* 	addNode(ll_t* head, int value)
 
     /* prepare the new node to be added */
     node = createNode();
+    if (node == NULL)
+    {
+        return head;	/* out of memory: the list is unchanged */
+    }
     node -> data = value; /* set the new element's data field to value */
 
     if (head == NULL)
@@ -67,3 +76,515 @@ ll_t* 	addNode(ll_t* head, int value)
     return head;
 }
 
+/************************************************************
+ * NODE POOL
+ ************************************************************/
+
+/*
+ * initPool():
+ *
+ * 		sets up an empty pool of nodes of size bytes each, taken
+ * 		from the heap perSlab at a time (POOL_SLAB_NODES if 0)
+ *
+ */
+void	initPool(pool_t* pool, size_t size, size_t perSlab)
+{
+	/* a free node holds the link to the next free one, so it must
+	 * have room for a pointer, and be aligned for one */
+	if (size < sizeof(void *))
+	{
+		size = sizeof(void *);
+	}
+	pool -> size = (size + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+	pool -> perSlab = perSlab ? perSlab : POOL_SLAB_NODES;
+	pool -> slabs = NULL;
+	pool -> pFree = NULL;
+	pool -> next = NULL;
+	pool -> end = NULL;
+}
+
+/*
+ * poolAlloc():
+ *
+ * 		takes a node from the pool: one given back, if any, or else
+ * 		the next one of the newest slab, starting a new slab when it
+ * 		runs out; returns NULL if the heap is exhausted
+ *
+ */
+void*	poolAlloc(pool_t* pool)
+{
+	void	*node;
+	struct	poolSlab *slab;
+
+	if (pool -> pFree != NULL)
+	{
+		node = pool -> pFree;
+		pool -> pFree = *(void **) node;
+		return node;
+	}
+	if (pool -> next == pool -> end)
+	{
+		slab = malloc(sizeof(struct poolSlab) + pool -> perSlab * pool -> size);
+		if (slab == NULL)
+		{
+			return NULL;
+		}
+		slab -> pNext = pool -> slabs;
+		pool -> slabs = slab;
+		pool -> next = (char *) (slab + 1);
+		pool -> end = pool -> next + pool -> perSlab * pool -> size;
+	}
+	node = pool -> next;
+	pool -> next += pool -> size;
+	return node;
+}
+
+/*
+ * poolRelease():
+ *
+ * 		gives a node back to the pool, for reuse
+ *
+ */
+void	poolRelease(pool_t* pool, void* node)
+{
+	*(void **) node = pool -> pFree;
+	pool -> pFree = node;
+}
+
+/*
+ * freePool():
+ *
+ * 		gives all of the pool's slabs back to the heap at once
+ *
+ */
+void	freePool(pool_t* pool)
+{
+	struct	poolSlab *slab;
+
+	while (pool -> slabs != NULL)
+	{
+		slab = pool -> slabs;
+		pool -> slabs = slab -> pNext;
+		free(slab);
+	}
+	pool -> pFree = NULL;
+	pool -> next = NULL;
+	pool -> end = NULL;
+}
+
+
+/************************************************************
+ * LIST HEADER
+ ************************************************************/
+
+/* takes a node for list from its pool, or from the heap */
+static ll_t*	listNode(list_t* list, int value)
+{
+	ll_t	*node;
+
+	if (list -> pool != NULL)
+	{
+		node = (ll_t *) poolAlloc(list -> pool);
+	}
+	else
+	{
+		node = createNode();
+	}
+	if (node != NULL)
+	{
+		node -> data = value;
+		node -> pNext = NULL;
+	}
+	return node;
+}
+
+/* gives a node of list back to its pool, or to the heap */
+static void	dropNode(list_t* list, ll_t* node)
+{
+	if (list -> pool != NULL)
+	{
+		poolRelease(list -> pool, node);
+	}
+	else
+	{
+		free(node);
+	}
+}
+
+void	initList(list_t* list, pool_t* pool)
+{
+	list -> head = NULL;
+	list -> tail = NULL;
+	list -> size = 0;
+	list -> pool = pool;
+}
+
+ll_t*	appendNode(list_t* list, int value)
+{
+	ll_t	*node = listNode(list, value);
+
+	if (node == NULL)
+	{
+		return NULL;
+	}
+	if (list -> tail == NULL)
+	{
+		list -> head = node;	/* the list was empty */
+	}
+	else
+	{
+		list -> tail -> pNext = node;
+	}
+	list -> tail = node;
+	list -> size++;
+	return node;
+}
+
+ll_t*	prependNode(list_t* list, int value)
+{
+	return insertAfter(list, NULL, value);
+}
+
+ll_t*	insertAfter(list_t* list, ll_t* prev, int value)
+{
+	ll_t	*node = listNode(list, value);
+
+	if (node == NULL)
+	{
+		return NULL;
+	}
+	if (prev == NULL)
+	{
+		node -> pNext = list -> head;
+		list -> head = node;
+	}
+	else
+	{
+		node -> pNext = prev -> pNext;
+		prev -> pNext = node;
+	}
+	if (node -> pNext == NULL)
+	{
+		list -> tail = node;	/* the new node is the last */
+	}
+	list -> size++;
+	return node;
+}
+
+ll_t*	findNode(const list_t* list, int value, ll_t** pPrev)
+{
+	ll_t	*prev = NULL;
+	ll_t	*p = list -> head;
+
+	while (p != NULL && p -> data != value)
+	{
+		prev = p;
+		p = p -> pNext;
+	}
+	if (pPrev != NULL)
+	{
+		*pPrev = prev;
+	}
+	return p;
+}
+
+int		deleteAfter(list_t* list, ll_t* prev)
+{
+	ll_t	*node = (prev == NULL) ? list -> head : prev -> pNext;
+
+	if (node == NULL)
+	{
+		return 0;
+	}
+	if (prev == NULL)
+	{
+		list -> head = node -> pNext;
+	}
+	else
+	{
+		prev -> pNext = node -> pNext;
+	}
+	if (list -> tail == node)
+	{
+		list -> tail = prev;	/* the last node went */
+	}
+	list -> size--;
+	dropNode(list, node);
+	return 1;
+}
+
+int		deleteValue(list_t* list, int value)
+{
+	ll_t	*prev;
+
+	if (findNode(list, value, &prev) == NULL)
+	{
+		return 0;
+	}
+	return deleteAfter(list, prev);
+}
+
+void	forEachNode(const list_t* list, void (*visit)(int, void*), void* arg)
+{
+	for (ll_t *p = list -> head; p != NULL; p = p -> pNext)
+	{
+		visit(p -> data, arg);
+	}
+}
+
+void	clearList(list_t* list)
+{
+	ll_t	*p = list -> head;
+	ll_t	*next;
+
+	while (p != NULL)
+	{
+		next = p -> pNext;
+		dropNode(list, p);
+		p = next;
+	}
+	initList(list, list -> pool);
+}
+
+
+/************************************************************
+ * UNROLLED LIST
+ ************************************************************/
+
+/* takes an empty node for list from its pool, or from the heap */
+static ull_t*	unrolledNode(ulist_t* list)
+{
+	ull_t	*node;
+
+	if (list -> pool != NULL)
+	{
+		node = (ull_t *) poolAlloc(list -> pool);
+	}
+	else
+	{
+		node = (ull_t *) malloc(sizeof(ull_t));
+	}
+	if (node != NULL)
+	{
+		node -> pNext = NULL;
+		node -> count = 0;
+	}
+	return node;
+}
+
+/* unlinks node, which follows prev (NULL: node is the head), from list */
+static void	dropUnrolled(ulist_t* list, ull_t* prev, ull_t* node)
+{
+	if (prev == NULL)
+	{
+		list -> head = node -> pNext;
+	}
+	else
+	{
+		prev -> pNext = node -> pNext;
+	}
+	if (list -> tail == node)
+	{
+		list -> tail = prev;
+	}
+	if (list -> pool != NULL)
+	{
+		poolRelease(list -> pool, node);
+	}
+	else
+	{
+		free(node);
+	}
+}
+
+void	initUnrolled(ulist_t* list, pool_t* pool)
+{
+	list -> head = NULL;
+	list -> tail = NULL;
+	list -> size = 0;
+	list -> pool = pool;
+}
+
+int		ullAppend(ulist_t* list, int value)
+{
+	ull_t	*node = list -> tail;
+
+	if (node == NULL || node -> count == ULL_CAP)
+	{
+		node = unrolledNode(list);
+		if (node == NULL)
+		{
+			return -1;
+		}
+		if (list -> tail == NULL)
+		{
+			list -> head = node;
+		}
+		else
+		{
+			list -> tail -> pNext = node;
+		}
+		list -> tail = node;
+	}
+	node -> data[node -> count++] = value;
+	list -> size++;
+	return 0;
+}
+
+int		ullInsertAt(ulist_t* list, size_t index, int value)
+{
+	ull_t	*node = list -> head;
+	ull_t	*half;
+	size_t	i;
+
+	if (index > list -> size)
+	{
+		return -1;
+	}
+	if (index == list -> size)
+	{
+		return ullAppend(list, value);
+	}
+
+	/* find the node holding element index */
+	while (index >= (size_t) node -> count)
+	{
+		index -= node -> count;
+		node = node -> pNext;
+	}
+	i = index;
+
+	/* no room: move the upper half of the node into a new one after it */
+	if (node -> count == ULL_CAP)
+	{
+		half = unrolledNode(list);
+		if (half == NULL)
+		{
+			return -1;
+		}
+		half -> count = ULL_CAP / 2;
+		node -> count -= half -> count;
+		memcpy(half -> data, node -> data + node -> count,
+				half -> count * sizeof(int));
+		half -> pNext = node -> pNext;
+		node -> pNext = half;
+		if (list -> tail == node)
+		{
+			list -> tail = half;
+		}
+		if (i > (size_t) node -> count)
+		{
+			i -= node -> count;
+			node = half;
+		}
+	}
+	memmove(node -> data + i + 1, node -> data + i,
+			(node -> count - i) * sizeof(int));
+	node -> data[i] = value;
+	node -> count++;
+	list -> size++;
+	return 0;
+}
+
+long	ullFind(const ulist_t* list, int value)
+{
+	long	base = 0;
+
+	for (ull_t *p = list -> head; p != NULL; p = p -> pNext)
+	{
+		for (int i = 0; i != p -> count; ++i)
+		{
+			if (p -> data[i] == value)
+			{
+				return base + i;
+			}
+		}
+		base += p -> count;
+	}
+	return -1;
+}
+
+int		ullDeleteAt(ulist_t* list, size_t index)
+{
+	ull_t	*prev = NULL;
+	ull_t	*node = list -> head;
+	ull_t	*next;
+	size_t	i;
+
+	if (index >= list -> size)
+	{
+		return 0;
+	}
+	while (index >= (size_t) node -> count)
+	{
+		index -= node -> count;
+		prev = node;
+		node = node -> pNext;
+	}
+	i = index;
+	memmove(node -> data + i, node -> data + i + 1,
+			(node -> count - i - 1) * sizeof(int));
+	node -> count--;
+	list -> size--;
+
+	if (node -> count == 0)
+	{
+		dropUnrolled(list, prev, node);
+	}
+	else if (node -> count < ULL_CAP / 2 && (next = node -> pNext) != NULL)
+	{
+		/* below half full: take what fits from the next node */
+		int	take = ULL_CAP - node -> count;
+
+		if (take >= next -> count)
+		{
+			memcpy(node -> data + node -> count, next -> data,
+					next -> count * sizeof(int));
+			node -> count += next -> count;
+			dropUnrolled(list, node, next);
+		}
+		else
+		{
+			/* or borrow, leaving the next one half full */
+			take = next -> count - ULL_CAP / 2;
+			memcpy(node -> data + node -> count, next -> data,
+					take * sizeof(int));
+			memmove(next -> data, next -> data + take,
+					(next -> count - take) * sizeof(int));
+			node -> count += take;
+			next -> count -= take;
+		}
+	}
+	return 1;
+}
+
+int		ullDeleteValue(ulist_t* list, int value)
+{
+	long	index = ullFind(list, value);
+
+	if (index < 0)
+	{
+		return 0;
+	}
+	return ullDeleteAt(list, (size_t) index);
+}
+
+void	ullForEach(const ulist_t* list, void (*visit)(int, void*), void* arg)
+{
+	for (ull_t *p = list -> head; p != NULL; p = p -> pNext)
+	{
+		for (int i = 0; i != p -> count; ++i)
+		{
+			visit(p -> data[i], arg);
+		}
+	}
+}
+
+void	ullClear(ulist_t* list)
+{
+	while (list -> head != NULL)
+	{
+		dropUnrolled(list, NULL, list -> head);
+	}
+	list -> size = 0;
+}
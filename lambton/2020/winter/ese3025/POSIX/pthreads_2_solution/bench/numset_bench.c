@@ -0,0 +1,244 @@
+/*
+ * numset_bench.c:
+ *
+ * 		benchmark of the set of integers (numset) against the way the
+ * 		threads of pthreads_2 used to do it, which, for each integer
+ * 		entered, added up the whole set again and bubble sorted it until no
+ * 		swaps were left
+ *
+ * 		gcc -std=gnu11 -O2 -Wall -I../source -o numset_bench numset_bench.c \
+ * 			../source/numset.c -lpthread -lm
+ *
+ * 		./numset_bench [-n values] [-t threads] [-s seed]
+ *
+ * 		it reports the time per value for: the old way (for sets small
+ * 		enough to finish), numset_insert() one value at a time, and
+ * 		numset_insert_bulk() with 1, 2, 4, ... threads; every set is
+ * 		checked, in order and in its statistics, against a plain sort
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include "numset.h"
+
+#define OLD_MAX		1000 /* largest set for the old way: it is O(n^3), and its
+				   int sum must not overflow */
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static uint32_t rng;
+
+static int next_int(void)
+{
+	rng ^= rng << 13;
+	rng ^= rng >> 17;
+	rng ^= rng << 5;
+	return (int) (rng % 2000001) - 1000000;
+}
+
+static int cmp_int(const void *a, const void *b)
+{
+	int x = *(const int *) a;
+	int y = *(const int *) b;
+
+	return (x > y) - (x < y);
+}
+
+/* what the threads of pthreads_2 did for each integer entered */
+static volatile float average;
+
+static void old_way(int *set, const int *values, size_t n)
+{
+	int sum, swaps, temp;
+
+	for (size_t k = 0; k != n; ++k)
+	{
+		set[k] = values[k];
+		sum = 0;
+		for (size_t i = 0; i != k + 1; ++i)
+		{
+			sum += set[i];
+		}
+		average = (float) (sum / (int) (k + 1));
+		swaps = 1;
+		while (swaps == 1)
+		{
+			swaps = 0;
+			for (size_t i = 0; i != k; ++i)
+			{
+				if (set[i] > set[i + 1])
+				{
+					temp = set[i];
+					set[i] = set[i + 1];
+					set[i + 1] = temp;
+					swaps = 1;
+				}
+			}
+		}
+	}
+}
+
+/*
+ * checks the set against the values, sorted, and their statistics; returns
+ * non-zero if it is wrong
+ */
+static int check(numset_t *s, const int *sorted, size_t n)
+{
+	static int *got;
+	numset_stats_t st;
+	double mean = 0.0, var = 0.0;
+	long long sum = 0;
+	int failed;
+
+	got = realloc(got, (n ? n : 1) * sizeof(int));
+	if (got == NULL)
+	{
+		printf("out of memory\n");
+		exit(1);
+	}
+	for (size_t i = 0; i != n; ++i)
+	{
+		sum += sorted[i];
+	}
+	mean = n ? (double) sum / n : 0.0;
+	for (size_t i = 0; i != n; ++i)
+	{
+		var += (sorted[i] - mean) * (sorted[i] - mean);
+	}
+	var = n > 1 ? var / n : 0.0;
+
+	numset_get_stats(s, &st);
+	failed = numset_copy_sorted(s, got, n) != n
+			|| memcmp(got, sorted, n * sizeof(int)) != 0
+			|| st.count != n || st.sum != sum
+			|| fabs(st.mean - mean) > 1e-6 * (1.0 + fabs(mean))
+			|| fabs(st.variance - var) > 1e-6 * (1.0 + var)
+			|| (n && (st.min != sorted[0] || st.max != sorted[n - 1]));
+	if (failed)
+	{
+		printf("  FAILED: count %zu mean %f variance %f\n", st.count, st.mean,
+				st.variance);
+	}
+	return failed;
+}
+
+/* the speedup is against base, if any */
+static void report(const char *how, size_t n, uint64_t elapsed, uint64_t base)
+{
+	printf("%-22s %10zu %12.1f", how, n, (double) elapsed / n);
+	if (base != 0)
+	{
+		printf(" %8.2fx", (double) base / elapsed);
+	}
+	printf("\n");
+}
+
+int main(int argc, char *argv[])
+{
+	size_t max_n = 10000000, n;
+	int max_threads = (int) sysconf(_SC_NPROCESSORS_ONLN), opt, failed = 0;
+	uint32_t seed = 2019;
+	int *values, *sorted, *set;
+	numset_t s;
+	uint64_t start, elapsed;
+	char label[32];
+
+	while ((opt = getopt(argc, argv, "n:t:s:")) != -1)
+	{
+		switch (opt)
+		{
+		case 'n':
+			max_n = strtoul(optarg, NULL, 0);
+			break;
+		case 't':
+			max_threads = atoi(optarg);
+			break;
+		case 's':
+			seed = strtoul(optarg, NULL, 0);
+			break;
+		default:
+			printf("usage: %s [-n values] [-t threads] [-s seed]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (max_n == 0 || max_threads < 1 || max_threads > NUMSET_MAX_THREADS)
+	{
+		printf("need some values, and 1 to %d threads\n", NUMSET_MAX_THREADS);
+		return 2;
+	}
+
+	values = malloc(max_n * sizeof(int));
+	sorted = malloc(max_n * sizeof(int));
+	set = malloc(OLD_MAX * sizeof(int));
+	if (values == NULL || sorted == NULL || set == NULL)
+	{
+		printf("out of memory\n");
+		return 1;
+	}
+	rng = seed | 1;
+	for (size_t i = 0; i != max_n; ++i)
+	{
+		values[i] = next_int();
+	}
+
+	printf("%-22s %10s %12s %9s\n", "", "values", "ns/value", "speedup");
+	for (n = max_n < 1000 ? max_n : 1000;; n = n * 10 < max_n ? n * 10 : max_n)
+	{
+		uint64_t old = 0, one;
+
+		memcpy(sorted, values, n * sizeof(int));
+		qsort(sorted, n, sizeof(int), cmp_int);
+
+		if (n <= OLD_MAX)
+		{
+			start = now_ns();
+			old_way(set, values, n);
+			old = now_ns() - start;
+			report("re-sum + bubble sort", n, old, 0);
+		}
+
+		/* one at a time, against the old way */
+		numset_init(&s);
+		start = now_ns();
+		for (size_t i = 0; i != n; ++i)
+		{
+			numset_insert(&s, values[i]);
+		}
+		one = now_ns() - start;
+		report("numset_insert", n, one, old);
+		failed |= check(&s, sorted, n);
+		numset_destroy(&s);
+
+		/* in bulk, against one at a time */
+		for (int t = 1; t <= max_threads; t *= 2)
+		{
+			numset_init(&s);
+			start = now_ns();
+			numset_insert_bulk(&s, values, n, t);
+			elapsed = now_ns() - start;
+			snprintf(label, sizeof(label), "numset_insert_bulk/%d", t);
+			report(label, n, elapsed, one);
+			failed |= check(&s, sorted, n);
+			numset_destroy(&s);
+		}
+		if (n == max_n)
+		{
+			break;
+		}
+	}
+
+	free(set);
+	free(sorted);
+	free(values);
+	return failed;
+}
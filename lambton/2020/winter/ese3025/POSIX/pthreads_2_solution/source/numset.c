@@ -0,0 +1,542 @@
+/*
+ * numset.c
+ *
+ *	the set of integers of numset.h: running statistics, the sorted run and
+ *	the ladder of merged runs, the parallel sort of bulk loads, and the
+ *	condition variable readers wait on
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "numset.h"
+
+#define	BULK_MIN_CHUNK	65536 // values per thread worth starting a thread for
+
+/*
+ * 	running statistics of some values, for a chunk of a bulk load
+ */
+struct moments
+{
+	size_t	count;
+	long long	sum;
+	double	mean;
+	double	m2;
+	int	min;
+	int	max;
+};
+
+/* a chunk of a bulk load, for one thread to sort (or merge) */
+struct chunk
+{
+	pthread_t	thread;
+	int	*v; // the values, sorted in place
+	size_t	n;
+	int	*scratch; // for sorting: as much room as the values take
+	const int	*b; // for merging: a second sorted run, ...
+	size_t	nb;
+	int	*out; // ... and where the merged run goes
+	struct moments	m;
+};
+
+/*********************/
+/* private functions */
+/*********************/
+
+/*
+ *	function to add a set of moments, b, to a, by the pairwise formulas of
+ *	Chan, Golub and LeVeque: no pass over the values is needed
+ */
+static void	moments_add(struct moments *a, const struct moments *b)
+{
+	size_t	n = a->count + b->count;
+	double	delta = b->mean - a->mean;
+
+	if (b->count == 0)
+	{
+		return;
+	}
+	a->mean += delta * b->count / n;
+	a->m2 += b->m2 + delta * delta * a->count / n * b->count;
+	a->sum += b->sum;
+	a->count = n;
+	if (b->min < a->min)
+	{
+		a->min = b->min;
+	}
+	if (b->max > a->max)
+	{
+		a->max = b->max;
+	}
+}
+
+/*
+ *	function to merge nsrc sorted runs into out, stopping after max values;
+ *	returns the number merged
+ */
+static size_t	merge_runs(const int **src, const size_t *n, int nsrc, int *out,
+		size_t max)
+{
+	size_t	at[NUMSET_LEVELS + 1] = { 0 };
+	size_t	k = 0;
+	int	i, best;
+
+	while (k != max)
+	{
+		best = -1;
+		for (i = 0; i != nsrc; ++i)
+		{
+			if (at[i] != n[i]
+					&& (best < 0 || src[i][at[i]] < src[best][at[best]]))
+			{
+				best = i;
+			}
+		}
+		if (best < 0)
+		{
+			break; // all used up
+		}
+		out[k++] = src[best][at[best]++];
+	}
+	return k;
+}
+
+/* the capacity of level i */
+static size_t	level_cap(int i)
+{
+	return (size_t) NUMSET_RUN << i;
+}
+
+/*
+ *	function to put a sorted run of m values into the ladder, from level k
+ *	up: the run and the levels from k on are merged, with one allocation,
+ *	into the first level that can hold them all; if adopt is set, and no
+ *	level has to be merged in, the run itself (from malloc()) becomes the
+ *	level; returns -1, with the ladder unchanged, when out of memory
+ */
+static int	spill(numset_t *s, int k, int *run, size_t m, int adopt)
+{
+	const int	*src[NUMSET_LEVELS + 1];
+	size_t	n[NUMSET_LEVELS + 1];
+	size_t	total = m;
+	int	i, j, nsrc = 0;
+	int	*v;
+
+	src[nsrc] = run;
+	n[nsrc++] = m;
+	for (j = k; j != NUMSET_LEVELS; ++j)
+	{
+		if (s->level[j].n != 0)
+		{
+			total += s->level[j].n;
+			src[nsrc] = s->level[j].v;
+			n[nsrc++] = s->level[j].n;
+		}
+		if (total <= level_cap(j))
+		{
+			break;
+		}
+	}
+	if (j == NUMSET_LEVELS)
+	{
+		return -1; // the ladder is full
+	}
+
+	if (nsrc == 1 && adopt)
+	{
+		v = run;
+	}
+	else
+	{
+		v = malloc(total * sizeof(int));
+		if (v == NULL)
+		{
+			return -1;
+		}
+		merge_runs(src, n, nsrc, v, total);
+		if (adopt)
+		{
+			free(run);
+		}
+	}
+	for (i = k; i != j; ++i)
+	{
+		free(s->level[i].v);
+		s->level[i].v = NULL;
+		s->level[i].n = 0;
+	}
+	free(s->level[j].v);
+	s->level[j].v = v;
+	s->level[j].n = total;
+	return 0;
+}
+
+/* tells the readers that the set has changed; the lock must be held */
+static void	changed(numset_t *s)
+{
+	++s->version;
+	pthread_cond_broadcast(&s->changed);
+}
+
+/*
+ *	function to sort n values, in four passes of a byte each, least
+ *	significant first (the sign bit flipped, so negative values come first),
+ *	through the scratch space tmp, which holds n values as well; an even
+ *	number of passes leaves them back in v
+ */
+static void	radix_sort(int *v, int *tmp, size_t n)
+{
+	size_t	count[256];
+	size_t	i, at, c;
+	unsigned int	x;
+	int	*from = v, *to = tmp, *t;
+
+	for (int shift = 0; shift != 32; shift += 8)
+	{
+		memset(count, 0, sizeof(count));
+		for (i = 0; i != n; ++i)
+		{
+			x = (unsigned int) from[i] ^ 0x80000000u;
+			count[(x >> shift) & 0xFF]++;
+		}
+		for (i = 0, at = 0; i != 256; ++i)
+		{
+			c = count[i];
+			count[i] = at;
+			at += c;
+		}
+		for (i = 0; i != n; ++i)
+		{
+			x = (unsigned int) from[i] ^ 0x80000000u;
+			to[count[(x >> shift) & 0xFF]++] = from[i];
+		}
+		t = from;
+		from = to;
+		to = t;
+	}
+}
+
+/*
+ *	thread function sorts a chunk of a bulk load, and takes its statistics
+ */
+static void	*sort_chunk(void *arg)
+{
+	struct chunk	*c = (struct chunk *) arg;
+	double	delta;
+
+	c->m.count = 0;
+	c->m.sum = 0;
+	c->m.mean = 0.0;
+	c->m.m2 = 0.0;
+	c->m.min = INT_MAX;
+	c->m.max = INT_MIN;
+	for (size_t i = 0; i != c->n; ++i)
+	{
+		c->m.count++;
+		c->m.sum += c->v[i];
+		delta = c->v[i] - c->m.mean;
+		c->m.mean += delta / c->m.count;
+		c->m.m2 += delta * (c->v[i] - c->m.mean);
+	}
+	radix_sort(c->v, c->scratch, c->n);
+	if (c->n != 0)
+	{
+		c->m.min = c->v[0];
+		c->m.max = c->v[c->n - 1];
+	}
+	return NULL;
+}
+
+/*
+ *	thread function merges two neighbouring sorted chunks
+ */
+static void	*merge_chunks(void *arg)
+{
+	struct chunk	*c = (struct chunk *) arg;
+	size_t	i = 0, j = 0, k = 0;
+
+	while (i != c->n && j != c->nb)
+	{
+		c->out[k++] = (c->b[j] < c->v[i]) ? c->b[j++] : c->v[i++];
+	}
+	memcpy(c->out + k, c->v + i, (c->n - i) * sizeof(int));
+	memcpy(c->out + k + c->n - i, c->b + j, (c->nb - j) * sizeof(int));
+	return NULL;
+}
+
+/*
+ *	function to run f on each of the n chunks, a thread for each but the
+ *	first, which the calling thread does itself
+ */
+static void	run_chunks(struct chunk *c, int n, void *(*f)(void *))
+{
+	int	started[NUMSET_MAX_THREADS] = { 0 };
+
+	for (int i = 1; i < n; ++i)
+	{
+		started[i] = pthread_create(&c[i].thread, NULL, f, &c[i]) == 0;
+		if (!started[i])
+		{
+			f(&c[i]); // do it here, then
+		}
+	}
+	f(&c[0]);
+	for (int i = 1; i < n; ++i)
+	{
+		if (started[i])
+		{
+			pthread_join(c[i].thread, NULL);
+		}
+	}
+}
+
+/*************************/
+/* numeric set functions */
+/*************************/
+
+int	numset_init(numset_t *s)
+{
+	memset(s, 0, sizeof(*s));
+	s->min = INT_MAX;
+	s->max = INT_MIN;
+	if (pthread_mutex_init(&s->lock, NULL) != 0)
+	{
+		return -1;
+	}
+	if (pthread_cond_init(&s->changed, NULL) != 0)
+	{
+		pthread_mutex_destroy(&s->lock);
+		return -1;
+	}
+	return 0;
+}
+
+void	numset_destroy(numset_t *s)
+{
+	for (int i = 0; i != NUMSET_LEVELS; ++i)
+	{
+		free(s->level[i].v);
+	}
+	pthread_cond_destroy(&s->changed);
+	pthread_mutex_destroy(&s->lock);
+}
+
+int	numset_insert(numset_t *s, int value)
+{
+	size_t	lo = 0, hi, mid;
+	double	delta;
+
+	pthread_mutex_lock(&s->lock);
+
+	// make room first, so that a failure leaves the set as it was
+	if (s->n_run == NUMSET_RUN)
+	{
+		if (spill(s, 0, s->run, s->n_run, 0) != 0)
+		{
+			pthread_mutex_unlock(&s->lock);
+			return -1;
+		}
+		s->n_run = 0;
+	}
+
+	// binary search for the first value greater than this one, ...
+	hi = s->n_run;
+	while (lo != hi)
+	{
+		mid = lo + (hi - lo) / 2;
+		if (s->run[mid] <= value)
+		{
+			lo = mid + 1;
+		}
+		else
+		{
+			hi = mid;
+		}
+	}
+	// ... and insert it there
+	memmove(&s->run[lo + 1], &s->run[lo], (s->n_run - lo) * sizeof(int));
+	s->run[lo] = value;
+	s->n_run++;
+
+	// update the statistics (Welford)
+	s->count++;
+	s->sum += value;
+	delta = value - s->mean;
+	s->mean += delta / s->count;
+	s->m2 += delta * (value - s->mean);
+	if (value < s->min)
+	{
+		s->min = value;
+	}
+	if (value > s->max)
+	{
+		s->max = value;
+	}
+
+	changed(s);
+	pthread_mutex_unlock(&s->lock);
+	return 0;
+}
+
+int	numset_insert_bulk(numset_t *s, const int *values, size_t n, int threads)
+{
+	struct chunk	c[NUMSET_MAX_THREADS];
+	struct moments	m, total;
+	int	*v, *tmp, *t;
+	int	nc, i, k;
+	size_t	at;
+
+	if (n == 0)
+	{
+		return 0;
+	}
+
+	// one chunk per thread, but not chunks too short to be worth a thread
+	if (threads > NUMSET_MAX_THREADS)
+	{
+		threads = NUMSET_MAX_THREADS;
+	}
+	nc = (int) ((n + BULK_MIN_CHUNK - 1) / BULK_MIN_CHUNK);
+	if (nc > threads)
+	{
+		nc = threads;
+	}
+	if (nc < 1)
+	{
+		nc = 1;
+	}
+
+	// sort a copy, out of the lock: readers carry on meanwhile
+	v = malloc(n * sizeof(int));
+	tmp = malloc(n * sizeof(int));
+	if (v == NULL || tmp == NULL)
+	{
+		free(v);
+		free(tmp);
+		return -1;
+	}
+	memcpy(v, values, n * sizeof(int));
+	for (i = 0, at = 0; i != nc; ++i)
+	{
+		c[i].v = v + at;
+		c[i].scratch = tmp + at;
+		c[i].n = n / nc + ((size_t) i < n % nc);
+		at += c[i].n;
+	}
+	run_chunks(c, nc, sort_chunk);
+
+	total = c[0].m;
+	for (i = 1; i != nc; ++i)
+	{
+		moments_add(&total, &c[i].m);
+	}
+
+	// merge neighbouring chunks in pairs, the pairs in parallel, till one
+	while (nc > 1)
+	{
+		for (i = 0, k = 0; i < nc; i += 2, ++k)
+		{
+			c[k].out = tmp + (c[i].v - v);
+			c[k].v = c[i].v;
+			c[k].n = c[i].n;
+			c[k].b = (i + 1 < nc) ? c[i + 1].v : NULL;
+			c[k].nb = (i + 1 < nc) ? c[i + 1].n : 0;
+		}
+		run_chunks(c, k, merge_chunks);
+		for (i = 0; i != k; ++i)
+		{
+			c[i].v = c[i].out;
+			c[i].n += c[i].nb;
+		}
+		t = v; // the merged runs are in tmp now
+		v = tmp;
+		tmp = t;
+		nc = k;
+	}
+	free(tmp);
+
+	// into the ladder, at the first level that can take it
+	for (k = 0; k != NUMSET_LEVELS - 1 && level_cap(k) < n; ++k)
+		;
+	pthread_mutex_lock(&s->lock);
+	if (spill(s, k, v, n, 1) != 0)
+	{
+		pthread_mutex_unlock(&s->lock);
+		free(v);
+		return -1;
+	}
+	m.count = s->count;
+	m.sum = s->sum;
+	m.mean = s->mean;
+	m.m2 = s->m2;
+	m.min = s->min;
+	m.max = s->max;
+	moments_add(&m, &total);
+	s->count = m.count;
+	s->sum = m.sum;
+	s->mean = m.mean;
+	s->m2 = m.m2;
+	s->min = m.min;
+	s->max = m.max;
+	changed(s);
+	pthread_mutex_unlock(&s->lock);
+	return 0;
+}
+
+void	numset_finish(numset_t *s)
+{
+	pthread_mutex_lock(&s->lock);
+	s->done = true;
+	changed(s);
+	pthread_mutex_unlock(&s->lock);
+}
+
+unsigned long	numset_wait(numset_t *s, unsigned long seen, bool *done)
+{
+	unsigned long	version;
+
+	pthread_mutex_lock(&s->lock);
+	while (s->version == seen && !s->done)
+	{
+		pthread_cond_wait(&s->changed, &s->lock);
+	}
+	version = s->version;
+	*done = s->done;
+	pthread_mutex_unlock(&s->lock);
+	return version;
+}
+
+void	numset_get_stats(numset_t *s, numset_stats_t *stats)
+{
+	pthread_mutex_lock(&s->lock);
+	stats->count = s->count;
+	stats->sum = s->sum;
+	stats->mean = s->mean;
+	stats->variance = (s->count > 1) ? s->m2 / s->count : 0.0;
+	stats->min = s->min;
+	stats->max = s->max;
+	pthread_mutex_unlock(&s->lock);
+}
+
+size_t	numset_copy_sorted(numset_t *s, int *out, size_t max)
+{
+	const int	*src[NUMSET_LEVELS + 1];
+	size_t	n[NUMSET_LEVELS + 1];
+	int	nsrc = 0;
+	size_t	k;
+
+	pthread_mutex_lock(&s->lock);
+	src[nsrc] = s->run;
+	n[nsrc++] = s->n_run;
+	for (int i = 0; i != NUMSET_LEVELS; ++i)
+	{
+		if (s->level[i].n != 0)
+		{
+			src[nsrc] = s->level[i].v;
+			n[nsrc++] = s->level[i].n;
+		}
+	}
+	k = merge_runs(src, n, nsrc, out, max);
+	pthread_mutex_unlock(&s->lock);
+	return k;
+}
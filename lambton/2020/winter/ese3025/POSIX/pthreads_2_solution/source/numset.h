@@ -0,0 +1,104 @@
+/*
+ * numset.h
+ *
+ *	a set of integers that keeps its statistics and its order up to date as
+ *	values are inserted, for threads that read it while another inserts:
+ *		- sum, mean and variance are updated on each insert (Welford), so
+ *		  reading them never walks the set
+ *		- the values are kept sorted: a new value goes, by binary search, into
+ *		  a short sorted run; when that fills up it is merged into a ladder of
+ *		  longer sorted runs, level i holding at most NUMSET_RUN << i values,
+ *		  carrying upwards the way a binary counter does, so an insert costs
+ *		  O(log n), amortised, however many values the set holds
+ *		- bulk loads are sorted in parallel, by several threads, and merged in
+ *		- readers sleep on a condition variable until the set changes, rather
+ *		  than polling it
+ */
+
+#ifndef NUMSET_H_
+#define NUMSET_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#define	NUMSET_RUN		1024 // values inserted between merges
+#define	NUMSET_LEVELS		40 // enough for NUMSET_RUN << 40 values
+#define	NUMSET_MAX_THREADS	16 // for numset_insert_bulk()
+
+/* a snapshot of the statistics */
+struct numset_stats
+{
+	size_t	count;
+	long long	sum;
+	double	mean;
+	double	variance; // population variance, 0 for fewer than 2 values
+	int	min;
+	int	max;
+};
+typedef struct numset_stats numset_stats_t;
+
+/* a sorted run of values, one rung of the ladder */
+struct numset_level
+{
+	int	*v;
+	size_t	n;
+};
+
+struct numset
+{
+	pthread_mutex_t	lock;
+	pthread_cond_t	changed;
+	unsigned long	version; // counts the changes, see numset_wait()
+	bool	done; // no more values to come
+
+	/* running statistics */
+	size_t	count;
+	long long	sum;
+	double	mean;
+	double	m2; // sum of squared deviations from the mean
+	int	min;
+	int	max;
+
+	/* the values: a short sorted run, and the ladder it is merged into */
+	int	run[NUMSET_RUN];
+	size_t	n_run;
+	struct numset_level	level[NUMSET_LEVELS];
+};
+typedef struct numset numset_t;
+
+/*
+ *	functions to set up, and tear down, an empty set
+ */
+int	numset_init(numset_t *s);
+void	numset_destroy(numset_t *s);
+
+/*
+ *	functions to insert one value, or n values; numset_insert_bulk() sorts
+ *	them with up to threads threads first; both return 0, or -1 when out of
+ *	memory (with the set unchanged)
+ */
+int	numset_insert(numset_t *s, int value);
+int	numset_insert_bulk(numset_t *s, const int *values, size_t n, int threads);
+
+/*
+ *	function to tell the readers that no more values are coming
+ */
+void	numset_finish(numset_t *s);
+
+/*
+ *	function for readers: sleeps until the set's version differs from seen,
+ *	or the set is finished, and returns the version; *done tells whether
+ *	the set is finished
+ */
+unsigned long	numset_wait(numset_t *s, unsigned long seen, bool *done);
+
+/*
+ *	functions for readers: a snapshot of the statistics, and a copy of the
+ *	smallest (up to) max values, in order; numset_copy_sorted() returns the
+ *	number copied
+ */
+void	numset_get_stats(numset_t *s, numset_stats_t *stats);
+size_t	numset_copy_sorted(numset_t *s, int *out, size_t max);
+
+#endif /* NUMSET_H_ */
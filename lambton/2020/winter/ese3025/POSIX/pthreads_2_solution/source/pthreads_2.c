@@ -1,152 +1,173 @@
 /*
  * pthreads_2.c
  *
+ *	the user enters integers; one thread displays their average, and another
+ *	the set in order, each time the set changes; the set keeps its statistics
+ *	and its order as the integers go in (numset), so the threads sleep until
+ *	there is something new to display, rather than spinning
+ *
+ *	./pthreads_2 [-b]
+ *		-b reads all the integers first, then loads them at once, sorting
+ *		them with a thread per processor
+ *
  *  Created on: Sep. 16, 2019
  *      Author: takis
  */
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <pthread.h>
 #include <unistd.h>
+#include "numset.h"
 
-#define	MAXINTS		5 // maximum number of integers that user may enter
-
-/*
- * 	global variables
- */
-int	num_ints=0;		// current number of integers entered by user
-int	done=0;			// flag indicating completion of user data entry
-float 	average=0.0;	// global storage for the average
+#define	DISP_MAX	20 // most integers displayed
 
 /*
- *	function to display the set of numbers periodically
+ *	function to display the set of numbers, the smallest DISP_MAX of them
  */
-void	disp_sorted(int *data)
+void	disp_sorted(int *data, size_t n, size_t count)
 {
-	if (num_ints != 0)
+	flockfile(stdout); // keep the line together
+	printf("the current (sorted) integer set is: ");
+	for (size_t i=0; i!=n; ++i)
 	{
-		printf("the current (sorted) integer set is: ");
-		for (int i=0; i!=num_ints; ++i)
-		{
-			printf("%d ", data[i]);
-		}
-		printf("\n");
+		printf("%d ", data[i]);
+	}
+	if (count > n)
+	{
+		printf("... (%zu in all)", count);
 	}
-	return;              	// return the pointer to x
+	printf("\n");
+	funlockfile(stdout);
+	return;
 }
 
 /*
- *	thread function to display the average of the set of numbers periodically
+ *	function to display the average of the set of numbers
  */
-void 	disp_avg(float x)
+void 	disp_avg(const numset_stats_t *x)
 {
-	printf("the current average is: %f\n", x);
+	printf("the current average is: %f (variance %f, min %d, max %d)\n",
+			x->mean, x->variance, x->min, x->max);
 	return;
 }
 
-
 /*
- *	thread function computes average of current set
+ *	thread function displays the average of the set, each time it changes
  */
-void	*avg_thread(void *arr)
+void	*avg_thread(void *arg)
 {
-	int 	*x = (int *) arr; // cast the passed data to integer type
-	int	sum; // storage for the sum
+	numset_t	*set = (numset_t *) arg;
+	numset_stats_t	stats;
+	unsigned long	seen = 0;
+	size_t	shown = 0; // the size of the set last displayed
+	bool	done = false;
 
-	while (done==0)
+	while (!done)
 	{
-		sum=0;
-		// add up the integer set
-		for (int i=0; i!=num_ints; ++i)
+		seen = numset_wait(set, seen, &done); // sleep until there's news
+		numset_get_stats(set, &stats);
+		if (stats.count != shown)
 		{
-			sum += x[i];
-		}
-		// calculate average, if possible
-		if (num_ints !=0)
-		{
-			average = (float) (sum/num_ints);
+			disp_avg(&stats);
+			shown = stats.count;
 		}
 	}
-	return x; // return the set, unchanged
+	return NULL;
 }
 
 /*
- * thread function sorts data set in its current set
+ * thread function displays the set, in order, each time it changes
  */
-void	*bubb_sort_thread(void *arr)
+void	*sort_thread(void *arg)
 {
-	int 	*x = (int *) arr; // cast the passed data to integer type
-	int 	swaps; // a flag indicating if a swap has occurred (if none occur, this set is sorted)
-	int		temp;
-
-	//while (num_ints != MAXINTS)
-	while (done==0)
+	numset_t	*set = (numset_t *) arg;
+	numset_stats_t	stats;
+	int	data[DISP_MAX];
+	unsigned long	seen = 0;
+	size_t	shown = 0; // the size of the set last displayed
+	bool	done = false;
+	size_t	n;
+
+	while (!done)
 	{
-		if (num_ints != 0)
+		seen = numset_wait(set, seen, &done); // sleep until there's news
+		numset_get_stats(set, &stats);
+		if (stats.count != shown)
 		{
-			swaps = 1;
-			while (swaps==1)
-			{
-				swaps = 0; // if a swap occurs, this flag toggled
-				for (int i=0; i!=(num_ints-1); ++i)
-				{
-					if (x[i] > x[i+1]) // elements must be in ascending order, if not ...
-					{	// ... then swap!
-						temp 	= x[i];
-						x[i] 	= x[i+1];
-						x[i+1] 	= temp;
-						swaps  	= 1; // a swap has occurred
-					}
-				}
-			}
+			n = numset_copy_sorted(set, data, DISP_MAX);
+			disp_sorted(data, n, stats.count);
+			shown = stats.count;
 		}
 	}
-	return x; // return the set, sorted
+	return NULL;
 }
 
-int main()
+int main(int argc, char *argv[])
 {
     pthread_t 	thread_calc_1;	// our handle for the averaging thread
     pthread_t	thread_calc_2;	// our handle for the sorting thread
-    int 	set[MAXINTS]; 	// storage for our numbers
-
+    static numset_t	set; 	// storage for our numbers
+    int	bulk = (argc > 1 && strcmp(argv[1], "-b") == 0);
 
-    // initialize set to zero
-    for (int i=0; i != MAXINTS; ++i)
+    if (numset_init(&set) != 0)
     {
-    	set[i]=0;
+    	printf("Failed to initialize the set\n");
+    	return 1;
     }
 
     // create threads
-    if(pthread_create(&thread_calc_1, NULL, &avg_thread, (void *)set)!=0)
+    if(pthread_create(&thread_calc_1, NULL, &avg_thread, (void *)&set)!=0)
     {
     	printf("Failed to create the thread\n");
     	return 1;
     }
 
-    if(pthread_create(&thread_calc_2, NULL, &bubb_sort_thread, (void *)set)!=0)
+    if(pthread_create(&thread_calc_2, NULL, &sort_thread, (void *)&set)!=0)
     {
     	printf("Failed to create the thread\n");
     	return 1;
     }
 
     int 	user_int;
-    printf("Please enter some positive integers... thanks\n");
-    while (num_ints != MAXINTS)
+    int	*ints = NULL;
+    size_t	num_ints = 0, max_ints = 0;
+    printf("Please enter some positive integers, then ctrl-D... thanks\n");
+    while (scanf("%d", &user_int) == 1)
+    {
+    	if (!bulk)
+    	{
+    		if (numset_insert(&set, user_int) != 0)
+    		{
+    			printf("Out of memory\n");
+    			break;
+    		}
+    		continue;
+    	}
+    	if (num_ints == max_ints)
+    	{
+    		max_ints = max_ints ? 2 * max_ints : 1024;
+    		int	*more = realloc(ints, max_ints * sizeof(int));
+    		if (more == NULL)
+    		{
+    			printf("Out of memory\n");
+    			break;
+    		}
+    		ints = more;
+    	}
+    	ints[num_ints++] = user_int;
+    }
+    if (bulk && numset_insert_bulk(&set, ints, num_ints,
+    		(int) sysconf(_SC_NPROCESSORS_ONLN)) != 0)
     {
-    	scanf("%d", &user_int);
-    	set[num_ints]=user_int;
-    	++num_ints;
-    	usleep(2000); // encourage pthreads to run
-    	disp_sorted(set);
-    	disp_avg(average);
-    	printf("num_ints=%d\n",num_ints);
+    	printf("Out of memory\n");
     }
-    done=1; // user has finished entering data
+    free(ints);
+
+    numset_finish(&set); // user has finished entering data
+    pthread_join(thread_calc_1, NULL);
+    pthread_join(thread_calc_2, NULL);
+    numset_destroy(&set);
     return 0;
 }
-
-
-
-
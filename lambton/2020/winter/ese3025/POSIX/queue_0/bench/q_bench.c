@@ -0,0 +1,290 @@
+/*
+ * q_bench.c:
+ *
+ * 		queue benchmark: P producer threads push records through one queue
+ * 		to C consumer threads, for P = C = 1, 2, 4, ... up to the thread
+ * 		count given, one record at a time and in batches; it reports the
+ * 		records per second and the latency from enqueue to dequeue
+ *
+ * 		gcc -std=gnu11 -O2 -Wall -I../headers -o q_bench q_bench.c \
+ * 			../source/queue_lib.c -lpthread
+ *
+ * 		./q_bench [-n records] [-t threads] [-b batch]
+ *
+ * 		each record carries its producer and sequence number in key, which
+ * 		the consumers check for order, and the time it was enqueued in x and
+ * 		y (nanoseconds, low and high words)
+ *
+ *  Created on: Oct. 30, 2019
+ *      Author: takis
+ */
+
+#include <stdlib.h>
+#include "queue_lib.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_THREADS	64
+#define MAX_BATCH	256
+#define SEQ_BITS	24 /* key: producer << SEQ_BITS | sequence number */
+#define BUCKETS		256 /* latency histogram, quarter octaves */
+
+struct bench
+{
+	queue_t *q;
+	size_t records; /* per producer */
+	size_t batch; /* 1: enqueue()/dequeue() */
+	int producers;
+};
+
+struct consumer
+{
+	pthread_t thread;
+	struct bench *b;
+	unsigned long received;
+	unsigned long out_of_order;
+	unsigned long histogram[BUCKETS];
+	uint64_t max_ns;
+};
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+/* quarter-octave bucket of a latency, and the top of a bucket's range */
+static int bucket_of(uint64_t ns)
+{
+	int e = 63 - __builtin_clzll(ns | 1);
+	if (ns < 4)
+	{
+		return (int) ns;
+	}
+	return 4 * (e - 1) + (int) ((ns >> (e - 2)) & 3);
+}
+
+static uint64_t bucket_top(int b)
+{
+	if (b < 4)
+	{
+		return b + 1;
+	}
+	return (uint64_t) (5 + (b & 3)) << (b / 4 - 1);
+}
+
+struct producer
+{
+	pthread_t thread;
+	struct bench *b;
+	unsigned int id;
+};
+
+void	*funcTx(void *pds)
+{
+	struct producer *p = (struct producer *) pds;
+	struct bench *b = p->b;
+	qrec_t recs[MAX_BATCH];
+	size_t sent = 0, n, i;
+
+	while (sent != b->records)
+	{
+		n = b->records - sent < b->batch ? b->records - sent : b->batch;
+		for (i = 0; i != n; ++i)
+		{
+			uint64_t t = now_ns();
+			recs[i].x = (int) (uint32_t) t;
+			recs[i].y = (int) (uint32_t) (t >> 32);
+			recs[i].key = (p->id << SEQ_BITS) | (unsigned int) (sent + i);
+		}
+		if (b->batch == 1)
+		{
+			enqueue(b->q, recs[0]);
+		}
+		else
+		{
+			enqueue_batch(b->q, recs, n);
+		}
+		sent += n;
+	}
+	return NULL;
+}
+
+void	*funcRx(void *pds)
+{
+	struct consumer *c = (struct consumer *) pds;
+	struct bench *b = c->b;
+	qrec_t recs[MAX_BATCH];
+	long last[MAX_THREADS];
+	size_t n, i;
+
+	for (i = 0; i != MAX_THREADS; ++i)
+	{
+		last[i] = -1;
+	}
+	for (;;)
+	{
+		if (b->batch == 1)
+		{
+			n = dequeue(b->q, recs) ? 1 : 0;
+		}
+		else
+		{
+			n = dequeue_batch(b->q, recs, b->batch);
+		}
+		if (n == 0)
+		{
+			break; /* closed and empty */
+		}
+		uint64_t t = now_ns();
+		for (i = 0; i != n; ++i)
+		{
+			uint64_t sent = (uint32_t) recs[i].x
+					| ((uint64_t) (uint32_t) recs[i].y << 32);
+			unsigned int id = recs[i].key >> SEQ_BITS;
+			long seq = recs[i].key & ((1u << SEQ_BITS) - 1);
+
+			/* a consumer sees each producer's records in order */
+			if (seq <= last[id])
+			{
+				c->out_of_order++;
+			}
+			last[id] = seq;
+			c->histogram[bucket_of(t - sent)]++;
+			if (t - sent > c->max_ns)
+			{
+				c->max_ns = t - sent;
+			}
+		}
+		c->received += n;
+	}
+	return NULL;
+}
+
+static uint64_t percentile(const unsigned long *h, unsigned long total, double p)
+{
+	unsigned long want = (unsigned long) (total * p), seen = 0;
+	for (int b = 0; b != BUCKETS; ++b)
+	{
+		seen += h[b];
+		if (seen > want)
+		{
+			return bucket_top(b);
+		}
+	}
+	return bucket_top(BUCKETS - 1);
+}
+
+/*
+ * runs one configuration, returns non-zero if records went missing or out
+ * of order
+ */
+static int run(int threads, size_t records, size_t batch)
+{
+	static queue_t q;
+	static struct producer prod[MAX_THREADS];
+	static struct consumer cons[MAX_THREADS];
+	struct bench b = { &q, records / threads, batch, threads };
+	unsigned long histogram[BUCKETS] = { 0 }, received = 0, disorder = 0;
+	uint64_t max_ns = 0, start, elapsed;
+	char label[32];
+	int i, k;
+
+	queue_init(&q);
+	memset(cons, 0, sizeof(cons));
+	start = now_ns();
+	for (i = 0; i != threads; ++i)
+	{
+		cons[i].b = &b;
+		prod[i].b = &b;
+		prod[i].id = i;
+		if (pthread_create(&cons[i].thread, NULL, &funcRx, &cons[i]) != 0
+				|| pthread_create(&prod[i].thread, NULL, &funcTx, &prod[i]) != 0)
+		{
+			printf("Failed to create the thread\n");
+			exit(1);
+		}
+	}
+	for (i = 0; i != threads; ++i)
+	{
+		pthread_join(prod[i].thread, NULL);
+	}
+	queue_close(&q);
+	for (i = 0; i != threads; ++i)
+	{
+		pthread_join(cons[i].thread, NULL);
+		received += cons[i].received;
+		disorder += cons[i].out_of_order;
+		for (k = 0; k != BUCKETS; ++k)
+		{
+			histogram[k] += cons[i].histogram[k];
+		}
+		if (cons[i].max_ns > max_ns)
+		{
+			max_ns = cons[i].max_ns;
+		}
+	}
+	elapsed = now_ns() - start;
+	queue_destroy(&q);
+
+	snprintf(label, sizeof(label), "%dP/%dC", threads, threads);
+	printf("%-9s %6zu %10.2f %10llu %10llu %12llu",
+			label, batch, received * 1e3 / elapsed,
+			(unsigned long long) percentile(histogram, received, 0.5),
+			(unsigned long long) percentile(histogram, received, 0.99),
+			(unsigned long long) max_ns);
+	if (received != b.records * threads || disorder != 0)
+	{
+		printf("  FAILED: %lu of %zu received, %lu out of order",
+				received, b.records * threads, disorder);
+	}
+	printf("\n");
+	return received != b.records * threads || disorder != 0;
+}
+
+int main(int argc, char *argv[])
+{
+	size_t records = 4000000, batch = 32;
+	int max_threads = 4, opt, failed = 0;
+
+	while ((opt = getopt(argc, argv, "n:t:b:")) != -1)
+	{
+		switch (opt)
+		{
+		case 'n':
+			records = strtoul(optarg, NULL, 0);
+			break;
+		case 't':
+			max_threads = atoi(optarg);
+			break;
+		case 'b':
+			batch = strtoul(optarg, NULL, 0);
+			break;
+		default:
+			printf("usage: %s [-n records] [-t threads] [-b batch]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (max_threads < 1 || max_threads > MAX_THREADS || batch < 2
+			|| batch > MAX_BATCH || records / max_threads >= (1u << SEQ_BITS))
+	{
+		printf("need 1 to %d threads, a batch of 2 to %d, and fewer than %u"
+				" records per thread\n", MAX_THREADS, MAX_BATCH, 1u << SEQ_BITS);
+		return 2;
+	}
+
+	printf("queue of %d cells, %zu records a run\n", Lq, records);
+	printf("%-9s %6s %10s %10s %10s %12s\n", "threads", "batch", "Mrec/s",
+			"p50 ns", "p99 ns", "max ns");
+	for (int t = 1; t <= max_threads; t *= 2)
+	{
+		failed |= run(t, records, 1);
+		failed |= run(t, records, batch);
+	}
+	return failed;
+}
@@ -8,8 +8,16 @@
 #define HEADERS_QUEUE_LIB_H_
 
 #include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
 
-#define Lq	1024 /* maximum number of queue elements */
+#define Lq	1024 /* maximum number of queue elements, a power of 2 */
+#define Lq_CACHE_LINE	64 /* keeps the producers' and consumers' counters apart */
+
+#if (Lq & (Lq - 1)) != 0
+#error "Lq must be a power of 2"
+#endif
 
 struct q_rec
 {
@@ -19,11 +27,39 @@ struct q_rec
 };
 typedef struct q_rec qrec_t;
 
+/*
+ * each cell carries a sequence number, telling whose turn it is:
+ * 		- seq == i: free, for the producer enqueuing element i
+ * 		- seq == i + 1: holds element i, for the consumer dequeuing it
+ * 		- and, once element i has been dequeued, seq == i + Lq: free again,
+ * 		  for the producer of element i + Lq, one lap later
+ */
+struct q_cell
+{
+	atomic_size_t seq;
+	qrec_t rec;
+};
+typedef struct q_cell qcell_t;
+
+/*
+ * a bounded queue for any number of producer and consumer threads: the
+ * try_ functions never block and never take a lock, the others sleep on a
+ * condition variable while the queue is full (or empty), and the lock is
+ * only touched when some thread is asleep
+ */
 struct q_struct
 {
-	size_t head;
-	size_t tail;
-	qrec_t data[Lq];
+	_Alignas(Lq_CACHE_LINE) atomic_size_t head; /* next element to dequeue */
+	_Alignas(Lq_CACHE_LINE) atomic_size_t tail; /* next element to enqueue */
+	_Alignas(Lq_CACHE_LINE) qcell_t data[Lq];
+
+	/* blocking */
+	pthread_mutex_t lock;
+	pthread_cond_t not_empty;
+	pthread_cond_t not_full;
+	atomic_uint waiting_consumers;
+	atomic_uint waiting_producers;
+	atomic_bool closed;
 };
 typedef struct q_struct queue_t;
 
@@ -31,24 +67,70 @@ typedef struct q_struct queue_t;
 /* queuing functions */
 /*********************/
 
+/*
+ *
+ * queue_init(pq):
+ * 		- makes the queue, q, empty and open (pq is pointer to q)
+ * queue_destroy(pq):
+ * 		- releases what queue_init() set up; no thread may be using q
+ *
+ */
+void queue_init(queue_t *);
+void queue_destroy(queue_t *);
+
+/*
+ *
+ * queue_close(pq):
+ * 		- no more data will be enqueued: blocked producers give up, and
+ * 		  blocked consumers give up once the queue is empty
+ *
+ */
+void queue_close(queue_t *);
+
+/*
+ *
+ * try_enqueue(pq, d), try_dequeue(pq, pd):
+ * 		- add data, d, at q.tail, or retrieve the data at q.head into *pd
+ * 		- return false, at once, if the queue is full (or empty)
+ *
+ */
+bool try_enqueue(queue_t *, qrec_t);
+bool try_dequeue(queue_t *, qrec_t *);
+
 /*
  *
  * enqueue(pq, d):
  * 		- adds new data, d, to queue, q, at q.tail (pq is pointer to q)
- * 		- updates q.tail
+ * 		- waits while the queue is full
+ * 		- returns false, with d not enqueued, if the queue has been closed
  *
  */
-void enqueue(queue_t *, qrec_t );
+bool enqueue(queue_t *, qrec_t);
 
 /*
  *
- * d* = dequeue(pq):
- * 		- retrieves new data, d, from queue, q, at q.head  (pq is pointer to q)
- * 		- updates q.head
- * 		- for efficiency, returns a pointer to d
+ * dequeue(pq, pd):
+ * 		- retrieves data, d, from queue, q, at q.head into *pd
+ * 		- waits while the queue is empty
+ * 		- returns false once the queue is closed and empty
  *
  */
-qrec_t* dequeue(queue_t *);
+bool dequeue(queue_t *, qrec_t *);
 
-#endif /* HEADERS_QUEUE_LIB_H_ */
+/*
+ *
+ * n* = enqueue_batch(pq, d, n), n* = dequeue_batch(pq, d, n):
+ * 		- add the n records at d, or retrieve up to n records into d, taking
+ * 		  as many cells as are ready at once, for a single update of
+ * 		  q.tail (or q.head)
+ * 		- enqueue_batch() waits until all n are enqueued, dequeue_batch()
+ * 		  until at least one is dequeued
+ * 		- return the number of records moved, short of n only if the
+ * 		  queue has been closed (or, for dequeue_batch(), if fewer were
+ * 		  ready)
+ *
+ */
+size_t enqueue_batch(queue_t *, const qrec_t *, size_t);
+size_t dequeue_batch(queue_t *, qrec_t *, size_t);
 
+#endif /* HEADERS_QUEUE_LIB_H_ */
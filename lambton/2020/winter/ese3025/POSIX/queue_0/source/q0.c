@@ -38,10 +38,10 @@ void	*funcTx(void *pds)
 		newrec.key = key;
 		key = (++xpos)*(++ypos);
 
-		/* enqueue this record */
+		/* enqueue this record, waiting for room if the queue is full */
 		enqueue(q, newrec);
 
-		/* delay a bit to let dequeueing happen without overflowing */
+		/* delay a bit, to vary the pace */
 		delay = rand() % 32;
 		usleep(delay);
 
@@ -62,18 +62,18 @@ void	*funcRx(void *pds)
 	queue_t *q = (queue_t *) pds;
 
 	/* storage for the retrieved record */
-	qrec_t 	*pnewrec;
+	qrec_t 	newrec;
 
 	int delay;
 
 	unsigned long i=0;
-	while (i != Lq/2)
+	/* dequeue() waits while the queue is empty, and fails once it is closed */
+	while (dequeue(q, &newrec))
 	{
-		if ( (q->head) != (q->tail) ) /* simple check to ensure that an underflow won't happen */
+		/* check the contrived data */
+		if (newrec.key != (unsigned int) (newrec.x*newrec.y))
 		{
-			/* storage for retrieved record */
-			pnewrec = dequeue(q);
-
+			printf("record %lu is corrupt\n", i);
 		}
 		/* delay a bit to allow queue to build up somewhat */
 		delay=rand() % 64;
@@ -83,6 +83,7 @@ void	*funcRx(void *pds)
 		++i;
 	}
 
+	printf("received %lu records\n", i);
 	return q; // return the set, unchanged
 }
 
@@ -93,9 +94,8 @@ int main()
     pthread_t	thread_receiver;	// our handle for the sorting thread
 
     /* define and initialize main queue, qm */
-    queue_t qm;
-    qm.head = 0;
-    qm.tail = 0;
+    static queue_t qm;
+    queue_init(&qm);
     queue_t *pqm = &qm;
 
     /* create threads */
@@ -110,16 +110,15 @@ int main()
     	return 1;
     }
 
-    /* allow threads to complete */
-    //void *result;
-    //pthread_join(thread_sender, &result);
-    // pthread_join(thread_receiver, &result);
-    usleep(20000); // give some time to run
-    pthread_cancel(thread_sender);
-    pthread_cancel(thread_receiver);
+    /* allow threads to complete: the receiver stops once the sender is done */
+    pthread_join(thread_sender, NULL);
+    queue_close(pqm);
+    pthread_join(thread_receiver, NULL);
 
     /* print results */
-    printf("final state of the queue: q.head=%zu and q.tail=%zu\n",qm.head,qm.tail);
+    printf("final state of the queue: q.head=%zu and q.tail=%zu\n",
+	    atomic_load(&qm.head), atomic_load(&qm.tail));
+    queue_destroy(pqm);
 
     return 0;
 }
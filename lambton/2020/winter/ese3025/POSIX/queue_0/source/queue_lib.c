@@ -8,67 +8,248 @@
 #include <stdlib.h>
 #include "queue_lib.h"
 
+#define Lq_MASK	(Lq - 1)
+
 /*********************/
-/* queuing functions */
+/* private functions */
 /*********************/
 
 /*
- *
- * enqueue(pq, d):
- * 		- adds new data, d, to queue, q, at q.tail (pq is pointer to q)
- * 		- updates q.tail
- *
+ * claims up to n consecutive cells, starting at the counter *pcount, whose
+ * sequence numbers say they are ready (seq == count + ahead), with a single
+ * update of the counter; returns the number claimed, and the first of them
+ * in *pfirst
  */
-void enqueue(queue_t *pq, qrec_t d)
+static size_t claim(queue_t *pq, atomic_size_t *pcount, size_t ahead,
+		size_t n, size_t *pfirst)
 {
-	/* write the new record at the tail location */
-	size_t i_new = pq->tail; /* index for new record in the array */
-	(pq->data)[i_new].x = d.x;
-	(pq->data)[i_new].y = d.y;
-	(pq->data)[i_new].key = d.key;
+	size_t pos = atomic_load_explicit(pcount, memory_order_relaxed);
+	size_t m, seq;
 
-	/* update the tail pointer */
-	if (i_new == Lq)
+	for (;;)
 	{
-		pq->tail = 1;
+		/* count the ready cells from pos on */
+		for (m = 0; m != n; ++m)
+		{
+			seq = atomic_load_explicit(&(pq->data)[(pos + m) & Lq_MASK].seq,
+					memory_order_acquire);
+			if (seq != pos + m + ahead)
+			{
+				break;
+			}
+		}
+		if (m == 0)
+		{
+			/* full (or empty), unless another thread has moved on */
+			size_t now = atomic_load_explicit(pcount, memory_order_relaxed);
+			if (now == pos)
+			{
+				return 0;
+			}
+			pos = now;
+			continue;
+		}
+		/* take them, unless another thread took some first */
+		if (atomic_compare_exchange_weak_explicit(pcount, &pos, pos + m,
+				memory_order_relaxed, memory_order_relaxed))
+		{
+			*pfirst = pos;
+			return m;
+		}
 	}
-	else
+}
+
+static size_t try_enqueue_some(queue_t *pq, const qrec_t *d, size_t n)
+{
+	size_t first;
+	size_t m = claim(pq, &pq->tail, 0, n, &first);
+
+	for (size_t i = 0; i != m; ++i)
 	{
-		++(pq->tail);
+		qcell_t *c = &(pq->data)[(first + i) & Lq_MASK];
+		c->rec = d[i];
+		atomic_store_explicit(&c->seq, first + i + 1, memory_order_release);
 	}
+	return m;
+}
 
-	/* finish */
-	return;
+static size_t try_dequeue_some(queue_t *pq, qrec_t *d, size_t n)
+{
+	size_t first;
+	size_t m = claim(pq, &pq->head, 1, n, &first);
+
+	for (size_t i = 0; i != m; ++i)
+	{
+		qcell_t *c = &(pq->data)[(first + i) & Lq_MASK];
+		d[i] = c->rec;
+		atomic_store_explicit(&c->seq, first + i + Lq, memory_order_release);
+	}
+	return m;
 }
 
 /*
- *
- * d* = dequeue(pq):
- * 		- retrieves new data, d, from queue, q, at q.head  (pq is pointer to q)
- * 		- updates q.head
- * 		- for efficiency, returns a pointer to d
- *
+ * wakes the threads waiting on cond, if any: the fence pairs with the one in
+ * wait_for(), so that either this thread sees the waiter, or the waiter sees
+ * what this thread has just done
+ */
+static void wake(queue_t *pq, atomic_uint *pwaiting, pthread_cond_t *cond,
+		bool all)
+{
+	atomic_thread_fence(memory_order_seq_cst);
+	if (atomic_load_explicit(pwaiting, memory_order_relaxed) != 0)
+	{
+		pthread_mutex_lock(&pq->lock);
+		if (all)
+		{
+			pthread_cond_broadcast(cond);
+		}
+		else
+		{
+			pthread_cond_signal(cond);
+		}
+		pthread_mutex_unlock(&pq->lock);
+	}
+}
+
+/*
+ * sleeps on cond until ready(pq) holds or the queue is closed; returns
+ * false if it was closed
  */
-qrec_t* dequeue(queue_t *pq)
+static bool wait_for(queue_t *pq, atomic_uint *pwaiting, pthread_cond_t *cond,
+		bool (*ready)(queue_t *))
 {
-    /* allocate memory from heap to store retrieved record */
-    qrec_t *d = malloc(sizeof(qrec_t));
-    size_t i_old = pq->head; /* index to old record at the head */
+	bool open = true;
 
-    /* retrieve the data at the head */
-    d->x = (pq->data)[i_old].x;
-    d->y = (pq->data)[i_old].y;
-    d->key = (pq->data)[i_old].key;
+	pthread_mutex_lock(&pq->lock);
+	atomic_fetch_add(pwaiting, 1);
+	atomic_thread_fence(memory_order_seq_cst);
+	while (!ready(pq) && (open = !atomic_load(&pq->closed)))
+	{
+		pthread_cond_wait(cond, &pq->lock);
+	}
+	atomic_fetch_sub(pwaiting, 1);
+	pthread_mutex_unlock(&pq->lock);
+	return open || ready(pq);
+}
+
+static bool has_room(queue_t *pq)
+{
+	size_t pos = atomic_load(&pq->tail);
+	return atomic_load(&(pq->data)[pos & Lq_MASK].seq) == pos;
+}
 
-    /* update head pointer */
-    if (i_old == Lq)
-    {
-	pq->head = 1;
-    }
-    else
-    {
-	++(pq->head);
-    }
-    return d;
+static bool has_data(queue_t *pq)
+{
+	size_t pos = atomic_load(&pq->head);
+	return atomic_load(&(pq->data)[pos & Lq_MASK].seq) == pos + 1;
 }
 
+/*********************/
+/* queuing functions */
+/*********************/
+
+void queue_init(queue_t *pq)
+{
+	atomic_init(&pq->head, 0);
+	atomic_init(&pq->tail, 0);
+	for (size_t i = 0; i != Lq; ++i)
+	{
+		atomic_init(&(pq->data)[i].seq, i);
+	}
+	pthread_mutex_init(&pq->lock, NULL);
+	pthread_cond_init(&pq->not_empty, NULL);
+	pthread_cond_init(&pq->not_full, NULL);
+	atomic_init(&pq->waiting_consumers, 0);
+	atomic_init(&pq->waiting_producers, 0);
+	atomic_init(&pq->closed, false);
+}
+
+void queue_destroy(queue_t *pq)
+{
+	pthread_cond_destroy(&pq->not_full);
+	pthread_cond_destroy(&pq->not_empty);
+	pthread_mutex_destroy(&pq->lock);
+}
+
+void queue_close(queue_t *pq)
+{
+	pthread_mutex_lock(&pq->lock);
+	atomic_store(&pq->closed, true);
+	pthread_cond_broadcast(&pq->not_empty);
+	pthread_cond_broadcast(&pq->not_full);
+	pthread_mutex_unlock(&pq->lock);
+}
+
+bool try_enqueue(queue_t *pq, qrec_t d)
+{
+	if (try_enqueue_some(pq, &d, 1) == 0)
+	{
+		return false;
+	}
+	wake(pq, &pq->waiting_consumers, &pq->not_empty, false);
+	return true;
+}
+
+bool try_dequeue(queue_t *pq, qrec_t *pd)
+{
+	if (try_dequeue_some(pq, pd, 1) == 0)
+	{
+		return false;
+	}
+	wake(pq, &pq->waiting_producers, &pq->not_full, false);
+	return true;
+}
+
+bool enqueue(queue_t *pq, qrec_t d)
+{
+	return enqueue_batch(pq, &d, 1) == 1;
+}
+
+bool dequeue(queue_t *pq, qrec_t *pd)
+{
+	return dequeue_batch(pq, pd, 1) == 1;
+}
+
+size_t enqueue_batch(queue_t *pq, const qrec_t *d, size_t n)
+{
+	size_t done = 0, m;
+
+	while (done != n)
+	{
+		if (atomic_load_explicit(&pq->closed, memory_order_relaxed))
+		{
+			break;
+		}
+		m = try_enqueue_some(pq, d + done, n - done);
+		if (m != 0)
+		{
+			done += m;
+			wake(pq, &pq->waiting_consumers, &pq->not_empty, m > 1);
+		}
+		else if (!wait_for(pq, &pq->waiting_producers, &pq->not_full, has_room))
+		{
+			break;
+		}
+	}
+	return done;
+}
+
+size_t dequeue_batch(queue_t *pq, qrec_t *d, size_t n)
+{
+	size_t m = 0;
+
+	while (n != 0)
+	{
+		m = try_dequeue_some(pq, d, n);
+		if (m != 0)
+		{
+			wake(pq, &pq->waiting_producers, &pq->not_full, m > 1);
+			break;
+		}
+		if (!wait_for(pq, &pq->waiting_consumers, &pq->not_empty, has_data))
+		{
+			break;
+		}
+	}
+	return m;
+}
@@ -0,0 +1,57 @@
+/*
+ * Statistics of the slab + TLSF heap (heap_slab.c).
+ *
+ * heap_slab.c replaces heap_3.c.  Small requests are served from per size
+ * class slabs, everything else from a two level segregated fit (TLSF)
+ * allocator that coalesces free neighbours.  Both paths take constant time.
+ */
+
+#ifndef HEAP_SLAB_H
+#define HEAP_SLAB_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Number of slab size classes, see uxHeapSlabClassSize[] in heap_slab.c. */
+#define heapSLAB_NUM_CLASSES		8
+
+typedef struct xSLAB_CLASS_STATS
+{
+	size_t xObjectSize;				/* Bytes handed out per object. */
+	size_t xPages;					/* Slab pages owned by the class. */
+	size_t xObjectsInUse;			/* Objects allocated now. */
+	size_t xMaxObjectsInUse;		/* High-water mark of xObjectsInUse. */
+	size_t xAllocations;			/* Allocations served by the class. */
+	size_t xFallbacks;				/* Requests sent to TLSF because no page was free. */
+} xSlabClassStats;
+
+typedef struct xHEAP_STATS
+{
+	size_t xTotalBytes;				/* Size of the heap area. */
+	size_t xFreeBytes;				/* Free TLSF payload plus free slab pages and objects. */
+	size_t xMinimumEverFreeBytes;	/* Low-water mark of xFreeBytes. */
+	size_t xLargestFreeBlock;		/* Largest single TLSF allocation possible now. */
+	size_t xFreeBlocks;				/* Free TLSF blocks. */
+	size_t xFreeSlabPages;			/* Slab pages not given to any class. */
+	unsigned long ulFragmentation;	/* 100 * ( 1 - largest / free TLSF bytes ). */
+} xHeapStats;
+
+/* Fill in *pxStats.  Takes time proportional to the number of free blocks in
+the largest occupied TLSF bin, call it for reporting only. */
+void vPortGetHeapStats( xHeapStats *pxStats );
+
+/* Statistics of slab class uxClass, 0 .. heapSLAB_NUM_CLASSES - 1.  Returns
+pdFALSE for an invalid class. */
+long xPortGetSlabClassStats( unsigned long uxClass, xSlabClassStats *pxStats );
+
+/* Low-water mark of xPortGetFreeHeapSize(). */
+size_t xPortGetMinimumEverFreeHeapSize( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HEAP_SLAB_H */
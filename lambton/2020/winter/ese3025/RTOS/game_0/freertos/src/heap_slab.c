@@ -0,0 +1,653 @@
+/*
+ * Implementation of pvPortMalloc() and vPortFree() for FreeRTOS with size
+ * class slabs in front of a two level segregated fit (TLSF) allocator.
+ *
+ * The heap is one static array of configTOTAL_HEAP_SIZE bytes.  The first
+ * configSLAB_HEAP_SIZE bytes are cut into pages of heapSLAB_PAGE_SIZE bytes.
+ * A page is given to one size class at a time and holds objects of that
+ * size only, so requests up to the largest class (go_t, go_list_t, list
+ * nodes, semaphores) cost a free list pop and leave no
+ * holes behind.  A page goes back to the page pool when its last object is
+ * freed.
+ *
+ * The rest of the heap is managed with TLSF: free blocks sit in segregated
+ * lists indexed by a first level (power of two) and a second level (eight
+ * linear steps within it), with a bitmap for each level.  Finding a fit is a
+ * couple of bit scans, and freed blocks are merged with free physical
+ * neighbours immediately.  Task stacks, TCBs, queue storage and small
+ * requests that found no slab page come from here.
+ *
+ * Both paths take constant time.  As in heap_3.c the scheduler is suspended
+ * while the heap is changed, so the functions must not be called from an
+ * interrupt.
+ *
+ * The file builds on a workstation as well, where the heap is placed in
+ * ordinary .bss: host/heap_bench.c runs it under a stub scheduler, times it
+ * against heap_3.c and stress tests it.
+ *
+ * See heap_3.c in the other FreeRTOS projects for the malloc() wrapper this
+ * replaces, and heap_slab.h for the statistics calls.
+ */
+
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "heap_slab.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* Bytes of the heap reserved for slab pages. */
+#ifndef configSLAB_HEAP_SIZE
+	#define configSLAB_HEAP_SIZE	( configTOTAL_HEAP_SIZE / 4 )
+#endif
+
+/* Memory section of the heap array.  On the LPC1769 the 32K AHB SRAM (RAM2)
+is otherwise unused by the game, which leaves the main RAM to .data, .bss
+and the newlib heap. */
+#ifndef configHEAP_SECTION
+	#ifdef __CODE_RED
+		#define configHEAP_SECTION	__attribute__ ( ( section( ".bss.$RAM2" ) ) )
+	#else
+		#define configHEAP_SECTION
+	#endif
+#endif
+
+#define heapSLAB_PAGE_SIZE		512
+#define heapSLAB_MAX_SIZE		( ( size_t ) 128 )
+#define heapSLAB_NUM_PAGES		( configSLAB_HEAP_SIZE / heapSLAB_PAGE_SIZE )
+
+/* The TLSF area needs room for one block header, the smallest payload and the
+header of the sentinel that ends the heap, 16 bytes each at most, plus what
+aligning the end of the heap may cut off. */
+#define heapTLSF_MIN_AREA		( 3 * 16 + portBYTE_ALIGNMENT )
+
+#if ( configTOTAL_HEAP_SIZE ) < ( heapSLAB_NUM_PAGES * heapSLAB_PAGE_SIZE + heapTLSF_MIN_AREA )
+	#error configTOTAL_HEAP_SIZE is too small for configSLAB_HEAP_SIZE and one TLSF block
+#endif
+
+/* TLSF geometry.  Block sizes are multiples of portBYTE_ALIGNMENT, the second
+level splits every power of two into 2^heapSL_INDEX_COUNT_LOG2 lists. */
+#define heapSL_INDEX_COUNT_LOG2	3
+#define heapSL_INDEX_COUNT		( 1UL << heapSL_INDEX_COUNT_LOG2 )
+#define heapALIGN_SIZE_LOG2		3
+#define heapFL_INDEX_SHIFT		( heapSL_INDEX_COUNT_LOG2 + heapALIGN_SIZE_LOG2 )
+#define heapFL_INDEX_MAX		24
+#define heapFL_INDEX_COUNT		( heapFL_INDEX_MAX - heapFL_INDEX_SHIFT + 1 )
+#define heapSMALL_BLOCK_SIZE	( ( size_t ) 1 << heapFL_INDEX_SHIFT )
+
+/* Flags kept in the low bits of xSize. */
+#define heapBLOCK_FREE			( ( size_t ) 1 )
+#define heapBLOCK_PREV_FREE		( ( size_t ) 2 )
+#define heapBLOCK_SIZE_MASK		( ~( size_t ) ( portBYTE_ALIGNMENT - 1 ) )
+
+/* Every TLSF block starts with this header.  pxPrevPhys is only valid when
+heapBLOCK_PREV_FREE is set; pxNextFree and pxPrevFree overlay the payload of
+free blocks. */
+typedef struct xTLSF_BLOCK
+{
+	struct xTLSF_BLOCK *pxPrevPhys;
+	size_t xSize;
+	struct xTLSF_BLOCK *pxNextFree;
+	struct xTLSF_BLOCK *pxPrevFree;
+} xTLSFBlock;
+
+#define heapBLOCK_HEADER_SIZE	( ( sizeof( struct xTLSF_BLOCK * ) + sizeof( size_t ) + portBYTE_ALIGNMENT - 1 ) & heapBLOCK_SIZE_MASK )
+#define heapBLOCK_MIN_SIZE		( ( 2 * sizeof( struct xTLSF_BLOCK * ) + portBYTE_ALIGNMENT - 1 ) & heapBLOCK_SIZE_MASK )
+
+/* A slab page in use by a class is on the partial list of the class while it
+has free objects.  Free objects are linked through their first word; objects
+past usCarved have never been handed out. */
+typedef struct xSLAB_PAGE
+{
+	struct xSLAB_PAGE *pxNext;
+	struct xSLAB_PAGE *pxPrev;
+	void *pvFreeList;
+	unsigned short usInUse;
+	unsigned short usCarved;
+	unsigned char ucClass;
+} xSlabPage;
+
+typedef struct xSLAB_CLASS
+{
+	xSlabPage *pxPartial;
+	size_t xObjects;					/* Objects that fit in one page. */
+	xSlabClassStats xStats;
+} xSlabClass;
+
+/* Object sizes of the slab classes, multiples of portBYTE_ALIGNMENT. */
+static const unsigned short uxHeapSlabClassSize[ heapSLAB_NUM_CLASSES ] = { 8, 16, 24, 32, 48, 64, 96, 128 };
+
+/* Slab pages are aligned to their size, so that the page of an object is
+found by division. */
+static unsigned char ucHeap[ configTOTAL_HEAP_SIZE ] configHEAP_SECTION __attribute__ ( ( aligned( 512 ) ) );
+
+static unsigned char *pucSlabStart = NULL, *pucSlabEnd = NULL;
+static xSlabPage xSlabPages[ heapSLAB_NUM_PAGES ];
+static xSlabPage *pxFreePages = NULL;
+static size_t xFreePageCount = 0;
+static xSlabClass xSlabClasses[ heapSLAB_NUM_CLASSES ];
+
+/* Size class of each request size in portBYTE_ALIGNMENT steps. */
+static unsigned char ucSizeToClass[ ( heapSLAB_MAX_SIZE / portBYTE_ALIGNMENT ) + 1 ];
+
+static unsigned long ulFLBitmap = 0;
+static unsigned long ulSLBitmap[ heapFL_INDEX_COUNT ];
+static xTLSFBlock *pxFreeBlocks[ heapFL_INDEX_COUNT ][ heapSL_INDEX_COUNT ];
+
+static size_t xHeapTotal = 0, xTLSFFree = 0, xSlabFree = 0, xMinimumEverFree = 0;
+static size_t xFreeBlockCount = 0;
+
+/*-----------------------------------------------------------*/
+
+static int prvFLS( size_t xWord )
+{
+	/* Index of the highest bit set, xWord must not be zero. */
+	return ( int ) ( sizeof( unsigned long ) * 8 - 1 ) - __builtin_clzl( ( unsigned long ) xWord );
+}
+/*-----------------------------------------------------------*/
+
+static int prvFFS( unsigned long ulWord )
+{
+	/* Index of the lowest bit set, ulWord must not be zero. */
+	return __builtin_ctzl( ulWord );
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvBlockSize( const xTLSFBlock *pxBlock )
+{
+	return pxBlock->xSize & heapBLOCK_SIZE_MASK;
+}
+/*-----------------------------------------------------------*/
+
+static xTLSFBlock *prvNextPhys( const xTLSFBlock *pxBlock )
+{
+	return ( xTLSFBlock * ) ( ( unsigned char * ) pxBlock + heapBLOCK_HEADER_SIZE + prvBlockSize( pxBlock ) );
+}
+/*-----------------------------------------------------------*/
+
+static void prvMappingInsert( size_t xSize, int *piFL, int *piSL )
+{
+int iFL, iSL;
+
+	if( xSize < heapSMALL_BLOCK_SIZE )
+	{
+		iFL = 0;
+		iSL = ( int ) ( xSize / ( heapSMALL_BLOCK_SIZE / heapSL_INDEX_COUNT ) );
+	}
+	else
+	{
+		iFL = prvFLS( xSize );
+		iSL = ( int ) ( xSize >> ( iFL - heapSL_INDEX_COUNT_LOG2 ) ) ^ ( 1 << heapSL_INDEX_COUNT_LOG2 );
+		iFL -= ( heapFL_INDEX_SHIFT - 1 );
+	}
+	*piFL = iFL;
+	*piSL = iSL;
+}
+/*-----------------------------------------------------------*/
+
+static void prvInsertFree( xTLSFBlock *pxBlock )
+{
+int iFL, iSL;
+xTLSFBlock *pxNext;
+
+	prvMappingInsert( prvBlockSize( pxBlock ), &iFL, &iSL );
+	pxBlock->pxPrevFree = NULL;
+	pxBlock->pxNextFree = pxFreeBlocks[ iFL ][ iSL ];
+	if( pxBlock->pxNextFree != NULL )
+	{
+		pxBlock->pxNextFree->pxPrevFree = pxBlock;
+	}
+	pxFreeBlocks[ iFL ][ iSL ] = pxBlock;
+	ulFLBitmap |= 1UL << iFL;
+	ulSLBitmap[ iFL ] |= 1UL << iSL;
+
+	/* Tell the physical neighbour where this free block starts. */
+	pxBlock->xSize |= heapBLOCK_FREE;
+	pxNext = prvNextPhys( pxBlock );
+	pxNext->pxPrevPhys = pxBlock;
+	pxNext->xSize |= heapBLOCK_PREV_FREE;
+
+	xTLSFFree += prvBlockSize( pxBlock );
+	xFreeBlockCount++;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRemoveFree( xTLSFBlock *pxBlock )
+{
+int iFL, iSL;
+
+	prvMappingInsert( prvBlockSize( pxBlock ), &iFL, &iSL );
+	if( pxBlock->pxNextFree != NULL )
+	{
+		pxBlock->pxNextFree->pxPrevFree = pxBlock->pxPrevFree;
+	}
+	if( pxBlock->pxPrevFree != NULL )
+	{
+		pxBlock->pxPrevFree->pxNextFree = pxBlock->pxNextFree;
+	}
+	else
+	{
+		pxFreeBlocks[ iFL ][ iSL ] = pxBlock->pxNextFree;
+		if( pxFreeBlocks[ iFL ][ iSL ] == NULL )
+		{
+			ulSLBitmap[ iFL ] &= ~( 1UL << iSL );
+			if( ulSLBitmap[ iFL ] == 0 )
+			{
+				ulFLBitmap &= ~( 1UL << iFL );
+			}
+		}
+	}
+
+	pxBlock->xSize &= ~heapBLOCK_FREE;
+	prvNextPhys( pxBlock )->xSize &= ~heapBLOCK_PREV_FREE;
+
+	xTLSFFree -= prvBlockSize( pxBlock );
+	xFreeBlockCount--;
+}
+/*-----------------------------------------------------------*/
+
+static xTLSFBlock *prvFindFree( size_t xSize )
+{
+int iFL, iSL;
+unsigned long ulMap;
+
+	/* Round up to the next list boundary so that any block of the list found
+	fits, which is what makes the search constant time. */
+	if( xSize >= heapSMALL_BLOCK_SIZE )
+	{
+		xSize += ( ( size_t ) 1 << ( prvFLS( xSize ) - heapSL_INDEX_COUNT_LOG2 ) ) - 1;
+	}
+	prvMappingInsert( xSize, &iFL, &iSL );
+	if( iFL >= heapFL_INDEX_COUNT )
+	{
+		return NULL;
+	}
+
+	ulMap = ulSLBitmap[ iFL ] & ( ~0UL << iSL );
+	if( ulMap == 0 )
+	{
+		ulMap = ( iFL + 1 < heapFL_INDEX_COUNT ) ? ( ulFLBitmap & ( ~0UL << ( iFL + 1 ) ) ) : 0;
+		if( ulMap == 0 )
+		{
+			return NULL;
+		}
+		iFL = prvFFS( ulMap );
+		ulMap = ulSLBitmap[ iFL ];
+	}
+	iSL = prvFFS( ulMap );
+	return pxFreeBlocks[ iFL ][ iSL ];
+}
+/*-----------------------------------------------------------*/
+
+static void *prvTLSFMalloc( size_t xWantedSize )
+{
+xTLSFBlock *pxBlock, *pxRest;
+size_t xSize, xBlockSize;
+
+	xSize = ( xWantedSize + portBYTE_ALIGNMENT - 1 ) & heapBLOCK_SIZE_MASK;
+	if( xSize < heapBLOCK_MIN_SIZE )
+	{
+		xSize = heapBLOCK_MIN_SIZE;
+	}
+	if( xSize < xWantedSize )
+	{
+		return NULL;
+	}
+
+	pxBlock = prvFindFree( xSize );
+	if( pxBlock == NULL )
+	{
+		return NULL;
+	}
+	prvRemoveFree( pxBlock );
+
+	/* Give the tail back when it is large enough to be a block. */
+	xBlockSize = prvBlockSize( pxBlock );
+	if( xBlockSize >= xSize + heapBLOCK_HEADER_SIZE + heapBLOCK_MIN_SIZE )
+	{
+		pxRest = ( xTLSFBlock * ) ( ( unsigned char * ) pxBlock + heapBLOCK_HEADER_SIZE + xSize );
+		pxRest->xSize = xBlockSize - xSize - heapBLOCK_HEADER_SIZE;
+		pxBlock->xSize = xSize | ( pxBlock->xSize & heapBLOCK_PREV_FREE );
+		prvInsertFree( pxRest );
+	}
+
+	return ( unsigned char * ) pxBlock + heapBLOCK_HEADER_SIZE;
+}
+/*-----------------------------------------------------------*/
+
+static void prvTLSFFree( void *pv )
+{
+xTLSFBlock *pxBlock, *pxNext, *pxPrev;
+
+	pxBlock = ( xTLSFBlock * ) ( ( unsigned char * ) pv - heapBLOCK_HEADER_SIZE );
+
+	/* Merge with the previous and the next block when they are free. */
+	if( ( pxBlock->xSize & heapBLOCK_PREV_FREE ) != 0 )
+	{
+		pxPrev = pxBlock->pxPrevPhys;
+		prvRemoveFree( pxPrev );
+		pxPrev->xSize += heapBLOCK_HEADER_SIZE + prvBlockSize( pxBlock );
+		pxBlock = pxPrev;
+	}
+	pxNext = prvNextPhys( pxBlock );
+	if( ( pxNext->xSize & heapBLOCK_FREE ) != 0 )
+	{
+		prvRemoveFree( pxNext );
+		pxBlock->xSize += heapBLOCK_HEADER_SIZE + prvBlockSize( pxNext );
+	}
+
+	prvInsertFree( pxBlock );
+}
+/*-----------------------------------------------------------*/
+
+static void *prvSlabMalloc( unsigned long uxClass )
+{
+xSlabClass *pxClass = &xSlabClasses[ uxClass ];
+xSlabPage *pxPage = pxClass->pxPartial;
+unsigned char *pucObject;
+
+	if( pxPage == NULL )
+	{
+		/* Take a page from the pool and put it on the partial list. */
+		pxPage = pxFreePages;
+		if( pxPage == NULL )
+		{
+			pxClass->xStats.xFallbacks++;
+			return NULL;
+		}
+		pxFreePages = pxPage->pxNext;
+		xFreePageCount--;
+		xSlabFree -= heapSLAB_PAGE_SIZE;
+		xSlabFree += pxClass->xObjects * pxClass->xStats.xObjectSize;
+
+		pxPage->ucClass = ( unsigned char ) uxClass;
+		pxPage->usInUse = 0;
+		pxPage->usCarved = 0;
+		pxPage->pvFreeList = NULL;
+		pxPage->pxPrev = NULL;
+		pxPage->pxNext = NULL;
+		pxClass->pxPartial = pxPage;
+		pxClass->xStats.xPages++;
+	}
+
+	if( pxPage->pvFreeList != NULL )
+	{
+		pucObject = ( unsigned char * ) pxPage->pvFreeList;
+		pxPage->pvFreeList = *( void ** ) pucObject;
+	}
+	else
+	{
+		/* Objects are carved on first use so that taking a page is O(1). */
+		pucObject = pucSlabStart + ( size_t ) ( pxPage - xSlabPages ) * heapSLAB_PAGE_SIZE +
+			( size_t ) pxPage->usCarved * pxClass->xStats.xObjectSize;
+		pxPage->usCarved++;
+	}
+	pxPage->usInUse++;
+
+	if( pxPage->usInUse == pxClass->xObjects )
+	{
+		/* Full, take it off the partial list. */
+		pxClass->pxPartial = pxPage->pxNext;
+		if( pxPage->pxNext != NULL )
+		{
+			pxPage->pxNext->pxPrev = NULL;
+		}
+	}
+
+	xSlabFree -= pxClass->xStats.xObjectSize;
+	pxClass->xStats.xAllocations++;
+	pxClass->xStats.xObjectsInUse++;
+	if( pxClass->xStats.xObjectsInUse > pxClass->xStats.xMaxObjectsInUse )
+	{
+		pxClass->xStats.xMaxObjectsInUse = pxClass->xStats.xObjectsInUse;
+	}
+	return pucObject;
+}
+/*-----------------------------------------------------------*/
+
+static void prvSlabFree( void *pv )
+{
+xSlabPage *pxPage = &xSlabPages[ ( size_t ) ( ( unsigned char * ) pv - pucSlabStart ) / heapSLAB_PAGE_SIZE ];
+xSlabClass *pxClass = &xSlabClasses[ pxPage->ucClass ];
+
+	if( pxPage->usInUse == pxClass->xObjects )
+	{
+		/* It was full, it has a free object again. */
+		pxPage->pxPrev = NULL;
+		pxPage->pxNext = pxClass->pxPartial;
+		if( pxPage->pxNext != NULL )
+		{
+			pxPage->pxNext->pxPrev = pxPage;
+		}
+		pxClass->pxPartial = pxPage;
+	}
+
+	*( void ** ) pv = pxPage->pvFreeList;
+	pxPage->pvFreeList = pv;
+	pxPage->usInUse--;
+	pxClass->xStats.xObjectsInUse--;
+	xSlabFree += pxClass->xStats.xObjectSize;
+
+	if( pxPage->usInUse == 0 )
+	{
+		/* Empty, give the page back to the pool. */
+		if( pxPage->pxPrev != NULL )
+		{
+			pxPage->pxPrev->pxNext = pxPage->pxNext;
+		}
+		else
+		{
+			pxClass->pxPartial = pxPage->pxNext;
+		}
+		if( pxPage->pxNext != NULL )
+		{
+			pxPage->pxNext->pxPrev = pxPage->pxPrev;
+		}
+		pxPage->pxNext = pxFreePages;
+		pxFreePages = pxPage;
+		xFreePageCount++;
+		xSlabFree -= pxClass->xObjects * pxClass->xStats.xObjectSize;
+		xSlabFree += heapSLAB_PAGE_SIZE;
+		pxClass->xStats.xPages--;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvHeapInit( void )
+{
+unsigned char *pucStart, *pucEnd;
+xTLSFBlock *pxBlock, *pxSentinel;
+unsigned long ux;
+size_t x;
+
+	pucSlabStart = ucHeap;
+	pucSlabEnd = pucSlabStart + heapSLAB_NUM_PAGES * heapSLAB_PAGE_SIZE;
+	for( x = heapSLAB_NUM_PAGES; x > 0; x-- )
+	{
+		xSlabPages[ x - 1 ].pxNext = pxFreePages;
+		pxFreePages = &xSlabPages[ x - 1 ];
+	}
+	xFreePageCount = heapSLAB_NUM_PAGES;
+	xSlabFree = heapSLAB_NUM_PAGES * heapSLAB_PAGE_SIZE;
+
+	for( ux = 0; ux < heapSLAB_NUM_CLASSES; ux++ )
+	{
+		xSlabClasses[ ux ].xStats.xObjectSize = uxHeapSlabClassSize[ ux ];
+		xSlabClasses[ ux ].xObjects = heapSLAB_PAGE_SIZE / uxHeapSlabClassSize[ ux ];
+	}
+	for( x = 0, ux = 0; x < sizeof( ucSizeToClass ); x++ )
+	{
+		while( uxHeapSlabClassSize[ ux ] < x * portBYTE_ALIGNMENT )
+		{
+			ux++;
+		}
+		ucSizeToClass[ x ] = ( unsigned char ) ux;
+	}
+
+	/* The TLSF area is one free block followed by a zero sized used block
+	that stops merging at the end of the heap. */
+	pucStart = pucSlabEnd;
+	pucEnd = ( unsigned char * ) ( ( ( size_t ) ucHeap + sizeof( ucHeap ) ) & heapBLOCK_SIZE_MASK );
+	pxBlock = ( xTLSFBlock * ) pucStart;
+	pxSentinel = ( xTLSFBlock * ) ( pucEnd - heapBLOCK_HEADER_SIZE );
+	pxSentinel->xSize = 0;
+	pxBlock->xSize = ( size_t ) ( ( unsigned char * ) pxSentinel - pucStart ) - heapBLOCK_HEADER_SIZE;
+	prvInsertFree( pxBlock );
+
+	xHeapTotal = xTLSFFree + xSlabFree;
+	xMinimumEverFree = xHeapTotal;
+}
+/*-----------------------------------------------------------*/
+
+void *pvPortMalloc( size_t xWantedSize )
+{
+void *pvReturn = NULL;
+
+	vTaskSuspendAll();
+	{
+		if( pucSlabStart == NULL )
+		{
+			prvHeapInit();
+		}
+
+		if( xWantedSize > 0 )
+		{
+			if( xWantedSize <= heapSLAB_MAX_SIZE )
+			{
+				pvReturn = prvSlabMalloc( ucSizeToClass[ ( xWantedSize + portBYTE_ALIGNMENT - 1 ) / portBYTE_ALIGNMENT ] );
+			}
+			if( pvReturn == NULL )
+			{
+				pvReturn = prvTLSFMalloc( xWantedSize );
+			}
+		}
+
+		if( xTLSFFree + xSlabFree < xMinimumEverFree )
+		{
+			xMinimumEverFree = xTLSFFree + xSlabFree;
+		}
+		traceMALLOC( pvReturn, xWantedSize );
+	}
+	xTaskResumeAll();
+
+	#if( configUSE_MALLOC_FAILED_HOOK == 1 )
+	{
+		if( pvReturn == NULL && xWantedSize > 0 )
+		{
+			extern void vApplicationMallocFailedHook( void );
+			vApplicationMallocFailedHook();
+		}
+	}
+	#endif
+
+	return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree( void *pv )
+{
+	if( pv )
+	{
+		vTaskSuspendAll();
+		{
+			if( ( unsigned char * ) pv >= pucSlabStart && ( unsigned char * ) pv < pucSlabEnd )
+			{
+				prvSlabFree( pv );
+			}
+			else
+			{
+				prvTLSFFree( pv );
+			}
+			traceFREE( pv, 0 );
+		}
+		xTaskResumeAll();
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortInitialiseBlocks( void )
+{
+	/* The heap is set up by the first call to pvPortMalloc(). */
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetFreeHeapSize( void )
+{
+	if( pucSlabStart == NULL )
+	{
+		return configTOTAL_HEAP_SIZE;
+	}
+	return xTLSFFree + xSlabFree;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetMinimumEverFreeHeapSize( void )
+{
+	if( pucSlabStart == NULL )
+	{
+		return configTOTAL_HEAP_SIZE;
+	}
+	return xMinimumEverFree;
+}
+/*-----------------------------------------------------------*/
+
+long xPortGetSlabClassStats( unsigned long uxClass, xSlabClassStats *pxStats )
+{
+	if( uxClass >= heapSLAB_NUM_CLASSES )
+	{
+		return pdFALSE;
+	}
+
+	vTaskSuspendAll();
+	{
+		*pxStats = xSlabClasses[ uxClass ].xStats;
+		pxStats->xObjectSize = uxHeapSlabClassSize[ uxClass ];
+	}
+	xTaskResumeAll();
+	return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetHeapStats( xHeapStats *pxStats )
+{
+xTLSFBlock *pxBlock;
+size_t xLargest = 0;
+int iFL, iSL;
+
+	vTaskSuspendAll();
+	{
+		if( pucSlabStart == NULL )
+		{
+			prvHeapInit();
+		}
+
+		/* The largest free block is in the highest occupied list. */
+		if( ulFLBitmap != 0 )
+		{
+			iFL = prvFLS( ulFLBitmap );
+			iSL = prvFLS( ulSLBitmap[ iFL ] );
+			for( pxBlock = pxFreeBlocks[ iFL ][ iSL ]; pxBlock != NULL; pxBlock = pxBlock->pxNextFree )
+			{
+				if( prvBlockSize( pxBlock ) > xLargest )
+				{
+					xLargest = prvBlockSize( pxBlock );
+				}
+			}
+		}
+
+		pxStats->xTotalBytes = xHeapTotal;
+		pxStats->xFreeBytes = xTLSFFree + xSlabFree;
+		pxStats->xMinimumEverFreeBytes = xMinimumEverFree;
+		pxStats->xLargestFreeBlock = xLargest;
+		pxStats->xFreeBlocks = xFreeBlockCount;
+		pxStats->xFreeSlabPages = xFreePageCount;
+		pxStats->ulFragmentation = ( xTLSFFree != 0 ) ? ( unsigned long ) ( 100 - ( xLargest * 100 ) / xTLSFFree ) : 0;
+	}
+	xTaskResumeAll();
+}
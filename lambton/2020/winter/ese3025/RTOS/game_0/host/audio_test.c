@@ -0,0 +1,214 @@
+/*
+ * audio_test.c
+ *
+ * The game_0 mixer on a workstation: the same libgameaudio, and the same
+ * sound effects, as on the board.
+ *
+ *	gcc -std=gnu99 -O2 -Wall -I../inc -o audio_test audio_test.c \
+ *	    ../source/libgameaudio.c ../source/libgamesounds.c
+ *
+ *	./audio_test wav game.wav
+ *		mixes a scene of the game, a block at a time as the DMA
+ *		interrupt does, and writes what the DAC would play as a WAV
+ *		file, 16-bit mono
+ *	./audio_test bench [blocks]
+ *		times the mixing of a block with 0 to AUDIO_CHANNELS voices
+ *		busy, PCM and ADPCM, and gives the cost of each voice
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "libgameaudio.h"
+#include "libgamesounds.h"
+
+/* the scene: which sound starts at which block */
+struct cue_struct
+{
+  uint16_t block;
+  const sound_t *sound;
+  uint8_t volume;
+};
+
+static const struct cue_struct scene[] =
+  {
+    { 10, &sfxFire, 200 },
+    { 25, &sfxFire, 200 },
+    { 30, &sfxHit, 255 },
+    { 40, &sfxFire, 200 },
+    { 44, &sfxFire, 200 },
+    { 48, &sfxFire, 200 },
+    { 50, &sfxHit, 255 },
+    { 55, &sfxAlienDown, 255 },
+    { 58, &sfxFire, 200 },
+    { 60, &sfxHit, 255 },
+    { 61, &sfxFire, 200 },
+    { 62, &sfxHit, 255 },
+    { 100, &sfxPlayerDown, 255 } };
+#define SCENE_BLOCKS			160
+
+static void
+prvPut16 (uint8_t *p, uint16_t v)
+{
+  p[0] = v;
+  p[1] = v >> 8;
+}
+
+static void
+prvPut32 (uint8_t *p, uint32_t v)
+{
+  prvPut16 (p, v);
+  prvPut16 (p + 2, v >> 16);
+}
+
+static int
+prvWav (const char *path)
+{
+  static audio_mixer_t mixer;
+  uint16_t block[AUDIO_BLOCK];
+  uint8_t header[44], pcm[2 * AUDIO_BLOCK];
+  uint32_t bytes = SCENE_BLOCKS * sizeof(pcm);
+  size_t cue = 0;
+  uint8_t most = 0;
+  FILE *f = fopen (path, "wb");
+
+  if (f == NULL)
+    {
+      perror (path);
+      return 1;
+    }
+  memcpy (header, "RIFF", 4);
+  prvPut32 (header + 4, 36 + bytes);
+  memcpy (header + 8, "WAVEfmt ", 8);
+  prvPut32 (header + 16, 16);
+  prvPut16 (header + 20, 1); // PCM
+  prvPut16 (header + 22, 1); // mono
+  prvPut32 (header + 24, AUDIO_SAMPLE_RATE);
+  prvPut32 (header + 28, AUDIO_SAMPLE_RATE * 2);
+  prvPut16 (header + 32, 2);
+  prvPut16 (header + 34, 16);
+  memcpy (header + 36, "data", 4);
+  prvPut32 (header + 40, bytes);
+  fwrite (header, 1, sizeof(header), f);
+
+  audioInit (&mixer);
+  for (uint16_t b = 0; b != SCENE_BLOCKS; ++b)
+    {
+      while (cue != sizeof(scene) / sizeof(scene[0]) && scene[cue].block == b)
+	{
+	  audioPlay (&mixer, scene[cue].sound, scene[cue].volume);
+	  cue++;
+	}
+      if (audioActive (&mixer) > most)
+	{
+	  most = audioActive (&mixer);
+	}
+      audioMix (&mixer, block, AUDIO_BLOCK);
+      for (int i = 0; i != AUDIO_BLOCK; ++i)
+	{
+	  int32_t s = (int32_t) (block[i] >> AUDIO_DAC_SHIFT) - AUDIO_DAC_MID;
+	  prvPut16 (pcm + 2 * i, (uint16_t) (s << (16 - AUDIO_DAC_BITS)));
+	}
+      fwrite (pcm, 1, sizeof(pcm), f);
+    }
+  fclose (f);
+
+  printf ("%s: %.2f s, %u blocks of %u samples at %u Hz\n", path,
+	  (double) SCENE_BLOCKS * AUDIO_BLOCK / AUDIO_SAMPLE_RATE,
+	  SCENE_BLOCKS, AUDIO_BLOCK, AUDIO_SAMPLE_RATE);
+  printf ("sounds %lu, voices stolen %lu, most voices at once %u,"
+	  " samples clipped %lu\n", (unsigned long) mixer.stats.started,
+	  (unsigned long) mixer.stats.stolen, most,
+	  (unsigned long) mixer.stats.clipped);
+  return 0;
+}
+
+static double
+prvNow (void)
+{
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/*
+ * function times blocks blocks with voices voices playing sound, and
+ * returns the nanoseconds a block
+ */
+static double
+prvTime (const sound_t *sound, uint8_t voices, unsigned long blocks)
+{
+  static audio_mixer_t mixer;
+  static uint16_t block[AUDIO_BLOCK];
+  uint32_t sum = 0;
+  double start, t = 0;
+
+  audioInit (&mixer);
+  for (unsigned long b = 0; b != blocks; ++b)
+    {
+      /* keep the voices busy, restarting them outside the timing */
+      while (audioActive (&mixer) < voices)
+	{
+	  audioPlay (&mixer, sound, AUDIO_VOLUME_FULL);
+	}
+      start = prvNow ();
+      audioMix (&mixer, block, AUDIO_BLOCK);
+      t += prvNow () - start;
+      sum += block[b % AUDIO_BLOCK];
+    }
+  if (sum == 1)
+    {
+      printf (" "); // keeps the mixing from being optimized away
+    }
+  return t * 1e9 / blocks;
+}
+
+static int
+prvBench (unsigned long blocks)
+{
+  static const struct
+  {
+    const char *name;
+    const sound_t *sound;
+  } kind[2] =
+    {
+      { "PCM8", &sfxFire },
+      { "ADPCM", &sfxPlayerDown } };
+
+  printf ("block of %u samples (%.1f ms), %lu blocks a run\n", AUDIO_BLOCK,
+	  1000.0 * AUDIO_BLOCK / AUDIO_SAMPLE_RATE, blocks);
+  printf ("%-6s %6s %12s %12s %14s\n", "format", "voices", "ns/block",
+	  "ns/sample", "ns/voice/smpl");
+  for (int k = 0; k != 2; ++k)
+    {
+      double idle = prvTime (kind[k].sound, 0, blocks), t;
+
+      for (uint8_t v = 0; v <= AUDIO_CHANNELS; ++v)
+	{
+	  t = v ? prvTime (kind[k].sound, v, blocks) : idle;
+	  printf ("%-6s %6u %12.0f %12.2f", kind[k].name, v, t, t / AUDIO_BLOCK);
+	  if (v)
+	    printf (" %14.2f", (t - idle) / v / AUDIO_BLOCK);
+	  printf ("\n");
+	}
+    }
+  return 0;
+}
+
+int
+main (int argc, char *argv[])
+{
+  if (argc == 3 && strcmp (argv[1], "wav") == 0)
+    {
+      return prvWav (argv[2]);
+    }
+  if ((argc == 2 || argc == 3) && strcmp (argv[1], "bench") == 0)
+    {
+      return prvBench (argc == 3 ? strtoul (argv[2], NULL, 0) : 200000);
+    }
+  fprintf (stderr, "usage: %s wav game.wav | bench [blocks]\n", argv[0]);
+  return 2;
+}
@@ -0,0 +1,15 @@
+/*
+ * board.h
+ *
+ * Host (Linux) stand-in for the board layer, found ahead of the board
+ * library by the host programs that include FreeRTOSConfig.h (-I. first).
+ * Of the board layer, the configuration only names SystemCoreClock, which
+ * is used by port.c alone.
+ */
+
+#ifndef __BOARD_H_
+#define __BOARD_H_
+
+extern unsigned long SystemCoreClock;
+
+#endif /* __BOARD_H_ */
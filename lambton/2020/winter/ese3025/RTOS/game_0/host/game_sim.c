@@ -0,0 +1,371 @@
+/*
+ * game_sim.c
+ *
+ * Headless game_0: steps libgamecore on a workstation, as fast as it can,
+ * with the buttons read from a recording. The game takes its random
+ * numbers from its own seeded generator, so a recording replays exactly
+ * the same game every time, and the state hash printed at the end tells
+ * whether a change to the game logic changed the game.
+ *
+ *	gcc -std=gnu99 -O2 -Wall -I../inc -o game_sim game_sim.c \
+ *	    ../source/libgamecore.c ../source/libgameds.c \
+ *	    ../source/libtakisbasics.c \
+ *	    -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=free
+ *
+ *	./game_sim record [-s seed] [-n steps] game.rec
+ *		make up a recording: a bot holds random buttons for random
+ *		spells
+ *	./game_sim replay [-n steps] [-v] [-x hash] game.rec
+ *		replay a recording and report the CPU time of each step,
+ *		heap allocations made by the game, and peak GO counts; -v
+ *		prints every step, -x fails unless the state hash matches
+ *
+ * Recording format, all numbers little endian:
+ *
+ *	"G0IN"  version (1 byte, 1)  seed (4 bytes)
+ *	then, until the end of the file, runs of identical steps:
+ *	buttons (1 byte, UI_LEFT | UI_RIGHT | UI_CROUCH | UI_FIRE)
+ *	steps (2 bytes)
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "libgameds.h"
+#include "libgamecore.h"
+
+#define REC_MAGIC			"G0IN"
+#define REC_VERSION			1
+#define REC_HEADER_SIZE			9
+#define REC_RUN_SIZE			3
+#define REC_MAX_RUN			0xFFFF
+
+/* allocations by the game, counted while a step runs */
+static int counting = 0;
+static unsigned long allocations = 0, allocated_bytes = 0;
+
+void *__real_malloc (size_t size);
+void *__real_calloc (size_t n, size_t size);
+void *__real_realloc (void *p, size_t size);
+void __real_free (void *p);
+
+void *
+__wrap_malloc (size_t size)
+{
+  allocations += counting;
+  allocated_bytes += counting ? size : 0;
+  return __real_malloc (size);
+}
+
+void *
+__wrap_calloc (size_t n, size_t size)
+{
+  allocations += counting;
+  allocated_bytes += counting ? n * size : 0;
+  return __real_calloc (n, size);
+}
+
+void *
+__wrap_realloc (void *p, size_t size)
+{
+  allocations += counting;
+  allocated_bytes += counting ? size : 0;
+  return __real_realloc (p, size);
+}
+
+void
+__wrap_free (void *p)
+{
+  __real_free (p);
+}
+
+static void
+prvPut32 (uint8_t *p, uint32_t v)
+{
+  p[0] = v;
+  p[1] = v >> 8;
+  p[2] = v >> 16;
+  p[3] = v >> 24;
+}
+
+static uint32_t
+prvGet32 (const uint8_t *p)
+{
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+/*
+ * function writes a recording of steps steps, made up by a bot
+ */
+static int
+prvRecord (const char *path, uint32_t seed, unsigned long steps)
+{
+  uint8_t header[REC_HEADER_SIZE], run[REC_RUN_SIZE];
+  uint32_t bot;
+  unsigned long left, spell;
+  FILE *f = fopen (path, "wb");
+
+  if (f == NULL)
+    {
+      perror (path);
+      return 1;
+    }
+  memcpy (header, REC_MAGIC, 4);
+  header[4] = REC_VERSION;
+  prvPut32 (header + 5, seed);
+  fwrite (header, 1, sizeof(header), f);
+
+  /* the bot has its own generator, the game's is seeded at replay */
+  prngSeed (&bot, seed ^ 0x9E3779B9UL);
+  for (left = steps; left != 0; left -= spell)
+    {
+      uint32_t r = prngNext (&bot);
+      uint8_t buttons = 0;
+
+      if ((r & 3) == 0)
+	buttons |= UI_LEFT;
+      else if ((r & 3) == 1)
+	buttons |= UI_RIGHT;
+      if ((r & 0x30) == 0)
+	buttons |= UI_FIRE;
+      else if ((r & 0x1F0) == 0x10)
+	buttons |= UI_CROUCH;
+      spell = 1 + ((r >> 16) % 40);
+      if (spell > left)
+	spell = left;
+      run[0] = buttons;
+      run[1] = spell;
+      run[2] = spell >> 8;
+      fwrite (run, 1, sizeof(run), f);
+    }
+  fclose (f);
+  printf ("%s: %lu steps, seed %lu\n", path, steps, (unsigned long) seed);
+  return 0;
+}
+
+/*
+ * function hashes what a step can change, FNV-1a
+ */
+static uint32_t
+prvHash (uint32_t h, const void *data, size_t len)
+{
+  const uint8_t *p = data;
+
+  while (len--)
+    {
+      h ^= *p++;
+      h *= 16777619UL;
+    }
+  return h;
+}
+
+static uint32_t
+prvStateHash (uint32_t h, const game_t *game)
+{
+  const go_store_t *gos = &game->gos;
+
+  for (go_slot_t s = 0; s != GO_POOL_SIZE; ++s)
+    {
+      if (!goIsAlive (gos, s))
+	continue;
+      h = prvHash (h, &s, sizeof(s));
+      h = prvHash (h, &gos->x[s], sizeof(gos->x[s]));
+      h = prvHash (h, &gos->y[s], sizeof(gos->y[s]));
+      h = prvHash (h, &gos->vx[s], sizeof(gos->vx[s]));
+      h = prvHash (h, &gos->vy[s], sizeof(gos->vy[s]));
+      h = prvHash (h, &gos->health[s], sizeof(gos->health[s]));
+      h = prvHash (h, &gos->animstate[s], sizeof(gos->animstate[s]));
+      h = prvHash (h, &gos->flags[s], sizeof(gos->flags[s]));
+    }
+  h = prvHash (h, &game->score, sizeof(game->score));
+  return prvHash (h, &game->rng, sizeof(game->rng));
+}
+
+static int
+prvCompare (const void *a, const void *b)
+{
+  uint32_t x = *(const uint32_t *) a, y = *(const uint32_t *) b;
+
+  return (x > y) - (x < y);
+}
+
+/*
+ * function replays a recording, the way vRunGameTask() and vGameLoopTask()
+ * play a game: a new round when the player dies, a new game when the
+ * player is out of lives
+ */
+static int
+prvReplay (const char *path, unsigned long max_steps, int verbose,
+	   const char *expect)
+{
+  static game_t game;
+  uint8_t header[REC_HEADER_SIZE], run[REC_RUN_SIZE];
+  uint16_t peak[NUMBER_OF_GO_TYPES] = { 0 };
+  uint16_t peak_total = 0, alive;
+  unsigned long steps = 0, games = 1, rounds = 1, capacity = 1 << 16;
+  unsigned long best_score = 0, step_allocs;
+  uint32_t *ns = malloc (capacity * sizeof(uint32_t));
+  uint32_t hash = 2166136261UL;
+  uint64_t total_ns = 0;
+  uint8_t lives = PLAYER_LIVES;
+  struct timespec t0, t1;
+  FILE *f = fopen (path, "rb");
+
+  if (f == NULL)
+    {
+      perror (path);
+      return 1;
+    }
+  if (fread (header, 1, sizeof(header), f) != sizeof(header)
+      || memcmp (header, REC_MAGIC, 4) != 0 || header[4] != REC_VERSION)
+    {
+      fprintf (stderr, "%s: not a game_0 recording\n", path);
+      return 1;
+    }
+
+  gameInit (&game);
+  prngSeed (&game.rng, prvGet32 (header + 5));
+  gameStartRound (&game, lives);
+
+  while (steps != max_steps && fread (run, 1, sizeof(run), f) == sizeof(run))
+    {
+      unsigned long spell = run[1] | (run[2] << 8);
+
+      uiUnpack (run[0], &game.user);
+      for (; spell != 0 && steps != max_steps; --spell, ++steps)
+	{
+	  step_allocs = allocations;
+	  counting = 1;
+	  clock_gettime (CLOCK_THREAD_CPUTIME_ID, &t0);
+	  gameStep (&game);
+	  clock_gettime (CLOCK_THREAD_CPUTIME_ID, &t1);
+	  counting = 0;
+
+	  if (steps == capacity)
+	    {
+	      capacity *= 2;
+	      ns = realloc (ns, capacity * sizeof(uint32_t));
+	    }
+	  ns[steps] = (t1.tv_sec - t0.tv_sec) * 1000000000L
+	      + (t1.tv_nsec - t0.tv_nsec);
+	  total_ns += ns[steps];
+
+	  alive = 0;
+	  for (int k = 0; k != NUMBER_OF_GO_TYPES; ++k)
+	    {
+	      alive += game.gos.number_alive[k];
+	      if (game.gos.number_alive[k] > peak[k])
+		peak[k] = game.gos.number_alive[k];
+	    }
+	  if (alive > peak_total)
+	    peak_total = alive;
+	  if (verbose)
+	    printf ("step %lu  %lu ns  %lu allocs  %u GOs  score %lu\n", steps,
+		    (unsigned long) ns[steps], allocations - step_allocs, alive,
+		    (unsigned long) game.score);
+	  hash = prvStateHash (hash, &game);
+
+	  /* the player died: next round, or next game */
+	  if (!goIsAlive (&game.gos, game.player))
+	    {
+	      gameClear (&game);
+	      if (--lives == 0)
+		{
+		  if (game.score > best_score)
+		    best_score = game.score;
+		  game.score = 0;
+		  lives = PLAYER_LIVES;
+		  games++;
+		}
+	      rounds++;
+	      gameStartRound (&game, lives);
+	    }
+	}
+    }
+  fclose (f);
+  if (game.score > best_score)
+    best_score = game.score;
+
+  if (steps == 0)
+    {
+      fprintf (stderr, "%s: no steps\n", path);
+      return 1;
+    }
+  qsort (ns, steps, sizeof(uint32_t), prvCompare);
+  printf ("steps %lu  games %lu  rounds %lu  best score %lu\n", steps, games,
+	  rounds, best_score);
+  printf ("step cpu time: mean %lu ns  p50 %lu  p99 %lu  max %lu  "
+	  "total %.3f ms\n", (unsigned long) (total_ns / steps),
+	  (unsigned long) ns[steps / 2], (unsigned long) ns[steps * 99 / 100],
+	  (unsigned long) ns[steps - 1], total_ns / 1e6);
+  printf ("heap allocations by the game: %lu (%lu bytes)\n", allocations,
+	  allocated_bytes);
+  printf ("peak GOs: player %u  alien %u  pooh %u  expunger %u  baby %u  "
+	  "kitty %u  total %u of %u\n", peak[player], peak[alien], peak[pooh],
+	  peak[expunger], peak[baby], peak[kitty], peak_total, GO_POOL_SIZE);
+  printf ("state hash %08lx\n", (unsigned long) hash);
+  free (ns);
+
+  if (expect != NULL && strtoul (expect, NULL, 16) != hash)
+    {
+      fprintf (stderr, "state hash differs from %s\n", expect);
+      return 2;
+    }
+  return 0;
+}
+
+static int
+prvUsage (const char *name)
+{
+  fprintf (stderr, "usage: %s record [-s seed] [-n steps] file\n"
+	   "       %s replay [-n steps] [-v] [-x hash] file\n",
+	   name, name);
+  return 1;
+}
+
+int
+main (int argc, char *argv[])
+{
+  unsigned long steps = 0;
+  uint32_t seed = PRNG_DEFAULT_SEED;
+  int verbose = 0, opt;
+  const char *expect = NULL;
+  const char *mode;
+
+  if (argc < 2)
+    return prvUsage (argv[0]);
+  mode = argv[1];
+  optind = 2;
+  while ((opt = getopt (argc, argv, "s:n:vx:")) != -1)
+    {
+      switch (opt)
+	{
+	case 's':
+	  seed = strtoul (optarg, NULL, 0);
+	  break;
+	case 'n':
+	  steps = strtoul (optarg, NULL, 0);
+	  break;
+	case 'v':
+	  verbose = 1;
+	  break;
+	case 'x':
+	  expect = optarg;
+	  break;
+	default:
+	  return prvUsage (argv[0]);
+	}
+    }
+  if (optind != argc - 1)
+    return prvUsage (argv[0]);
+
+  if (strcmp (mode, "record") == 0)
+    return prvRecord (argv[optind], seed, steps ? steps : 100000);
+  if (strcmp (mode, "replay") == 0)
+    return prvReplay (argv[optind], steps ? steps : (unsigned long) -1,
+		      verbose, expect);
+  return prvUsage (argv[0]);
+}
@@ -0,0 +1,440 @@
+/*
+ * heap_bench.c
+ *
+ * freertos/src/heap_slab.c on a workstation, under a stub scheduler (the
+ * heap only suspends and resumes it), next to heap_3.c, the malloc()
+ * wrapper it replaced. heap_3.c is taken from proj_freertos_0 and built
+ * here with its functions renamed; on the host it wraps glibc malloc(),
+ * on the LPC1769 newlib's.
+ *
+ *	gcc -std=gnu99 -O2 -Wall -DCORE_M3 -I. -I../inc -I../freertos/inc \
+ *	    -o heap_bench heap_bench.c ../freertos/src/heap_slab.c
+ *
+ *	./heap_bench bench [-s seed] [-n ops]
+ *		time malloc/free pairs of both heaps on the same random
+ *		requests: small (slab classes), large (TLSF) and a game
+ *		like mix, each against a live set of objects small enough
+ *		that even all of them at their largest fit the heap; any
+ *		request either heap fails fails the bench
+ *	./heap_bench stress [-s seed] [-n ops]
+ *		random malloc/free on both heaps, every object filled with a
+ *		pattern that is checked when it is freed, the heap statistics
+ *		checked as it runs, the heap exhausted and recovered, and at
+ *		the end all of it free again in one block; the random run
+ *		asks for more than heap_slab.c holds on purpose, so it runs
+ *		out of memory there and heap_3.c does not
+ *
+ * Build the stress test with -fsanitize=address,undefined -g as well: the
+ * heap_slab.c objects live in its static array, so the patterns catch
+ * overlapping objects, and the sanitizers catch the heap reaching outside
+ * the array and heap_3.c objects being overrun.
+ *
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "heap_slab.h"
+
+#define pvPortMalloc pvHeap3Malloc
+#define vPortFree vHeap3Free
+#include "../../proj_freertos_0/freertos/src/heap_3.c"
+#undef pvPortMalloc
+#undef vPortFree
+
+#define SLOTS				512
+#define SMALL_MAX			128	/* heapSLAB_MAX_SIZE of heap_slab.c */
+
+typedef struct
+{
+  const char *name;
+  void *(*malloc) (size_t size);
+  void (*free) (void *p);
+} heap_t;
+
+static const heap_t heaps[] = {
+  { "heap_slab", pvPortMalloc, vPortFree },
+  { "heap_3", pvHeap3Malloc, vHeap3Free },
+};
+
+typedef struct
+{
+  const char *name;
+  unsigned live;		/* objects kept allocated */
+  unsigned small_percent;	/* requests of 1..SMALL_MAX bytes */
+  size_t large_max;		/* the others are SMALL_MAX+1..large_max */
+} workload_t;
+
+/* live * the largest request is at most 6K for small, which is about
+   what the 7K of slab pages hold once each class has its partial page,
+   and at most 12K of the 21K of TLSF for the others */
+static const workload_t workloads[] = {
+  { "small", 48, 100, 0 },
+  { "large", 6, 0, 2048 },
+  { "mixed", 24, 90, 512 },
+};
+
+/* the stub scheduler: the heap only suspends and resumes it */
+static int suspended = 0;
+
+void
+vTaskSuspendAll (void)
+{
+  suspended++;
+}
+
+signed portBASE_TYPE
+xTaskResumeAll (void)
+{
+  if (suspended-- == 0)
+    {
+      fprintf (stderr, "FAILED: xTaskResumeAll() without vTaskSuspendAll()\n");
+      exit (1);
+    }
+  return pdFALSE;
+}
+
+/*
+ * function is xorshift32, the bench wants the same requests every run
+ */
+static uint32_t
+prvRandom (uint32_t *state)
+{
+  uint32_t x = *state;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return *state = x;
+}
+
+static size_t
+prvSize (uint32_t *state, const workload_t *w)
+{
+  uint32_t r = prvRandom (state);
+
+  if (r % 100 < w->small_percent)
+    return 1 + (r >> 8) % SMALL_MAX;
+  return SMALL_MAX + 1 + (r >> 8) % (w->large_max - SMALL_MAX);
+}
+
+static uint64_t
+prvNow (void)
+{
+  struct timespec t;
+
+  clock_gettime (CLOCK_MONOTONIC, &t);
+  return t.tv_sec * 1000000000ULL + t.tv_nsec;
+}
+
+/*
+ * function frees the object in a random slot of the live set and puts a
+ * new one in its place, ops times; returns the requests that failed
+ */
+static unsigned long
+prvChurn (const heap_t *h, const workload_t *w, const uint32_t *slot,
+	  const size_t *size, unsigned long ops)
+{
+  void *live[SLOTS] = { NULL };
+  unsigned long failed = 0;
+
+  for (unsigned long i = 0; i != ops; ++i)
+    {
+      void **p = &live[slot[i]];
+
+      h->free (*p);
+      *p = h->malloc (size[i]);
+      failed += *p == NULL;
+    }
+  for (unsigned k = 0; k != w->live; ++k)
+    h->free (live[k]);
+  return failed;
+}
+
+static int
+prvBench (uint32_t seed, unsigned long ops)
+{
+  uint32_t *slot = malloc (ops * sizeof(uint32_t));
+  size_t *size = malloc (ops * sizeof(size_t));
+  int ret = 0;
+
+  printf ("%lu malloc/free pairs per run, ns per pair\n", ops);
+  printf ("%-8s %6s %12s %12s\n", "", "live", heaps[0].name, heaps[1].name);
+  for (unsigned k = 0; k != sizeof(workloads) / sizeof(workloads[0]); ++k)
+    {
+      const workload_t *w = &workloads[k];
+      uint32_t state = seed;
+      double ns[2];
+      unsigned long failed[2];
+
+      /* the requests are made up ahead, so both heaps get the same */
+      for (unsigned long i = 0; i != ops; ++i)
+	{
+	  slot[i] = prvRandom (&state) % w->live;
+	  size[i] = prvSize (&state, w);
+	}
+      for (unsigned j = 0; j != 2; ++j)
+	{
+	  /* a run to warm up, then the timed one */
+	  failed[j] = prvChurn (&heaps[j], w, slot, size, ops < 10000 ? ops : 10000);
+	  uint64_t t0 = prvNow ();
+	  failed[j] += prvChurn (&heaps[j], w, slot, size, ops);
+	  ns[j] = (double) (prvNow () - t0) / ops;
+	}
+      printf ("%-8s %6u %12.1f %12.1f\n", w->name, w->live, ns[0], ns[1]);
+      if (failed[0] != 0 || failed[1] != 0)
+	{
+	  printf ("FAILED: %s: %lu / %lu requests out of memory\n", w->name,
+		  failed[0], failed[1]);
+	  ret = 1;
+	}
+    }
+  free (slot);
+  free (size);
+  return ret;
+}
+
+/* what the stress test knows about an object */
+typedef struct
+{
+  unsigned char *p;
+  size_t size;
+  unsigned char tag;
+} object_t;
+
+static void
+prvFill (object_t *o)
+{
+  for (size_t i = 0; i != o->size; ++i)
+    o->p[i] = o->tag + i * 7;
+}
+
+static int
+prvCheck (const heap_t *h, const object_t *o)
+{
+  for (size_t i = 0; i != o->size; ++i)
+    if (o->p[i] != (unsigned char) (o->tag + i * 7))
+      {
+	printf ("FAILED: %s: %zu byte object at %p overwritten at byte %zu\n",
+		h->name, o->size, (void *) o->p, i);
+	return 1;
+      }
+  return 0;
+}
+
+/*
+ * function checks the statistics of heap_slab.c against what the test has
+ * allocated
+ */
+static int
+prvCheckStats (size_t in_use)
+{
+  xHeapStats stats;
+
+  vPortGetHeapStats (&stats);
+  if (stats.xFreeBytes != xPortGetFreeHeapSize ()
+      || stats.xFreeBytes > stats.xTotalBytes
+      || stats.xTotalBytes - stats.xFreeBytes < in_use
+      || stats.xMinimumEverFreeBytes > stats.xFreeBytes
+      || stats.xMinimumEverFreeBytes != xPortGetMinimumEverFreeHeapSize ()
+      || stats.xLargestFreeBlock > stats.xFreeBytes
+      || (stats.xLargestFreeBlock != 0) != (stats.xFreeBlocks != 0)
+      || stats.ulFragmentation > 100)
+    {
+      printf ("FAILED: heap_slab statistics: total %zu free %zu (%zu in use) "
+	      "min %zu largest %zu blocks %zu pages %zu frag %lu%%\n",
+	      stats.xTotalBytes, stats.xFreeBytes, in_use,
+	      stats.xMinimumEverFreeBytes, stats.xLargestFreeBlock,
+	      stats.xFreeBlocks, stats.xFreeSlabPages, stats.ulFragmentation);
+      return 1;
+    }
+  return 0;
+}
+
+/*
+ * function checks that all of heap_slab.c is free and in one piece
+ */
+static int
+prvCheckEmpty (const char *when)
+{
+  xHeapStats stats;
+  xSlabClassStats slab;
+
+  vPortGetHeapStats (&stats);
+  if (stats.xFreeBytes != stats.xTotalBytes || stats.xFreeBlocks != 1
+      || stats.ulFragmentation != 0)
+    {
+      printf ("FAILED: heap_slab %s: free %zu of %zu in %zu blocks, "
+	      "fragmentation %lu%%\n", when, stats.xFreeBytes,
+	      stats.xTotalBytes, stats.xFreeBlocks, stats.ulFragmentation);
+      return 1;
+    }
+  for (unsigned long c = 0; xPortGetSlabClassStats (c, &slab); ++c)
+    if (slab.xPages != 0 || slab.xObjectsInUse != 0)
+      {
+	printf ("FAILED: heap_slab %s: %zu byte class keeps %zu pages, %zu "
+		"objects\n", when, slab.xObjectSize, slab.xPages,
+		slab.xObjectsInUse);
+	return 1;
+      }
+  return 0;
+}
+
+/*
+ * function allocates objects of size until the heap is out of memory, then
+ * frees them all; returns the count, or -1 on failure
+ */
+static long
+prvExhaust (const heap_t *h, size_t size, object_t *o, unsigned max)
+{
+  unsigned n;
+
+  for (n = 0; n != max; ++n)
+    {
+      o[n].p = h->malloc (size);
+      if (o[n].p == NULL)
+	break;
+      o[n].size = size;
+      o[n].tag = n;
+      prvFill (&o[n]);
+    }
+  for (unsigned k = 0; k != n; ++k)
+    {
+      if (prvCheck (h, &o[k]))
+	return -1;
+      h->free (o[k].p);
+    }
+  return n;
+}
+
+static int
+prvStress (uint32_t seed, unsigned long ops)
+{
+  static object_t o[SLOTS], big[configTOTAL_HEAP_SIZE / 8];
+  static const workload_t stress = { "stress", SLOTS, 70, 4096 };
+
+  for (unsigned j = 0; j != 2; ++j)
+    {
+      const heap_t *h = &heaps[j];
+      uint32_t state = seed;
+      unsigned long failed = 0;
+      size_t in_use = 0, peak = 0;
+
+      memset (o, 0, sizeof(o));
+      for (unsigned long i = 0; i != ops; ++i)
+	{
+	  object_t *s = &o[prvRandom (&state) % SLOTS];
+
+	  if (s->p != NULL)
+	    {
+	      if (prvCheck (h, s))
+		return 1;
+	      h->free (s->p);
+	      in_use -= s->size;
+	      s->p = NULL;
+	      continue;
+	    }
+	  s->size = prvSize (&state, &stress);
+	  s->p = h->malloc (s->size);
+	  if (s->p == NULL)
+	    {
+	      failed++;
+	      continue;
+	    }
+	  if ((uintptr_t) s->p % portBYTE_ALIGNMENT != 0)
+	    {
+	      printf ("FAILED: %s: %zu byte object at %p is not aligned\n",
+		      h->name, s->size, (void *) s->p);
+	      return 1;
+	    }
+	  s->tag = i;
+	  prvFill (s);
+	  in_use += s->size;
+	  if (in_use > peak)
+	    peak = in_use;
+	  if (j == 0 && i % 1024 == 0 && prvCheckStats (in_use))
+	    return 1;
+	}
+      for (unsigned k = 0; k != SLOTS; ++k)
+	if (o[k].p != NULL)
+	  {
+	    if (prvCheck (h, &o[k]))
+	      return 1;
+	    h->free (o[k].p);
+	    o[k].p = NULL;
+	  }
+      printf ("%-10s %lu ops, peak %zu bytes in use, %lu requests out of "
+	      "memory\n", h->name, ops, peak, failed);
+    }
+  if (prvCheckEmpty ("after the random run"))
+    return 1;
+
+  /* out of memory, small objects first, then large, and back */
+  long small = prvExhaust (&heaps[0], 24, big, sizeof(big) / sizeof(big[0]));
+  long large = prvExhaust (&heaps[0], 1000, big, sizeof(big) / sizeof(big[0]));
+  long again = prvExhaust (&heaps[0], 24, big, sizeof(big) / sizeof(big[0]));
+
+  if (small < 0 || large < 0 || again < 0)
+    return 1;
+  if (small == sizeof(big) / sizeof(big[0]) || large == 0 || again != small)
+    {
+      printf ("FAILED: heap_slab exhausted with %ld then %ld objects\n",
+	      small, again);
+      return 1;
+    }
+  if (prvCheckEmpty ("after running out of memory"))
+    return 1;
+  printf ("heap_slab  ran out after %ld 24 byte objects, %ld 1000 byte "
+	  "objects, and was whole again\n", small, large);
+  return 0;
+}
+
+static int
+prvUsage (const char *name)
+{
+  fprintf (stderr, "usage: %s bench [-s seed] [-n ops]\n"
+	   "       %s stress [-s seed] [-n ops]\n", name, name);
+  return 1;
+}
+
+int
+main (int argc, char *argv[])
+{
+  unsigned long ops = 0;
+  uint32_t seed = 2463534242UL;
+  int opt;
+  const char *mode;
+
+  if (argc < 2)
+    return prvUsage (argv[0]);
+  mode = argv[1];
+  optind = 2;
+  while ((opt = getopt (argc, argv, "s:n:")) != -1)
+    {
+      switch (opt)
+	{
+	case 's':
+	  seed = strtoul (optarg, NULL, 0);
+	  break;
+	case 'n':
+	  ops = strtoul (optarg, NULL, 0);
+	  break;
+	default:
+	  return prvUsage (argv[0]);
+	}
+    }
+  if (optind != argc || seed == 0)
+    return prvUsage (argv[0]);
+
+  if (strcmp (mode, "bench") == 0)
+    return prvBench (seed, ops ? ops : 1000000);
+  if (strcmp (mode, "stress") == 0)
+    return prvStress (seed, ops ? ops : 1000000);
+  return prvUsage (argv[0]);
+}
@@ -0,0 +1,550 @@
+/*
+ * impacts_bench.c
+ *
+ * Times the proximity pass of gameStep() with hundreds of GOs: every GO
+ * moves, then aliens look for expungers and kitties, the player for
+ * poohs, kitties and babies, and babies and kitties for poohs. Four ways
+ * of finding the objects near a subject are timed on the same scenes:
+ *
+ *	game	prvComputeProximities() of libgamecore.c, which scans kinds
+ *		of fewer than GRID_MIN_SLOTS slots and uses the grid for the
+ *		others
+ *	grid	prvGridProximities(), the grid cells around the subject
+ *	scan	prvScanProximities(), every object of the kind, in the
+ *		go_store_t arrays
+ *	list	the layout go_store_t replaced: a go_t node from the heap
+ *		per GO, each followed by the stack of its task, a linked list
+ *		per kind, and an interaction list per subject whose nodes
+ *		are looked up, allocated and freed as objects come and go,
+ *		as vImpactsTask() did
+ *
+ * scan against grid is the grid's gain, list against scan the layout's;
+ * where grid and scan cross over is what GRID_MIN_SLOTS is set from. All
+ * must find the same seen/hits masks in every frame. The GO pool is
+ * raised past the game's (21 GOs) on the command line, and the GOs bounce
+ * off the borders instead of dying, so a scene keeps its size; built
+ * without the -D options, it times the game's own pool. GRID_CELL_SIZE
+ * and GRID_MIN_SLOTS can be set the same way:
+ *
+ *	gcc -std=gnu99 -O2 -Wall -I../inc -DMAX_ALIENS=100 -DMAX_POOHS=500 \
+ *	    -DMAX_EXPUNGERS=100 -DMAX_BABIES=50 -DMAX_KITTIES=50 \
+ *	    -o impacts_bench impacts_bench.c ../source/libgameds.c \
+ *	    ../source/libtakisbasics.c
+ *
+ *	./impacts_bench [-s seed] [-f frames] [count...]
+ *		time frames frames of scenes of count GOs each (by default
+ *		21, 50, 100, 200, 400 and 800), and print the mean time of
+ *		a frame for each method
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* for prvComputeProximities() */
+#include "../source/libgamecore.c"
+
+enum method
+{
+  GAME, GRID, SCAN, LIST, NUMBER_OF_METHODS
+};
+
+static const char *const method_name[NUMBER_OF_METHODS] =
+  { "game", "grid", "scan", "list" };
+
+/* the old layout, as libgameds.h had it */
+struct old_go_list_struct
+{
+  gotype_t kind;
+  uint32_t ID;
+  uint16_t distance;
+  bool_t seen;
+  bool_t collision;
+  struct old_go_list_struct *pNext;
+  struct old_go_list_struct *pPrev;
+};
+typedef struct old_go_list_struct old_go_list_t;
+
+struct old_go_struct
+{
+  gotype_t kind;
+  uint32_t ID; // the slot the GO has in the store
+  uint16_t go_level;
+  uint16_t health;
+  bool_t alive;
+  bool_t active;
+  bool_t gameover;
+  go_coord_t pos;
+  go_coord_t des_vel;
+  bool_t can_move;
+  go_coord_t acc;
+  superstateGO_t animstate;
+  bool_t move_left;
+  bool_t move_right;
+  bool_t crouch_or_extra;
+  bool_t shoot_or_pooh;
+  uint8_t numlives;
+  old_go_list_t *interactions;
+  void *task;
+  char taskText[32];
+  struct old_go_struct *pNext;
+  struct old_go_struct *pPrev;
+};
+typedef struct old_go_struct old_go_t;
+
+/* stack and TCB of a GO task: 256 words and then some */
+#define OLD_TASK_SIZE			(256 * 4 + 96)
+
+/* the GO lists, by kind */
+static old_go_t *old_gos[NUMBER_OF_GO_TYPES];
+
+/* a scene: per kind, how many of count GOs there are */
+static uint16_t scene[NUMBER_OF_GO_TYPES];
+
+/*
+ * function splits count GOs among the kinds in about the proportions of a
+ * busy game: the player, an eighth each aliens and expungers, a sixteenth
+ * each babies and kitties, and poohs the rest; within the pool
+ */
+static uint16_t
+prvSetScene (unsigned count)
+{
+  static const uint8_t sixteenths[NUMBER_OF_GO_TYPES] =
+    { 0, 2, 0, 2, 1, 1 };
+  unsigned rest = count > 1 ? count - 1 : 0;
+  uint16_t total = 0;
+
+  scene[player] = 1;
+  scene[pooh] = rest;
+  for (int k = player; k != NUMBER_OF_GO_TYPES; ++k)
+    {
+      if (k != player && k != pooh)
+	{
+	  scene[k] = rest * sixteenths[k] / 16 ? rest * sixteenths[k] / 16 : 1;
+	  scene[pooh] -= scene[k] < scene[pooh] ? scene[k] : scene[pooh];
+	}
+    }
+  for (int k = player; k != NUMBER_OF_GO_TYPES; ++k)
+    {
+      if (scene[k] > goKindBase[k + 1] - goKindBase[k])
+	scene[k] = goKindBase[k + 1] - goKindBase[k];
+      total += scene[k];
+    }
+  return total;
+}
+
+/*
+ * function fills the store with the scene, every GO somewhere on the field
+ * and moving the way its kind moves
+ */
+static void
+prvPopulate (go_store_t *gos, uint32_t seed)
+{
+  uint32_t rng;
+
+  prngSeed (&rng, seed);
+  goStoreInit (gos);
+  for (int k = player; k != NUMBER_OF_GO_TYPES; ++k)
+    for (uint16_t i = 0; i != scene[k]; ++i)
+      {
+	go_coord_t pos =
+	  { prngNext (&rng) % (XRIGHT + 1), prngNext (&rng) % (YBOTTOM + 1) };
+	go_slot_t s = goSpawn (gos, k, pos, 1, 1);
+	int16_t v = (prngNext (&rng) & 1) ? 1 : -1;
+
+	if (k == pooh)
+	  gos->vy[s] = POOH_SPEED;
+	else if (k == expunger)
+	  gos->vy[s] = -EXPUNGER_SPEED;
+	else
+	  gos->vx[s] = v;
+      }
+}
+
+/*
+ * function moves a GO by its velocity, turning it around at the borders
+ */
+static void
+prvBounce (go_store_t *gos, go_slot_t s)
+{
+  int16_t x = gos->x[s] + gos->vx[s];
+  int16_t y = gos->y[s] + gos->vy[s];
+
+  if (x < XLEFT || x > XRIGHT)
+    {
+      gos->vx[s] = -gos->vx[s];
+      x = gos->x[s] + gos->vx[s];
+    }
+  if (y < YTOP || y > YBOTTOM)
+    {
+      gos->vy[s] = -gos->vy[s];
+      y = gos->y[s] + gos->vy[s];
+    }
+  goMove (gos, s, x, y);
+}
+
+/*
+ * function is the move and proximity part of gameStep()
+ */
+static void
+prvFrame (go_store_t *gos, enum method m)
+{
+  void
+  (*proximities) (go_store_t*, go_slot_t, gotype_t) =
+      m == GAME ? prvComputeProximities :
+      m == GRID ? prvGridProximities : prvScanProximities;
+
+  for (go_slot_t s = 0; s != GO_POOL_SIZE; ++s)
+    {
+      gos->seen[s] = 0;
+      gos->hits[s] = 0;
+      if (goIsAlive (gos, s))
+	prvBounce (gos, s);
+    }
+  for (go_slot_t s = goKindBase[alien]; s != goKindBase[alien + 1]; ++s)
+    if (goIsAlive (gos, s))
+      {
+	proximities (gos, s, expunger);
+	proximities (gos, s, kitty);
+      }
+  for (go_slot_t s = goKindBase[player]; s != goKindBase[player + 1]; ++s)
+    if (goIsAlive (gos, s))
+      {
+	proximities (gos, s, pooh);
+	proximities (gos, s, kitty);
+	proximities (gos, s, baby);
+      }
+  for (go_slot_t s = goKindBase[baby]; s != goKindBase[kitty + 1]; ++s)
+    if (goIsAlive (gos, s))
+      proximities (gos, s, pooh);
+}
+
+/*
+ * function builds the GO lists from the store: the GOs are spawned in a
+ * random order of kinds, as they are during a game, and each node is
+ * followed on the heap by the stack of its task
+ */
+static void
+prvListBuild (const go_store_t *gos, uint32_t seed)
+{
+  static go_slot_t order[GO_POOL_SIZE];
+  old_go_t *tail[NUMBER_OF_GO_TYPES] = { NULL };
+  uint16_t n = 0;
+  uint32_t rng;
+
+  for (go_slot_t s = 0; s != GO_POOL_SIZE; ++s)
+    if (goIsAlive (gos, s))
+      order[n++] = s;
+  prngSeed (&rng, seed ^ 0x9E3779B9UL);
+  for (uint16_t i = n; i > 1; --i)
+    {
+      uint16_t j = prngNext (&rng) % i;
+      go_slot_t t = order[i - 1];
+
+      order[i - 1] = order[j];
+      order[j] = t;
+    }
+
+  for (int k = 0; k != NUMBER_OF_GO_TYPES; ++k)
+    old_gos[k] = NULL;
+  for (uint16_t i = 0; i != n; ++i)
+    {
+      go_slot_t s = order[i];
+      gotype_t k = gos->kind[s];
+      old_go_t *pNew = calloc (1, sizeof(old_go_t));
+
+      pNew->kind = k;
+      pNew->ID = s;
+      pNew->alive = True;
+      pNew->pos = goPosition (gos, s);
+      pNew->des_vel.X = gos->vx[s];
+      pNew->des_vel.Y = gos->vy[s];
+      pNew->task = malloc (OLD_TASK_SIZE);
+      snprintf (pNew->taskText, sizeof(pNew->taskText), "GO %u", s);
+      pNew->pPrev = tail[k];
+      if (tail[k] != NULL)
+	tail[k]->pNext = pNew;
+      else
+	old_gos[k] = pNew;
+      tail[k] = pNew;
+    }
+}
+
+static void
+prvListFree (void)
+{
+  for (int k = 0; k != NUMBER_OF_GO_TYPES; ++k)
+    while (old_gos[k] != NULL)
+      {
+	old_go_t *pW = old_gos[k];
+
+	while (pW->interactions != NULL)
+	  {
+	    old_go_list_t *pI = pW->interactions;
+
+	    pW->interactions = pI->pNext;
+	    free (pI);
+	  }
+	old_gos[k] = pW->pNext;
+	free (pW->task);
+	free (pW);
+      }
+}
+
+/*
+ * function is prvUpdateInteractionList() of the old vImpactsTask(): the
+ * object is looked up in the subject's interaction list, added when it
+ * comes into sight, and removed when it is out of sight
+ */
+static void
+prvListUpdate (old_go_t *pSub, const old_go_t *pObj, uint16_t distance,
+	       bool_t collision, bool_t seen)
+{
+  old_go_list_t *pW = pSub->interactions;
+  old_go_list_t *pLast = NULL;
+
+  while (pW != NULL && pW->ID != pObj->ID)
+    {
+      pLast = pW;
+      pW = pW->pNext;
+    }
+  if (pW == NULL)
+    {
+      if (!seen)
+	return;
+      pW = malloc (sizeof(old_go_list_t));
+      pW->kind = pObj->kind;
+      pW->ID = pObj->ID;
+      pW->pNext = NULL;
+      pW->pPrev = pLast;
+      if (pLast != NULL)
+	pLast->pNext = pW;
+      else
+	pSub->interactions = pW;
+    }
+  else if (!seen && !collision)
+    {
+      if (pW->pPrev != NULL)
+	pW->pPrev->pNext = pW->pNext;
+      else
+	pSub->interactions = pW->pNext;
+      if (pW->pNext != NULL)
+	pW->pNext->pPrev = pW->pPrev;
+      free (pW);
+      return;
+    }
+  pW->distance = distance;
+  pW->seen = seen;
+  pW->collision = collision;
+}
+
+static void
+prvListProximities (old_go_t *pSubject, const old_go_t *pObject)
+{
+  for (const old_go_t *pW = pObject; pW != NULL; pW = pW->pNext)
+    {
+      uint16_t distance = uiCompareGODistance (pSubject->pos, pW->pos);
+
+      if (distance <= THRESHOLD_COLLISION)
+	prvListUpdate (pSubject, pW, distance, True, True);
+      else if (distance <= THRESHOLD_SEEN)
+	prvListUpdate (pSubject, pW, distance, False, True);
+      else
+	prvListUpdate (pSubject, pW, distance, False, False);
+    }
+}
+
+/*
+ * function is prvFrame() on the GO lists
+ */
+static void
+prvListFrame (void)
+{
+  old_go_t *pW;
+
+  for (int k = 0; k != NUMBER_OF_GO_TYPES; ++k)
+    for (pW = old_gos[k]; pW != NULL; pW = pW->pNext)
+      {
+	int16_t x = pW->pos.X + pW->des_vel.X;
+	int16_t y = pW->pos.Y + pW->des_vel.Y;
+
+	if (x < XLEFT || x > XRIGHT)
+	  {
+	    pW->des_vel.X = -pW->des_vel.X;
+	    x = pW->pos.X + pW->des_vel.X;
+	  }
+	if (y < YTOP || y > YBOTTOM)
+	  {
+	    pW->des_vel.Y = -pW->des_vel.Y;
+	    y = pW->pos.Y + pW->des_vel.Y;
+	  }
+	pW->pos.X = x;
+	pW->pos.Y = y;
+      }
+  for (pW = old_gos[alien]; pW != NULL; pW = pW->pNext)
+    {
+      prvListProximities (pW, old_gos[expunger]);
+      prvListProximities (pW, old_gos[kitty]);
+    }
+  for (pW = old_gos[player]; pW != NULL; pW = pW->pNext)
+    {
+      prvListProximities (pW, old_gos[pooh]);
+      prvListProximities (pW, old_gos[kitty]);
+      prvListProximities (pW, old_gos[baby]);
+    }
+  for (pW = old_gos[baby]; pW != NULL; pW = pW->pNext)
+    prvListProximities (pW, old_gos[pooh]);
+  for (pW = old_gos[kitty]; pW != NULL; pW = pW->pNext)
+    prvListProximities (pW, old_gos[pooh]);
+}
+
+/*
+ * function puts what the interaction lists say into the masks of the
+ * store, for comparison
+ */
+static void
+prvListMasks (go_store_t *gos)
+{
+  memset (gos->seen, 0, sizeof(gos->seen));
+  memset (gos->hits, 0, sizeof(gos->hits));
+  for (int k = 0; k != NUMBER_OF_GO_TYPES; ++k)
+    for (const old_go_t *pW = old_gos[k]; pW != NULL; pW = pW->pNext)
+      for (const old_go_list_t *pI = pW->interactions; pI != NULL;
+	  pI = pI->pNext)
+	{
+	  gos->seen[pW->ID] |= pI->seen << pI->kind;
+	  gos->hits[pW->ID] |= pI->collision << pI->kind;
+	}
+}
+
+/*
+ * function hashes the masks a frame found, FNV-1a
+ */
+static uint32_t
+prvMaskHash (uint32_t h, const go_store_t *gos)
+{
+  for (go_slot_t s = 0; s != GO_POOL_SIZE; ++s)
+    {
+      h = (h ^ gos->seen[s]) * 16777619UL;
+      h = (h ^ gos->hits[s]) * 16777619UL;
+    }
+  return h;
+}
+
+static uint64_t
+prvNow (void)
+{
+  struct timespec t;
+
+  clock_gettime (CLOCK_MONOTONIC, &t);
+  return t.tv_sec * 1000000000ULL + t.tv_nsec;
+}
+
+/*
+ * function runs frames frames of the scene with method m; returns the mean
+ * time of a frame in ns, and the hash of every mask found in *hash
+ */
+static double
+prvRun (enum method m, uint32_t seed, unsigned long frames, uint32_t *hash,
+	unsigned long *contacts)
+{
+  static go_store_t gos;
+  uint64_t ns = 0;
+
+  prvPopulate (&gos, seed);
+  if (m == LIST)
+    prvListBuild (&gos, seed);
+  *hash = 2166136261UL;
+  *contacts = 0;
+  for (unsigned long f = 0; f != frames; ++f)
+    {
+      uint64_t t0 = prvNow ();
+      if (m == LIST)
+	prvListFrame ();
+      else
+	prvFrame (&gos, m);
+      ns += prvNow () - t0;
+      if (m == LIST)
+	prvListMasks (&gos);
+      *hash = prvMaskHash (*hash, &gos);
+      for (go_slot_t s = 0; s != GO_POOL_SIZE; ++s)
+	*contacts += gos.hits[s] != 0;
+    }
+  if (m == LIST)
+    prvListFree ();
+  return (double) ns / frames;
+}
+
+static int
+prvUsage (const char *name)
+{
+  fprintf (stderr, "usage: %s [-s seed] [-f frames] [count...]\n", name);
+  return 1;
+}
+
+int
+main (int argc, char *argv[])
+{
+  static unsigned counts[64] =
+    { 21, 50, 100, 200, 400, 800 };
+  unsigned number_of_counts = 6;
+  unsigned long frames = 2000;
+  uint32_t seed = PRNG_DEFAULT_SEED;
+  int opt, failed = 0;
+
+  while ((opt = getopt (argc, argv, "s:f:")) != -1)
+    {
+      switch (opt)
+	{
+	case 's':
+	  seed = strtoul (optarg, NULL, 0);
+	  break;
+	case 'f':
+	  frames = strtoul (optarg, NULL, 0);
+	  break;
+	default:
+	  return prvUsage (argv[0]);
+	}
+    }
+  if (frames == 0 || argc - optind > 64)
+    return prvUsage (argv[0]);
+  if (optind != argc)
+    {
+      number_of_counts = argc - optind;
+      for (unsigned i = 0; i != number_of_counts; ++i)
+	counts[i] = strtoul (argv[optind + i], NULL, 0);
+    }
+
+  printf ("GO pool %u, grid %ux%u cells of %u for kinds of %u slots or more, "
+	  "%lu frames, ns per frame\n", GO_POOL_SIZE, GRID_COLS, GRID_ROWS,
+	  GRID_CELL_SIZE, GRID_MIN_SLOTS, frames);
+  printf ("%6s %9s", "GOs", "contacts");
+  for (int m = 0; m != NUMBER_OF_METHODS; ++m)
+    printf (" %10s", method_name[m]);
+  printf ("\n");
+  for (unsigned i = 0; i != number_of_counts; ++i)
+    {
+      uint16_t total = prvSetScene (counts[i]);
+      uint32_t hash[NUMBER_OF_METHODS];
+      unsigned long contacts[NUMBER_OF_METHODS];
+      double ns[NUMBER_OF_METHODS];
+
+      for (int m = 0; m != NUMBER_OF_METHODS; ++m)
+	ns[m] = prvRun (m, seed, frames, &hash[m], &contacts[m]);
+      printf ("%6u %9.1f", total, (double) contacts[GAME] / frames);
+      for (int m = 0; m != NUMBER_OF_METHODS; ++m)
+	printf (" %10.0f", ns[m]);
+      printf ("\n");
+      for (int m = 1; m != NUMBER_OF_METHODS; ++m)
+	if (hash[m] != hash[GAME])
+	  {
+	    printf ("FAILED: %s and %s find different GOs with %u GOs\n",
+		    method_name[GAME], method_name[m], total);
+	    failed = 1;
+	  }
+    }
+  return failed;
+}
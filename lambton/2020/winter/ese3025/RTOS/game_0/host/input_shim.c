@@ -0,0 +1,303 @@
+/*
+ * input_shim.c
+ *
+ * The buttons of game_0 without the board: a script of raw pin edges goes
+ * through the same debouncer and latch as the GPIO interrupts feed on the
+ * board (libgameinput), on a virtual microsecond clock, and the buttons
+ * the game loop would have seen at each step are written out as a
+ * recording for game_sim to replay.
+ *
+ *	gcc -std=gnu99 -O2 -Wall -I../inc -o input_shim input_shim.c \
+ *	    ../source/libgameinput.c ../source/libgameds.c \
+ *	    ../source/libtakisbasics.c
+ *
+ *	./input_shim [-b bounces] [-w window_us] [-s seed] script [game.rec]
+ *		-b adds that many bounces after every edge of the script,
+ *		each one within a millisecond of the last; -w sets the
+ *		debounce window (5000 us, as on the board); -s seeds both the
+ *		bounces and the game of the recording
+ *
+ * Script, one edge per line, '#' starts a comment:
+ *
+ *	time_ms  left|right|crouch|fire  1|0	(1: pressed)
+ *
+ * The report gives the edges, the bounces the debouncer ignored, the
+ * events it let through, and the latency from an edge to the end of the
+ * game step that used it, which is when the board sends the screen.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "libgameds.h"
+#include "libgameinput.h"
+
+#define STEP_US				50000 // GAME_TICK_HZ 20
+#define DEFAULT_WINDOW_US		5000 // BUTTON_DEBOUNCE_US
+#define BOUNCE_SPREAD_US		1000
+#define TAIL_US				1000000 // run on after the last edge
+#define MAX_EDGES			65536
+
+#define REC_MAGIC			"G0IN"
+#define REC_VERSION			1
+#define REC_MAX_RUN			0xFFFF
+
+struct edge_struct
+{
+  uint32_t t; // microseconds
+  uint8_t button;
+  uint8_t level;
+};
+typedef struct edge_struct edge_t;
+
+static edge_t edges[MAX_EDGES];
+static size_t number_of_edges = 0;
+
+static const char *button_name[NUMBER_OF_BUTTONS] =
+  { "left", "right", "crouch", "fire" };
+
+static void
+prvAddEdge (uint32_t t, uint8_t button, uint8_t level)
+{
+  if (number_of_edges == MAX_EDGES)
+    {
+      fprintf (stderr, "input_shim: too many edges\n");
+      exit (1);
+    }
+  edges[number_of_edges].t = t;
+  edges[number_of_edges].button = button;
+  edges[number_of_edges].level = level;
+  number_of_edges++;
+}
+
+static int
+prvCompareEdges (const void *a, const void *b)
+{
+  const edge_t *ea = a, *eb = b;
+
+  return (ea->t > eb->t) - (ea->t < eb->t);
+}
+
+/*
+ * function reads the script, adding bounces bounces after every edge
+ */
+static int
+prvReadScript (const char *path, unsigned bounces, uint32_t *rng)
+{
+  char line[128], name[16];
+  unsigned long ms;
+  unsigned level, lineno = 0;
+  uint8_t b;
+  FILE *f = fopen (path, "r");
+
+  if (f == NULL)
+    {
+      perror (path);
+      return 1;
+    }
+  while (fgets (line, sizeof(line), f) != NULL)
+    {
+      lineno++;
+      line[strcspn (line, "#")] = '\0';
+      if (sscanf (line, "%lu %15s %u", &ms, name, &level) != 3)
+	{
+	  if (strspn (line, " \t\r\n") != strlen (line))
+	    {
+	      fprintf (stderr, "%s:%u: time_ms button 1|0 expected\n", path,
+		       lineno);
+	      fclose (f);
+	      return 1;
+	    }
+	  continue;
+	}
+      for (b = 0; b != NUMBER_OF_BUTTONS && strcmp (name, button_name[b]);
+	  ++b)
+	;
+      if (b == NUMBER_OF_BUTTONS || level > 1)
+	{
+	  fprintf (stderr, "%s:%u: bad button or level\n", path, lineno);
+	  fclose (f);
+	  return 1;
+	}
+
+      /* the contact chatters, settling at the scripted level */
+      uint32_t t = ms * 1000;
+      prvAddEdge (t, b, level);
+      for (unsigned i = 0; i != bounces; ++i)
+	{
+	  t += 1 + prngNext (rng) % BOUNCE_SPREAD_US;
+	  prvAddEdge (t, b, !level);
+	  t += 1 + prngNext (rng) % BOUNCE_SPREAD_US;
+	  prvAddEdge (t, b, level);
+	}
+    }
+  fclose (f);
+  qsort (edges, number_of_edges, sizeof(edge_t), prvCompareEdges);
+  return 0;
+}
+
+static void
+prvPutRun (FILE *f, uint8_t buttons, unsigned long steps)
+{
+  uint8_t run[3];
+
+  while (steps != 0)
+    {
+      unsigned long n = (steps > REC_MAX_RUN) ? REC_MAX_RUN : steps;
+
+      run[0] = buttons;
+      run[1] = n;
+      run[2] = n >> 8;
+      fwrite (run, 1, sizeof(run), f);
+      steps -= n;
+    }
+}
+
+static void
+prvPrintEvent (const ui_event_t *ev)
+{
+  printf ("%10.3f ms ", ev->stamp / 1000.0);
+  for (uint8_t b = 0; b != NUMBER_OF_BUTTONS; ++b)
+    {
+      if (ev->changed & (1U << b))
+	{
+	  printf (" %s %s", button_name[b],
+		  (ev->buttons & (1U << b)) ? "down" : "up");
+	}
+    }
+  printf ("\n");
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t window = DEFAULT_WINDOW_US, seed = PRNG_DEFAULT_SEED, rng;
+  uint32_t now, next_step, deadline, end;
+  unsigned bounces = 0;
+  unsigned long steps = 0, run_steps = 0;
+  uint8_t raw = 0, run_buttons = 0, buttons;
+  size_t e = 0;
+  debouncer_t deb;
+  input_latch_t latch;
+  ui_event_t ev;
+  ui_t ui;
+  FILE *rec = NULL;
+  int opt;
+
+  while ((opt = getopt (argc, argv, "b:w:s:")) != -1)
+    {
+      switch (opt)
+	{
+	case 'b':
+	  bounces = strtoul (optarg, NULL, 0);
+	  break;
+	case 'w':
+	  window = strtoul (optarg, NULL, 0);
+	  break;
+	case 's':
+	  seed = strtoul (optarg, NULL, 0);
+	  break;
+	default:
+	  fprintf (stderr, "usage: %s [-b bounces] [-w window_us] [-s seed]"
+		   " script [game.rec]\n", argv[0]);
+	  return 2;
+	}
+    }
+  if (optind == argc || argc - optind > 2)
+    {
+      fprintf (stderr, "usage: %s [-b bounces] [-w window_us] [-s seed]"
+	       " script [game.rec]\n", argv[0]);
+      return 2;
+    }
+  prngSeed (&rng, seed ^ 0x85EBCA6BUL);
+  if (prvReadScript (argv[optind], bounces, &rng))
+    {
+      return 1;
+    }
+  if (optind + 1 < argc)
+    {
+      uint8_t header[9] =
+	{ 0, 0, 0, 0, REC_VERSION, seed, seed >> 8, seed >> 16, seed >> 24 };
+
+      rec = fopen (argv[optind + 1], "wb");
+      if (rec == NULL)
+	{
+	  perror (argv[optind + 1]);
+	  return 1;
+	}
+      memcpy (header, REC_MAGIC, 4);
+      fwrite (header, 1, sizeof(header), rec);
+    }
+
+  inputDebounceInit (&deb, window, 0);
+  inputLatchInit (&latch);
+  end = (number_of_edges ? edges[number_of_edges - 1].t : 0) + TAIL_US;
+
+  /* whichever comes first: an edge, a lock-out expiring, a game step */
+  for (now = 0, next_step = STEP_US; next_step <= end;)
+    {
+      uint32_t t = next_step;
+
+      if (e != number_of_edges && edges[e].t < t)
+	t = edges[e].t;
+      if (inputDebounceDeadline (&deb, &deadline) && deadline < t)
+	t = deadline;
+      now = t;
+
+      if (e != number_of_edges && edges[e].t == now)
+	{
+	  /* the GPIO interrupt */
+	  raw = (raw & ~(1U << edges[e].button))
+	      | (edges[e].level << edges[e].button);
+	  if (inputDebounceEdge (&deb, edges[e].button, edges[e].level, now,
+				 &ev))
+	    {
+	      inputLatchEvent (&latch, &ev);
+	      prvPrintEvent (&ev);
+	    }
+	  e++;
+	}
+      else if (inputDebounceDeadline (&deb, &deadline) && deadline == now)
+	{
+	  /* the RI timer interrupt */
+	  if (inputDebounceExpire (&deb, raw, now, &ev))
+	    {
+	      inputLatchEvent (&latch, &ev);
+	      prvPrintEvent (&ev);
+	    }
+	}
+      else
+	{
+	  /* the game loop: a step, then the screen */
+	  inputLatchStep (&latch, &ui);
+	  inputLatchShown (&latch, now);
+	  buttons = uiPack (&ui);
+	  if (run_steps != 0 && buttons != run_buttons)
+	    {
+	      if (rec != NULL)
+		prvPutRun (rec, run_buttons, run_steps);
+	      run_steps = 0;
+	    }
+	  run_buttons = buttons;
+	  run_steps++;
+	  steps++;
+	  next_step += STEP_US;
+	}
+    }
+  if (rec != NULL)
+    {
+      prvPutRun (rec, run_buttons, run_steps);
+      fclose (rec);
+    }
+
+  printf ("steps %lu, edges %lu, bounces ignored %lu, events %lu\n", steps,
+	  (unsigned long) deb.edges, (unsigned long) deb.bounces,
+	  (unsigned long) deb.events);
+  printf ("input to screen: %lu steps, mean %.1f ms, max %.1f ms\n",
+	  (unsigned long) latch.shown,
+	  latch.shown ? latch.total_latency / 1000.0 / latch.shown : 0.0,
+	  latch.max_latency / 1000.0);
+  return 0;
+}
@@ -0,0 +1,182 @@
+/*
+ * proto_bench.c
+ *
+ * Bandwidth of the game screen protocol (libgameproto): bytes per frame
+ * for a typical game, a game on a lossy link, a host that never
+ * acknowledges, and the worst case scene, with every slot taken and
+ * every GO changing on every step. Each frame is decoded again and the
+ * decoded screen checked against the game.
+ *
+ *	gcc -std=gnu99 -O2 -Wall -I../inc -o proto_bench proto_bench.c \
+ *	    ../source/libgameproto.c ../source/libgamecore.c \
+ *	    ../source/libgameds.c ../source/libtakisbasics.c
+ *	./proto_bench [steps]
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "libgameds.h"
+#include "libgamecore.h"
+#include "libgameproto.h"
+
+#define BENCH_TICK_HZ			20 // GAME_TICK_HZ in libgametasks.h
+#define BENCH_BAUD			115200
+#define BENCH_BITS_PER_BYTE		10 // 8N1
+/* what a text command per GO, e.g. "G:17,063,031,04\r\n", would take */
+#define TEXT_BYTES_PER_GO		17
+
+enum scene
+{
+  TYPICAL, LOSSY, NO_ACKS, WORST_CASE
+};
+
+static const char * const scene_name[] =
+  { "typical", "lossy (1 in 4 lost)", "never acknowledged", "worst case" };
+
+/*
+ * function plays the game with random buttons, starting a new round when
+ * the player dies
+ */
+static void
+prvStepGame (game_t *game)
+{
+  if (!goIsAlive (&game->gos, game->player))
+    {
+      gameClear (game);
+      gameStartRound (game, PLAYER_LIVES);
+    }
+  game->user.left_button = (rand () % 8 == 0) ? True : False;
+  game->user.right_button = (rand () % 8 == 0) ? True : False;
+  game->user.fire_button = (rand () % 4 == 0) ? True : False;
+  game->user.crouch_button = False;
+  gameStep (game);
+}
+
+/*
+ * function fills every slot and moves every GO, and changes its state, on
+ * every step
+ */
+static void
+prvStepWorstCase (game_t *game)
+{
+  go_store_t *gos = &game->gos;
+
+  for (go_slot_t s = 0; s != GO_POOL_SIZE; ++s)
+    {
+      if (!goIsAlive (gos, s))
+	{
+	  go_coord_t pos =
+	    { (s * 7) % (XRIGHT + 1), (s * 3) % (YBOTTOM + 1) };
+	  goSpawn (gos, (gotype_t) gos->kind[s], pos, 1, 1);
+	}
+      goMove (gos, s, (gos->x[s] + 1) % (XRIGHT + 1),
+	      (gos->y[s] + 1) % (YBOTTOM + 1));
+      gos->animstate[s] = (gos->animstate[s] + 1) % (SELFCLEAN3 + 1);
+    }
+}
+
+/*
+ * function checks the decoded screen against the game
+ */
+static int
+prvCheck (const proto_decoder_t *dec, const go_store_t *gos)
+{
+  for (go_slot_t s = 0; s != GO_POOL_SIZE; ++s)
+    {
+      const proto_go_t *go = &dec->screen[s];
+
+      if (go->alive != goIsAlive (gos, s)
+	  || (go->alive
+	      && (go->x != gos->x[s] || go->y != gos->y[s]
+		  || go->state != gos->animstate[s])))
+	{
+	  return 0;
+	}
+    }
+  return 1;
+}
+
+static void
+prvRun (enum scene scene, unsigned long steps)
+{
+  static game_t game;
+  static proto_encoder_t enc;
+  static proto_decoder_t dec;
+  uint8_t frame[PROTO_MAX_FRAME], ack[PROTO_ACK_SIZE];
+  unsigned long text_bytes = 0, mismatches = 0, delivered = 0;
+  uint16_t len, ack_len;
+  double per_step;
+
+  srand (1);
+  gameInit (&game);
+  if (scene == WORST_CASE)
+    {
+      /* every slot gets its own kind, spawned by prvStepWorstCase() */
+      for (gotype_t k = player; k != NUMBER_OF_GO_TYPES; ++k)
+	for (go_slot_t s = goKindBase[k]; s != goKindBase[k + 1]; ++s)
+	  game.gos.kind[s] = k;
+    }
+  else
+    {
+      gameStartRound (&game, PLAYER_LIVES);
+    }
+  protoEncoderInit (&enc);
+  protoDecoderInit (&dec);
+
+  for (unsigned long i = 0; i != steps; ++i)
+    {
+      if (scene == WORST_CASE)
+	prvStepWorstCase (&game);
+      else
+	prvStepGame (&game);
+
+      for (int k = 0; k != NUMBER_OF_GO_TYPES; ++k)
+	text_bytes += game.gos.number_alive[k] * TEXT_BYTES_PER_GO;
+
+      len = protoEncodeFrame (&enc, &game.gos, frame);
+      if (len == 0 || (scene == LOSSY && rand () % 4 == 0))
+	continue; // nothing to send, or lost on the way
+      for (uint16_t b = 0; b != len; ++b)
+	{
+	  if (protoDecodeByte (&dec, frame[b]) != PROTO_FRAME)
+	    continue;
+	  delivered++;
+	  mismatches += !prvCheck (&dec, &game.gos);
+	  ack_len = protoMakeAck (dec.seq, ack);
+	  if (scene == NO_ACKS || (scene == LOSSY && rand () % 4 == 0))
+	    continue;
+	  if (ack_len == PROTO_ACK_SIZE && (ack[1] ^ ack[2]) == 0xFF)
+	    protoEncoderAck (&enc, ack[1]);
+	}
+    }
+
+  per_step = (double) enc.stats.bytes / steps;
+  printf ("%-20s %8lu %8lu %8lu %9.2f %7lu %9.2f %6.1f%% %8lu\n",
+	  scene_name[scene], steps, (unsigned long) enc.stats.frames,
+	  (unsigned long) enc.stats.full_frames, per_step,
+	  (unsigned long) enc.stats.max_frame_bytes, (double) text_bytes / steps,
+	  100.0 * per_step * BENCH_TICK_HZ * BENCH_BITS_PER_BYTE / BENCH_BAUD,
+	  mismatches);
+  if (delivered != dec.stats.frames)
+    printf ("    %lu frames were not applied\n",
+	    delivered - (unsigned long) dec.stats.frames);
+}
+
+int
+main (int argc, char *argv[])
+{
+  unsigned long steps = (argc > 1) ? strtoul (argv[1], NULL, 0) : 20000;
+
+  printf ("frame budget at %d Hz and %d baud: %d bytes, transmit ring: %d\n\n",
+	  BENCH_TICK_HZ, BENCH_BAUD,
+	  BENCH_BAUD / BENCH_BITS_PER_BYTE / BENCH_TICK_HZ, 128);
+  printf ("%-20s %8s %8s %8s %9s %7s %9s %7s %8s\n", "scene", "steps",
+	  "frames", "full", "bytes/st", "max", "text/st", "link", "mismatch");
+  for (enum scene scene = TYPICAL; scene <= WORST_CASE; ++scene)
+    {
+      prvRun (scene, steps);
+    }
+  return 0;
+}
@@ -0,0 +1,177 @@
+/*
+ * screen_host.c
+ *
+ * Host end of the game screen protocol (libgameproto): reads the game's
+ * UART, draws the playing field in a terminal, and acknowledges every
+ * frame so the game can keep its frames small.
+ *
+ *	gcc -std=gnu99 -O2 -Wall -I../inc -o screen_host screen_host.c \
+ *	    ../source/libgameproto.c ../source/libgameds.c
+ *
+ *	./screen_host /dev/ttyUSB0	the LPCXpresso UART3, 115200 8N1
+ *	./screen_host - < uart.bin	a capture, nothing is acknowledged
+ *
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include "libgameds.h"
+#include "libgameproto.h"
+
+/* the 128 x 64 field is drawn at half resolution */
+#define COLS				((XRIGHT + 2) / 2)
+#define ROWS				((YBOTTOM + 2) / 2)
+
+static const char glyph[NUMBER_OF_GO_TYPES] =
+  { 'P', 'A', 'o', '|', 'b', 'k' };
+
+/*
+ * function finds the kind of GO a slot belongs to
+ */
+static gotype_t
+prvKindOf (go_slot_t slot)
+{
+  gotype_t kind = player;
+
+  while (slot >= goKindBase[kind + 1])
+    {
+      kind++;
+    }
+  return kind;
+}
+
+/*
+ * function puts the serial port in raw mode at 115200 baud
+ */
+static int
+prvOpenSerial (const char *path)
+{
+  struct termios tio;
+  int fd = open (path, O_RDWR | O_NOCTTY);
+
+  if (fd < 0)
+    {
+      perror (path);
+      exit (1);
+    }
+  if (tcgetattr (fd, &tio) == 0)
+    {
+      cfmakeraw (&tio);
+      cfsetispeed (&tio, B115200);
+      cfsetospeed (&tio, B115200);
+      tio.c_cc[VMIN] = 1;
+      tio.c_cc[VTIME] = 0;
+      tcsetattr (fd, TCSANOW, &tio);
+    }
+  return fd;
+}
+
+/*
+ * function draws the screen held by the decoder
+ */
+static void
+prvDraw (const proto_decoder_t *dec, const char *message)
+{
+  static char field[ROWS][COLS + 1];
+
+  for (int r = 0; r != ROWS; ++r)
+    {
+      memset (field[r], ' ', COLS);
+      field[r][COLS] = '\0';
+    }
+  for (go_slot_t s = 0; s != GO_POOL_SIZE; ++s)
+    {
+      const proto_go_t *go = &dec->screen[s];
+
+      if (go->alive && go->x / 2 < COLS && go->y / 2 < ROWS)
+	{
+	  field[go->y / 2][go->x / 2] = glyph[prvKindOf (s)];
+	}
+    }
+
+  printf ("\033[H+");
+  for (int c = 0; c != COLS; ++c)
+    putchar ('-');
+  printf ("+\n");
+  for (int r = 0; r != ROWS; ++r)
+    {
+      printf ("|%s|\n", field[r]);
+    }
+  printf ("+");
+  for (int c = 0; c != COLS; ++c)
+    putchar ('-');
+  printf ("+\n%-*s\n", COLS + 2, message);
+  printf ("frame %3u  frames %lu (%lu full)  %.1f bytes/frame, max %lu"
+	  "  crc errors %lu  missing base %lu\033[K\n",
+	  dec->seq, (unsigned long) dec->stats.frames,
+	  (unsigned long) dec->stats.full_frames,
+	  dec->stats.frames ? (double) dec->stats.bytes / dec->stats.frames : 0.0,
+	  (unsigned long) dec->stats.max_frame_bytes,
+	  (unsigned long) dec->stats.crc_errors,
+	  (unsigned long) dec->stats.missing_base);
+  fflush (stdout);
+}
+
+int
+main (int argc, char *argv[])
+{
+  static proto_decoder_t dec;
+  char message[sizeof(dec.text)] = "";
+  uint8_t buf[256], ack[PROTO_ACK_SIZE];
+  int fd, ack_fd;
+  ssize_t n;
+
+  if (argc != 2)
+    {
+      fprintf (stderr, "usage: %s /dev/ttyXXX | -\n", argv[0]);
+      return 1;
+    }
+  if (strcmp (argv[1], "-") == 0)
+    {
+      fd = STDIN_FILENO;
+      ack_fd = -1;
+    }
+  else
+    {
+      fd = ack_fd = prvOpenSerial (argv[1]);
+    }
+
+  protoDecoderInit (&dec);
+  printf ("\033[2J");
+  while ((n = read (fd, buf, sizeof(buf))) > 0)
+    {
+      for (ssize_t i = 0; i != n; ++i)
+	{
+	  switch (protoDecodeByte (&dec, buf[i]))
+	    {
+	    case PROTO_FRAME:
+	      if (ack_fd >= 0
+		  && write (ack_fd, ack, protoMakeAck (dec.seq, ack)) < 0)
+		{
+		  perror ("ack");
+		}
+	      prvDraw (&dec, message);
+	      break;
+	    case PROTO_TEXT:
+	      if (strcmp (dec.text, "C:clc") == 0)
+		{
+		  printf ("\033[2J");
+		  message[0] = '\0';
+		}
+	      else if (strncmp (dec.text, "D:", 2) == 0)
+		{
+		  strcpy (message, dec.text + 2);
+		}
+	      prvDraw (&dec, message);
+	      break;
+	    default:
+	      break;
+	    }
+	}
+    }
+  return 0;
+}
@@ -0,0 +1,224 @@
+/*
+ * sfx_gen.c
+ *
+ * Makes the sound effects of game_0 and writes them out as C source, for
+ * source/libgamesounds.c. The effects are synthesized, so they can be
+ * changed here, and kept small: the short one as 8-bit PCM, the others as
+ * IMA ADPCM, at half the size.
+ *
+ *	gcc -std=gnu99 -O2 -Wall -I../inc -o sfx_gen sfx_gen.c -lm
+ *	./sfx_gen > ../source/libgamesounds.c
+ *
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "libgameaudio.h"
+
+#define MAX_SAMPLES			(AUDIO_SAMPLE_RATE * 2)
+
+static const int16_t adpcm_step[89] =
+  { 7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41,
+      45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190,
+      209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724,
+      796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272,
+      2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132,
+      7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500,
+      20350, 22385, 24623, 27086, 29794, 32767 };
+static const int8_t adpcm_index[8] =
+  { -1, -1, -1, -1, 2, 4, 6, 8 };
+
+static double wave[MAX_SAMPLES]; // -1 to 1
+static uint8_t data[MAX_SAMPLES];
+static uint32_t noise = 0x2545F491UL;
+
+static double
+prvNoise (void)
+{
+  noise ^= noise << 13;
+  noise ^= noise >> 17;
+  noise ^= noise << 5;
+  return noise / 2147483648.0 - 1.0;
+}
+
+/*
+ * the effects: n samples each, into wave
+ */
+static int
+prvFire (void)
+{
+  int n = AUDIO_SAMPLE_RATE / 10;
+  double phase = 0;
+
+  /* a square chirp, 1200 Hz down to 400 Hz */
+  for (int i = 0; i != n; ++i)
+    {
+      double t = (double) i / n;
+      phase += (1200 - 800 * t) / AUDIO_SAMPLE_RATE;
+      wave[i] = (fmod (phase, 1.0) < 0.5 ? 0.7 : -0.7) * (1 - t);
+    }
+  return n;
+}
+
+static int
+prvHit (void)
+{
+  int n = AUDIO_SAMPLE_RATE * 12 / 100;
+  double lp = 0;
+
+  /* a thud: low-passed noise, dying away fast */
+  for (int i = 0; i != n; ++i)
+    {
+      double t = (double) i / n;
+      lp += 0.3 * (prvNoise () - lp);
+      wave[i] = 1.6 * lp * exp (-5 * t);
+    }
+  return n;
+}
+
+static int
+prvAlienDown (void)
+{
+  int n = AUDIO_SAMPLE_RATE * 4 / 10;
+  double phase = 0;
+
+  /* a falling triangle, 700 Hz to 80 Hz, with some grit */
+  for (int i = 0; i != n; ++i)
+    {
+      double t = (double) i / n;
+      phase += (700 * pow (80.0 / 700, t)) / AUDIO_SAMPLE_RATE;
+      double tri = 4 * fabs (fmod (phase, 1.0) - 0.5) - 1;
+      wave[i] = (0.6 * tri + 0.15 * prvNoise ()) * (1 - t * t);
+    }
+  return n;
+}
+
+static int
+prvPlayerDown (void)
+{
+  static const double note[3] =
+    { 392.0, 311.1, 261.6 }; // G4 Eb4 C4
+  int per = AUDIO_SAMPLE_RATE / 5, n = 3 * per;
+  double phase = 0;
+
+  /* three sad notes, the last one sagging */
+  for (int i = 0; i != n; ++i)
+    {
+      int k = i / per;
+      double t = (double) (i % per) / per;
+      double f = note[k] * (k == 2 ? 1 - 0.2 * t : 1);
+      phase += f / AUDIO_SAMPLE_RATE;
+      wave[i] = 0.5 * sin (2 * M_PI * phase)
+	  + 0.2 * sin (4 * M_PI * phase) * (1 - t);
+      wave[i] *= (t < 0.05 ? t / 0.05 : 1) * (k == 2 ? 1 - t : 0.9);
+    }
+  return n;
+}
+
+/*
+ * encoders, returning the bytes of data
+ */
+static int
+prvEncodePCM8 (int n)
+{
+  for (int i = 0; i != n; ++i)
+    {
+      long s = lround (wave[i] * 127);
+      data[i] = (uint8_t) (int8_t) (s > 127 ? 127 : s < -127 ? -127 : s);
+    }
+  return n;
+}
+
+static int
+prvEncodeADPCM (int n)
+{
+  int predictor = 0, index = 0;
+
+  memset (data, 0, (n + 1) / 2);
+  for (int i = 0; i != n; ++i)
+    {
+      long s = lround (wave[i] * 32767);
+      int step = adpcm_step[index], diff, code = 0, delta;
+
+      if (s > 32767)
+	s = 32767;
+      else if (s < -32768)
+	s = -32768;
+      diff = s - predictor;
+      if (diff < 0)
+	{
+	  code = 8;
+	  diff = -diff;
+	}
+      /* the same arithmetic as the decoder, so they stay in step */
+      delta = step >> 3;
+      if (diff >= step)
+	{
+	  code |= 4;
+	  diff -= step;
+	  delta += step;
+	}
+      if (diff >= step >> 1)
+	{
+	  code |= 2;
+	  diff -= step >> 1;
+	  delta += step >> 1;
+	}
+      if (diff >= step >> 2)
+	{
+	  code |= 1;
+	  delta += step >> 2;
+	}
+      predictor += (code & 8) ? -delta : delta;
+      if (predictor > 32767)
+	predictor = 32767;
+      else if (predictor < -32768)
+	predictor = -32768;
+      index += adpcm_index[code & 7];
+      if (index < 0)
+	index = 0;
+      else if (index > 88)
+	index = 88;
+      data[i >> 1] |= (i & 1) ? code << 4 : code;
+    }
+  return (n + 1) / 2;
+}
+
+static void
+prvWriteSound (const char *name, int (*make) (void), sound_format_t format)
+{
+  int n = make ();
+  int bytes = (format == SOUND_ADPCM) ? prvEncodeADPCM (n) : prvEncodePCM8 (n);
+
+  printf ("\nstatic const uint8_t %s_data[%d] =\n  {", name, bytes);
+  for (int i = 0; i != bytes; ++i)
+    {
+      printf ("%s0x%02X%s", (i == 0 || i % 12) ? " " : "\n      ", data[i],
+	      (i + 1 == bytes) ? "" : ",");
+    }
+  printf (" };\nconst sound_t %s =\n  { %s, %d, %s_data };\n", name,
+	  (format == SOUND_ADPCM) ? "SOUND_ADPCM" : "SOUND_PCM8", n, name);
+}
+
+int
+main (void)
+{
+  printf ("/*\n"
+	  " * libgamesounds.c\n"
+	  " *\n"
+	  " * Game Sounds Library\n"
+	  " *\n"
+	  " * The sound effects, %d samples a second, see libgamesounds.h.\n"
+	  " * Made by host/sfx_gen, do not edit.\n"
+	  " *\n"
+	  " */\n\n"
+	  "#include \"libgameaudio.h\"\n"
+	  "#include \"libgamesounds.h\"\n", AUDIO_SAMPLE_RATE);
+  prvWriteSound ("sfxFire", prvFire, SOUND_PCM8);
+  prvWriteSound ("sfxHit", prvHit, SOUND_ADPCM);
+  prvWriteSound ("sfxAlienDown", prvAlienDown, SOUND_ADPCM);
+  prvWriteSound ("sfxPlayerDown", prvPlayerDown, SOUND_ADPCM);
+  return 0;
+}
@@ -76,11 +76,11 @@
 #define configCPU_CLOCK_HZ			( ( unsigned long ) SystemCoreClock )
 #define configTICK_RATE_HZ			( ( portTickType ) 10000 )
 #define configMINIMAL_STACK_SIZE	( ( unsigned short ) 128 )
-#ifdef __CODE_RED
-#define configTOTAL_HEAP_SIZE		( ( size_t ) ( 16*1024 ) )
-#else
-#define configTOTAL_HEAP_SIZE		( ( size_t ) ( 0 ) )
-#endif
+/* heap_slab.c places the heap in the 32K AHB SRAM (RAM2) with the Code Red
+tools and in .bss elsewhere, a quarter of it is cut into slab pages for small
+objects.  Plain numbers, heap_slab.c checks them with #if. */
+#define configTOTAL_HEAP_SIZE		( 28*1024 )
+#define configSLAB_HEAP_SIZE		( 7*1024 )
 #define configMAX_TASK_NAME_LEN		( 20 )
 #define configUSE_TRACE_FACILITY	1
 #define configUSE_16_BIT_TICKS		0
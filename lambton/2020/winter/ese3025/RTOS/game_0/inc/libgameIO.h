@@ -8,6 +8,13 @@
 #ifndef LIBGAMEIO_H_
 #define LIBGAMEIO_H_
 
+#include "chip.h"
+#include "FreeRTOS.h"
+#include "libgameaudio.h"
+#include "libgameds.h"
+#include "libgameinput.h"
+#include "libgameproto.h"
+
 /********************************************************************
  * UART Comm Setup
  ********************************************************************/
@@ -19,4 +26,79 @@
 #define UART_SRB_SIZE 128	/* Send */
 #define UART_RRB_SIZE 32	/* Receive */
 
+/* Transmit and receive ring buffers, set up by prvSetupHardware() */
+extern RINGBUFF_T txring, rxring;
+extern uint8_t rxbuff[UART_RRB_SIZE], txbuff[UART_SRB_SIZE];
+
+/********************************************************************
+ * Screen Updates
+ ********************************************************************/
+void
+sendUARTText (const char tx_text[]);
+void
+sendUARTScreen (const go_store_t *store);
+void
+resetUARTScreen (void);
+void
+getUARTScreenStats (proto_stats_t *stats);
+
+/********************************************************************
+ * Buttons
+ ********************************************************************/
+/*
+ * the buttons pull their pins low, against the internal pull-ups; both
+ * edges interrupt, through EINT3, and are stamped with the RI timer, which
+ * otherwise runs free
+ */
+#define BUTTON_PORT		2
+#define BUTTON_INT_PORT		GPIOINT_PORT2
+#define BUTTON_LEFT_PIN		3
+#define BUTTON_RIGHT_PIN	4
+#define BUTTON_CROUCH_PIN	5
+#define BUTTON_FIRE_PIN		6
+#define BUTTON_PINS		((1 << BUTTON_LEFT_PIN) | (1 << BUTTON_RIGHT_PIN) \
+				 | (1 << BUTTON_CROUCH_PIN) | (1 << BUTTON_FIRE_PIN))
+#define BUTTON_DEBOUNCE_US	5000
+#define BUTTON_QUEUE_LENGTH	16 // events the tasks may fall behind by
+
+/* what the buttons have been up to, latencies in microseconds */
+struct button_stats_struct
+{
+  uint32_t edges; // edges interrupted on
+  uint32_t bounces; // edges ignored by the debouncer
+  uint32_t events; // changes of the buttons
+  uint32_t dropped; // events lost to a full queue
+  uint32_t shown; // steps with new input that made it to the screen
+  uint32_t last_latency_us; // from the first edge to the screen update
+  uint32_t max_latency_us;
+  uint32_t mean_latency_us;
+};
+typedef struct button_stats_struct button_stats_t;
+
+void
+initButtons (void);
+bool_t
+waitButtons (ui_event_t *ev, portTickType xTicksToWait);
+bool_t
+getButtons (ui_t *ui);
+void
+markButtonsShown (void);
+void
+getButtonStats (button_stats_t *stats);
+
+/********************************************************************
+ * Sound Effects
+ ********************************************************************/
+/*
+ * the DMA controller streams a ring of two mixed blocks into the DAC
+ * (AOUT, P0.26), paced by the DAC's own counter at AUDIO_SAMPLE_RATE; the
+ * mixer fills a block each time the controller is done with it
+ */
+void
+initSound (void);
+void
+playSound (const sound_t *sound, uint8_t volume);
+void
+getSoundStats (audio_stats_t *stats);
+
 #endif /* LIBGAMEIO_H_ */
@@ -0,0 +1,94 @@
+/*
+ * libgameaudio.h
+ *
+ *
+ * Game Audio Library
+ *
+ * Mixes the sound effects of the game, a few voices at a time, into blocks
+ * of DAC samples. On the board the DMA controller streams a ring of two
+ * such blocks into the DAC at AUDIO_SAMPLE_RATE, and the mixer runs once
+ * per block, when the DMA controller is done with one half of the ring;
+ * the CPU never touches the DAC sample by sample.
+ *
+ * Effects are mono, at AUDIO_SAMPLE_RATE, as signed 8-bit PCM or as IMA
+ * ADPCM (4 bits a sample, low nibble first). The mixed samples come out
+ * laid out as the DAC register wants them, so the DMA controller can move
+ * them as they are.
+ *
+ * Nothing in here touches the hardware, the host tools use it as is.
+ *
+ */
+
+#ifndef LIBGAMEAUDIO_H_
+#define LIBGAMEAUDIO_H_
+
+#include <stdint.h>
+#include "libtakisbasics.h"
+
+#define AUDIO_SAMPLE_RATE		8000
+#define AUDIO_CHANNELS			4
+#define AUDIO_BLOCK			128 // samples in each half of the ring
+#define AUDIO_DAC_BITS			10
+#define AUDIO_DAC_SHIFT			6 // value field of the DAC register
+#define AUDIO_DAC_MID			(1 << (AUDIO_DAC_BITS - 1))
+#define AUDIO_VOLUME_FULL		255
+
+enum sound_format
+{
+  SOUND_PCM8 = 0U, SOUND_ADPCM = 1U
+};
+typedef enum sound_format sound_format_t;
+
+/* a sound effect, kept in flash */
+struct sound_struct
+{
+  sound_format_t format;
+  uint16_t samples;
+  const uint8_t *data;
+};
+typedef struct sound_struct sound_t;
+
+/* a voice plays one sound at a time */
+struct audio_voice_struct
+{
+  const sound_t *sound; // NULL when the voice is free
+  uint16_t pos; // next sample
+  uint8_t volume;
+  uint8_t index; // ADPCM step index...
+  int16_t predictor; // ...and last sample
+};
+typedef struct audio_voice_struct audio_voice_t;
+
+struct audio_stats_struct
+{
+  uint32_t blocks; // blocks mixed
+  uint32_t voice_blocks; // voices mixed into them, to average the load
+  uint32_t clipped; // samples that did not fit the DAC
+  uint32_t started; // sounds started...
+  uint32_t stolen; // ...in a voice taken from another sound
+};
+typedef struct audio_stats_struct audio_stats_t;
+
+struct audio_mixer_struct
+{
+  audio_voice_t voice[AUDIO_CHANNELS];
+  int32_t acc[AUDIO_BLOCK]; // the block being mixed
+  audio_stats_t stats;
+};
+typedef struct audio_mixer_struct audio_mixer_t;
+
+/*
+ * FUNCTION PROTOTYPES
+ */
+void
+audioInit (audio_mixer_t *mixer);
+uint8_t
+audioPlay (audio_mixer_t *mixer, const sound_t *sound, uint8_t volume);
+void
+audioStop (audio_mixer_t *mixer, uint8_t channel);
+uint8_t
+audioActive (const audio_mixer_t *mixer);
+void
+audioMix (audio_mixer_t *mixer, uint16_t *out, uint16_t n);
+
+#endif /* LIBGAMEAUDIO_H_ */
@@ -0,0 +1,53 @@
+/*
+ * libgamecore.h
+ *
+ *
+ * Game Logic Library
+ *
+ * Everything that happens in one game step: spawning, GO state machines,
+ * movement, proximities and collisions. Nothing in here touches the RTOS
+ * or the hardware, so the same code steps the game on the LPC1769 and on
+ * a workstation.
+ *
+ */
+
+#ifndef LIBGAMECORE_H_
+#define LIBGAMECORE_H_
+
+#include "libgameds.h"
+
+#define PLAYER_HEALTH			512
+#define	PLAYER_LIVES			3
+#define ALIEN_HEALTH			1024
+#define BABY_HEALTH			128
+#define KITTY_HEALTH			8192
+#define KITTY_LIVES			9
+#define PROJECTILE_HEALTH		1
+#define DAMAGE_PER_HIT			256
+#define POOH_SPEED			1 // pixels per game step, downwards
+#define EXPUNGER_SPEED			2 // pixels per game step, upwards
+#define SCORE_ALIEN			64 // for each alien expunged
+
+/*
+ * FUNCTION PROTOTYPES
+ */
+void
+gameInit (game_t *this_game);
+go_slot_t
+gameStartRound (game_t *this_game, uint8_t numlives);
+void
+gameClear (game_t *this_game);
+void
+gameStep (game_t *this_game);
+
+superstateGO_t
+vPlayerStateMachine (superstateGO_t current_state, const ui_t *ui);
+superstateGO_t
+vAlienStateMachine (superstateGO_t current_state, int16_t vx);
+superstateGO_t
+vKittyStateMachine (superstateGO_t current_state, uint32_t *rng);
+
+uint16_t
+uiCompareGODistance (go_coord_t A, go_coord_t B);
+
+#endif /* LIBGAMECORE_H_ */
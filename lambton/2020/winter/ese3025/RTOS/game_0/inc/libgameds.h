@@ -13,25 +13,32 @@
 #ifndef LIBGAMEDS_H_
 #define LIBGAMEDS_H_
 
-#include "FreeRTOS.h"
-#include "task.h"
+#include <stdint.h>
 #include <stdlib.h>
-#include "libgameds.h"
 #include "libtakisbasics.h"
 
-#define	RUN_GAME_PRIORITY		3
-#define IMPACTS_TASK_PRIORITY		(RUN_GAME_PRIORITY - 1)
-#define GO_TASK_PRIORITY		(IMPACTS_TASK_PRIORITY - 1)
 #define	MAX_NUMBER_OF_PLAYERS		4
-#define DELAY_RUN_GAME			65536
-#define	DELAY_GAME_TICK			8192
 #define THRESHOLD_COLLISION	 	16
 #define THRESHOLD_SEEN			32
+/*
+ * capacity of the GO pool per kind; a host build may raise them, as
+ * host/impacts_bench.c does to time the game with hundreds of GOs
+ */
+#ifndef MAX_ALIENS
 #define MAX_ALIENS			3
+#endif
+#ifndef MAX_POOHS
 #define MAX_POOHS			9
+#endif
+#ifndef MAX_EXPUNGERS
 #define	MAX_EXPUNGERS			3
+#endif
+#ifndef MAX_BABIES
 #define MAX_BABIES			3
+#endif
+#ifndef MAX_KITTIES
 #define	MAX_KITTIES			2
+#endif
 #define	XLEFT				0
 #define XMIDDLE				63
 #define XRIGHT				127
@@ -41,7 +48,23 @@
 #define LEVELUP				8192
 #define	MAX_GO_CODES			16
 #define LEVEL_UP_X			256 // determines scale of leveling up
-#define MOVE_TICKS			100 // number of RTOS ticks for GO anim
+#define NUMBER_OF_GO_TYPES		6
+
+/*
+ * uniform grid over the 128 x 64 playing field, used to find the GOs near a
+ * subject without scanning whole GO lists; a query visits the cells that
+ * overlap the square of +/- THRESHOLD_SEEN around the subject
+ */
+#ifndef GRID_CELL_SIZE
+#define GRID_CELL_SIZE			16
+#endif
+#define GRID_COLS			((XRIGHT + GRID_CELL_SIZE) / GRID_CELL_SIZE)
+#define GRID_ROWS			((YBOTTOM + GRID_CELL_SIZE) / GRID_CELL_SIZE)
+#define GRID_NO_CELL			0xFF
+/* kinds with fewer slots are scanned instead; see host/impacts_bench.c */
+#ifndef GRID_MIN_SLOTS
+#define GRID_MIN_SLOTS			256
+#endif
 
 
 enum likelihood
@@ -53,7 +76,7 @@ enum likelihood
   Unlikely = 4U,		// < RAND_MAX / 16, prob. = 6.25 %
   QuiteUnLikely = 5U, 		// < RAND_MAX / 32, prob. = 3.125 %
   YeahRight = 6U,		// < RAND_MAX / 64, prob. = 1.5625 %
-} likelihood_enum;
+};
 typedef enum likelihood likely_t;
 
 enum gotype
@@ -77,26 +100,6 @@ enum superstateGOtype
 };
 typedef enum superstateGOtype superstateGO_t;
 
-/* GO ID code book */
-/*
- * GO IDs:
- * 			0x0000 000q: players
- * 			0x0000 00q0: aliens
- * 			0x0000 0q00: poohs
- * 			0x0000 q000: expungers
- * 			0x000q 0000: babies
- * 			0x00q0 0000: kitties
- *
- * 			where q \in {0,1,2,3,4,5,6,7,8,9,A,B,C,D,E,F}
- *
- */
-struct go_ID_struct
-{
-  uint32_t code;
-  bool_t available;
-};
-typedef struct go_ID_struct go_ID_t;
-
 /* user-input tracking */
 struct ui_struct
 {
@@ -107,6 +110,19 @@ struct ui_struct
 };
 typedef struct ui_struct ui_t;
 
+/* user input packed into one byte per game step, for recordings */
+#define UI_LEFT				0x01
+#define UI_RIGHT			0x02
+#define UI_CROUCH			0x04
+#define UI_FIRE				0x08
+
+/*
+ * random numbers for the game: a xorshift32 generator whose state lives in
+ * the game, so that a game is repeated exactly from its seed and inputs
+ */
+#define PRNG_MAX			0xFFFFFFFFUL
+#define PRNG_DEFAULT_SEED		0x2545F491UL
+
 /* coordinate type */
 struct go_coord_struct
 {
@@ -116,35 +132,81 @@ struct go_coord_struct
 typedef struct go_coord_struct go_coord_t;
 
 
-/* (g)ame (o)bject record-keeping */
-struct go_struct
+/*
+ * (g)ame (o)bject store
+ *
+ * GOs are not allocated one by one: every GO lives in a slot of a fixed
+ * pool, and each property is an array indexed by slot (structure of
+ * arrays). The slots of each GO kind form one contiguous range,
+ * [goKindBase[kind], goKindBase[kind + 1]), so a pass over one kind of GO
+ * is a loop over a dense index range, testing the alive bitmap. Free slots
+ * are kept on a stack per kind, spawning and killing a GO is O(1).
+ */
+typedef uint16_t go_slot_t;
+#define GO_NONE				((go_slot_t) 0xFFFF)
+
+#define GO_BASE_PLAYER			0
+#define GO_BASE_ALIEN			(GO_BASE_PLAYER + 1)
+#define GO_BASE_POOH			(GO_BASE_ALIEN + MAX_ALIENS)
+#define GO_BASE_EXPUNGER		(GO_BASE_POOH + MAX_POOHS)
+#define GO_BASE_BABY			(GO_BASE_EXPUNGER + MAX_EXPUNGERS)
+#define GO_BASE_KITTY			(GO_BASE_BABY + MAX_BABIES)
+#define GO_POOL_SIZE			(GO_BASE_KITTY + MAX_KITTIES)
+#define GO_BITMAP_WORDS			((GO_POOL_SIZE + 31) / 32)
+
+/* per-GO flags */
+#define GO_CAN_MOVE			0x01 // (re)set by gameStep()
+#define GO_STRUCK			0x02 // GO reacts to being struck
+#define GO_ACTION			0x04 // shoot or pooh
+
+struct go_store_struct
 {
-  gotype_t kind;
-  uint32_t ID;
-  uint16_t go_level; // can only be altered by the vImpactsTask()!
-  uint16_t health; // can only be altered by the vImpactsTask()!
-  bool_t alive; // can only be altered by the vImpactsTask()!
-  bool_t active;
-  bool_t gameover; // can only be altered by the vImpactsTask()!
-  go_coord_t pos;
-  go_coord_t des_vel; // character's desired velocity, checked by vImpactsTask()
-  bool_t can_move; // whether GO is allowed to move; (re)set by vImpactsTask()
-  go_coord_t acc;
-  superstateGO_t animstate; // storage for the GO animation state
-  bool_t move_left;
-  bool_t move_right;
-  bool_t crouch_or_extra;
-  bool_t shoot_or_pooh;
-  uint8_t numlives;
-  go_list_t *interactions;
-  xTaskHandle task;
-  char taskText[32];
-  struct go_struct *pNext;
-  struct go_struct *pPrev;
+  /* properties, indexed by slot */
+  int16_t x[GO_POOL_SIZE]; // position
+  int16_t y[GO_POOL_SIZE];
+  int16_t vx[GO_POOL_SIZE]; // velocity, per game step
+  int16_t vy[GO_POOL_SIZE];
+  uint16_t health[GO_POOL_SIZE]; // only altered by collisions in gameStep()!
+  uint8_t kind[GO_POOL_SIZE];
+  uint8_t animstate[GO_POOL_SIZE]; // storage for the GO animation state
+  uint8_t numlives[GO_POOL_SIZE];
+  uint8_t flags[GO_POOL_SIZE];
+  /* interactions found in the last gameStep(), as bitmasks of
+   * GO kinds */
+  uint8_t seen[GO_POOL_SIZE]; // within THRESHOLD_SEEN
+  uint8_t hits[GO_POOL_SIZE]; // within THRESHOLD_COLLISION
+  /* one bit per slot, set while the GO is alive */
+  uint32_t alive[GO_BITMAP_WORDS];
+  /* free slots of each kind, a stack in the kind's slot range */
+  go_slot_t free_slots[GO_POOL_SIZE];
+  uint16_t number_free[NUMBER_OF_GO_TYPES];
+  uint16_t number_alive[NUMBER_OF_GO_TYPES];
+  /* uniform grid: per kind and cell, a list of slots linked through
+   * cell_next/cell_prev */
+  uint8_t cell[GO_POOL_SIZE]; // GRID_NO_CELL if none
+  go_slot_t cell_next[GO_POOL_SIZE];
+  go_slot_t cell_prev[GO_POOL_SIZE];
+  go_slot_t grid[NUMBER_OF_GO_TYPES][GRID_ROWS * GRID_COLS];
 };
-typedef struct go_struct go_t;
+typedef struct go_store_struct go_store_t;
+
+/* first slot of each GO kind; goKindBase[NUMBER_OF_GO_TYPES] is the pool
+ * size */
+extern const go_slot_t goKindBase[NUMBER_OF_GO_TYPES + 1];
 
+static inline bool_t
+goIsAlive (const go_store_t *store, go_slot_t slot)
+{
+  return (store->alive[slot >> 5] >> (slot & 31)) & 1U ? True : False;
+}
 
+static inline go_coord_t
+goPosition (const go_store_t *store, go_slot_t slot)
+{
+  go_coord_t pos =
+    { store->x[slot], store->y[slot] };
+  return pos;
+}
 
 /* game record-keeping for each player
  * (we assume one player per game, right?) */
@@ -154,43 +216,46 @@ struct game_struct
   char playerID[4];
   uint16_t game_level;
   ui_t user;
-  /* GO lists */
-  go_t *player;
-  go_t *aliens;
-  go_t *poohs;
-  go_t *expungers;
-  go_t *babies;
-  go_t *kitties;
-  /* ID code books for various GO types, other than player */
-  go_ID_t aliensID[16];
-  go_ID_t poohsID[16];
-  go_ID_t expungersID[16];
-  go_ID_t babiesID[16];
-  go_ID_t kittiesID[16];
-  /* record keeping for number of each GO type, other than player */
-  size_t number_of_aliens;
-  size_t number_of_poohs;
-  size_t number_of_expungers;
-  size_t number_of_babies;
-  size_t number_of_kitties;
+  /* all GOs of this game */
+  go_store_t gos;
+  go_slot_t player; // slot of the player GO
+  bool_t gameover;
+  uint32_t frame; // count of gameStep() calls
+  uint32_t rng; // random number generator state
 };
 typedef struct game_struct game_t;
 
 
-struct go_list_struct
-{
-  gotype_t kind;
-  uint32_t ID;
-  uint16_t distance;
-  bool_t seen;
-  bool_t collision;
-  struct go_list_struct *pNext;
-  struct go_list_struct *pPrev;
-};
-typedef struct go_list_struct go_list_t;
-
 /*
  * FUNCTION PROTOTYPES
  */
+void
+goStoreInit (go_store_t *store);
+go_slot_t
+goSpawn (go_store_t *store, gotype_t kind, go_coord_t pos, uint16_t health,
+	 uint8_t numlives);
+void
+goKill (go_store_t *store, go_slot_t slot);
+void
+goMove (go_store_t *store, go_slot_t slot, int16_t x, int16_t y);
+
+void
+prngSeed (uint32_t *state, uint32_t seed);
+uint32_t
+prngNext (uint32_t *state);
+
+uint8_t
+uiPack (const ui_t *ui);
+void
+uiUnpack (uint8_t bits, ui_t *ui);
+
+uint8_t
+gridCellOf (go_coord_t pos);
+void
+gridInsertGO (go_store_t *store, go_slot_t slot);
+void
+gridRemoveGO (go_store_t *store, go_slot_t slot);
+void
+gridMoveGO (go_store_t *store, go_slot_t slot);
 
 #endif /* LIBGAMEDS_H_ */
@@ -0,0 +1,90 @@
+/*
+ * libgameinput.h
+ *
+ *
+ * Game Input Library
+ *
+ * Debouncing of the button edges, and the events handed from the input
+ * interrupts to the game loop. Times are stamps from a free-running
+ * counter, in whatever unit the caller uses (RI timer counts on the board,
+ * microseconds on a workstation). Nothing in here touches the hardware.
+ *
+ * A button edge is accepted at once, so input costs no debounce delay;
+ * the button is then locked out for the debounce window, and whatever
+ * edges it bounces through are ignored. When the window expires the pin is
+ * sampled again, and if it has settled on the other level that is a new
+ * edge.
+ *
+ */
+
+#ifndef LIBGAMEINPUT_H_
+#define LIBGAMEINPUT_H_
+
+#include <stdint.h>
+#include "libgameds.h"
+#include "libtakisbasics.h"
+
+#define NUMBER_OF_BUTTONS		4 // bit b is button b, as in uiPack()
+
+/* a change of the buttons, as accepted by the debouncer */
+struct ui_event_struct
+{
+  uint8_t buttons; // all buttons after the change, UI_LEFT | ...
+  uint8_t changed; // the buttons that changed
+  uint32_t stamp; // when the (first) edge was seen
+};
+typedef struct ui_event_struct ui_event_t;
+
+struct debouncer_struct
+{
+  uint32_t window; // debounce window, in stamp units
+  uint32_t until[NUMBER_OF_BUTTONS]; // end of each button's lock-out
+  uint8_t buttons; // accepted levels
+  uint8_t locked; // buttons in their lock-out
+  uint32_t edges; // edges seen
+  uint32_t bounces; // edges ignored
+  uint32_t events; // edges accepted
+};
+typedef struct debouncer_struct debouncer_t;
+
+/* what the game loop makes of the events, step by step */
+struct input_latch_struct
+{
+  uint8_t held; // buttons down now
+  uint8_t latched; // buttons down at any time since the last step
+  bool_t pending; // events arrived since the last step
+  uint32_t pending_stamp; // the oldest of them
+  bool_t in_step; // the last step used events...
+  uint32_t step_stamp; // ...the oldest of them from here
+  /* input-to-screen latency, in stamp units */
+  uint32_t shown;
+  uint32_t last_latency;
+  uint32_t max_latency;
+  uint64_t total_latency;
+};
+typedef struct input_latch_struct input_latch_t;
+
+/*
+ * FUNCTION PROTOTYPES
+ */
+void
+inputDebounceInit (debouncer_t *deb, uint32_t window, uint8_t buttons);
+bool_t
+inputDebounceEdge (debouncer_t *deb, uint8_t button, bool_t level,
+		   uint32_t now, ui_event_t *ev);
+bool_t
+inputDebounceExpire (debouncer_t *deb, uint8_t levels, uint32_t now,
+		     ui_event_t *ev);
+bool_t
+inputDebounceDeadline (const debouncer_t *deb, uint32_t *deadline);
+
+void
+inputLatchInit (input_latch_t *latch);
+void
+inputLatchEvent (input_latch_t *latch, const ui_event_t *ev);
+bool_t
+inputLatchStep (input_latch_t *latch, ui_t *ui);
+void
+inputLatchShown (input_latch_t *latch, uint32_t now);
+
+#endif /* LIBGAMEINPUT_H_ */
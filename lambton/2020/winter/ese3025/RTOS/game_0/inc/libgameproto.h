@@ -0,0 +1,142 @@
+/*
+ * libgameproto.h
+ *
+ *
+ * Game Screen Protocol Library
+ *
+ * The screen is kept up to date with one binary frame per game step,
+ * carrying only the GOs that differ from a frame the host has acknowledged:
+ *
+ *	SYNC seq base count|FULL record... crc8
+ *
+ *	- seq: sequence number of this frame
+ *	- base: the acknowledged frame the records are relative to; with
+ *		PROTO_FULL set in the count byte there is no base, the records
+ *		describe the whole screen
+ *	- record: one header byte, slot | PROTO_REC_POS | PROTO_REC_STATE |
+ *		PROTO_REC_GONE, followed by x and y if PROTO_REC_POS is set,
+ *		and by the animation state if PROTO_REC_STATE is set
+ *	- crc8: CRC-8 (polynomial 0x07) over seq to the last record
+ *
+ * The host answers each good frame with ACK seq ~seq. Records carry
+ * absolute values, and the base is always a frame the host holds, so a lost
+ * frame or a lost acknowledgement only makes later frames larger until an
+ * acknowledgement gets through. Text messages ("C:clc", "D:...") still go
+ * out as ASCII lines between frames, SYNC is not ASCII so the host can tell
+ * the two apart.
+ *
+ * Nothing in here touches the hardware, the host decoder uses it as is.
+ *
+ */
+
+#ifndef LIBGAMEPROTO_H_
+#define LIBGAMEPROTO_H_
+
+#include <stdint.h>
+#include "libgameds.h"
+#include "libtakisbasics.h"
+
+#define PROTO_SYNC			0xA5
+#define PROTO_ACK			0x5A
+#define PROTO_FULL			0x80 // in the count byte
+#define PROTO_REC_SLOT			0x1F
+#define PROTO_REC_POS			0x20
+#define PROTO_REC_STATE			0x40
+#define PROTO_REC_GONE			0x80
+#define PROTO_HEADER_SIZE		4 // SYNC seq base count
+#define PROTO_RECORD_MAX		4 // header x y state
+#define PROTO_MAX_FRAME			(PROTO_HEADER_SIZE \
+					 + GO_POOL_SIZE * PROTO_RECORD_MAX + 1)
+#define PROTO_ACK_SIZE			3 // ACK seq ~seq
+#define PROTO_WINDOW			8 // frames kept for use as a base
+
+#if GO_POOL_SIZE > PROTO_REC_SLOT + 1
+#error "slot numbers do not fit a protocol record"
+#endif
+
+/* a GO as drawn on the screen */
+struct proto_go_struct
+{
+  uint8_t alive;
+  uint8_t x;
+  uint8_t y;
+  uint8_t state;
+};
+typedef struct proto_go_struct proto_go_t;
+
+/* bandwidth bookkeeping, on both ends */
+struct proto_stats_struct
+{
+  uint32_t frames;
+  uint32_t full_frames;
+  uint32_t records;
+  uint32_t bytes;
+  uint32_t max_frame_bytes;
+  uint32_t dropped; // encoder only: no room to send
+  uint32_t crc_errors; // decoder only
+  uint32_t missing_base; // decoder only: base no longer held
+};
+typedef struct proto_stats_struct proto_stats_t;
+
+/* sending end */
+struct proto_encoder_struct
+{
+  proto_go_t sent[PROTO_WINDOW][GO_POOL_SIZE]; // screen after each frame
+  uint8_t seq; // last frame sent
+  uint8_t acked; // last frame acknowledged
+  uint8_t oldest; // oldest frame whose acknowledgement counts
+  bool_t have_base; // acked can be used as a base
+  proto_stats_t stats;
+};
+typedef struct proto_encoder_struct proto_encoder_t;
+
+/* receiving end */
+enum proto_event
+{
+  PROTO_NONE = 0U, PROTO_FRAME = 1U, PROTO_TEXT = 2U
+};
+typedef enum proto_event proto_event_t;
+
+struct proto_decoder_struct
+{
+  proto_go_t held[PROTO_WINDOW][GO_POOL_SIZE]; // screen after each frame
+  uint8_t held_seq[PROTO_WINDOW];
+  bool_t held_valid[PROTO_WINDOW];
+  proto_go_t screen[GO_POOL_SIZE]; // screen after the latest frame
+  uint8_t seq; // latest frame
+  /* byte parser, buf holds the frame after SYNC */
+  uint8_t buf[PROTO_MAX_FRAME];
+  uint16_t len;
+  uint8_t records; // records still to come
+  uint8_t need; // bytes still to come in the current record
+  bool_t in_frame;
+  char text[64]; // last text line, NUL terminated
+  uint8_t text_len;
+  proto_stats_t stats;
+};
+typedef struct proto_decoder_struct proto_decoder_t;
+
+/*
+ * FUNCTION PROTOTYPES
+ */
+uint8_t
+protoCRC8 (const uint8_t *data, uint16_t len);
+
+void
+protoEncoderInit (proto_encoder_t *enc);
+void
+protoEncoderReset (proto_encoder_t *enc);
+uint16_t
+protoEncodeFrame (proto_encoder_t *enc, const go_store_t *store,
+		  uint8_t *frame);
+void
+protoEncoderAck (proto_encoder_t *enc, uint8_t seq);
+
+void
+protoDecoderInit (proto_decoder_t *dec);
+proto_event_t
+protoDecodeByte (proto_decoder_t *dec, uint8_t byte);
+uint16_t
+protoMakeAck (uint8_t seq, uint8_t *ack);
+
+#endif /* LIBGAMEPROTO_H_ */
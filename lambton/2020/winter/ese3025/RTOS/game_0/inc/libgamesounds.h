@@ -0,0 +1,22 @@
+/*
+ * libgamesounds.h
+ *
+ *
+ * Game Sounds Library
+ *
+ * The sound effects of the game. libgamesounds.c is made by host/sfx_gen,
+ * change the effects there and make it again rather than editing it.
+ *
+ */
+
+#ifndef LIBGAMESOUNDS_H_
+#define LIBGAMESOUNDS_H_
+
+#include "libgameaudio.h"
+
+extern const sound_t sfxFire; // the player fires an expunger
+extern const sound_t sfxHit; // something is struck and lives
+extern const sound_t sfxAlienDown; // an alien is expunged
+extern const sound_t sfxPlayerDown; // the player loses a life
+
+#endif /* LIBGAMESOUNDS_H_ */
@@ -8,6 +8,45 @@
 #ifndef LIBGAMETASKS_H_
 #define LIBGAMETASKS_H_
 
+#include "FreeRTOS.h"
 
+#define	RUN_GAME_PRIORITY		3
+#define GAME_LOOP_PRIORITY		(RUN_GAME_PRIORITY - 1)
+#define GAME_LOOP_STACK			(2 * configMINIMAL_STACK_SIZE)
+
+/*
+ * the game loop steps the game at a fixed rate, GAME_TICK_HZ; when it falls
+ * behind, it runs up to GAME_MAX_CATCHUP steps back to back before the
+ * screen is updated, and drops any steps beyond that
+ */
+#define GAME_TICK_HZ			20
+#define GAME_STEP_TICKS			(configTICK_RATE_HZ / GAME_TICK_HZ)
+#define GAME_MAX_CATCHUP		4
+
+/* timing of the game loop, times in microseconds */
+struct game_timing_struct
+{
+  uint32_t steps; // gameStep() calls
+  uint32_t frames; // screen updates, one per pass of the loop
+  uint32_t catchup_steps; // steps run late, back to back
+  uint32_t skipped_steps; // steps dropped to get back on time
+  uint32_t last_step_us; // last gameStep()
+  uint32_t max_step_us;
+  uint32_t last_frame_us; // last pass: its steps and the screen update
+  uint32_t max_frame_us;
+  uint32_t max_lateness_ticks; // worst delay between due and started
+};
+typedef struct game_timing_struct game_timing_t;
+
+/*
+ * tasks behind the game: one supervisor per game, and one loop stepping
+ * every GO of the game being played
+ */
+void
+vRunGameTask (void *pvParams);
+void
+vGameLoopTask (void *pvParams);
+void
+vGetGameTiming (game_timing_t *timing);
 
 #endif /* LIBGAMETASKS_H_ */
@@ -13,45 +13,12 @@
 enum boolean
 {
   False = 0U, True = 1U
-} boolean_enum;
+};
 typedef enum boolean bool_t;
 
-/*
- *
- * signum function
- * 	integer-argument version
- *
- */
 int
-sgn (const void *parg)
-{
-  int arg = *((int *) parg);
-  int ret = 0;
-
-  if (arg > 0)
-    ret = 1;
-  else if (arg < 0)
-    ret = -1;
-
-  return ret;
-}
-
-/*
- *
- * signum function
- * 	integer-argument and boolean-result version
- *
- */
+sgn (const void *parg);
 bool_t
-sgn_bool (const void *parg)
-{
-  int arg = *((int *) parg);
-  bool_t ret = False;
-
-  if (arg > 0)
-    ret = True;
-
-  return ret;
-}
+sgn_bool (const void *parg);
 
 #endif /* LIBTAKISBASICS_H_ */
@@ -16,6 +16,7 @@
 #include "FreeRTOS.h"
 #include "task.h"
 #include "semphr.h"
+#include <stdio.h>
 #include <stdlib.h>
 #include "libgameds.h"
 #include <string.h>
@@ -28,16 +29,7 @@
 /********************************************************************
  * Global Variables
  ********************************************************************/
-/* Transmit and receive buffers */
-static uint8_t rxbuff[UART_RRB_SIZE], txbuff[UART_SRB_SIZE];
-/* Transmit and receive ring buffers */
-static RINGBUFF_T txring, rxring;
-
 //volatile queue_t q; /* UART queue */
-ui_t user_input =
-  { False, False, False, False };
-size_t number_of_players = 0;
-
 xSemaphoreHandle xGameMutex = NULL;
 
 /********************************************************************
@@ -47,61 +39,53 @@ xSemaphoreHandle xGameMutex = NULL;
  * function to display number of players
  */
 static void
-prvShowNumPlayers (void)
+prvShowNumPlayers (uint8_t number_of_players)
 {
+  char mesg[40];
+
   sendUARTText ("C:clc\r\n");
-  char numplayers_str[2];
-  sprintf (numplayers_str, "%d", number_of_players);
-  char mesg[40] = "D:enter number of players: ";
-  strcat (mesg, numplayers_str);
-  strcat (mesg, "\r\n");
+  sprintf (mesg, "D:enter number of players: %u\r\n", number_of_players);
   sendUARTText (mesg);
 }
 /*
- * function to determine the number of players in the game
+ * task to determine the number of players in the game: right adds a
+ * player, left removes one, fire starts a game for each; it sleeps on the
+ * button queue in between
  */
 static void
-prvGetNumberofPlayers (void)
+vLobbyTask (void *pvParams)
 {
-  prvShowNumPlayers ();
-  /* get number of players */
-  while (user.shoot == False)
+  uint8_t number_of_players = 1;
+  uint8_t pressed;
+  ui_event_t ev;
+
+  prvShowNumPlayers (number_of_players);
+  do
     {
-      if (user.move_right)
+      waitButtons (&ev, portMAX_DELAY);
+      pressed = ev.changed & ev.buttons;
+      if ((pressed & UI_RIGHT) && number_of_players < MAX_NUMBER_OF_PLAYERS)
 	{
-	  if (number_of_players <= MAX_NUMBER_OF_PLAYERS)
-	    {
-	      number_of_players++;
-	      prvShowNumPlayers ();
-	    }
+	  number_of_players++;
+	  prvShowNumPlayers (number_of_players);
 	}
-      else if (user.move_left)
+      else if ((pressed & UI_LEFT) && number_of_players != 1)
 	{
-	  if (number_of_players != 1)
-	    {
-	      number_of_players--;
-	      prvShowNumPlayers ();
-	    }
+	  number_of_players--;
+	  prvShowNumPlayers (number_of_players);
 	}
     }
-}
-/*
- * function to reset game board, called by vRunGameTask(), after scheduler has started
- */
-static void
-prvResetBoard (void)
-{
-  /* send command to clear the game screen/board and wait for 5 seconds */
-  taskENTER_CRITICAL();
-  sendUARTText ("C:clc"); /* command: clear console */
-  vTaskDelay (configTICK_RATE_HZ * 5); /* wait for a few seconds */
-  sendUARTText ("D:emad studio inc. presents: ");
-  vTaskDelay (configTICK_RATE_HZ * 2);
-  sendUARTText ("D:aliens & babies : at the daycare!");
-  vTaskDelay (configTICK_RATE_HZ * 5);
-  taskEXIT_CRITICAL();
-}
+  while (!(pressed & UI_FIRE));
 
+  /* start game */
+  for (size_t i = 0; i != number_of_players; ++i)
+    {
+      xTaskCreate(vRunGameTask, "Supervisory Game Task",
+		  4*configMINIMAL_STACK_SIZE, (void * ) i,
+		  RUN_GAME_PRIORITY, NULL);
+    }
+  vTaskDelete (NULL);
+}
 /*
  * function to initialize hardware, run at the very beginning, BEFORE scheduler,
  * please!
@@ -139,8 +123,10 @@ prvSetupHardware (void)
   NVIC_EnableIRQ (IRQ_SELECTION);
 
   /* set up GPIO pin interrupts for user interface */
+  initButtons ();
 
   /* set up DAC for sound effects */
+  initSound ();
 }
 
 /********************************************************************
@@ -155,16 +141,9 @@ main (void)
   /* hardware init */
   prvSetupHardware ();
 
-  /* get the number of players */
-  prvGetNumberofPlayers ();
-
-  /* start game */
-  for (size_t i = 0; i != number_of_players; ++i)
-    {
-      xTaskCreate(vRunGameTask, "Supervisory Game Task",
-		  4*configMINIMAL_STACK_SIZE, (void * ) &i, NULL,
-		  RUN_GAME_PRIORITY);
-    }
+  /* get the number of players, the lobby then starts the games */
+  xTaskCreate(vLobbyTask, "Lobby", 2*configMINIMAL_STACK_SIZE, NULL,
+	      RUN_GAME_PRIORITY, NULL);
 
   /* relinquish control to scheduler */
   vTaskStartScheduler ();
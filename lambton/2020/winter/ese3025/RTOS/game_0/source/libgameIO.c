@@ -6,25 +6,407 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
+#include "chip.h"
+#include "FreeRTOS.h"
+#include "queue.h"
+#include "task.h"
+#include "libgameaudio.h"
 #include "libgameds.h"
+#include "libgameinput.h"
+#include "libgameproto.h"
 #include "libtakisbasics.h"
 #include "libgameIO.h"
 
+/********************************************************************
+ * Global Variables
+ ********************************************************************/
+/* Transmit and receive buffers */
+uint8_t rxbuff[UART_RRB_SIZE], txbuff[UART_SRB_SIZE];
+/* Transmit and receive ring buffers */
+RINGBUFF_T txring, rxring;
+
+/* screen frames sent, and the acknowledgements received, so far */
+static proto_encoder_t screen;
+static bool_t screen_ready = False;
+static uint8_t ack[PROTO_ACK_SIZE];
+static uint8_t ack_len = 0;
+
+/* the buttons: debounced by the interrupts, latched by the game loop */
+#define BUTTON_IRQ_PRIORITY	(configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY + 1)
+static const uint8_t button_pin[NUMBER_OF_BUTTONS] =
+  { BUTTON_LEFT_PIN, BUTTON_RIGHT_PIN, BUTTON_CROUCH_PIN, BUTTON_FIRE_PIN };
+static debouncer_t buttons;
+static input_latch_t latch;
+static xQueueHandle xButtonQueue = NULL;
+static uint32_t rit_ticks_per_us = 1;
+static volatile uint32_t button_events_dropped = 0;
+
+/* the sound: a ring of two blocks, each with its DMA descriptor */
+#define SOUND_IRQ_PRIORITY	(configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY + 1)
+static audio_mixer_t mixer;
+static uint16_t sound_ring[2][AUDIO_BLOCK];
+static DMA_TransferDescriptor_t sound_lli[2];
+static uint8_t sound_channel;
+static uint8_t sound_half = 0; // the half the DMA controller finishes next
+static volatile uint32_t sound_dma_errors = 0;
+
+/*
+ *	UART interrupt handler, moves bytes between the UART and the ring
+ *	buffers
+ */
+void
+HANDLER_NAME (void)
+{
+  Chip_UART_IRQRBHandler (UART_SELECTION, &rxring, &txring);
+}
+
 /*
  *	function to handle UART Transmissions for text
  */
 void
 sendUARTText (const char tx_text[])
 {
-  Chip_UART_SendRB (UART_SELECTION, &txring, tx_text, sizeof(tx_text) - 1);
+  Chip_UART_SendRB (UART_SELECTION, &txring, tx_text, strlen (tx_text));
+}
+
+/*
+ *	function collects the acknowledgements the host has sent, ACK seq ~seq,
+ *	resynchronizing on the ACK byte after a bad one
+ */
+static void
+prvReceiveAcks (void)
+{
+  uint8_t byte;
+
+  while (RingBuffer_Pop (&rxring, &byte))
+    {
+      if (ack_len == 0 && byte != PROTO_ACK)
+	{
+	  continue;
+	}
+      ack[ack_len++] = byte;
+      if (ack_len == PROTO_ACK_SIZE)
+	{
+	  ack_len = 0;
+	  if ((ack[1] ^ ack[2]) == 0xFF)
+	    {
+	      protoEncoderAck (&screen, ack[1]);
+	    }
+	}
+    }
 }
 
 /*
- *	function to handle UART Transmissions for graphics
+ *	function to handle UART Transmissions for graphics: one frame with
+ *	the GOs the host does not have yet; a frame that does not fit in the
+ *	transmit ring is dropped, its changes go out with the next one
  */
 void
-sendUARTGraphic (go_t *pGO)
+sendUARTScreen (const go_store_t *store)
 {
+  static uint8_t frame[PROTO_MAX_FRAME];
+  uint16_t len;
+
+  if (!screen_ready)
+    {
+      protoEncoderInit (&screen);
+      screen_ready = True;
+    }
+  prvReceiveAcks ();
+  len = protoEncodeFrame (&screen, store, frame);
+  if (len == 0)
+    {
+      return;
+    }
+  if (RingBuffer_GetFree (&txring) < len)
+    {
+      screen.stats.dropped++;
+      return;
+    }
+  Chip_UART_SendRB (UART_SELECTION, &txring, frame, len);
+}
 
+/*
+ *	function to be called after the host's screen has been cleared: the
+ *	next frames redraw every GO
+ */
+void
+resetUARTScreen (void)
+{
+  if (screen_ready)
+    {
+      protoEncoderReset (&screen);
+    }
+}
 
+/*
+ *	function copies the bandwidth bookkeeping of the screen updates
+ */
+void
+getUARTScreenStats (proto_stats_t *stats)
+{
+  *stats = screen.stats;
+}
+
+/*
+ *	function reads the buttons that are down, as UI_LEFT | ...
+ */
+static uint8_t
+prvReadButtons (void)
+{
+  uint32_t port = Chip_GPIO_GetPortValue (LPC_GPIO, BUTTON_PORT);
+  uint8_t levels = 0;
+
+  for (uint8_t b = 0; b != NUMBER_OF_BUTTONS; ++b)
+    {
+      if (!(port & (1UL << button_pin[b])))
+	{
+	  levels |= 1U << b;
+	}
+    }
+  return levels;
+}
+
+/*
+ *	function sets the RI timer to interrupt when the next debounce
+ *	lock-out expires; with none, a compare value just behind the counter
+ *	keeps it quiet for a whole wrap
+ */
+static void
+prvArmButtonTimer (uint32_t now)
+{
+  uint32_t deadline;
+
+  if (!inputDebounceDeadline (&buttons, &deadline))
+    {
+      deadline = now - 1;
+    }
+  Chip_RIT_SetCOMPVAL (LPC_RITIMER, deadline);
+}
+
+/*
+ *	function hands an accepted change of the buttons to the tasks
+ */
+static void
+prvPostButtons (const ui_event_t *ev, portBASE_TYPE *pxWoken)
+{
+  if (xQueueSendFromISR (xButtonQueue, ev, pxWoken) != pdTRUE)
+    {
+      button_events_dropped++;
+    }
+}
+
+/*
+ *	GPIO interrupt handler (shares EINT3): stamps the button edges and
+ *	debounces them
+ */
+void
+EINT3_IRQHandler (void)
+{
+  uint32_t now = Chip_RIT_GetCounter (LPC_RITIMER);
+  uint32_t pins = Chip_GPIOINT_GetStatusFalling (LPC_GPIOINT, BUTTON_INT_PORT)
+      | Chip_GPIOINT_GetStatusRising (LPC_GPIOINT, BUTTON_INT_PORT);
+  uint8_t levels = prvReadButtons ();
+  portBASE_TYPE xWoken = pdFALSE;
+  ui_event_t ev;
+
+  Chip_GPIOINT_ClearIntStatus (LPC_GPIOINT, BUTTON_INT_PORT, pins);
+  for (uint8_t b = 0; b != NUMBER_OF_BUTTONS; ++b)
+    {
+      if ((pins & (1UL << button_pin[b]))
+	  && inputDebounceEdge (&buttons, b, (levels >> b) & 1, now, &ev))
+	{
+	  prvPostButtons (&ev, &xWoken);
+	}
+    }
+  prvArmButtonTimer (now);
+  portEND_SWITCHING_ISR(xWoken);
+}
+
+/*
+ *	RI timer interrupt handler: a debounce lock-out has expired, so the
+ *	buttons are sampled again
+ */
+void
+RIT_IRQHandler (void)
+{
+  uint32_t now = Chip_RIT_GetCounter (LPC_RITIMER);
+  portBASE_TYPE xWoken = pdFALSE;
+  ui_event_t ev;
+
+  Chip_RIT_ClearInt (LPC_RITIMER);
+  if (inputDebounceExpire (&buttons, prvReadButtons (), now, &ev))
+    {
+      prvPostButtons (&ev, &xWoken);
+    }
+  prvArmButtonTimer (now);
+  portEND_SWITCHING_ISR(xWoken);
+}
+
+/*
+ *	function sets up the buttons, their interrupts and the RI timer;
+ *	called by prvSetupHardware(), before the scheduler starts
+ */
+void
+initButtons (void)
+{
+  /* free-running, the compare value is only used for the lock-outs */
+  Chip_RIT_Init (LPC_RITIMER);
+  rit_ticks_per_us = Chip_Clock_GetPeripheralClockRate (SYSCTL_PCLK_RIT)
+      / 1000000;
+
+  Chip_GPIOINT_Init (LPC_GPIOINT);
+  for (uint8_t b = 0; b != NUMBER_OF_BUTTONS; ++b)
+    {
+      Chip_IOCON_PinMux (LPC_IOCON, BUTTON_PORT, button_pin[b],
+			 IOCON_MODE_PULLUP, IOCON_FUNC0);
+      Chip_GPIO_SetPinDIRInput (LPC_GPIO, BUTTON_PORT, button_pin[b]);
+    }
+
+  inputDebounceInit (&buttons, BUTTON_DEBOUNCE_US * rit_ticks_per_us,
+		     prvReadButtons ());
+  inputLatchInit (&latch);
+  xButtonQueue = xQueueCreate(BUTTON_QUEUE_LENGTH, sizeof(ui_event_t));
+  prvArmButtonTimer (Chip_RIT_GetCounter (LPC_RITIMER));
+
+  Chip_GPIOINT_SetIntFalling (LPC_GPIOINT, BUTTON_INT_PORT, BUTTON_PINS);
+  Chip_GPIOINT_SetIntRising (LPC_GPIOINT, BUTTON_INT_PORT, BUTTON_PINS);
+  NVIC_SetPriority (EINT3_IRQn, BUTTON_IRQ_PRIORITY);
+  NVIC_EnableIRQ (EINT3_IRQn);
+  NVIC_SetPriority (RITIMER_IRQn, BUTTON_IRQ_PRIORITY);
+  NVIC_EnableIRQ (RITIMER_IRQn);
+}
+
+/*
+ *	function blocks for the next change of the buttons, for up to
+ *	xTicksToWait; for menus, which see every press, so the game's latch
+ *	is left alone
+ */
+bool_t
+waitButtons (ui_event_t *ev, portTickType xTicksToWait)
+{
+  return (xQueueReceive (xButtonQueue, ev, xTicksToWait) == pdTRUE) ?
+      True : False;
+}
+
+/*
+ *	function gives the buttons for the next game step, see
+ *	inputLatchStep(); returns True if there was new input
+ */
+bool_t
+getButtons (ui_t *ui)
+{
+  ui_event_t ev;
+
+  while (xQueueReceive (xButtonQueue, &ev, 0) == pdTRUE)
+    {
+      inputLatchEvent (&latch, &ev);
+    }
+  return inputLatchStep (&latch, ui);
+}
+
+/*
+ *	function to be called once a step's screen update has been sent,
+ *	for the input latency
+ */
+void
+markButtonsShown (void)
+{
+  inputLatchShown (&latch, Chip_RIT_GetCounter (LPC_RITIMER));
+}
+
+/*
+ *	function copies the bookkeeping of the buttons
+ */
+void
+getButtonStats (button_stats_t *stats)
+{
+  stats->edges = buttons.edges;
+  stats->bounces = buttons.bounces;
+  stats->events = buttons.events;
+  stats->dropped = button_events_dropped;
+  stats->shown = latch.shown;
+  stats->last_latency_us = latch.last_latency / rit_ticks_per_us;
+  stats->max_latency_us = latch.max_latency / rit_ticks_per_us;
+  stats->mean_latency_us =
+      latch.shown ? latch.total_latency / latch.shown / rit_ticks_per_us : 0;
+}
+
+/*
+ *	DMA interrupt handler: the controller has moved on to the other half
+ *	of the ring, so the half it finished is mixed again
+ */
+void
+DMA_IRQHandler (void)
+{
+  if (Chip_GPDMA_Interrupt (LPC_GPDMA, sound_channel) == SUCCESS)
+    {
+      audioMix (&mixer, sound_ring[sound_half], AUDIO_BLOCK);
+      sound_half ^= 1;
+    }
+  else
+    {
+      sound_dma_errors++;
+    }
+}
+
+/*
+ *	function sets up the DAC, and the DMA controller to feed it from the
+ *	ring; called by prvSetupHardware(), before the scheduler starts
+ */
+void
+initSound (void)
+{
+  uint32_t dac_clk;
+
+  audioInit (&mixer);
+  audioMix (&mixer, sound_ring[0], AUDIO_BLOCK); // silence, to start
+  audioMix (&mixer, sound_ring[1], AUDIO_BLOCK);
+
+  /* the DAC asks for a sample every time its counter runs out */
+  Chip_DAC_Init (LPC_DAC);
+  Chip_Clock_SetPCLKDiv (SYSCTL_PCLK_DAC, SYSCTL_CLKDIV_1);
+  dac_clk = Chip_Clock_GetPeripheralClockRate (SYSCTL_PCLK_DAC);
+  Chip_DAC_SetDMATimeOut (LPC_DAC, dac_clk / AUDIO_SAMPLE_RATE);
+  Chip_DAC_ConfigDAConverterControl (LPC_DAC, DAC_CNT_ENA | DAC_DMA_ENA);
+
+  /* two descriptors linked in a circle, each interrupting when done */
+  Chip_GPDMA_Init (LPC_GPDMA);
+  sound_channel = Chip_GPDMA_GetFreeChannel (LPC_GPDMA, GPDMA_CONN_DAC);
+  for (uint8_t h = 0; h != 2; ++h)
+    {
+      Chip_GPDMA_PrepareDescriptor (LPC_GPDMA, &sound_lli[h],
+				    (uint32_t) sound_ring[h], GPDMA_CONN_DAC,
+				    AUDIO_BLOCK,
+				    GPDMA_TRANSFERTYPE_M2P_CONTROLLER_DMA,
+				    &sound_lli[h ^ 1]);
+      sound_lli[h].ctrl |= GPDMA_DMACCxControl_I;
+    }
+  NVIC_SetPriority (DMA_IRQn, SOUND_IRQ_PRIORITY);
+  NVIC_EnableIRQ (DMA_IRQn);
+  Chip_GPDMA_SGTransfer (LPC_GPDMA, sound_channel, &sound_lli[0],
+			 GPDMA_TRANSFERTYPE_M2P_CONTROLLER_DMA);
+}
+
+/*
+ *	function starts a sound effect, heard from the next block mixed
+ */
+void
+playSound (const sound_t *sound, uint8_t volume)
+{
+  taskENTER_CRITICAL(); // the mixer belongs to DMA_IRQHandler()
+  audioPlay (&mixer, sound, volume);
+  taskEXIT_CRITICAL();
+}
+
+/*
+ *	function copies the bookkeeping of the mixer
+ */
+void
+getSoundStats (audio_stats_t *stats)
+{
+  taskENTER_CRITICAL();
+  *stats = mixer.stats;
+  taskEXIT_CRITICAL();
 }
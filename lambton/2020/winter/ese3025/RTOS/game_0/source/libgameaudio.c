@@ -0,0 +1,222 @@
+/*
+ * libgameaudio.c
+ *
+ * Game Audio Library
+ *
+ * Voices and the mixer, see libgameaudio.h.
+ *
+ */
+
+#include <string.h>
+#include "libgameaudio.h"
+#include "libtakisbasics.h"
+
+/* IMA ADPCM */
+static const int16_t adpcm_step[89] =
+  { 7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41,
+      45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190,
+      209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724,
+      796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272,
+      2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132,
+      7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500,
+      20350, 22385, 24623, 27086, 29794, 32767 };
+static const int8_t adpcm_index[8] =
+  { -1, -1, -1, -1, 2, 4, 6, 8 };
+
+/*****************************************************************************
+ *
+ * PRIVATE FUNCTIONS
+ *
+ *****************************************************************************/
+
+/*
+ * functions add n samples of a voice, at its volume, to the block
+ */
+static void
+prvMixPCM8 (audio_voice_t *v, int32_t *acc, uint16_t n)
+{
+  const int8_t *src = (const int8_t *) v->sound->data + v->pos;
+  int32_t gain = v->volume << 8; // 8-bit samples to 16 bits, and the volume
+
+  for (uint16_t i = 0; i != n; ++i)
+    {
+      acc[i] += (src[i] * gain) >> 8;
+    }
+  v->pos += n;
+}
+
+static void
+prvMixADPCM (audio_voice_t *v, int32_t *acc, uint16_t n)
+{
+  const uint8_t *src = v->sound->data;
+  int32_t predictor = v->predictor;
+  int8_t index = v->index;
+  uint16_t pos = v->pos;
+  uint8_t code;
+  int32_t step, diff;
+
+  for (uint16_t i = 0; i != n; ++i, ++pos)
+    {
+      code = (pos & 1) ? (src[pos >> 1] >> 4) : (src[pos >> 1] & 0x0F);
+      step = adpcm_step[index];
+      diff = step >> 3;
+      if (code & 4)
+	diff += step;
+      if (code & 2)
+	diff += step >> 1;
+      if (code & 1)
+	diff += step >> 2;
+      predictor += (code & 8) ? -diff : diff;
+      if (predictor > 32767)
+	predictor = 32767;
+      else if (predictor < -32768)
+	predictor = -32768;
+      index += adpcm_index[code & 7];
+      if (index < 0)
+	index = 0;
+      else if (index > 88)
+	index = 88;
+      acc[i] += (predictor * v->volume) >> 8;
+    }
+  v->predictor = predictor;
+  v->index = index;
+  v->pos = pos;
+}
+
+/*****************************************************************************
+ *
+ * PUBLIC FUNCTIONS
+ *
+ *****************************************************************************/
+
+/*
+ * function starts a mixer with every voice free
+ */
+void
+audioInit (audio_mixer_t *mixer)
+{
+  memset (mixer, 0, sizeof(audio_mixer_t));
+  for (uint8_t c = 0; c != AUDIO_CHANNELS; ++c)
+    {
+      mixer->voice[c].sound = NULL;
+    }
+}
+
+/*
+ * function starts a sound at volume (AUDIO_VOLUME_FULL is full scale) in
+ * a free voice or, with none free, in the voice closest to finishing its
+ * sound; returns the voice
+ */
+uint8_t
+audioPlay (audio_mixer_t *mixer, const sound_t *sound, uint8_t volume)
+{
+  uint8_t channel = 0;
+  uint16_t left = UINT16_MAX, l;
+
+  for (uint8_t c = 0; c != AUDIO_CHANNELS; ++c)
+    {
+      if (mixer->voice[c].sound == NULL)
+	{
+	  channel = c;
+	  left = 0;
+	  break;
+	}
+      l = mixer->voice[c].sound->samples - mixer->voice[c].pos;
+      if (l < left)
+	{
+	  channel = c;
+	  left = l;
+	}
+    }
+  if (left != 0)
+    {
+      mixer->stats.stolen++;
+    }
+  mixer->stats.started++;
+
+  audio_voice_t *v = &mixer->voice[channel];
+  v->pos = 0;
+  v->volume = volume;
+  v->index = 0;
+  v->predictor = 0;
+  v->sound = sound;
+  return channel;
+}
+
+/*
+ * function silences a voice
+ */
+void
+audioStop (audio_mixer_t *mixer, uint8_t channel)
+{
+  mixer->voice[channel].sound = NULL;
+}
+
+/*
+ * function counts the voices playing
+ */
+uint8_t
+audioActive (const audio_mixer_t *mixer)
+{
+  uint8_t active = 0;
+
+  for (uint8_t c = 0; c != AUDIO_CHANNELS; ++c)
+    {
+      active += (mixer->voice[c].sound != NULL);
+    }
+  return active;
+}
+
+/*
+ * function mixes the next n samples, n up to AUDIO_BLOCK, of every voice
+ * into out, as DAC register values; a voice is freed when its sound ends
+ */
+void
+audioMix (audio_mixer_t *mixer, uint16_t *out, uint16_t n)
+{
+  int32_t *acc = mixer->acc;
+  int32_t s;
+  uint16_t m;
+
+  memset (acc, 0, n * sizeof(acc[0]));
+  for (uint8_t c = 0; c != AUDIO_CHANNELS; ++c)
+    {
+      audio_voice_t *v = &mixer->voice[c];
+
+      if (v->sound == NULL)
+	{
+	  continue;
+	}
+      m = v->sound->samples - v->pos;
+      if (m > n)
+	{
+	  m = n;
+	}
+      if (v->sound->format == SOUND_ADPCM)
+	{
+	  prvMixADPCM (v, acc, m);
+	}
+      else
+	{
+	  prvMixPCM8 (v, acc, m);
+	}
+      if (v->pos == v->sound->samples)
+	{
+	  v->sound = NULL;
+	}
+      mixer->stats.voice_blocks++;
+    }
+
+  /* 16 bits to the DAC's 10, around its midpoint */
+  for (uint16_t i = 0; i != n; ++i)
+    {
+      s = (acc[i] >> (16 - AUDIO_DAC_BITS)) + AUDIO_DAC_MID;
+      if (s < 0 || s >= (1 << AUDIO_DAC_BITS))
+	{
+	  s = (s < 0) ? 0 : (1 << AUDIO_DAC_BITS) - 1;
+	  mixer->stats.clipped++;
+	}
+      out[i] = s << AUDIO_DAC_SHIFT;
+    }
+  mixer->stats.blocks++;
+}
@@ -0,0 +1,771 @@
+/*
+ * libgamecore.c
+ *
+ * Game Logic Library
+ *
+ * One call to gameStep() advances the whole game by one fixed time step;
+ * it replaces the task that used to animate each GO, so the GO state
+ * machines are stepped here, in slot order, and never block.
+ *
+ */
+
+#include <stdlib.h>
+#include "libgameds.h"
+#include "libgamecore.h"
+#include "libtakisbasics.h"
+
+/*************************************************************************
+ *
+ *
+ * PRIVATE FUNCTIONS
+ *
+ *
+ *************************************************************************/
+
+/*
+ *
+ * function determines if an event happens, based on how likely it is...
+ * the likelihood is passed in as a parameter
+ *
+ */
+static bool_t
+prvYesHappens (uint32_t *rng, likely_t prob)
+{
+  /*
+   HighlyLikely = 0U,		// < PRNG_MAX (probability \approx 1)
+   QuiteLikely = 1U, 		// < PRNG_MAX / 2, prob. = 50 %
+   ModeratelyLikely = 2U, 	// < PRNG_MAX / 4, prob. = 25 %
+   Maybe = 3U,			// < PRNG_MAX / 8, prob. = 12.5 %
+   Unlikely = 4U,		// < PRNG_MAX / 16, prob. = 6.25 %
+   QuiteUnLikely = 5U, 		// < PRNG_MAX / 32, prob. = 3.125 %
+   YeahRight = 6U,		// < PRNG_MAX / 64, prob. = 1.5625 %
+   */
+  uint32_t r = prngNext (rng); /* pull my finger */
+  register uint32_t s = PRNG_MAX;
+
+  s = s >> prob;
+  if (r < s)
+    {
+      return True;
+    }
+  else
+    {
+      return False;
+    }
+}
+
+/*
+ * function spawns a GO which starts out moving with velocity (vx, vy)
+ */
+static go_slot_t
+prvSpawnMoving (game_t *this_game, gotype_t kind, go_coord_t pos,
+		uint16_t health, uint8_t numlives, int16_t vx, int16_t vy)
+{
+  go_slot_t slot = goSpawn (&this_game->gos, kind, pos, health, numlives);
+
+  if (slot != GO_NONE)
+    {
+      this_game->gos.vx[slot] = vx;
+      this_game->gos.vy[slot] = vy;
+    }
+  return slot;
+}
+
+/*
+ *
+ * function records in the subject's seen/hits masks whether the object, of
+ * kind objKind, is in sight or in contact
+ *
+ */
+static inline void
+prvProximity (go_store_t *gos, go_slot_t subject, go_slot_t obj,
+	      gotype_t objKind)
+{
+  uint16_t distance = abs (gos->x[subject] - gos->x[obj])
+      + abs (gos->y[subject] - gos->y[obj]);
+
+  if (distance <= THRESHOLD_COLLISION)
+    {
+      /* object and subject are in contact */
+      gos->hits[subject] |= 1U << objKind;
+    }
+  if (distance <= THRESHOLD_SEEN)
+    {
+      /* object seen by subject */
+      gos->seen[subject] |= 1U << objKind;
+    }
+}
+
+/*
+ *
+ * function looks at every live object of kind objKind, in slot order
+ *
+ */
+static void
+prvScanProximities (go_store_t *gos, go_slot_t subject, gotype_t objKind)
+{
+  for (go_slot_t obj = goKindBase[objKind]; obj != goKindBase[objKind + 1];
+      ++obj)
+    {
+      if (goIsAlive (gos, obj))
+	{
+	  prvProximity (gos, subject, obj, objKind);
+	}
+    }
+}
+
+/*
+ *
+ * function looks only at the objects of kind objKind in the grid cells that
+ * overlap the square of +/- THRESHOLD_SEEN around the subject, as nothing
+ * further away can be seen
+ *
+ */
+static void
+prvGridProximities (go_store_t *gos, go_slot_t subject, gotype_t objKind)
+{
+  go_coord_t lo =
+    { gos->x[subject] - THRESHOLD_SEEN, gos->y[subject] - THRESHOLD_SEEN };
+  go_coord_t hi =
+    { gos->x[subject] + THRESHOLD_SEEN, gos->y[subject] + THRESHOLD_SEEN };
+  uint8_t first = gridCellOf (lo);
+  uint8_t last = gridCellOf (hi);
+  go_slot_t obj;
+
+  for (uint8_t row = first / GRID_COLS; row <= last / GRID_COLS; ++row)
+    {
+      for (uint8_t col = first % GRID_COLS; col <= last % GRID_COLS; ++col)
+	{
+	  for (obj = gos->grid[objKind][row * GRID_COLS + col]; obj != GO_NONE;
+	      obj = gos->cell_next[obj])
+	    {
+	      prvProximity (gos, subject, obj, objKind);
+	    }
+	}
+    }
+}
+
+/*
+ *
+ * function computes determines the "relationship" between subject and the
+ * object GOs of kind objKind, recording in the subject's seen/hits masks
+ * whether any of them is in sight or in contact; a kind with fewer than
+ * GRID_MIN_SLOTS slots is scanned, as that is quicker than visiting the
+ * grid cells (see host/impacts_bench.c), larger kinds go through the grid
+ *
+ */
+static void
+prvComputeProximities (go_store_t *gos, go_slot_t subject, gotype_t objKind)
+{
+  if (goKindBase[objKind + 1] - goKindBase[objKind] < GRID_MIN_SLOTS)
+    {
+      prvScanProximities (gos, subject, objKind);
+    }
+  else
+    {
+      prvGridProximities (gos, subject, objKind);
+    }
+}
+
+/*
+ *
+ * function called by gameStep() to impose specific collision-type or
+ * limit-induced interactions
+ *	- the subject, in slot sub, is checked (one subject only)
+ *	- if objInt is set to Other, we simply check whether the subject
+ *		is located at an extreme location, which requires that it
+ *		terminate (as in the case of a missile or a bomb reaching the
+ *		end of its path)
+ *	- otherwise, (if objInt is player, alien, kitty or baby) then we
+ *		check for collisions between subject and an object of kind
+ *		objInt; if a collision has been registered, the subject's health
+ *		is affected, and/or the subject is terminated (for example, if
+ *		the subject is the player, and the object kind is pooh, then if
+ *		a collision is detected, the player's health is reduced and/or
+ *		the player is terminated, i.e., it is killed)
+ *		- it is presumed that objInt is either a pooh or an expunger
+ *	- returns True if the subject was terminated
+ *
+ */
+static bool_t
+prvImposeConstraints (go_store_t *gos, go_slot_t sub, gotype_t objInt)
+{
+  /* perform checks by subject kind */
+  switch (gos->kind[sub])
+    {
+    case pooh: // look for pooh/bomb reaching the ground
+      if (gos->y[sub] >= YBOTTOM)
+	{
+	  goKill (gos, sub); // terminate pooh
+	  return True;
+	}
+      break;
+    case expunger: // look for expunger hitting the ceiling
+      if (gos->y[sub] <= YTOP)
+	{
+	  goKill (gos, sub); // terminate expunger
+	  return True;
+	}
+      break;
+    default: // player, alien, baby, kitty, being struck with a projectile
+      if (gos->hits[sub] & (1U << objInt))
+	{
+	  gos->flags[sub] |= GO_STRUCK; // GO reacts to being struck
+	  if (gos->health[sub] <= DAMAGE_PER_HIT) // health reduces
+	    {
+	      gos->health[sub] = 0;
+	      goKill (gos, sub);
+	      return True;
+	    }
+	  else
+	    {
+	      gos->health[sub] -= DAMAGE_PER_HIT;
+	    }
+	}
+    } // switch
+  return False;
+} // function
+
+/*
+ * function spawns the aliens and kitties the current game level calls for
+ */
+static void
+prvSpawnCast (game_t *this_game)
+{
+  go_store_t *gos = &this_game->gos;
+  uint8_t levelLambda;
+
+  /*
+   * simple way to set the game level:
+   * 	level = log2(2*LEVEL_UP_X) = 1 + log2(LEVEL_UP_X)
+   */
+  levelLambda = this_game->score / (2 * LEVEL_UP_X);
+  if (levelLambda > 8)
+    levelLambda = 8;
+  this_game->game_level = 1 << levelLambda;
+
+  /*
+   * is it time to spawn an alien? number of aliens
+   * should be (game_level + 1)
+   */
+  if (gos->number_alive[alien] < (this_game->game_level + 1))
+    {
+      /* a high probability exists of an alien being created, if there
+       * is room for another alien */
+      if (prvYesHappens (&this_game->rng, QuiteLikely))
+	{
+	  go_coord_t alien_start_posn =
+	    { XMIDDLE, YMIDDLE };
+	  goSpawn (gos, alien, alien_start_posn, ALIEN_HEALTH, 1);
+	}
+    }
+
+  /*
+   * is it time to spawn a kitty? The number of kitties should be
+   * (game_level)
+   */
+  if (gos->number_alive[kitty] < (this_game->game_level))
+    {
+      /* a some probability exists of a kitty showing up,
+       * in which case the alien's pooh may start dropping */
+      if (prvYesHappens (&this_game->rng, Maybe))
+	{
+	  go_coord_t kitties_start_posn =
+	    { XRIGHT, YBOTTOM };
+	  goSpawn (gos, kitty, kitties_start_posn, KITTY_HEALTH, KITTY_LIVES);
+	}
+    }
+}
+
+/*
+ * function steps the player: the state machine follows the buttons, and
+ * entering FIRE launches an expunger
+ */
+static void
+prvStepPlayer (game_t *this_game, go_slot_t s)
+{
+  go_store_t *gos = &this_game->gos;
+  superstateGO_t prev = gos->animstate[s];
+  superstateGO_t next = vPlayerStateMachine (prev, &this_game->user);
+
+  gos->animstate[s] = next;
+  switch (next)
+    {
+    case R0:
+    case R1:
+    case R2:
+      gos->vx[s] = 1;
+      break;
+    case L0:
+    case L1:
+    case L2:
+      gos->vx[s] = -1;
+      break;
+    default:
+      gos->vx[s] = 0;
+    }
+
+  gos->flags[s] &= ~GO_ACTION;
+  if (next == FIRE && prev != FIRE)
+    {
+      go_coord_t muzzle =
+	{ gos->x[s], gos->y[s] - 1 };
+      prvSpawnMoving (this_game, expunger, muzzle, PROJECTILE_HEALTH, 1, 0,
+		      -EXPUNGER_SPEED);
+      gos->flags[s] |= GO_ACTION;
+    }
+}
+
+/*
+ * function steps a GO that wanders left and right (aliens and babies),
+ * turning back at the edges of the field and, now and then, on a whim
+ */
+static void
+prvStepWanderer (game_t *this_game, go_slot_t s)
+{
+  go_store_t *gos = &this_game->gos;
+
+  if (gos->vx[s] == 0)
+    {
+      gos->vx[s] = prvYesHappens (&this_game->rng, QuiteLikely) ? 1 : -1;
+    }
+  if ((gos->x[s] <= XLEFT && gos->vx[s] < 0)
+      || (gos->x[s] >= XRIGHT && gos->vx[s] > 0)
+      || prvYesHappens (&this_game->rng, YeahRight))
+    {
+      gos->vx[s] = -gos->vx[s];
+    }
+  gos->animstate[s] = vAlienStateMachine (gos->animstate[s], gos->vx[s]);
+}
+
+/*
+ * function steps an alien: it wanders, and poohs, more so when it can see
+ * a kitty
+ */
+static void
+prvStepAlien (game_t *this_game, go_slot_t s)
+{
+  go_store_t *gos = &this_game->gos;
+
+  prvStepWanderer (this_game, s);
+  gos->flags[s] &= ~GO_ACTION;
+  if (prvYesHappens (&this_game->rng,
+		     (gos->seen[s] & (1U << kitty)) ? Maybe : QuiteUnLikely))
+    {
+      go_coord_t drop =
+	{ gos->x[s], gos->y[s] + 1 };
+      prvSpawnMoving (this_game, pooh, drop, PROJECTILE_HEALTH, 1, 0,
+		      POOH_SPEED);
+      gos->flags[s] |= GO_ACTION;
+    }
+}
+
+/*
+ * function steps a kitty: strolling and self-cleaning
+ */
+static void
+prvStepKitty (game_t *this_game, go_slot_t s)
+{
+  go_store_t *gos = &this_game->gos;
+  superstateGO_t next = vKittyStateMachine (gos->animstate[s],
+					    &this_game->rng);
+
+  gos->animstate[s] = next;
+  if ((gos->x[s] <= XLEFT && next == L0) || (gos->x[s] >= XRIGHT && next == R0))
+    {
+      gos->animstate[s] = STOP;
+    }
+  gos->vx[s] = (gos->animstate[s] == R0) - (gos->animstate[s] == L0);
+}
+
+/*
+ * function moves a GO by its velocity, keeping it on the playing field
+ */
+static void
+prvMoveGO (go_store_t *gos, go_slot_t s)
+{
+  int16_t x = gos->x[s] + gos->vx[s];
+  int16_t y = gos->y[s] + gos->vy[s];
+
+  if (x < XLEFT)
+    x = XLEFT;
+  else if (x > XRIGHT)
+    x = XRIGHT;
+  if (y < YTOP)
+    y = YTOP;
+  else if (y > YBOTTOM)
+    y = YBOTTOM;
+
+  if (x != gos->x[s] || y != gos->y[s])
+    {
+      goMove (gos, s, x, y);
+    }
+}
+
+/*************************************************************************
+ *
+ *
+ * PUBLIC FUNCTIONS
+ *
+ *
+ *************************************************************************/
+
+/*
+ * function to initialize game at very beginning
+ */
+void
+gameInit (game_t *this_game)
+{
+  /* every GO slot is free, the grid is empty */
+  goStoreInit (&this_game->gos);
+
+  this_game->score = 0;
+  for (size_t i = 0; i != 3; ++i)
+    this_game->playerID[i] = 'A';
+  this_game->playerID[3] = '\0';
+  this_game->game_level = 1;
+  this_game->user.left_button = False;
+  this_game->user.right_button = False;
+  this_game->user.crouch_button = False;
+  this_game->user.fire_button = False;
+  this_game->player = GO_NONE;
+  this_game->gameover = False;
+  this_game->frame = 0;
+  prngSeed (&this_game->rng, PRNG_DEFAULT_SEED);
+}
+
+/*
+ * function sets the board for a round: the player, with numlives lives to
+ * go, an alien and two babies; returns the player's slot
+ */
+go_slot_t
+gameStartRound (game_t *this_game, uint8_t numlives)
+{
+  go_coord_t player_start_posn =
+    { XMIDDLE, YBOTTOM };
+  go_coord_t alien_start_posn =
+    { XMIDDLE, YMIDDLE };
+  go_coord_t baby_start_posn_LEFT =
+    { XLEFT, YBOTTOM };
+  go_coord_t baby_start_posn_MID =
+    { XMIDDLE, YBOTTOM };
+
+  this_game->player = goSpawn (&this_game->gos, player, player_start_posn,
+			       PLAYER_HEALTH, numlives);
+  goSpawn (&this_game->gos, alien, alien_start_posn, ALIEN_HEALTH, 1);
+  goSpawn (&this_game->gos, baby, baby_start_posn_LEFT, BABY_HEALTH, 1);
+  goSpawn (&this_game->gos, baby, baby_start_posn_MID, BABY_HEALTH, 1);
+
+  return this_game->player;
+}
+
+/*
+ * function takes every GO, the player included, out of play
+ */
+void
+gameClear (game_t *this_game)
+{
+  for (go_slot_t s = 0; s != GO_POOL_SIZE; ++s)
+    {
+      goKill (&this_game->gos, s);
+    }
+}
+
+/*
+ *
+ * function advances the game by one time step, using the buttons in
+ * this_game->user:
+ *	- spawn aliens and kitties, as the game level calls for
+ *	- step the state machine of every GO and launch projectiles
+ *	- move every GO by its velocity
+ *	- find what each GO sees and touches
+ *	- impose collisions and limits
+ *
+ */
+void
+gameStep (game_t *this_game)
+{
+  go_store_t *gos = &this_game->gos;
+
+  this_game->frame++;
+  prvSpawnCast (this_game);
+
+  /*
+   * STEP THE GO STATE MACHINES
+   */
+  for (go_slot_t s = 0; s != GO_POOL_SIZE; ++s)
+    {
+      if (!goIsAlive (gos, s))
+	continue;
+      gos->flags[s] &= ~GO_STRUCK;
+      switch (gos->kind[s])
+	{
+	case player:
+	  prvStepPlayer (this_game, s);
+	  break;
+	case alien:
+	  prvStepAlien (this_game, s);
+	  break;
+	case baby:
+	  prvStepWanderer (this_game, s);
+	  break;
+	case kitty:
+	  prvStepKitty (this_game, s);
+	  break;
+	default: // poohs and expungers keep going
+	  break;
+	}
+    }
+
+  /*
+   * MOVE, THEN UPDATE THE INTERACTIONS
+   */
+  for (go_slot_t s = 0; s != GO_POOL_SIZE; ++s)
+    {
+      gos->seen[s] = 0;
+      gos->hits[s] = 0;
+      if (goIsAlive (gos, s))
+	{
+	  prvMoveGO (gos, s);
+	}
+    }
+
+  /* check alien proximity to kitties and expungers */
+  for (go_slot_t s = goKindBase[alien]; s != goKindBase[alien + 1]; ++s)
+    {
+      if (goIsAlive (gos, s))
+	{
+	  prvComputeProximities (gos, s, expunger);
+	  prvComputeProximities (gos, s, kitty);
+	}
+    }
+  /* check player proximity to poohs, kitties or babies */
+  for (go_slot_t s = goKindBase[player]; s != goKindBase[player + 1]; ++s)
+    {
+      if (goIsAlive (gos, s))
+	{
+	  prvComputeProximities (gos, s, pooh);
+	  prvComputeProximities (gos, s, kitty);
+	  prvComputeProximities (gos, s, baby);
+	}
+    }
+  /* check babies and kitties for proximity to poohs */
+  for (go_slot_t s = goKindBase[baby]; s != goKindBase[kitty + 1]; ++s)
+    {
+      if (goIsAlive (gos, s))
+	{
+	  prvComputeProximities (gos, s, pooh);
+	}
+    }
+
+  /*
+   *
+   * IMPOSE COLLISION/LIMIT INTERACTIONS (characters have no say here!)
+   *
+   * 	- players:
+   * 		- killed from contact with poohs
+   * 	- aliens:
+   * 		- die from enough expunger strikes
+   * 	- babies:
+   * 		- vapourized from contact with poohs
+   * 	- kitties:
+   * 		- essentially impervious, but have negative health
+   * 		effects from pooh contact
+   * 	- poohs:
+   * 		- hit the ground
+   * 	- expungers:
+   * 		- reach the ceiling
+   *
+   */
+  static const gotype_t hazard[NUMBER_OF_GO_TYPES] =
+    { pooh, expunger, other, other, pooh, pooh };
+
+  for (go_slot_t s = 0; s != GO_POOL_SIZE; ++s)
+    {
+      if (goIsAlive (gos, s)
+	  && prvImposeConstraints (gos, s, hazard[gos->kind[s]])
+	  && gos->kind[s] == alien)
+	{
+	  this_game->score += SCORE_ALIEN;
+	}
+    }
+}
+
+/*
+ *
+ * function determines player GO animation state, based on user input
+ * every GO must have a STOP state, used as a default initial state of being
+ * STOP, FIRE, CROUCH, R0, R1, R2, L0, L1, L2, // basic animation states, player
+ * U0, D0, // additional states needed by aliens who move (U)p and (D)own
+ * SELFCLEAN0, SELFCLEAN1, SELFCLEAN2, SELFCLEAN3 // states just for kitties
+ *
+ */
+superstateGO_t
+vPlayerStateMachine (superstateGO_t current_state, const ui_t *ui)
+{
+  superstateGO_t next_state = current_state;
+
+  switch (current_state)
+    {
+    case R0:
+      next_state = R1;
+      break;
+    case R1:
+      next_state = R2;
+      break;
+    case R2:
+      if (ui->left_button)
+	{
+	  next_state = STOP;
+	}
+      else
+	{
+	  next_state = R0;
+	}
+      break;
+    case L0:
+      next_state = L1;
+      break;
+    case L1:
+      next_state = L2;
+      break;
+    case L2:
+      if (ui->right_button)
+	{
+	  next_state = STOP;
+	}
+      else
+	{
+	  next_state = L0;
+	}
+      break;
+    case STOP:
+      if (ui->right_button)
+	{
+	  next_state = R0;
+	}
+      else if (ui->left_button)
+	{
+	  next_state = L0;
+	}
+      else if (ui->fire_button)
+	{
+	  next_state = FIRE;
+	}
+      else if (ui->crouch_button)
+	{
+	  next_state = CROUCH;
+	}
+      break;
+    case CROUCH:
+      if (ui->fire_button || ui->left_button || ui->right_button)
+	{
+	  next_state = STOP;
+	}
+      break;
+    case FIRE:
+      if (ui->crouch_button || ui->left_button || ui->right_button)
+	{
+	  next_state = STOP;
+	}
+      break;
+    default:
+      next_state = STOP;
+    }
+  return next_state;
+}
+
+/*
+ *
+ * function determines alien GO animation state, based on the direction
+ * it is moving in
+ *
+ * every GO must have a STOP state, used as a default initial state of being
+ * STOP, FIRE, CROUCH, R0, R1, R2, L0, L1, L2, // basic animation states, player
+ * U0, D0, // additional states needed by aliens who move (U)p and (D)own
+ * SELFCLEAN0, SELFCLEAN1, SELFCLEAN2, SELFCLEAN3 // states just for kitties
+ *
+ */
+superstateGO_t
+vAlienStateMachine (superstateGO_t current_state, int16_t vx)
+{
+  superstateGO_t next_state = current_state;
+  int velocity = vx;
+
+  // determine direction of velocity
+  bool_t moving_right = sgn_bool (&velocity);
+
+  switch (current_state)
+    {
+    case STOP:
+      if (moving_right)
+	next_state = R0;
+      else
+	next_state = L0;
+      break;
+    case R0:
+      if (!moving_right)
+	next_state = STOP;
+      break;
+    case L0:
+      if (moving_right)
+	next_state = STOP;
+      break;
+    default:
+      next_state = STOP;
+    }
+  return next_state;
+}
+
+/*
+ *
+ * function determines kitty GO animation state: a kitty strolls about and,
+ * when it stops, may go through its self-cleaning routine; the game's
+ * random number generator, rng, decides when
+ *
+ */
+superstateGO_t
+vKittyStateMachine (superstateGO_t current_state, uint32_t *rng)
+{
+  superstateGO_t next_state = current_state;
+
+  switch (current_state)
+    {
+    case STOP:
+      if (prvYesHappens (rng, Unlikely))
+	next_state = SELFCLEAN0;
+      else if (prvYesHappens (rng, Maybe))
+	next_state = prvYesHappens (rng, QuiteLikely) ? R0 : L0;
+      break;
+    case R0:
+    case L0:
+      if (prvYesHappens (rng, Unlikely))
+	next_state = STOP;
+      break;
+    case SELFCLEAN0:
+      next_state = SELFCLEAN1;
+      break;
+    case SELFCLEAN1:
+      next_state = SELFCLEAN2;
+      break;
+    case SELFCLEAN2:
+      next_state = SELFCLEAN3;
+      break;
+    default:
+      next_state = STOP;
+    }
+  return next_state;
+}
+
+/*
+ *
+ * function provides an integer-friendly l1 metric,
+ * namely, the sum of the absolute values of the element-wise
+ * differences
+ *
+ */
+uint16_t
+uiCompareGODistance (go_coord_t A, go_coord_t B)
+{
+  return abs (A.X - B.X) + abs (A.Y - B.Y);
+}
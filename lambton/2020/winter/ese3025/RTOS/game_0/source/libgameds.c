@@ -7,219 +7,237 @@
  *      Author: takis
  */
 
-#include "FreeRTOS.h"
-#include "task.h"
 #include <stdlib.h>
 #include "libgameds.h"
 #include "libtakisbasics.h"
 
+/* first slot of each GO kind, in gotype_t order */
+const go_slot_t goKindBase[NUMBER_OF_GO_TYPES + 1] =
+  { GO_BASE_PLAYER, GO_BASE_ALIEN, GO_BASE_POOH, GO_BASE_EXPUNGER,
+      GO_BASE_BABY, GO_BASE_KITTY, GO_POOL_SIZE };
+
 /*****************************************************************************
  *
  * FUNCTIONS
  *
  *****************************************************************************/
 
-/* function sets up very basic default settings for a newly created GO
- *
- * 	NB: presumes that passed in GO pointer already points to valid memory
- *
+/*
+ * function empties the GO store: every slot is free, the grid is empty
  */
-go_t*
-getGODefaults (go_t *pRet, char taskstring[])
+void
+goStoreInit (go_store_t *store)
 {
-  /*
-   * GO IDs:
-   * 			0x0000 000q: players
-   * 			0x0000 00q0: aliens
-   * 			0x0000 0q00: poohs
-   * 			0x0000 q000: expungers
-   * 			0x000q 0000: babies
-   * 			0x00q0 0000: kitties
-   *
-   * 			where q \in {0,1,2,3,4,5,6,7,8,9,A,B,C,D,E,F}
-   *
-   */
-  pRet->ID = 0x00000000UL; /* to be defined by addGONode() */
-  pRet->go_level = 1;
-  pRet->health = 512;
-  pRet->alive = True;
-  pRet->active = True;
-  pRet->gameover = False;
-  pRet->pos.X = 0;
-  pRet->pos.Y = 0;
-  pRet->des_vel.X = 0;
-  pRet->des_vel.Y = 0;
-  pRet->can_move = True;
-  pRet->acc.X = 0;
-  pRet->acc.Y = 0;
-  pRet->animstate = STOP;
-  pRet->move_left = False;
-  pRet->move_right = False;
-  pRet->crouch_or_extra = False;
-  pRet->shoot_or_pooh = False;
-  pRet->numlives = 3; /* by default, every GO is made with 3 lives */
-  pRet->interactions = NULL;
-  pRet->task = NULL;
-  pRet->taskText = taskstring;
-  pRet->pNext = NULL;
-  pRet->pPrev = NULL;
-
-  return pRet;
+  for (size_t w = 0; w != GO_BITMAP_WORDS; ++w)
+    {
+      store->alive[w] = 0;
+    }
+  for (size_t k = 0; k != NUMBER_OF_GO_TYPES; ++k)
+    {
+      /* push the slots so that the lowest one is handed out first */
+      store->number_free[k] = 0;
+      for (go_slot_t s = goKindBase[k + 1]; s != goKindBase[k]; --s)
+	{
+	  store->free_slots[goKindBase[k] + store->number_free[k]++] = s - 1;
+	}
+      store->number_alive[k] = 0;
+      for (size_t c = 0; c != GRID_ROWS * GRID_COLS; ++c)
+	{
+	  store->grid[k][c] = GO_NONE;
+	}
+    }
+  for (go_slot_t s = 0; s != GO_POOL_SIZE; ++s)
+    {
+      store->cell[s] = GRID_NO_CELL;
+    }
 }
 
 /*
- * creates a basic GO node, with default information based on GO type
+ * function creates a GO of the given kind, with default settings, and puts
+ * it in the grid; returns GO_NONE when all slots of that kind are taken
  */
-go_t*
-createDefaultGONode (game_t *this_game, uint8_t GOtype)
+go_slot_t
+goSpawn (go_store_t *store, gotype_t kind, go_coord_t pos, uint16_t health,
+	 uint8_t numlives)
 {
-  /* GOtype values:
-   * 		0 -> player
-   * 		1 -> alien
-   * 		2 -> poohs
-   * 		3 -> expungers
-   * 		4 -> babies
-   * 		5 -> kitties
-   */
-
-  go_t *pNew = (go_t *) pvPortMalloc (sizeof(go_t));
-
-  switch (GOType)
+  go_slot_t slot;
+
+  if (store->number_free[kind] == 0)
     {
-    case 0: // player
-      {
-	pNew = getGODefaults (pNew, "player task");
-	return pNew;
-      }
-    case 1: // aliens
-      {
-	pNew = getGODefaults (pNew, "aliens task");
-	this_game->number_of_aliens++;
-	return pNew;
-      }
-    case 2: // poohs
-      {
-	pNew = getGODefaults (pNew, "poohs (bombs) task");
-	this_game->number_of_poohs++;
-	return pNew;
-      }
-    case 3: // expungers
-      {
-	pNew = getGODefaults (pNew, "expungers task");
-	this_game->number_of_expungers++;
-	return pNew;
-      }
-    case 4: // babies
-      {
-	pNew = getGODefaults (pNew, "babies task");
-	this_game->number_of_babies++;
-	return pNew;
-      }
-    case 5: // kitties
-      {
-	pNew = getGODefaults (pNew, "kitties task");
-	this_game->number_of_kitties++;
-	return pNew;
-      }
+      return GO_NONE;
     }
+  slot = store->free_slots[goKindBase[kind] + --store->number_free[kind]];
+  store->number_alive[kind]++;
+
+  store->x[slot] = pos.X;
+  store->y[slot] = pos.Y;
+  store->vx[slot] = 0;
+  store->vy[slot] = 0;
+  store->health[slot] = health;
+  store->kind[slot] = kind;
+  store->animstate[slot] = STOP;
+  store->numlives[slot] = numlives;
+  store->flags[slot] = GO_CAN_MOVE;
+  store->seen[slot] = 0;
+  store->hits[slot] = 0;
+  store->alive[slot >> 5] |= 1UL << (slot & 31);
+  gridInsertGO (store, slot);
+
+  return slot;
 }
 
 /*
- *
- * creates a GO, adding it to the GO master list (e.g., this_game->aliens
- * or this_game->babies)
- *
+ * function removes a GO from play and returns its slot to the free stack
  */
-go_t*
-addGONode (game_t *this_game, go_t* pGOHead, uint8_t GOtype,
-	   go_coord_t GOstartcoord, uint32_t ID)
+void
+goKill (go_store_t *store, go_slot_t slot)
 {
-  go_t* pW = pGOHead; /* working pointer */
+  gotype_t kind = store->kind[slot];
 
-  if (pW == NULL)
+  if (!goIsAlive (store, slot))
     {
-      /* create the first instance of this GO ... need to properly position and
-       * initialize an object before game play can resume */
-      go_t *pNode = createDefaultGONode (this_game, GOtype); // default settings
-      pNode->kind = GOtype;
-      pNode->ID = ID;
-      pNode->pos = GOstartcoord;
-      pW = pNode;
+      return;
     }
-  else
+  gridRemoveGO (store, slot);
+  store->alive[slot >> 5] &= ~(1UL << (slot & 31));
+  store->free_slots[goKindBase[kind] + store->number_free[kind]++] = slot;
+  store->number_alive[kind]--;
+}
+
+/*
+ * function moves a GO, keeping the grid up to date
+ */
+void
+goMove (go_store_t *store, go_slot_t slot, int16_t x, int16_t y)
+{
+  store->x[slot] = x;
+  store->y[slot] = y;
+  gridMoveGO (store, slot);
+}
+
+/*
+ * function seeds a random number generator; xorshift gets stuck at 0, so
+ * a zero seed picks the default one
+ */
+void
+prngSeed (uint32_t *state, uint32_t seed)
+{
+  *state = (seed != 0) ? seed : PRNG_DEFAULT_SEED;
+}
+
+/*
+ * function returns the next number from a xorshift32 generator
+ */
+uint32_t
+prngNext (uint32_t *state)
+{
+  uint32_t x = *state;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *state = x;
+  return x;
+}
+
+/*
+ * functions to pack the buttons into one byte, and back
+ */
+uint8_t
+uiPack (const ui_t *ui)
+{
+  return (ui->left_button ? UI_LEFT : 0) | (ui->right_button ? UI_RIGHT : 0)
+      | (ui->crouch_button ? UI_CROUCH : 0) | (ui->fire_button ? UI_FIRE : 0);
+}
+
+void
+uiUnpack (uint8_t bits, ui_t *ui)
+{
+  ui->left_button = (bits & UI_LEFT) ? True : False;
+  ui->right_button = (bits & UI_RIGHT) ? True : False;
+  ui->crouch_button = (bits & UI_CROUCH) ? True : False;
+  ui->fire_button = (bits & UI_FIRE) ? True : False;
+}
+
+/*
+ * function maps a position to its grid cell; positions off the playing
+ * field are clamped to the nearest border cell
+ */
+uint8_t
+gridCellOf (go_coord_t pos)
+{
+  int16_t col = pos.X / GRID_CELL_SIZE;
+  int16_t row = pos.Y / GRID_CELL_SIZE;
+
+  if (col < 0)
+    col = 0;
+  else if (col >= GRID_COLS)
+    col = GRID_COLS - 1;
+  if (row < 0)
+    row = 0;
+  else if (row >= GRID_ROWS)
+    row = GRID_ROWS - 1;
+
+  return (uint8_t) (row * GRID_COLS + col);
+}
+
+/*
+ * function puts a GO at the head of the list of its cell, O(1)
+ */
+void
+gridInsertGO (go_store_t *store, go_slot_t slot)
+{
+  uint8_t c = gridCellOf (goPosition (store, slot));
+  go_slot_t *pHead = &store->grid[store->kind[slot]][c];
+
+  store->cell[slot] = c;
+  store->cell_prev[slot] = GO_NONE;
+  store->cell_next[slot] = *pHead;
+  if (*pHead != GO_NONE)
     {
-      /* find the next available opening in the list */
-      while (pW->pNext != NULL)
-	{
-	  pW = pW->pNext;
-	}
-      /* now add the GO there, with the proper settings */
-      pW->pNext = createDefaultGONode (this_game, GOtype); // default settings
-      pW->pNext->kind = GOtype;
-      pW->pNext->ID = ID;
-      pW->pNext->pos = GOstartcoord;
-      pW->pNext->pPrev = pW;
+      store->cell_prev[*pHead] = slot;
     }
-  return pW; /* return a pointer to the new element */
+  *pHead = slot;
 }
 
 /*
- * function to edit the game "small lists" of type go_list_t
+ * function takes a GO out of its cell, O(1)
  */
 void
-prvUpdateInteractionList (go_t *pSub, go_t *pObj, uint16_t distance,
-			  bool_t collision, bool_t seen)
+gridRemoveGO (go_store_t *store, go_slot_t slot)
 {
-  go_list_t *pW = pSub;
-  go_list_t *ppW;
-  size_t obj_ID = pObj->ID;
-  gotype_t obj_kind = pObj->kind;
-
-  /* look for obj in sub's interaction list */
-  bool_t found = False;
-  while (pW != NULL)
+  go_slot_t next = store->cell_next[slot];
+  go_slot_t prev = store->cell_prev[slot];
+
+  if (store->cell[slot] == GRID_NO_CELL)
     {
-      ppW = pW;
-      if ((pW->ID) == obj_ID)
-	{
-	  found = True;
-	  break;
-	}
-      pW = pW->pNext;
+      return;
     }
-  /* if obj not found, add it to the list */
-  if (!found)
+  if (prev != GO_NONE)
     {
-      go_list_t *pNode = (go_list_t*) pvPortMalloc (sizeof(go_list_t));
-      pNode->kind = obj_kind;
-      pNode->ID = obj_ID;
-      pNode->distance = distance;
-      pNode->seen = seen;
-      pNode->collision = collision;
-      pNode->pNext = NULL;
-      pNode->pPrev = ppW;
-      ppW->pNext = pNode;
+      store->cell_next[prev] = next;
     }
   else
     {
-      /* obj is already on the interaction list; if already in collision,
-       * must remain so; if unseen, and not in collision, remove from list */
-      if (pW->collision == False)
-	{
-	  if ((!seen) && (!collision))
-	    {
-	      /* remove the node */
-	      ppW->pNext = pW->pNext;
-	      (pW->pNext)->pPrev = ppW;
-	      vPortFree ((void *) pW);
-	    }
-	  else
-	    {
-	      /* update the interaction parameters */
-	      pW->seen = seen;
-	      pW->collision = collision;
-	    }
-	}
+      store->grid[store->kind[slot]][store->cell[slot]] = next;
     }
-} /* end prvUpdateInteractionList */
+  if (next != GO_NONE)
+    {
+      store->cell_prev[next] = prev;
+    }
+  store->cell[slot] = GRID_NO_CELL;
+}
 
+/*
+ * function keeps the grid up to date after a GO has moved; the GO only
+ * changes lists when it has crossed into another cell
+ */
+void
+gridMoveGO (go_store_t *store, go_slot_t slot)
+{
+  if (gridCellOf (goPosition (store, slot)) != store->cell[slot])
+    {
+      gridRemoveGO (store, slot);
+      gridInsertGO (store, slot);
+    }
+}
@@ -0,0 +1,188 @@
+/*
+ * libgameinput.c
+ *
+ * Game Input Library
+ *
+ * Debouncing and latching of the buttons, see libgameinput.h.
+ *
+ */
+
+#include <string.h>
+#include "libgameds.h"
+#include "libgameinput.h"
+#include "libtakisbasics.h"
+
+/*****************************************************************************
+ *
+ * FUNCTIONS
+ *
+ *****************************************************************************/
+
+/*
+ * function starts a debouncer with the buttons at the given levels
+ */
+void
+inputDebounceInit (debouncer_t *deb, uint32_t window, uint8_t buttons)
+{
+  memset (deb, 0, sizeof(debouncer_t));
+  deb->window = window;
+  deb->buttons = buttons;
+}
+
+/*
+ * function takes an edge of a button, now at level; returns True, with the
+ * event in ev, when the edge is accepted
+ */
+bool_t
+inputDebounceEdge (debouncer_t *deb, uint8_t button, bool_t level,
+		   uint32_t now, ui_event_t *ev)
+{
+  uint8_t bit = 1U << button;
+
+  deb->edges++;
+  if ((deb->locked & bit) && (int32_t) (now - deb->until[button]) < 0)
+    {
+      deb->bounces++; // settled when the lock-out expires
+      return False;
+    }
+  deb->locked &= ~bit;
+  if (((deb->buttons & bit) != 0) == (level != False))
+    {
+      return False; // no change, a bounce that ended in time
+    }
+
+  deb->buttons ^= bit;
+  deb->locked |= bit;
+  deb->until[button] = now + deb->window;
+  deb->events++;
+  ev->buttons = deb->buttons;
+  ev->changed = bit;
+  ev->stamp = now;
+  return True;
+}
+
+/*
+ * function samples the buttons, at levels, whose lock-out has expired by
+ * now; returns True, with the event in ev, when they settled at a level
+ * other than the accepted one
+ */
+bool_t
+inputDebounceExpire (debouncer_t *deb, uint8_t levels, uint32_t now,
+		     ui_event_t *ev)
+{
+  uint8_t changed = 0;
+
+  for (uint8_t b = 0; b != NUMBER_OF_BUTTONS; ++b)
+    {
+      uint8_t bit = 1U << b;
+
+      if (!(deb->locked & bit) || (int32_t) (now - deb->until[b]) < 0)
+	{
+	  continue;
+	}
+      deb->locked &= ~bit;
+      if ((deb->buttons ^ levels) & bit)
+	{
+	  /* missed the last edge while locked out: a new edge, locked out
+	   * in its turn */
+	  deb->buttons ^= bit;
+	  deb->locked |= bit;
+	  deb->until[b] = now + deb->window;
+	  changed |= bit;
+	}
+    }
+  if (changed == 0)
+    {
+      return False;
+    }
+  deb->events++;
+  ev->buttons = deb->buttons;
+  ev->changed = changed;
+  ev->stamp = now;
+  return True;
+}
+
+/*
+ * function finds when the next lock-out expires; returns False when no
+ * button is locked out
+ */
+bool_t
+inputDebounceDeadline (const debouncer_t *deb, uint32_t *deadline)
+{
+  bool_t any = False;
+
+  for (uint8_t b = 0; b != NUMBER_OF_BUTTONS; ++b)
+    {
+      if ((deb->locked & (1U << b))
+	  && (!any || (int32_t) (deb->until[b] - *deadline) < 0))
+	{
+	  *deadline = deb->until[b];
+	  any = True;
+	}
+    }
+  return any;
+}
+
+/*
+ * function starts a latch with no button down
+ */
+void
+inputLatchInit (input_latch_t *latch)
+{
+  memset (latch, 0, sizeof(input_latch_t));
+  latch->pending = False;
+  latch->in_step = False;
+}
+
+/*
+ * function takes an event from the debouncer
+ */
+void
+inputLatchEvent (input_latch_t *latch, const ui_event_t *ev)
+{
+  latch->held = ev->buttons;
+  latch->latched |= ev->buttons;
+  if (!latch->pending)
+    {
+      latch->pending = True;
+      latch->pending_stamp = ev->stamp;
+    }
+}
+
+/*
+ * function gives the buttons for the next game step: those down now, and
+ * those pressed and released since the last step, so that a tap shorter
+ * than a step is not lost; returns True if there were new events
+ */
+bool_t
+inputLatchStep (input_latch_t *latch, ui_t *ui)
+{
+  uiUnpack (latch->latched, ui);
+  latch->latched = latch->held;
+
+  latch->in_step = latch->pending;
+  latch->step_stamp = latch->pending_stamp;
+  latch->pending = False;
+  return latch->in_step;
+}
+
+/*
+ * function notes that the last step has been put on the screen, now; this
+ * is when its input events have been seen by the player
+ */
+void
+inputLatchShown (input_latch_t *latch, uint32_t now)
+{
+  if (!latch->in_step)
+    {
+      return;
+    }
+  latch->in_step = False;
+  latch->last_latency = now - latch->step_stamp;
+  if (latch->last_latency > latch->max_latency)
+    {
+      latch->max_latency = latch->last_latency;
+    }
+  latch->total_latency += latch->last_latency;
+  latch->shown++;
+}
@@ -0,0 +1,352 @@
+/*
+ * libgameproto.c
+ *
+ * Game Screen Protocol Library
+ *
+ * Delta-encoded screen frames, see libgameproto.h for the frame layout.
+ *
+ */
+
+#include <string.h>
+#include "libgameds.h"
+#include "libgameproto.h"
+#include "libtakisbasics.h"
+
+/* CRC-8, polynomial x^8 + x^2 + x + 1, four bits at a time */
+static const uint8_t crc8_nibble[16] =
+  { 0x00, 0x07, 0x0E, 0x09, 0x1C, 0x1B, 0x12, 0x15, 0x38, 0x3F, 0x36, 0x31,
+      0x24, 0x23, 0x2A, 0x2D };
+
+/*****************************************************************************
+ *
+ * FUNCTIONS
+ *
+ *****************************************************************************/
+
+/*
+ * function computes the CRC-8 of len bytes
+ */
+uint8_t
+protoCRC8 (const uint8_t *data, uint16_t len)
+{
+  uint8_t crc = 0;
+
+  while (len--)
+    {
+      crc ^= *data++;
+      crc = (crc << 4) ^ crc8_nibble[crc >> 4];
+      crc = (crc << 4) ^ crc8_nibble[crc >> 4];
+    }
+  return crc;
+}
+
+/*
+ * function starts an encoder with nothing sent and nothing acknowledged
+ */
+void
+protoEncoderInit (proto_encoder_t *enc)
+{
+  memset (enc, 0, sizeof(proto_encoder_t));
+  enc->have_base = False;
+}
+
+/*
+ * function makes the next frames describe the whole screen, until one of
+ * them is acknowledged; used after the host's screen has been cleared
+ */
+void
+protoEncoderReset (proto_encoder_t *enc)
+{
+  enc->have_base = False;
+  enc->oldest = enc->seq + 1;
+}
+
+/*
+ *
+ * function encodes the GOs of the store into frame, which must have room
+ * for PROTO_MAX_FRAME bytes, and returns the frame length:
+ *	- a GO gets a record if it differs from the acknowledged base frame
+ *	- without a base (nothing acknowledged since the last reset, or the
+ *		base is too old) the frame describes the whole screen
+ *	- returns 0, and sends nothing, when the host is known to be up to
+ *		date
+ *
+ */
+uint16_t
+protoEncodeFrame (proto_encoder_t *enc, const go_store_t *store,
+		  uint8_t *frame)
+{
+  uint8_t seq = enc->seq + 1;
+  bool_t full = (!enc->have_base
+      || (uint8_t) (seq - enc->acked) >= PROTO_WINDOW) ? True : False;
+  const proto_go_t *base = full ? NULL : enc->sent[enc->acked % PROTO_WINDOW];
+  proto_go_t *now = enc->sent[seq % PROTO_WINDOW];
+  uint8_t *p = frame + PROTO_HEADER_SIZE;
+  uint8_t count = 0;
+  uint8_t rec;
+  uint16_t len;
+
+  for (go_slot_t s = 0; s != GO_POOL_SIZE; ++s)
+    {
+      proto_go_t cur =
+	{ 0, 0, 0, 0 };
+      bool_t was_alive = (base != NULL && base[s].alive) ? True : False;
+
+      if (goIsAlive (store, s))
+	{
+	  cur.alive = 1;
+	  cur.x = (uint8_t) store->x[s];
+	  cur.y = (uint8_t) store->y[s];
+	  cur.state = store->animstate[s];
+	}
+      now[s] = cur;
+
+      rec = 0;
+      if (cur.alive)
+	{
+	  if (!was_alive || base[s].x != cur.x || base[s].y != cur.y)
+	    rec |= PROTO_REC_POS;
+	  if (!was_alive || base[s].state != cur.state)
+	    rec |= PROTO_REC_STATE;
+	}
+      else if (was_alive)
+	{
+	  rec = PROTO_REC_GONE;
+	}
+      if (rec)
+	{
+	  *p++ = rec | s;
+	  if (rec & PROTO_REC_POS)
+	    {
+	      *p++ = cur.x;
+	      *p++ = cur.y;
+	    }
+	  if (rec & PROTO_REC_STATE)
+	    {
+	      *p++ = cur.state;
+	    }
+	  count++;
+	}
+    }
+
+  /* nothing changed, and the host holds the base as its latest frame */
+  if (!full && count == 0 && enc->acked == enc->seq)
+    {
+      return 0;
+    }
+
+  frame[0] = PROTO_SYNC;
+  frame[1] = seq;
+  frame[2] = full ? 0 : enc->acked;
+  frame[3] = count | (full ? PROTO_FULL : 0);
+  *p = protoCRC8 (frame + 1, p - (frame + 1));
+  p++;
+  len = p - frame;
+
+  enc->seq = seq;
+  enc->stats.frames++;
+  enc->stats.full_frames += full;
+  enc->stats.records += count;
+  enc->stats.bytes += len;
+  if (len > enc->stats.max_frame_bytes)
+    {
+      enc->stats.max_frame_bytes = len;
+    }
+  return len;
+}
+
+/*
+ * function takes note of an acknowledgement; acknowledgements of frames
+ * older than the current base, or no longer kept, are ignored
+ */
+void
+protoEncoderAck (proto_encoder_t *enc, uint8_t seq)
+{
+  uint8_t age = enc->seq - seq;
+
+  if (age >= PROTO_WINDOW
+      || (uint8_t) (seq - enc->oldest) > (uint8_t) (enc->seq - enc->oldest))
+    {
+      return;
+    }
+  enc->acked = seq;
+  enc->oldest = seq;
+  enc->have_base = True;
+}
+
+/*
+ * function starts a decoder with an empty screen
+ */
+void
+protoDecoderInit (proto_decoder_t *dec)
+{
+  memset (dec, 0, sizeof(proto_decoder_t));
+  for (size_t i = 0; i != PROTO_WINDOW; ++i)
+    {
+      dec->held_valid[i] = False;
+    }
+  dec->in_frame = False;
+}
+
+/*
+ * function applies a complete frame, checked by its CRC, to the screen
+ */
+static proto_event_t
+prvApplyFrame (proto_decoder_t *dec)
+{
+  uint8_t seq = dec->buf[0];
+  uint8_t base = dec->buf[1];
+  uint8_t count = dec->buf[2] & ~PROTO_FULL;
+  const uint8_t *p = dec->buf + 3;
+  uint8_t rec, slot;
+
+  if (protoCRC8 (dec->buf, dec->len - 1) != dec->buf[dec->len - 1])
+    {
+      dec->stats.crc_errors++;
+      return PROTO_NONE;
+    }
+
+  if (dec->buf[2] & PROTO_FULL)
+    {
+      memset (dec->screen, 0, sizeof(dec->screen));
+      dec->stats.full_frames++;
+    }
+  else if (dec->held_valid[base % PROTO_WINDOW]
+      && dec->held_seq[base % PROTO_WINDOW] == base)
+    {
+      memcpy (dec->screen, dec->held[base % PROTO_WINDOW],
+	      sizeof(dec->screen));
+    }
+  else
+    {
+      dec->stats.missing_base++;
+      return PROTO_NONE;
+    }
+
+  for (uint8_t r = 0; r != count; ++r)
+    {
+      rec = *p++;
+      slot = rec & PROTO_REC_SLOT;
+      if (rec & PROTO_REC_GONE)
+	{
+	  dec->screen[slot].alive = 0;
+	  continue;
+	}
+      dec->screen[slot].alive = 1;
+      if (rec & PROTO_REC_POS)
+	{
+	  dec->screen[slot].x = *p++;
+	  dec->screen[slot].y = *p++;
+	}
+      if (rec & PROTO_REC_STATE)
+	{
+	  dec->screen[slot].state = *p++;
+	}
+    }
+
+  memcpy (dec->held[seq % PROTO_WINDOW], dec->screen, sizeof(dec->screen));
+  dec->held_seq[seq % PROTO_WINDOW] = seq;
+  dec->held_valid[seq % PROTO_WINDOW] = True;
+  dec->seq = seq;
+
+  dec->stats.frames++;
+  dec->stats.records += count;
+  dec->stats.bytes += dec->len + 1;
+  if (dec->len + 1U > dec->stats.max_frame_bytes)
+    {
+      dec->stats.max_frame_bytes = dec->len + 1;
+    }
+  return PROTO_FRAME;
+}
+
+/*
+ *
+ * function feeds one received byte to the decoder, returns:
+ *	- PROTO_FRAME when a frame has been applied to dec->screen; the
+ *		host should then send protoMakeAck (dec->seq)
+ *	- PROTO_TEXT when a text line is complete, in dec->text
+ *	- PROTO_NONE otherwise
+ *
+ */
+proto_event_t
+protoDecodeByte (proto_decoder_t *dec, uint8_t byte)
+{
+  proto_event_t event = PROTO_NONE;
+  uint8_t rec;
+
+  if (!dec->in_frame)
+    {
+      if (byte == PROTO_SYNC || byte == '\r' || byte == '\n')
+	{
+	  if (dec->text_len != 0)
+	    {
+	      dec->text[dec->text_len] = '\0';
+	      dec->text_len = 0;
+	      event = PROTO_TEXT;
+	    }
+	  if (byte == PROTO_SYNC)
+	    {
+	      dec->in_frame = True;
+	      dec->len = 0;
+	      dec->need = 0;
+	    }
+	}
+      else if (byte >= ' ' && byte < 0x7F
+	  && dec->text_len < sizeof(dec->text) - 1)
+	{
+	  dec->text[dec->text_len++] = byte;
+	}
+      return event;
+    }
+
+  dec->buf[dec->len++] = byte;
+  if (dec->len < 3)
+    {
+      return PROTO_NONE; // seq, base
+    }
+  if (dec->len == 3)
+    {
+      dec->records = byte & ~PROTO_FULL;
+      if (dec->records > GO_POOL_SIZE)
+	{
+	  dec->in_frame = False; // not a frame after all
+	}
+      return PROTO_NONE;
+    }
+  if (dec->need != 0)
+    {
+      dec->need--;
+      return PROTO_NONE;
+    }
+  if (dec->records != 0)
+    {
+      rec = byte;
+      if ((rec & PROTO_REC_SLOT) >= GO_POOL_SIZE
+	  || ((rec & PROTO_REC_GONE) && (rec & ~PROTO_REC_SLOT) != PROTO_REC_GONE))
+	{
+	  dec->stats.crc_errors++;
+	  dec->in_frame = False;
+	  return PROTO_NONE;
+	}
+      dec->need = ((rec & PROTO_REC_POS) ? 2 : 0)
+	  + ((rec & PROTO_REC_STATE) ? 1 : 0);
+      dec->records--;
+      return PROTO_NONE;
+    }
+
+  /* that was the CRC */
+  dec->in_frame = False;
+  return prvApplyFrame (dec);
+}
+
+/*
+ * function builds the acknowledgement of frame seq, returns its length
+ */
+uint16_t
+protoMakeAck (uint8_t seq, uint8_t *ack)
+{
+  ack[0] = PROTO_ACK;
+  ack[1] = seq;
+  ack[2] = ~seq;
+  return PROTO_ACK_SIZE;
+}
@@ -0,0 +1,469 @@
+/*
+ * libgamesounds.c
+ *
+ * Game Sounds Library
+ *
+ * The sound effects, 8000 samples a second, see libgamesounds.h.
+ * Made by host/sfx_gen, do not edit.
+ *
+ */
+
+#include "libgameaudio.h"
+#include "libgamesounds.h"
+
+static const uint8_t sfxFire_data[800] =
+  { 0x59, 0x59, 0x59, 0xA7, 0xA8, 0xA8, 0x58, 0x58, 0x58, 0x58, 0xA8, 0xA8,
+      0xA8, 0x57, 0x57, 0x57, 0xA9, 0xA9, 0xA9, 0xA9, 0x57, 0x57, 0x56, 0xAA,
+      0xAA, 0xAA, 0x56, 0x56, 0x56, 0x56, 0xAA, 0xAB, 0xAB, 0x55, 0x55, 0x55,
+      0x55, 0xAB, 0xAB, 0xAB, 0x54, 0x54, 0x54, 0x54, 0xAC, 0xAC, 0xAC, 0x54,
+      0x54, 0x53, 0x53, 0xAD, 0xAD, 0xAD, 0x53, 0x53, 0x53, 0x53, 0xAE, 0xAE,
+      0xAE, 0x52, 0x52, 0x52, 0x52, 0xAE, 0xAE, 0xAF, 0x51, 0x51, 0x51, 0x51,
+      0xAF, 0xAF, 0xAF, 0x51, 0x50, 0x50, 0x50, 0xB0, 0xB0, 0xB0, 0x50, 0x50,
+      0x50, 0x4F, 0xB1, 0xB1, 0xB1, 0xB1, 0x4F, 0x4F, 0x4F, 0xB1, 0xB2, 0xB2,
+      0xB2, 0x4E, 0x4E, 0x4E, 0xB2, 0xB2, 0xB2, 0xB3, 0x4D, 0x4D, 0x4D, 0x4D,
+      0xB3, 0xB3, 0xB3, 0x4D, 0x4C, 0x4C, 0x4C, 0xB4, 0xB4, 0xB4, 0xB4, 0x4C,
+      0x4C, 0x4B, 0xB5, 0xB5, 0xB5, 0xB5, 0x4B, 0x4B, 0x4B, 0x4B, 0xB6, 0xB6,
+      0xB6, 0xB6, 0x4A, 0x4A, 0x4A, 0xB6, 0xB6, 0xB7, 0xB7, 0x49, 0x49, 0x49,
+      0x49, 0xB7, 0xB7, 0xB7, 0xB8, 0x48, 0x48, 0x48, 0x48, 0xB8, 0xB8, 0xB8,
+      0x48, 0x47, 0x47, 0x47, 0xB9, 0xB9, 0xB9, 0xB9, 0x47, 0x47, 0x46, 0x46,
+      0xBA, 0xBA, 0xBA, 0xBA, 0x46, 0x46, 0x46, 0x45, 0xBB, 0xBB, 0xBB, 0xBB,
+      0x45, 0x45, 0x45, 0x45, 0xBC, 0xBC, 0xBC, 0x44, 0x44, 0x44, 0x44, 0xBC,
+      0xBC, 0xBD, 0xBD, 0x43, 0x43, 0x43, 0x43, 0xBD, 0xBD, 0xBD, 0xBE, 0x42,
+      0x42, 0x42, 0x42, 0xBE, 0xBE, 0xBE, 0xBE, 0x41, 0x41, 0x41, 0x41, 0x41,
+      0xBF, 0xBF, 0xBF, 0xBF, 0x40, 0x40, 0x40, 0x40, 0xC0, 0xC0, 0xC0, 0xC0,
+      0x40, 0x3F, 0x3F, 0x3F, 0xC1, 0xC1, 0xC1, 0xC1, 0x3F, 0x3F, 0x3E, 0x3E,
+      0xC2, 0xC2, 0xC2, 0xC2, 0x3E, 0x3E, 0x3E, 0x3D, 0x3D, 0xC3, 0xC3, 0xC3,
+      0xC3, 0x3D, 0x3D, 0x3D, 0x3C, 0xC4, 0xC4, 0xC4, 0xC4, 0x3C, 0x3C, 0x3C,
+      0x3C, 0x3B, 0xC5, 0xC5, 0xC5, 0xC5, 0x3B, 0x3B, 0x3B, 0x3B, 0xC6, 0xC6,
+      0xC6, 0xC6, 0x3A, 0x3A, 0x3A, 0x3A, 0x3A, 0xC7, 0xC7, 0xC7, 0xC7, 0x39,
+      0x39, 0x39, 0x39, 0x39, 0xC8, 0xC8, 0xC8, 0xC8, 0x38, 0x38, 0x38, 0x38,
+      0xC8, 0xC9, 0xC9, 0xC9, 0xC9, 0x37, 0x37, 0x37, 0x37, 0xC9, 0xCA, 0xCA,
+      0xCA, 0xCA, 0x36, 0x36, 0x36, 0x36, 0xCA, 0xCB, 0xCB, 0xCB, 0xCB, 0x35,
+      0x35, 0x35, 0x35, 0x35, 0xCC, 0xCC, 0xCC, 0xCC, 0x34, 0x34, 0x34, 0x34,
+      0x34, 0xCD, 0xCD, 0xCD, 0xCD, 0x33, 0x33, 0x33, 0x33, 0x33, 0xCE, 0xCE,
+      0xCE, 0xCE, 0xCE, 0x32, 0x32, 0x32, 0x32, 0xCF, 0xCF, 0xCF, 0xCF, 0xCF,
+      0x31, 0x31, 0x31, 0x31, 0x30, 0xD0, 0xD0, 0xD0, 0xD0, 0xD0, 0x30, 0x30,
+      0x30, 0x2F, 0x2F, 0xD1, 0xD1, 0xD1, 0xD1, 0xD1, 0x2F, 0x2F, 0x2E, 0x2E,
+      0xD2, 0xD2, 0xD2, 0xD2, 0xD2, 0x2E, 0x2E, 0x2D, 0x2D, 0x2D, 0xD3, 0xD3,
+      0xD3, 0xD3, 0xD3, 0x2D, 0x2C, 0x2C, 0x2C, 0x2C, 0xD4, 0xD4, 0xD4, 0xD4,
+      0xD4, 0x2B, 0x2B, 0x2B, 0x2B, 0x2B, 0xD5, 0xD5, 0xD5, 0xD5, 0xD6, 0x2A,
+      0x2A, 0x2A, 0x2A, 0x2A, 0x2A, 0xD6, 0xD6, 0xD7, 0xD7, 0xD7, 0x29, 0x29,
+      0x29, 0x29, 0x29, 0xD7, 0xD8, 0xD8, 0xD8, 0xD8, 0x28, 0x28, 0x28, 0x28,
+      0x28, 0x27, 0xD9, 0xD9, 0xD9, 0xD9, 0xD9, 0x27, 0x27, 0x27, 0x26, 0x26,
+      0xDA, 0xDA, 0xDA, 0xDA, 0xDA, 0xDA, 0x26, 0x25, 0x25, 0x25, 0x25, 0xDB,
+      0xDB, 0xDB, 0xDB, 0xDB, 0xDC, 0x24, 0x24, 0x24, 0x24, 0x24, 0xDC, 0xDC,
+      0xDC, 0xDD, 0xDD, 0xDD, 0x23, 0x23, 0x23, 0x23, 0x23, 0xDD, 0xDE, 0xDE,
+      0xDE, 0xDE, 0xDE, 0x22, 0x22, 0x22, 0x22, 0x21, 0x21, 0xDF, 0xDF, 0xDF,
+      0xDF, 0xDF, 0x21, 0x21, 0x20, 0x20, 0x20, 0x20, 0xE0, 0xE0, 0xE0, 0xE0,
+      0xE0, 0xE1, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0xE1, 0xE1, 0xE2, 0xE2,
+      0xE2, 0xE2, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1D, 0xE3, 0xE3, 0xE3, 0xE3,
+      0xE3, 0xE3, 0x1D, 0x1D, 0x1C, 0x1C, 0x1C, 0x1C, 0xE4, 0xE4, 0xE4, 0xE4,
+      0xE4, 0xE5, 0x1B, 0x1B, 0x1B, 0x1B, 0x1B, 0x1B, 0xE5, 0xE5, 0xE6, 0xE6,
+      0xE6, 0xE6, 0xE6, 0x1A, 0x1A, 0x1A, 0x1A, 0x19, 0x19, 0xE7, 0xE7, 0xE7,
+      0xE7, 0xE7, 0xE7, 0x19, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0xE8, 0xE8,
+      0xE8, 0xE9, 0xE9, 0xE9, 0x17, 0x17, 0x17, 0x17, 0x17, 0x17, 0x16, 0xEA,
+      0xEA, 0xEA, 0xEA, 0xEA, 0xEA, 0xEA, 0x16, 0x15, 0x15, 0x15, 0x15, 0x15,
+      0xEB, 0xEB, 0xEB, 0xEB, 0xEC, 0xEC, 0xEC, 0x14, 0x14, 0x14, 0x14, 0x14,
+      0x14, 0x13, 0xED, 0xED, 0xED, 0xED, 0xED, 0xED, 0xED, 0x13, 0x12, 0x12,
+      0x12, 0x12, 0x12, 0x12, 0xEE, 0xEE, 0xEE, 0xEF, 0xEF, 0xEF, 0xEF, 0xEF,
+      0x11, 0x11, 0x11, 0x11, 0x10, 0x10, 0x10, 0xF0, 0xF0, 0xF0, 0xF0, 0xF0,
+      0xF0, 0xF1, 0x0F, 0x0F, 0x0F, 0x0F, 0x0F, 0x0F, 0x0F, 0x0F, 0xF2, 0xF2,
+      0xF2, 0xF2, 0xF2, 0xF2, 0xF2, 0x0E, 0x0E, 0x0D, 0x0D, 0x0D, 0x0D, 0x0D,
+      0x0D, 0xF3, 0xF3, 0xF3, 0xF4, 0xF4, 0xF4, 0xF4, 0xF4, 0x0C, 0x0C, 0x0C,
+      0x0C, 0x0B, 0x0B, 0x0B, 0x0B, 0xF5, 0xF5, 0xF5, 0xF5, 0xF5, 0xF6, 0xF6,
+      0xF6, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x09, 0x09, 0xF7, 0xF7, 0xF7,
+      0xF7, 0xF7, 0xF7, 0xF7, 0xF8, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08,
+      0x08, 0x07, 0xF9, 0xF9, 0xF9, 0xF9, 0xF9, 0xF9, 0xF9, 0xF9, 0xFA, 0x06,
+      0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0xFB, 0xFB, 0xFB, 0xFB, 0xFB,
+      0xFB, 0xFB, 0xFB, 0xFB, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04,
+      0x04, 0x03, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFE, 0x02,
+      0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x01, 0x01, 0xFF, 0xFF, 0xFF,
+      0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00 };
+const sound_t sfxFire =
+  { SOUND_PCM8, 800, sfxFire_data };
+
+static const uint8_t sfxHit_data[480] =
+  { 0x77, 0xF7, 0x77, 0xF7, 0xF1, 0x2F, 0x11, 0x5B, 0xB3, 0x1C, 0xA4, 0x88,
+      0x80, 0x4D, 0x0B, 0xA8, 0x05, 0x99, 0xB4, 0x30, 0x03, 0x0C, 0x14, 0x9B,
+      0xB0, 0x90, 0x7C, 0x3A, 0x2A, 0x8A, 0xD2, 0x88, 0x90, 0x15, 0x4B, 0x99,
+      0xB0, 0x34, 0x12, 0x0F, 0xA1, 0x90, 0x21, 0x1D, 0x8A, 0x42, 0x9A, 0x32,
+      0x9B, 0x9A, 0x07, 0x02, 0xE8, 0x82, 0x98, 0xB2, 0xA1, 0x1A, 0xB8, 0x27,
+      0x3C, 0xB8, 0x21, 0xAD, 0x22, 0x4C, 0x9A, 0xA4, 0x09, 0x0A, 0x15, 0x93,
+      0x11, 0x8B, 0x8D, 0x18, 0xAB, 0x79, 0x14, 0x80, 0x01, 0x9D, 0x21, 0x8B,
+      0x2C, 0xB4, 0x88, 0x13, 0x8D, 0x33, 0x81, 0x0D, 0xC2, 0xC0, 0x31, 0x9C,
+      0x5A, 0x2A, 0x22, 0xE9, 0x92, 0x90, 0x38, 0x02, 0xAF, 0x83, 0xA1, 0xB3,
+      0x91, 0xAB, 0x09, 0x55, 0x0A, 0x49, 0xD2, 0x28, 0x92, 0x22, 0x8F, 0x81,
+      0x0A, 0x38, 0x8A, 0x20, 0x9E, 0x08, 0x9A, 0x17, 0x10, 0x9B, 0x32, 0xD8,
+      0xA1, 0x18, 0xA9, 0xB5, 0x7A, 0x90, 0x00, 0x0A, 0x08, 0x3A, 0x4A, 0x68,
+      0x19, 0x19, 0xAA, 0x16, 0x29, 0x20, 0xA1, 0x0D, 0xD8, 0x99, 0x33, 0x1A,
+      0x2B, 0x93, 0xA4, 0x81, 0x38, 0x9F, 0x00, 0x1E, 0x28, 0x02, 0x9A, 0x01,
+      0xD1, 0xC4, 0x99, 0x6A, 0x0A, 0x38, 0xB2, 0x5B, 0x90, 0x31, 0xAE, 0xA4,
+      0x80, 0xA2, 0x58, 0x80, 0xAB, 0x24, 0xB1, 0xB1, 0x83, 0xB9, 0xA1, 0x97,
+      0x3D, 0x2A, 0x91, 0x4D, 0x89, 0xA9, 0x85, 0x22, 0x9A, 0x89, 0xC2, 0x6A,
+      0xB1, 0x08, 0x91, 0x84, 0xC1, 0x48, 0x90, 0xAC, 0x08, 0x11, 0x0A, 0x1A,
+      0x07, 0xA3, 0x8C, 0xA0, 0x02, 0x5A, 0x39, 0xBB, 0x81, 0xA7, 0xA1, 0x85,
+      0x4A, 0x21, 0xB0, 0xAC, 0x88, 0xA6, 0x09, 0xA4, 0xA3, 0x94, 0x02, 0x8A,
+      0x31, 0x38, 0xBF, 0x98, 0x1B, 0x96, 0xB2, 0x94, 0x33, 0x28, 0xAC, 0xA9,
+      0x18, 0x30, 0x2B, 0xD4, 0x33, 0xDC, 0x09, 0x88, 0x79, 0xA1, 0x18, 0x9B,
+      0x4A, 0x5B, 0xB3, 0xA8, 0x13, 0x5C, 0xB8, 0x08, 0x94, 0xA2, 0xD0, 0x49,
+      0x88, 0x00, 0x90, 0x8A, 0x92, 0x97, 0x04, 0x9B, 0x82, 0x1C, 0x10, 0x29,
+      0x6B, 0xC1, 0x10, 0x28, 0xC9, 0x00, 0x0C, 0x15, 0x00, 0xC9, 0xB4, 0x48,
+      0x09, 0x98, 0x04, 0xCA, 0x88, 0x31, 0x01, 0xAC, 0x1A, 0x17, 0xA1, 0x11,
+      0x9C, 0x13, 0x08, 0xF3, 0xC1, 0x11, 0x08, 0x81, 0x1C, 0x2C, 0xB1, 0xB4,
+      0xA9, 0x40, 0x84, 0xB1, 0x18, 0x40, 0xF2, 0x91, 0x21, 0xAB, 0xB2, 0x95,
+      0x09, 0x10, 0x20, 0x04, 0xFA, 0x29, 0xB0, 0x92, 0x42, 0xAD, 0x81, 0x4A,
+      0xA0, 0x24, 0x19, 0x1C, 0x8E, 0x92, 0x81, 0xC4, 0x98, 0x29, 0xA0, 0x93,
+      0xD2, 0x32, 0x2B, 0xD3, 0x58, 0x2A, 0x0B, 0xB2, 0x13, 0x9E, 0xAA, 0x25,
+      0xC0, 0x38, 0x09, 0x4C, 0x91, 0x98, 0x1B, 0x70, 0x91, 0x9A, 0x15, 0xBA,
+      0xB3, 0x8B, 0x22, 0x8A, 0x52, 0x9A, 0x02, 0x0D, 0x4A, 0xD3, 0x14, 0x00,
+      0xAC, 0x48, 0x10, 0x9A, 0x98, 0x05, 0xAA, 0x2B, 0x9C, 0xA5, 0xA2, 0x91,
+      0x07, 0x92, 0x99, 0x31, 0xA4, 0x03, 0xAD, 0xA9, 0x04, 0x08, 0xA6, 0x2A,
+      0x19, 0xBB, 0x5B, 0xA4, 0x5A, 0xB3, 0x2B, 0x3A, 0x09, 0x2C, 0xA4, 0xB1,
+      0x49, 0x93, 0x2A, 0xE9, 0xB0, 0x12, 0xC5, 0x94, 0x92, 0x39, 0x49, 0x3A,
+      0xC0, 0x29, 0x20, 0x9F, 0xA0, 0x92, 0x3B, 0x12, 0x85, 0x4A, 0x08, 0x0C,
+      0x12, 0x3C, 0xC1, 0x3A, 0xB0, 0xA1, 0x3D, 0x22, 0x14, 0xEB, 0x08, 0x14,
+      0x00, 0xAE, 0x81, 0xB8, 0x23, 0x9C, 0x6B, 0xB2, 0xA3, 0xB4, 0x33, 0x08 };
+const sound_t sfxHit =
+  { SOUND_ADPCM, 960, sfxHit_data };
+
+static const uint8_t sfxAlienDown_data[1600] =
+  { 0x77, 0xF7, 0xFF, 0x4F, 0x75, 0x34, 0x8F, 0xAB, 0x19, 0x21, 0x17, 0x90,
+      0x99, 0x8E, 0x39, 0x40, 0x11, 0xB8, 0xC8, 0xB9, 0x01, 0x26, 0x11, 0xD1,
+      0xA8, 0x9B, 0x69, 0x21, 0x30, 0xD8, 0xB8, 0x0B, 0x21, 0x31, 0x45, 0xAB,
+      0x9B, 0x9C, 0x03, 0x73, 0x10, 0x09, 0x9D, 0xB8, 0x01, 0x16, 0x58, 0x99,
+      0x99, 0xB9, 0x20, 0x14, 0x14, 0x8A, 0x0D, 0x0D, 0x1A, 0x22, 0x34, 0x89,
+      0x9D, 0xA9, 0x3A, 0x04, 0x05, 0x10, 0x9B, 0x9D, 0x0A, 0x11, 0x06, 0x41,
+      0xC9, 0x98, 0xAB, 0x60, 0x01, 0x03, 0xA8, 0xC9, 0xF0, 0x18, 0x21, 0x21,
+      0x81, 0x99, 0x9F, 0x99, 0x04, 0x21, 0x22, 0x9A, 0xBB, 0xDA, 0x3A, 0x13,
+      0x37, 0xA2, 0xCB, 0x9B, 0x8B, 0x54, 0x38, 0x11, 0xC0, 0x0B, 0x8E, 0x4B,
+      0x20, 0x13, 0xA4, 0xE0, 0x88, 0xB9, 0x12, 0x84, 0x85, 0xA2, 0xA9, 0x9B,
+      0x9A, 0x63, 0x21, 0x14, 0xD9, 0x0A, 0x9C, 0x18, 0x60, 0x20, 0x92, 0xB9,
+      0xC8, 0xB0, 0x18, 0x25, 0x41, 0x88, 0xB8, 0xAC, 0xE9, 0x11, 0x52, 0x30,
+      0xB1, 0x98, 0xAC, 0xDB, 0x02, 0x84, 0x34, 0x92, 0xBC, 0xA0, 0x9F, 0x31,
+      0x20, 0x11, 0x84, 0x9B, 0x9D, 0xC9, 0x68, 0x28, 0x20, 0x00, 0xE1, 0xA8,
+      0xB8, 0x59, 0x11, 0x48, 0x82, 0x9A, 0xE0, 0x09, 0x1A, 0x12, 0x68, 0x11,
+      0x09, 0xD9, 0xA9, 0xB9, 0x24, 0x33, 0x02, 0x01, 0xF8, 0x9C, 0xA0, 0x19,
+      0x14, 0x03, 0x62, 0x9B, 0xB0, 0xBA, 0xAA, 0x54, 0x81, 0x17, 0xC1, 0xA0,
+      0x98, 0xCA, 0x82, 0x04, 0x32, 0x00, 0xC2, 0x1D, 0xAA, 0xBA, 0x06, 0x10,
+      0x13, 0x22, 0xEB, 0x89, 0x0D, 0x89, 0x24, 0x49, 0x11, 0xD2, 0xA8, 0x98,
+      0x8C, 0x39, 0x78, 0x18, 0x11, 0x88, 0x9A, 0xBB, 0xEB, 0x32, 0x68, 0x81,
+      0x12, 0x99, 0x0A, 0xDC, 0x0A, 0x38, 0x43, 0x69, 0x21, 0x9A, 0x9C, 0xAB,
+      0x19, 0x39, 0x42, 0x22, 0x37, 0x9A, 0xDA, 0xC0, 0x0A, 0x10, 0x43, 0x69,
+      0x08, 0x90, 0xAA, 0xB1, 0x9C, 0x6A, 0x08, 0x33, 0x10, 0x96, 0x0C, 0x9B,
+      0xC8, 0x18, 0x04, 0x48, 0x40, 0x00, 0xC8, 0x99, 0x0C, 0x9B, 0x24, 0x69,
+      0x00, 0x30, 0x99, 0xE0, 0x0A, 0xA8, 0x2A, 0x51, 0x81, 0x06, 0x91, 0x89,
+      0x0C, 0xAB, 0x8A, 0x83, 0x16, 0x21, 0x52, 0x98, 0xBB, 0x0D, 0xC8, 0x08,
+      0x82, 0x85, 0x23, 0x14, 0xBA, 0x0C, 0xF9, 0x80, 0x2B, 0x40, 0x11, 0x32,
+      0x3A, 0xF9, 0x88, 0xAB, 0xD0, 0x82, 0x51, 0x00, 0x02, 0x83, 0xF1, 0x98,
+      0x89, 0xAB, 0x29, 0x42, 0x62, 0x91, 0x11, 0xC1, 0x0B, 0xAB, 0x9D, 0x10,
+      0x11, 0x64, 0x29, 0x23, 0xEA, 0xA1, 0xB9, 0xE0, 0x91, 0x12, 0x03, 0x38,
+      0x42, 0x0A, 0x8B, 0xFA, 0xD8, 0x91, 0x11, 0x81, 0x23, 0x54, 0xB0, 0x0A,
+      0xBB, 0xC8, 0x1C, 0x5C, 0x80, 0x33, 0x30, 0x82, 0xF1, 0xA9, 0x09, 0x9B,
+      0xB8, 0x48, 0x40, 0x22, 0x32, 0x06, 0xC9, 0xD0, 0xA8, 0xA9, 0x29, 0x30,
+      0x31, 0x07, 0x95, 0xA3, 0xD0, 0x80, 0x9B, 0xAA, 0x6B, 0x82, 0x51, 0x00,
+      0x10, 0x93, 0xEA, 0xA1, 0x8C, 0x8B, 0x38, 0x82, 0x32, 0x07, 0x03, 0x18,
+      0xD9, 0xE8, 0xA0, 0x09, 0x3C, 0x00, 0x03, 0x87, 0x03, 0x08, 0x8A, 0xAA,
+      0x9D, 0x0C, 0x2A, 0x91, 0x06, 0x10, 0x96, 0x31, 0x9C, 0x89, 0x99, 0xB0,
+      0xAA, 0x12, 0x86, 0x24, 0x38, 0x83, 0xB4, 0xCC, 0xE2, 0x98, 0xA0, 0x80,
+      0x93, 0x03, 0x44, 0x00, 0x42, 0x9A, 0xB8, 0x0F, 0x1C, 0x0C, 0x10, 0x48,
+      0x38, 0x80, 0x14, 0xB3, 0x2B, 0xDC, 0x08, 0x0D, 0xB8, 0x40, 0x39, 0x40,
+      0x82, 0x13, 0xD3, 0xA8, 0x0A, 0x0C, 0xDC, 0xA1, 0x01, 0x84, 0x51, 0x91,
+      0x03, 0x92, 0x8C, 0xC0, 0xBA, 0xE2, 0xA9, 0x10, 0x14, 0x21, 0x70, 0x38,
+      0x39, 0x9B, 0x0C, 0x2C, 0xAC, 0x91, 0x1E, 0x13, 0x28, 0x01, 0x51, 0x00,
+      0xA8, 0x18, 0xEC, 0xB0, 0xC1, 0x80, 0x18, 0x94, 0x14, 0x12, 0x91, 0x97,
+      0x91, 0xBA, 0xF1, 0x08, 0x9A, 0xB0, 0x14, 0x11, 0x83, 0x15, 0x10, 0x94,
+      0x8D, 0x09, 0xC9, 0xB1, 0x8A, 0xB9, 0x17, 0x81, 0x03, 0x93, 0x95, 0x85,
+      0xBA, 0x98, 0x8B, 0x09, 0x8F, 0x98, 0x82, 0x04, 0x71, 0x00, 0x81, 0x13,
+      0xAC, 0xA1, 0xE8, 0x08, 0x8C, 0x08, 0x10, 0x30, 0x59, 0x00, 0x07, 0x29,
+      0xB1, 0x99, 0x89, 0x1E, 0x0C, 0x0A, 0x28, 0x09, 0x15, 0x20, 0x43, 0x28,
+      0xB2, 0xE8, 0x08, 0x8A, 0x0D, 0xDA, 0x98, 0x40, 0x81, 0xA4, 0x41, 0xA3,
+      0x31, 0xA0, 0xF1, 0xA1, 0x2A, 0xCB, 0xE0, 0xA8, 0x14, 0x19, 0x03, 0x51,
+      0x20, 0x4A, 0x89, 0x90, 0x1C, 0xCA, 0x98, 0xF8, 0x08, 0x80, 0x21, 0x84,
+      0x48, 0x19, 0x05, 0x82, 0x1A, 0x0C, 0x8A, 0x9F, 0x18, 0x1D, 0x98, 0x01,
+      0x82, 0x85, 0x23, 0x7B, 0x00, 0x80, 0xA9, 0x0C, 0xB0, 0xE0, 0x98, 0x09,
+      0x81, 0x06, 0x90, 0x04, 0x80, 0x13, 0x03, 0x1B, 0x1F, 0x89, 0x1E, 0x2B,
+      0x1C, 0x98, 0x88, 0x85, 0x02, 0x92, 0x30, 0x30, 0x51, 0x3B, 0xFA, 0xA8,
+      0xC2, 0x0A, 0xF0, 0x18, 0x18, 0x01, 0x48, 0x08, 0x30, 0x51, 0x6A, 0x98,
+      0xB0, 0x19, 0x8C, 0x19, 0x1D, 0x8D, 0x39, 0x18, 0x20, 0x92, 0x32, 0x05,
+      0x48, 0x40, 0x9A, 0x8B, 0xA0, 0x9E, 0x88, 0xF9, 0x98, 0x10, 0x79, 0x00,
+      0x10, 0x18, 0x48, 0x11, 0x91, 0xD9, 0xE3, 0x90, 0x98, 0x89, 0xC1, 0xD0,
+      0x11, 0x92, 0x48, 0x21, 0x08, 0x96, 0x84, 0x10, 0xA8, 0x1B, 0x9C, 0xB9,
+      0x93, 0xAF, 0xA2, 0x8B, 0x87, 0x48, 0x18, 0x80, 0x20, 0x33, 0x98, 0xA1,
+      0xF4, 0x98, 0x98, 0x80, 0xDA, 0xB8, 0xF3, 0x81, 0x40, 0x29, 0x20, 0x08,
+      0x84, 0x03, 0xA3, 0x81, 0xF1, 0x90, 0x8C, 0xC0, 0x99, 0xB8, 0xD8, 0x82,
+      0x13, 0x96, 0x28, 0x83, 0x95, 0x32, 0x90, 0x00, 0xF2, 0x2A, 0xC9, 0xA0,
+      0xE0, 0xA1, 0x99, 0x0A, 0x68, 0x30, 0x28, 0xB3, 0x70, 0x81, 0x31, 0x48,
+      0xA9, 0x1E, 0x1B, 0x89, 0x2E, 0x9B, 0xA0, 0xA0, 0x10, 0x48, 0x83, 0x63,
+      0x88, 0x94, 0x11, 0x20, 0x44, 0xAA, 0x09, 0xDA, 0xC8, 0x1A, 0x2C, 0x8C,
+      0xD0, 0x01, 0x5A, 0x39, 0x6A, 0x29, 0x08, 0xA4, 0x84, 0x00, 0x91, 0x9B,
+      0x29, 0xF9, 0x18, 0x1C, 0x99, 0x0C, 0xB1, 0x58, 0x80, 0x20, 0x12, 0x58,
+      0x03, 0x81, 0xA4, 0x02, 0x9D, 0xC1, 0xC1, 0xD2, 0x29, 0xC8, 0x99, 0x01,
+      0x1D, 0x01, 0x58, 0xA8, 0x23, 0x7A, 0x20, 0x8A, 0x31, 0x78, 0x8B, 0x81,
+      0xAA, 0xA9, 0xA0, 0x0A, 0xB2, 0xFB, 0xA8, 0x30, 0x79, 0x88, 0x95, 0x30,
+      0x1A, 0x24, 0x20, 0x2C, 0x94, 0x1A, 0x0E, 0x1A, 0x90, 0xBB, 0x88, 0x98,
+      0xF9, 0x3A, 0x4D, 0x90, 0x03, 0xA1, 0x34, 0x3A, 0x38, 0x52, 0x38, 0xB8,
+      0xE5, 0xA1, 0xC0, 0xA1, 0x80, 0x1D, 0x99, 0x29, 0x9C, 0x19, 0x38, 0x84,
+      0x15, 0x5C, 0x19, 0x48, 0x2A, 0x58, 0x1A, 0xA1, 0x99, 0x81, 0x88, 0x0F,
+      0x8A, 0x80, 0xF0, 0xA1, 0x29, 0xA9, 0x06, 0x18, 0x39, 0x59, 0x88, 0x02,
+      0x01, 0x18, 0x07, 0x99, 0x81, 0xBB, 0xE3, 0x98, 0x09, 0x00, 0x0F, 0xA8,
+      0xC2, 0x1A, 0x18, 0x06, 0x39, 0x11, 0x98, 0x21, 0x10, 0x15, 0x02, 0x48,
+      0xF4, 0x90, 0x29, 0x0A, 0x1E, 0x9A, 0x90, 0x81, 0x0B, 0xBA, 0x88, 0x22,
+      0x54, 0x5C, 0x3A, 0x39, 0x20, 0x04, 0x1C, 0x53, 0x89, 0x11, 0x9B, 0xAA,
+      0xB5, 0xCA, 0x93, 0x8A, 0x9D, 0xD1, 0x99, 0x4A, 0x8B, 0x97, 0x38, 0x38,
+      0x3B, 0x18, 0x32, 0x70, 0x2A, 0x80, 0x95, 0x91, 0x11, 0xDA, 0x1A, 0xF0,
+      0x18, 0x8B, 0x10, 0x8B, 0x1B, 0x1F, 0x2B, 0xA2, 0xA5, 0x22, 0x19, 0x18,
+      0x51, 0x19, 0x17, 0x89, 0x83, 0x52, 0xB9, 0xE2, 0x18, 0x2C, 0x99, 0x09,
+      0x91, 0xEB, 0xA0, 0x00, 0x90, 0x8B, 0x70, 0x88, 0x04, 0x49, 0x1B, 0x11,
+      0x43, 0xB8, 0x84, 0x14, 0x80, 0xD2, 0xA2, 0x4A, 0xA9, 0xDB, 0xC1, 0x90,
+      0xA8, 0xC2, 0xD2, 0xA8, 0x00, 0x6B, 0x38, 0x0B, 0x11, 0x07, 0x10, 0x0A,
+      0x84, 0xC3, 0x94, 0x81, 0x11, 0xC5, 0x00, 0x1A, 0x0B, 0xF1, 0x80, 0x80,
+      0x1C, 0x19, 0x0B, 0x2E, 0x2A, 0x8C, 0xA2, 0x05, 0x2A, 0x40, 0xB1, 0x00,
+      0x96, 0x91, 0x02, 0x60, 0x08, 0x38, 0x19, 0x9D, 0x91, 0x90, 0xAB, 0x0A,
+      0xA4, 0x0C, 0xB8, 0xE8, 0xB1, 0xA1, 0xF0, 0x30, 0x4A, 0x28, 0x4A, 0x30,
+      0x4D, 0xB1, 0x95, 0x91, 0x92, 0x84, 0x01, 0x11, 0xD1, 0xB0, 0x39, 0x8A,
+      0x1F, 0x2B, 0xF0, 0x80, 0x19, 0x9A, 0x00, 0xA2, 0x9A, 0xA2, 0x33, 0x4F,
+      0x38, 0xA0, 0x41, 0x01, 0x7B, 0x39, 0x3B, 0x88, 0x41, 0x40, 0xE1, 0xA2,
+      0x09, 0x91, 0xCA, 0x83, 0xA9, 0x9C, 0x94, 0xAB, 0x4B, 0x2C, 0x8E, 0x91,
+      0x01, 0x4A, 0x20, 0x18, 0xC2, 0xA2, 0x44, 0x11, 0x8A, 0x52, 0x4A, 0x5A,
+      0x1A, 0x41, 0xD0, 0x00, 0x99, 0x28, 0x0E, 0x00, 0xBA, 0xA1, 0xA3, 0x0B,
+      0x0E, 0x19, 0x1D, 0x08, 0x98, 0x9A, 0x16, 0x03, 0x98, 0xD3, 0x04, 0x23,
+      0x0A, 0x19, 0x11, 0x27, 0x21, 0x5C, 0x01, 0x99, 0x9C, 0x11, 0x0E, 0x09,
+      0x1A, 0x88, 0x1C, 0x1B, 0x2E, 0x2A, 0x8F, 0x92, 0xB8, 0x02, 0x3B, 0x1B,
+      0x70, 0xB2, 0x82, 0xA5, 0x21, 0x90, 0x48, 0x40, 0x18, 0xA8, 0xA7, 0x84,
+      0xB2, 0xC2, 0x93, 0xA0, 0xB8, 0x89, 0x89, 0x2D, 0x8E, 0xA2, 0x80, 0x2C,
+      0xCA, 0x20, 0x2A, 0x9F, 0x49, 0x10, 0x2B, 0xB3, 0x06, 0x39, 0x19, 0x10,
+      0xB2, 0x78, 0x90, 0x40, 0xB0, 0x83, 0xB4, 0x96, 0x28, 0xD0, 0x08, 0xA8,
+      0x88, 0xC4, 0xA0, 0x49, 0x8C, 0x90, 0x1A, 0x28, 0xB9, 0x8D, 0xA0, 0xC3,
+      0x02, 0x5C, 0x3A, 0xC2, 0x38, 0x79, 0x39, 0x1B, 0x84, 0x1A, 0x04, 0x4B,
+      0x28, 0x4A, 0x92, 0x6B, 0xB1, 0x81, 0x4C, 0x0C, 0x98, 0xA1, 0x01, 0xB8,
+      0xE0, 0x00, 0x08, 0x98, 0x0B, 0x28, 0xAD, 0x0C, 0x8A, 0xA6, 0x29, 0x4B,
+      0x41, 0x0C, 0x84, 0x18, 0x59, 0x11, 0x8B, 0x50, 0x4A, 0x4A, 0x29, 0x99,
+      0x03, 0x28, 0x5A, 0xA8, 0x04, 0x1F, 0x8B, 0x21, 0xD9, 0x20, 0x09, 0xA8,
+      0x1B, 0x0C, 0xE0, 0x92, 0xD1, 0x38, 0xA9, 0x88, 0x92, 0xE2, 0x04, 0x09,
+      0x58, 0x00, 0x2A, 0x81, 0x04, 0xA8, 0xB4, 0x03, 0x80, 0x73, 0x4A, 0x88,
+      0x2A, 0xA4, 0x38, 0x09, 0xD9, 0x96, 0x9A, 0xB0, 0xB2, 0xE3, 0xB1, 0x93,
+      0xAA, 0x96, 0x8B, 0x88, 0xA3, 0xA0, 0x9F, 0xA3, 0x8C, 0x05, 0x08, 0xB1,
+      0xB4, 0xA5, 0x12, 0x08, 0x04, 0x80, 0x6C, 0x80, 0x29, 0xA0, 0x82, 0x92,
+      0x96, 0x11, 0x90, 0x28, 0x01, 0xDB, 0xB5, 0xD3, 0x90, 0x29, 0xC0, 0xA0,
+      0x39, 0x0C, 0x9C, 0x91, 0xA1, 0x5D, 0x3B, 0x0E, 0x09, 0x00, 0xC0, 0x08,
+      0x13, 0x3E, 0x90, 0x91, 0x21, 0x6A, 0x39, 0x4C, 0x09, 0x20, 0xA0, 0x00,
+      0xA7, 0x80, 0x92, 0x31, 0x89, 0xA6, 0x00, 0x02, 0x3B, 0x38, 0xF9, 0xA2,
+      0x9A, 0xE0, 0xB4, 0x80, 0xA0, 0x20, 0x0A, 0xAC, 0xE3, 0x20, 0x8A, 0x0B,
+      0x20, 0x0F, 0x18, 0xE8, 0xA1, 0x22, 0x2B, 0x40, 0x0A, 0x12, 0x32, 0x2A,
+      0x82, 0x5E, 0xD2, 0x48, 0xA1, 0x22, 0xC8, 0x18, 0x12, 0xD4, 0x03, 0x10,
+      0x0B, 0x12, 0xA1, 0xE0, 0x18, 0x2C, 0x0D, 0x00, 0x9C, 0x84, 0x98, 0x89,
+      0x1A, 0x1D, 0xB2, 0x98, 0x49, 0xCB, 0x30, 0x0D, 0x00, 0xF9, 0x02, 0xB9,
+      0x05, 0x1A, 0xB3, 0x41, 0x89, 0x23, 0x2E, 0x39, 0x2A, 0x19, 0x11, 0x10,
+      0x95, 0x30, 0x3C, 0x5B, 0xD4, 0xA4, 0x00, 0xA2, 0x03, 0x0C, 0x95, 0x89,
+      0x4A, 0x2C, 0x0B, 0x81, 0xC1, 0x18, 0x0B, 0x89, 0xAA, 0xC2, 0x95, 0xB1,
+      0xB9, 0x05, 0x9C, 0x98, 0x14, 0x8B, 0x0C, 0x84, 0x0D, 0xA1, 0x23, 0x9A,
+      0x96, 0xB2, 0x23, 0x98, 0x58, 0x0A, 0x91, 0x86, 0x90, 0x11, 0x38, 0xB9,
+      0x84, 0x00, 0x05, 0x2A, 0x10, 0xCA, 0xB6, 0x10, 0x90, 0xB3, 0x38, 0xBB,
+      0x99, 0x59, 0x0B, 0x19, 0xC8, 0x88, 0xC8, 0x80, 0x4A, 0xC8, 0x10, 0x8B,
+      0xA3, 0xA1, 0x92, 0x82 };
+const sound_t sfxAlienDown =
+  { SOUND_ADPCM, 3200, sfxAlienDown_data };
+
+static const uint8_t sfxPlayerDown_data[2400] =
+  { 0x70, 0x77, 0x77, 0xA8, 0x9A, 0xCA, 0xDF, 0xAC, 0x1A, 0x55, 0x35, 0x12,
+      0xA8, 0xBB, 0x9B, 0xA9, 0xDD, 0xBC, 0x0A, 0x64, 0x44, 0x12, 0x98, 0xAA,
+      0xAA, 0x99, 0xCA, 0xBD, 0x8B, 0x72, 0x35, 0x23, 0x80, 0xBB, 0xAB, 0x9A,
+      0xCA, 0xCD, 0xAA, 0x51, 0x45, 0x23, 0x81, 0xBA, 0xAA, 0x9A, 0xA9, 0xDC,
+      0x9B, 0x30, 0x56, 0x33, 0x01, 0xB9, 0xBA, 0x9A, 0xA9, 0xEB, 0xBB, 0x28,
+      0x56, 0x43, 0x11, 0x99, 0xBA, 0x99, 0x99, 0xCB, 0xBC, 0x09, 0x64, 0x34,
+      0x12, 0x90, 0xAB, 0x9B, 0xA9, 0xCA, 0xBC, 0x8B, 0x73, 0x35, 0x13, 0x91,
+      0xBA, 0xBA, 0x99, 0xBA, 0xCD, 0x8B, 0x50, 0x45, 0x23, 0x81, 0xAA, 0xAB,
+      0x99, 0xAA, 0xBD, 0x9C, 0x38, 0x47, 0x23, 0x02, 0xA9, 0xBB, 0x9A, 0xA9,
+      0xCC, 0xBB, 0x28, 0x56, 0x34, 0x11, 0xA8, 0xBA, 0x9A, 0xA9, 0xDA, 0xCB,
+      0x19, 0x73, 0x34, 0x12, 0x90, 0xAB, 0x9B, 0x9A, 0xCA, 0xBC, 0x8B, 0x73,
+      0x44, 0x22, 0x80, 0xB9, 0xAA, 0x9A, 0xC9, 0xCB, 0x9B, 0x42, 0x37, 0x24,
+      0x00, 0xA9, 0xAB, 0x99, 0xAA, 0xBC, 0xAC, 0x30, 0x47, 0x33, 0x02, 0xA9,
+      0xBB, 0xAA, 0xB9, 0xCC, 0xAC, 0x28, 0x55, 0x43, 0x12, 0xA8, 0xAA, 0x9B,
+      0x9A, 0xDB, 0xBB, 0x09, 0x55, 0x44, 0x12, 0x90, 0xAA, 0xAA, 0x99, 0xBB,
+      0xBD, 0x8A, 0x63, 0x45, 0x22, 0x80, 0xA9, 0xAB, 0xA9, 0xBA, 0xBD, 0x8B,
+      0x51, 0x36, 0x24, 0x01, 0xA9, 0xAB, 0xAA, 0xB9, 0xCC, 0x9B, 0x48, 0x55,
+      0x33, 0x11, 0xA9, 0xBA, 0xAB, 0xAA, 0xBD, 0xAC, 0x28, 0x55, 0x34, 0x12,
+      0x98, 0xAB, 0xAB, 0xAA, 0xDB, 0xBB, 0x1A, 0x74, 0x34, 0x13, 0x90, 0xAA,
+      0xAB, 0xAB, 0xCB, 0xBC, 0x8A, 0x73, 0x44, 0x23, 0x80, 0xB9, 0xBA, 0x9A,
+      0xBB, 0xCD, 0x8A, 0x41, 0x45, 0x14, 0x01, 0xA8, 0xAA, 0xAA, 0xAA, 0xBC,
+      0x9C, 0x30, 0x46, 0x34, 0x11, 0x99, 0xAB, 0xAA, 0xBA, 0xCC, 0xBA, 0x28,
+      0x46, 0x25, 0x12, 0x98, 0xB9, 0xAA, 0xAA, 0xDB, 0xAB, 0x09, 0x64, 0x34,
+      0x23, 0x80, 0xBA, 0xBB, 0xBA, 0xBC, 0xBD, 0x89, 0x63, 0x54, 0x22, 0x80,
+      0xA8, 0xAB, 0xAA, 0xCA, 0xBB, 0x9B, 0x52, 0x37, 0x24, 0x01, 0xA9, 0xAA,
+      0xAA, 0xBB, 0xBC, 0x9C, 0x30, 0x56, 0x33, 0x12, 0xA8, 0xBA, 0xBB, 0xCB,
+      0xDB, 0xAA, 0x29, 0x46, 0x34, 0x13, 0x98, 0xBA, 0xBA, 0xBB, 0xCC, 0xBB,
+      0x19, 0x55, 0x44, 0x12, 0x81, 0xAA, 0xAB, 0xBA, 0xBB, 0xBD, 0x0A, 0x72,
+      0x44, 0x22, 0x81, 0xA9, 0xBA, 0xAA, 0xCB, 0xAC, 0x9A, 0x51, 0x45, 0x33,
+      0x01, 0xA8, 0xBB, 0xBB, 0xCB, 0xBC, 0x9B, 0x40, 0x55, 0x24, 0x02, 0x90,
+      0xAB, 0xBA, 0xCA, 0xBB, 0xBB, 0x38, 0x47, 0x25, 0x13, 0x88, 0xAA, 0xBB,
+      0xBA, 0xBC, 0xAC, 0x09, 0x64, 0x34, 0x22, 0x81, 0xAA, 0xBB, 0xAC, 0xCB,
+      0xBB, 0x89, 0x73, 0x44, 0x23, 0x01, 0xA9, 0xBB, 0xBB, 0xDB, 0xBB, 0x9A,
+      0x52, 0x46, 0x23, 0x02, 0xA8, 0xBA, 0xAC, 0xCA, 0xBA, 0x9B, 0x40, 0x55,
+      0x43, 0x11, 0x90, 0xBA, 0xBA, 0xBB, 0xBC, 0x9C, 0x28, 0x55, 0x43, 0x13,
+      0x80, 0xBA, 0xBB, 0xCB, 0xCB, 0xAB, 0x19, 0x45, 0x35, 0x14, 0x81, 0xA9,
+      0xAB, 0xBB, 0xCB, 0xAC, 0x09, 0x62, 0x44, 0x22, 0x82, 0xA8, 0xBB, 0xBB,
+      0xBC, 0xBC, 0x99, 0x52, 0x45, 0x33, 0x02, 0xA8, 0xCA, 0xBA, 0xCB, 0xBB,
+      0x9B, 0x41, 0x46, 0x24, 0x12, 0x90, 0xBA, 0xBB, 0xCB, 0xAC, 0x9B, 0x28,
+      0x55, 0x34, 0x23, 0x90, 0xB9, 0xCB, 0xBB, 0xBC, 0xAB, 0x19, 0x55, 0x44,
+      0x22, 0x00, 0xA9, 0xBB, 0xBB, 0xCC, 0xBA, 0x09, 0x63, 0x44, 0x23, 0x02,
+      0xA9, 0xCA, 0xBA, 0xBC, 0xAB, 0x8A, 0x61, 0x44, 0x24, 0x11, 0x98, 0xAA,
+      0xAC, 0xBB, 0xCB, 0x8A, 0x30, 0x37, 0x25, 0x12, 0x90, 0xB9, 0xBB, 0xBC,
+      0xCB, 0xAA, 0x20, 0x55, 0x34, 0x22, 0x80, 0xB9, 0xCB, 0xBB, 0xBC, 0xAB,
+      0x19, 0x55, 0x34, 0x14, 0x01, 0xA9, 0xBA, 0xBC, 0xBB, 0xAC, 0x09, 0x63,
+      0x44, 0x23, 0x11, 0x99, 0xBB, 0xBC, 0xBC, 0xAB, 0x8A, 0x52, 0x45, 0x33,
+      0x13, 0x98, 0xCB, 0xBB, 0xCC, 0xBA, 0x99, 0x31, 0x46, 0x34, 0x12, 0x90,
+      0xB9, 0xCB, 0xAC, 0xBB, 0x9B, 0x20, 0x46, 0x34, 0x23, 0x81, 0xB9, 0xBC,
+      0xBC, 0xBB, 0x9C, 0x18, 0x73, 0x43, 0x23, 0x82, 0xA8, 0xCB, 0xAC, 0xCB,
+      0xAA, 0x08, 0x52, 0x35, 0x33, 0x12, 0xA8, 0xCB, 0xBC, 0xAC, 0xAB, 0x0A,
+      0x51, 0x54, 0x23, 0x12, 0x90, 0xBA, 0xCC, 0xBB, 0xBB, 0x8A, 0x41, 0x55,
+      0x33, 0x13, 0x81, 0xCA, 0xCB, 0xBB, 0xBC, 0x9A, 0x30, 0x45, 0x44, 0x22,
+      0x00, 0xA9, 0xCB, 0xCB, 0xBA, 0x9B, 0x18, 0x54, 0x44, 0x22, 0x01, 0xA8,
+      0xCA, 0xCB, 0xAB, 0xAB, 0x09, 0x44, 0x35, 0x24, 0x02, 0x90, 0xBB, 0xBD,
+      0xBB, 0xAC, 0x09, 0x51, 0x63, 0x32, 0x12, 0x80, 0xBA, 0xBD, 0xCB, 0xBA,
+      0x89, 0x31, 0x55, 0x43, 0x12, 0x81, 0xB9, 0xDB, 0xBB, 0xAC, 0x8A, 0x20,
+      0x54, 0x34, 0x22, 0x01, 0xA9, 0xDB, 0xAC, 0xBB, 0xAA, 0x28, 0x54, 0x34,
+      0x33, 0x02, 0xA8, 0xDB, 0xBC, 0xCB, 0x9A, 0x19, 0x52, 0x34, 0x34, 0x12,
+      0x98, 0xCA, 0xBC, 0xCB, 0xAA, 0x09, 0x41, 0x35, 0x34, 0x22, 0x80, 0xCA,
+      0xDB, 0xBB, 0xAB, 0x89, 0x31, 0x46, 0x24, 0x23, 0x00, 0xAA, 0xCC, 0xCB,
+      0xBA, 0x99, 0x21, 0x54, 0x43, 0x23, 0x01, 0xA9, 0xDB, 0xBC, 0xAB, 0x9B,
+      0x10, 0x54, 0x34, 0x33, 0x02, 0x98, 0xBC, 0xCD, 0xBA, 0x9A, 0x08, 0x43,
+      0x35, 0x34, 0x12, 0x88, 0xCA, 0xBC, 0xBC, 0xAA, 0x09, 0x42, 0x44, 0x24,
+      0x22, 0x80, 0xB9, 0xBD, 0xBC, 0xAB, 0x09, 0x31, 0x45, 0x34, 0x32, 0x81,
+      0xA9, 0xBD, 0xBD, 0xBA, 0x89, 0x20, 0x35, 0x35, 0x23, 0x02, 0xA8, 0xCC,
+      0xBC, 0xBB, 0x9B, 0x20, 0x44, 0x35, 0x33, 0x12, 0x98, 0xCC, 0xDB, 0xAB,
+      0x9A, 0x08, 0x43, 0x35, 0x24, 0x12, 0x91, 0xCA, 0x8F, 0x08, 0x08, 0x88,
+      0x88, 0x88, 0x10, 0x21, 0x22, 0x11, 0x90, 0xBB, 0xAB, 0xAA, 0xA9, 0xED,
+      0xDB, 0xAB, 0x29, 0x74, 0x53, 0x22, 0x82, 0xA8, 0xBA, 0xBB, 0xA9, 0xA9,
+      0xDD, 0xBC, 0xAB, 0x30, 0x56, 0x44, 0x22, 0x00, 0xA9, 0xBA, 0xAB, 0x99,
+      0xAA, 0xCD, 0xBC, 0x9A, 0x41, 0x55, 0x43, 0x22, 0x80, 0xAA, 0xAB, 0x9B,
+      0x99, 0xBA, 0xDC, 0xAC, 0x8A, 0x42, 0x55, 0x33, 0x22, 0x90, 0xBA, 0xBB,
+      0xAB, 0xA9, 0xCA, 0xBD, 0xAD, 0x89, 0x53, 0x35, 0x34, 0x12, 0x90, 0xBA,
+      0xBB, 0x9B, 0xAA, 0xDA, 0xCC, 0xBA, 0x19, 0x73, 0x44, 0x23, 0x02, 0x90,
+      0xBB, 0xBB, 0x9A, 0xA9, 0xBC, 0xBE, 0xAB, 0x18, 0x55, 0x44, 0x23, 0x01,
+      0x98, 0xBA, 0xBB, 0x9A, 0xAA, 0xEB, 0xDB, 0x9A, 0x28, 0x45, 0x35, 0x32,
+      0x01, 0xA9, 0xBB, 0xAB, 0xAA, 0xAA, 0xCD, 0xCB, 0x9B, 0x31, 0x56, 0x43,
+      0x23, 0x81, 0xA9, 0xBB, 0xAB, 0x9A, 0xCA, 0xDB, 0xAC, 0x9A, 0x41, 0x55,
+      0x33, 0x23, 0x81, 0xB9, 0xAC, 0xAB, 0xA9, 0xBA, 0xCD, 0xBB, 0x0A, 0x62,
+      0x54, 0x33, 0x23, 0x90, 0xB9, 0xAC, 0x9B, 0xAA, 0xBA, 0xCD, 0xBB, 0x09,
+      0x73, 0x44, 0x33, 0x12, 0x90, 0xBA, 0xBB, 0xBB, 0xAA, 0xCC, 0xBC, 0xAC,
+      0x08, 0x54, 0x44, 0x33, 0x02, 0x90, 0xAB, 0xAC, 0x9A, 0xAA, 0xCB, 0xBC,
+      0x9C, 0x18, 0x64, 0x53, 0x32, 0x01, 0x98, 0xBA, 0xBA, 0xAA, 0xBA, 0xCC,
+      0xBC, 0xAA, 0x30, 0x56, 0x53, 0x22, 0x01, 0x98, 0xAB, 0xAB, 0x9B, 0xBB,
+      0xCC, 0xAC, 0x9B, 0x31, 0x47, 0x34, 0x23, 0x81, 0xA8, 0xCB, 0xAA, 0x9A,
+      0xAB, 0xCC, 0xCB, 0x89, 0x31, 0x47, 0x43, 0x22, 0x80, 0xA8, 0xBB, 0xBA,
+      0xAA, 0xCB, 0xBC, 0xBC, 0x89, 0x62, 0x35, 0x34, 0x13, 0x81, 0xAA, 0xAC,
+      0xBA, 0xB9, 0xCA, 0xBC, 0xBB, 0x09, 0x64, 0x44, 0x33, 0x13, 0x80, 0xBA,
+      0xCB, 0xAB, 0xAA, 0xBC, 0xCC, 0xAA, 0x18, 0x73, 0x44, 0x23, 0x12, 0x90,
+      0xBA, 0xBB, 0xBB, 0xCA, 0xCB, 0xBC, 0xAB, 0x20, 0x46, 0x35, 0x24, 0x01,
+      0x90, 0xAA, 0xBB, 0xBA, 0xCA, 0xCB, 0xCB, 0x9A, 0x30, 0x46, 0x25, 0x33,
+      0x01, 0x98, 0xBB, 0xBB, 0xBB, 0xDB, 0xCB, 0xAC, 0x8A, 0x40, 0x45, 0x34,
+      0x23, 0x82, 0xA8, 0xBB, 0xAC, 0xAB, 0xBB, 0xBD, 0xBC, 0x89, 0x42, 0x46,
+      0x24, 0x13, 0x01, 0xA9, 0xBA, 0xAC, 0xAA, 0xBB, 0xBD, 0xBB, 0x09, 0x73,
+      0x44, 0x24, 0x22, 0x80, 0x99, 0xBB, 0xBB, 0xBB, 0xCC, 0xCB, 0xAA, 0x09,
+      0x54, 0x35, 0x24, 0x13, 0x80, 0xB9, 0xBB, 0xBB, 0xBC, 0xCB, 0xBC, 0xAA,
+      0x18, 0x55, 0x44, 0x33, 0x12, 0x90, 0xAA, 0xAC, 0xAB, 0xBB, 0xCC, 0xBB,
+      0xAA, 0x20, 0x47, 0x34, 0x24, 0x11, 0x90, 0xAA, 0xBB, 0xCB, 0xBA, 0xBC,
+      0xAC, 0x9A, 0x30, 0x47, 0x53, 0x22, 0x11, 0x98, 0xBA, 0xBA, 0xAC, 0xBB,
+      0xDB, 0xAB, 0x8A, 0x41, 0x46, 0x34, 0x22, 0x02, 0xA8, 0xBA, 0xBC, 0xBA,
+      0xBC, 0xCB, 0xBB, 0x89, 0x63, 0x54, 0x43, 0x22, 0x00, 0xA8, 0xBA, 0xBB,
+      0xAC, 0xAC, 0xAC, 0xAB, 0x08, 0x63, 0x44, 0x34, 0x12, 0x01, 0xA9, 0xBB,
+      0xCB, 0xBB, 0xBC, 0xCB, 0x9B, 0x19, 0x45, 0x35, 0x34, 0x22, 0x80, 0xA9,
+      0xCB, 0xBA, 0xAC, 0xCB, 0xBB, 0xAA, 0x20, 0x55, 0x35, 0x43, 0x11, 0x91,
+      0xA9, 0xBB, 0xCB, 0xBB, 0xBC, 0xAC, 0x9A, 0x30, 0x55, 0x44, 0x32, 0x02,
+      0x80, 0xAA, 0xCB, 0xBB, 0xCB, 0xCB, 0xBA, 0x8A, 0x41, 0x45, 0x44, 0x22,
+      0x02, 0x90, 0xAA, 0xCB, 0xBB, 0xCB, 0xCB, 0xBA, 0x09, 0x51, 0x54, 0x43,
+      0x23, 0x01, 0x98, 0xAA, 0xBC, 0xCB, 0xCA, 0xBA, 0xAB, 0x09, 0x63, 0x44,
+      0x34, 0x23, 0x01, 0xA8, 0xCA, 0xBB, 0xCB, 0xCB, 0xBB, 0xAB, 0x18, 0x54,
+      0x35, 0x34, 0x23, 0x01, 0xA8, 0xCB, 0xCB, 0xBB, 0xBC, 0xBB, 0xAB, 0x10,
+      0x46, 0x44, 0x24, 0x12, 0x81, 0xA8, 0xBB, 0xDB, 0xBA, 0xAC, 0xBB, 0x9A,
+      0x20, 0x46, 0x44, 0x23, 0x22, 0x00, 0xAA, 0xCB, 0xCB, 0xCB, 0xBA, 0xBB,
+      0x8A, 0x40, 0x45, 0x44, 0x23, 0x12, 0x80, 0xB9, 0xCB, 0xCB, 0xCB, 0xAB,
+      0xBB, 0x89, 0x42, 0x55, 0x43, 0x33, 0x02, 0x80, 0xBA, 0xBC, 0xBC, 0xAC,
+      0xAC, 0x9A, 0x09, 0x41, 0x45, 0x43, 0x23, 0x12, 0x98, 0xBA, 0xBC, 0xBC,
+      0xBC, 0xBB, 0xAA, 0x19, 0x73, 0x34, 0x25, 0x23, 0x11, 0x98, 0xCA, 0xBB,
+      0xBC, 0xBC, 0xBB, 0x9A, 0x18, 0x54, 0x35, 0x34, 0x22, 0x02, 0x99, 0xBB,
+      0xBD, 0xBC, 0xCB, 0xBA, 0x99, 0x10, 0x45, 0x44, 0x33, 0x22, 0x01, 0xA8,
+      0xCB, 0xBC, 0xBC, 0xAC, 0xAB, 0x89, 0x30, 0x64, 0x43, 0x24, 0x12, 0x81,
+      0xA8, 0xBB, 0xBD, 0xCB, 0xBB, 0xAB, 0x8A, 0x32, 0x47, 0x43, 0x33, 0x13,
+      0x81, 0xB9, 0xEB, 0xBB, 0xBC, 0xCB, 0x9A, 0x09, 0x41, 0x44, 0x34, 0x24,
+      0x12, 0x80, 0xAA, 0xCB, 0xBC, 0xBC, 0xAB, 0x9B, 0x19, 0x62, 0x63, 0x33,
+      0x33, 0x12, 0x90, 0xBA, 0xCD, 0xCB, 0xBB, 0xAB, 0x9B, 0x18, 0x44, 0x45,
+      0x33, 0x24, 0x11, 0x88, 0xBA, 0xCC, 0xCB, 0xBB, 0xAB, 0x9A, 0x10, 0x45,
+      0x44, 0x33, 0x33, 0x02, 0x98, 0xCB, 0xCC, 0xCB, 0xBB, 0xAB, 0x8A, 0x30,
+      0x64, 0x43, 0x24, 0x13, 0x02, 0xA8, 0xCA, 0xBC, 0xBC, 0xBB, 0xAB, 0x8A,
+      0x41, 0x54, 0x53, 0x32, 0x22, 0x01, 0xA8, 0xCB, 0xCC, 0xCB, 0xBA, 0x9A,
+      0x09, 0x31, 0x36, 0x35, 0x33, 0x23, 0x81, 0xB8, 0xCC, 0xCC, 0xBB, 0xAB,
+      0x9B, 0x19, 0x42, 0x45, 0x34, 0x33, 0x22, 0x81, 0xB9, 0xBD, 0xBD, 0xBC,
+      0xBA, 0x99, 0x18, 0x52, 0x44, 0x33, 0x24, 0x13, 0x80, 0xB9, 0xBD, 0xCC,
+      0xBB, 0xAB, 0x9A, 0x20, 0x63, 0x34, 0x34, 0x33, 0x22, 0x90, 0xCA, 0xCC,
+      0xDB, 0xBA, 0xAA, 0x8A, 0x11, 0x44, 0x34, 0x34, 0x33, 0x12, 0x88, 0xCB,
+      0xBD, 0xCC, 0xBA, 0xAA, 0x88, 0x30, 0x44, 0x34, 0x34, 0x23, 0x12, 0x98,
+      0xDB, 0xBC, 0xCC, 0xBA, 0x17, 0x80, 0x08, 0x88, 0x00, 0x00, 0x11, 0x11,
+      0x00, 0x98, 0xA9, 0xAA, 0x99, 0x99, 0xCA, 0xDC, 0xCC, 0xAA, 0x09, 0x62,
+      0x54, 0x33, 0x24, 0x01, 0x99, 0xCA, 0xBA, 0x9A, 0x9A, 0xB9, 0xDC, 0xCC,
+      0xBB, 0x8A, 0x41, 0x46, 0x34, 0x24, 0x02, 0x80, 0xBA, 0xBB, 0xAC, 0x99,
+      0x99, 0xCA, 0xBC, 0xBD, 0xAA, 0x20, 0x64, 0x34, 0x34, 0x13, 0x81, 0xA8,
+      0xCB, 0xAB, 0xAA, 0x99, 0xB9, 0xCC, 0xCC, 0xBA, 0x09, 0x51, 0x54, 0x43,
+      0x23, 0x12, 0x88, 0xBA, 0xAC, 0xAB, 0xA9, 0x99, 0xBB, 0xBE, 0xCC, 0x9A,
+      0x28, 0x63, 0x44, 0x24, 0x22, 0x81, 0x98, 0xBA, 0xAC, 0x9A, 0x9A, 0xA9,
+      0xCB, 0xBD, 0xCB, 0x99, 0x31, 0x56, 0x43, 0x33, 0x22, 0x80, 0xAA, 0xCB,
+      0xBB, 0xAA, 0xA9, 0xBA, 0xCD, 0xBC, 0xAB, 0x09, 0x62, 0x45, 0x43, 0x32,
+      0x11, 0x90, 0xB9, 0xAC, 0xAB, 0x9A, 0x9A, 0xCB, 0xBC, 0xBD, 0xAA, 0x18,
+      0x54, 0x35, 0x34, 0x33, 0x01, 0xA0, 0xCA, 0xBA, 0xBB, 0xAA, 0xB9, 0xDB,
+      0xCC, 0xBB, 0x9B, 0x38, 0x46, 0x35, 0x34, 0x13, 0x02, 0x99, 0xBB, 0xAC,
+      0xAB, 0xAA, 0xAA, 0xCC, 0xBC, 0xAC, 0x9A, 0x30, 0x46, 0x44, 0x33, 0x22,
+      0x01, 0x99, 0xCB, 0xBA, 0xAB, 0x9B, 0xBB, 0xCC, 0xCC, 0xBA, 0x8A, 0x30,
+      0x56, 0x53, 0x23, 0x23, 0x00, 0xA8, 0xCA, 0xBA, 0xAB, 0xAA, 0xAB, 0xBD,
+      0xCC, 0xBB, 0x8A, 0x40, 0x64, 0x43, 0x24, 0x22, 0x81, 0x98, 0xBA, 0xBB,
+      0xAC, 0x9A, 0xBA, 0xBC, 0xBD, 0xCB, 0x8A, 0x20, 0x55, 0x34, 0x34, 0x23,
+      0x02, 0x98, 0xBB, 0xBC, 0xAB, 0xAB, 0xBB, 0xCC, 0xBC, 0xBC, 0x9A, 0x10,
+      0x55, 0x34, 0x25, 0x23, 0x02, 0x90, 0xAA, 0xAC, 0xAB, 0xAB, 0xBA, 0xDB,
+      0xDB, 0xBB, 0xAA, 0x19, 0x54, 0x45, 0x33, 0x24, 0x12, 0x81, 0xB9, 0xBB,
+      0xAC, 0xAB, 0xAB, 0xAC, 0xCC, 0xBB, 0xBB, 0x0A, 0x62, 0x45, 0x53, 0x32,
+      0x22, 0x01, 0x99, 0xBB, 0xCB, 0xBB, 0xBA, 0xBB, 0xBD, 0xBD, 0xBB, 0x9A,
+      0x31, 0x56, 0x34, 0x34, 0x33, 0x02, 0x80, 0xBA, 0xBC, 0xAC, 0xBA, 0xAA,
+      0xBC, 0xDB, 0xBB, 0xAB, 0x19, 0x73, 0x44, 0x34, 0x43, 0x21, 0x00, 0x99,
+      0xBA, 0xCB, 0xBA, 0xBA, 0xBB, 0xBD, 0xBC, 0xAC, 0x99, 0x21, 0x46, 0x34,
+      0x34, 0x33, 0x12, 0x88, 0xBA, 0xDB, 0xBA, 0xBB, 0xCA, 0xBB, 0xCC, 0xBB,
+      0xAB, 0x09, 0x73, 0x44, 0x34, 0x33, 0x23, 0x02, 0xA8, 0xBB, 0xBD, 0xBB,
+      0xBB, 0xBC, 0xDB, 0xCB, 0xBA, 0x9A, 0x28, 0x55, 0x34, 0x35, 0x23, 0x13,
+      0x81, 0xA9, 0xBB, 0xBD, 0xBA, 0xBB, 0xBC, 0xDB, 0xBB, 0xAC, 0x89, 0x21,
+      0x46, 0x44, 0x33, 0x33, 0x22, 0x80, 0xBA, 0xDB, 0xBB, 0xBB, 0xBC, 0xBB,
+      0xBD, 0xAC, 0xAB, 0x89, 0x52, 0x54, 0x34, 0x43, 0x32, 0x11, 0x90, 0xB9,
+      0xCB, 0xBB, 0xCB, 0xBB, 0xCB, 0xBC, 0xBB, 0x9C, 0x09, 0x52, 0x54, 0x53,
+      0x32, 0x23, 0x11, 0x88, 0xB9, 0xCB, 0xAC, 0xAB, 0xCB, 0xBB, 0xBC, 0xCB,
+      0xAA, 0x08, 0x53, 0x45, 0x53, 0x32, 0x23, 0x12, 0x88, 0xAA, 0xBC, 0xCB,
+      0xBB, 0xBB, 0xCC, 0xBB, 0xAC, 0x9B, 0x09, 0x43, 0x46, 0x34, 0x24, 0x23,
+      0x12, 0x90, 0xA9, 0xCB, 0xCB, 0xBA, 0xAC, 0xBB, 0xBC, 0xAC, 0x9B, 0x09,
+      0x51, 0x44, 0x44, 0x33, 0x33, 0x22, 0x00, 0xB9, 0xCB, 0xBC, 0xCB, 0xCA,
+      0xBA, 0xCB, 0xBB, 0xAB, 0x89, 0x31, 0x47, 0x44, 0x33, 0x24, 0x22, 0x81,
+      0x98, 0xBA, 0xBC, 0xCB, 0xBB, 0xBC, 0xCB, 0xCB, 0xAA, 0x8A, 0x28, 0x54,
+      0x44, 0x24, 0x24, 0x12, 0x02, 0x90, 0xA9, 0xBB, 0xAD, 0xBB, 0xBC, 0xCB,
+      0xBB, 0xBB, 0xAB, 0x08, 0x73, 0x44, 0x34, 0x24, 0x33, 0x12, 0x81, 0x99,
+      0xCB, 0xCB, 0xBB, 0xBC, 0xAC, 0xCB, 0xBA, 0xAB, 0x89, 0x30, 0x46, 0x44,
+      0x43, 0x33, 0x22, 0x02, 0x90, 0xB9, 0xBC, 0xBC, 0xBC, 0xCB, 0xBB, 0xCB,
+      0xAB, 0x9B, 0x08, 0x53, 0x45, 0x34, 0x34, 0x33, 0x22, 0x01, 0x99, 0xBB,
+      0xBD, 0xBC, 0xCB, 0xCB, 0xBA, 0xAC, 0xAA, 0x99, 0x20, 0x44, 0x45, 0x43,
+      0x33, 0x33, 0x12, 0x81, 0xA9, 0xDB, 0xCB, 0xCB, 0xBB, 0xCB, 0xCB, 0xBA,
+      0x9A, 0x89, 0x31, 0x46, 0x34, 0x25, 0x33, 0x33, 0x11, 0x80, 0xB9, 0xDB,
+      0xCB, 0xAC, 0xCB, 0xBA, 0xCB, 0xBA, 0xA9, 0x08, 0x42, 0x54, 0x34, 0x34,
+      0x33, 0x23, 0x12, 0x80, 0xBA, 0xCC, 0xBC, 0xCB, 0xBB, 0xBC, 0xCB, 0xAA,
+      0x9A, 0x18, 0x42, 0x45, 0x53, 0x33, 0x24, 0x13, 0x02, 0x80, 0xB9, 0xCB,
+      0xBC, 0xBC, 0xBC, 0xBB, 0xAC, 0xAB, 0x9A, 0x08, 0x52, 0x44, 0x44, 0x33,
+      0x43, 0x22, 0x02, 0x80, 0xA9, 0xCB, 0xBC, 0xBC, 0xBC, 0xBB, 0xAC, 0xAB,
+      0xAA, 0x18, 0x51, 0x44, 0x53, 0x43, 0x23, 0x23, 0x12, 0x81, 0x99, 0xBC,
+      0xBC, 0xBD, 0xBB, 0xBC, 0xAC, 0xBA, 0xA9, 0x08, 0x31, 0x45, 0x44, 0x43,
+      0x33, 0x33, 0x13, 0x11, 0x99, 0xCB, 0xBC, 0xBD, 0xCB, 0xCB, 0xAB, 0xBB,
+      0xAA, 0x89, 0x21, 0x54, 0x44, 0x43, 0x43, 0x32, 0x22, 0x01, 0x80, 0xB9,
+      0xDB, 0xBC, 0xDB, 0xCA, 0xAA, 0xAB, 0xAB, 0x99, 0x10, 0x42, 0x45, 0x43,
+      0x34, 0x33, 0x33, 0x22, 0x81, 0xA8, 0xCB, 0xBD, 0xBC, 0xBC, 0xBC, 0xAB,
+      0xBB, 0x9A, 0x09, 0x21, 0x45, 0x44, 0x43, 0x43, 0x32, 0x22, 0x11, 0x80,
+      0xA9, 0xBC, 0xBD, 0xBC, 0xCB, 0xCB, 0xAA, 0xAA, 0x89, 0x18, 0x32, 0x45,
+      0x44, 0x42, 0x32, 0x23, 0x22, 0x01, 0x90, 0xBA, 0xDC, 0xCB, 0xCB, 0xBB,
+      0xCB, 0xAA, 0xAA, 0x88, 0x20, 0x53, 0x53, 0x34, 0x43, 0x33, 0x33, 0x12,
+      0x01, 0x98, 0xCB, 0xCC, 0xDB, 0xBB, 0xBB, 0xBC, 0xAA, 0x9A, 0x08, 0x21,
+      0x44, 0x34, 0x35, 0x33, 0x24, 0x23, 0x11, 0x81, 0xA8, 0xCA, 0xBC, 0xBD,
+      0xBB, 0xBC, 0xBA, 0xAA, 0x89, 0x18, 0x31, 0x35, 0x35, 0x43, 0x33, 0x23,
+      0x13, 0x02, 0x90, 0xB9, 0xBC, 0xAD, 0xBB, 0xCB, 0xA9, 0x09, 0x00, 0x22 };
+const sound_t sfxPlayerDown =
+  { SOUND_ADPCM, 4800, sfxPlayerDown_data };
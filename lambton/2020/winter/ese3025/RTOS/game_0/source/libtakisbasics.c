@@ -9,7 +9,40 @@
 #include "libtakisbasics.h"
 
 
+/*
+ *
+ * signum function
+ * 	integer-argument version
+ *
+ */
+int
+sgn (const void *parg)
+{
+  int arg = *((int *) parg);
+  int ret = 0;
+
+  if (arg > 0)
+    ret = 1;
+  else if (arg < 0)
+    ret = -1;
+
+  return ret;
+}
+
+/*
+ *
+ * signum function
+ * 	integer-argument and boolean-result version
+ *
+ */
+bool_t
+sgn_bool (const void *parg)
+{
+  int arg = *((int *) parg);
+  bool_t ret = False;
 
-int sgn (void *);
+  if (arg > 0)
+    ret = True;
 
-bool_t sgn_bool (void *);
+  return ret;
+}
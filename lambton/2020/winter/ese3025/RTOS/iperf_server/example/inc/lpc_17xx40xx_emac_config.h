@@ -65,6 +65,26 @@ extern "C"
 /* Array of slow memory address ranges for LPC_CHECK_SLOWMEM */
 #define LPC_SLOWMEM_ARRAY
 
+/* Non-blocking transmit. When there are not enough free TX descriptors,
+   frames wait in a software queue that lpc_tx_reclaim() drains, instead
+   of the driver spinning. A full queue returns ERR_WOULDBLOCK. */
+#define LPC_TX_NONBLOCK 1
+
+/* Number of frames the TX queue holds in non-blocking mode */
+#define LPC_TX_QUEUE_LEN 8
+
+/* Budgeted RX polling. The EMAC interrupt masks RX and schedules
+   lpc_enetif_poll(), which is then called instead of lpc_enetif_input() */
+#define LPC_RX_POLL 1
+
+/* Maximum number of frames one lpc_enetif_poll() call receives */
+#define LPC_RX_POLL_BUDGET LPC_NUM_BUFF_RXDESCS
+
+/* Time in microSeconds RX stays masked after the ring has been drained,
+   so that following frames are taken by one interrupt. Uses the RI timer,
+   0 unmasks straight away. */
+#define LPC_RX_HOLDOFF_US 0
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,18 +1,89 @@
+#include <string.h>
+
 #include "lwip/debug.h"
 #include "lwip/stats.h"
 #include "lwip/tcp.h"
+#include "lwip/udp.h"
+#include "lwip/sys.h"
+#include "lwip/timers.h"
+
+#include "board.h"
+#include "iperf_server.h"
 
 /*---------------------------------------------------------------------------*/
 /* local defines                                                                                                                 */
 /*---------------------------------------------------------------------------*/
 #define IPERF_SERVER_PORT 5001
 
+/* Number of test streams (TCP RX, TCP TX and UDP) tracked at once */
+#ifndef IPERF_MAX_STREAMS
+#define IPERF_MAX_STREAMS 4
+#endif
+
+/* Answer the iperf2 -r / -d options with a reverse (TX) test */
+#ifndef IPERF_TX_ENABLE
+#define IPERF_TX_ENABLE   1
+#endif
+#if !LWIP_TCP
+#undef IPERF_TX_ENABLE
+#define IPERF_TX_ENABLE   0
+#endif
+
+/* How long a finished UDP test keeps its stream, to answer the client
+   repeating its last datagram until the server report gets through */
+#ifndef IPERF_UDP_LINGER_MS
+#define IPERF_UDP_LINGER_MS 2000
+#endif
+
+/* iperf2 header flags */
+#define IPERF_HEADER_VERSION1 0x80000000UL
+#define IPERF_RUN_NOW         0x00000001UL
+
 /*---------------------------------------------------------------------------*/
 /* local data                                                                                                                    */
 /*---------------------------------------------------------------------------*/
-#if LWIP_TCP
+#if LWIP_TCP || LWIP_UDP
+
+/* First bytes of an iperf2 client TCP stream / UDP datagram */
+struct iperf_client_hdr
+{
+  s32_t flags;
+  s32_t num_threads;
+  s32_t port;
+  s32_t buffer_len;
+  s32_t win_band;
+  s32_t amount;
+};
+
+/* Start of every iperf2 UDP datagram, id < 0 marks the last one */
+struct iperf_udp_hdr
+{
+  s32_t id;
+  u32_t tv_sec;
+  u32_t tv_usec;
+};
 
+/* Report returned to the iperf2 client at the end of a UDP test */
+struct iperf_server_hdr
+{
+  s32_t flags;
+  s32_t total_len1;
+  s32_t total_len2;
+  s32_t stop_sec;
+  s32_t stop_usec;
+  s32_t error_cnt;
+  s32_t outorder_cnt;
+  s32_t datagrams;
+  s32_t jitter1;
+  s32_t jitter2;
+};
+
+#if LWIP_TCP
 static struct tcp_pcb *iperf_pcb;
+#endif
+#if LWIP_UDP
+static struct udp_pcb *iperf_udp_pcb;
+#endif
 
 enum iperfserver_states
 {
@@ -22,28 +93,129 @@ enum iperfserver_states
   ES_CLOSING
 };
 
+enum iperfserver_kinds
+{
+  IPERF_TCP_RX = 0,
+  IPERF_TCP_TX,
+  IPERF_UDP_RX
+};
+
 struct iperfserver_state
 {
   u8_t state;
-  u8_t retries;
+  u8_t kind;
   struct tcp_pcb *pcb;
-  /* pbuf (chain) to recycle */
-  struct pbuf *p;
+  /* peer, for UDP stream matching and the reverse test */
+  ip_addr_t remote_ip;
+  u16_t remote_port;
+  /* iperf2 client header, gathered from the start of the stream */
+  struct iperf_client_hdr hdr;
+  u8_t hdr_len;
+  /* statistics */
+  struct iperf_stats stats;
+  /* reverse test: bytes left to send or, if timed, end time in ms */
+  u32_t tx_left;
+  u32_t tx_end;
+  u8_t tx_timed;
+  /* UDP: last sequence number and RFC 1889 transit time */
+  s32_t udp_last_id;
+  s32_t udp_transit;
 };
 
+static struct iperfserver_state iperf_streams[IPERF_MAX_STREAMS];
+
+#if IPERF_TX_ENABLE
+/* Payload of the reverse test; the leading zeroes form a client header
+   without flags, so the iperf2 client does not ask for another reverse run */
+static u8_t iperf_tx_buf[TCP_MSS];
+#endif
+
 /*---------------------------------------------------------------------------*/
 /* local functions                                                                                                              */
 /*---------------------------------------------------------------------------*/
+#if LWIP_TCP
 static err_t iperfserver_accept(void *arg, struct tcp_pcb *newpcb, err_t err);
 static err_t iperfserver_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err);
 static void iperfserver_error(void *arg, err_t err);
-static err_t iperfserver_sent(void *arg, struct tcp_pcb *tpcb, u16_t len);
-static void iperfserver_send(struct tcp_pcb *tpcb, struct iperfserver_state *es);
 static void iperfserver_close(struct tcp_pcb *tpcb, struct iperfserver_state *es);
+#endif
+#if LWIP_UDP
+static void iperfserver_udp_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p,
+                                 ip_addr_t *addr, u16_t port);
+static void iperfserver_udp_expire(void *arg);
+#endif
+#if IPERF_TX_ENABLE
+static void iperfserver_tx_start(struct iperfserver_state *rx);
+static err_t iperfserver_tx_connected(void *arg, struct tcp_pcb *tpcb, err_t err);
+static err_t iperfserver_tx_sent(void *arg, struct tcp_pcb *tpcb, u16_t len);
+static void iperfserver_tx_fill(struct tcp_pcb *tpcb, struct iperfserver_state *es);
+#endif
+
+static struct iperfserver_state *
+iperfserver_alloc(u8_t kind)
+{
+  int i;
+
+  for (i = 0; i < IPERF_MAX_STREAMS; i++)
+  {
+    if (iperf_streams[i].state == ES_NONE)
+    {
+      memset(&iperf_streams[i], 0, sizeof(iperf_streams[i]));
+      iperf_streams[i].kind = kind;
+      iperf_streams[i].stats.start_ms = sys_now();
+      iperf_streams[i].stats.last_ms = iperf_streams[i].stats.start_ms;
+      return &iperf_streams[i];
+    }
+  }
+  return NULL;
+}
+
+/* account for one received or sent segment */
+static void
+iperfserver_count(struct iperf_stats *st, u32_t len)
+{
+  u32_t now = sys_now();
+  u32_t gap = now - st->last_ms;
+
+  if (st->segments > 0)
+  {
+    st->gap_sum_ms += gap;
+    if (gap > st->gap_max_ms)
+    {
+      st->gap_max_ms = gap;
+    }
+  }
+  st->bytes += len;
+  st->segments++;
+  st->last_ms = now;
+}
+
+static void
+iperfserver_report(struct iperfserver_state *es)
+{
+  static const char *const kind[] = { "TCP RX", "TCP TX", "UDP RX" };
+  struct iperf_stats *st = &es->stats;
+  u32_t ms = st->last_ms - st->start_ms;
+  u32_t kbps = ms ? (u32_t) ((st->bytes * 8) / ms) : 0;
+
+  DEBUGOUT("iperf %s: %lu KB in %lu ms, %lu.%03lu Mb/s, %lu segs, gap avg %lu max %lu ms\r\n",
+           kind[es->kind], (unsigned long) (st->bytes / 1024), (unsigned long) ms,
+           (unsigned long) (kbps / 1000), (unsigned long) (kbps % 1000),
+           (unsigned long) st->segments,
+           (unsigned long) (st->segments > 1 ? st->gap_sum_ms / (st->segments - 1) : 0),
+           (unsigned long) st->gap_max_ms);
+  if (es->kind == IPERF_UDP_RX)
+  {
+    DEBUGOUT("iperf UDP RX: jitter %lu us, lost %lu/%ld, out of order %lu\r\n",
+             (unsigned long) st->jitter_us, (unsigned long) st->lost,
+             (long) (es->udp_last_id + 1), (unsigned long) st->outorder);
+  }
+}
 
 void
 iperf_server_init(void)
 {
+#if LWIP_TCP
   iperf_pcb = tcp_new();
   if (iperf_pcb != NULL)
   {
@@ -55,7 +227,7 @@ iperf_server_init(void)
       iperf_pcb = tcp_listen(iperf_pcb);
       tcp_accept(iperf_pcb, iperfserver_accept);
     }
-    else 
+    else
     {
       /* abort? output diagnostic? */
     }
@@ -64,9 +236,36 @@ iperf_server_init(void)
   {
     /* abort? output diagnostic? */
   }
+#endif /* LWIP_TCP */
+
+#if LWIP_UDP
+  iperf_udp_pcb = udp_new();
+  if (iperf_udp_pcb != NULL)
+  {
+    if (udp_bind(iperf_udp_pcb, IP_ADDR_ANY, IPERF_SERVER_PORT) == ERR_OK)
+    {
+      udp_recv(iperf_udp_pcb, iperfserver_udp_recv, NULL);
+    }
+    else
+    {
+      udp_remove(iperf_udp_pcb);
+      iperf_udp_pcb = NULL;
+    }
+  }
+#endif /* LWIP_UDP */
 }
 
+const struct iperf_stats *
+iperf_server_stats(int idx)
+{
+  if (idx < 0 || idx >= IPERF_MAX_STREAMS || iperf_streams[idx].state == ES_NONE)
+  {
+    return NULL;
+  }
+  return &iperf_streams[idx].stats;
+}
 
+#if LWIP_TCP
 err_t
 iperfserver_accept(void *arg, struct tcp_pcb *newpcb, err_t err)
 {
@@ -79,25 +278,25 @@ iperfserver_accept(void *arg, struct tcp_pcb *newpcb, err_t err)
   /* commonly observed practive to call tcp_setprio(), why? */
   tcp_setprio(newpcb, TCP_PRIO_MIN);
 
-  es = (struct iperfserver_state *)mem_malloc(sizeof(struct iperfserver_state));
+  es = iperfserver_alloc(IPERF_TCP_RX);
   if (es != NULL)
   {
     es->state = ES_ACCEPTED;
     es->pcb = newpcb;
-    es->retries = 0;
-    es->p = NULL;
+    ip_addr_copy(es->remote_ip, newpcb->remote_ip);
+    es->remote_port = newpcb->remote_port;
     /* pass newly allocated es to our callbacks */
     tcp_arg(newpcb, es);
     tcp_recv(newpcb, iperfserver_recv);
     tcp_err(newpcb, iperfserver_error);
-  
+
     ret_err = ERR_OK;
   }
   else
   {
     ret_err = ERR_MEM;
   }
-  return ret_err;  
+  return ret_err;
 }
 
 err_t
@@ -105,7 +304,6 @@ iperfserver_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err)
 {
   struct iperfserver_state *es;
   err_t ret_err;
-  u16_t plen;
 
   LWIP_ASSERT("arg != NULL",arg != NULL);
   es = (struct iperfserver_state *)arg;
@@ -113,41 +311,57 @@ iperfserver_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err)
   {
     /* remote host closed connection */
     es->state = ES_CLOSING;
-    iperfserver_close(tpcb, es);    
-    ret_err = ERR_OK;   
+    iperfserver_report(es);
+#if IPERF_TX_ENABLE
+    /* iperf2 -r: the reverse test follows the forward one */
+    if ((es->hdr_len == sizeof(es->hdr)) &&
+        (ntohl(es->hdr.flags) & IPERF_HEADER_VERSION1) &&
+        !(ntohl(es->hdr.flags) & IPERF_RUN_NOW))
+    {
+      iperfserver_tx_start(es);
+    }
+#endif
+    iperfserver_close(tpcb, es);
+    ret_err = ERR_OK;
   }
   else if(err != ERR_OK)
   {
     /* cleanup, for unkown reason */
     if (p != NULL)
     {
-      es->p = NULL;
       pbuf_free(p);
     }
     ret_err = err;
   }
-  else if(es->state == ES_ACCEPTED)
-  {
-    es->p = p;
-    plen = es->p->len;
-    pbuf_free(es->p);   //receive the package and discard it silently for testing reception bandwidth
-    tcp_recved(tpcb, plen); 
-   
-    ret_err = ERR_OK;
-  }
-  else if(es->state == ES_CLOSING)
+  else if(es->state == ES_ACCEPTED || es->state == ES_RECEIVED)
   {
-    /* odd case, remote side closing twice, trash data */
+    /* the client header leads the stream */
+    if (es->hdr_len < sizeof(es->hdr))
+    {
+      es->hdr_len += pbuf_copy_partial(p, (u8_t *) &es->hdr + es->hdr_len,
+                                       sizeof(es->hdr) - es->hdr_len, 0);
+#if IPERF_TX_ENABLE
+      /* iperf2 -d: the reverse test runs alongside */
+      if ((es->hdr_len == sizeof(es->hdr)) &&
+          (ntohl(es->hdr.flags) & IPERF_HEADER_VERSION1) &&
+          (ntohl(es->hdr.flags) & IPERF_RUN_NOW))
+      {
+        iperfserver_tx_start(es);
+      }
+#endif
+    }
+    es->state = ES_RECEIVED;
+
+    /* account for and discard the whole chain to measure reception bandwidth */
+    iperfserver_count(&es->stats, p->tot_len);
     tcp_recved(tpcb, p->tot_len);
-    es->p = NULL;
     pbuf_free(p);
     ret_err = ERR_OK;
   }
   else
   {
-    /* unkown es->state, trash data  */
+    /* odd case, remote side closing twice or unknown es->state, trash data */
     tcp_recved(tpcb, p->tot_len);
-    es->p = NULL;
     pbuf_free(p);
     ret_err = ERR_OK;
   }
@@ -164,103 +378,306 @@ iperfserver_error(void *arg, err_t err)
   es = (struct iperfserver_state *)arg;
   if (es != NULL)
   {
-    mem_free(es);
+    iperfserver_report(es);
+    es->state = ES_NONE;
   }
 }
 
-err_t
-iperfserver_sent(void *arg, struct tcp_pcb *tpcb, u16_t len)
+void
+iperfserver_close(struct tcp_pcb *tpcb, struct iperfserver_state *es)
+{
+  tcp_arg(tpcb, NULL);
+  tcp_sent(tpcb, NULL);
+  tcp_recv(tpcb, NULL);
+  tcp_err(tpcb, NULL);
+
+
+  if (es != NULL)
+  {
+    es->state = ES_NONE;
+  }
+  tcp_close(tpcb);
+}
+
+#if IPERF_TX_ENABLE
+/* connect back to the client for the reverse test it asked for */
+void
+iperfserver_tx_start(struct iperfserver_state *rx)
 {
   struct iperfserver_state *es;
+  struct tcp_pcb *pcb;
+  s32_t amount = (s32_t) ntohl(rx->hdr.amount);
 
-  LWIP_UNUSED_ARG(len);
+  es = iperfserver_alloc(IPERF_TCP_TX);
+  if (es == NULL)
+  {
+    return;
+  }
+  pcb = tcp_new();
+  if (pcb == NULL)
+  {
+    return;
+  }
 
-  es = (struct iperfserver_state *)arg;
-  es->retries = 0;
-  
-  if(es->p != NULL)
+  /* a negative amount is the test time in units of 10 ms */
+  if (amount < 0)
   {
-    /* still got pbufs to send */
-    tcp_sent(tpcb, iperfserver_sent);
-    iperfserver_send(tpcb, es);
+    es->tx_timed = 1;
+    es->tx_end = (u32_t) -amount * 10;
   }
   else
   {
-    /* no more pbufs to send */
-    if(es->state == ES_CLOSING)
+    es->tx_left = (u32_t) amount;
+  }
+  es->state = ES_ACCEPTED;
+  es->pcb = pcb;
+  ip_addr_copy(es->remote_ip, rx->remote_ip);
+  es->remote_port = (u16_t) ntohl(rx->hdr.port);
+
+  tcp_arg(pcb, es);
+  tcp_err(pcb, iperfserver_error);
+  if (tcp_connect(pcb, &es->remote_ip, es->remote_port, iperfserver_tx_connected) != ERR_OK)
+  {
+    es->state = ES_NONE;
+    tcp_abort(pcb);
+  }
+}
+
+err_t
+iperfserver_tx_connected(void *arg, struct tcp_pcb *tpcb, err_t err)
+{
+  struct iperfserver_state *es = (struct iperfserver_state *)arg;
+
+  LWIP_UNUSED_ARG(err);
+
+  es->state = ES_RECEIVED;
+  es->stats.start_ms = sys_now();
+  es->stats.last_ms = es->stats.start_ms;
+  if (es->tx_timed)
+  {
+    es->tx_end += es->stats.start_ms;
+  }
+  tcp_sent(tpcb, iperfserver_tx_sent);
+  iperfserver_tx_fill(tpcb, es);
+  return ERR_OK;
+}
+
+err_t
+iperfserver_tx_sent(void *arg, struct tcp_pcb *tpcb, u16_t len)
+{
+  struct iperfserver_state *es = (struct iperfserver_state *)arg;
+
+  iperfserver_count(&es->stats, len);
+  iperfserver_tx_fill(tpcb, es);
+  return ERR_OK;
+}
+
+/* queue payload by reference while there is room and data left to send */
+void
+iperfserver_tx_fill(struct tcp_pcb *tpcb, struct iperfserver_state *es)
+{
+  u16_t len;
+  int done;
+
+  if (es->state != ES_RECEIVED)
+  {
+    return;
+  }
+
+  done = es->tx_timed ? ((s32_t) (sys_now() - es->tx_end) >= 0) : (es->tx_left == 0);
+  while (!done && tcp_sndbuf(tpcb) > 0)
+  {
+    len = LWIP_MIN(tcp_sndbuf(tpcb), sizeof(iperf_tx_buf));
+    if (!es->tx_timed && len > es->tx_left)
+    {
+      len = (u16_t) es->tx_left;
+    }
+    if (tcp_write(tpcb, iperf_tx_buf, len, 0) != ERR_OK)
     {
-      iperfserver_close(tpcb, es);
+      break;
+    }
+    if (!es->tx_timed)
+    {
+      es->tx_left -= len;
+      done = (es->tx_left == 0);
     }
   }
-  return ERR_OK;
+  tcp_output(tpcb);
+
+  /* all queued and acknowledged */
+  if (done && tpcb->unacked == NULL && tpcb->unsent == NULL)
+  {
+    iperfserver_report(es);
+    iperfserver_close(tpcb, es);
+  }
+}
+#endif /* IPERF_TX_ENABLE */
+#endif /* LWIP_TCP */
+
+#if LWIP_UDP
+/* find the UDP stream of a peer, or start a new one */
+static struct iperfserver_state *
+iperfserver_udp_stream(ip_addr_t *addr, u16_t port)
+{
+  struct iperfserver_state *es;
+  int i;
+
+  for (i = 0; i < IPERF_MAX_STREAMS; i++)
+  {
+    es = &iperf_streams[i];
+    if (es->state != ES_NONE && es->kind == IPERF_UDP_RX &&
+        es->remote_port == port && ip_addr_cmp(&es->remote_ip, addr))
+    {
+      return es;
+    }
+  }
+
+  es = iperfserver_alloc(IPERF_UDP_RX);
+  if (es != NULL)
+  {
+    es->state = ES_ACCEPTED;
+    ip_addr_copy(es->remote_ip, *addr);
+    es->remote_port = port;
+    es->udp_last_id = -1;
+  }
+  return es;
+}
+
+/* answer the final datagram of a UDP test with the server report */
+static void
+iperfserver_udp_report(struct iperfserver_state *es, struct udp_pcb *pcb,
+                       const struct iperf_udp_hdr *udp)
+{
+  struct iperf_server_hdr srv;
+  struct pbuf *q;
+  u32_t ms = es->stats.last_ms - es->stats.start_ms;
+
+  q = pbuf_alloc(PBUF_TRANSPORT, sizeof(*udp) + sizeof(srv), PBUF_RAM);
+  if (q == NULL)
+  {
+    return;
+  }
+
+  srv.flags = htonl(IPERF_HEADER_VERSION1);
+  srv.total_len1 = htonl((u32_t) (es->stats.bytes >> 32));
+  srv.total_len2 = htonl((u32_t) es->stats.bytes);
+  srv.stop_sec = htonl(ms / 1000);
+  srv.stop_usec = htonl((ms % 1000) * 1000);
+  srv.error_cnt = htonl(es->stats.lost);
+  srv.outorder_cnt = htonl(es->stats.outorder);
+  srv.datagrams = htonl(es->udp_last_id);
+  srv.jitter1 = htonl(es->stats.jitter_us / 1000000);
+  srv.jitter2 = htonl(es->stats.jitter_us % 1000000);
+
+  pbuf_take(q, udp, sizeof(*udp));
+  memcpy((u8_t *) q->payload + sizeof(*udp), &srv, sizeof(srv));
+  udp_sendto(pcb, q, &es->remote_ip, es->remote_port);
+  pbuf_free(q);
 }
 
 void
-iperfserver_send(struct tcp_pcb *tpcb, struct iperfserver_state *es)
+iperfserver_udp_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p,
+                     ip_addr_t *addr, u16_t port)
 {
-  struct pbuf *ptr;
-  err_t wr_err = ERR_OK;
- 
-  while ((wr_err == ERR_OK) &&
-         (es->p != NULL) && 
-         (es->p->len <= tcp_sndbuf(tpcb)))
-  {
-  ptr = es->p;
-
-  /* enqueue data for transmission */
-  wr_err = tcp_write(tpcb, ptr->payload, ptr->len, TCP_WRITE_FLAG_COPY);
-  if (wr_err == ERR_OK)
-  {
-     u16_t plen;
-      u8_t freed;
-
-     plen = ptr->len;
-     /* continue with next pbuf in chain (if any) */
-     es->p = ptr->next;
-     if(es->p != NULL)
-     {
-       /* new reference! */
-       pbuf_ref(es->p);
-     }
-     /* chop first pbuf from chain */
-      do
-      {
-        /* try hard to free pbuf */
-        freed = pbuf_free(ptr);
-      }
-      while(freed == 0);
-     /* we can read more data now */
-     tcp_recved(tpcb, plen);
-   }
-   else if(wr_err == ERR_MEM)
-   {
-      /* we are low on memory, try later / harder, defer to poll */
-     es->p = ptr;
-   }
-   else
-   {
-     /* other problem ?? */
-   }
+  struct iperfserver_state *es;
+  struct iperf_udp_hdr udp;
+  s32_t id, transit, d;
+
+  LWIP_UNUSED_ARG(arg);
+
+  if (pbuf_copy_partial(p, &udp, sizeof(udp), 0) != sizeof(udp))
+  {
+    pbuf_free(p);
+    return;
+  }
+
+  es = iperfserver_udp_stream(addr, port);
+  if (es == NULL)
+  {
+    pbuf_free(p);
+    return;
+  }
+
+  id = (s32_t) ntohl(udp.id);
+  if (es->state == ES_CLOSING)
+  {
+    if (id >= 0)
+    {
+      /* same peer starting over */
+      sys_untimeout(iperfserver_udp_expire, es);
+      es->state = ES_NONE;
+      es = iperfserver_udp_stream(addr, port);
+    }
+    else
+    {
+      /* the client repeats the last datagram until it gets the report */
+      iperfserver_udp_report(es, pcb, &udp);
+      pbuf_free(p);
+      return;
+    }
   }
+  es->state = ES_RECEIVED;
+  iperfserver_count(&es->stats, p->tot_len);
+
+  /* RFC 1889 jitter, in microseconds at the resolution of sys_now() */
+  transit = (s32_t) (sys_now() * 1000 - (ntohl(udp.tv_sec) * 1000000 + ntohl(udp.tv_usec)));
+  if (es->stats.segments > 1)
+  {
+    d = transit - es->udp_transit;
+    if (d < 0)
+    {
+      d = -d;
+    }
+    es->stats.jitter_us = (u32_t) ((s32_t) es->stats.jitter_us +
+                                   (d - (s32_t) es->stats.jitter_us) / 16);
+  }
+  es->udp_transit = transit;
+
+  /* loss and reordering from the sequence numbers */
+  if (id < 0)
+  {
+    id = -id;
+  }
+  if (id > es->udp_last_id + 1)
+  {
+    es->stats.lost += id - es->udp_last_id - 1;
+  }
+  else if (id < es->udp_last_id + 1)
+  {
+    es->stats.outorder++;
+    if (es->stats.lost > 0)
+    {
+      es->stats.lost--;
+    }
+  }
+  if (id > es->udp_last_id)
+  {
+    es->udp_last_id = id;
+  }
+
+  if ((s32_t) ntohl(udp.id) < 0)
+  {
+    es->state = ES_CLOSING;
+    iperfserver_report(es);
+    iperfserver_udp_report(es, pcb, &udp);
+    sys_timeout(IPERF_UDP_LINGER_MS, iperfserver_udp_expire, es);
+  }
+  pbuf_free(p);
 }
 
+/* the client has had time to get the report, give the stream back */
 void
-iperfserver_close(struct tcp_pcb *tpcb, struct iperfserver_state *es)
+iperfserver_udp_expire(void *arg)
 {
-  tcp_arg(tpcb, NULL);
-  tcp_sent(tpcb, NULL);
-  tcp_recv(tpcb, NULL);
-  tcp_err(tpcb, NULL);
- 
-  
-  if (es != NULL)
+  struct iperfserver_state *es = (struct iperfserver_state *)arg;
+
+  if (es->state == ES_CLOSING && es->kind == IPERF_UDP_RX)
   {
-    mem_free(es);
-  }  
-  tcp_close(tpcb);
+    es->state = ES_NONE;
+  }
 }
+#endif /* LWIP_UDP */
 
-#endif /* LWIP_TCP */
+#endif /* LWIP_TCP || LWIP_UDP */
 /*****************************************************************************/
 /* END OF FILE */
-
@@ -0,0 +1,26 @@
+#ifndef __IPERF_SERVER_H__
+#define __IPERF_SERVER_H__
+
+#include <stdint.h>
+#include "lwip/arch.h"
+
+/* Per-stream iperf statistics, times in sys_now() milliseconds */
+struct iperf_stats
+{
+  uint64_t bytes;      /* payload bytes received (RX) or acknowledged (TX) */
+  u32_t segments;      /* receive/sent callbacks, or UDP datagrams */
+  u32_t start_ms;      /* accept / connect / first datagram time */
+  u32_t last_ms;       /* time of the latest segment */
+  u32_t gap_sum_ms;    /* sum of the gaps between segments */
+  u32_t gap_max_ms;    /* longest gap between segments */
+  u32_t jitter_us;     /* UDP: RFC 1889 jitter */
+  u32_t lost;          /* UDP: datagrams missing from the sequence */
+  u32_t outorder;      /* UDP: datagrams received out of order */
+};
+
+void iperf_server_init(void);
+
+/* Statistics of stream slot idx, NULL when the slot is unused */
+const struct iperf_stats *iperf_server_stats(int idx);
+
+#endif /* __IPERF_SERVER_H__ */
@@ -47,7 +47,9 @@
 #include "lpc_phy.h"
 #include "arch\lpc17xx_40xx_emac.h"
 #include "arch\lpc_arch.h"
+#include "lpc_17xx40xx_emac_config.h"
 #include "echo.h"
+#include "iperf_server.h"
 
 /*****************************************************************************
  * Private types/enumerations/variables
@@ -131,7 +133,11 @@ int main(void)
 	   too long, so do this stuff with a background loop. */
 	while (1) {
 		/* Handle packets as part of this loop, not in the IRQ handler */
+#if LPC_RX_POLL == 1
+		lpc_enetif_poll(&lpc_netif, LPC_RX_POLL_BUDGET);
+#else
 		lpc_enetif_input(&lpc_netif);
+#endif
 
 		/* lpc_rx_queue will re-qeueu receive buffers. This normally occurs
 		   automatically, but in systems were memory is constrained, pbufs
@@ -193,6 +199,18 @@ int main(void)
 				prt_ip = 1;
 			}
 		}
+
+#if LPC_RX_POLL == 1
+		/* Nothing to do until the next interrupt, unless frames are waiting
+		   or a timeout is due. The EMAC RX interrupt and the 1mS sysTick end
+		   the sleep, which keeps the TX reclaim and PHY polling going. With
+		   interrupts masked, one taken after the checks still ends the WFI. */
+		__disable_irq();
+		if (!lpc_enetif_poll_pending(&lpc_netif) && (sys_timeouts_sleeptime() != 0)) {
+			__WFI();
+		}
+		__enable_irq();
+#endif
 	}
 
 	/* Never returns, for warning only */
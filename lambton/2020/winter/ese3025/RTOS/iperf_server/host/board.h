@@ -0,0 +1,21 @@
+/*
+ * @brief Host (Linux) stand-in for the board layer
+ *
+ * @note
+ * Found ahead of the board library by the host tests that build sources
+ * of example/src or the EMAC driver (-I. first on the include path); of
+ * the board layer they only use the debug output, which goes to stdout, and
+ * the delay callback type of lpc_phy.h.
+ */
+
+#ifndef __BOARD_H_
+#define __BOARD_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define DEBUGOUT(...) printf(__VA_ARGS__)
+
+typedef void (*p_msDelay_func_t)(uint32_t);
+
+#endif /* __BOARD_H_ */
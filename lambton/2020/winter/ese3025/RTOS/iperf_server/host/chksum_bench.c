@@ -0,0 +1,198 @@
+/*
+ * @brief Host (Linux) benchmark of the Internet checksum in inet_chksum.c
+ *
+ * @note
+ * Times inet_chksum() and lwip_chksum_copy() over buffers of a header, a
+ * small segment and a full segment, starting 0 to 3 bytes past a 4-byte
+ * boundary, and lwip_chksum_copy() to a destination one byte further on.
+ * Built once for each LWIP_CHKSUM_ALGORITHM and LWIP_CHKSUM_COPY_ALGORITHM:
+ *
+ *	gcc -std=gnu99 -O2 -DLWIP_CHKSUM_ALGORITHM=4 -DLWIP_CHKSUM_COPY_ALGORITHM=2 \
+ *		-I. -I../lwip/inc -I../lwip/inc/ipv4 -o chksum_4 chksum_bench.c \
+ *		../lwip/src/core/[a-z]*.c ../lwip/src/core/ipv4/[a-z]*.c \
+ *		../lwip/src/netif/etharp.c
+ *
+ *	./chksum_4 [-f CPU MHz] [-b bytes per measurement]
+ *
+ * Speeds are in bytes per ns, or in bytes per cycle given the clock with -f.
+ * Before anything is timed, both functions are checked against RFC 1071
+ * for every length up to 1600 bytes at every alignment, and the copy
+ * against the source.
+ */
+
+#include "lwip/init.h"
+#include "lwip/opt.h"
+#include "lwip/def.h"
+#include "lwip/inet_chksum.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_LEN         1600
+
+static u8_t src_buf[MAX_LEN + 8] __attribute__ ((aligned (8)));
+static u8_t dst_buf[MAX_LEN + 8] __attribute__ ((aligned (8)));
+static volatile u32_t sink;	/* keeps the results alive */
+
+/* lwIP platform hooks */
+u32_t sys_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (u32_t) (ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+void assert_loop(void)
+{
+	printf("lwIP assertion failed\n");
+	abort();
+}
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+/* RFC 1071, the bytes taken in pairs as big-endian numbers; in network
+   order, as inet_chksum() returns it */
+static u16_t ref_chksum(const u8_t *p, int len)
+{
+	u32_t sum = 0;
+
+	while (len > 1) {
+		sum += (u32_t) (p[0] << 8 | p[1]);
+		p += 2;
+		len -= 2;
+	}
+	if (len > 0) {
+		sum += (u32_t) (p[0] << 8);
+	}
+	while (sum >> 16) {
+		sum = (sum & 0xffff) + (sum >> 16);
+	}
+	return htons((u16_t) ~sum);
+}
+
+/* Returns the number of wrong checksums and copies */
+static int check(void)
+{
+	int len, so, doff, wrong = 0;
+
+	for (len = 0; len <= MAX_LEN; ++len) {
+		for (so = 0; so != 4; ++so) {
+			u16_t expect = ref_chksum(src_buf + so, len);
+
+			if (inet_chksum(src_buf + so, (u16_t) len) != expect) {
+				wrong++;
+			}
+			for (doff = 0; doff != 4; ++doff) {
+				u16_t sum;
+
+				memset(dst_buf, 0xa5, sizeof(dst_buf));
+				sum = lwip_chksum_copy(dst_buf + doff, src_buf + so, (u16_t) len);
+				if ((u16_t) ~sum != expect ||
+					memcmp(dst_buf + doff, src_buf + so, len) != 0 ||
+					dst_buf[doff + len] != 0xa5 || (doff > 0 && dst_buf[doff - 1] != 0xa5)) {
+					wrong++;
+				}
+			}
+		}
+	}
+	return wrong;
+}
+
+/* Returns the speed of inet_chksum() on len bytes at src_buf + off */
+static double time_chksum(int len, int off, long bytes)
+{
+	long i, n = bytes / len + 1;
+	u32_t acc = 0;
+	uint64_t start = now_ns();
+
+	for (i = 0; i != n; ++i) {
+		acc += inet_chksum(src_buf + off, (u16_t) len);
+	}
+	sink = acc;
+	return (double) n * len / (now_ns() - start);
+}
+
+/* The same for lwip_chksum_copy(), to dst_buf + doff */
+static double time_copy(int len, int off, int doff, long bytes)
+{
+	long i, n = bytes / len + 1;
+	u32_t acc = 0;
+	uint64_t start = now_ns();
+
+	for (i = 0; i != n; ++i) {
+		acc += lwip_chksum_copy(dst_buf + doff, src_buf + off, (u16_t) len);
+	}
+	sink = acc;
+	return (double) n * len / (now_ns() - start);
+}
+
+int main(int argc, char *argv[])
+{
+	static const int sizes[] = {20, 64, 576, 1460};
+	double mhz = 0, scale = 1;
+	long bytes = 100000000;
+	unsigned int k;
+	u32_t rng = 2014;
+	int opt, i, off;
+
+	while ((opt = getopt(argc, argv, "f:b:")) != -1) {
+		switch (opt) {
+		case 'f':
+			mhz = strtod(optarg, NULL);
+			break;
+		case 'b':
+			bytes = strtol(optarg, NULL, 0);
+			break;
+		default:
+			printf("usage: %s [-f CPU MHz] [-b bytes per measurement]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (bytes < 1 || mhz < 0) {
+		printf("need some bytes, and a clock that is not negative\n");
+		return 2;
+	}
+	if (mhz > 0) {
+		scale = 1000 / mhz;	/* bytes/ns to bytes/cycle */
+	}
+
+	lwip_init();
+	for (i = 0; i != (int) sizeof(src_buf); ++i) {
+		rng = rng * 1664525u + 1013904223u;
+		src_buf[i] = (u8_t) (rng >> 24);
+	}
+	/* long runs of 0xff make the carries go all the way round */
+	memset(src_buf + 600, 0xff, 300);
+	if (check() != 0) {
+		printf("FAILED: checksums or copies differ from RFC 1071\n");
+		return 1;
+	}
+
+	printf("LWIP_CHKSUM_ALGORITHM=%d, LWIP_CHKSUM_COPY_ALGORITHM=%d, in %s\n",
+		   LWIP_CHKSUM_ALGORITHM, LWIP_CHKSUM_COPY_ALGORITHM,
+		   mhz > 0 ? "bytes/cycle" : "bytes/ns");
+	printf("%6s %6s %10s %10s %10s\n", "bytes", "offset", "chksum", "copy",
+		   "copy +1");
+	for (k = 0; k != sizeof(sizes) / sizeof(sizes[0]); ++k) {
+		for (off = 0; off != 4; ++off) {
+			int len = sizes[k];
+
+			printf("%6d %6d %10.2f %10.2f %10.2f\n", len, off,
+				   time_chksum(len, off, bytes) * scale,
+				   time_copy(len, off, off, bytes) * scale,
+				   time_copy(len, off, off + 1, bytes) * scale);
+		}
+	}
+	return 0;
+}
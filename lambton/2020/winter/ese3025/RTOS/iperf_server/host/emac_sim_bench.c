@@ -0,0 +1,342 @@
+/*
+ * @brief Host (Linux) benchmark of the EMAC driver on the simulated EMAC
+ *
+ * @note
+ * Builds lpc17xx_40xx_emac.c with LPC_EMAC_SIM, as configured for the
+ * example (example/inc/lpc_17xx40xx_emac_config.h), and runs it the way
+ * main.c does: lpc_enetif_poll(), lpc_tx_reclaim() and the timeouts, with
+ * lpc_emac_sim_poll() in place of the EMAC interrupt. The frames come from
+ * a capture written by the benchmark, an ARP request for the board and a
+ * run of UDP datagrams to it, looped until enough have been received, for
+ * each of a few frame sizes. It reports packets per second and the pbufs
+ * the driver allocated for each frame received; with -e, every datagram is
+ * echoed back, which puts the TX path in the loop too:
+ *
+ *	gcc -std=gnu99 -O2 -no-pie -Wno-pointer-to-int-cast -DLPC_EMAC_SIM -DCORE_M3 \
+ *		-DLWIP_UDP=1 -I. -I../example/inc -I../lwip/inc -I../lwip/inc/ipv4 \
+ *		-I../../lpc_chip_175x_6x/inc -I../../lpc_board_nxp_lpcxpresso_1769/inc \
+ *		-o emac_sim_bench emac_sim_bench.c ../lwip/src/arch/lpc17xx_40xx_emac.c \
+ *		../lwip/src/arch/lpc_emac_sim.c ../../lpc_chip_175x_6x/src/enet_17xx_40xx.c \
+ *		../../lpc_chip_175x_6x/src/clock_17xx_40xx.c \
+ *		../../lpc_chip_175x_6x/src/sysctl_17xx_40xx.c \
+ *		../lwip/src/core/[a-z]*.c ../lwip/src/core/ipv4/[a-z]*.c \
+ *		../lwip/src/netif/etharp.c
+ *
+ *	./emac_sim_bench [-p packets] [-e]
+ *
+ * -no-pie keeps the lwIP heap below 4 GB, where the 32-bit Packet fields
+ * of the descriptors can point at it. Every datagram received must reach
+ * the UDP callback, and with -e every one of them must be sent back or
+ * counted as dropped by the full TX queue. Last, a frame chained from more
+ * pbufs than there are TX descriptors must still go out, copied whole
+ * into one bounce slot.
+ */
+
+#include "lwip/init.h"
+#include "lwip/opt.h"
+#include "lwip/def.h"
+#include "lwip/pbuf.h"
+#include "lwip/netif.h"
+#include "lwip/ip.h"
+#include "lwip/inet_chksum.h"
+#include "lwip/udp.h"
+#include "lwip/timers.h"
+#include "netif/etharp.h"
+
+#include "lpc_17xx40xx_emac_config.h"
+#include "arch/lpc17xx_40xx_emac.h"
+#include "arch/lpc_emac_sim.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SERVER_PORT     5001
+#define CLIENT_PORT     20000
+#define DATAGRAMS       63		/* UDP frames after the ARP request in the capture */
+#define DRAIN_POLLS     64		/* main loop runs to empty the rings after a size */
+
+static struct netif netif;
+static const u8_t client_mac[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x02};
+static ip_addr_t client_ip;
+static struct udp_pcb *pcb;
+static int echo;
+static u32_t udp_rx;
+
+/* Crystal rates of the board library, for the chip clock code linked in
+   with the Ethernet driver of the chip library */
+const uint32_t OscRateIn = 12000000;
+const uint32_t RTCOscRateIn = 32768;
+
+/* lwIP platform hooks */
+u32_t sys_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (u32_t) (ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+void assert_loop(void)
+{
+	printf("lwIP assertion failed\n");
+	abort();
+}
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static void bench_recv(void *arg, struct udp_pcb *upcb, struct pbuf *p,
+						ip_addr_t *addr, u16_t port)
+{
+	LWIP_UNUSED_ARG(arg);
+	udp_rx++;
+	if (echo) {
+		udp_sendto(upcb, p, addr, port);
+	}
+	pbuf_free(p);
+}
+
+static void put_record(FILE *fp, const u8_t *frame, u32_t len)
+{
+	u32_t rec[4] = {0, 0, len, len};
+
+	fwrite(rec, sizeof(rec), 1, fp);
+	fwrite(frame, 1, len, fp);
+}
+
+/* Writes the capture for one frame size (Ethernet header to end of the
+   UDP payload, without the FCS) */
+static int write_capture(const char *name, u32_t len)
+{
+	static const u32_t filehdr[6] = {0xa1b2c3d4, 0x00040002, 0, 0, 65535, 1};
+	u8_t frame[ENET_ETH_MAX_FLEN];
+	struct eth_hdr *eth = (struct eth_hdr *) frame;
+	struct etharp_hdr *arp = (struct etharp_hdr *) (eth + 1);
+	struct ip_hdr *iphdr = (struct ip_hdr *) (eth + 1);
+	struct udp_hdr *udphdr = (struct udp_hdr *) (iphdr + 1);
+	FILE *fp;
+	int i;
+
+	fp = fopen(name, "wb");
+	if (fp == NULL) {
+		return -1;
+	}
+	fwrite(filehdr, sizeof(filehdr), 1, fp);
+
+	/* Who has the board? The reply teaches its ARP cache the client. */
+	memset(frame, 0, sizeof(frame));
+	memset(eth->dest.addr, 0xff, 6);
+	memcpy(eth->src.addr, client_mac, 6);
+	eth->type = htons(ETHTYPE_ARP);
+	arp->hwtype = htons(1);
+	arp->proto = htons(ETHTYPE_IP);
+	arp->hwlen = ETHARP_HWADDR_LEN;
+	arp->protolen = sizeof(ip_addr_t);
+	arp->opcode = htons(ARP_REQUEST);
+	memcpy(arp->shwaddr.addr, client_mac, 6);
+	memcpy(&arp->sipaddr, &client_ip, 4);
+	memcpy(&arp->dipaddr, &netif.ip_addr, 4);
+	put_record(fp, frame, 60);
+
+	memset(frame, 0, sizeof(frame));
+	memcpy(eth->dest.addr, lpc_emac_sim_hwaddr, 6);
+	memcpy(eth->src.addr, client_mac, 6);
+	eth->type = htons(ETHTYPE_IP);
+	IPH_VHL_SET(iphdr, 4, IP_HLEN / 4);
+	IPH_LEN_SET(iphdr, htons(len - SIZEOF_ETH_HDR));
+	IPH_TTL_SET(iphdr, 64);
+	IPH_PROTO_SET(iphdr, IP_PROTO_UDP);
+	ip_addr_copy(iphdr->src, client_ip);
+	ip_addr_copy(iphdr->dest, netif.ip_addr);
+	IPH_CHKSUM_SET(iphdr, inet_chksum(iphdr, IP_HLEN));
+	udphdr->src = htons(CLIENT_PORT);
+	udphdr->dest = htons(SERVER_PORT);
+	udphdr->len = htons(len - SIZEOF_ETH_HDR - IP_HLEN);
+	for (i = 0; i < DATAGRAMS; i++) {
+		put_record(fp, frame, len);
+	}
+
+	return fclose(fp);
+}
+
+/* One pass of the main loop of main.c */
+static void main_loop(void)
+{
+	lpc_emac_sim_poll();
+	lpc_enetif_poll(&netif, LPC_RX_POLL_BUDGET);
+	lpc_tx_reclaim(&netif);
+	sys_check_timeouts();
+}
+
+/* Sends a frame of len bytes chained from pieces pbufs, which must go
+   out as one frame of that length */
+static int send_chain(u32_t len, int pieces)
+{
+	struct pbuf *p = NULL, *q;
+	u32_t frames = lpc_emac_sim_stats.tx_frames, bytes = lpc_emac_sim_stats.tx_bytes;
+	u32_t n, left = len;
+	int i;
+
+	for (; pieces > 0; pieces--) {
+		n = left / pieces;
+		q = pbuf_alloc(PBUF_RAW, n, PBUF_RAM);
+		if (q == NULL) {
+			printf("out of memory\n");
+			return -1;
+		}
+		memset(q->payload, 0, n);
+		if (p == NULL) {
+			p = q;
+		}
+		else {
+			pbuf_cat(p, q);
+		}
+		left -= n;
+	}
+	if (netif.linkoutput(&netif, p) != ERR_OK) {
+		printf("FAILED: chain of %d pbufs refused\n", pbuf_clen(p));
+		pbuf_free(p);
+		return -1;
+	}
+	pbuf_free(p);
+	for (i = 0; i < DRAIN_POLLS; i++) {
+		main_loop();
+	}
+	if ((lpc_emac_sim_stats.tx_frames != frames + 1) ||
+		(lpc_emac_sim_stats.tx_bytes != bytes + len)) {
+		printf("FAILED: chain of %lu bytes sent as %lu frames of %lu bytes\n",
+			   (unsigned long) len, (unsigned long) (lpc_emac_sim_stats.tx_frames - frames),
+			   (unsigned long) (lpc_emac_sim_stats.tx_bytes - bytes));
+		return -1;
+	}
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	static const u32_t sizes[] = {60, 512, 1514};
+	char capture[] = "/tmp/emac_sim_benchXXXXXX";
+	ip_addr_t ipaddr, netmask, gw;
+	long packets = 1000000;
+	unsigned int k;
+	int opt, fd, i;
+
+	while ((opt = getopt(argc, argv, "p:e")) != -1) {
+		switch (opt) {
+		case 'p':
+			packets = strtol(optarg, NULL, 0);
+			break;
+		case 'e':
+			echo = 1;
+			break;
+		default:
+			printf("usage: %s [-p packets] [-e]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (packets < 1) {
+		printf("need some packets\n");
+		return 2;
+	}
+	fd = mkstemp(capture);
+	if (fd < 0) {
+		printf("cannot create %s\n", capture);
+		return 1;
+	}
+	close(fd);
+
+	lwip_init();
+	IP4_ADDR(&ipaddr, 10, 0, 0, 1);
+	IP4_ADDR(&netmask, 255, 0, 0, 0);
+	IP4_ADDR(&gw, 10, 0, 0, 254);
+	IP4_ADDR(&client_ip, 10, 0, 0, 2);
+	netif_add(&netif, &ipaddr, &netmask, &gw, NULL, lpc_enetif_init, ethernet_input);
+	netif_set_default(&netif);
+	netif_set_up(&netif);
+	netif_set_link_up(&netif);
+	pcb = udp_new();
+	if ((pcb == NULL) || (udp_bind(pcb, IP_ADDR_ANY, SERVER_PORT) != ERR_OK)) {
+		printf("cannot bind UDP port %d\n", SERVER_PORT);
+		return 1;
+	}
+	udp_recv(pcb, bench_recv, NULL);
+
+	/* Send the gratuitous ARP of netif_set_up() before the counting starts */
+	main_loop();
+
+	printf("%d RX descriptors, %d TX descriptors, poll budget %d%s\n", LPC_NUM_BUFF_RXDESCS,
+		   LPC_NUM_BUFF_TXDESCS, LPC_RX_POLL_BUDGET, echo ? ", echoing" : "");
+	printf("%6s %10s %10s %10s %10s\n", "frame", "packets/s", "ns/packet", "allocs/pkt",
+		   "tx frames");
+	for (k = 0; k != sizeof(sizes) / sizeof(sizes[0]); ++k) {
+		u32_t arps, qdrops = lpc_enetif_stats(&netif)->tx_qdrops;
+		uint64_t t0, t1;
+
+		if ((write_capture(capture, sizes[k]) != 0) || (lpc_emac_sim_open_pcap(capture, 1) != 0)) {
+			printf("cannot write %s\n", capture);
+			unlink(capture);
+			return 1;
+		}
+		udp_rx = 0;
+
+		t0 = now_ns();
+		while ((lpc_emac_sim_stats.rx_frames < (u32_t) packets) &&
+			   (lpc_emac_sim_stats.rx_toolong == 0)) {
+			main_loop();
+		}
+		t1 = now_ns();
+
+		/* Let what is still on the rings through */
+		lpc_emac_sim_close();
+		for (i = 0; i < DRAIN_POLLS; i++) {
+			main_loop();
+		}
+
+		printf("%6u %10.0f %10.1f %10.3f %10lu\n", (unsigned) sizes[k],
+			   lpc_emac_sim_stats.rx_frames * 1e9 / (t1 - t0),
+			   (double) (t1 - t0) / lpc_emac_sim_stats.rx_frames,
+			   (double) lpc_emac_sim_stats.rx_allocs / lpc_emac_sim_stats.rx_frames,
+			   (unsigned long) lpc_emac_sim_stats.tx_frames);
+
+		if (lpc_emac_sim_stats.rx_toolong != 0) {
+			printf("FAILED: frames too long for their RX descriptor\n");
+			unlink(capture);
+			return 1;
+		}
+
+		/* The capture starts over with its ARP request every DATAGRAMS + 1
+		   frames; each request is answered */
+		arps = (lpc_emac_sim_stats.rx_frames + DATAGRAMS) / (DATAGRAMS + 1);
+		if (udp_rx != lpc_emac_sim_stats.rx_frames - arps) {
+			printf("FAILED: %lu of %lu datagrams received\n", (unsigned long) udp_rx,
+				   (unsigned long) (lpc_emac_sim_stats.rx_frames - arps));
+			unlink(capture);
+			return 1;
+		}
+		qdrops = lpc_enetif_stats(&netif)->tx_qdrops - qdrops;
+		if (lpc_emac_sim_stats.tx_frames + qdrops != arps + (echo ? udp_rx : 0)) {
+			printf("FAILED: %lu frames sent and %lu dropped for %lu ARP requests and %lu echoes\n",
+				   (unsigned long) lpc_emac_sim_stats.tx_frames, (unsigned long) qdrops,
+				   (unsigned long) arps, (unsigned long) (echo ? udp_rx : 0));
+			unlink(capture);
+			return 1;
+		}
+	}
+	unlink(capture);
+
+	/* Longer than the TX ring, so it cannot take a descriptor a pbuf */
+	if (send_chain(1514, 2 * LPC_NUM_BUFF_TXDESCS) != 0) {
+		return 1;
+	}
+	printf("chain of %d pbufs sent from a bounce slot\n", 2 * LPC_NUM_BUFF_TXDESCS);
+	return 0;
+}
@@ -0,0 +1,268 @@
+/*
+ * @brief Host (Linux) benchmark of the ARP cache in etharp
+ *
+ * @note
+ * Teaches the ARP cache n LAN hosts with ARP replies, then times
+ * etharp_output() to one host over and over, and to all of them in a
+ * random order, and times etharp_tmr() on the full cache:
+ *
+ *	gcc -std=gnu99 -O2 -I. -I../lwip/inc -I../lwip/inc/ipv4 -o etharp_bench \
+ *		etharp_bench.c ../lwip/src/core/[a-z]*.c ../lwip/src/core/ipv4/[a-z]*.c \
+ *		../lwip/src/netif/etharp.c
+ *
+ *	./etharp_bench [-p packets]
+ *
+ * Every frame sent must carry the Ethernet address of the host it was sent
+ * to, and no ARP request may go out while the hosts are all in the cache.
+ */
+
+#include "lwip/init.h"
+#include "lwip/opt.h"
+#include "lwip/def.h"
+#include "lwip/pbuf.h"
+#include "lwip/netif.h"
+#include "lwip/ip.h"
+#include "netif/etharp.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_HOSTS       ARP_TABLE_SIZE
+#define TMR_CALLS       100	/* well short of the 20 minutes an entry lives */
+
+static struct netif netif;
+static const struct eth_addr our_mac = {{0x02, 0x00, 0x00, 0x00, 0x00, 0x01}};
+static struct eth_addr expect_mac;	/* where the next IP frame must go */
+static u32_t ip_frames, arp_frames, wrong_frames;
+
+/* lwIP platform hooks */
+u32_t sys_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (u32_t) (ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+void assert_loop(void)
+{
+	printf("lwIP assertion failed\n");
+	abort();
+}
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+/* Host i of the LAN, 10.0.0.2 onwards, and its Ethernet address */
+static void host_ip(int i, ip_addr_t *ip)
+{
+	IP4_ADDR(ip, 10, 0, (u8_t) ((i + 2) >> 8), (u8_t) (i + 2));
+}
+
+static void host_mac(int i, struct eth_addr *mac)
+{
+	static const struct eth_addr base = {{0x02, 0x00, 0x5e, 0x00, 0x00, 0x00}};
+
+	*mac = base;
+	mac->addr[4] = (u8_t) (i >> 8);
+	mac->addr[5] = (u8_t) i;
+}
+
+/* Every frame etharp sends ends up here */
+static err_t sink_linkoutput(struct netif *n, struct pbuf *p)
+{
+	struct eth_hdr *ethhdr = (struct eth_hdr *) p->payload;
+
+	LWIP_UNUSED_ARG(n);
+	if (ethhdr->type == PP_HTONS(ETHTYPE_ARP)) {
+		arp_frames++;
+	} else {
+		ip_frames++;
+		if (memcmp(&ethhdr->dest, &expect_mac, ETHARP_HWADDR_LEN) != 0) {
+			wrong_frames++;
+		}
+	}
+	return ERR_OK;
+}
+
+static err_t sink_init(struct netif *n)
+{
+	n->output = etharp_output;
+	n->linkoutput = sink_linkoutput;
+	n->mtu = 1500;
+	n->hwaddr_len = ETHARP_HWADDR_LEN;
+	memcpy(n->hwaddr, &our_mac, ETHARP_HWADDR_LEN);
+	n->flags = NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP | NETIF_FLAG_LINK_UP;
+	return ERR_OK;
+}
+
+/* Hands ethernet_input() an ARP reply from host i */
+static void arp_reply(int i)
+{
+	struct pbuf *p = pbuf_alloc(PBUF_RAW, SIZEOF_ETHARP_PACKET, PBUF_RAM);
+	struct eth_hdr *ethhdr;
+	struct etharp_hdr *hdr;
+	struct eth_addr mac;
+	ip_addr_t ip;
+
+	if (p == NULL) {
+		printf("out of memory\n");
+		exit(1);
+	}
+	host_mac(i, &mac);
+	host_ip(i, &ip);
+	ethhdr = (struct eth_hdr *) p->payload;
+	ethhdr->dest = our_mac;
+	ethhdr->src = mac;
+	ethhdr->type = PP_HTONS(ETHTYPE_ARP);
+	hdr = (struct etharp_hdr *) ((u8_t *) p->payload + SIZEOF_ETH_HDR);
+	hdr->hwtype = PP_HTONS(1);
+	hdr->proto = PP_HTONS(ETHTYPE_IP);
+	hdr->hwlen = ETHARP_HWADDR_LEN;
+	hdr->protolen = sizeof(ip_addr_t);
+	hdr->opcode = PP_HTONS(ARP_REPLY);
+	hdr->shwaddr = mac;
+	IPADDR2_COPY(&hdr->sipaddr, &ip);
+	hdr->dhwaddr = our_mac;
+	IPADDR2_COPY(&hdr->dipaddr, &netif.ip_addr);
+	ethernet_input(p, &netif);
+}
+
+/* Sends q to host i, and takes the Ethernet header off again */
+static void send_to(struct pbuf *q, int i)
+{
+	ip_addr_t ip;
+
+	host_ip(i, &ip);
+	host_mac(i, &expect_mac);
+	etharp_output(&netif, q, &ip);
+	pbuf_header(q, -(s16_t) SIZEOF_ETH_HDR);
+}
+
+int main(int argc, char *argv[])
+{
+	static const int sizes[] = {8, 32, 127, 512, 1024};
+	static int order[MAX_HOSTS];
+	ip_addr_t ipaddr, netmask, gw;
+	struct pbuf *q;
+	long packets = 1000000, rounds, r;
+	unsigned int k;
+	u32_t rng = 2014;
+	int opt, i;
+
+	while ((opt = getopt(argc, argv, "p:")) != -1) {
+		switch (opt) {
+		case 'p':
+			packets = strtol(optarg, NULL, 0);
+			break;
+		default:
+			printf("usage: %s [-p packets]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (packets < 1) {
+		printf("need some packets\n");
+		return 2;
+	}
+
+	lwip_init();
+	IP4_ADDR(&ipaddr, 10, 0, 0, 1);
+	IP4_ADDR(&netmask, 255, 255, 0, 0);
+	IP4_ADDR(&gw, 10, 0, 0, 254);
+	netif_add(&netif, &ipaddr, &netmask, &gw, NULL, sink_init, ethernet_input);
+	netif_set_default(&netif);
+	netif_set_up(&netif);
+	q = pbuf_alloc(PBUF_IP, IP_HLEN, PBUF_RAM);
+	if (q == NULL) {
+		printf("out of memory\n");
+		return 1;
+	}
+	memset(q->payload, 0, IP_HLEN);
+
+	printf("ARP_TABLE_SIZE=%d\n", ARP_TABLE_SIZE);
+	printf("%6s %10s %10s %10s %10s %10s\n", "hosts", "learn", "refresh",
+		   "same host", "any host", "etharp_tmr");
+	printf("%6s %10s %10s %10s %10s %10s\n", "", "ns/reply", "ns/reply",
+		   "ns/packet", "ns/packet", "us/call");
+	for (k = 0; k != sizeof(sizes) / sizeof(sizes[0]); ++k) {
+		int n = sizes[k];
+		uint64_t t0, t1, t2, t3, t4, t5;
+
+		if (n > MAX_HOSTS) {
+			break;
+		}
+		etharp_cleanup_netif(&netif);
+		ip_frames = arp_frames = wrong_frames = 0;
+
+		t0 = now_ns();
+		for (i = 0; i != n; ++i) {
+			arp_reply(i);
+		}
+		t1 = now_ns();
+		for (i = 0; i != n; ++i) {
+			arp_reply(i);
+		}
+		t2 = now_ns();
+
+		rounds = (packets + n - 1) / n;
+		for (r = 0; r != rounds * n; ++r) {
+			send_to(q, n / 2);
+		}
+		t3 = now_ns();
+
+		for (i = 0; i != n; ++i) {
+			order[i] = i;
+		}
+		for (i = n - 1; i > 0; --i) {
+			int j, t;
+
+			rng = rng * 1664525u + 1013904223u;
+			j = (int) ((rng >> 8) % (u32_t) (i + 1));
+			t = order[i];
+			order[i] = order[j];
+			order[j] = t;
+		}
+		t4 = now_ns();
+		for (r = 0; r != rounds; ++r) {
+			for (i = 0; i != n; ++i) {
+				send_to(q, order[i]);
+			}
+		}
+		t5 = now_ns();
+
+		printf("%6d %10.1f %10.1f %10.1f %10.1f", n, (double) (t1 - t0) / n,
+			   (double) (t2 - t1) / n, (double) (t3 - t2) / (rounds * n),
+			   (double) (t5 - t4) / (rounds * n));
+		t0 = now_ns();
+		for (i = 0; i != TMR_CALLS; ++i) {
+			etharp_tmr();
+		}
+		printf(" %10.2f\n", (now_ns() - t0) / 1e3 / TMR_CALLS);
+
+		if (wrong_frames != 0 || arp_frames != 0 || ip_frames != 2 * rounds * n) {
+			printf("FAILED: %lu frames, %lu to the wrong host, %lu ARP requests\n",
+				   (unsigned long) ip_frames, (unsigned long) wrong_frames,
+				   (unsigned long) arp_frames);
+			return 1;
+		}
+		/* the entries are still there after aging */
+		for (i = 0; i != n; ++i) {
+			send_to(q, i);
+		}
+		if (wrong_frames != 0 || arp_frames != 0) {
+			printf("FAILED: entries lost by etharp_tmr()\n");
+			return 1;
+		}
+	}
+	pbuf_free(q);
+	return 0;
+}
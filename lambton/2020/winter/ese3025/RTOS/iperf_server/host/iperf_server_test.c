@@ -0,0 +1,417 @@
+/*
+ * @brief Host (Linux) test of the UDP and TCP streams of example/src/iperf_server.c
+ *
+ * @note
+ * Builds iperf_server.c with the lwIP core on the host, in place of a run
+ * on the unix port over a tap device. The test plays the iperf2 client: it
+ * hands ip_input() the datagrams and segments the client would send, looks
+ * at what the stack sends back, and keeps a clock of its own to run the
+ * timeouts. It runs three times as many UDP tests, one after the other and
+ * each from a port of its own, as the server has streams, each ending with
+ * the final datagram sent twice as the client repeats it until it has the
+ * report. Every test must get its reports, must give its stream back once
+ * IPERF_UDP_LINGER_MS is over, and a TCP test must still be accepted at
+ * the end.
+ *
+ * The TCP test then sends its data in segments of one pbuf, in chains of
+ * several pbufs, and out of order, so that lwIP hands the server a chain
+ * made of two segments. The server must count every byte of each chain
+ * and give the whole window back. Last it streams -m megabytes in chains
+ * of two pbufs, and reports the rate at which ip_input() and the server
+ * take them on the host, before the client closes the test:
+ *
+ *	gcc -std=gnu99 -O2 -DLWIP_UDP=1 -I. -I../lwip/inc -I../lwip/inc/ipv4 \
+ *		-o iperf_server_test iperf_server_test.c ../example/src/iperf_server.c \
+ *		../lwip/src/core/[a-z]*.c ../lwip/src/core/ipv4/[a-z]*.c \
+ *		../lwip/src/netif/etharp.c
+ *	./iperf_server_test [-m megabytes]
+ */
+
+#include "lwip/init.h"
+#include "lwip/opt.h"
+#include "lwip/def.h"
+#include "lwip/pbuf.h"
+#include "lwip/netif.h"
+#include "lwip/ip.h"
+#include "lwip/udp.h"
+#include "lwip/tcp_impl.h"
+#include "lwip/timers.h"
+
+#include "../example/src/iperf_server.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SERVER_PORT     5001
+#define CLIENT_PORT     20000	/* test i comes from port CLIENT_PORT + i */
+#define STREAMS         4		/* IPERF_MAX_STREAMS of iperf_server.c */
+#define LINGER_MS       2000	/* IPERF_UDP_LINGER_MS of iperf_server.c */
+#define TESTS           (3 * STREAMS)
+#define DATAGRAMS       10
+#define DATAGRAM_LEN    100
+#define SEGMENT_LEN     1460	/* TCP_MSS */
+
+static struct netif netif;
+static ip_addr_t client_ip;
+static u32_t now_ms;
+
+/* What the stack sent back */
+static int udp_reports;
+static s32_t report_datagrams, report_errors;
+static int tcp_synacks, tcp_rsts;
+static u32_t synack_seq;
+
+/* lwIP platform hooks */
+u32_t sys_now(void)
+{
+	return now_ms;
+}
+
+void assert_loop(void)
+{
+	printf("lwIP assertion failed\n");
+	abort();
+}
+
+static u32_t get32(const u8_t *p)
+{
+	return (u32_t) p[0] << 24 | (u32_t) p[1] << 16 | (u32_t) p[2] << 8 | p[3];
+}
+
+/* Every packet the stack sends ends up here */
+static err_t client_output(struct netif *n, struct pbuf *p, ip_addr_t *dst)
+{
+	static u8_t buf[1600];
+	const struct ip_hdr *iphdr = (const struct ip_hdr *) buf;
+	const u8_t *l4;
+	u16_t len = pbuf_copy_partial(p, buf, sizeof(buf), 0);
+
+	LWIP_UNUSED_ARG(n);
+	LWIP_UNUSED_ARG(dst);
+	if (len < IP_HLEN + 8) {
+		return ERR_OK;
+	}
+	l4 = buf + IPH_HL(iphdr) * 4;
+	if (IPH_PROTO(iphdr) == IP_PROTO_UDP && len >= (l4 - buf) + 8 + 12 + 40) {
+		/* the server report follows the 12 bytes of the datagram header */
+		const u8_t *srv = l4 + 8 + 12;
+
+		udp_reports++;
+		report_errors = (s32_t) get32(srv + 20);
+		report_datagrams = (s32_t) get32(srv + 28);
+	}
+	else if (IPH_PROTO(iphdr) == IP_PROTO_TCP) {
+		u8_t flags = l4[13];
+
+		if ((flags & (TCP_SYN | TCP_ACK)) == (TCP_SYN | TCP_ACK)) {
+			tcp_synacks++;
+			synack_seq = get32(l4 + 4);
+		}
+		if (flags & TCP_RST) {
+			tcp_rsts++;
+		}
+	}
+	return ERR_OK;
+}
+
+static err_t client_init(struct netif *n)
+{
+	n->output = client_output;
+	n->mtu = 1500;
+	n->flags = NETIF_FLAG_LINK_UP;
+	return ERR_OK;
+}
+
+/* An IPv4 packet from the client to the server, with room for len bytes
+   past the IP header in a chain of pieces pbufs, the first of which
+   holds the IP header and head bytes past it */
+static struct pbuf *client_chain(u8_t proto, u16_t len, u16_t head, int pieces)
+{
+	struct pbuf *p = pbuf_alloc(PBUF_RAW, IP_HLEN + head, PBUF_RAM);
+	struct pbuf *q;
+	struct ip_hdr *iphdr;
+	u16_t left = len - head, n;
+
+	if (p == NULL) {
+		printf("out of memory\n");
+		exit(1);
+	}
+	memset(p->payload, 0, IP_HLEN + head);
+	for (; pieces > 1; pieces--) {
+		n = left / (pieces - 1);
+		q = pbuf_alloc(PBUF_RAW, n, PBUF_RAM);
+		if (q == NULL) {
+			printf("out of memory\n");
+			exit(1);
+		}
+		memset(q->payload, 0, n);
+		pbuf_cat(p, q);
+		left -= n;
+	}
+	iphdr = (struct ip_hdr *) p->payload;
+	IPH_VHL_SET(iphdr, 4, IP_HLEN / 4);
+	IPH_LEN_SET(iphdr, htons(IP_HLEN + len));
+	IPH_TTL_SET(iphdr, 64);
+	IPH_PROTO_SET(iphdr, proto);
+	ip_addr_copy(iphdr->src, client_ip);
+	ip_addr_copy(iphdr->dest, netif.ip_addr);
+	return p;
+}
+
+/* The same in a single pbuf */
+static struct pbuf *client_packet(u8_t proto, u16_t len)
+{
+	return client_chain(proto, len, len, 1);
+}
+
+/* One iperf2 datagram; the client sends the last one with the id negated */
+static void send_datagram(u16_t port, s32_t id)
+{
+	struct pbuf *p = client_packet(IP_PROTO_UDP, UDP_HLEN + DATAGRAM_LEN);
+	struct udp_hdr *udphdr = (struct udp_hdr *) ((u8_t *) p->payload + IP_HLEN);
+	u32_t *iperf = (u32_t *) (udphdr + 1);
+
+	udphdr->src = htons(port);
+	udphdr->dest = htons(SERVER_PORT);
+	udphdr->len = htons(UDP_HLEN + DATAGRAM_LEN);
+	iperf[0] = htonl((u32_t) id);
+	iperf[1] = htonl(now_ms / 1000);
+	iperf[2] = htonl((now_ms % 1000) * 1000);
+	ip_input(p, &netif);
+}
+
+/* A TCP segment carrying len bytes of zeroes, which the server takes for
+   an iperf2 client header without flags, in a chain of pieces pbufs */
+static void send_data(u16_t port, u32_t seq, u32_t ack, u8_t flags, u16_t len, int pieces)
+{
+	struct pbuf *p = client_chain(IP_PROTO_TCP, TCP_HLEN + len,
+								  TCP_HLEN + len / pieces, pieces);
+	struct tcp_hdr *tcphdr = (struct tcp_hdr *) ((u8_t *) p->payload + IP_HLEN);
+
+	tcphdr->src = htons(port);
+	tcphdr->dest = htons(SERVER_PORT);
+	tcphdr->seqno = htonl(seq);
+	tcphdr->ackno = htonl(ack);
+	TCPH_HDRLEN_FLAGS_SET(tcphdr, TCP_HLEN / 4, flags);
+	tcphdr->wnd = htons(TCP_WND);
+	ip_input(p, &netif);
+}
+
+static void send_segment(u16_t port, u32_t seq, u32_t ack, u8_t flags)
+{
+	send_data(port, seq, ack, flags, 0, 1);
+}
+
+/* Lets time go by, running the timeouts as the main loop does */
+static void advance(u32_t ms)
+{
+	u32_t end = now_ms + ms;
+
+	while (now_ms != end) {
+		now_ms += 10;
+		sys_check_timeouts();
+	}
+}
+
+static double now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* Statistics of the one stream in use */
+static const struct iperf_stats *stream_stats(void)
+{
+	const struct iperf_stats *st;
+	int i;
+
+	for (i = 0; i < STREAMS; i++) {
+		if ((st = iperf_server_stats(i)) != NULL) {
+			return st;
+		}
+	}
+	return NULL;
+}
+
+static int streams_in_use(void)
+{
+	int i, n = 0;
+
+	for (i = 0; i < STREAMS; i++) {
+		n += iperf_server_stats(i) != NULL;
+	}
+	return n;
+}
+
+/* One UDP test from port; returns 0 if it got both reports, and they
+   are right */
+static int udp_test(u16_t port)
+{
+	s32_t id;
+
+	udp_reports = 0;
+	for (id = 0; id < DATAGRAMS; id++) {
+		send_datagram(port, id);
+		advance(10);
+	}
+	send_datagram(port, -DATAGRAMS);
+	advance(100);
+	send_datagram(port, -DATAGRAMS);
+	if (udp_reports != 2) {
+		printf("FAILED: %d reports for the UDP test from port %u\n", udp_reports, port);
+		return -1;
+	}
+	if (report_datagrams != DATAGRAMS || report_errors != 0) {
+		printf("FAILED: report of %ld datagrams, %ld lost\n", (long) report_datagrams,
+			   (long) report_errors);
+		return -1;
+	}
+	return 0;
+}
+
+/* The TCP test: its data in chains, out of order, then -m megabytes of
+   it timed, and the close. The handshake is done, seq is the client's
+   next sequence number and ack the server's. */
+static int tcp_test(u16_t port, u32_t seq, u32_t ack, long megabytes)
+{
+	const struct iperf_stats *st = stream_stats();
+	uint64_t bytes, segs, i;
+	double t0, t1;
+
+	/* One pbuf, then a segment in a chain of three */
+	send_data(port, seq, ack, TCP_ACK, 500, 1);
+	seq += 500;
+	send_data(port, seq, ack, TCP_ACK, SEGMENT_LEN, 3);
+	seq += SEGMENT_LEN;
+	if (st == NULL || st->bytes != 500 + SEGMENT_LEN || st->segments != 2) {
+		printf("FAILED: %lu bytes in %lu segments counted, of %d in 2\n",
+			   st ? (unsigned long) st->bytes : 0, st ? (unsigned long) st->segments : 0,
+			   500 + SEGMENT_LEN);
+		return -1;
+	}
+
+	/* The second half first: held back, then handed over chained to the
+	   first half in one call */
+	send_data(port, seq + 1000, ack, TCP_ACK, 1000, 2);
+	send_data(port, seq, ack, TCP_ACK, 1000, 1);
+	seq += 2000;
+	if (st->bytes != 2500 + SEGMENT_LEN || st->segments != 3) {
+		printf("FAILED: out of order data counted as %lu bytes in %lu calls\n",
+			   (unsigned long) st->bytes, (unsigned long) st->segments);
+		return -1;
+	}
+	if (tcp_active_pcbs == NULL || tcp_active_pcbs->rcv_wnd != TCP_WND) {
+		printf("FAILED: receive window of %u after the chains, not %u\n",
+			   tcp_active_pcbs ? tcp_active_pcbs->rcv_wnd : 0, TCP_WND);
+		return -1;
+	}
+	printf("TCP chains counted in full: %lu bytes in %lu calls\n",
+		   (unsigned long) st->bytes, (unsigned long) st->segments);
+
+	/* Throughput of the receive path */
+	bytes = st->bytes;
+	segs = (uint64_t) megabytes * 1000000 / SEGMENT_LEN;
+	t0 = now_ns();
+	for (i = 0; i < segs; i++) {
+		send_data(port, seq, ack, TCP_ACK, SEGMENT_LEN, 2);
+		seq += SEGMENT_LEN;
+	}
+	t1 = now_ns();
+	if (st->bytes != bytes + segs * SEGMENT_LEN || tcp_active_pcbs->rcv_wnd != TCP_WND) {
+		printf("FAILED: %llu of %llu streamed bytes counted\n",
+			   (unsigned long long) (st->bytes - bytes),
+			   (unsigned long long) (segs * SEGMENT_LEN));
+		return -1;
+	}
+	printf("TCP receive: %llu segments of %d bytes, %.0f ns each, %.0f Mb/s\n",
+		   (unsigned long long) segs, SEGMENT_LEN, (t1 - t0) / segs,
+		   segs * SEGMENT_LEN * 8 * 1e3 / (t1 - t0));
+
+	/* The client closes: the server reports and gives the stream back */
+	send_segment(port, seq, ack, TCP_FIN | TCP_ACK);
+	if (streams_in_use() != 0 || tcp_rsts != 0) {
+		printf("FAILED: TCP test not closed\n");
+		return -1;
+	}
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	ip_addr_t ipaddr, netmask, gw;
+	u32_t seq = 5000;
+	long megabytes = 64;
+	int t, opt;
+
+	while ((opt = getopt(argc, argv, "m:")) != -1) {
+		switch (opt) {
+		case 'm':
+			megabytes = atol(optarg);
+			break;
+		default:
+			printf("usage: %s [-m megabytes]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	lwip_init();
+	IP4_ADDR(&ipaddr, 10, 0, 0, 1);
+	IP4_ADDR(&netmask, 255, 0, 0, 0);
+	IP4_ADDR(&gw, 10, 0, 0, 254);
+	IP4_ADDR(&client_ip, 10, 0, 0, 2);
+	netif_add(&netif, &ipaddr, &netmask, &gw, NULL, client_init, ip_input);
+	netif_set_default(&netif);
+	netif_set_up(&netif);
+	iperf_server_init();
+
+	/* More tests than streams; each stream is kept a while for the
+	   repeated last datagram, then given back */
+	for (t = 0; t < TESTS; t++) {
+		if (udp_test(CLIENT_PORT + t) != 0) {
+			return 1;
+		}
+		if (streams_in_use() != 1) {
+			printf("FAILED: %d streams in use right after UDP test %d\n", streams_in_use(), t);
+			return 1;
+		}
+		advance(LINGER_MS);
+		if (streams_in_use() != 0) {
+			printf("FAILED: UDP test %d kept its stream\n", t);
+			return 1;
+		}
+	}
+	printf("%d UDP tests on %d streams\n", TESTS, STREAMS);
+
+	/* A client starting over before its old test has let go */
+	if (udp_test(CLIENT_PORT) != 0 || udp_test(CLIENT_PORT) != 0 || streams_in_use() != 1) {
+		printf("FAILED: UDP test run again from the same port\n");
+		return 1;
+	}
+	advance(LINGER_MS);
+	printf("UDP test run again from the same port\n");
+
+	/* And a TCP test is accepted: the handshake completes without a RST */
+	send_segment(CLIENT_PORT + TESTS, seq, 0, TCP_SYN);
+	if (tcp_synacks != 1) {
+		printf("FAILED: no SYN-ACK\n");
+		return 1;
+	}
+	send_segment(CLIENT_PORT + TESTS, seq + 1, synack_seq + 1, TCP_ACK);
+	if (tcp_rsts != 0 || streams_in_use() != 1) {
+		printf("FAILED: TCP test refused after the UDP tests\n");
+		return 1;
+	}
+	printf("TCP test accepted after them\n");
+
+	if (tcp_test(CLIENT_PORT + TESTS, seq + 1, synack_seq + 1, megabytes) != 0) {
+		return 1;
+	}
+	printf("passed\n");
+	return 0;
+}
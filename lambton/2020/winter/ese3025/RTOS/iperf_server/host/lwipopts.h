@@ -0,0 +1,76 @@
+/*
+ * @brief LWIP build options for the host (Linux) benchmarks
+ *
+ * @note
+ * Put this directory first on the include path, ahead of example/inc, so
+ * that this file is used in place of the MCU's lwipopts.h. The pools are
+ * sized for a thousand connections and ten thousand timeouts, and the TCP
+ * and IP checksums are not checked, so that the benchmarks can hand the
+ * stack segments without computing them.
+ */
+
+#ifndef __LWIPOPTS_H_
+#define __LWIPOPTS_H_
+
+#define NO_SYS                          1
+#define NO_SYS_NO_TIMERS                0
+#define SYS_LIGHTWEIGHT_PROT            0
+
+/* As on the MCU: TCP asserts that its headers are aligned to this, and
+   they sit 20 bytes into a pbuf. x86 does not mind the pointers in heap
+   blocks being only 4-byte aligned. */
+#define MEM_ALIGNMENT                   4
+#define MEM_SIZE                        (1024 * 1024)
+#define PBUF_POOL_SIZE                  64
+
+#define MEMP_NUM_TCP_PCB                1100
+#define MEMP_NUM_TCP_PCB_LISTEN         8
+#define MEMP_NUM_TCP_SEG                256
+#define MEMP_NUM_SYS_TIMEOUT            10100
+
+#define CHECKSUM_CHECK_IP               0
+#define CHECKSUM_CHECK_UDP              0
+#define CHECKSUM_CHECK_TCP              0
+#define LWIP_CHECKSUM_ON_COPY           1
+
+/* Built each way: -DLWIP_CHKSUM_ALGORITHM=1 to 4, and
+   -DLWIP_CHKSUM_COPY_ALGORITHM=1 or 2 */
+#ifndef LWIP_CHKSUM_COPY_ALGORITHM
+#define LWIP_CHKSUM_COPY_ALGORITHM      2
+#endif
+
+#define LWIP_RAW                        0
+#define LWIP_DHCP                       0
+/* Only the iperf server test needs UDP, and turns it on with -DLWIP_UDP=1 */
+#ifndef LWIP_UDP
+#define LWIP_UDP                        0
+#endif
+#define LWIP_SOCKET                     0
+#define LWIP_NETCONN                    0
+
+#define TCP_MSS                         1460
+#define TCP_SND_BUF                     (2 * TCP_MSS)
+
+/* Built both ways: -DTCP_PCB_HASH=0 or -DTCP_PCB_HASH=1 */
+#ifndef TCP_PCB_HASH
+#define TCP_PCB_HASH                    1
+#endif
+#define TCP_PCB_HASH_SIZE               1024
+
+/* A gateway's worth of LAN hosts; -DARP_TABLE_SIZE=127 for the old limit */
+#ifndef ARP_TABLE_SIZE
+#define ARP_TABLE_SIZE                  1024
+#endif
+
+/* Built both ways: -DLWIP_TIMERS_WHEEL=0 or -DLWIP_TIMERS_WHEEL=1 */
+#ifndef LWIP_TIMERS_WHEEL
+#define LWIP_TIMERS_WHEEL               1
+#endif
+#define LWIP_TIMERS_HASH_SIZE           4096
+
+#define LWIP_STATS                      0
+
+/* As on the MCU (example/inc/lwipopts.h), for the EMAC driver */
+#define LPC_TX_PBUF_BOUNCE_EN           1
+
+#endif /* __LWIPOPTS_H_ */
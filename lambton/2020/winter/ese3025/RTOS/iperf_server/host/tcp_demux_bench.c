@@ -0,0 +1,343 @@
+/*
+ * @brief Host (Linux) benchmark of the TCP demultiplexing in tcp_input()
+ *
+ * @note
+ * Opens n connections to a listening PCB with synthetic handshakes, moves a
+ * quarter of them to TIME-WAIT, and then hands tcp_input() pure ACKs for
+ * connections picked at random, reporting the time per segment. Built once
+ * with the PCB lists and once with the hash tables:
+ *
+ *	gcc -std=gnu99 -O2 -DTCP_PCB_HASH=0 -I. -I../lwip/inc -I../lwip/inc/ipv4 \
+ *		-o tcp_demux_list tcp_demux_bench.c ../lwip/src/core/[a-z]*.c \
+ *		../lwip/src/core/ipv4/[a-z]*.c ../lwip/src/netif/etharp.c
+ *	gcc ... -DTCP_PCB_HASH=1 ... -o tcp_demux_hash ...
+ *
+ *	./tcp_demux_list [-s segments]
+ *
+ * Before it is timed, each established connection is sent a byte of data
+ * and its receive callback must see it; while it is timed, no segment may
+ * draw a reply (a segment for no connection would draw a RST).
+ */
+
+#include "lwip/init.h"
+#include "lwip/opt.h"
+#include "lwip/def.h"
+#include "lwip/pbuf.h"
+#include "lwip/netif.h"
+#include "lwip/ip.h"
+#include "lwip/tcp_impl.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SERVER_PORT     5001
+#define CLIENT_PORT     10000	/* connection i comes from port CLIENT_PORT + i */
+#define MAX_CONNS       1000
+
+/* The far end of a connection */
+typedef struct {
+	ip_addr_t ip;
+	u16_t port;
+	u32_t seq;			/* next sequence number to send */
+	u32_t ack;			/* next sequence number expected */
+	struct tcp_pcb *pcb;
+	u32_t hits;			/* bytes seen by the receive callback */
+} conn_t;
+
+static conn_t conns[MAX_CONNS];
+static struct netif netif;
+static u32_t replies;
+
+/* lwIP platform hooks */
+u32_t sys_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (u32_t) (ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+void assert_loop(void)
+{
+	printf("lwIP assertion failed\n");
+	abort();
+}
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+/* Every segment the stack sends ends up here */
+static err_t sink_output(struct netif *n, struct pbuf *p, ip_addr_t *dst)
+{
+	LWIP_UNUSED_ARG(n);
+	LWIP_UNUSED_ARG(p);
+	LWIP_UNUSED_ARG(dst);
+	replies++;
+	return ERR_OK;
+}
+
+static err_t sink_init(struct netif *n)
+{
+	n->output = sink_output;
+	n->mtu = 1500;
+	n->flags = NETIF_FLAG_LINK_UP;
+	return ERR_OK;
+}
+
+/* Hands tcp_input() a segment from c, as ip_input() would */
+static void send_segment(conn_t *c, u8_t flags, u16_t datalen)
+{
+	struct pbuf *p = pbuf_alloc(PBUF_RAW, IP_HLEN + TCP_HLEN + datalen, PBUF_RAM);
+	struct ip_hdr *iphdr;
+	struct tcp_hdr *tcphdr;
+
+	if (p == NULL) {
+		printf("out of memory\n");
+		exit(1);
+	}
+	iphdr = (struct ip_hdr *) p->payload;
+	IPH_VHL_SET(iphdr, 4, IP_HLEN / 4);
+	IPH_TOS_SET(iphdr, 0);
+	IPH_LEN_SET(iphdr, htons(IP_HLEN + TCP_HLEN + datalen));
+	IPH_ID_SET(iphdr, 0);
+	IPH_OFFSET_SET(iphdr, 0);
+	IPH_TTL_SET(iphdr, 64);
+	IPH_PROTO_SET(iphdr, IP_PROTO_TCP);
+	IPH_CHKSUM_SET(iphdr, 0);
+	ip_addr_copy(iphdr->src, c->ip);
+	ip_addr_copy(iphdr->dest, netif.ip_addr);
+
+	tcphdr = (struct tcp_hdr *) ((u8_t *) p->payload + IP_HLEN);
+	tcphdr->src = htons(c->port);
+	tcphdr->dest = htons(SERVER_PORT);
+	tcphdr->seqno = htonl(c->seq);
+	tcphdr->ackno = htonl(c->ack);
+	TCPH_HDRLEN_FLAGS_SET(tcphdr, TCP_HLEN / 4, flags);
+	tcphdr->wnd = htons(TCP_WND);
+	tcphdr->chksum = 0;
+	tcphdr->urgp = 0;
+	if (datalen != 0) {
+		memset((u8_t *) tcphdr + TCP_HLEN, 'x', datalen);
+	}
+
+	current_netif = &netif;
+	current_header = iphdr;
+	ip_addr_copy(current_iphdr_src, iphdr->src);
+	ip_addr_copy(current_iphdr_dest, iphdr->dest);
+	tcp_input(p, &netif);
+}
+
+static err_t conn_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
+{
+	conn_t *c = (conn_t *) arg;
+
+	LWIP_UNUSED_ARG(err);
+	if (p != NULL) {
+		c->hits += p->tot_len;
+		tcp_recved(pcb, p->tot_len);
+		pbuf_free(p);
+	}
+	return ERR_OK;
+}
+
+static err_t conn_accept(void *arg, struct tcp_pcb *newpcb, err_t err)
+{
+	conn_t *c = &conns[newpcb->remote_port - CLIENT_PORT];
+
+	LWIP_UNUSED_ARG(err);
+	tcp_accepted((struct tcp_pcb *) arg);
+	c->pcb = newpcb;
+	tcp_arg(newpcb, c);
+	tcp_recv(newpcb, conn_recv);
+	return ERR_OK;
+}
+
+/* Opens n connections, and moves n_tw of them to TIME-WAIT; returns 0 if
+   the stack did what it should have */
+static int open_conns(struct tcp_pcb *lpcb, int n, int n_tw)
+{
+	int i;
+
+	for (i = 0; i != n; ++i) {
+		conn_t *c = &conns[i];
+		struct tcp_pcb *pcb;
+
+		/* spread over a few networks, as real clients would be */
+		IP4_ADDR(&c->ip, 10, 1 + i % 7, (i >> 8) & 0xff, 1 + (i & 0x7f));
+		c->port = CLIENT_PORT + i;
+		c->seq = 1000u * i;
+		c->ack = 0;
+		c->pcb = NULL;
+		c->hits = 0;
+
+		send_segment(c, TCP_SYN, 0);
+		pcb = tcp_active_pcbs; /* new PCBs go to the front */
+		if (pcb == NULL || pcb->remote_port != c->port || pcb->state != SYN_RCVD) {
+			return -1;
+		}
+		c->seq++;
+		c->ack = pcb->snd_nxt;
+		send_segment(c, TCP_ACK, 0);
+		if (c->pcb != pcb || pcb->state != ESTABLISHED) {
+			return -1;
+		}
+	}
+
+	/* the demultiplexing must find each of them */
+	for (i = 0; i != n; ++i) {
+		send_segment(&conns[i], TCP_ACK | TCP_PSH, 1);
+		conns[i].seq++;
+		if (conns[i].hits != 1) {
+			return -1;
+		}
+	}
+
+	/* our side closes first, so it is our side that waits */
+	for (i = 0; i != n_tw; ++i) {
+		conn_t *c = &conns[i];
+
+		if (tcp_close(c->pcb) != ERR_OK) {
+			return -1;
+		}
+		c->ack = c->pcb->snd_nxt;
+		send_segment(c, TCP_FIN | TCP_ACK, 0);
+		c->seq++;
+		if (c->pcb->state != TIME_WAIT) {
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static void close_conns(void)
+{
+	while (tcp_active_pcbs != NULL) {
+		tcp_abort(tcp_active_pcbs);
+	}
+	while (tcp_tw_pcbs != NULL) {
+		tcp_abort(tcp_tw_pcbs);
+	}
+}
+
+/* Pure ACKs to connections first..first+n-1, in a random order; returns
+   the time per segment in ns */
+static double time_acks(int first, int n, long segments)
+{
+	static int order[MAX_CONNS];
+	u32_t rng = 2014;
+	long i, rounds = (segments + n - 1) / n;
+	uint64_t start;
+	int j;
+
+	for (j = 0; j != n; ++j) {
+		order[j] = first + j;
+	}
+	for (j = n - 1; j > 0; --j) {
+		int k, t;
+
+		rng = rng * 1664525u + 1013904223u;
+		k = (int) ((rng >> 8) % (u32_t) (j + 1));
+		t = order[j];
+		order[j] = order[k];
+		order[k] = t;
+	}
+
+	start = now_ns();
+	for (i = 0; i != rounds; ++i) {
+		for (j = 0; j != n; ++j) {
+			send_segment(&conns[order[j]], TCP_ACK, 0);
+		}
+	}
+	return (double) (now_ns() - start) / (rounds * n);
+}
+
+/* What building and freeing a segment costs, without tcp_input() */
+static double time_overhead(long segments)
+{
+	uint64_t start = now_ns();
+	long i;
+
+	for (i = 0; i != segments; ++i) {
+		struct pbuf *p = pbuf_alloc(PBUF_RAW, IP_HLEN + TCP_HLEN, PBUF_RAM);
+		struct tcp_hdr *tcphdr = (struct tcp_hdr *) ((u8_t *) p->payload + IP_HLEN);
+
+		tcphdr->seqno = htonl(conns[i % MAX_CONNS].seq);
+		pbuf_free(p);
+	}
+	return (double) (now_ns() - start) / segments;
+}
+
+int main(int argc, char *argv[])
+{
+	static const int sizes[] = {10, 30, 100, 300, 1000};
+	ip_addr_t ipaddr, netmask, gw;
+	struct tcp_pcb *pcb, *lpcb;
+	long segments = 1000000;
+	unsigned int k;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "s:")) != -1) {
+		switch (opt) {
+		case 's':
+			segments = strtol(optarg, NULL, 0);
+			break;
+		default:
+			printf("usage: %s [-s segments]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (segments < 1) {
+		printf("need some segments\n");
+		return 2;
+	}
+
+	lwip_init();
+	IP4_ADDR(&ipaddr, 10, 0, 0, 1);
+	IP4_ADDR(&netmask, 255, 0, 0, 0);
+	IP4_ADDR(&gw, 10, 0, 0, 254);
+	netif_add(&netif, &ipaddr, &netmask, &gw, NULL, sink_init, ip_input);
+	netif_set_default(&netif);
+	netif_set_up(&netif);
+
+	pcb = tcp_new();
+	if (pcb == NULL || tcp_bind(pcb, IP_ADDR_ANY, SERVER_PORT) != ERR_OK ||
+		(lpcb = tcp_listen(pcb)) == NULL) {
+		printf("cannot listen\n");
+		return 1;
+	}
+	tcp_arg(lpcb, lpcb);
+	tcp_accept(lpcb, conn_accept);
+
+	printf("TCP_PCB_HASH=%d, %.1f ns/segment to build and free a segment\n",
+		   TCP_PCB_HASH, time_overhead(segments));
+	printf("%6s %8s %14s %14s\n", "pcbs", "in TW", "ESTABLISHED", "TIME-WAIT");
+	printf("%6s %8s %14s %14s\n", "", "", "ns/segment", "ns/segment");
+	for (k = 0; k != sizeof(sizes) / sizeof(sizes[0]); ++k) {
+		int n = sizes[k], n_tw = n / 4;
+		double est, tw;
+
+		if (open_conns(lpcb, n, n_tw) != 0) {
+			printf("FAILED: setting up %d connections\n", n);
+			return 1;
+		}
+		replies = 0;
+		est = time_acks(n_tw, n - n_tw, segments);
+		tw = time_acks(0, n_tw, segments);
+		printf("%6d %8d %14.1f %14.1f\n", n, n_tw, est, tw);
+		if (replies != 0) {
+			printf("FAILED: %lu replies to pure ACKs\n", (unsigned long) replies);
+			return 1;
+		}
+		close_conns();
+	}
+	return 0;
+}
@@ -0,0 +1,297 @@
+/*
+ * @brief Host (Linux) benchmark of the lwIP timeouts in timers.c
+ *
+ * @note
+ * Runs the timeouts on a simulated sys_now() that starts a little before it
+ * wraps around, with n timeouts of random lengths pending, and reports the
+ * time for sys_timeout(), sys_untimeout(), a sys_check_timeouts() every
+ * millisecond, and a timeout that sets itself again each time it is called
+ * from a main loop that sleeps for sys_timeouts_sleeptime(). It also counts
+ * the calls that loop makes to sys_check_timeouts() for n timeouts. Last, a
+ * timeout that sets itself again every 250 ms, checked every 7 ms, must
+ * still be called within 7 ms of a multiple of 250 ms from when it was
+ * first set: its period is counted from when it was due, not from when it
+ * was called, so it does not drift. Built once with the sorted list and once
+ * with the timing wheel:
+ *
+ *	gcc -std=gnu99 -O2 -DLWIP_TIMERS_WHEEL=0 -I. -I../lwip/inc -I../lwip/inc/ipv4 \
+ *		-o timers_list timers_bench.c ../lwip/src/core/[a-z]*.c \
+ *		../lwip/src/core/ipv4/[a-z]*.c ../lwip/src/netif/etharp.c
+ *	gcc ... -DLWIP_TIMERS_WHEEL=1 ... -o timers_wheel ...
+ *
+ *	./timers_wheel [-d longest timeout in ms] [-e events]
+ *
+ * Every timeout must be called in the millisecond it is due, and none that
+ * was taken back by sys_untimeout() may be called at all.
+ */
+
+#include "lwip/init.h"
+#include "lwip/opt.h"
+#include "lwip/def.h"
+#include "lwip/timers.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_TIMERS      10000
+
+/* A timeout of the benchmark; its address is the argument of its handler */
+typedef struct {
+	u32_t due;			/* sys_now() it must be called at */
+	u8_t pending;		/* set, and not called or taken back yet */
+	u8_t again;			/* sets itself again when called */
+} tmo_t;
+
+static tmo_t timers[MAX_TIMERS];
+static u32_t sim_now = 0xFFFFFFFFu - 30000;	/* wraps around in the first run */
+static u32_t rng = 2014;
+static u32_t longest = 10000;
+static long called;
+static u32_t wrong;
+
+/* lwIP platform hooks */
+u32_t sys_now(void)
+{
+	return sim_now;
+}
+
+void assert_loop(void)
+{
+	printf("lwIP assertion failed\n");
+	abort();
+}
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static u32_t random_ms(void)
+{
+	rng = rng * 1664525u + 1013904223u;
+	return 1 + (rng >> 8) % longest;
+}
+
+static void handler(void *arg);
+
+/* Sets the timeout to be due ms after from */
+static void set(tmo_t *t, u32_t from)
+{
+	u32_t ms = random_ms();
+
+	t->due = from + ms;
+	t->pending = 1;
+	sys_timeout(ms, handler, t);
+}
+
+static void handler(void *arg)
+{
+	tmo_t *t = (tmo_t *) arg;
+
+	called++;
+	if (!t->pending || t->due != sim_now) {
+		wrong++;
+	}
+	t->pending = 0;
+	if (t->again) {
+		set(t, t->due);
+	}
+}
+
+/* Sets n timeouts; the list counts their times from the last time a
+   timeout was called, so it is moved up to now first */
+static uint64_t set_all(int n, u8_t again)
+{
+	uint64_t start;
+	int i;
+
+	called = 0;
+	sys_restart_timeouts();
+	start = now_ns();
+	for (i = 0; i != n; ++i) {
+		timers[i].again = again;
+		set(&timers[i], sim_now);
+	}
+	return now_ns() - start;
+}
+
+/* Runs the clock a millisecond at a time until n timeouts have been called;
+   returns the number of sys_check_timeouts() calls */
+static u32_t poll_all(long n)
+{
+	u32_t calls = 0;
+
+	while (called < n) {
+		sim_now++;
+		sys_check_timeouts();
+		calls++;
+	}
+	return calls;
+}
+
+/* The same, but sleeping for sys_timeouts_sleeptime() in between */
+static u32_t sleep_all(long n)
+{
+	u32_t calls = 0, ms;
+
+	while (called < n) {
+		ms = sys_timeouts_sleeptime();
+		if (ms == SYS_TIMEOUTS_SLEEPTIME_INFINITE) {
+			break;
+		}
+		sim_now += ms;
+		sys_check_timeouts();
+		calls++;
+	}
+	return calls;
+}
+
+#define PERIOD          250
+#define POLL            7
+
+static u32_t periodic_calls, periodic_start, periodic_late;
+
+static void periodic(void *arg)
+{
+	u32_t late = sim_now - periodic_start - ++periodic_calls * PERIOD;
+
+	if (late > periodic_late) {
+		periodic_late = late;
+	}
+	sys_timeout(PERIOD, periodic, arg);
+}
+
+/* A timeout that sets itself again, called from a main loop that checks
+   every POLL ms; returns the most it was called late, in ms */
+static u32_t periodic_drift(u32_t periods)
+{
+	sys_restart_timeouts();
+	periodic_calls = 0;
+	periodic_late = 0;
+	periodic_start = sim_now;
+	sys_timeout(PERIOD, periodic, NULL);
+	while (periodic_calls < periods) {
+		sim_now += POLL;
+		sys_check_timeouts();
+	}
+	sys_untimeout(periodic, NULL);
+	return periodic_late;
+}
+
+int main(int argc, char *argv[])
+{
+	static const int sizes[] = {10, 100, 1000, 10000};
+	static int order[MAX_TIMERS];
+	long events = 1000000;
+	u32_t late;
+	unsigned int k;
+	int opt, i;
+
+	while ((opt = getopt(argc, argv, "d:e:")) != -1) {
+		switch (opt) {
+		case 'd':
+			longest = strtoul(optarg, NULL, 0);
+			break;
+		case 'e':
+			events = strtol(optarg, NULL, 0);
+			break;
+		default:
+			printf("usage: %s [-d longest timeout in ms] [-e events]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (longest < 1 || longest > 0x7FFFFFFF || events < 1) {
+		printf("need some events, and timeouts of 1 ms to 24 days\n");
+		return 2;
+	}
+
+	lwip_init();
+	/* touch the pool and the tables before anything is timed */
+	set_all(MAX_TIMERS, 0);
+	for (i = 0; i != MAX_TIMERS; ++i) {
+		sys_untimeout(handler, &timers[i]);
+		timers[i].pending = 0;
+	}
+
+	printf("LWIP_TIMERS_WHEEL=%d, timeouts of 1 to %lu ms\n", LWIP_TIMERS_WHEEL,
+		   (unsigned long) longest);
+	printf("%6s %10s %10s %10s %10s %10s\n", "timers", "set", "cancel",
+		   "check", "sleeping", "again");
+	printf("%6s %10s %10s %10s %10s %10s\n", "", "ns/timer", "ns/timer",
+		   "ns/call", "calls", "ns/event");
+	for (k = 0; k != sizeof(sizes) / sizeof(sizes[0]); ++k) {
+		int n = sizes[k];
+		uint64_t t_set, t_cancel, t_check, t_again;
+		u32_t checks, sleeps;
+
+		wrong = 0;
+
+		/* all of them set and taken back again, in a random order */
+		t_set = set_all(n, 0);
+		for (i = 0; i != n; ++i) {
+			order[i] = i;
+		}
+		for (i = n - 1; i > 0; --i) {
+			int j, t;
+
+			rng = rng * 1664525u + 1013904223u;
+			j = (int) ((rng >> 8) % (u32_t) (i + 1));
+			t = order[i];
+			order[i] = order[j];
+			order[j] = t;
+		}
+		t_cancel = now_ns();
+		for (i = 0; i != n; ++i) {
+			sys_untimeout(handler, &timers[order[i]]);
+		}
+		t_cancel = now_ns() - t_cancel;
+		for (i = 0; i != n; ++i) {
+			timers[i].pending = 0;
+		}
+
+		/* set again, and called as the clock goes by */
+		set_all(n, 0);
+		t_check = now_ns();
+		checks = poll_all(n);
+		t_check = now_ns() - t_check;
+
+		/* and again, sleeping till the next one is due */
+		set_all(n, 0);
+		sleeps = sleep_all(n);
+
+		/* each called and set again, until events calls */
+		set_all(n, 1);
+		t_again = now_ns();
+		sleep_all(events);
+		t_again = now_ns() - t_again;
+		for (i = 0; i != n; ++i) {
+			sys_untimeout(handler, &timers[i]);
+			timers[i].pending = 0;
+		}
+
+		printf("%6d %10.1f %10.1f %10.1f %10lu %10.1f\n", n,
+			   (double) t_set / n, (double) t_cancel / n,
+			   (double) t_check / checks, (unsigned long) sleeps,
+			   (double) t_again / called);
+		if (wrong != 0) {
+			printf("FAILED: %lu timeouts called at the wrong time\n",
+				   (unsigned long) wrong);
+			return 1;
+		}
+	}
+
+	late = periodic_drift(10000);
+	printf("a %d ms timeout checked every %d ms, 10000 times: at most %lu ms late\n",
+		   PERIOD, POLL, (unsigned long) late);
+	if (late >= POLL) {
+		printf("FAILED: a timeout that sets itself again drifts\n");
+		return 1;
+	}
+	return 0;
+}
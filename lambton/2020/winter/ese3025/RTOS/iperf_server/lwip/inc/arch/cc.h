@@ -90,8 +90,11 @@ typedef uintptr_t          mem_ptr_t;
 //	#define ALIGNED(n)  __align(n)
 #endif 
 
-/* Used with IP headers only */
+/* Used with IP headers only; lwipopts.h may choose 4, word at a time with
+   LDM on the Cortex-M3 (see inet_chksum.c), once it has been timed there */
+#ifndef LWIP_CHKSUM_ALGORITHM
 #define LWIP_CHKSUM_ALGORITHM 1
+#endif
 
 #ifdef LWIP_DEBUG
 /**
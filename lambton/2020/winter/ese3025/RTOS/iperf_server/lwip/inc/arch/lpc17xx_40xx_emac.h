@@ -53,6 +53,24 @@ extern "C"
  * @{
  */
 
+/**
+ * @brief EMAC driver counters
+ */
+typedef struct {
+	u32_t tx_bounce_segs;		/**< TX fragments copied to a bounce slot */
+	u32_t tx_bounce_bytes;		/**< Bytes copied to bounce slots */
+	u32_t tx_stalls;			/**< Packets that found too few free TX descriptors */
+	u32_t tx_qdrops;			/**< Packets refused because the TX queue was full */
+	u32_t tx_reclaimed;			/**< Packets freed after transmission */
+	u32_t tx_reclaim_ms_sum;	/**< Sum of output to reclaim times, in milliSeconds */
+	u32_t tx_reclaim_ms_max;	/**< Longest output to reclaim time, in milliSeconds */
+	u32_t rx_irqs;				/**< RX interrupts taken (LPC_RX_POLL) */
+	u32_t rx_irqs_per_sec;		/**< RX interrupts in the last full second (LPC_RX_POLL) */
+	u32_t rx_polls;				/**< Calls to lpc_enetif_poll() that had work */
+	u32_t rx_poll_frames;		/**< Frames taken by those polls, divide by rx_polls for frames per poll */
+	u32_t rx_poll_full;			/**< Polls that used their whole budget */
+} lpc_enetstats_t;
+
 /**
  * @brief	Attempt to read a packet from the EMAC interface
  * @param	netif	: lwip network interface structure pointer
@@ -60,6 +78,29 @@ extern "C"
  */
 void lpc_enetif_input(struct netif *netif);
 
+/**
+ * @brief	Budgeted receive after an RX interrupt
+ * @param	netif	: lwip network interface structure pointer
+ * @param	budget	: Maximum number of frames to receive
+ * @return	The number of frames taken off the ring
+ * @note	Only available with LPC_RX_POLL. The EMAC interrupt masks RX and
+ * schedules a poll. Each call receives up to budget frames, refills their
+ * descriptors as one batch and passes the frames up the stack. RX is
+ * unmasked again, after the optional LPC_RX_HOLDOFF_US delay, once the
+ * ring is empty. Returns 0 straight away when no poll is scheduled.
+ */
+s32_t lpc_enetif_poll(struct netif *netif, s32_t budget);
+
+/**
+ * @brief	Tells if an RX poll is scheduled
+ * @param	netif	: lwip network interface structure pointer
+ * @return	Non-zero while lpc_enetif_poll() has frames to take
+ * @note	Only available with LPC_RX_POLL. A main loop that sleeps until
+ * the next interrupt must check this with interrupts disabled, so that an
+ * RX interrupt taken just before it sleeps is not missed.
+ */
+s32_t lpc_enetif_poll_pending(struct netif *netif);
+
 /**
  * @brief	Attempt to allocate and requeue a new pbuf for RX
  * @param	netif	: lwip network interface structure pointer
@@ -71,7 +112,8 @@ s32_t lpc_rx_queue(struct netif *netif);
  * @brief	Polls if an available TX descriptor is ready
  * @param	netif	: lwip network interface structure pointer
  * @return	0 if no descriptors are read, or >0
- * @note	Can be used to determine if the low level transmit function will block
+ * @note	Can be used to determine if the low level transmit function will block.
+ * Descriptors the EMAC has sent only count once lpc_tx_reclaim() has freed them.
  */
 s32_t lpc_tx_ready(struct netif *netif);
 
@@ -92,6 +134,13 @@ void lpc_tx_reclaim(struct netif *netif);
  */
 err_t lpc_enetif_init(struct netif *netif);
 
+/**
+ * @brief	Returns the EMAC driver counters
+ * @param	netif	: lwip network interface structure pointer
+ * @return	Pointer to the counters, updated as the driver runs
+ */
+const lpc_enetstats_t *lpc_enetif_stats(struct netif *netif);
+
 /**
  * @brief	Set up the MAC interface duplex
  * @param	full_duplex	: 0 = half duplex, 1 = full duplex
@@ -0,0 +1,123 @@
+/*
+ * @brief Host (Linux) simulation of the LPC17xx/40xx EMAC for LWIP
+ *
+ * @note
+ * This file is only used when the EMAC driver is built on a workstation
+ * with LPC_EMAC_SIM defined. The MCU build never includes it.
+ */
+
+#ifndef __LPC_EMAC_SIM_H_
+#define __LPC_EMAC_SIM_H_
+
+#include "lwip/opt.h"
+#include "chip.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** @defgroup NET_LWIP_LPC_EMAC_SIM 17xx/40xx EMAC host simulation
+ * @ingroup NET_LWIP_LPC17XX40XX_EMAC_DRIVER
+ * @note	Building lpc17xx_40xx_emac.c with LPC_EMAC_SIM defined replaces the
+ * LPC_ETHERNET register block with one in host RAM. lpc_emac_sim_poll()
+ * then plays the part of the EMAC DMA engine: it sends the frames queued on
+ * the TX descriptors and completes them, and it fills the RX descriptors
+ * from a TAP device or a pcap capture, setting the same status words and
+ * produce/consume indexes the hardware does. lpc_low_level_input(),
+ * lpc_low_level_output() and lpc_tx_reclaim_st() run unchanged against it.
+ *
+ * The descriptor Packet fields are 32 bits wide, so the buffers must sit
+ * below 4 GB: build with 32-bit pointers (gcc -m32), or as a position
+ * dependent x86-64 executable (gcc -no-pie) so that lwIP's static heap
+ * does. host/emac_sim_bench.c is built that way.
+ * @{
+ */
+
+/**
+ * @brief Simulated EMAC counters
+ */
+typedef struct {
+	u32_t rx_frames;		/**< Frames written to RX descriptors */
+	u32_t rx_bytes;			/**< Bytes written to RX descriptors, without FCS */
+	u32_t rx_nodesc;		/**< Frames dropped because no RX descriptor was free */
+	u32_t rx_toolong;		/**< Frames dropped because they did not fit the RX buffer */
+	u32_t rx_allocs;		/**< pbufs allocated by the driver for the RX ring */
+	u32_t tx_frames;		/**< Frames taken from TX descriptors */
+	u32_t tx_bytes;			/**< Bytes taken from TX descriptors */
+	u32_t tx_descs;			/**< TX descriptors completed */
+} LPC_EMAC_SIM_STATS_T;
+
+/** Register block used in place of LPC_ETHERNET */
+extern LPC_ENET_T lpc_emac_sim_regs;
+
+/** Counters, cleared by lpc_emac_sim_open_tap() and lpc_emac_sim_open_pcap() */
+extern LPC_EMAC_SIM_STATS_T lpc_emac_sim_stats;
+
+/** Station address reported to the driver in place of Board_ENET_GetMacADDR() */
+extern u8_t lpc_emac_sim_hwaddr[6];
+
+/**
+ * @brief	Attach the simulated EMAC to a Linux TAP device
+ * @param	ifname	: TAP interface name, for example "tap0"
+ * @return	0 on success, -1 on error (errno is set)
+ * @note	The device must exist and be owned by the caller, for example
+ * "ip tuntap add dev tap0 mode tap user $USER".
+ */
+int lpc_emac_sim_open_tap(const char *ifname);
+
+/**
+ * @brief	Attach the simulated EMAC to a pcap capture file
+ * @param	filename	: Capture in classic libpcap format, Ethernet link type
+ * @param	loop		: Non-zero to rewind the capture when it ends
+ * @return	0 on success, -1 on error
+ * @note	Frames are delivered as fast as the driver consumes them, which
+ * is what the packets per second benchmark wants. Transmitted frames are
+ * counted and discarded.
+ */
+int lpc_emac_sim_open_pcap(const char *filename, int loop);
+
+/**
+ * @brief	Detach the simulated EMAC from its TAP device or capture file
+ * @return	Nothing
+ */
+void lpc_emac_sim_close(void);
+
+/**
+ * @brief	Run the simulated transmit DMA
+ * @return	Number of frames sent
+ * @note	Completes every fully queued TX frame and advances the TX
+ * consume index, as the EMAC does after it has sent them.
+ */
+int lpc_emac_sim_txdma(void);
+
+/**
+ * @brief	Run the simulated receive DMA
+ * @return	Number of frames received, or -1 once a capture has ended
+ * @note	Fills free RX descriptors with waiting frames and advances the
+ * RX produce index.
+ */
+int lpc_emac_sim_rxdma(void);
+
+/**
+ * @brief	Run the simulated transmit and receive DMA once
+ * @return	Number of frames received, or -1 once a capture has ended
+ * @note	Call this from the host main loop where the MCU would take the
+ * EMAC interrupt. ETH_IRQHandler() is called when an enabled interrupt
+ * is pending.
+ */
+int lpc_emac_sim_poll(void);
+
+/* The driver and the Chip_ENET_* helpers talk to the simulated registers */
+#undef LPC_ETHERNET
+#define LPC_ETHERNET (&lpc_emac_sim_regs)
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LPC_EMAC_SIM_H_ */
@@ -217,8 +217,12 @@ struct netif {
   netif_igmp_mac_filter_fn igmp_mac_filter;
 #endif /* LWIP_IGMP */
 #if LWIP_NETIF_HWADDRHINT
-  u8_t *addr_hint;
+  u16_t *addr_hint;
 #endif /* LWIP_NETIF_HWADDRHINT */
+#if LWIP_ARP
+  /** ARP table entry this netif last sent to, tried first by etharp_output() */
+  u16_t arp_last;
+#endif /* LWIP_ARP */
 #if ENABLE_LOOPBACK
   /* List of packets to be queued for ourselves. */
   struct pbuf *loop_first;
@@ -76,6 +76,25 @@
 #define NO_SYS_NO_TIMERS                0
 #endif
 
+/**
+ * LWIP_TIMERS_WHEEL==1: keep the timeouts in a hierarchical timing wheel
+ * instead of a sorted list, so that sys_timeout() and sys_untimeout() take
+ * the same time however many timeouts are pending. Each timeout takes three
+ * more fields, and the wheel about 130 pointers.
+ */
+#ifndef LWIP_TIMERS_WHEEL
+#define LWIP_TIMERS_WHEEL               0
+#endif
+
+/**
+ * LWIP_TIMERS_HASH_SIZE: the number of buckets sys_untimeout() finds the
+ * timeouts of a handler in, with LWIP_TIMERS_WHEEL. It stays O(1) while this
+ * is at least about the number of pending timeouts.
+ */
+#ifndef LWIP_TIMERS_HASH_SIZE
+#define LWIP_TIMERS_HASH_SIZE           16
+#endif
+
 /**
  * MEMCPY: override this if you have a faster implementation at hand than the
  * one included in your C library
@@ -427,7 +446,9 @@
 #endif
 
 /**
- * ARP_TABLE_SIZE: Number of active MAC-IP address pairs cached.
+ * ARP_TABLE_SIZE: Number of active MAC-IP address pairs cached, up to 0x7fff.
+ * Lookups go through a hash of at least twice as many 2-byte buckets, so
+ * their cost does not grow with the table.
  */
 #ifndef ARP_TABLE_SIZE
 #define ARP_TABLE_SIZE                  10
@@ -1035,6 +1056,34 @@
 #define TCP_DEFAULT_LISTEN_BACKLOG      0xff
 #endif
 
+/**
+ * TCP_PCB_HASH==1: find the PCB for an incoming segment through hash tables
+ * instead of walking the PCB lists: one keyed by the 4-tuple, holding the
+ * active and TIME-WAIT PCBs, and one keyed by the local port, holding the
+ * listening PCBs. The lists are kept as well, for the timers; every PCB
+ * grows by one pointer.
+ */
+#ifndef TCP_PCB_HASH
+#define TCP_PCB_HASH                    0
+#endif
+
+/**
+ * TCP_PCB_HASH_SIZE: the number of buckets in the 4-tuple table, a power of
+ * 2. Lookups stay O(1) while it is at least about the number of active and
+ * TIME-WAIT PCBs.
+ */
+#ifndef TCP_PCB_HASH_SIZE
+#define TCP_PCB_HASH_SIZE               32
+#endif
+
+/**
+ * TCP_LISTEN_HASH_SIZE: the number of buckets in the local port table, a
+ * power of 2.
+ */
+#ifndef TCP_LISTEN_HASH_SIZE
+#define TCP_LISTEN_HASH_SIZE            8
+#endif
+
 /**
  * TCP_OVERSIZE: The maximum number of bytes that tcp_write may
  * allocate ahead of time in an attempt to create shorter pbuf chains
@@ -150,11 +150,18 @@ enum tcp_state {
 #define DEF_ACCEPT_CALLBACK
 #endif /* LWIP_CALLBACK_API */
 
+#if TCP_PCB_HASH
+#define DEF_HASH_NEXT(type)  type *hash_next; /* for the hash table bucket */
+#else /* TCP_PCB_HASH */
+#define DEF_HASH_NEXT(type)
+#endif /* TCP_PCB_HASH */
+
 /**
  * members common to struct tcp_pcb and struct tcp_listen_pcb
  */
 #define TCP_PCB_COMMON(type) \
   type *next; /* for the linked list */ \
+  DEF_HASH_NEXT(type) \
   void *callback_arg; \
   /* the accept callback for listen- and normal pcbs, if LWIP_CALLBACK_API */ \
   DEF_ACCEPT_CALLBACK \
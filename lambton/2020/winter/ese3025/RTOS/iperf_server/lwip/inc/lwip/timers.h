@@ -66,12 +66,22 @@ typedef void (* sys_timeout_handler)(void *arg);
 
 struct sys_timeo {
   struct sys_timeo *next;
+#if LWIP_TIMERS_WHEEL
+  struct sys_timeo *prev;
+  /** next timeout in the same sys_untimeout() bucket */
+  struct sys_timeo *hash_next;
+#endif /* LWIP_TIMERS_WHEEL */
+  /** time after the timeout before this one in the list, or with
+      LWIP_TIMERS_WHEEL the sys_now() at which this one is due */
   u32_t time;
   sys_timeout_handler h;
   void *arg;
 #if LWIP_DEBUG_TIMERNAMES
   const char* handler_name;
 #endif /* LWIP_DEBUG_TIMERNAMES */
+#if LWIP_TIMERS_WHEEL
+  u8_t slot;
+#endif /* LWIP_TIMERS_WHEEL */
 };
 
 void sys_timeouts_init(void);
@@ -91,6 +101,13 @@ void sys_restart_timeouts(void);
 void sys_timeouts_mbox_fetch(sys_mbox_t *mbox, void **msg);
 #endif /* NO_SYS */
 
+#if NO_SYS || LWIP_TIMERS_WHEEL
+/** What sys_timeouts_sleeptime() returns when no timeout is pending */
+#define SYS_TIMEOUTS_SLEEPTIME_INFINITE 0xFFFFFFFF
+
+u32_t sys_timeouts_sleeptime(void);
+#endif /* NO_SYS || LWIP_TIMERS_WHEEL */
+
 
 #ifdef __cplusplus
 }
@@ -46,6 +46,10 @@
 #include "board.h"
 #include "lpc_phy.h"
 
+#ifdef LPC_EMAC_SIM
+#include "arch/lpc_emac_sim.h"
+#endif
+
 #include <string.h>
 
 extern void msDelay(uint32_t ms);
@@ -58,6 +62,39 @@ extern void msDelay(uint32_t ms);
 #error LPC_NUM_BUFF_RXDESCS must be at least 3
 #endif
 
+#ifndef LPC_TX_NONBLOCK
+#define LPC_TX_NONBLOCK 0
+#endif
+
+#if LPC_TX_NONBLOCK == 1 && !defined(LPC_TX_QUEUE_LEN)
+#define LPC_TX_QUEUE_LEN 8
+#endif
+
+#ifndef LPC_RX_POLL
+#define LPC_RX_POLL 0
+#endif
+
+#if LPC_RX_POLL == 1 && !defined(LPC_RX_POLL_BUDGET)
+#define LPC_RX_POLL_BUDGET LPC_NUM_BUFF_RXDESCS
+#endif
+
+/* The RI timer holdoff needs the real peripheral */
+#if !defined(LPC_RX_HOLDOFF_US) || LPC_RX_POLL == 0 || defined(LPC_EMAC_SIM)
+#undef LPC_RX_HOLDOFF_US
+#define LPC_RX_HOLDOFF_US 0
+#endif
+
+/* TX bounce slots must be in memory the EMAC DMA can read. The AHB
+   (peripheral) SRAM bank is, on all parts; the LPCXpresso managed linker
+   scripts call it RAM2. */
+#ifndef LPC_TX_BOUNCE_SECTION
+#if defined(LPC_EMAC_SIM)
+#define LPC_TX_BOUNCE_SECTION
+#else
+#define LPC_TX_BOUNCE_SECTION __attribute__ ((section(".bss.$RAM2")))
+#endif
+#endif
+
 /** @ingroup NET_LWIP_LPC17XX40XX_EMAC_DRIVER
  * @{
  */
@@ -88,16 +125,19 @@ extern void msDelay(uint32_t ms);
  * so use it only for debug. */
 // #define LOCK_RX_THREAD
 
-#if NO_SYS == 0
+#if NO_SYS == 0 || LPC_RX_POLL == 1
 /** @brief Receive group interrupts
  */
 #define RXINTGROUP (ENET_INT_RXOVERRUN | ENET_INT_RXERROR | ENET_INT_RXDONE)
+#else
+#define RXINTGROUP 0
+#endif
 
+#if NO_SYS == 0
 /** @brief Transmit group interrupts
  */
 #define TXINTGROUP (ENET_INT_TXUNDERRUN | ENET_INT_TXERROR | ENET_INT_TXDONE)
 #else
-#define RXINTGROUP 0
 #define TXINTGROUP 0
 #endif
 
@@ -117,6 +157,19 @@ typedef struct {
 	struct pbuf *txb[LPC_NUM_BUFF_TXDESCS];		/**< TX pbuf pointer list, zero-copy mode */
 
 	u32_t lpc_last_tx_idx;						/**< TX last descriptor index, zero-copy mode */
+	u32_t txtime[LPC_NUM_BUFF_TXDESCS];			/**< sys_now() when each TX frame was handed to the driver */
+#if LPC_TX_NONBLOCK == 1
+	struct pbuf *txq[LPC_TX_QUEUE_LEN];			/**< Frames waiting for TX descriptors */
+	u32_t txq_time[LPC_TX_QUEUE_LEN];			/**< sys_now() when each txq frame was queued */
+	u32_t txq_head;								/**< Oldest entry in txq */
+	u32_t txq_count;							/**< Number of entries in txq */
+#endif
+#if LPC_RX_POLL == 1
+	volatile u32_t rx_poll_pending;				/**< RX interrupt masked, poll scheduled */
+	u32_t rx_rate_ms;							/**< Start of the current IRQ rate window */
+	u32_t rx_rate_irqs;							/**< rx_irqs at the start of the window */
+#endif
+	lpc_enetstats_t stats;						/**< Driver counters */
 #if NO_SYS == 0
 	sys_sem_t rx_sem;							/**< RX receive thread wakeup semaphore */
 	sys_sem_t tx_clean_sem;						/**< TX cleanup thread wakeup semaphore */
@@ -130,6 +183,12 @@ typedef struct {
  */
 ALIGNED(8) lpc_enetdata_t lpc_enetdata;
 
+#if LPC_TX_PBUF_BOUNCE_EN == 1
+/** \brief  TX bounce slots, one for each TX descriptor
+ */
+ALIGNED(4) LPC_TX_BOUNCE_SECTION STATIC u8_t lpc_txbounce[LPC_NUM_BUFF_TXDESCS][ENET_ETH_MAX_FLEN];
+#endif
+
 /*****************************************************************************
  * Public types/enumerations/variables
  ****************************************************************************/
@@ -146,6 +205,10 @@ STATIC void lpc_rxqueue_pbuf(lpc_enetdata_t *lpc_enetif, struct pbuf *p)
 	/* Get next free descriptor index */
 	idx = lpc_enetif->rx_fill_desc_index;
 
+	/* A pbuf put back after a dropped frame has its length cut down to
+	   the frame's; the descriptor gets the whole buffer again */
+	p->len = p->tot_len = (u16_t) ENET_ETH_MAX_FLEN;
+
 	/* Setup descriptor and clear statuses */
 	lpc_enetif->prxd[idx].Control = ENET_RCTRL_INT | ((u32_t) ENET_RCTRL_SIZE(p->len));
 	lpc_enetif->prxd[idx].Packet = (u32_t) p->payload;
@@ -320,9 +383,57 @@ STATIC struct pbuf *lpc_low_level_input(struct netif *netif) {
 	return p;
 }
 
+/* Passes a received frame to the network layer */
+STATIC void lpc_enetif_deliver(struct netif *netif, struct pbuf *p)
+{
+	struct eth_hdr *ethhdr;
+
+	/* points to packet payload, which starts with an Ethernet header */
+	ethhdr = p->payload;
+
+	switch (htons(ethhdr->type)) {
+	case ETHTYPE_IP:
+	case ETHTYPE_ARP:
+#if PPPOE_SUPPORT
+	case ETHTYPE_PPPOEDISC:
+	case ETHTYPE_PPPOE:
+#endif /* PPPOE_SUPPORT */
+		/* full packet send to tcpip_thread to process */
+		if (netif->input(p, netif) != ERR_OK) {
+			LWIP_DEBUGF(NETIF_DEBUG, ("lpc_enetif_input: IP input error\n"));
+			/* Free buffer */
+			pbuf_free(p);
+		}
+		break;
+
+	default:
+		/* Return buffer */
+		pbuf_free(p);
+		break;
+	}
+}
+
+#if LPC_RX_POLL == 1
+/* Unmasks the RX interrupts at the end of a poll or holdoff */
+STATIC void lpc_rx_unmask(void)
+{
+#if LPC_RX_HOLDOFF_US > 0
+	/* Keep RX masked for the holdoff time, frames arriving meanwhile are
+	   picked up by the interrupt that fires when RIT_IRQHandler() unmasks */
+	Chip_RIT_Enable(LPC_RITIMER);
+#else
+	Chip_ENET_EnableInt(LPC_ETHERNET, RXINTGROUP);
+#endif
+}
+
+#endif
+
 /* Determine if the passed address is usable for the ethernet DMA controller */
 STATIC s32_t lpc_packet_addr_notsafe(void *addr) {
-#if defined(CHIP_LPC175X_6X)
+#if defined(LPC_EMAC_SIM)
+	/* The simulated DMA can reach all of host memory */
+	return 0;
+#elif defined(CHIP_LPC175X_6X)
 	/* Check for legal address ranges */
 	if ((((u32_t) addr >= 0x10000000) && ((u32_t) addr < 0x10008000)) /* 32kB local SRAM */
 		|| (((u32_t) addr >= 0x1FFF0000) && ((u32_t) addr < 0x1FFF2000)) /* 8kB ROM */
@@ -372,6 +483,14 @@ STATIC void lpc_tx_reclaim_st(lpc_enetdata_t *lpc_enetif, u32_t cidx)
 
 	while (cidx != lpc_enetif->lpc_last_tx_idx) {
 		if (lpc_enetif->txb[lpc_enetif->lpc_last_tx_idx] != NULL) {
+			u32_t latency = sys_now() - lpc_enetif->txtime[lpc_enetif->lpc_last_tx_idx];
+
+			lpc_enetif->stats.tx_reclaimed++;
+			lpc_enetif->stats.tx_reclaim_ms_sum += latency;
+			if (latency > lpc_enetif->stats.tx_reclaim_ms_max) {
+				lpc_enetif->stats.tx_reclaim_ms_max = latency;
+			}
+
 			LWIP_DEBUGF(EMAC_DEBUG | LWIP_DBG_TRACE,
 						("lpc_tx_reclaim_st: Freeing packet %p (index %d)\n",
 						 lpc_enetif->txb[lpc_enetif->lpc_last_tx_idx],
@@ -395,24 +514,140 @@ STATIC void lpc_tx_reclaim_st(lpc_enetdata_t *lpc_enetif, u32_t cidx)
 #endif
 }
 
-/* Low level output of a packet. Never call this from an interrupt context,
- * as it may block until TX descriptors become available. */
-STATIC err_t lpc_low_level_output(struct netif *netif, struct pbuf *p)
+/* Number of TX descriptors a frame takes, 0 if it can never be queued.
+ * One descriptor of the ring always stays empty, so a chain longer than
+ * the rest is copied whole into a single bounce slot. */
+STATIC u32_t lpc_tx_descs(struct pbuf *p)
+{
+	u32_t dn = (u32_t) pbuf_clen(p);
+
+	if (dn > LPC_NUM_BUFF_TXDESCS - 1) {
+#if LPC_TX_PBUF_BOUNCE_EN == 1
+		dn = 1;
+#else
+		dn = 0;
+#endif
+	}
+
+	return dn;
+}
+
+/* Queues a frame on the TX descriptors. The caller makes sure that dn
+ * descriptors are free and hands a reference to p over to the driver,
+ * which is released by lpc_tx_reclaim_st(). txtime is the sys_now() of
+ * when the frame was handed to the driver. A chained frame given a
+ * single descriptor (see lpc_tx_descs()) goes out of its bounce slot. */
+STATIC void lpc_txqueue_pbuf(lpc_enetdata_t *lpc_enetif, struct pbuf *p, u32_t dn, u32_t txtime)
 {
-	lpc_enetdata_t *lpc_enetif = netif->state;
 	struct pbuf *q;
+	u8_t *payload;
+	u32_t idx, len;
+
+	/* Get free TX buffer index */
+	idx = Chip_ENET_GetTXProduceIndex(LPC_ETHERNET);
+
+	/* Setup transfers */
+	q = p;
+	while (dn > 0) {
+		dn--;
+		payload = (u8_t *) q->payload;
+		len = q->len;
 
 #if LPC_TX_PBUF_BOUNCE_EN == 1
-	u8_t *dst;
-	struct pbuf *np;
+		/* Only fragments the DMA cannot read (see lpc_packet_addr_notsafe())
+		   are copied, into the bounce slot that belongs to this descriptor,
+		   or the whole chain when it has just the one descriptor. The slot
+		   is free again once the descriptor has been reclaimed. */
+		if ((q == p) && (dn == 0) && (p->next != NULL)) {
+			len = pbuf_copy_partial(p, lpc_txbounce[idx], ENET_ETH_MAX_FLEN, 0);
+			payload = lpc_txbounce[idx];
+
+			lpc_enetif->stats.tx_bounce_segs += pbuf_clen(p);
+			lpc_enetif->stats.tx_bounce_bytes += len;
+		}
+		else if (lpc_packet_addr_notsafe(payload)) {
+			MEMCPY(lpc_txbounce[idx], payload, len);
+			payload = lpc_txbounce[idx];
+
+			lpc_enetif->stats.tx_bounce_segs++;
+			lpc_enetif->stats.tx_bounce_bytes += len;
+		}
 #endif
-	u32_t idx;
-	u32_t dn, notdmasafe = 0;
 
-	/* Zero-copy TX buffers may be fragmented across mutliple payload
-	   chains. Determine the number of descriptors needed for the
-	   transfer. The pbuf chaining can be a mess! */
-	dn = (u32_t) pbuf_clen(p);
+		/* Only save pointer to free on last descriptor */
+		if (dn == 0) {
+			/* Save size of packet and signal it's ready */
+			lpc_enetif->ptxd[idx].Control = ENET_TCTRL_SIZE(len) | ENET_TCTRL_INT |
+											ENET_TCTRL_LAST;
+			lpc_enetif->txb[idx] = p;
+			lpc_enetif->txtime[idx] = txtime;
+		}
+		else {
+			/* Save size of packet, descriptor is not last */
+			lpc_enetif->ptxd[idx].Control = ENET_TCTRL_SIZE(len) | ENET_TCTRL_INT;
+			lpc_enetif->txb[idx] = NULL;
+		}
+
+		LWIP_DEBUGF(EMAC_DEBUG | LWIP_DBG_TRACE,
+					("lpc_txqueue_pbuf: pbuf packet(%p) sent, chain#=%d,"
+					 " size = %d (index=%d)\n", payload, dn, len, idx));
+
+		lpc_enetif->ptxd[idx].Packet = (u32_t) payload;
+
+		q = q->next;
+
+		idx = Chip_ENET_IncTXProduceIndex(LPC_ETHERNET);
+	}
+
+	LINK_STATS_INC(link.xmit);
+}
+
+#if LPC_TX_NONBLOCK == 1
+/* Moves frames waiting in the TX queue onto free descriptors */
+STATIC void lpc_tx_flush(lpc_enetdata_t *lpc_enetif)
+{
+	struct pbuf *p;
+	u32_t dn;
+
+#if NO_SYS == 0
+	/* Get exclusive access */
+	sys_mutex_lock(&lpc_enetif->tx_lock_mutex);
+#endif
+
+	while (lpc_enetif->txq_count > 0) {
+		p = lpc_enetif->txq[lpc_enetif->txq_head];
+		dn = lpc_tx_descs(p);
+		if (dn > (u32_t) lpc_tx_ready(lpc_enetif->pnetif)) {
+			break;
+		}
+
+		/* The queue's reference now belongs to the descriptors */
+		lpc_txqueue_pbuf(lpc_enetif, p, dn, lpc_enetif->txq_time[lpc_enetif->txq_head]);
+		lpc_enetif->txq[lpc_enetif->txq_head] = NULL;
+		lpc_enetif->txq_head = (lpc_enetif->txq_head + 1) % LPC_TX_QUEUE_LEN;
+		lpc_enetif->txq_count--;
+	}
+
+#if NO_SYS == 0
+	/* Restore access */
+	sys_mutex_unlock(&lpc_enetif->tx_lock_mutex);
+#endif
+}
+
+#endif
+
+/* Low level output of a packet. Never call this from an interrupt context,
+ * as it may block until TX descriptors become available. With
+ * LPC_TX_NONBLOCK, it queues the packet instead and never blocks. */
+STATIC err_t lpc_low_level_output(struct netif *netif, struct pbuf *p)
+{
+	lpc_enetdata_t *lpc_enetif = netif->state;
+	err_t err = ERR_OK;
+	u32_t dn, now = sys_now();
+
+#if LPC_TX_PBUF_BOUNCE_EN == 0
+	struct pbuf *q;
+	u32_t notdmasafe = 0;
 
 	/* Test to make sure packet addresses are DMA safe. A DMA safe
 	   address is once that uses external memory or periphheral RAM.
@@ -420,62 +655,78 @@ STATIC err_t lpc_low_level_output(struct netif *netif, struct pbuf *p)
 	for (q = p; q != NULL; q = q->next) {
 		notdmasafe += lpc_packet_addr_notsafe(q->payload);
 	}
+	LWIP_ASSERT("lpc_low_level_output: Not a DMA safe pbuf",
+				(notdmasafe == 0));
+#endif
 
-#if LPC_TX_PBUF_BOUNCE_EN == 1
-	/* If the pbuf is not DMA safe, a new bounce buffer (pbuf) will be
-	   created that will be used instead. This requires an copy from the
-	   non-safe DMA region to the new pbuf */
-	if (notdmasafe) {
-		/* Allocate a pbuf in DMA memory */
-		np = pbuf_alloc(PBUF_RAW, p->tot_len, PBUF_RAM);
-		if (np == NULL) {
-			LWIP_DEBUGF(EMAC_DEBUG | LWIP_DBG_TRACE,
-						("lpc_low_level_output: could not allocate TX pbuf\n"));
-			return ERR_MEM;
-		}
+	/* Zero-copy TX buffers may be fragmented across mutliple payload
+	   chains. Determine the number of descriptors needed for the
+	   transfer. The pbuf chaining can be a mess! */
+	dn = lpc_tx_descs(p);
 
-		/* This buffer better be contiguous! */
-		LWIP_ASSERT("lpc_low_level_output: New transmit pbuf is chained",
-					(pbuf_clen(np) == 1));
+	/* Without bounce slots, a chain longer than the ring would wait for
+	   descriptors forever */
+	if (dn == 0) {
+		LWIP_DEBUGF(EMAC_DEBUG | LWIP_DBG_TRACE,
+					("lpc_low_level_output: pbuf chain too long (%d)\n", pbuf_clen(p)));
+		LINK_STATS_INC(link.drop);
+		return ERR_BUF;
+	}
 
-		/* Copy to DMA safe pbuf */
-		dst = (u8_t *) np->payload;
-		for (q = p; q != NULL; q = q->next) {
-			/* Copy the buffer to the descriptor's buffer */
-			MEMCPY(dst, (u8_t *) q->payload, q->len);
-			dst += q->len;
-		}
-		np->len = p->tot_len;
+#if LPC_TX_NONBLOCK == 1
+#if NO_SYS == 0
+	/* Get exclusive access */
+	sys_mutex_lock(&lpc_enetif->tx_lock_mutex);
+#endif
 
-		LWIP_DEBUGF(EMAC_DEBUG | LWIP_DBG_TRACE,
-					("lpc_low_level_output: Switched to DMA safe buffer, old=%p, new=%p\n",
-					 q, np));
+	/* Prevent LWIP from de-allocating this pbuf. The driver will
+	   free it once it's been transmitted. */
+	if ((lpc_enetif->txq_count == 0) && (dn <= (u32_t) lpc_tx_ready(netif))) {
+		pbuf_ref(p);
+		lpc_txqueue_pbuf(lpc_enetif, p, dn, now);
+	}
+	else if (lpc_enetif->txq_count < LPC_TX_QUEUE_LEN) {
+		u32_t tail = (lpc_enetif->txq_head + lpc_enetif->txq_count) % LPC_TX_QUEUE_LEN;
 
-		/* use the new buffer for descrptor queueing. The original pbuf will
-		   be de-allocated outsuide this driver. */
-		p = np;
-		dn = 1;
+		/* Hold the packet, in order, until lpc_tx_reclaim() frees
+		   enough descriptors. Its latency counts from now. */
+		pbuf_ref(p);
+		lpc_enetif->txq[tail] = p;
+		lpc_enetif->txq_time[tail] = now;
+		lpc_enetif->txq_count++;
+		lpc_enetif->stats.tx_stalls++;
 	}
-#else
-	if (notdmasafe) {
-		LWIP_ASSERT("lpc_low_level_output: Not a DMA safe pbuf",
-					(notdmasafe == 0));
+	else {
+		LINK_STATS_INC(link.drop);
+		lpc_enetif->stats.tx_qdrops++;
+		err = ERR_WOULDBLOCK;
 	}
+
+#if NO_SYS == 0
+	/* Restore access */
+	sys_mutex_unlock(&lpc_enetif->tx_lock_mutex);
 #endif
 
+#else
 	/* Wait until enough descriptors are available for the transfer. */
 	/* THIS WILL BLOCK UNTIL THERE ARE ENOUGH DESCRIPTORS AVAILABLE */
-	while (dn > lpc_tx_ready(netif)) {
+	if (dn > (u32_t) lpc_tx_ready(netif)) {
+		lpc_enetif->stats.tx_stalls++;
+	}
+	while (dn > (u32_t) lpc_tx_ready(netif)) {
 #if NO_SYS == 0
 		xSemaphoreTake(lpc_enetif->xtx_count_sem, 0);
+#else
+#if defined(LPC_EMAC_SIM)
+		lpc_emac_sim_txdma();
 #else
 		msDelay(1);
+#endif
+		/* Without the cleanup task, nothing else reclaims descriptors */
+		lpc_tx_reclaim_st(lpc_enetif, Chip_ENET_GetTXConsumeIndex(LPC_ETHERNET));
 #endif
 	}
 
-	/* Get free TX buffer index */
-	idx = Chip_ENET_GetTXProduceIndex(LPC_ETHERNET);
-
 #if NO_SYS == 0
 	/* Get exclusive access */
 	sys_mutex_lock(&lpc_enetif->tx_lock_mutex);
@@ -483,47 +734,16 @@ STATIC err_t lpc_low_level_output(struct netif *netif, struct pbuf *p)
 
 	/* Prevent LWIP from de-allocating this pbuf. The driver will
 	   free it once it's been transmitted. */
-	if (!notdmasafe) {
-		pbuf_ref(p);
-	}
-
-	/* Setup transfers */
-	q = p;
-	while (dn > 0) {
-		dn--;
-
-		/* Only save pointer to free on last descriptor */
-		if (dn == 0) {
-			/* Save size of packet and signal it's ready */
-			lpc_enetif->ptxd[idx].Control = ENET_TCTRL_SIZE(q->len) | ENET_TCTRL_INT |
-											ENET_TCTRL_LAST;
-			lpc_enetif->txb[idx] = p;
-		}
-		else {
-			/* Save size of packet, descriptor is not last */
-			lpc_enetif->ptxd[idx].Control = ENET_TCTRL_SIZE(q->len) | ENET_TCTRL_INT;
-			lpc_enetif->txb[idx] = NULL;
-		}
-
-		LWIP_DEBUGF(EMAC_DEBUG | LWIP_DBG_TRACE,
-					("lpc_low_level_output: pbuf packet(%p) sent, chain#=%d,"
-					 " size = %d (index=%d)\n", q->payload, dn, q->len, idx));
-
-		lpc_enetif->ptxd[idx].Packet = (u32_t) q->payload;
-
-		q = q->next;
-
-		idx = Chip_ENET_IncTXProduceIndex(LPC_ETHERNET);
-	}
-
-	LINK_STATS_INC(link.xmit);
+	pbuf_ref(p);
+	lpc_txqueue_pbuf(lpc_enetif, p, dn, now);
 
 #if NO_SYS == 0
 	/* Restore access */
 	sys_mutex_unlock(&lpc_enetif->tx_lock_mutex);
 #endif
+#endif /* LPC_TX_NONBLOCK */
 
-	return ERR_OK;
+	return err;
 }
 
 #if NO_SYS == 0
@@ -536,10 +756,17 @@ STATIC void vPacketReceiveTask(void *pvParameters)
 		/* Wait for receive task to wakeup */
 		sys_arch_sem_wait(&lpc_enetif->rx_sem, 0);
 
+#if LPC_RX_POLL == 1
+		/* Poll until the ring is drained, which unmasks RX again */
+		while (lpc_enetif->rx_poll_pending) {
+			lpc_enetif_poll(lpc_enetif->pnetif, LPC_RX_POLL_BUDGET);
+		}
+#else
 		/* Process packets until all empty */
 		while (!Chip_ENET_IsRxEmpty(LPC_ETHERNET)) {
 			lpc_enetif_input(lpc_enetif->pnetif);
 		}
+#endif
 	}
 }
 
@@ -598,6 +825,10 @@ STATIC err_t low_level_init(struct netif *netif)
 	lpc_enetdata_t *lpc_enetif = netif->state;
 	err_t err = ERR_OK;
 
+#if defined(LPC_EMAC_SIM)
+	/* No clocks or PHY to bring up, the link is managed by the host */
+	memset(LPC_ETHERNET, 0, sizeof(*LPC_ETHERNET));
+#else
 #if defined(USE_RMII)
 	Chip_ENET_Init(LPC_ETHERNET, true);
 
@@ -616,6 +847,7 @@ STATIC err_t low_level_init(struct netif *netif)
 		return ERROR;
 	}
 #endif
+#endif /* LPC_EMAC_SIM */
 
 	/* Save station address */
 	Chip_ENET_SetADDR(LPC_ETHERNET, netif->hwaddr);
@@ -632,12 +864,25 @@ STATIC err_t low_level_init(struct netif *netif)
 #if IP_SOF_BROADCAST_RECV
 	Chip_ENET_EnableRXFilter(LPC_ETHERNET, ENET_RXFILTERCTRL_APE | ENET_RXFILTERCTRL_ABE);
 #else
-	Chip_ENET_EnableRXFilter(ENET_RXFILTERCTRL_APE);
+	Chip_ENET_EnableRXFilter(LPC_ETHERNET, ENET_RXFILTERCTRL_APE);
 #endif
 
 	/* Clear and enable rx/tx interrupts */
 	Chip_ENET_EnableInt(LPC_ETHERNET, RXINTGROUP | TXINTGROUP);
 
+#if LPC_RX_HOLDOFF_US > 0
+	/* One-shot holdoff timer, started by lpc_rx_unmask() */
+	Chip_RIT_Init(LPC_RITIMER);
+	Chip_RIT_SetCOMPVAL(LPC_RITIMER, (Chip_Clock_GetPeripheralClockRate(SYSCTL_PCLK_RIT) / 1000000) *
+						LPC_RX_HOLDOFF_US);
+	Chip_RIT_EnableCTRL(LPC_RITIMER, RIT_CTRL_ENCLR);
+	Chip_RIT_Disable(LPC_RITIMER);
+	NVIC_EnableIRQ(RITIMER_IRQn);
+#endif
+#if NO_SYS == 1 && LPC_RX_POLL == 1 && !defined(LPC_EMAC_SIM)
+	NVIC_EnableIRQ(ETHERNET_IRQn);
+#endif
+
 	/* Enable RX and TX */
 	Chip_ENET_TXEnable(LPC_ETHERNET);
 	Chip_ENET_RXEnable(LPC_ETHERNET);
@@ -686,6 +931,10 @@ s32_t lpc_rx_queue(struct netif *netif)
 		LWIP_ASSERT("lpc_rx_queue: pbuf is not contiguous (chained)",
 					pbuf_clen(p) <= 1);
 
+#ifdef LPC_EMAC_SIM
+		lpc_emac_sim_stats.rx_allocs++;
+#endif
+
 		/* Queue packet */
 		lpc_rxqueue_pbuf(lpc_enetif, p);
 
@@ -699,8 +948,6 @@ s32_t lpc_rx_queue(struct netif *netif)
 /* Attempt to read a packet from the EMAC interface */
 void lpc_enetif_input(struct netif *netif)
 {
-	struct eth_hdr *ethhdr;
-
 	struct pbuf *p;
 
 	/* move received packet into a new pbuf */
@@ -709,36 +956,150 @@ void lpc_enetif_input(struct netif *netif)
 		return;
 	}
 
-	/* points to packet payload, which starts with an Ethernet header */
-	ethhdr = p->payload;
+	lpc_enetif_deliver(netif, p);
+}
 
-	switch (htons(ethhdr->type)) {
-	case ETHTYPE_IP:
-	case ETHTYPE_ARP:
-#if PPPOE_SUPPORT
-	case ETHTYPE_PPPOEDISC:
-	case ETHTYPE_PPPOE:
-#endif /* PPPOE_SUPPORT */
-		/* full packet send to tcpip_thread to process */
-		if (netif->input(p, netif) != ERR_OK) {
-			LWIP_DEBUGF(NETIF_DEBUG, ("lpc_enetif_input: IP input error\n"));
-			/* Free buffer */
-			pbuf_free(p);
+#if LPC_RX_POLL == 1
+/* Budgeted receive after an RX interrupt */
+s32_t lpc_enetif_poll(struct netif *netif, s32_t budget)
+{
+	lpc_enetdata_t *lpc_enetif = netif->state;
+	struct pbuf *frames[LPC_NUM_BUFF_RXDESCS];
+	struct pbuf *p;
+	u32_t idx, pidx, now;
+	s32_t n, i;
+
+	/* IRQ rate over one second windows */
+	now = sys_now();
+	if ((now - lpc_enetif->rx_rate_ms) >= 1000) {
+		lpc_enetif->stats.rx_irqs_per_sec = lpc_enetif->stats.rx_irqs - lpc_enetif->rx_rate_irqs;
+		lpc_enetif->rx_rate_irqs = lpc_enetif->stats.rx_irqs;
+		lpc_enetif->rx_rate_ms = now;
+	}
+
+	if (!lpc_enetif->rx_poll_pending) {
+		return 0;
+	}
+
+	/* The single frame path does the RX overrun recovery */
+	if (Chip_ENET_GetIntStatus(LPC_ETHERNET) & ENET_INT_RXOVERRUN) {
+		lpc_low_level_input(netif);
+	}
+
+	if (budget > LPC_NUM_BUFF_RXDESCS) {
+		budget = LPC_NUM_BUFF_RXDESCS;
+	}
+
+	/* Take the received frames off their descriptors. The descriptors stay
+	   with the driver until the consume index moves past them. */
+	n = 0;
+	idx = Chip_ENET_GetRXConsumeIndex(LPC_ETHERNET);
+	pidx = Chip_ENET_GetRXProduceIndex(LPC_ETHERNET);
+	while ((idx != pidx) && (n < budget)) {
+		p = lpc_enetif->rxb[idx];
+		lpc_enetif->rxb[idx] = NULL;
+		lpc_enetif->rx_free_descs++;
+
+		if (lpc_enetif->prxs[idx].StatusInfo & (ENET_RINFO_CRC_ERR |
+												ENET_RINFO_SYM_ERR | ENET_RINFO_ALIGN_ERR | ENET_RINFO_LEN_ERR)) {
+#if LINK_STATS
+			if (lpc_enetif->prxs[idx].StatusInfo & (ENET_RINFO_CRC_ERR |
+													ENET_RINFO_SYM_ERR | ENET_RINFO_ALIGN_ERR)) {
+				LINK_STATS_INC(link.chkerr);
+			}
+			if (lpc_enetif->prxs[idx].StatusInfo & ENET_RINFO_LEN_ERR) {
+				LINK_STATS_INC(link.lenerr);
+			}
+#endif
+
+			/* Drop the frame and re-queue the pbuf for receive */
+			LINK_STATS_INC(link.drop);
+			lpc_rxqueue_pbuf(lpc_enetif, p);
+			p = NULL;
 		}
-		break;
+		else {
+			/* Zero-copy, size without the FCS */
+			p->len = p->tot_len = (u16_t) (ENET_RINFO_SIZE(lpc_enetif->prxs[idx].StatusInfo) - 4);
+		}
+		frames[n++] = p;
 
-	default:
-		/* Return buffer */
-		pbuf_free(p);
-		break;
+		idx++;
+		if (idx >= LPC_NUM_BUFF_RXDESCS) {
+			idx = 0;
+		}
+	}
+
+	/* Refill the whole batch at once. Frames that could not get a new
+	   buffer are dropped and their pbuf goes back on the ring. */
+	lpc_rx_queue(netif);
+	for (i = n - 1; (i >= 0) && (lpc_enetif->rx_free_descs > 0); i--) {
+		if (frames[i] != NULL) {
+			lpc_rxqueue_pbuf(lpc_enetif, frames[i]);
+			frames[i] = NULL;
+			LINK_STATS_INC(link.drop);
+		}
+	}
+
+	/* Hand the refilled descriptors back to the EMAC */
+	for (i = 0; i < n; i++) {
+		Chip_ENET_IncRXConsumeIndex(LPC_ETHERNET);
+	}
+
+	for (i = 0; i < n; i++) {
+		if (frames[i] != NULL) {
+			LINK_STATS_INC(link.recv);
+			lpc_enetif_deliver(netif, frames[i]);
+		}
 	}
+
+	lpc_enetif->stats.rx_polls++;
+	lpc_enetif->stats.rx_poll_frames += n;
+	if (n == budget) {
+		lpc_enetif->stats.rx_poll_full++;
+		return n;
+	}
+
+	/* The ring looks drained. Clear the RX status before the final check,
+	   so a frame that arrives after it raises the interrupt again as soon
+	   as RX is unmasked. */
+	Chip_ENET_ClearIntStatus(LPC_ETHERNET, RXINTGROUP & ~ENET_INT_RXOVERRUN);
+	if (Chip_ENET_IsRxEmpty(LPC_ETHERNET)) {
+		lpc_enetif->rx_poll_pending = 0;
+		lpc_rx_unmask();
+	}
+
+	return n;
 }
 
+/* Tells if an RX poll is scheduled */
+s32_t lpc_enetif_poll_pending(struct netif *netif)
+{
+	return ((lpc_enetdata_t *) netif->state)->rx_poll_pending != 0;
+}
+
+#if LPC_RX_HOLDOFF_US > 0
+/**
+ * @brief	RI timer interrupt handler, ends the RX interrupt holdoff
+ * @return	Nothing
+ */
+void RIT_IRQHandler(void)
+{
+	Chip_RIT_Disable(LPC_RITIMER);
+	Chip_RIT_ClearInt(LPC_RITIMER);
+	Chip_ENET_EnableInt(LPC_ETHERNET, RXINTGROUP);
+}
+
+#endif
+#endif
+
 /* Call for freeing TX buffers that are complete */
 void lpc_tx_reclaim(struct netif *netif)
 {
 	lpc_tx_reclaim_st((lpc_enetdata_t *) netif->state,
 					  Chip_ENET_GetTXConsumeIndex(LPC_ETHERNET));
+#if LPC_TX_NONBLOCK == 1
+	lpc_tx_flush((lpc_enetdata_t *) netif->state);
+#endif
 }
 
 /* Polls if an available TX descriptor is ready */
@@ -746,7 +1107,10 @@ s32_t lpc_tx_ready(struct netif *netif)
 {
 	u32_t pidx, cidx;
 
-	cidx = Chip_ENET_GetTXConsumeIndex(LPC_ETHERNET);
+	/* A descriptor the EMAC has sent still holds its pbuf until
+	   lpc_tx_reclaim_st() frees it, so count from the reclaim index
+	   rather than the consume index */
+	cidx = ((lpc_enetdata_t *) netif->state)->lpc_last_tx_idx;
 	pidx = Chip_ENET_GetTXProduceIndex(LPC_ETHERNET);
 
 	return Chip_ENET_GetFreeDescNum(LPC_ETHERNET, pidx, cidx, LPC_NUM_BUFF_TXDESCS);
@@ -760,18 +1124,35 @@ s32_t lpc_tx_ready(struct netif *netif)
  */
 void ETH_IRQHandler(void)
 {
-#if NO_SYS == 1
+#if NO_SYS == 1 && LPC_RX_POLL == 0
 	/* Interrupts are not used without an RTOS */
 	NVIC_DisableIRQ(ETHERNET_IRQn);
 #else
+#if NO_SYS == 0
 	signed portBASE_TYPE xRecTaskWoken = pdFALSE, XTXTaskWoken = pdFALSE;
+#endif
 	uint32_t ints;
 
 	/* Interrupts are of 2 groups - transmit or receive. Based on the
 	   interrupt, kick off the receive or transmit (cleanup) task */
 
-	/* Get pending interrupts */
-	ints = Chip_ENET_GetIntStatus(LPC_ETHERNET);
+	/* Get pending interrupts. A masked source still shows in the status,
+	   such as RX while lpc_enetif_poll() owns the ring, so leave those
+	   alone. */
+	ints = Chip_ENET_GetIntStatus(LPC_ETHERNET) & LPC_ETHERNET->MODULE_CONTROL.INTENABLE;
+
+#if LPC_RX_POLL == 1
+	if (ints & RXINTGROUP) {
+		/* Mask RX until lpc_enetif_poll() has drained the ring. An overrun
+		   stays pending for the poll to recover from. */
+		Chip_ENET_DisableInt(LPC_ETHERNET, RXINTGROUP);
+		ints &= ~ENET_INT_RXOVERRUN;
+		lpc_enetdata.rx_poll_pending = 1;
+		lpc_enetdata.stats.rx_irqs++;
+	}
+#endif
+
+#if NO_SYS == 0
 
 	if (ints & RXINTGROUP) {
 		/* RX group interrupt(s) */
@@ -787,12 +1168,22 @@ void ETH_IRQHandler(void)
 		xSemaphoreGiveFromISR(lpc_enetdata.tx_clean_sem, &XTXTaskWoken);
 	}
 
+#endif
+
 	/* Clear pending interrupts */
 	Chip_ENET_ClearIntStatus(LPC_ETHERNET, ints);
 
+#if NO_SYS == 0
 	/* Context switch needed? */
 	portEND_SWITCHING_ISR(xRecTaskWoken || XTXTaskWoken);
 #endif
+#endif
+}
+
+/* Returns the driver counters */
+const lpc_enetstats_t *lpc_enetif_stats(struct netif *netif)
+{
+	return &((lpc_enetdata_t *) netif->state)->stats;
 }
 
 /* Set up the MAC interface duplex */
@@ -827,7 +1218,11 @@ err_t lpc_enetif_init(struct netif *netif)
 	lpc_enetdata.pnetif = netif;
 
 	/* set MAC hardware address */
+#ifdef LPC_EMAC_SIM
+	memcpy(netif->hwaddr, lpc_emac_sim_hwaddr, sizeof(lpc_emac_sim_hwaddr));
+#else
 	Board_ENET_GetMacADDR(netif->hwaddr);
+#endif
 	netif->hwaddr_len = ETHARP_HWADDR_LEN;
 
 	/* maximum transfer unit */
@@ -0,0 +1,396 @@
+/*
+ * @brief Host (Linux) simulation of the LPC17xx/40xx EMAC for LWIP
+ *
+ * @note
+ * Only built when LPC_EMAC_SIM is defined. See lpc_emac_sim.h.
+ */
+
+#include "lwip/opt.h"
+
+#ifdef LPC_EMAC_SIM
+
+#include "lwip/def.h"
+#include "arch/lpc_emac_sim.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <net/if.h>
+#include <linux/if_tun.h>
+
+extern void ETH_IRQHandler(void);
+
+/** @ingroup NET_LWIP_LPC_EMAC_SIM
+ * @{
+ */
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Classic libpcap file format */
+#define PCAP_MAGIC          0xa1b2c3d4
+#define PCAP_MAGIC_SWAPPED  0xd4c3b2a1
+#define PCAP_LINKTYPE_ETH   1
+
+typedef struct {
+	u32_t magic;
+	u16_t version_major;
+	u16_t version_minor;
+	s32_t thiszone;
+	u32_t sigfigs;
+	u32_t snaplen;
+	u32_t network;
+} pcap_filehdr_t;
+
+typedef struct {
+	u32_t ts_sec;
+	u32_t ts_usec;
+	u32_t incl_len;
+	u32_t orig_len;
+} pcap_rechdr_t;
+
+/* Frame source and sink */
+static int tap_fd = -1;
+static FILE *pcap_fp;
+static int pcap_swapped, pcap_loop;
+
+/* Frame read from the source but not yet accepted by a descriptor */
+static u8_t rx_frame[ENET_ETH_MAX_FLEN];
+static int rx_frame_len;
+
+/* Frame gathered from TX descriptors */
+static u8_t tx_frame[ENET_ETH_MAX_FLEN];
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+LPC_ENET_T lpc_emac_sim_regs;
+LPC_EMAC_SIM_STATS_T lpc_emac_sim_stats;
+u8_t lpc_emac_sim_hwaddr[6] = {0x02, 0x00, 0x4c, 0x50, 0x43, 0x01};
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* Write a register the driver can only read */
+#define SIM_REG(r) (*(volatile uint32_t *) &(r))
+
+static u32_t pcap_u32(u32_t v)
+{
+	if (pcap_swapped) {
+		v = (v >> 24) | ((v >> 8) & 0xff00) | ((v << 8) & 0xff0000) | (v << 24);
+	}
+	return v;
+}
+
+/* Apply the side effects of the reset and interrupt clear registers */
+static void sim_apply_writes(void)
+{
+	LPC_ENET_T *pENET = &lpc_emac_sim_regs;
+
+	if (pENET->MAC.MAC1 & ENET_MAC1_RESETRX) {
+		pENET->MAC.MAC1 &= ~ENET_MAC1_RESETRX;
+		pENET->CONTROL.RX.PRODUCEINDEX = 0;
+		rx_frame_len = 0;
+	}
+	if (pENET->MAC.MAC1 & ENET_MAC1_RESETTX) {
+		pENET->MAC.MAC1 &= ~ENET_MAC1_RESETTX;
+		pENET->CONTROL.TX.CONSUMEINDEX = 0;
+	}
+	if (pENET->MODULE_CONTROL.INTCLEAR) {
+		SIM_REG(pENET->MODULE_CONTROL.INTSTATUS) &= ~pENET->MODULE_CONTROL.INTCLEAR;
+		pENET->MODULE_CONTROL.INTCLEAR = 0;
+	}
+}
+
+/* Read the next frame from the capture, 0 at end of file */
+static int pcap_read(u8_t *buf, int size)
+{
+	pcap_rechdr_t rec;
+	u32_t len;
+
+	while (1) {
+		if (fread(&rec, sizeof(rec), 1, pcap_fp) != 1) {
+			if (!pcap_loop || fseek(pcap_fp, sizeof(pcap_filehdr_t), SEEK_SET) != 0) {
+				return 0;
+			}
+			if (fread(&rec, sizeof(rec), 1, pcap_fp) != 1) {
+				return 0;	/* Empty capture */
+			}
+		}
+
+		len = pcap_u32(rec.incl_len);
+		if (len <= (u32_t) size) {
+			if (fread(buf, 1, len, pcap_fp) != len) {
+				return 0;
+			}
+			return (int) len;
+		}
+
+		/* Oversized record, skip it */
+		lpc_emac_sim_stats.rx_toolong++;
+		if (fseek(pcap_fp, len, SEEK_CUR) != 0) {
+			return 0;
+		}
+	}
+}
+
+/* Fetch the next frame from the attached source, 0 if none, -1 at the end */
+static int sim_fetch_frame(void)
+{
+	ssize_t n;
+
+	if (tap_fd >= 0) {
+		n = read(tap_fd, rx_frame, sizeof(rx_frame));
+		if (n < 0) {
+			return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+		}
+		return (int) n;
+	}
+	if (pcap_fp != NULL) {
+		n = pcap_read(rx_frame, sizeof(rx_frame));
+		return (n > 0) ? (int) n : -1;
+	}
+	return 0;
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Attach the simulated EMAC to a Linux TAP device */
+int lpc_emac_sim_open_tap(const char *ifname)
+{
+	struct ifreq ifr;
+	int fd;
+
+	lpc_emac_sim_close();
+
+	fd = open("/dev/net/tun", O_RDWR | O_NONBLOCK);
+	if (fd < 0) {
+		return -1;
+	}
+
+	memset(&ifr, 0, sizeof(ifr));
+	ifr.ifr_flags = IFF_TAP | IFF_NO_PI;
+	strncpy(ifr.ifr_name, ifname, IFNAMSIZ - 1);
+	if (ioctl(fd, TUNSETIFF, &ifr) < 0) {
+		close(fd);
+		return -1;
+	}
+
+	tap_fd = fd;
+	memset(&lpc_emac_sim_stats, 0, sizeof(lpc_emac_sim_stats));
+	return 0;
+}
+
+/* Attach the simulated EMAC to a pcap capture file */
+int lpc_emac_sim_open_pcap(const char *filename, int loop)
+{
+	pcap_filehdr_t hdr;
+	FILE *fp;
+
+	lpc_emac_sim_close();
+
+	fp = fopen(filename, "rb");
+	if (fp == NULL) {
+		return -1;
+	}
+	if (fread(&hdr, sizeof(hdr), 1, fp) != 1 ||
+		(hdr.magic != PCAP_MAGIC && hdr.magic != PCAP_MAGIC_SWAPPED)) {
+		fclose(fp);
+		return -1;
+	}
+
+	pcap_swapped = (hdr.magic == PCAP_MAGIC_SWAPPED);
+	if (pcap_u32(hdr.network) != PCAP_LINKTYPE_ETH) {
+		fclose(fp);
+		return -1;
+	}
+
+	pcap_fp = fp;
+	pcap_loop = loop;
+	memset(&lpc_emac_sim_stats, 0, sizeof(lpc_emac_sim_stats));
+	return 0;
+}
+
+/* Detach the simulated EMAC */
+void lpc_emac_sim_close(void)
+{
+	if (tap_fd >= 0) {
+		close(tap_fd);
+		tap_fd = -1;
+	}
+	if (pcap_fp != NULL) {
+		fclose(pcap_fp);
+		pcap_fp = NULL;
+	}
+	rx_frame_len = 0;
+}
+
+/* Run the simulated transmit DMA */
+int lpc_emac_sim_txdma(void)
+{
+	LPC_ENET_T *pENET = &lpc_emac_sim_regs;
+	ENET_TXDESC_T *pdesc;
+	ENET_TXSTAT_T *pstat;
+	u32_t idx, last, num, len, size;
+	int sent = 0;
+
+	sim_apply_writes();
+	if (!(pENET->CONTROL.COMMAND & ENET_COMMAND_TXENABLE)) {
+		return 0;
+	}
+
+	pdesc = (ENET_TXDESC_T *) (uintptr_t) pENET->CONTROL.TX.DESCRIPTOR;
+	pstat = (ENET_TXSTAT_T *) (uintptr_t) pENET->CONTROL.TX.STATUS;
+	num = pENET->CONTROL.TX.DESCRIPTORNUMBER + 1;
+
+	while (pENET->CONTROL.TX.CONSUMEINDEX != pENET->CONTROL.TX.PRODUCEINDEX) {
+		/* Only start a frame once all of its descriptors are queued */
+		idx = pENET->CONTROL.TX.CONSUMEINDEX;
+		while (!(pdesc[idx].Control & ENET_TCTRL_LAST)) {
+			idx = (idx + 1) % num;
+			if (idx == pENET->CONTROL.TX.PRODUCEINDEX) {
+				return sent;
+			}
+		}
+		last = idx;
+
+		/* Gather the fragments and complete their descriptors */
+		len = 0;
+		idx = pENET->CONTROL.TX.CONSUMEINDEX;
+		while (1) {
+			size = (pdesc[idx].Control & 0x7FF) + 1;
+			if (len + size <= sizeof(tx_frame)) {
+				memcpy(&tx_frame[len], (void *) (uintptr_t) pdesc[idx].Packet, size);
+			}
+			len += size;
+			pstat[idx].StatusInfo = 0;
+			lpc_emac_sim_stats.tx_descs++;
+			if (idx == last) {
+				break;
+			}
+			idx = (idx + 1) % num;
+		}
+		pENET->CONTROL.TX.CONSUMEINDEX = (last + 1) % num;
+
+		if (len <= sizeof(tx_frame)) {
+			if ((tap_fd >= 0) && (write(tap_fd, tx_frame, len) != (ssize_t) len)) {
+				SIM_REG(pENET->MODULE_CONTROL.INTSTATUS) |= ENET_INT_TXERROR;
+			}
+			lpc_emac_sim_stats.tx_frames++;
+			lpc_emac_sim_stats.tx_bytes += len;
+		}
+		else {
+			pstat[last].StatusInfo = ENET_TINFO_ERR;
+			SIM_REG(pENET->MODULE_CONTROL.INTSTATUS) |= ENET_INT_TXERROR;
+		}
+		SIM_REG(pENET->MODULE_CONTROL.INTSTATUS) |= ENET_INT_TXDONE;
+		sent++;
+	}
+
+	SIM_REG(pENET->MODULE_CONTROL.INTSTATUS) |= ENET_INT_TXFINISHED;
+	return sent;
+}
+
+/* Run the simulated receive DMA */
+int lpc_emac_sim_rxdma(void)
+{
+	LPC_ENET_T *pENET = &lpc_emac_sim_regs;
+	ENET_RXDESC_T *pdesc;
+	ENET_RXSTAT_T *pstat;
+	u32_t idx, next, num, size;
+	int received = 0;
+
+	sim_apply_writes();
+	if (!(pENET->CONTROL.COMMAND & ENET_COMMAND_RXENABLE)) {
+		return 0;
+	}
+
+	pdesc = (ENET_RXDESC_T *) (uintptr_t) pENET->CONTROL.RX.DESCRIPTOR;
+	pstat = (ENET_RXSTAT_T *) (uintptr_t) pENET->CONTROL.RX.STATUS;
+	num = pENET->CONTROL.RX.DESCRIPTORNUMBER + 1;
+
+	while (1) {
+		if (rx_frame_len == 0) {
+			rx_frame_len = sim_fetch_frame();
+			if (rx_frame_len <= 0) {
+				if ((rx_frame_len < 0) && (received == 0)) {
+					rx_frame_len = 0;
+					return -1;
+				}
+				rx_frame_len = 0;
+				break;
+			}
+		}
+
+		/* The ring is full when produce would run into consume */
+		idx = pENET->CONTROL.RX.PRODUCEINDEX;
+		next = (idx + 1) % num;
+		if (next == pENET->CONTROL.RX.CONSUMEINDEX) {
+			/* Like the wire, a TAP frame is lost without a free
+			   descriptor. A capture frame waits for one. */
+			if (tap_fd >= 0) {
+				lpc_emac_sim_stats.rx_nodesc++;
+				rx_frame_len = 0;
+			}
+			break;
+		}
+
+		/* The EMAC stores the frame check sequence after the data */
+		size = (pdesc[idx].Control & 0x7FF) + 1;
+		if ((u32_t) rx_frame_len + 4 > size) {
+			/* Dropped; end the run here, so that a looped capture of
+			   such frames cannot keep the call going forever */
+			lpc_emac_sim_stats.rx_toolong++;
+			rx_frame_len = 0;
+			break;
+		}
+		memcpy((void *) (uintptr_t) pdesc[idx].Packet, rx_frame, rx_frame_len);
+		memset((u8_t *) (uintptr_t) pdesc[idx].Packet + rx_frame_len, 0, 4);
+
+		pstat[idx].StatusInfo = ENET_RINFO_LAST_FLAG | ((rx_frame_len + 4 - 1) & 0x7FF);
+		if (rx_frame[0] & 1) {
+			pstat[idx].StatusInfo |= (rx_frame[0] == 0xff) ? ENET_RINFO_BCAST : ENET_RINFO_MCAST;
+		}
+		pstat[idx].StatusHashCRC = 0;
+		pENET->CONTROL.RX.PRODUCEINDEX = next;
+
+		lpc_emac_sim_stats.rx_frames++;
+		lpc_emac_sim_stats.rx_bytes += rx_frame_len;
+		rx_frame_len = 0;
+		received++;
+	}
+
+	if (received) {
+		SIM_REG(pENET->MODULE_CONTROL.INTSTATUS) |= ENET_INT_RXDONE | ENET_INT_RXFINISHED;
+	}
+	return received;
+}
+
+/* Run the simulated transmit and receive DMA once */
+int lpc_emac_sim_poll(void)
+{
+	int received;
+
+	lpc_emac_sim_txdma();
+	received = lpc_emac_sim_rxdma();
+
+	if (lpc_emac_sim_regs.MODULE_CONTROL.INTSTATUS & lpc_emac_sim_regs.MODULE_CONTROL.INTENABLE) {
+		ETH_IRQHandler();
+	}
+
+	return received;
+}
+
+/**
+ * @}
+ */
+
+#endif /* LPC_EMAC_SIM */
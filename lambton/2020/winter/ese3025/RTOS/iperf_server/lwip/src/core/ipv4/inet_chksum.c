@@ -52,7 +52,7 @@
  * #define LWIP_CHKSUM <your_checksum_routine> 
  *
  * Or you can select from the implementations below by defining
- * LWIP_CHKSUM_ALGORITHM to 1, 2 or 3.
+ * LWIP_CHKSUM_ALGORITHM to 1, 2, 3 or 4.
  */
 
 #ifndef LWIP_CHKSUM
@@ -256,6 +256,138 @@ lwip_standard_chksum(void *dataptr, int len)
 }
 #endif
 
+#if (LWIP_CHKSUM_ALGORITHM == 4) || (LWIP_CHKSUM_COPY_ALGORITHM == 2)
+/** Adds a 32-bit word to a sum, with the carry out added back in */
+#define CHKSUM_ADD32(sum, w) do { \
+  u32_t w_ = (w); \
+  (sum) += w_; \
+  (sum) += ((sum) < w_); \
+} while(0)
+#endif /* (LWIP_CHKSUM_ALGORITHM == 4) || (LWIP_CHKSUM_COPY_ALGORITHM == 2) */
+
+#if (LWIP_CHKSUM_ALGORITHM == 4) /* Alternative version #4 */
+/**
+ * Adds up 32-bit words, with end-around carry, 8 at a time. On a Cortex-M3
+ * with GCC the 8 come in with two LDMs and go through an ADCS chain.
+ *
+ * @param sum the sum so far
+ * @param src the words, 4-byte aligned
+ * @param n number of words
+ * @return sum with the words added in
+ */
+static u32_t
+lwip_chksum_words(u32_t sum, const u32_t *src, int n)
+{
+#if defined(__GNUC__) && defined(__ARM_ARCH_7M__)
+  u32_t k = (u32_t)n >> 3;
+
+  if (k != 0) {
+    __asm__ (
+      "1:\n\t"
+      "ldmia  %[src]!, {r3-r6}\n\t"
+      "adds   %[sum], %[sum], r3\n\t"
+      "adcs   %[sum], %[sum], r4\n\t"
+      "adcs   %[sum], %[sum], r5\n\t"
+      "adcs   %[sum], %[sum], r6\n\t"
+      "ldmia  %[src]!, {r3-r6}\n\t"
+      "adcs   %[sum], %[sum], r3\n\t"
+      "adcs   %[sum], %[sum], r4\n\t"
+      "adcs   %[sum], %[sum], r5\n\t"
+      "adcs   %[sum], %[sum], r6\n\t"
+      /* twice: 0xffffffff plus a carry wraps to 0, and carries again */
+      "adcs   %[sum], %[sum], #0\n\t"
+      "adc    %[sum], %[sum], #0\n\t"
+      "subs   %[k], %[k], #1\n\t"
+      "bne    1b\n\t"
+      : [sum] "+r" (sum), [src] "+r" (src), [k] "+r" (k)
+      :
+      : "r3", "r4", "r5", "r6", "cc", "memory");
+    n &= 7;
+  }
+#else /* __GNUC__ && __ARM_ARCH_7M__ */
+  while (n >= 8) {
+    CHKSUM_ADD32(sum, src[0]);
+    CHKSUM_ADD32(sum, src[1]);
+    CHKSUM_ADD32(sum, src[2]);
+    CHKSUM_ADD32(sum, src[3]);
+    CHKSUM_ADD32(sum, src[4]);
+    CHKSUM_ADD32(sum, src[5]);
+    CHKSUM_ADD32(sum, src[6]);
+    CHKSUM_ADD32(sum, src[7]);
+    src += 8;
+    n -= 8;
+  }
+#endif /* __GNUC__ && __ARM_ARCH_7M__ */
+  while (n > 0) {
+    CHKSUM_ADD32(sum, *src++);
+    n--;
+  }
+  return sum;
+}
+
+/**
+ * Version #4 a word at a time: the head bytes up to a 4-byte boundary and
+ * the tail bytes are treated specially, and the bulk of the buffer is added
+ * up by lwip_chksum_words(), 32 bytes per loop.
+ *
+ * @arg start of buffer to be checksummed. May be an odd byte address.
+ * @len number of bytes in the buffer to be checksummed.
+ * @return host order (!) lwip checksum (non-inverted Internet sum)
+ */
+static u16_t
+lwip_standard_chksum(void *dataptr, int len)
+{
+  u8_t *pb = (u8_t *)dataptr;
+  u16_t t = 0;
+  u32_t sum = 0;
+  /* starts at odd byte address? */
+  int odd = ((mem_ptr_t)pb & 1);
+
+  if (odd && len > 0) {
+    ((u8_t *)&t)[1] = *pb++;
+    len--;
+  }
+
+  if (((mem_ptr_t)pb & 2) && len > 1) {
+    sum = *(u16_t *)(void *)pb;
+    pb += 2;
+    len -= 2;
+  }
+
+  sum = lwip_chksum_words(sum, (u32_t *)(void *)pb, len >> 2);
+  pb += len & ~3;
+  len &= 3;
+
+  /* make room in upper bits */
+  sum = FOLD_U32T(sum);
+
+  /* 16-bit aligned word remaining? */
+  if (len > 1) {
+    sum += *(u16_t *)(void *)pb;
+    pb += 2;
+    len -= 2;
+  }
+
+  /* dangling tail byte remaining? */
+  if (len > 0) {
+    ((u8_t *)&t)[0] = *pb;
+  }
+
+  sum += t;
+
+  /* Fold 32-bit sum to 16 bits
+     calling this twice is propably faster than if statements... */
+  sum = FOLD_U32T(sum);
+  sum = FOLD_U32T(sum);
+
+  if (odd) {
+    sum = SWAP_BYTES_IN_WORD(sum);
+  }
+
+  return (u16_t)sum;
+}
+#endif
+
 /* inet_chksum_pseudo:
  *
  * Calculates the pseudo Internet checksum used by TCP and UDP for a pbuf chain.
@@ -448,3 +580,134 @@ lwip_chksum_copy(void *dst, const void *src, u16_t len)
   return LWIP_CHKSUM(dst, len);
 }
 #endif /* (LWIP_CHKSUM_COPY_ALGORITHM == 1) */
+
+#if (LWIP_CHKSUM_COPY_ALGORITHM == 2) /* Version #2 */
+/**
+ * Copies 32-bit words and adds them up on the way, 8 at a time; the
+ * Cortex-M3 version of lwip_chksum_words() with an STM after each LDM.
+ */
+static u32_t
+lwip_chksum_copy_words(u32_t sum, u32_t *dst, const u32_t *src, int n)
+{
+#if defined(__GNUC__) && defined(__ARM_ARCH_7M__)
+  u32_t k = (u32_t)n >> 3;
+
+  if (k != 0) {
+    __asm__ (
+      "1:\n\t"
+      "ldmia  %[src]!, {r3-r6}\n\t"
+      "stmia  %[dst]!, {r3-r6}\n\t"
+      "adds   %[sum], %[sum], r3\n\t"
+      "adcs   %[sum], %[sum], r4\n\t"
+      "adcs   %[sum], %[sum], r5\n\t"
+      "adcs   %[sum], %[sum], r6\n\t"
+      "ldmia  %[src]!, {r3-r6}\n\t"
+      "stmia  %[dst]!, {r3-r6}\n\t"
+      "adcs   %[sum], %[sum], r3\n\t"
+      "adcs   %[sum], %[sum], r4\n\t"
+      "adcs   %[sum], %[sum], r5\n\t"
+      "adcs   %[sum], %[sum], r6\n\t"
+      "adcs   %[sum], %[sum], #0\n\t"
+      "adc    %[sum], %[sum], #0\n\t"
+      "subs   %[k], %[k], #1\n\t"
+      "bne    1b\n\t"
+      : [sum] "+r" (sum), [dst] "+r" (dst), [src] "+r" (src), [k] "+r" (k)
+      :
+      : "r3", "r4", "r5", "r6", "cc", "memory");
+    n &= 7;
+  }
+#else /* __GNUC__ && __ARM_ARCH_7M__ */
+  u32_t w;
+
+  while (n >= 8) {
+    dst[0] = w = src[0];
+    CHKSUM_ADD32(sum, w);
+    dst[1] = w = src[1];
+    CHKSUM_ADD32(sum, w);
+    dst[2] = w = src[2];
+    CHKSUM_ADD32(sum, w);
+    dst[3] = w = src[3];
+    CHKSUM_ADD32(sum, w);
+    dst[4] = w = src[4];
+    CHKSUM_ADD32(sum, w);
+    dst[5] = w = src[5];
+    CHKSUM_ADD32(sum, w);
+    dst[6] = w = src[6];
+    CHKSUM_ADD32(sum, w);
+    dst[7] = w = src[7];
+    CHKSUM_ADD32(sum, w);
+    dst += 8;
+    src += 8;
+    n -= 8;
+  }
+#endif /* __GNUC__ && __ARM_ARCH_7M__ */
+  while (n > 0) {
+    *dst++ = *src;
+    CHKSUM_ADD32(sum, *src++);
+    n--;
+  }
+  return sum;
+}
+
+/** Copy and checksum in one pass over the data, like version #4 of the
+ * checksum, when src and dst are the same distance from a 4-byte boundary;
+ * otherwise MEMCPY, then LWIP_CHKSUM.
+ */
+u16_t
+lwip_chksum_copy(void *dst, const void *src, u16_t len)
+{
+  u8_t *pd = (u8_t *)dst;
+  const u8_t *ps = (const u8_t *)src;
+  u16_t t = 0, w;
+  u32_t sum = 0;
+  int odd = ((mem_ptr_t)ps & 1);
+
+  if ((((mem_ptr_t)ps ^ (mem_ptr_t)pd) & 3) != 0) {
+    MEMCPY(dst, src, len);
+    return LWIP_CHKSUM(dst, len);
+  }
+
+  if (odd && len > 0) {
+    ((u8_t *)&t)[1] = *pd++ = *ps++;
+    len--;
+  }
+
+  if (((mem_ptr_t)ps & 2) && len > 1) {
+    *(u16_t *)(void *)pd = w = *(const u16_t *)(const void *)ps;
+    sum = w;
+    pd += 2;
+    ps += 2;
+    len -= 2;
+  }
+
+  sum = lwip_chksum_copy_words(sum, (u32_t *)(void *)pd,
+                               (const u32_t *)(const void *)ps, len >> 2);
+  pd += len & ~3;
+  ps += len & ~3;
+  len &= 3;
+
+  sum = FOLD_U32T(sum);
+
+  if (len > 1) {
+    *(u16_t *)(void *)pd = w = *(const u16_t *)(const void *)ps;
+    sum += w;
+    pd += 2;
+    ps += 2;
+    len -= 2;
+  }
+
+  if (len > 0) {
+    ((u8_t *)&t)[0] = *pd = *ps;
+  }
+
+  sum += t;
+  sum = FOLD_U32T(sum);
+  sum = FOLD_U32T(sum);
+
+  if (odd) {
+    sum = SWAP_BYTES_IN_WORD(sum);
+  }
+
+  return (u16_t)sum;
+}
+#endif /* (LWIP_CHKSUM_COPY_ALGORITHM == 2) */
@@ -855,7 +855,7 @@ ip_output(struct pbuf *p, ip_addr_t *src, ip_addr_t *dest,
  */
 err_t
 ip_output_hinted(struct pbuf *p, ip_addr_t *src, ip_addr_t *dest,
-          u8_t ttl, u8_t tos, u8_t proto, u8_t *addr_hint)
+          u8_t ttl, u8_t tos, u8_t proto, u16_t *addr_hint)
 {
   struct netif *netif;
   err_t err;
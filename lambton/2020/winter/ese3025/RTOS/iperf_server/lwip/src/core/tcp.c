@@ -118,6 +118,16 @@ struct tcp_pcb *tcp_tmp_pcb;
 
 u8_t tcp_active_pcbs_changed;
 
+#if TCP_PCB_HASH
+#if (TCP_PCB_HASH_SIZE & (TCP_PCB_HASH_SIZE - 1)) || (TCP_LISTEN_HASH_SIZE & (TCP_LISTEN_HASH_SIZE - 1))
+#error "TCP_PCB_HASH_SIZE and TCP_LISTEN_HASH_SIZE must be powers of 2"
+#endif
+/** Active and TIME-WAIT PCBs, by remote address and port and local port */
+static struct tcp_pcb *tcp_pcb_hash[TCP_PCB_HASH_SIZE];
+/** Listening PCBs, by local port */
+static struct tcp_pcb_listen *tcp_listen_hash[TCP_LISTEN_HASH_SIZE];
+#endif /* TCP_PCB_HASH */
+
 /** Timer counter to handle calling slow-timer from tcp_tmr() */ 
 static u8_t tcp_timer;
 static u8_t tcp_timer_ctr;
@@ -958,6 +968,7 @@ tcp_slowtmr_start:
         LWIP_ASSERT("tcp_slowtmr: first pcb == tcp_active_pcbs", tcp_active_pcbs == pcb);
         tcp_active_pcbs = pcb->next;
       }
+      TCP_HASH_RMV(&tcp_active_pcbs, pcb);
 
       if (pcb_reset) {
         tcp_rst(pcb->snd_nxt, pcb->rcv_nxt, &pcb->local_ip, &pcb->remote_ip,
@@ -1026,6 +1037,7 @@ tcp_slowtmr_start:
         LWIP_ASSERT("tcp_slowtmr: first pcb == tcp_tw_pcbs", tcp_tw_pcbs == pcb);
         tcp_tw_pcbs = pcb->next;
       }
+      TCP_HASH_RMV(&tcp_tw_pcbs, pcb);
       pcb2 = pcb;
       pcb = pcb->next;
       memp_free(MEMP_TCP_PCB, pcb2);
@@ -1528,6 +1540,139 @@ tcp_pcb_purge(struct tcp_pcb *pcb)
   }
 }
 
+#if TCP_PCB_HASH
+/** The 4-tuple table bucket of a connection. The local address is left out:
+ * there is usually only one. */
+static u16_t
+tcp_pcb_hash_index(ip_addr_t *remote_ip, u16_t remote_port, u16_t local_port)
+{
+  u32_t h = ip4_addr_get_u32(remote_ip) ^ (((u32_t)remote_port << 16) | local_port);
+
+  h ^= h >> 16;
+  h *= 0x45d9f3bUL;
+  h ^= h >> 16;
+  return (u16_t)(h & (TCP_PCB_HASH_SIZE - 1));
+}
+
+/** The local port table bucket of a port */
+#define TCP_LISTEN_HASH_INDEX(port) (((port) ^ ((port) >> 8)) & (TCP_LISTEN_HASH_SIZE - 1))
+
+/**
+ * Adds a PCB just put on one of the PCB lists to the hash table for that
+ * list, if it has one. Called by TCP_REG.
+ *
+ * @param pcbs the list the PCB was put on
+ * @param npcb the PCB
+ */
+void
+tcp_pcb_hash_add(struct tcp_pcb **pcbs, struct tcp_pcb *npcb)
+{
+  if (pcbs == &tcp_active_pcbs || pcbs == &tcp_tw_pcbs) {
+    struct tcp_pcb **bucket = &tcp_pcb_hash[tcp_pcb_hash_index(&npcb->remote_ip,
+      npcb->remote_port, npcb->local_port)];
+    npcb->hash_next = *bucket;
+    *bucket = npcb;
+  } else if (pcbs == &tcp_listen_pcbs.pcbs) {
+    struct tcp_pcb_listen *lpcb = (struct tcp_pcb_listen *)npcb;
+    struct tcp_pcb_listen **bucket = &tcp_listen_hash[TCP_LISTEN_HASH_INDEX(lpcb->local_port)];
+    lpcb->hash_next = *bucket;
+    *bucket = lpcb;
+  }
+}
+
+/**
+ * Removes a PCB just taken off one of the PCB lists from the hash table for
+ * that list, if it has one. Called by TCP_RMV.
+ *
+ * @param pcbs the list the PCB was taken off
+ * @param npcb the PCB
+ */
+void
+tcp_pcb_hash_remove(struct tcp_pcb **pcbs, struct tcp_pcb *npcb)
+{
+  if (pcbs == &tcp_active_pcbs || pcbs == &tcp_tw_pcbs) {
+    struct tcp_pcb **p = &tcp_pcb_hash[tcp_pcb_hash_index(&npcb->remote_ip,
+      npcb->remote_port, npcb->local_port)];
+    for (; *p != NULL; p = &(*p)->hash_next) {
+      if (*p == npcb) {
+        *p = npcb->hash_next;
+        break;
+      }
+    }
+  } else if (pcbs == &tcp_listen_pcbs.pcbs) {
+    struct tcp_pcb_listen *lpcb = (struct tcp_pcb_listen *)npcb;
+    struct tcp_pcb_listen **p = &tcp_listen_hash[TCP_LISTEN_HASH_INDEX(lpcb->local_port)];
+    for (; *p != NULL; p = &(*p)->hash_next) {
+      if (*p == lpcb) {
+        *p = lpcb->hash_next;
+        break;
+      }
+    }
+  }
+  npcb->hash_next = NULL;
+}
+
+/**
+ * Finds the active or TIME-WAIT PCB of a connection.
+ *
+ * @return the PCB, or NULL if there is none
+ */
+struct tcp_pcb *
+tcp_pcb_hash_lookup(ip_addr_t *remote_ip, u16_t remote_port,
+                    ip_addr_t *local_ip, u16_t local_port)
+{
+  struct tcp_pcb *pcb = tcp_pcb_hash[tcp_pcb_hash_index(remote_ip, remote_port, local_port)];
+
+  for (; pcb != NULL; pcb = pcb->hash_next) {
+    if (pcb->remote_port == remote_port &&
+       pcb->local_port == local_port &&
+       ip_addr_cmp(&(pcb->remote_ip), remote_ip) &&
+       ip_addr_cmp(&(pcb->local_ip), local_ip)) {
+      break;
+    }
+  }
+  return pcb;
+}
+
+/**
+ * Finds the listening PCB for a local address and port: one bound to the
+ * address itself, or else one bound to IP_ADDR_ANY (with SO_REUSE, the
+ * former is preferred to the latter).
+ *
+ * @return the PCB, or NULL if there is none
+ */
+struct tcp_pcb_listen *
+tcp_listen_hash_lookup(ip_addr_t *local_ip, u16_t local_port)
+{
+  struct tcp_pcb_listen *lpcb = tcp_listen_hash[TCP_LISTEN_HASH_INDEX(local_port)];
+#if SO_REUSE
+  struct tcp_pcb_listen *lpcb_any = NULL;
+#endif /* SO_REUSE */
+
+  for (; lpcb != NULL; lpcb = lpcb->hash_next) {
+    if (lpcb->local_port == local_port) {
+#if SO_REUSE
+      if (ip_addr_cmp(&(lpcb->local_ip), local_ip)) {
+        return lpcb;
+      } else if (ip_addr_isany(&(lpcb->local_ip))) {
+        lpcb_any = lpcb;
+      }
+#else /* SO_REUSE */
+      if (ip_addr_cmp(&(lpcb->local_ip), local_ip) ||
+          ip_addr_isany(&(lpcb->local_ip))) {
+        return lpcb;
+      }
+#endif /* SO_REUSE */
+    }
+  }
+#if SO_REUSE
+  return lpcb_any;
+#else /* SO_REUSE */
+  return NULL;
+#endif /* SO_REUSE */
+}
+#endif /* TCP_PCB_HASH */
+
 /**
  * Purges the PCB and removes it from a PCB list. Any delayed ACKs are sent first.
  *
@@ -60,11 +60,41 @@
 #include "lwip/pbuf.h"
 
 
+#if LWIP_TIMERS_WHEEL
+/* The timeouts are kept in a hierarchical timing wheel, with sys_timeo.time
+ * the sys_now() at which each is due. Wheel w has a slot for each value of
+ * digit w (TIMERS_BITS bits wide, counting from the lowest) of a time. A
+ * timeout sits in the wheel of the highest digit in which its time differs
+ * from timers_now, in the slot of its time's value of that digit. So the
+ * timeouts in a wheel are all due before those in any higher wheel, and the
+ * next slot along in the lowest wheel in use is the next to come due. When
+ * timers_now reaches the start of a slot, its timeouts move down to lower
+ * wheels, until in wheel 0, where a slot is a millisecond, they are due. */
+#define TIMERS_BITS     4
+#define TIMERS_SLOTS    (1 << TIMERS_BITS)
+#define TIMERS_WHEELS   (32 / TIMERS_BITS)
+/** The slot of the timeouts that are due and waiting to be called */
+#define TIMERS_DUE      (TIMERS_WHEELS * TIMERS_SLOTS)
+
+static struct sys_timeo *timers_slots[TIMERS_DUE + 1];
+/** Bit s of timers_used[w] is set while slot s of wheel w is not empty */
+static u16_t timers_used[TIMERS_WHEELS];
+/** The time up to which the wheel has been run */
+static u32_t timers_now;
+/** The pending timeouts again, by handler and argument */
+static struct sys_timeo *timers_hash[LWIP_TIMERS_HASH_SIZE];
+/** While a handler runs, the time its timeout was due, which the timeouts
+ * it sets are counted from, so a timeout that sets itself again keeps its
+ * period however late it was called */
+static u32_t timers_due;
+static u8_t timers_calling;
+#else /* LWIP_TIMERS_WHEEL */
 /** The one and only timeout list */
 static struct sys_timeo *next_timeout;
 #if NO_SYS
 static u32_t timeouts_last_time;
 #endif /* NO_SYS */
+#endif /* LWIP_TIMERS_WHEEL */
 
 #if LWIP_TCP
 /** global variable that shows if the tcp timer is currently scheduled or not */
@@ -222,6 +252,9 @@ dns_timer(void *arg)
 /** Initialize this module */
 void sys_timeouts_init(void)
 {
+#if LWIP_TIMERS_WHEEL
+  timers_now = sys_now();
+#endif /* LWIP_TIMERS_WHEEL */
 #if IP_REASSEMBLY
   sys_timeout(IP_TMR_INTERVAL, ip_reass_timer, NULL);
 #endif /* IP_REASSEMBLY */
@@ -242,12 +275,377 @@ void sys_timeouts_init(void)
   sys_timeout(DNS_TMR_INTERVAL, dns_timer, NULL);
 #endif /* LWIP_DNS */
 
-#if NO_SYS
+#if NO_SYS && !LWIP_TIMERS_WHEEL
   /* Initialise timestamp for sys_check_timeouts */
   timeouts_last_time = sys_now();
 #endif
 }
 
+#if LWIP_TIMERS_WHEEL
+
+/** Number of the highest bit set in x, which must not be 0 */
+static u8_t
+timers_msb(u32_t x)
+{
+#ifdef __GNUC__
+  return (u8_t)(31 - __builtin_clz(x));
+#else /* __GNUC__ */
+  u8_t n = 0;
+
+  while (x >>= 1) {
+    n++;
+  }
+  return n;
+#endif /* __GNUC__ */
+}
+
+/** Number of the lowest bit set in x, which must not be 0 */
+static u8_t
+timers_lsb(u32_t x)
+{
+#ifdef __GNUC__
+  return (u8_t)__builtin_ctz(x);
+#else /* __GNUC__ */
+  return timers_msb(x & (~x + 1));
+#endif /* __GNUC__ */
+}
+
+/** The timers_hash bucket of the timeouts calling handler with arg */
+static struct sys_timeo **
+timers_bucket(sys_timeout_handler handler, void *arg)
+{
+  u32_t x = (u32_t)(mem_ptr_t)handler ^ (u32_t)(mem_ptr_t)arg;
+
+  x = ((x >> 16) ^ x) * 0x45d9f3b;
+  x = (x >> 16) ^ x;
+  return &timers_hash[x % LWIP_TIMERS_HASH_SIZE];
+}
+
+/** Takes a timeout out of its timers_hash bucket */
+static void
+timers_forget(struct sys_timeo *t)
+{
+  struct sys_timeo **pt = timers_bucket(t->h, t->arg);
+
+  while (*pt != t) {
+    pt = &(*pt)->hash_next;
+  }
+  *pt = t->hash_next;
+}
+
+/** Puts a timeout in its slot for timers_now */
+static void
+timers_place(struct sys_timeo *t)
+{
+  u8_t wheel, slot;
+
+  if ((s32_t)(t->time - timers_now) <= 0) {
+    slot = TIMERS_DUE;
+  } else {
+    wheel = timers_msb(t->time ^ timers_now) / TIMERS_BITS;
+    slot = (u8_t)((t->time >> (wheel * TIMERS_BITS)) & (TIMERS_SLOTS - 1));
+    timers_used[wheel] |= (u16_t)(1 << slot);
+    slot += wheel * TIMERS_SLOTS;
+  }
+  t->slot = slot;
+  t->prev = NULL;
+  t->next = timers_slots[slot];
+  if (t->next != NULL) {
+    t->next->prev = t;
+  }
+  timers_slots[slot] = t;
+}
+
+/** Takes a timeout out of its slot */
+static void
+timers_unlink(struct sys_timeo *t)
+{
+  if (t->next != NULL) {
+    t->next->prev = t->prev;
+  }
+  if (t->prev != NULL) {
+    t->prev->next = t->next;
+  } else {
+    timers_slots[t->slot] = t->next;
+    if ((t->next == NULL) && (t->slot != TIMERS_DUE)) {
+      timers_used[t->slot / TIMERS_SLOTS] &= (u16_t)~(1 << (t->slot % TIMERS_SLOTS));
+    }
+  }
+}
+
+/**
+ * Finds the next slot to come due.
+ *
+ * @param slot set to that slot
+ * @return the time from timers_now to the start of the slot, the earliest
+ *         any timeout in it can be due; or 0 if the wheel is empty
+ */
+static u32_t
+timers_next(u8_t *slot)
+{
+  u8_t wheel, shift, s;
+  u32_t used, start;
+
+  for (wheel = 0; timers_used[wheel] == 0; wheel++) {
+    if (wheel == TIMERS_WHEELS - 1) {
+      return 0;
+    }
+  }
+  shift = wheel * TIMERS_BITS;
+  s = (u8_t)((timers_now >> shift) & (TIMERS_SLOTS - 1));
+  used = timers_used[wheel] & ~((2UL << s) - 1);
+  if (used == 0) {
+    /* only the top digit wraps around before the timeouts are due */
+    LWIP_ASSERT("timers_next: slot behind timers_now", wheel == TIMERS_WHEELS - 1);
+    used = timers_used[wheel];
+  }
+  s = timers_lsb(used);
+  *slot = (u8_t)(wheel * TIMERS_SLOTS + s);
+  start = (u32_t)s << shift;
+  if (shift + TIMERS_BITS < 32) {
+    start |= timers_now & (0xFFFFFFFFUL << (shift + TIMERS_BITS));
+  }
+  return start - timers_now;
+}
+
+/**
+ * Runs the wheel up to now, calling each timeout as it comes due. Timeouts
+ * are called in the order they are due, but those due in the same
+ * millisecond in no particular order.
+ */
+static void
+timers_run(u32_t now)
+{
+  struct sys_timeo *t, *list;
+  sys_timeout_handler handler;
+  void *arg;
+  u32_t next;
+  u8_t slot;
+
+  for (;;) {
+    while ((t = timers_slots[TIMERS_DUE]) != NULL) {
+#if PBUF_POOL_FREE_OOSEQ
+      PBUF_CHECK_FREE_OOSEQ();
+#endif /* PBUF_POOL_FREE_OOSEQ */
+      timers_unlink(t);
+      timers_forget(t);
+      handler = t->h;
+      arg = t->arg;
+#if LWIP_DEBUG_TIMERNAMES
+      if (handler != NULL) {
+        LWIP_DEBUGF(TIMERS_DEBUG, ("sct calling h=%s arg=%p\n",
+          t->handler_name, arg));
+      }
+#endif /* LWIP_DEBUG_TIMERNAMES */
+      timers_due = t->time;
+      memp_free(MEMP_SYS_TIMEOUT, t);
+      if (handler != NULL) {
+        timers_calling = 1;
+        handler(arg);
+        timers_calling = 0;
+      }
+    }
+
+    next = timers_next(&slot);
+    if ((next == 0) || (next > now - timers_now)) {
+      break;
+    }
+    /* on to the start of that slot, and its timeouts down a wheel */
+    timers_now += next;
+    list = timers_slots[slot];
+    timers_slots[slot] = NULL;
+    timers_used[slot / TIMERS_SLOTS] &= (u16_t)~(1 << (slot % TIMERS_SLOTS));
+    while (list != NULL) {
+      t = list;
+      list = t->next;
+      timers_place(t);
+    }
+  }
+  timers_now = now;
+}
+
+/**
+ * Create a one-shot timer (aka timeout). Timeouts are processed in the
+ * following cases:
+ * - while waiting for a message using sys_timeouts_mbox_fetch()
+ * - by calling sys_check_timeouts() (NO_SYS==1 only)
+ *
+ * @param msecs time in milliseconds after that the timer should expire
+ * @param handler callback function to call when msecs have elapsed
+ * @param arg argument to pass to the callback function
+ */
+#if LWIP_DEBUG_TIMERNAMES
+void
+sys_timeout_debug(u32_t msecs, sys_timeout_handler handler, void *arg, const char* handler_name)
+#else /* LWIP_DEBUG_TIMERNAMES */
+void
+sys_timeout(u32_t msecs, sys_timeout_handler handler, void *arg)
+#endif /* LWIP_DEBUG_TIMERNAMES */
+{
+  struct sys_timeo *timeout, **bucket;
+  u32_t now = sys_now();
+
+  timeout = (struct sys_timeo *)memp_malloc(MEMP_SYS_TIMEOUT);
+  if (timeout == NULL) {
+    LWIP_ASSERT("sys_timeout: timeout != NULL, pool MEMP_SYS_TIMEOUT is empty", timeout != NULL);
+    return;
+  }
+  timeout->h = handler;
+  timeout->arg = arg;
+  timeout->time = now + msecs;
+  if (timers_calling && ((s32_t)(timers_due + msecs - now) > 0)) {
+    /* from a handler: counted from when its timeout was due, unless that
+       is past already, when the handler was called more than msecs late */
+    timeout->time = timers_due + msecs;
+  }
+#if LWIP_DEBUG_TIMERNAMES
+  timeout->handler_name = handler_name;
+  LWIP_DEBUGF(TIMERS_DEBUG, ("sys_timeout: %p msecs=%"U32_F" handler=%s arg=%p\n",
+    (void *)timeout, msecs, handler_name, (void *)arg));
+#endif /* LWIP_DEBUG_TIMERNAMES */
+
+  bucket = timers_bucket(handler, arg);
+  timeout->hash_next = *bucket;
+  *bucket = timeout;
+  timers_place(timeout);
+}
+
+/**
+ * Remove the first matching timeout found, even though the timeout has not
+ * triggered yet.
+ *
+ * @note This function only works as expected if there is only one timeout
+ * calling 'handler' with 'arg' in the list of timeouts.
+ *
+ * @param handler callback function that would be called by the timeout
+ * @param arg callback argument that would be passed to handler
+*/
+void
+sys_untimeout(sys_timeout_handler handler, void *arg)
+{
+  struct sys_timeo **pt, *t;
+
+  for (pt = timers_bucket(handler, arg); (t = *pt) != NULL; pt = &t->hash_next) {
+    if ((t->h == handler) && (t->arg == arg)) {
+      *pt = t->hash_next;
+      timers_unlink(t);
+      memp_free(MEMP_SYS_TIMEOUT, t);
+      return;
+    }
+  }
+}
+
+/** Returns the time in milliseconds until the next timeout is due, 0 if one
+ * is due already, or SYS_TIMEOUTS_SLEEPTIME_INFINITE if there are none. A
+ * main loop can sleep that long before it calls sys_check_timeouts() again.
+ */
+u32_t
+sys_timeouts_sleeptime(void)
+{
+  struct sys_timeo *t;
+  u32_t next, elapsed;
+  u8_t slot;
+
+  if (timers_slots[TIMERS_DUE] != NULL) {
+    return 0;
+  }
+  next = timers_next(&slot);
+  if (next == 0) {
+    return SYS_TIMEOUTS_SLEEPTIME_INFINITE;
+  }
+  if (slot >= TIMERS_SLOTS) {
+    /* past wheel 0 the slot only bounds it, the earliest in it is due next */
+    next = 0xFFFFFFFFUL;
+    for (t = timers_slots[slot]; t != NULL; t = t->next) {
+      if (t->time - timers_now < next) {
+        next = t->time - timers_now;
+      }
+    }
+  }
+  elapsed = sys_now() - timers_now;
+  return next > elapsed ? next - elapsed : 0;
+}
+
+#if NO_SYS
+
+/** Handle timeouts for NO_SYS==1 (i.e. without using
+ * tcpip_thread/sys_timeouts_mbox_fetch(). Uses sys_now() to call timeout
+ * handler functions when timeouts expire.
+ *
+ * Must be called periodically from your main loop, at the latest when
+ * sys_timeouts_sleeptime() says.
+ */
+void
+sys_check_timeouts(void)
+{
+  timers_run(sys_now());
+}
+
+/** Set back the timestamp of the last call to sys_check_timeouts()
+ * This is necessary if sys_check_timeouts() hasn't been called for a long
+ * time (e.g. while saving energy) to prevent all timer functions of that
+ * period being called. Every pending timeout is put back by that time,
+ * so this one takes time in proportion to their number.
+ */
+void
+sys_restart_timeouts(void)
+{
+  struct sys_timeo *t, *list = NULL;
+  u32_t now = sys_now();
+  u16_t slot;
+
+  for (slot = 0; slot <= TIMERS_DUE; slot++) {
+    while ((t = timers_slots[slot]) != NULL) {
+      timers_unlink(t);
+      t->time += now - timers_now;
+      t->next = list;
+      list = t;
+    }
+  }
+  timers_now = now;
+  while (list != NULL) {
+    t = list;
+    list = t->next;
+    timers_place(t);
+  }
+}
+
+#else /* NO_SYS */
+
+/**
+ * Wait (forever) for a message to arrive in an mbox.
+ * While waiting, timeouts are processed.
+ *
+ * @param mbox the mbox to fetch the message from
+ * @param msg the place to store the message
+ */
+void
+sys_timeouts_mbox_fetch(sys_mbox_t *mbox, void **msg)
+{
+  u32_t sleeptime;
+
+ again:
+  sleeptime = sys_timeouts_sleeptime();
+  if (sleeptime == SYS_TIMEOUTS_SLEEPTIME_INFINITE) {
+    sys_arch_mbox_fetch(mbox, msg, 0);
+  } else if ((sleeptime == 0) ||
+             (sys_arch_mbox_fetch(mbox, msg, sleeptime) == SYS_ARCH_TIMEOUT)) {
+    /* For LWIP_TCPIP_CORE_LOCKING, lock the core before calling the
+       timeout handler functions. */
+    LOCK_TCPIP_CORE();
+    timers_run(sys_now());
+    UNLOCK_TCPIP_CORE();
+    LWIP_TCPIP_THREAD_ALIVE();
+
+    /* We try again to fetch a message from the mbox. */
+    goto again;
+  }
+}
+
+#endif /* NO_SYS */
+
+#else /* LWIP_TIMERS_WHEEL */
+
 /**
  * Create a one-shot timer (aka timeout). Timeouts are processed in the
  * following cases:
@@ -378,7 +776,7 @@ sys_check_timeouts(void)
       if (tmptimeout && (tmptimeout->time <= diff)) {
         /* timeout has expired */
         had_one = 1;
-        timeouts_last_time = now;
+        timeouts_last_time += tmptimeout->time;
         diff -= tmptimeout->time;
         next_timeout = tmptimeout->next;
         handler = tmptimeout->h;
@@ -410,6 +808,22 @@ sys_restart_timeouts(void)
   timeouts_last_time = sys_now();
 }
 
+/** Returns the time in milliseconds until the next timeout is due, 0 if one
+ * is due already, or SYS_TIMEOUTS_SLEEPTIME_INFINITE if there are none. A
+ * main loop can sleep that long before it calls sys_check_timeouts() again.
+ */
+u32_t
+sys_timeouts_sleeptime(void)
+{
+  u32_t diff;
+
+  if (next_timeout == NULL) {
+    return SYS_TIMEOUTS_SLEEPTIME_INFINITE;
+  }
+  diff = sys_now() - timeouts_last_time;
+  return next_timeout->time > diff ? next_timeout->time - diff : 0;
+}
+
 #else /* NO_SYS */
 
 /**
@@ -478,6 +892,8 @@ sys_timeouts_mbox_fetch(sys_mbox_t *mbox, void **msg)
 
 #endif /* NO_SYS */
 
+#endif /* LWIP_TIMERS_WHEEL */
+
 #else /* LWIP_TIMERS */
 /* Satisfy the TCP code which calls this function */
 void
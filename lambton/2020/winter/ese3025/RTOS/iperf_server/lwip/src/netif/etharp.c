@@ -119,9 +119,24 @@ struct etharp_entry {
 
 static struct etharp_entry arp_table[ARP_TABLE_SIZE];
 
-#if !LWIP_NETIF_HWADDRHINT
-static u8_t etharp_cached_entry;
-#endif /* !LWIP_NETIF_HWADDRHINT */
+/** Number of buckets in arp_hash: the power of 2 at or above twice
+ *  ARP_TABLE_SIZE, so that the hash is never more than half full. */
+#define ETHARP_SMEAR2(x)   ((x) | ((x) >> 1))
+#define ETHARP_SMEAR4(x)   (ETHARP_SMEAR2(x) | (ETHARP_SMEAR2(x) >> 2))
+#define ETHARP_SMEAR8(x)   (ETHARP_SMEAR4(x) | (ETHARP_SMEAR4(x) >> 4))
+#define ETHARP_SMEAR16(x)  (ETHARP_SMEAR8(x) | (ETHARP_SMEAR8(x) >> 8))
+#define ARP_HASH_SIZE      (ETHARP_SMEAR16(2 * ARP_TABLE_SIZE - 1) + 1)
+
+/** Open-addressed hash (linear probing) on the IP address of the entries
+ *  in use: each bucket holds an index into arp_table plus 1, or 0 if it is
+ *  empty. Entries never move in arp_table, so their index can be cached. */
+static u16_t arp_hash[ARP_HASH_SIZE];
+
+/** Entries of arp_table given back by etharp_free_entry() */
+static u16_t arp_free[ARP_TABLE_SIZE];
+static u16_t arp_num_free;
+/** Entries of arp_table from here on have never been used */
+static u16_t arp_num_used;
 
 /** Try hard to create a new entry - we want the IP address to appear in
     the cache (even if this means removing an active entry or so). */
@@ -132,16 +147,20 @@ static u8_t etharp_cached_entry;
 #endif /* ETHARP_SUPPORT_STATIC_ENTRIES */
 
 #if LWIP_NETIF_HWADDRHINT
-#define ETHARP_SET_HINT(netif, hint)  if (((netif) != NULL) && ((netif)->addr_hint != NULL))  \
-                                      *((netif)->addr_hint) = (hint);
+#define ETHARP_SET_HINT(netif, hint)  do { \
+                                        if ((netif)->addr_hint != NULL) { \
+                                          *((netif)->addr_hint) = (hint); \
+                                        } \
+                                        (netif)->arp_last = (hint); \
+                                      } while(0)
 #else /* LWIP_NETIF_HWADDRHINT */
-#define ETHARP_SET_HINT(netif, hint)  (etharp_cached_entry = (hint))
+#define ETHARP_SET_HINT(netif, hint)  ((netif)->arp_last = (hint))
 #endif /* LWIP_NETIF_HWADDRHINT */
 
 
 /* Some checks, instead of etharp_init(): */
-#if (LWIP_ARP && (ARP_TABLE_SIZE > 0x7f))
-  #error "ARP_TABLE_SIZE must fit in an s8_t, you have to reduce it in your lwipopts.h"
+#if (LWIP_ARP && (ARP_TABLE_SIZE > 0x7fff))
+  #error "ARP_TABLE_SIZE must fit in an s16_t, you have to reduce it in your lwipopts.h"
 #endif
 
 
@@ -172,10 +191,77 @@ free_etharp_q(struct etharp_q_entry *q)
 
 #endif /* ARP_QUEUEING */
 
+/**
+ * The bucket of arp_hash where the search for an IP address starts. The
+ * address is mixed so that hosts differing only in the last byte, which is
+ * the top byte of the u32_t on little-endian machines, spread out.
+ */
+static u16_t
+etharp_hash(ip_addr_t *ipaddr)
+{
+  u32_t h = ip4_addr_get_u32(ipaddr);
+
+  h ^= h >> 16;
+  h *= 0x45d9f3bUL;
+  h ^= h >> 16;
+  return (u16_t)(h & (ARP_HASH_SIZE - 1));
+}
+
+/**
+ * Find the bucket of arp_hash that holds the entry for an IP address.
+ *
+ * @param ipaddr IP address to look for
+ * @return the bucket, or the empty bucket where the search for ipaddr
+ * ended (which is where it would go)
+ */
+static u16_t
+etharp_hash_bucket(ip_addr_t *ipaddr)
+{
+  u16_t b = etharp_hash(ipaddr);
+
+  while ((arp_hash[b] != 0) &&
+         !ip_addr_cmp(ipaddr, &arp_table[arp_hash[b] - 1].ipaddr)) {
+    b = (b + 1) & (ARP_HASH_SIZE - 1);
+  }
+  return b;
+}
+
+/**
+ * Take an entry out of arp_hash. The entries further along its run of full
+ * buckets that would no longer be found move back into the gap, so there
+ * are no deleted markers to wade through later.
+ *
+ * @param i index of the entry, with its IP address still set
+ */
+static void
+etharp_hash_remove(u16_t i)
+{
+  u16_t hole = etharp_hash_bucket(&arp_table[i].ipaddr);
+  u16_t b = hole, home;
+
+  LWIP_ASSERT("entry not in arp_hash", arp_hash[hole] == i + 1);
+  for (;;) {
+    arp_hash[hole] = 0;
+    /* find an entry whose search passes through the hole */
+    do {
+      b = (b + 1) & (ARP_HASH_SIZE - 1);
+      if (arp_hash[b] == 0) {
+        return;
+      }
+      home = etharp_hash(&arp_table[arp_hash[b] - 1].ipaddr);
+    } while (((b - home) & (ARP_HASH_SIZE - 1)) < ((b - hole) & (ARP_HASH_SIZE - 1)));
+    arp_hash[hole] = arp_hash[b];
+    hole = b;
+  }
+}
+
 /** Clean up ARP table entries */
 static void
 etharp_free_entry(int i)
 {
+  /* take it out of the hash and give it back */
+  etharp_hash_remove((u16_t)i);
+  arp_free[arp_num_free++] = (u16_t)i;
   /* remove from SNMP ARP index tree */
   snmp_delete_arpidx_tree(arp_table[i].netif, &arp_table[i].ipaddr);
   /* and empty packet queue */
@@ -205,17 +291,30 @@ etharp_free_entry(int i)
 void
 etharp_tmr(void)
 {
-  u8_t i;
+  u16_t b, i;
+  u32_t n;
 
   LWIP_DEBUGF(ETHARP_DEBUG, ("etharp_timer\n"));
-  /* remove expired entries from the ARP table */
-  for (i = 0; i < ARP_TABLE_SIZE; ++i) {
-    u8_t state = arp_table[i].state;
-    if (state != ETHARP_STATE_EMPTY
+  /* remove expired entries from the ARP table, going round the buckets of
+     arp_hash from just after an empty one: freeing an entry only moves
+     entries from further along its run back into the gap, so looking at
+     the same bucket again visits each entry exactly once */
+  for (b = 0; arp_hash[b] != 0; ++b) {
+  }
+  for (n = 0; n < ARP_HASH_SIZE; ++n) {
+    b = (b + 1) & (ARP_HASH_SIZE - 1);
+    while (arp_hash[b] != 0) {
+      u8_t state;
+
+      i = arp_hash[b] - 1;
+      state = arp_table[i].state;
+      if (state == ETHARP_STATE_EMPTY
 #if ETHARP_SUPPORT_STATIC_ENTRIES
-      && (state != ETHARP_STATE_STATIC)
+        || (state == ETHARP_STATE_STATIC)
 #endif /* ETHARP_SUPPORT_STATIC_ENTRIES */
-      ) {
+        ) {
+        break;
+      }
       arp_table[i].ctime++;
       if ((arp_table[i].ctime >= ARP_MAXAGE) ||
           ((arp_table[i].state == ETHARP_STATE_PENDING)  &&
@@ -225,18 +324,14 @@ etharp_tmr(void)
              arp_table[i].state >= ETHARP_STATE_STABLE ? "stable" : "pending", (u16_t)i));
         /* clean up entries that have just been expired */
         etharp_free_entry(i);
+        continue;
       }
-      else if (arp_table[i].state == ETHARP_STATE_STABLE_REREQUESTING) {
+      if (arp_table[i].state == ETHARP_STATE_STABLE_REREQUESTING) {
         /* Reset state to stable, so that the next transmitted packet will
            re-send an ARP request. */
         arp_table[i].state = ETHARP_STATE_STABLE;
       }
-#if ARP_QUEUEING
-      /* still pending entry? (not expired) */
-      if (arp_table[i].state == ETHARP_STATE_PENDING) {
-        /* resend an ARP query here? */
-      }
-#endif /* ARP_QUEUEING */
+      break;
     }
   }
 }
@@ -244,66 +339,83 @@ etharp_tmr(void)
 /**
  * Search the ARP table for a matching or new entry.
  * 
- * If an IP address is given, return a pending or stable ARP entry that matches
- * the address. If no match is found, create a new entry with this address set,
- * but in state ETHARP_EMPTY. The caller must check and possibly change the
- * state of the returned entry.
- * 
- * If ipaddr is NULL, return a initialized new entry in state ETHARP_EMPTY.
+ * Return a pending or stable ARP entry that matches the IP address. If no
+ * match is found, create a new entry with this address set, but in state
+ * ETHARP_EMPTY. The caller must check and possibly change the state of the
+ * returned entry.
  * 
- * In all cases, attempt to create new entries from an empty entry. If no
- * empty entries are available and ETHARP_FLAG_TRY_HARD flag is set, recycle
- * old entries. Heuristic choose the least important entry for recycling.
+ * The address is looked up in arp_hash. New entries are taken from the
+ * unused ones. If there are none and ETHARP_FLAG_TRY_HARD flag is set,
+ * recycle old entries. Heuristic choose the least important entry for
+ * recycling: only then is the whole table searched.
  *
  * @param ipaddr IP address to find in ARP cache, or to add if not found.
  * @param flags @see definition of ETHARP_FLAG_*
- * @param netif netif related to this address (used for NETIF_HWADDRHINT)
  *  
  * @return The ARP entry index that matched or is created, ERR_MEM if no
  * entry is found or could be recycled.
  */
-static s8_t
+static s16_t
 etharp_find_entry(ip_addr_t *ipaddr, u8_t flags)
 {
-  s8_t old_pending = ARP_TABLE_SIZE, old_stable = ARP_TABLE_SIZE;
-  s8_t empty = ARP_TABLE_SIZE;
-  u8_t i = 0, age_pending = 0, age_stable = 0;
+  s16_t old_pending = ARP_TABLE_SIZE, old_stable = ARP_TABLE_SIZE;
+  u16_t i = 0, b;
+  u8_t age_pending = 0, age_stable = 0;
   /* oldest entry with packets on queue */
-  s8_t old_queue = ARP_TABLE_SIZE;
+  s16_t old_queue = ARP_TABLE_SIZE;
   /* its age */
   u8_t age_queue = 0;
 
+  LWIP_ASSERT("ipaddr != NULL", ipaddr != NULL);
+
   /**
-   * a) do a search through the cache, remember candidates
-   * b) select candidate entry
-   * c) create new entry
+   * a) look the address up
+   * b) take an unused entry
+   * c) or else select an entry to recycle
+   * d) create new entry
    */
 
-  /* a) in a single search sweep, do all of this
-   * 1) remember the first empty entry (if any)
-   * 2) remember the oldest stable entry (if any)
-   * 3) remember the oldest pending entry without queued packets (if any)
-   * 4) remember the oldest pending entry with queued packets (if any)
-   * 5) search for a matching IP entry, either pending or stable
-   *    until 5 matches, or all entries are searched for.
-   */
+  /* a) does IP address match IP address in ARP entry? */
+  b = etharp_hash_bucket(ipaddr);
+  if (arp_hash[b] != 0) {
+    i = arp_hash[b] - 1;
+    LWIP_ASSERT("state == ETHARP_STATE_PENDING || state >= ETHARP_STATE_STABLE",
+      arp_table[i].state == ETHARP_STATE_PENDING || arp_table[i].state >= ETHARP_STATE_STABLE);
+    LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("etharp_find_entry: found matching entry %"U16_F"\n", i));
+    /* found exact IP address match, simply bail out */
+    return (s16_t)i;
+  }
+  /* { we have no match } => try to create a new entry */
+   
+  /* don't create new entry, only search? */
+  if ((flags & ETHARP_FLAG_FIND_ONLY) != 0) {
+    LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("etharp_find_entry: no matching entry found and not allowed to create\n"));
+    return (s16_t)ERR_MEM;
+  }
 
-  for (i = 0; i < ARP_TABLE_SIZE; ++i) {
-    u8_t state = arp_table[i].state;
-    /* no empty entry found yet and now we do find one? */
-    if ((empty == ARP_TABLE_SIZE) && (state == ETHARP_STATE_EMPTY)) {
-      LWIP_DEBUGF(ETHARP_DEBUG, ("etharp_find_entry: found empty entry %"U16_F"\n", (u16_t)i));
-      /* remember first empty entry */
-      empty = i;
-    } else if (state != ETHARP_STATE_EMPTY) {
+  /* b) empty entry available? */
+  if (arp_num_free != 0) {
+    i = arp_free[--arp_num_free];
+  } else if (arp_num_used < ARP_TABLE_SIZE) {
+    i = arp_num_used++;
+  } else {
+    /* no empty entry found and not allowed to recycle? */
+    if ((flags & ETHARP_FLAG_TRY_HARD) == 0) {
+      LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("etharp_find_entry: no empty entry found and not allowed to recycle\n"));
+      return (s16_t)ERR_MEM;
+    }
+
+    /* c) choose the least destructive entry to recycle, in a single sweep:
+     * 1) oldest stable entry
+     * 2) oldest pending entry without queued packets
+     * 3) oldest pending entry with queued packets
+     * 
+     * { ETHARP_FLAG_TRY_HARD is set at this point, and every entry is in use }
+     */ 
+    for (i = 0; i < ARP_TABLE_SIZE; ++i) {
+      u8_t state = arp_table[i].state;
       LWIP_ASSERT("state == ETHARP_STATE_PENDING || state >= ETHARP_STATE_STABLE",
         state == ETHARP_STATE_PENDING || state >= ETHARP_STATE_STABLE);
-      /* if given, does IP address match IP address in ARP entry? */
-      if (ipaddr && ip_addr_cmp(ipaddr, &arp_table[i].ipaddr)) {
-        LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("etharp_find_entry: found matching entry %"U16_F"\n", (u16_t)i));
-        /* found exact IP address match, simply bail out */
-        return i;
-      }
       /* pending entry? */
       if (state == ETHARP_STATE_PENDING) {
         /* pending with queued packets? */
@@ -335,70 +447,48 @@ etharp_find_entry(ip_addr_t *ipaddr, u8_t flags)
         }
       }
     }
-  }
-  /* { we have no match } => try to create a new entry */
-   
-  /* don't create new entry, only search? */
-  if (((flags & ETHARP_FLAG_FIND_ONLY) != 0) ||
-      /* or no empty entry found and not allowed to recycle? */
-      ((empty == ARP_TABLE_SIZE) && ((flags & ETHARP_FLAG_TRY_HARD) == 0))) {
-    LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("etharp_find_entry: no empty entry found and not allowed to recycle\n"));
-    return (s8_t)ERR_MEM;
-  }
-  
-  /* b) choose the least destructive entry to recycle:
-   * 1) empty entry
-   * 2) oldest stable entry
-   * 3) oldest pending entry without queued packets
-   * 4) oldest pending entry with queued packets
-   * 
-   * { ETHARP_FLAG_TRY_HARD is set at this point }
-   */ 
-
-  /* 1) empty entry available? */
-  if (empty < ARP_TABLE_SIZE) {
-    i = empty;
-    LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("etharp_find_entry: selecting empty entry %"U16_F"\n", (u16_t)i));
-  } else {
-    /* 2) found recyclable stable entry? */
+
+    /* 1) found recyclable stable entry? */
     if (old_stable < ARP_TABLE_SIZE) {
       /* recycle oldest stable*/
       i = old_stable;
-      LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("etharp_find_entry: selecting oldest stable entry %"U16_F"\n", (u16_t)i));
+      LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("etharp_find_entry: selecting oldest stable entry %"U16_F"\n", i));
       /* no queued packets should exist on stable entries */
       LWIP_ASSERT("arp_table[i].q == NULL", arp_table[i].q == NULL);
-    /* 3) found recyclable pending entry without queued packets? */
+    /* 2) found recyclable pending entry without queued packets? */
     } else if (old_pending < ARP_TABLE_SIZE) {
       /* recycle oldest pending */
       i = old_pending;
-      LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("etharp_find_entry: selecting oldest pending entry %"U16_F" (without queue)\n", (u16_t)i));
-    /* 4) found recyclable pending entry with queued packets? */
+      LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("etharp_find_entry: selecting oldest pending entry %"U16_F" (without queue)\n", i));
+    /* 3) found recyclable pending entry with queued packets? */
     } else if (old_queue < ARP_TABLE_SIZE) {
       /* recycle oldest pending (queued packets are free in etharp_free_entry) */
       i = old_queue;
-      LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("etharp_find_entry: selecting oldest pending entry %"U16_F", freeing packet queue %p\n", (u16_t)i, (void *)(arp_table[i].q)));
+      LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("etharp_find_entry: selecting oldest pending entry %"U16_F", freeing packet queue %p\n", i, (void *)(arp_table[i].q)));
       /* no empty or recyclable entries found */
     } else {
       LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("etharp_find_entry: no empty or recyclable entries found\n"));
-      return (s8_t)ERR_MEM;
+      return (s16_t)ERR_MEM;
     }
 
     /* { empty or recyclable entry found } */
     LWIP_ASSERT("i < ARP_TABLE_SIZE", i < ARP_TABLE_SIZE);
     etharp_free_entry(i);
+    i = arp_free[--arp_num_free];
+    /* taking the old entry out of the hash may have moved the bucket for
+       the new one */
+    b = etharp_hash_bucket(ipaddr);
   }
 
   LWIP_ASSERT("i < ARP_TABLE_SIZE", i < ARP_TABLE_SIZE);
   LWIP_ASSERT("arp_table[i].state == ETHARP_STATE_EMPTY",
     arp_table[i].state == ETHARP_STATE_EMPTY);
 
-  /* IP address given? */
-  if (ipaddr != NULL) {
-    /* set IP address */
-    ip_addr_copy(arp_table[i].ipaddr, *ipaddr);
-  }
+  /* d) set IP address, and enter it in the hash */
+  ip_addr_copy(arp_table[i].ipaddr, *ipaddr);
+  arp_hash[b] = i + 1;
   arp_table[i].ctime = 0;
-  return (err_t)i;
+  return (s16_t)i;
 }
 
 /**
@@ -447,7 +537,7 @@ etharp_send_ip(struct netif *netif, struct pbuf *p, struct eth_addr *src, struct
 static err_t
 etharp_update_arp_entry(struct netif *netif, ip_addr_t *ipaddr, struct eth_addr *ethaddr, u8_t flags)
 {
-  s8_t i;
+  s16_t i;
   LWIP_ASSERT("netif->hwaddr_len == ETHARP_HWADDR_LEN", netif->hwaddr_len == ETHARP_HWADDR_LEN);
   LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("etharp_update_arp_entry: %"U16_F".%"U16_F".%"U16_F".%"U16_F" - %02"X16_F":%02"X16_F":%02"X16_F":%02"X16_F":%02"X16_F":%02"X16_F"\n",
     ip4_addr1_16(ipaddr), ip4_addr2_16(ipaddr), ip4_addr3_16(ipaddr), ip4_addr4_16(ipaddr),
@@ -550,7 +640,7 @@ etharp_add_static_entry(ip_addr_t *ipaddr, struct eth_addr *ethaddr)
 err_t
 etharp_remove_static_entry(ip_addr_t *ipaddr)
 {
-  s8_t i;
+  s16_t i;
   LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("etharp_remove_static_entry: %"U16_F".%"U16_F".%"U16_F".%"U16_F"\n",
     ip4_addr1_16(ipaddr), ip4_addr2_16(ipaddr), ip4_addr3_16(ipaddr), ip4_addr4_16(ipaddr)));
 
@@ -578,7 +668,7 @@ etharp_remove_static_entry(ip_addr_t *ipaddr)
  */
 void etharp_cleanup_netif(struct netif *netif)
 {
-  u8_t i;
+  u16_t i;
 
   for (i = 0; i < ARP_TABLE_SIZE; ++i) {
     u8_t state = arp_table[i].state;
@@ -599,11 +689,11 @@ void etharp_cleanup_netif(struct netif *netif)
  * @param ip_ret points to return pointer
  * @return table index if found, -1 otherwise
  */
-s8_t
+s16_t
 etharp_find_addr(struct netif *netif, ip_addr_t *ipaddr,
          struct eth_addr **eth_ret, ip_addr_t **ip_ret)
 {
-  s8_t i;
+  s16_t i;
 
   LWIP_ASSERT("eth_ret != NULL && ip_ret != NULL",
     eth_ret != NULL && ip_ret != NULL);
@@ -839,7 +929,7 @@ etharp_arp_input(struct netif *netif, struct eth_addr *ethaddr, struct pbuf *p)
  * in the arp_table specified by the index 'arp_idx'.
  */
 static err_t
-etharp_output_to_arp_index(struct netif *netif, struct pbuf *q, u8_t arp_idx)
+etharp_output_to_arp_index(struct netif *netif, struct pbuf *q, u16_t arp_idx)
 {
   LWIP_ASSERT("arp_table[arp_idx].state >= ETHARP_STATE_STABLE",
               arp_table[arp_idx].state >= ETHARP_STATE_STABLE);
@@ -915,7 +1005,7 @@ etharp_output(struct netif *netif, struct pbuf *q, ip_addr_t *ipaddr)
     dest = &mcastaddr;
   /* unicast destination IP address? */
   } else {
-    s8_t i;
+    s16_t i;
     /* outside local network? if so, this can neither be a global broadcast nor
        a subnet broadcast. */
     if (!ip_addr_netcmp(ipaddr, &(netif->ip_addr), &(netif->netmask)) &&
@@ -944,29 +1034,30 @@ etharp_output(struct netif *netif, struct pbuf *q, ip_addr_t *ipaddr)
 #if LWIP_NETIF_HWADDRHINT
     if (netif->addr_hint != NULL) {
       /* per-pcb cached entry was given */
-      u8_t etharp_cached_entry = *(netif->addr_hint);
-      if (etharp_cached_entry < ARP_TABLE_SIZE) {
-#endif /* LWIP_NETIF_HWADDRHINT */
-        if ((arp_table[etharp_cached_entry].state >= ETHARP_STATE_STABLE) &&
-            (ip_addr_cmp(dst_addr, &arp_table[etharp_cached_entry].ipaddr))) {
-          /* the per-pcb-cached entry is stable and the right one! */
-          ETHARP_STATS_INC(etharp.cachehit);
-          return etharp_output_to_arp_index(netif, q, etharp_cached_entry);
-        }
-#if LWIP_NETIF_HWADDRHINT
+      u16_t etharp_cached_entry = *(netif->addr_hint);
+      if ((etharp_cached_entry < ARP_TABLE_SIZE) &&
+          (arp_table[etharp_cached_entry].state >= ETHARP_STATE_STABLE) &&
+          (ip_addr_cmp(dst_addr, &arp_table[etharp_cached_entry].ipaddr))) {
+        /* the per-pcb-cached entry is stable and the right one! */
+        ETHARP_STATS_INC(etharp.cachehit);
+        netif->arp_last = etharp_cached_entry;
+        return etharp_output_to_arp_index(netif, q, etharp_cached_entry);
       }
     }
 #endif /* LWIP_NETIF_HWADDRHINT */
+    /* the entry this netif last sent to is stable and the right one? */
+    if ((arp_table[netif->arp_last].state >= ETHARP_STATE_STABLE) &&
+        (ip_addr_cmp(dst_addr, &arp_table[netif->arp_last].ipaddr))) {
+      ETHARP_STATS_INC(etharp.cachehit);
+      return etharp_output_to_arp_index(netif, q, netif->arp_last);
+    }
 
-    /* find stable entry: do this here since this is a critical path for
-       throughput and etharp_find_entry() is kind of slow */
-    for (i = 0; i < ARP_TABLE_SIZE; i++) {
-      if ((arp_table[i].state >= ETHARP_STATE_STABLE) &&
-          (ip_addr_cmp(dst_addr, &arp_table[i].ipaddr))) {
-        /* found an existing, stable entry */
-        ETHARP_SET_HINT(netif, i);
-        return etharp_output_to_arp_index(netif, q, i);
-      }
+    /* find stable entry in the hash */
+    i = etharp_find_entry(dst_addr, ETHARP_FLAG_FIND_ONLY);
+    if ((i >= 0) && (arp_table[i].state >= ETHARP_STATE_STABLE)) {
+      /* found an existing, stable entry */
+      ETHARP_SET_HINT(netif, i);
+      return etharp_output_to_arp_index(netif, q, i);
     }
     /* no stable entry found, use the (slower) query function:
        queue on destination Ethernet address belonging to ipaddr */
@@ -1017,7 +1108,7 @@ etharp_query(struct netif *netif, ip_addr_t *ipaddr, struct pbuf *q)
 {
   struct eth_addr * srcaddr = (struct eth_addr *)netif->hwaddr;
   err_t result = ERR_MEM;
-  s8_t i; /* ARP entry index */
+  s16_t i; /* ARP entry index */
 
   /* non-unicast address? */
   if (ip_addr_isbroadcast(ipaddr, netif) ||
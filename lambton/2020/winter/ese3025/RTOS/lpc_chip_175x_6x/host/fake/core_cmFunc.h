@@ -0,0 +1,39 @@
+/*
+ * @brief Host (Linux) stand-in for the CMSIS core register functions
+ *
+ * @note
+ * Found before ../inc/core_cmFunc.h by the host tests that build the chip
+ * drivers (-Ifake ahead of -I../inc), as the instructions of the real one
+ * do not assemble on the host. The interrupt mask is a variable the tests
+ * can check; nothing interrupts the host code behind its back.
+ */
+
+#ifndef __CORE_CMFUNC_H
+#define __CORE_CMFUNC_H
+
+#include <stdint.h>
+
+/* Set while the driver has "interrupts" disabled */
+extern uint32_t fake_primask;
+
+static inline void __enable_irq(void)
+{
+	fake_primask = 0;
+}
+
+static inline void __disable_irq(void)
+{
+	fake_primask = 1;
+}
+
+static inline uint32_t __get_PRIMASK(void)
+{
+	return fake_primask;
+}
+
+static inline void __set_PRIMASK(uint32_t priMask)
+{
+	fake_primask = priMask;
+}
+
+#endif /* __CORE_CMFUNC_H */
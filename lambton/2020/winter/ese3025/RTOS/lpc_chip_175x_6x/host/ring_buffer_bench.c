@@ -0,0 +1,282 @@
+/*
+ * @brief Host (Linux) benchmark of the ring buffer copies in ring_buffer.c
+ *
+ * @note
+ * Moves bytes through a ring buffer in batches, as a UART handler and the
+ * task that feeds or drains it do, three ways: a byte at a time with
+ * RingBuffer_Insert/RingBuffer_Pop, as the UART handlers used to; a batch
+ * at a time through a buffer of the caller's with RingBuffer_InsertMult/
+ * RingBuffer_PopMult, which memcpy; and in place, the producer writing
+ * into the spans of RingBuffer_ReserveWrite and the consumer reading the
+ * spans of RingBuffer_PeekRead. Each byte is made by the producer and
+ * added up by the consumer, so all three do the same work apart from the
+ * copies. Once on one thread, the producer and consumer taking turns, and
+ * once on two threads:
+ *
+ *	gcc -std=gnu99 -O2 -Wall -pthread -I../inc -o ring_buffer_bench \
+ *		ring_buffer_bench.c ../src/ring_buffer.c
+ *	./ring_buffer_bench [-f CPU MHz] [-b bytes per measurement]
+ *
+ * Speeds are in bytes per ns, or in bytes per cycle given the clock with -f.
+ */
+
+#include "ring_buffer.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define RING_SIZE       1024
+#define MAX_BATCH       256
+
+enum method {
+	BYTE, COPY, SPAN, METHODS
+};
+
+static const char *const method_names[METHODS] = {"byte", "memcpy", "in place"};
+
+static RINGBUFF_T rb;
+static uint8_t rb_buf[RING_SIZE];
+static long bytes = 100000000;
+static int batch;
+static enum method method;
+static volatile uint32_t sink;	/* keeps the sums alive */
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+/* Put up to num bytes, numbered from n; returns the number put */
+static int produce(uint32_t n, int num)
+{
+	uint8_t tmp[MAX_BATCH];
+	RINGBUFF_SPAN_T span[2];
+	int i, j, cnt = 0;
+
+	switch (method) {
+	case BYTE:
+		for (cnt = 0; cnt < num; cnt++) {
+			uint8_t ch = (uint8_t) (n + cnt);
+
+			if (!RingBuffer_Insert(&rb, &ch)) {
+				break;
+			}
+		}
+		break;
+
+	case COPY:
+		cnt = MIN(num, RingBuffer_GetFree(&rb));
+		for (i = 0; i < cnt; i++) {
+			tmp[i] = (uint8_t) (n + i);
+		}
+		cnt = RingBuffer_InsertMult(&rb, tmp, cnt);
+		break;
+
+	default:
+		cnt = RingBuffer_ReserveWrite(&rb, span, num);
+		for (i = 0; i < 2; i++) {
+			uint8_t *p8 = span[i].data;
+
+			for (j = 0; j < span[i].count; j++) {
+				p8[j] = (uint8_t) (n + j);
+			}
+			n += span[i].count;
+		}
+		RingBuffer_CommitWrite(&rb, cnt);
+		break;
+	}
+	return cnt;
+}
+
+/* Take up to num bytes and add them to *sum; returns the number taken */
+static int consume(uint32_t *sum, int num)
+{
+	uint8_t tmp[MAX_BATCH];
+	RINGBUFF_SPAN_T span[2];
+	int i, j, cnt = 0;
+
+	switch (method) {
+	case BYTE:
+		for (cnt = 0; cnt < num; cnt++) {
+			uint8_t ch;
+
+			if (!RingBuffer_Pop(&rb, &ch)) {
+				break;
+			}
+			*sum += ch;
+		}
+		break;
+
+	case COPY:
+		cnt = RingBuffer_PopMult(&rb, tmp, num);
+		for (i = 0; i < cnt; i++) {
+			*sum += tmp[i];
+		}
+		break;
+
+	default:
+		cnt = RingBuffer_PeekRead(&rb, span, num);
+		for (i = 0; i < 2; i++) {
+			const uint8_t *p8 = span[i].data;
+
+			for (j = 0; j < span[i].count; j++) {
+				*sum += p8[j];
+			}
+		}
+		RingBuffer_ReleaseRead(&rb, cnt);
+		break;
+	}
+	return cnt;
+}
+
+/* The sum the consumer must come to */
+static uint32_t expected_sum(void)
+{
+	uint32_t sum = 0;
+	long i;
+
+	for (i = 0; i < bytes; i++) {
+		sum += (uint8_t) i;
+	}
+	return sum;
+}
+
+static void *producer(void *arg)
+{
+	long n = 0;
+
+	(void) arg;
+	while (n < bytes) {
+		int cnt = produce((uint32_t) n, MIN(batch, bytes - n));
+
+		if (cnt == 0) {
+			sched_yield();
+		}
+		n += cnt;
+	}
+	return NULL;
+}
+
+static void *consumer(void *arg)
+{
+	uint32_t sum = 0;
+	long n = 0;
+
+	(void) arg;
+	while (n < bytes) {
+		int cnt = consume(&sum, MIN(batch, bytes - n));
+
+		if (cnt == 0) {
+			sched_yield();
+		}
+		n += cnt;
+	}
+	sink = sum;
+	return NULL;
+}
+
+/* Returns the speed on one thread */
+static double time_one(void)
+{
+	uint32_t sum = 0;
+	long n = 0;
+	uint64_t start;
+
+	RingBuffer_Init(&rb, rb_buf, 1, RING_SIZE);
+	start = now_ns();
+	while (n < bytes) {
+		/* stop at the end, as bytes need not be a multiple of batch */
+		int num = MIN(batch, bytes - n);
+
+		produce((uint32_t) n, num);
+		n += consume(&sum, num);
+	}
+	sink = sum;
+	return (double) bytes / (now_ns() - start);
+}
+
+/* The same on two threads */
+static double time_two(void)
+{
+	pthread_t prod, cons;
+	uint64_t start;
+
+	RingBuffer_Init(&rb, rb_buf, 1, RING_SIZE);
+	start = now_ns();
+	pthread_create(&prod, NULL, producer, NULL);
+	pthread_create(&cons, NULL, consumer, NULL);
+	pthread_join(prod, NULL);
+	pthread_join(cons, NULL);
+	return (double) bytes / (now_ns() - start);
+}
+
+int main(int argc, char *argv[])
+{
+	static const int batches[] = {1, 16, 64, 256};
+	double speed[2][METHODS], mhz = 0, scale = 1;
+	uint32_t expect;
+	unsigned int k;
+	int opt, m, t;
+
+	while ((opt = getopt(argc, argv, "f:b:")) != -1) {
+		switch (opt) {
+		case 'f':
+			mhz = strtod(optarg, NULL);
+			break;
+		case 'b':
+			bytes = strtol(optarg, NULL, 0);
+			break;
+		default:
+			printf("usage: %s [-f CPU MHz] [-b bytes per measurement]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (bytes < 1 || mhz < 0) {
+		printf("need some bytes, and a clock that is not negative\n");
+		return 2;
+	}
+	if (mhz > 0) {
+		scale = 1000 / mhz;	/* bytes/ns to bytes/cycle */
+	}
+	expect = expected_sum();
+
+	printf("ring of %d bytes, in %s\n", RING_SIZE, mhz > 0 ? "bytes/cycle" : "bytes/ns");
+	printf("%6s %10s %10s %10s %10s %10s %10s\n", "", "1 thread", "", "", "2 threads", "", "");
+	printf("%6s", "batch");
+	for (t = 0; t < 2; t++) {
+		for (m = 0; m < METHODS; m++) {
+			printf(" %10s", method_names[m]);
+		}
+	}
+	printf("\n");
+	for (k = 0; k != sizeof(batches) / sizeof(batches[0]); ++k) {
+		for (t = 0; t < 2; t++) {
+			for (m = 0; m < METHODS; m++) {
+				method = (enum method) m;
+				batch = batches[k];
+				speed[t][m] = (t == 0 ? time_one() : time_two()) * scale;
+				if (sink != expect) {
+					printf("FAILED: %s lost or changed bytes\n", method_names[m]);
+					return 1;
+				}
+			}
+		}
+		printf("%6d", batches[k]);
+		for (t = 0; t < 2; t++) {
+			for (m = 0; m < METHODS; m++) {
+				printf(" %10.2f", speed[t][m]);
+			}
+		}
+		printf("\n");
+	}
+	return 0;
+}
@@ -0,0 +1,228 @@
+/*
+ * @brief Host (Linux) stress test of the SPSC ring buffer in ring_buffer.c
+ *
+ * @note
+ * One thread produces a running count and another consumes it, each
+ * picking at random between the copying calls (RingBuffer_Insert,
+ * RingBuffer_InsertMult, RingBuffer_Pop, RingBuffer_PopMult) and the
+ * in-place ones (RingBuffer_ReserveWrite/CommitWrite,
+ * RingBuffer_PeekRead/ReleaseRead), committing or releasing only part of
+ * what was reserved or peeked now and then. The consumer checks that the
+ * count arrives whole and in order, and both sides that the buffer never
+ * holds more than it can. The buffer is small, so the indexes wrap all
+ * the time; they also start just short of 2^32 to wrap the free-running
+ * counters. Run it for 1, 2, 4 and 8 byte items:
+ *
+ *	gcc -std=gnu99 -O2 -Wall -pthread -I../inc -o ring_buffer_stress \
+ *		ring_buffer_stress.c ../src/ring_buffer.c
+ *	./ring_buffer_stress [-n items] [-c ring size]
+ *
+ * Also worth a run with -fsanitize=thread and with -fsanitize=address.
+ */
+
+#include "ring_buffer.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define MAX_BATCH       64
+
+static RINGBUFF_T rb;
+static uint8_t rb_buf[4096 * 8] __attribute__ ((aligned (8)));
+static int item_sz;
+static long total = 10000000;
+static volatile int failed;
+
+/* xorshift, one state per thread */
+static uint32_t rnd(uint32_t *s)
+{
+	*s ^= *s << 13;
+	*s ^= *s >> 17;
+	*s ^= *s << 5;
+	return *s;
+}
+
+/* The item for count n, truncated to the item size */
+static void make_item(uint8_t *p, uint64_t n)
+{
+	memcpy(p, &n, item_sz);
+}
+
+static int check_item(const uint8_t *p, uint64_t n)
+{
+	uint64_t v = 0;
+
+	memcpy(&v, p, item_sz);
+	if (item_sz < 8) {
+		n &= (1ull << (8 * item_sz)) - 1;
+	}
+	return v == n;
+}
+
+static void fail(const char *what, uint64_t n)
+{
+	if (!failed) {
+		failed = 1;
+		printf("FAILED: %s at item %llu (head %lu, tail %lu)\n", what,
+			   (unsigned long long) n, (unsigned long) rb.head, (unsigned long) rb.tail);
+	}
+}
+
+/* Neither side may ever see more items than the buffer holds */
+static void check_count(uint64_t n)
+{
+	int cnt = RingBuffer_GetCount(&rb);
+
+	if (cnt < 0 || cnt > RingBuffer_GetSize(&rb)) {
+		fail("count out of range", n);
+	}
+}
+
+static void *producer(void *arg)
+{
+	uint8_t tmp[MAX_BATCH * 8];
+	RINGBUFF_SPAN_T span[2];
+	uint32_t seed = 2014;
+	uint64_t n = 0;
+	int i, j, k, cnt, want;
+
+	(void) arg;
+	while (n < (uint64_t) total && !failed) {
+		want = 1 + rnd(&seed) % MAX_BATCH;
+		if ((uint64_t) want > (uint64_t) total - n) {
+			want = (int) ((uint64_t) total - n);
+		}
+		switch (rnd(&seed) % 3) {
+		case 0:
+			make_item(tmp, n);
+			n += RingBuffer_Insert(&rb, tmp);
+			break;
+
+		case 1:
+			for (i = 0; i < want; i++) {
+				make_item(tmp + i * item_sz, n + i);
+			}
+			n += RingBuffer_InsertMult(&rb, tmp, want);
+			break;
+
+		default:
+			cnt = RingBuffer_ReserveWrite(&rb, span, want);
+			if (cnt > 0 && (rnd(&seed) & 3) == 0) {
+				cnt = rnd(&seed) % (cnt + 1);	/* commit only part of it */
+			}
+			for (i = 0, k = 0; i < 2; i++) {
+				for (j = 0; j < span[i].count && k < cnt; j++, k++) {
+					make_item((uint8_t *) span[i].data + j * item_sz, n + k);
+				}
+			}
+			RingBuffer_CommitWrite(&rb, cnt);
+			n += cnt;
+			break;
+		}
+		if (RingBuffer_IsFull(&rb)) {
+			sched_yield();	/* a single CPU would wait out the time slice */
+		}
+		check_count(n);
+	}
+	return NULL;
+}
+
+static void *consumer(void *arg)
+{
+	uint8_t tmp[MAX_BATCH * 8];
+	RINGBUFF_SPAN_T span[2];
+	uint32_t seed = 1969;
+	uint64_t n = 0;
+	int i, j, k, cnt, want;
+
+	(void) arg;
+	while (n < (uint64_t) total && !failed) {
+		want = 1 + rnd(&seed) % MAX_BATCH;
+		switch (rnd(&seed) % 3) {
+		case 0:
+			cnt = RingBuffer_Pop(&rb, tmp);
+			break;
+
+		case 1:
+			cnt = RingBuffer_PopMult(&rb, tmp, want);
+			break;
+
+		default:
+			cnt = RingBuffer_PeekRead(&rb, span, want);
+			if (cnt > 0 && (rnd(&seed) & 3) == 0) {
+				cnt = rnd(&seed) % (cnt + 1);	/* release only part of it */
+			}
+			if (span[0].count + span[1].count > want ||
+				(span[1].count > 0 && span[1].data != rb.data)) {
+				fail("bad span", n);
+			}
+			for (i = 0, k = 0; i < 2; i++) {
+				for (j = 0; j < span[i].count && k < cnt; j++, k++) {
+					memcpy(tmp + k * item_sz, (uint8_t *) span[i].data + j * item_sz, item_sz);
+				}
+			}
+			RingBuffer_ReleaseRead(&rb, cnt);
+			break;
+		}
+		for (i = 0; i < cnt; i++) {
+			if (!check_item(tmp + i * item_sz, n + i)) {
+				fail("wrong item", n + i);
+				break;
+			}
+		}
+		n += cnt;
+		if (cnt == 0) {
+			sched_yield();
+		}
+		check_count(n);
+	}
+	return NULL;
+}
+
+int main(int argc, char *argv[])
+{
+	static const int sizes[] = {1, 2, 4, 8};
+	pthread_t prod, cons;
+	int opt, count = 64;
+	unsigned int k;
+
+	while ((opt = getopt(argc, argv, "n:c:")) != -1) {
+		switch (opt) {
+		case 'n':
+			total = strtol(optarg, NULL, 0);
+			break;
+		case 'c':
+			count = strtol(optarg, NULL, 0);
+			break;
+		default:
+			printf("usage: %s [-n items] [-c ring size]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (total < 1 || count < 2 || count > 4096 || (count & (count - 1)) != 0) {
+		printf("need some items, and a ring size that is a power of 2 from 2 to 4096\n");
+		return 2;
+	}
+
+	for (k = 0; k != sizeof(sizes) / sizeof(sizes[0]); ++k) {
+		item_sz = sizes[k];
+		RingBuffer_Init(&rb, rb_buf, item_sz, count);
+		/* start just short of the free-running indexes wrapping */
+		rb.head = rb.tail = 0xFFFFFFFFu - 1000;
+
+		pthread_create(&prod, NULL, producer, NULL);
+		pthread_create(&cons, NULL, consumer, NULL);
+		pthread_join(prod, NULL);
+		pthread_join(cons, NULL);
+		if (failed) {
+			return 1;
+		}
+		printf("%d byte items: %ld passed through a ring of %d\n", item_sz, total, count);
+	}
+	return 0;
+}
@@ -0,0 +1,435 @@
+/*
+ * @brief Host (Linux) test of the UART ring buffer DMA in uart_17xx_40xx.c
+ *
+ * @note
+ * Runs Chip_UART_InitDMARB() and the rest of the UART, GPDMA and ring
+ * buffer drivers unchanged against a fake of the registers they use. The
+ * APB and GPDMA address ranges are mapped at their LPC175x/6x addresses,
+ * and fake_dma() plays the GPDMA controller: on a request of the UART it
+ * moves a byte for the enabled channel waiting for it, counts the transfer
+ * down, raises the terminal count and loads the next linked descriptor, as
+ * the hardware does. The DMA interrupt is taken right after the terminal
+ * count unless a test holds it off. The ring buffers and descriptors sit
+ * in a mapping below 4 GB as well, as the drivers keep addresses in 32
+ * bits, and fake/core_cmFunc.h stands in for the interrupt mask.
+ *
+ * Tests transmit across the end of the ring (two linked descriptors) and
+ * chaining the next transfer from the DMA handler; receive round and round
+ * the ring with the drain of an idle timer; a whole ring received
+ * while the DMA interrupt is held off; and an overrun, which must neither
+ * publish more than the ring holds nor lose count of what was overwritten:
+ *
+ *	gcc -std=gnu99 -O2 -Wall -Wno-pointer-to-int-cast -DCORE_M3 \
+ *		-Ifake -I../inc -o uart_dma_test uart_dma_test.c \
+ *		../src/uart_17xx_40xx.c ../src/gpdma_17xx_40xx.c ../src/ring_buffer.c \
+ *		../src/clock_17xx_40xx.c ../src/sysctl_17xx_40xx.c
+ *	./uart_dma_test
+ *
+ * Also worth a run with -fsanitize=address,undefined.
+ */
+
+#include "chip.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#define RX_SIZE         64
+#define TX_SIZE         64
+
+/* Write a register the drivers only read */
+#define FAKE_REG(r)     (*(volatile uint32_t *) &(r))
+
+/* Peripheral address ranges, and memory for the DMA to reach */
+#define APB_BASE        0x40000000
+#define APB_SIZE        0x00100000
+#define AHB_BASE        0x50000000
+#define AHB_SIZE        0x00010000
+#define SRAM_BASE       0x2007C000
+#define SRAM_SIZE       0x00008000
+
+/* Everything the DMA reads or writes, placed in SRAM */
+struct sram {
+	UART_DMARB_T dmarb;
+	RINGBUFF_T rxrb, txrb;
+	uint8_t rxbuf[RX_SIZE];
+	uint8_t txbuf[TX_SIZE];
+};
+
+uint32_t fake_primask;
+const uint32_t OscRateIn = 12000000;
+const uint32_t RTCOscRateIn = 32768;
+
+static struct sram *s;
+static int irq_on;
+static uint8_t txlog[4096];
+static int txlen;
+
+static int fail(const char *what, long n)
+{
+	printf("FAILED: %s (%ld)\n", what, n);
+	return 1;
+}
+
+/* The side effects of register writes a memory fake cannot have */
+static void fake_sync(void)
+{
+	LPC_GPDMA_T *dma = LPC_GPDMA;
+	uint32_t enabled = 0;
+	int ch;
+
+	FAKE_REG(dma->INTTCSTAT) &= ~dma->INTTCCLEAR;
+	FAKE_REG(dma->INTERRSTAT) &= ~dma->INTERRCLR;
+	dma->INTTCCLEAR = 0;
+	dma->INTERRCLR = 0;
+	FAKE_REG(dma->INTSTAT) = dma->INTTCSTAT | dma->INTERRSTAT;
+	for (ch = 0; ch < GPDMA_NUMBER_CHANNELS; ch++) {
+		if (dma->CH[ch].CONFIG & GPDMA_DMACCxConfig_E) {
+			enabled |= 1 << ch;
+		}
+	}
+	FAKE_REG(dma->ENBLDCHNS) = enabled;
+}
+
+/* Takes the DMA interrupt if one is pending and not held off */
+static void fake_irq(void)
+{
+	fake_sync();
+	if (irq_on && LPC_GPDMA->INTSTAT) {
+		Chip_UART_DMARBHandler(&s->dmarb);
+		fake_sync();
+	}
+}
+
+/* One request of DMA line 'line': moves a byte for the enabled channel
+   waiting for it, returns 0 if there is none */
+static int fake_dma(uint32_t line)
+{
+	LPC_GPDMA_T *dma = LPC_GPDMA;
+	uint32_t cfg, type, size;
+	int ch;
+
+	fake_sync();
+	for (ch = 0; ch < GPDMA_NUMBER_CHANNELS; ch++) {
+		GPDMA_CH_T *c = &dma->CH[ch];
+
+		cfg = c->CONFIG;
+		type = (cfg >> 11) & 7;
+		if (!(cfg & GPDMA_DMACCxConfig_E) ||
+			!((type == GPDMA_TRANSFERTYPE_P2M_CONTROLLER_DMA && ((cfg >> 1) & 0x1F) == line) ||
+			  (type == GPDMA_TRANSFERTYPE_M2P_CONTROLLER_DMA && ((cfg >> 6) & 0x1F) == line))) {
+			continue;
+		}
+
+		*(volatile uint8_t *) (uintptr_t) c->DESTADDR = *(volatile uint8_t *) (uintptr_t) c->SRCADDR;
+		if (c->CONTROL & GPDMA_DMACCxControl_SI) {
+			c->SRCADDR++;
+		}
+		if (c->CONTROL & GPDMA_DMACCxControl_DI) {
+			c->DESTADDR++;
+		}
+		size = (c->CONTROL & 0xFFF) - 1;
+		c->CONTROL = (c->CONTROL & ~0xFFF) | size;
+		if (size == 0) {
+			/* Terminal count */
+			if ((c->CONTROL & GPDMA_DMACCxControl_I) && (cfg & GPDMA_DMACCxConfig_ITC)) {
+				FAKE_REG(dma->RAWINTTCSTAT) |= 1 << ch;
+				FAKE_REG(dma->INTTCSTAT) |= 1 << ch;
+			}
+			if (c->LLI) {
+				const DMA_TransferDescriptor_t *d = (const void *) (uintptr_t) c->LLI;
+
+				c->SRCADDR = d->src;
+				c->DESTADDR = d->dst;
+				c->LLI = d->lli;
+				c->CONTROL = d->ctrl;
+			}
+			else {
+				c->CONFIG = cfg & ~GPDMA_DMACCxConfig_E;
+			}
+			fake_irq();
+		}
+		return 1;
+	}
+	return 0;
+}
+
+/* The UART receives n bytes numbered from first */
+static int uart_rx(uint32_t first, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++) {
+		FAKE_REG(LPC_UART0->RBR) = (uint8_t) (first + i);
+		FAKE_REG(LPC_UART0->LSR) |= UART_LSR_RDR;
+		if (!fake_dma(GPDMA_CONN_UART0_Rx)) {
+			return fail("no DMA channel took a received byte", first + i);
+		}
+		FAKE_REG(LPC_UART0->LSR) &= ~UART_LSR_RDR;
+		if (RingBuffer_GetCount(&s->rxrb) < 0 || RingBuffer_GetCount(&s->rxrb) > RX_SIZE) {
+			return fail("RX ring holds more than it can", RingBuffer_GetCount(&s->rxrb));
+		}
+	}
+	return 0;
+}
+
+/* The UART sends up to max bytes, returns how many */
+static int uart_tx(int max)
+{
+	int n = 0;
+
+	while (n < max && fake_dma(GPDMA_CONN_UART0_Tx)) {
+		txlog[txlen++] = (uint8_t) LPC_UART0->THR;
+		n++;
+	}
+	return n;
+}
+
+/* The idle timer fires after the line has gone quiet */
+static void uart_idle(void)
+{
+	Chip_UART_DrainDMARX(&s->dmarb);
+}
+
+/* Reads everything published, checking that the spans stay in the ring
+   and, if check is set, that each byte is its index */
+static int rx_read(uint32_t *rd, int check)
+{
+	RINGBUFF_SPAN_T span[2];
+	const uint8_t *p;
+	int i, j, cnt;
+
+	cnt = RingBuffer_PeekRead(&s->rxrb, span, RX_SIZE);
+	for (i = 0; i < 2; i++) {
+		p = span[i].data;
+		if (span[i].count > 0 && (p < s->rxbuf || p + span[i].count > s->rxbuf + RX_SIZE)) {
+			return fail("RX span outside the ring", *rd);
+		}
+		for (j = 0; j < span[i].count; j++, (*rd)++) {
+			if (check && p[j] != (uint8_t) *rd) {
+				return fail("wrong byte received", *rd);
+			}
+		}
+	}
+	RingBuffer_ReleaseRead(&s->rxrb, cnt);
+	return 0;
+}
+
+static int reset(void)
+{
+	memset((void *) APB_BASE, 0, APB_SIZE);
+	memset((void *) AHB_BASE, 0, AHB_SIZE);
+	memset(s, 0, sizeof(*s));
+	txlen = 0;
+	irq_on = 1;
+
+	Chip_GPDMA_Init(LPC_GPDMA);
+	fake_sync();
+	RingBuffer_Init(&s->rxrb, s->rxbuf, 1, RX_SIZE);
+	RingBuffer_Init(&s->txrb, s->txbuf, 1, TX_SIZE);
+	if (Chip_UART_InitDMARB(&s->dmarb, LPC_UART0, LPC_GPDMA, &s->rxrb, &s->txrb) != SUCCESS) {
+		return fail("Chip_UART_InitDMARB", 0);
+	}
+	fake_sync();
+	if (LPC_UART0->IER & UART_IER_RBRINT) {
+		return fail("UART receive interrupt left on beside the DMA", LPC_UART0->IER);
+	}
+	return 0;
+}
+
+static int test_tx(void)
+{
+	uint8_t data[120];
+	int i;
+
+	for (i = 0; i < 120; i++) {
+		data[i] = (uint8_t) i;
+	}
+	if (reset()) {
+		return 1;
+	}
+
+	/* One span, then one across the end of the ring in two descriptors */
+	if (Chip_UART_SendDMARB(&s->dmarb, data, 40) != 40 || uart_tx(1000) != 40) {
+		return fail("first transfer", txlen);
+	}
+	if (s->dmarb.txBusy != 0 || !RingBuffer_IsEmpty(&s->txrb)) {
+		return fail("first transfer not released", s->dmarb.txBusy);
+	}
+	if (Chip_UART_SendDMARB(&s->dmarb, data + 40, 50) != 50 || s->dmarb.txBusy != 50 ||
+		LPC_GPDMA->CH[s->dmarb.txChannel].LLI == 0) {
+		return fail("wrapping transfer not in two descriptors", s->dmarb.txBusy);
+	}
+
+	/* What fits while it runs, chained by the handler when it is done */
+	uart_tx(10);
+	if (Chip_UART_SendDMARB(&s->dmarb, data + 90, 30) != 14 || s->dmarb.txBusy != 50) {
+		return fail("data queued behind a running transfer", s->dmarb.txBusy);
+	}
+	uart_tx(1000);
+	if (txlen != 104 || memcmp(txlog, data, 104) != 0) {
+		return fail("bytes sent", txlen);
+	}
+	if (s->dmarb.txBusy != 0 || !RingBuffer_IsEmpty(&s->txrb) || fake_primask) {
+		return fail("TX left busy or interrupts masked", s->dmarb.txBusy);
+	}
+	printf("tx: wrapped and chained transfers sent %d bytes\n", txlen);
+	return 0;
+}
+
+static int test_rx_wrap(void)
+{
+	uint32_t n = 0, rd = 0;
+	int i;
+
+	if (reset()) {
+		return 1;
+	}
+
+	/* A short message below the half mark only shows after the idle drain */
+	if (uart_rx(n, 5)) {
+		return 1;
+	}
+	n += 5;
+	if (RingBuffer_GetCount(&s->rxrb) != 0) {
+		return fail("published before a drain", RingBuffer_GetCount(&s->rxrb));
+	}
+	uart_idle();
+	if (RingBuffer_GetCount(&s->rxrb) != 5 || fake_primask) {
+		return fail("idle drain", RingBuffer_GetCount(&s->rxrb));
+	}
+
+	/* Round and round, reading after every burst */
+	for (i = 0; i < 40; i++) {
+		if (uart_rx(n, 13 + i % 7)) {
+			return 1;
+		}
+		n += 13 + i % 7;
+		uart_idle();
+		if (RingBuffer_GetCount(&s->rxrb) != (int) (n - rd)) {
+			return fail("not all received bytes published", n - rd);
+		}
+		if (rx_read(&rd, 1)) {
+			return 1;
+		}
+	}
+	if (s->dmarb.rxOverrun != 0) {
+		return fail("overrun counted when the consumer kept up", s->dmarb.rxOverrun);
+	}
+	printf("rx: %lu bytes round a ring of %d\n", (unsigned long) n, RX_SIZE);
+	return 0;
+}
+
+static int test_rx_held_off(void)
+{
+	uint32_t n = 0, rd = 0;
+
+	if (reset()) {
+		return 1;
+	}
+	if (uart_rx(n, 10)) {
+		return 1;
+	}
+	n += 10;
+	uart_idle();
+	if (rx_read(&rd, 1)) {
+		return 1;
+	}
+
+	/* A whole ring while the DMA interrupt is held off: both terminal
+	   counts come as one, and the DMA is back where the last drain was */
+	irq_on = 0;
+	if (uart_rx(n, RX_SIZE)) {
+		return 1;
+	}
+	n += RX_SIZE;
+	irq_on = 1;
+	fake_irq();
+	if (RingBuffer_GetCount(&s->rxrb) != RX_SIZE) {
+		return fail("a whole ring received between drains was lost", RingBuffer_GetCount(&s->rxrb));
+	}
+	if (rx_read(&rd, 1)) {
+		return 1;
+	}
+	if (s->dmarb.rxOverrun != 0 || rd != n) {
+		return fail("overrun counted for a ring that was read in time", s->dmarb.rxOverrun);
+	}
+	printf("rx: a whole ring received with the DMA interrupt held off\n");
+	return 0;
+}
+
+static int test_rx_overrun(void)
+{
+	uint32_t n = 0, rd = 0, lost;
+	int i;
+
+	if (reset()) {
+		return 1;
+	}
+
+	/* Nothing read while two and a half rings come in */
+	if (uart_rx(n, 160)) {
+		return 1;
+	}
+	n += 160;
+	uart_idle();
+	lost = n - RX_SIZE;
+	if (RingBuffer_GetCount(&s->rxrb) != RX_SIZE || s->dmarb.rxOverrun != lost) {
+		return fail("overrun not clamped to the ring or not counted", s->dmarb.rxOverrun);
+	}
+
+	/* The consumer catches up, the bytes overwritten in the meantime
+	   counted as well, and then the data is right again */
+	if (rx_read(&rd, 0)) {
+		return 1;
+	}
+	if (uart_rx(n, 20)) {
+		return 1;
+	}
+	n += 20;
+	uart_idle();
+	lost += 20;
+	if (rx_read(&rd, 0) || s->dmarb.rxOverrun != lost) {
+		return fail("overrun while catching up", s->dmarb.rxOverrun);
+	}
+	uart_idle();
+	if (rx_read(&rd, 1)) {
+		return 1;
+	}
+	for (i = 0; i < 10; i++) {
+		if (uart_rx(n, 30)) {
+			return 1;
+		}
+		n += 30;
+		uart_idle();
+		if (rx_read(&rd, 1)) {
+			return 1;
+		}
+	}
+	if (rd != n || s->dmarb.rxOverrun != lost) {
+		return fail("stream after the overrun", n - rd);
+	}
+	printf("rx: overrun of %lu bytes clamped, counted and recovered from\n", (unsigned long) lost);
+	return 0;
+}
+
+int main(void)
+{
+	if (mmap((void *) APB_BASE, APB_SIZE, PROT_READ | PROT_WRITE,
+			 MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0) != (void *) APB_BASE ||
+		mmap((void *) AHB_BASE, AHB_SIZE, PROT_READ | PROT_WRITE,
+			 MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0) != (void *) AHB_BASE ||
+		mmap((void *) SRAM_BASE, SRAM_SIZE, PROT_READ | PROT_WRITE,
+			 MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0) != (void *) SRAM_BASE) {
+		perror("cannot map the fake registers");
+		return 1;
+	}
+	s = (struct sram *) SRAM_BASE;
+
+	if (test_tx() || test_rx_wrap() || test_rx_held_off() || test_rx_overrun()) {
+		return 1;
+	}
+	printf("passed\n");
+	return 0;
+}
@@ -36,6 +36,10 @@
 
 /** @defgroup Ring_Buffer CHIP: Simple ring buffer implementation
  * @ingroup CHIP_Common
+ * With one producer and one consumer (e.g. a task and an ISR) the ring
+ * buffer is safe without a critical section: each side only ever writes
+ * its own index (head for the producer, tail for the consumer) and
+ * publishes it with release ordering after the item data.
  * @{
  */
 
@@ -62,6 +66,33 @@ typedef struct {
  */
 #define RB_VTAIL(rb)              (*(volatile uint32_t *) &(rb)->tail)
 
+/**
+ * @def		RB_LOAD_ACQ(idx)
+ * Load a head/tail index with acquire ordering; the data the other side
+ * published before storing the index is visible after this load
+ */
+/**
+ * @def		RB_STORE_REL(idx, val)
+ * Store a head/tail index with release ordering; all item data written
+ * before this store is visible to the side that loads the index
+ */
+#if defined(__GNUC__)
+#define RB_LOAD_ACQ(idx)          __atomic_load_n(&(idx), __ATOMIC_ACQUIRE)
+#define RB_STORE_REL(idx, val)    __atomic_store_n(&(idx), (val), __ATOMIC_RELEASE)
+#else
+#define RB_LOAD_ACQ(idx)          (*(volatile uint32_t *) &(idx))
+#define RB_STORE_REL(idx, val)    ((*(volatile uint32_t *) &(idx)) = (val))
+#endif
+
+/**
+ * @brief Contiguous region of a ring buffer returned by the
+ * reserve/peek calls; a region that wraps is returned as two spans
+ */
+typedef struct {
+	void *data;		/*!< Pointer to the first item of the span */
+	int count;		/*!< Number of items in the span */
+} RINGBUFF_SPAN_T;
+
 /**
  * @brief	Initialize ring buffer
  * @param	RingBuff	: Pointer to ring buffer to initialize
@@ -180,6 +211,55 @@ int RingBuffer_Pop(RINGBUFF_T *RingBuff, void *data);
  */
 int RingBuffer_PopMult(RINGBUFF_T *RingBuff, void *data, int num);
 
+/**
+ * @brief	Reserve free space in the ring buffer for in-place writing
+ * @param	RingBuff	: Pointer to ring buffer
+ * @param	span		: Array of 2 spans filled with the reserved regions
+ * @param	num			: Max number of items to reserve
+ * @return	Total number of items reserved across both spans,
+ * 			0 when the buffer is full
+ * @note	Producer side only. The second span is non-empty only when the
+ * 			reserved region wraps past the end of the buffer. Nothing
+ * 			becomes visible to the consumer until RingBuffer_CommitWrite().
+ */
+int RingBuffer_ReserveWrite(RINGBUFF_T *RingBuff, RINGBUFF_SPAN_T span[2], int num);
+
+/**
+ * @brief	Publish items written in place to the consumer
+ * @param	RingBuff	: Pointer to ring buffer
+ * @param	num			: Number of items written, must not exceed the
+ * 						  count returned by RingBuffer_ReserveWrite()
+ * @return	Nothing
+ */
+STATIC INLINE void RingBuffer_CommitWrite(RINGBUFF_T *RingBuff, int num)
+{
+	RB_STORE_REL(RingBuff->head, RingBuff->head + num);
+}
+
+/**
+ * @brief	Get the items available for in-place reading
+ * @param	RingBuff	: Pointer to ring buffer
+ * @param	span		: Array of 2 spans filled with the readable regions
+ * @param	num			: Max number of items to return
+ * @return	Total number of readable items across both spans,
+ * 			0 when the buffer is empty
+ * @note	Consumer side only. The items stay owned by the consumer until
+ * 			RingBuffer_ReleaseRead() hands the space back to the producer.
+ */
+int RingBuffer_PeekRead(RINGBUFF_T *RingBuff, RINGBUFF_SPAN_T span[2], int num);
+
+/**
+ * @brief	Return space of items consumed in place to the producer
+ * @param	RingBuff	: Pointer to ring buffer
+ * @param	num			: Number of items consumed, must not exceed the
+ * 						  count returned by RingBuffer_PeekRead()
+ * @return	Nothing
+ */
+STATIC INLINE void RingBuffer_ReleaseRead(RINGBUFF_T *RingBuff, int num)
+{
+	RB_STORE_REL(RingBuff->tail, RingBuff->tail + num);
+}
+
 
 /**
  * @}
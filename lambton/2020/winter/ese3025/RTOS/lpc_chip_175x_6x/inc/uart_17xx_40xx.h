@@ -784,6 +784,93 @@ int Chip_UART_ReadRB(LPC_USART_T *pUART, RINGBUFF_T *pRB, void *data, int bytes)
  */
 void Chip_UART_IRQRBHandler(LPC_USART_T *pUART, RINGBUFF_T *pRXRB, RINGBUFF_T *pTXRB);
 
+/**
+ * @brief UART ring buffer DMA state
+ * @note	Set up with Chip_UART_InitDMARB(). Both ring buffers must use
+ *			1 byte items. The RX ring buffer is written by a circular
+ *			descriptor pair covering its two halves, so the consumer must
+ *			keep up or the DMA overwrites data not read yet. Those bytes
+ *			are counted in rxOverrun; newer bytes stand in their place
+ *			until the consumer has caught up, so the data read around an
+ *			overrun should be treated as corrupt.
+ */
+typedef struct {
+	LPC_USART_T *pUART;					/*!< UART served by this state */
+	LPC_GPDMA_T *pGPDMA;				/*!< GPDMA controller */
+	RINGBUFF_T *pRXRB;					/*!< Receive ring buffer, NULL if unused */
+	RINGBUFF_T *pTXRB;					/*!< Transmit ring buffer, NULL if unused */
+	uint8_t rxChannel;					/*!< GPDMA channel streaming into pRXRB */
+	uint8_t txChannel;					/*!< GPDMA channel streaming from pTXRB */
+	volatile int txBusy;				/*!< Bytes of pTXRB owned by the running TX transfer */
+	uint32_t rxOverrun;					/*!< Bytes overwritten before they were read */
+	uint32_t rxPos;						/*!< Free-running RX index the DMA had reached at the last drain */
+	volatile uint32_t rxHalves;			/*!< RX ring halves the DMA has filled, counted at each terminal count */
+	DMA_TransferDescriptor_t rxDesc[2];	/*!< Circular RX descriptors, one per ring half */
+	DMA_TransferDescriptor_t txDesc[2];	/*!< TX descriptors, two when the data wraps */
+} UART_DMARB_T;
+
+/**
+ * @brief	Set up DMA driven transmit and receive for UART ring buffers
+ * @param	pDMARB	: Pointer to DMA state to initialize
+ * @param	pUART	: Pointer to selected UART peripheral (UART0 - UART3)
+ * @param	pGPDMA	: The base of GPDMA on the chip, must be initialized
+ * @param	pRXRB	: Receive ring buffer, or NULL for no DMA receive
+ * @param	pTXRB	: Transmit ring buffer, or NULL for no DMA transmit
+ * @return	ERROR when the UART has no DMA connection or the RX transfer
+ *			cannot be started, otherwise SUCCESS
+ * @note	Enables the UART FIFO DMA mode and starts the circular receive
+ *			transfer with the UART receive interrupt disabled. The
+ *			application must enable DMA_IRQn and call
+ *			Chip_UART_DMARBHandler() from DMA_IRQHandler. For DMA receive
+ *			it must also call Chip_UART_DrainDMARX() from an idle timer,
+ *			such as a timer tick, so that data short of a ring half is
+ *			published; its period bounds the receive latency.
+ */
+Status Chip_UART_InitDMARB(UART_DMARB_T *pDMARB, LPC_USART_T *pUART, LPC_GPDMA_T *pGPDMA,
+						   RINGBUFF_T *pRXRB, RINGBUFF_T *pTXRB);
+
+/**
+ * @brief	Populate a transmit ring buffer and start DMA transmit
+ * @param	pDMARB	: Pointer to DMA state
+ * @param	data	: Pointer to buffer to move to ring buffer
+ * @param	bytes	: Number of bytes to move
+ * @return	The number of bytes placed into the ring buffer
+ * @note	Data written in place with RingBuffer_ReserveWrite() and
+ *			RingBuffer_CommitWrite() can be started with
+ *			Chip_UART_StartDMATX() instead.
+ */
+uint32_t Chip_UART_SendDMARB(UART_DMARB_T *pDMARB, const void *data, int bytes);
+
+/**
+ * @brief	Start a DMA transmit of the pending TX ring buffer data
+ * @param	pDMARB	: Pointer to DMA state
+ * @return	Nothing
+ * @note	Does nothing while a transfer is running; the DMA handler
+ *			chains the next one when it completes.
+ */
+void Chip_UART_StartDMATX(UART_DMARB_T *pDMARB);
+
+/**
+ * @brief	Publish bytes received by DMA to the RX ring buffer
+ * @param	pDMARB	: Pointer to DMA state
+ * @return	Number of newly published bytes
+ * @note	Called by Chip_UART_DMARBHandler() at each ring half; call it
+ *			from an idle timer as well, and before reading when waiting
+ *			for a short message. It only reads where the DMA got to, so
+ *			bytes still on their way are published by the next call.
+ *			Never publishes more than the ring buffer has room for; what
+ *			the DMA wrote over unread data is added to rxOverrun instead.
+ */
+int Chip_UART_DrainDMARX(UART_DMARB_T *pDMARB);
+
+/**
+ * @brief	GPDMA interrupt handler for UART ring buffer DMA
+ * @param	pDMARB	: Pointer to DMA state
+ * @return	Nothing
+ * @note	Call from DMA_IRQHandler; other channels are left untouched.
+ */
+void Chip_UART_DMARBHandler(UART_DMARB_T *pDMARB);
+
 /**
  * @brief	Returns the Auto Baud status
  * @param	pUART	: Pointer to selected UART peripheral
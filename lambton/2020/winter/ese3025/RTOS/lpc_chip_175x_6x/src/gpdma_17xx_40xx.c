@@ -271,6 +271,24 @@ STATIC uint8_t configDMAMux(uint32_t gpdma_peripheral_connection_number)
 #endif
 }
 
+/* Find the peripheral connection whose data register is at address addr.
+   Tx/Rx connections sharing one data register are listed as Tx, Rx pairs,
+   so the source side of a transfer takes the second entry of a pair. */
+STATIC int getConnFromAddr(uint32_t addr, bool isSrc)
+{
+	int i, num = sizeof(GPDMA_LUTPerAddr) / sizeof(GPDMA_LUTPerAddr[0]);
+
+	for (i = 0; i < num; i++) {
+		if ((uint32_t) GPDMA_LUTPerAddr[i] == addr) {
+			if (isSrc && (i + 1) < num && GPDMA_LUTPerAddr[i + 1] == GPDMA_LUTPerAddr[i]) {
+				i++;
+			}
+			return i;
+		}
+	}
+	return -1;
+}
+
 uint32_t makeCtrlWord(const GPDMA_CH_CFG_T *GPDMAChannelConfig,
 					  uint32_t GPDMA_LUTPerBurstSrcConn,
 					  uint32_t GPDMA_LUTPerBurstDstConn,
@@ -657,7 +675,27 @@ Status Chip_GPDMA_SGTransfer(LPC_GPDMA_T *pGPDMA,
 	GPDMA_CH_CFG_T GPDMACfg;
 	uint8_t SrcPeripheral = 0, DstPeripheral = 0;
 	uint32_t src = DMADescriptor->src, dst = DMADescriptor->dst;
-	int ret;
+	int ret, conn;
+
+	/* Descriptors hold data register addresses, map them back to connections */
+	if (TransferType != GPDMA_TRANSFERTYPE_M2M_CONTROLLER_DMA &&
+		TransferType != GPDMA_TRANSFERTYPE_M2P_CONTROLLER_DMA &&
+		TransferType != GPDMA_TRANSFERTYPE_M2P_CONTROLLER_PERIPHERAL) {
+		conn = getConnFromAddr(src, true);
+		if (conn < 0) {
+			return ERROR;
+		}
+		src = conn;
+	}
+	if (TransferType != GPDMA_TRANSFERTYPE_M2M_CONTROLLER_DMA &&
+		TransferType != GPDMA_TRANSFERTYPE_P2M_CONTROLLER_DMA &&
+		TransferType != GPDMA_TRANSFERTYPE_P2M_CONTROLLER_PERIPHERAL) {
+		conn = getConnFromAddr(dst, false);
+		if (conn < 0) {
+			return ERROR;
+		}
+		dst = conn;
+	}
 
 	ret = Chip_GPDMA_InitChannelCfg(pGPDMA, &GPDMACfg, ChannelNum, src, dst, 0, TransferType);
 	if (ret < 0) {
@@ -47,6 +47,27 @@
  * Private functions
  ****************************************************************************/
 
+/* Split up to num items starting at free-running index idx into at most
+   two contiguous spans, the second one starting back at the buffer base */
+static int RingBuffer_GetSpans(RINGBUFF_T *RingBuff, uint32_t idx, int avail,
+							   RINGBUFF_SPAN_T span[2], int num)
+{
+	uint32_t ind = idx & (RingBuff->count - 1);
+	int cnt1, cnt2;
+
+	cnt1 = cnt2 = MIN(avail, num);
+	if (ind + cnt1 >= (uint32_t) RingBuff->count)
+		cnt1 = RingBuff->count - ind;
+	cnt2 -= cnt1;
+
+	span[0].data = (uint8_t *) RingBuff->data + ind * RingBuff->itemSz;
+	span[0].count = cnt1;
+	span[1].data = RingBuff->data;
+	span[1].count = cnt2;
+
+	return cnt1 + cnt2;
+}
+
 /*****************************************************************************
  * Public functions
  ****************************************************************************/
@@ -66,14 +87,15 @@ int RingBuffer_Init(RINGBUFF_T *RingBuff, void *buffer, int itemSize, int count)
 int RingBuffer_Insert(RINGBUFF_T *RingBuff, const void *data)
 {
 	uint8_t *ptr = RingBuff->data;
+	uint32_t head = RingBuff->head;
 
 	/* We cannot insert when queue is full */
-	if (RingBuffer_IsFull(RingBuff))
+	if ((int) (head - RB_LOAD_ACQ(RingBuff->tail)) >= RingBuff->count)
 		return 0;
 
 	ptr += RB_INDH(RingBuff) * RingBuff->itemSz;
 	memcpy(ptr, data, RingBuff->itemSz);
-	RingBuff->head++;
+	RB_STORE_REL(RingBuff->head, head + 1);
 
 	return 1;
 }
@@ -81,51 +103,36 @@ int RingBuffer_Insert(RINGBUFF_T *RingBuff, const void *data)
 /* Insert multiple items into Ring Buffer */
 int RingBuffer_InsertMult(RINGBUFF_T *RingBuff, const void *data, int num)
 {
-	uint8_t *ptr = RingBuff->data;
-	int cnt1, cnt2;
+	RINGBUFF_SPAN_T span[2];
+	int cnt;
 
 	/* We cannot insert when queue is full */
-	if (RingBuffer_IsFull(RingBuff))
+	cnt = RingBuffer_ReserveWrite(RingBuff, span, num);
+	if (cnt == 0)
 		return 0;
 
-	/* Calculate the segment lengths */
-	cnt1 = cnt2 = RingBuffer_GetFree(RingBuff);
-	if (RB_INDH(RingBuff) + cnt1 >= RingBuff->count)
-		cnt1 = RingBuff->count - RB_INDH(RingBuff);
-	cnt2 -= cnt1;
-
-	cnt1 = MIN(cnt1, num);
-	num -= cnt1;
-
-	cnt2 = MIN(cnt2, num);
-	num -= cnt2;
+	/* Write segment 1 and 2 */
+	memcpy(span[0].data, data, span[0].count * RingBuff->itemSz);
+	data = (const uint8_t *) data + span[0].count * RingBuff->itemSz;
+	memcpy(span[1].data, data, span[1].count * RingBuff->itemSz);
+	RingBuffer_CommitWrite(RingBuff, cnt);
 
-	/* Write segment 1 */
-	ptr += RB_INDH(RingBuff) * RingBuff->itemSz;
-	memcpy(ptr, data, cnt1 * RingBuff->itemSz);
-	RingBuff->head += cnt1;
-
-	/* Write segment 2 */
-	ptr = (uint8_t *) RingBuff->data + RB_INDH(RingBuff) * RingBuff->itemSz;
-	data = (const uint8_t *) data + cnt1 * RingBuff->itemSz;
-	memcpy(ptr, data, cnt2 * RingBuff->itemSz);
-	RingBuff->head += cnt2;
-
-	return cnt1 + cnt2;
+	return cnt;
 }
 
 /* Pop single item from Ring Buffer */
 int RingBuffer_Pop(RINGBUFF_T *RingBuff, void *data)
 {
 	uint8_t *ptr = RingBuff->data;
+	uint32_t tail = RingBuff->tail;
 
 	/* We cannot pop when queue is empty */
-	if (RingBuffer_IsEmpty(RingBuff))
+	if (RB_LOAD_ACQ(RingBuff->head) == tail)
 		return 0;
 
 	ptr += RB_INDT(RingBuff) * RingBuff->itemSz;
 	memcpy(data, ptr, RingBuff->itemSz);
-	RingBuff->tail++;
+	RB_STORE_REL(RingBuff->tail, tail + 1);
 
 	return 1;
 }
@@ -133,35 +140,37 @@ int RingBuffer_Pop(RINGBUFF_T *RingBuff, void *data)
 /* Pop multiple items from Ring buffer */
 int RingBuffer_PopMult(RINGBUFF_T *RingBuff, void *data, int num)
 {
-	uint8_t *ptr = RingBuff->data;
-	int cnt1, cnt2;
+	RINGBUFF_SPAN_T span[2];
+	int cnt;
 
-	/* We cannot insert when queue is empty */
-	if (RingBuffer_IsEmpty(RingBuff))
+	/* We cannot pop when queue is empty */
+	cnt = RingBuffer_PeekRead(RingBuff, span, num);
+	if (cnt == 0)
 		return 0;
 
-	/* Calculate the segment lengths */
-	cnt1 = cnt2 = RingBuffer_GetCount(RingBuff);
-	if (RB_INDT(RingBuff) + cnt1 >= RingBuff->count)
-		cnt1 = RingBuff->count - RB_INDT(RingBuff);
-	cnt2 -= cnt1;
+	/* Read segment 1 and 2 */
+	memcpy(data, span[0].data, span[0].count * RingBuff->itemSz);
+	data = (uint8_t *) data + span[0].count * RingBuff->itemSz;
+	memcpy(data, span[1].data, span[1].count * RingBuff->itemSz);
+	RingBuffer_ReleaseRead(RingBuff, cnt);
 
-	cnt1 = MIN(cnt1, num);
-	num -= cnt1;
+	return cnt;
+}
 
-	cnt2 = MIN(cnt2, num);
-	num -= cnt2;
+/* Reserve free space for in-place writing (producer side) */
+int RingBuffer_ReserveWrite(RINGBUFF_T *RingBuff, RINGBUFF_SPAN_T span[2], int num)
+{
+	uint32_t head = RingBuff->head;
+	int avail = RingBuff->count - (int) (head - RB_LOAD_ACQ(RingBuff->tail));
 
-	/* Write segment 1 */
-	ptr += RB_INDT(RingBuff) * RingBuff->itemSz;
-	memcpy(data, ptr, cnt1 * RingBuff->itemSz);
-	RingBuff->tail += cnt1;
+	return RingBuffer_GetSpans(RingBuff, head, avail, span, num);
+}
 
-	/* Write segment 2 */
-	ptr = (uint8_t *) RingBuff->data + RB_INDT(RingBuff) * RingBuff->itemSz;
-	data = (uint8_t *) data + cnt1 * RingBuff->itemSz;
-	memcpy(data, ptr, cnt2 * RingBuff->itemSz);
-	RingBuff->tail += cnt2;
+/* Get the items available for in-place reading (consumer side) */
+int RingBuffer_PeekRead(RINGBUFF_T *RingBuff, RINGBUFF_SPAN_T span[2], int num)
+{
+	uint32_t tail = RingBuff->tail;
+	int avail = (int) (RB_LOAD_ACQ(RingBuff->head) - tail);
 
-	return cnt1 + cnt2;
+	return RingBuffer_GetSpans(RingBuff, tail, avail, span, num);
 }
@@ -72,6 +72,31 @@ STATIC CHIP_SYSCTL_CLOCK_T Chip_UART_GetClockIndex(LPC_USART_T *pUART)
 	return clkUART;
 }
 
+/* Returns the GPDMA transmit connection of the UART, -1 if it has none.
+   The receive connection always directly follows the transmit one. */
+STATIC int Chip_UART_GetDMATxConn(LPC_USART_T *pUART)
+{
+	if (pUART == LPC_UART0) {
+		return GPDMA_CONN_UART0_Tx;
+	}
+	else if (pUART == (LPC_USART_T *) LPC_UART1) {
+		return GPDMA_CONN_UART1_Tx;
+	}
+	else if (pUART == LPC_UART2) {
+		return GPDMA_CONN_UART2_Tx;
+	}
+	else if (pUART == LPC_UART3) {
+		return GPDMA_CONN_UART3_Tx;
+	}
+#if defined(CHIP_LPC177X_8X) || defined(CHIP_LPC40XX)
+	else if (pUART == LPC_UART4) {
+		return GPDMA_CONN_UART4_Tx;
+	}
+#endif
+
+	return -1;
+}
+
 /* UART Autobaud command interrupt handler */
 STATIC void Chip_UART_ABIntHandler(LPC_USART_T *pUART)
 {
@@ -308,23 +333,48 @@ uint32_t Chip_UART_SetBaud(LPC_USART_T *pUART, uint32_t baudrate)
 /* UART receive-only interrupt handler for ring buffers */
 void Chip_UART_RXIntHandlerRB(LPC_USART_T *pUART, RINGBUFF_T *pRB)
 {
+	RINGBUFF_SPAN_T span[2];
+	int i, n = 0, cnt;
+
+	/* Receive straight into the free space of the ring buffer */
+	cnt = RingBuffer_ReserveWrite(pRB, span, RingBuffer_GetSize(pRB));
+	for (i = 0; i < 2; i++) {
+		uint8_t *p8 = span[i].data;
+		uint8_t *end = p8 + span[i].count;
+
+		while (p8 < end && (Chip_UART_ReadLineStatus(pUART) & UART_LSR_RDR)) {
+			*p8++ = Chip_UART_ReadByte(pUART);
+			n++;
+		}
+	}
+	RingBuffer_CommitWrite(pRB, n);
+
 	/* New data will be ignored if data not popped in time */
-	while (Chip_UART_ReadLineStatus(pUART) & UART_LSR_RDR) {
-		uint8_t ch = Chip_UART_ReadByte(pUART);
-		RingBuffer_Insert(pRB, &ch);
+	if (n == cnt) {
+		while (Chip_UART_ReadLineStatus(pUART) & UART_LSR_RDR) {
+			Chip_UART_ReadByte(pUART);
+		}
 	}
 }
 
 /* UART transmit-only interrupt handler for ring buffers */
 void Chip_UART_TXIntHandlerRB(LPC_USART_T *pUART, RINGBUFF_T *pRB)
 {
-	uint8_t ch;
+	RINGBUFF_SPAN_T span[2];
+	int i, n = 0;
 
 	/* Fill FIFO until full or until TX ring buffer is empty */
-	while ((Chip_UART_ReadLineStatus(pUART) & UART_LSR_THRE) != 0 &&
-		   RingBuffer_Pop(pRB, &ch)) {
-		Chip_UART_SendByte(pUART, ch);
+	RingBuffer_PeekRead(pRB, span, RingBuffer_GetSize(pRB));
+	for (i = 0; i < 2; i++) {
+		const uint8_t *p8 = span[i].data;
+		const uint8_t *end = p8 + span[i].count;
+
+		while (p8 < end && (Chip_UART_ReadLineStatus(pUART) & UART_LSR_THRE) != 0) {
+			Chip_UART_SendByte(pUART, *p8++);
+			n++;
+		}
 	}
+	RingBuffer_ReleaseRead(pRB, n);
 }
 
 /* Populate a transmit ring buffer and start UART transmit */
@@ -377,6 +427,185 @@ void Chip_UART_IRQRBHandler(LPC_USART_T *pUART, RINGBUFF_T *pRXRB, RINGBUFF_T *p
     Chip_UART_ABIntHandler(pUART);
 }
 
+/* Set up DMA driven transmit and receive for UART ring buffers */
+Status Chip_UART_InitDMARB(UART_DMARB_T *pDMARB, LPC_USART_T *pUART, LPC_GPDMA_T *pGPDMA,
+						   RINGBUFF_T *pRXRB, RINGBUFF_T *pTXRB)
+{
+	int conn = Chip_UART_GetDMATxConn(pUART);
+	uint32_t half;
+
+	if (conn < 0) {
+		return ERROR;
+	}
+
+	pDMARB->pUART = pUART;
+	pDMARB->pGPDMA = pGPDMA;
+	pDMARB->pRXRB = pRXRB;
+	pDMARB->pTXRB = pTXRB;
+	pDMARB->txBusy = 0;
+	pDMARB->rxOverrun = 0;
+	pDMARB->rxPos = 0;
+	pDMARB->rxHalves = 0;
+
+	/* The UART raises an RX DMA request at 8 characters or on the character
+	   time-out, so the DMA empties the FIFO without the CPU; TX requests
+	   come while the TX FIFO has room */
+	Chip_UART_SetupFIFOS(pUART, UART_FCR_FIFO_EN | UART_FCR_RX_RS | UART_FCR_TX_RS |
+						 UART_FCR_DMAMODE_SEL | UART_FCR_TRG_LEV2);
+
+	if (pTXRB) {
+		pDMARB->txChannel = Chip_GPDMA_GetFreeChannel(pGPDMA, conn);
+	}
+
+	if (pRXRB) {
+		/* Two descriptors linked in a circle, one per half of the ring,
+		   each raising a terminal count interrupt */
+		RingBuffer_Flush(pRXRB);
+		half = RingBuffer_GetSize(pRXRB) / 2;
+		pDMARB->rxChannel = Chip_GPDMA_GetFreeChannel(pGPDMA, conn + 1);
+		Chip_GPDMA_PrepareDescriptor(pGPDMA, &pDMARB->rxDesc[0], conn + 1,
+									 (uint32_t) pRXRB->data, half,
+									 GPDMA_TRANSFERTYPE_P2M_CONTROLLER_DMA, &pDMARB->rxDesc[1]);
+		Chip_GPDMA_PrepareDescriptor(pGPDMA, &pDMARB->rxDesc[1], conn + 1,
+									 (uint32_t) pRXRB->data + half, half,
+									 GPDMA_TRANSFERTYPE_P2M_CONTROLLER_DMA, &pDMARB->rxDesc[0]);
+		pDMARB->rxDesc[0].ctrl |= GPDMA_DMACCxControl_I;
+		pDMARB->rxDesc[1].ctrl |= GPDMA_DMACCxControl_I;
+
+		/* No receive interrupt, the DMA takes every character; what is
+		   left below a ring half is published by an idle timer calling
+		   Chip_UART_DrainDMARX() */
+		Chip_UART_IntDisable(pUART, UART_IER_RBRINT);
+
+		return Chip_GPDMA_SGTransfer(pGPDMA, pDMARB->rxChannel, &pDMARB->rxDesc[0],
+									 GPDMA_TRANSFERTYPE_P2M_CONTROLLER_DMA);
+	}
+
+	return SUCCESS;
+}
+
+/* Start a DMA transmit of the pending TX ring buffer data */
+void Chip_UART_StartDMATX(UART_DMARB_T *pDMARB)
+{
+	RINGBUFF_SPAN_T span[2];
+	uint32_t dst = Chip_UART_GetDMATxConn(pDMARB->pUART);
+	uint32_t primask;
+	int cnt;
+
+	/* Called from both the application and the DMA handler */
+	primask = __get_PRIMASK();
+	__disable_irq();
+
+	if (pDMARB->txBusy == 0) {
+		/* One descriptor per contiguous span, limited to the 12-bit transfer size */
+		cnt = RingBuffer_PeekRead(pDMARB->pTXRB, span, 0xFFF);
+		if (cnt > 0) {
+			cnt = span[0].count;
+			if (span[1].count > 0) {
+				Chip_GPDMA_PrepareDescriptor(pDMARB->pGPDMA, &pDMARB->txDesc[1],
+											 (uint32_t) span[1].data, dst, span[1].count,
+											 GPDMA_TRANSFERTYPE_M2P_CONTROLLER_DMA, NULL);
+				cnt += span[1].count;
+			}
+			Chip_GPDMA_PrepareDescriptor(pDMARB->pGPDMA, &pDMARB->txDesc[0],
+										 (uint32_t) span[0].data, dst, span[0].count,
+										 GPDMA_TRANSFERTYPE_M2P_CONTROLLER_DMA,
+										 (span[1].count > 0) ? &pDMARB->txDesc[1] : NULL);
+			if (Chip_GPDMA_SGTransfer(pDMARB->pGPDMA, pDMARB->txChannel, &pDMARB->txDesc[0],
+									  GPDMA_TRANSFERTYPE_M2P_CONTROLLER_DMA) == SUCCESS) {
+				pDMARB->txBusy = cnt;
+			}
+		}
+	}
+
+	__set_PRIMASK(primask);
+}
+
+/* Populate a transmit ring buffer and start DMA transmit */
+uint32_t Chip_UART_SendDMARB(UART_DMARB_T *pDMARB, const void *data, int bytes)
+{
+	uint32_t ret;
+
+	ret = RingBuffer_InsertMult(pDMARB->pTXRB, data, bytes);
+	Chip_UART_StartDMATX(pDMARB);
+
+	return ret;
+}
+
+/* Publish bytes received by DMA to the RX ring buffer */
+int Chip_UART_DrainDMARX(UART_DMARB_T *pDMARB)
+{
+	RINGBUFF_T *pRB = pDMARB->pRXRB;
+	uint32_t size = RingBuffer_GetSize(pRB);
+	uint32_t half = size / 2;
+	uint32_t off, base, pos, tail, first, primask;
+	int cnt;
+
+	/* Called from both the DMA handler and the idle timer */
+	primask = __get_PRIMASK();
+	__disable_irq();
+
+	/* Free-running index the DMA writes next. DESTADDR only gives it
+	   modulo the ring size, so a ring the DMA went all the way round
+	   between two drains would look empty; the halves counted at each
+	   terminal count give the lap. They may lag a half behind when the
+	   DMA has moved on to the next descriptor before its interrupt is
+	   taken, which the offset from base still covers. */
+	off = pDMARB->pGPDMA->CH[pDMARB->rxChannel].DESTADDR - (uint32_t) pRB->data;
+	base = pDMARB->rxHalves * half;
+	pos = base + ((off - base) & (size - 1));
+
+	/* The DMA wrote over the bytes more than a ring behind it; count those
+	   the consumer had not read yet and that earlier drains did not count */
+	tail = RB_LOAD_ACQ(pRB->tail);
+	first = tail;
+	if ((int32_t) (pDMARB->rxPos - size - first) > 0) {
+		first = pDMARB->rxPos - size;
+	}
+	if ((int32_t) (pos - size - first) > 0) {
+		pDMARB->rxOverrun += pos - size - first;
+	}
+	pDMARB->rxPos = pos;
+
+	/* Publish up to the DMA position, but never past a full ring, so the
+	   head stays in step with the data and within a ring of the tail */
+	if ((int32_t) (pos - (tail + size)) > 0) {
+		pos = tail + size;
+	}
+	cnt = pos - pRB->head;
+	if (cnt > 0) {
+		RingBuffer_CommitWrite(pRB, cnt);
+	}
+	else {
+		cnt = 0;
+	}
+
+	__set_PRIMASK(primask);
+
+	return cnt;
+}
+
+/* GPDMA interrupt handler for UART ring buffer DMA */
+void Chip_UART_DMARBHandler(UART_DMARB_T *pDMARB)
+{
+	LPC_GPDMA_T *pGPDMA = pDMARB->pGPDMA;
+
+	/* Circular receive reached a ring half */
+	if (pDMARB->pRXRB && Chip_GPDMA_IntGetStatus(pGPDMA, GPDMA_STAT_INT, pDMARB->rxChannel)) {
+		Chip_GPDMA_Interrupt(pGPDMA, pDMARB->rxChannel);
+		pDMARB->rxHalves++;
+		Chip_UART_DrainDMARX(pDMARB);
+	}
+
+	/* Transmit done, hand the sent span back and chain the next one */
+	if (pDMARB->pTXRB && Chip_GPDMA_IntGetStatus(pGPDMA, GPDMA_STAT_INT, pDMARB->txChannel)) {
+		Chip_GPDMA_Interrupt(pGPDMA, pDMARB->txChannel);
+		RingBuffer_ReleaseRead(pDMARB->pTXRB, pDMARB->txBusy);
+		pDMARB->txBusy = 0;
+		Chip_UART_StartDMATX(pDMARB);
+	}
+}
+
 /* Determines and sets best dividers to get a target baud rate */
 uint32_t Chip_UART_SetBaudFDR(LPC_USART_T *pUART, uint32_t baudrate)
 